@@ -0,0 +1,91 @@
+/******************************************************************************
+ * Project:  hint
+ * Purpose:  Indexing interval data
+ * Author:   Panagiotis Bouros, pbour@github.io
+ * Author:   George Christodoulou
+ ******************************************************************************
+ * Copyright (c) 2020 - 2024
+ *
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************/
+
+
+#ifndef _AGGREGATES_H_
+#define _AGGREGATES_H_
+
+#include "../def_global.h"
+#include "relation.h"
+#include "sinks.h"
+
+
+
+// Prefix aggregates over an array of ids, e.g., the originals-in of an index
+// level; entry i holds the aggregates of the first i ids, so the aggregates
+// of any contiguous range of the array, e.g., a run of partitions fully
+// covered by a query, are derived with two lookups. Minimum start and maximum
+// end are not kept, as they cannot be derived from prefixes.
+class PrefixAggregates
+{
+public:
+    vector<size_t> xorIds;
+    vector<size_t> sumDurations;
+    
+    PrefixAggregates()
+    {
+    };
+    
+    // Ids must be the positions of the records in R, see AggregateSink.
+    void build(const RelationId &ids, const Relation &R)
+    {
+        auto cnt = ids.size();
+        
+        this->xorIds.resize(cnt+1);
+        this->sumDurations.resize(cnt+1);
+        this->xorIds[0] = this->sumDurations[0] = 0;
+        for (auto j = 0; j < cnt; j++)
+        {
+            this->xorIds[j+1] = this->xorIds[j] ^ ids[j];
+            this->sumDurations[j+1] = this->sumDurations[j] + (R[ids[j]].end-R[ids[j]].start);
+        }
+    };
+    
+    // Reports the aggregates of the ids in positions [from, to).
+    inline void report(const size_t from, const size_t to, AggregateSink &result) const
+    {
+        result.addAggregates(to-from, this->xorIds[to]^this->xorIds[from], this->sumDurations[to]-this->sumDurations[from]);
+    };
+    
+    // Same as above, for an XorSink, i.e., the default XOR workload.
+    inline void report(const size_t from, const size_t to, XorSink &result) const
+    {
+        result.result ^= this->xorIds[to]^this->xorIds[from];
+    };
+    
+    inline size_t getSize() const
+    {
+        return (this->xorIds.capacity()+this->sumDurations.capacity())*sizeof(size_t);
+    };
+    
+    ~PrefixAggregates()
+    {
+    };
+};
+#endif //_AGGREGATES_H_
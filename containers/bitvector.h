@@ -0,0 +1,319 @@
+/******************************************************************************
+ * Project:  hint
+ * Purpose:  Indexing interval data
+ * Author:   Panagiotis Bouros, pbour@github.io
+ * Author:   George Christodoulou
+ ******************************************************************************
+ * Copyright (c) 2020 - 2024
+ *
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************/
+
+
+#ifndef _BITVECTOR_H_
+#define _BITVECTOR_H_
+
+#include "../def_global.h"
+#include "mapping.h"
+
+
+
+inline unsigned int popcount64(uint64_t x)
+{
+#ifdef __POPCNT__
+    return __builtin_popcountll(x);
+#else
+    x = x-((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL)+((x >> 2) & 0x3333333333333333ULL);
+    x = (x+(x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    
+    return (x*0x0101010101010101ULL) >> 56;
+#endif
+}
+
+
+// Bitvector with constant time rank, e.g., over the partitions of an index
+// level marking the non-empty ones; rank(i) is then the position of the first
+// non-empty partition from i on in a directory of the non-empty partitions.
+// Every block of 512 bits keeps the number of set bits before it and, packed
+// in 9-bit fields, the number of set bits before each of its 64-bit words
+// (rank9, Vigna 2008), i.e., 25% extra space; a rank is two lookups and a
+// popcount.
+class RankBitvector
+{
+public:
+    typedef vector<uint64_t, MappedAllocator<uint64_t> > Words;    // may view a file, see containers/mapping.h
+    
+    Words  words;
+    Words  counts;              // 2 per block
+    size_t numBits;
+    
+    RankBitvector()
+    {
+        this->numBits = 0;
+    };
+    
+    // There is always a word for bit numBits, so rank(numBits) is valid.
+    void init(const size_t numBits)
+    {
+        this->numBits = numBits;
+        this->words.assign((numBits/512+1)*8, 0);
+        this->counts.clear();
+    };
+    
+    inline void set(const size_t i)
+    {
+        this->words[i >> 6] |= (1ULL << (i & 63));
+    };
+    
+    inline bool get(const size_t i) const
+    {
+        return (this->words[i >> 6] >> (i & 63)) & 1;
+    };
+    
+    // To be called after the last set()
+    void buildRank()
+    {
+        auto numBlocks = this->words.size()/8;
+        size_t sum = 0;
+        
+        this->counts.resize(2*numBlocks);
+        for (auto b = 0; b < numBlocks; b++)
+        {
+            uint64_t packed = 0, inBlock = 0;
+            
+            this->counts[2*b] = sum;
+            for (auto w = 0; w < 8; w++)
+            {
+                if (w > 0)
+                    packed |= inBlock << (9*(w-1));
+                inBlock += popcount64(this->words[8*b+w]);
+            }
+            this->counts[2*b+1] = packed;
+            sum += inBlock;
+        }
+    };
+    
+    // True if the words and the counts fit numBits and each other, e.g., for
+    // a bitvector read from a file
+    bool check() const
+    {
+        auto numBlocks = this->words.size()/8;
+        size_t sum = 0;
+        
+        if ((this->words.size() != (this->numBits/512+1)*8) || (this->counts.size() != 2*numBlocks))
+            return false;
+        for (auto b = 0; b < numBlocks; b++)
+        {
+            uint64_t packed = 0, inBlock = 0;
+            
+            for (auto w = 0; w < 8; w++)
+            {
+                if (w > 0)
+                    packed |= inBlock << (9*(w-1));
+                inBlock += popcount64(this->words[8*b+w]);
+            }
+            if ((this->counts[2*b] != sum) || (this->counts[2*b+1] != packed))
+                return false;
+            sum += inBlock;
+        }
+        
+        return true;
+    };
+    
+    // Number of set bits in [0, i), for i <= numBits
+    inline size_t rank(const size_t i) const
+    {
+        const uint64_t *c = this->counts.data()+2*(i >> 9);
+        const uint64_t w = ((i >> 6) & 7)-1;
+        
+        // For the first word of the block, w wraps around and the shift
+        // lands on bit 63 of the packed counts, which is always 0.
+        return c[0]+((c[1] >> ((w+((w >> 60) & 8))*9)) & 0x1FF)+popcount64(this->words[i >> 6] & ((1ULL << (i & 63))-1));
+    };
+    
+    // Position of the first set bit from i on, or numBits
+    size_t nextSetBit(const size_t i) const
+    {
+        size_t w = i >> 6;
+        uint64_t x = this->words[w] & (~0ULL << (i & 63));
+        
+        while ((x == 0) && (++w < this->words.size()))
+            x = this->words[w];
+        
+        return (x == 0)? this->numBits: min(this->numBits, (w << 6)+__builtin_ctzll(x));
+    };
+    
+    // True until buildRank() is called
+    bool empty() const
+    {
+        return this->counts.empty();
+    };
+    
+    size_t getNumSetBits() const
+    {
+        return this->rank(this->numBits);
+    };
+    
+    size_t getSize() const
+    {
+        return (this->words.capacity()+this->counts.capacity())*sizeof(uint64_t);
+    };
+    
+    // Size in bytes of a bitvector of numBits bits, once its rank is built
+    static size_t getSize(const size_t numBits)
+    {
+        return (numBits/512+1)*10*sizeof(uint64_t);
+    };
+    
+    // Releases the memory, empty() from now on
+    void clear()
+    {
+        Words().swap(this->words);
+        Words().swap(this->counts);
+        this->numBits = 0;
+    };
+    
+    void swap(RankBitvector &rhs)
+    {
+        this->words.swap(rhs.words);
+        this->counts.swap(rhs.counts);
+        std::swap(this->numBits, rhs.numBits);
+    };
+    
+    ~RankBitvector()
+    {
+    };
+};
+
+
+
+// Rank over a sparse bitvector, i.e., with few set bits, for which the 1.25
+// bits per bit of RankBitvector dominate. The bits are split in buckets of
+// 2^shift bits, holding about 8 set bits each on average; the low shift bits
+// of every set bit are kept in sorted order, i.e., 16 bits each, along with
+// the number of set bits before every bucket, i.e., 4 bits per set bit. A
+// rank is then a lookup and a binary search within a bucket. Buckets span at
+// most 2^16 bits, so the extremely sparse bitvectors take 32 more bits every
+// 2^16 bits. Built like RankBitvector, but the bits must be set in order.
+class SparseRankBitvector
+{
+public:
+    vector<uint16_t> lows;
+    vector<uint32_t> starts;    // 1 per bucket, plus 1
+    unsigned int shift;
+    size_t numBits;
+    
+    SparseRankBitvector()
+    {
+        this->shift   = 0;
+        this->numBits = 0;
+    };
+    
+    // As for RankBitvector, there is always a bucket for bit numBits
+    void init(const size_t numBits, const size_t numSetBits)
+    {
+        this->numBits = numBits;
+        this->shift   = getShift(numBits, numSetBits);
+        this->lows.clear();
+        this->lows.reserve(numSetBits);
+        this->starts.assign((numBits >> this->shift)+2, 0);
+    };
+    
+    // Bits must be set in increasing order
+    inline void set(const size_t i)
+    {
+        this->lows.push_back(i & ((1ULL << this->shift)-1));
+        this->starts[(i >> this->shift)+1]++;
+    };
+    
+    // Same set bits as a RankBitvector
+    void build(const RankBitvector &dir)
+    {
+        this->init(dir.numBits, dir.getNumSetBits());
+        for (size_t i = dir.nextSetBit(0); i < dir.numBits; i = dir.nextSetBit(i+1))
+            this->set(i);
+        this->buildRank();
+    };
+    
+    // To be called after the last set()
+    void buildRank()
+    {
+        for (auto b = 1; b < this->starts.size(); b++)
+            this->starts[b] += this->starts[b-1];
+    };
+    
+    // Number of set bits in [0, i), for i <= numBits
+    inline size_t rank(const size_t i) const
+    {
+        const uint16_t *first = this->lows.data()+this->starts[i >> this->shift];
+        const uint16_t *last  = this->lows.data()+this->starts[(i >> this->shift)+1];
+        
+        return std::lower_bound(first, last, (uint16_t)(i & ((1ULL << this->shift)-1)))-this->lows.data();
+    };
+    
+    // True until init() is called
+    bool empty() const
+    {
+        return this->starts.empty();
+    };
+    
+    // Releases the memory, empty() from now on
+    void clear()
+    {
+        vector<uint16_t>().swap(this->lows);
+        vector<uint32_t>().swap(this->starts);
+        this->numBits = 0;
+    };
+    
+    size_t getNumSetBits() const
+    {
+        return this->lows.size();
+    };
+    
+    size_t getSize() const
+    {
+        return this->lows.capacity()*sizeof(uint16_t)+this->starts.capacity()*sizeof(uint32_t);
+    };
+    
+    // Size in bytes for numSetBits set bits out of numBits; worth it over
+    // RankBitvector::getSize(numBits) roughly when fewer than a bit in 16 is set
+    static size_t getSize(const size_t numBits, const size_t numSetBits)
+    {
+        return numSetBits*sizeof(uint16_t)+((numBits >> getShift(numBits, numSetBits))+2)*sizeof(uint32_t);
+    };
+    
+    // Smallest bucket holding 8 set bits on average, up to 2^16 bits
+    static unsigned int getShift(const size_t numBits, const size_t numSetBits)
+    {
+        unsigned int shift = 0;
+        
+        while ((shift < 16) && ((((size_t)1) << shift)*max(numSetBits, (size_t)1) < 8*numBits))
+            shift++;
+        
+        return shift;
+    };
+    
+    ~SparseRankBitvector()
+    {
+    };
+};
+#endif //_BITVECTOR_H_
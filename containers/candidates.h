@@ -0,0 +1,107 @@
+/******************************************************************************
+ * Project:  hint
+ * Purpose:  Indexing interval data
+ * Author:   Panagiotis Bouros, pbour@github.io
+ * Author:   George Christodoulou
+ ******************************************************************************
+ * Copyright (c) 2020 - 2024
+ *
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************/
+
+
+#ifndef _CANDIDATES_H_
+#define _CANDIDATES_H_
+
+#include "../def_global.h"
+#include "relation.h"
+
+
+
+// Set of candidate record ids used by the HINT^m query algorithms that need
+// to match the contents of two different partition classes (e.g., EQUALS).
+// Membership is marked by stamping the id with the epoch of the current
+// query, so reset() costs O(1) instead of clearing |R| bits; the stamps array
+// only grows up to the largest id ever inserted.
+class CandidateSet
+{
+private:
+    vector<unsigned int> stamps;
+    unsigned int epoch;
+    
+public:
+    CandidateSet()
+    {
+        this->epoch = 1;
+    };
+    
+    inline void reset()
+    {
+        this->epoch++;
+        
+        // Wrap-around; stale stamps could collide with the new epoch
+        if (this->epoch == 0)
+        {
+            fill(this->stamps.begin(), this->stamps.end(), 0);
+            this->epoch = 1;
+        }
+    };
+    
+    inline bool contains(const RecordId id) const
+    {
+        return (((size_t)id < this->stamps.size()) && (this->stamps[id] == this->epoch));
+    };
+    
+    inline void insert(const RecordId id)
+    {
+        if ((size_t)id >= this->stamps.size())
+            this->stamps.resize(max((size_t)id+1, 2*this->stamps.size()), 0);
+        this->stamps[id] = this->epoch;
+    };
+    
+    ~CandidateSet()
+    {
+    };
+};
+
+
+
+// Contiguous range of record ids that qualify without comparisons.
+typedef pair<RelationIdIterator, RelationIdIterator> IdRange;
+
+
+
+// Per-thread scratch space reused across queries.
+class QueryContext
+{
+public:
+    CandidateSet vcand;
+    vector<IdRange> ranges;
+    
+    // Returns the context of the calling thread.
+    static inline QueryContext& local()
+    {
+        static thread_local QueryContext ctx;
+        
+        return ctx;
+    };
+};
+#endif //_CANDIDATES_H_
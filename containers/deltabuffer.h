@@ -0,0 +1,195 @@
+/******************************************************************************
+ * Project:  hint
+ * Purpose:  Indexing interval data
+ * Author:   Panagiotis Bouros, pbour@github.io
+ * Author:   George Christodoulou
+ ******************************************************************************
+ * Copyright (c) 2020 - 2024
+ *
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************/
+
+#ifndef _DELTABUFFER_H_
+#define _DELTABUFFER_H_
+
+#include "../def_global.h"
+#include "relation.h"
+#include "kernels.h"
+
+#define DELTA_BUFFER_CAPACITY 4096  // Default number of insertions kept before a merge
+
+
+
+// Records inserted in an index after it was built, see
+// HierarchicalIndex::insert(). They are kept sorted by start, then end, until
+// they are merged in the index in bulk; meanwhile, every query also probes
+// the buffer. A predicate on a single interval is a box over its endpoints,
+// see scanRecords() in containers/kernels.h, so only the records with a start
+// inside the box, found by binary search, are scanned.
+class DeltaBuffer
+{
+public:
+    Relation records;
+    size_t capacity;
+    
+    DeltaBuffer()
+    {
+        this->capacity = DELTA_BUFFER_CAPACITY;
+    };
+    
+    inline size_t size() const {return this->records.size();};
+    inline bool empty() const {return this->records.empty();};
+    inline bool isFull() const {return (this->records.size() >= this->capacity);};
+    inline void clear() {this->records.clear();};
+    
+    inline void insert(const Record &r)
+    {
+        this->records.insert(upper_bound(this->records.begin(), this->records.end(), r), r);
+    };
+    
+    // Removes record r; false if it is not in the buffer
+    inline bool erase(const Record &r)
+    {
+        auto range = equal_range(this->records.begin(), this->records.end(), r);
+        
+        for (auto iter = range.first; iter != range.second; iter++)
+        {
+            if (iter->id == r.id)
+            {
+                this->records.erase(iter);
+                return true;
+            }
+        }
+        
+        return false;
+    };
+    
+    // Reports the records with sLo <= start <= sHi and eLo <= end <= eHi
+    template <class Sink>
+    inline void scan(const unsigned int kernel, const Timestamp sLo, const Timestamp sHi, const Timestamp eLo, const Timestamp eHi, Sink &result) const
+    {
+        if (this->records.empty())
+            return;
+        
+        auto first = lower_bound(this->records.begin(), this->records.end(), sLo, [](const Record &r, const Timestamp t) {return (r.start < t);});
+        auto last  = upper_bound(first, this->records.end(), sHi, [](const Timestamp t, const Record &r) {return (t < r.start);});
+        
+        if (first < last)
+            scanRecords(kernel, &(*first), last-first, sLo, sHi, eLo, eHi, result);
+    };
+    
+    // Basic predicates of Allen's algebra, see Relation
+    template <class Sink> inline void execute_Equals(const unsigned int kernel, RangeQuery Q, Sink &result) const
+    {
+        this->scan(kernel, Q.start, Q.start, Q.end, Q.end, result);
+    };
+    
+    template <class Sink> inline void execute_Starts(const unsigned int kernel, RangeQuery Q, Sink &result) const
+    {
+        this->scan(kernel, Q.start, Q.start, Q.end+1, numeric_limits<Timestamp>::max(), result);
+    };
+    
+    template <class Sink> inline void execute_Started(const unsigned int kernel, RangeQuery Q, Sink &result) const
+    {
+        this->scan(kernel, Q.start, Q.start, numeric_limits<Timestamp>::min(), Q.end-1, result);
+    };
+    
+    template <class Sink> inline void execute_Finishes(const unsigned int kernel, RangeQuery Q, Sink &result) const
+    {
+        this->scan(kernel, numeric_limits<Timestamp>::min(), Q.start-1, Q.end, Q.end, result);
+    };
+    
+    template <class Sink> inline void execute_Finished(const unsigned int kernel, RangeQuery Q, Sink &result) const
+    {
+        this->scan(kernel, Q.start+1, numeric_limits<Timestamp>::max(), Q.end, Q.end, result);
+    };
+    
+    template <class Sink> inline void execute_Meets(const unsigned int kernel, RangeQuery Q, Sink &result) const
+    {
+        this->scan(kernel, Q.end, Q.end, numeric_limits<Timestamp>::min(), numeric_limits<Timestamp>::max(), result);
+    };
+    
+    template <class Sink> inline void execute_Met(const unsigned int kernel, RangeQuery Q, Sink &result) const
+    {
+        this->scan(kernel, numeric_limits<Timestamp>::min(), numeric_limits<Timestamp>::max(), Q.start, Q.start, result);
+    };
+    
+    template <class Sink> inline void execute_Overlaps(const unsigned int kernel, RangeQuery Q, Sink &result) const
+    {
+        this->scan(kernel, Q.start+1, Q.end-1, Q.end+1, numeric_limits<Timestamp>::max(), result);
+    };
+    
+    template <class Sink> inline void execute_Overlapped(const unsigned int kernel, RangeQuery Q, Sink &result) const
+    {
+        this->scan(kernel, numeric_limits<Timestamp>::min(), Q.start-1, Q.start+1, Q.end-1, result);
+    };
+    
+    template <class Sink> inline void execute_Contains(const unsigned int kernel, RangeQuery Q, Sink &result) const
+    {
+        this->scan(kernel, Q.start+1, numeric_limits<Timestamp>::max(), numeric_limits<Timestamp>::min(), Q.end-1, result);
+    };
+    
+    template <class Sink> inline void execute_Contained(const unsigned int kernel, RangeQuery Q, Sink &result) const
+    {
+        this->scan(kernel, numeric_limits<Timestamp>::min(), Q.start-1, Q.end+1, numeric_limits<Timestamp>::max(), result);
+    };
+    
+    template <class Sink> inline void execute_Precedes(const unsigned int kernel, RangeQuery Q, Sink &result) const
+    {
+        this->scan(kernel, Q.end+1, numeric_limits<Timestamp>::max(), numeric_limits<Timestamp>::min(), numeric_limits<Timestamp>::max(), result);
+    };
+    
+    template <class Sink> inline void execute_Preceded(const unsigned int kernel, RangeQuery Q, Sink &result) const
+    {
+        this->scan(kernel, numeric_limits<Timestamp>::min(), numeric_limits<Timestamp>::max(), numeric_limits<Timestamp>::min(), Q.start-1, result);
+    };
+    
+    // Generalized predicate, ACM SIGMOD'22 gOverlaps
+    template <class Sink> inline void execute_gOverlaps(const unsigned int kernel, StabbingQuery Q, Sink &result) const
+    {
+        this->scan(kernel, numeric_limits<Timestamp>::min(), Q.point, Q.point, numeric_limits<Timestamp>::max(), result);
+    };
+    
+    template <class Sink> inline void execute_gOverlaps(const unsigned int kernel, RangeQuery Q, Sink &result) const
+    {
+        this->scan(kernel, numeric_limits<Timestamp>::min(), Q.end, Q.start, numeric_limits<Timestamp>::max(), result);
+    };
+};
+
+
+
+// Merging the buffer in an index whose partitions lie contiguously in one
+// array per level and partition class.
+
+// Opens a gap of counts[pId] entries at the end of every partition pId of
+// level array v, given the offsets of its numPartitions partitions; the
+// partitions are moved back to front, so that it is done in place.
+template <class Array, class Offset, class Counter>
+void openPartitionGaps(Array &v, const Offset *offsets, const Counter *counts, const PartitionId numPartitions, size_t numInserted)
+{
+    v.resize(v.size()+numInserted);
+    for (auto pId = numPartitions-1; (pId >= 0) && (numInserted > 0); pId--)
+    {
+        numInserted -= counts[pId];
+        move_backward(v.begin()+offsets[pId], v.begin()+offsets[pId+1], v.begin()+offsets[pId+1]+numInserted);
+    }
+}
+#endif // _DELTABUFFER_H_
@@ -0,0 +1,155 @@
+/******************************************************************************
+ * Project:  hint
+ * Purpose:  Indexing interval data
+ * Author:   Panagiotis Bouros, pbour@github.io
+ * Author:   George Christodoulou
+ ******************************************************************************
+ * Copyright (c) 2020 - 2024
+ *
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************/
+
+
+
+#ifndef _INDEXHANDLE_H_
+#define _INDEXHANDLE_H_
+
+#include "../def_global.h"
+#include <atomic>
+#include <thread>
+
+#define INDEX_HANDLE_RETIRE_WAIT 100    // Microseconds between two checks for the readers of a retired index
+
+
+
+// Handle through which concurrent readers share an index that is rebuilt
+// from time to time, RCU-style. A reader acquires the current index and
+// evaluates on it for as long as it holds the Reader; the writer publishes
+// a rebuilt index by swapping the pointer, so the readers never wait for
+// the rebuild, and new readers see the rebuilt index right away. The old
+// index is retired: the writer waits until the readers in flight release
+// it and frees it itself, so no reader pays for freeing a whole index.
+//
+// The readers are tracked by epoch, without any lock: a reader registers in
+// the counter of the current epoch, by parity, before it loads the pointer,
+// and checks that the epoch has not moved meanwhile, else it registers
+// again. A publish swaps the pointer and then starts a new epoch, so the
+// readers of the new epoch load the new index, and only those registered in
+// the old epoch may hold the old one; once its counter drops to zero, the
+// old index is freed. The readers of the epoch before were waited for by the
+// previous publish, so the two parities are enough. The publishes must be
+// serialized by the caller.
+template <class Index>
+class IndexHandle
+{
+private:
+    atomic<Index *> idx;
+    atomic<size_t> epoch;
+    mutable atomic<size_t> numReaders[2];    // Readers registered in every epoch, by parity
+    
+public:
+    // A reader of the index; the index stays alive for as long as it exists
+    class Reader
+    {
+    private:
+        const IndexHandle *handle;
+        size_t slot;
+        Index *idx;
+        
+    public:
+        Reader(const IndexHandle &handle) : handle(&handle)
+        {
+            while (true)
+            {
+                size_t e = handle.epoch.load();
+                
+                this->slot = e%2;
+                handle.numReaders[this->slot]++;
+                if (handle.epoch.load() == e)
+                    break;
+                handle.numReaders[this->slot]--;
+            }
+            this->idx = handle.idx.load();
+        };
+        
+        Reader(Reader &&other) : handle(other.handle), slot(other.slot), idx(other.idx)
+        {
+            other.handle = NULL;
+        };
+        
+        Reader(const Reader &) = delete;
+        Reader &operator=(const Reader &) = delete;
+        
+        inline Index *get() const {return this->idx;};
+        inline Index *operator->() const {return this->idx;};
+        inline Index &operator*() const {return *this->idx;};
+        
+        ~Reader()
+        {
+            if (this->handle != NULL)
+                this->handle->numReaders[this->slot]--;
+        };
+    };
+    
+    atomic<size_t> numSwaps;
+    
+    IndexHandle(Index *idx)
+    {
+        this->idx           = idx;
+        this->epoch         = 0;
+        this->numReaders[0] = this->numReaders[1] = 0;
+        this->numSwaps      = 0;
+    };
+    
+    
+    // Readers
+    inline Reader acquire() const
+    {
+        return Reader(*this);
+    };
+    
+    
+    // Writer; the current index, for the writer only, as a publish frees it
+    inline Index *get() const
+    {
+        return this->idx.load();
+    };
+    
+    // Takes ownership of idx, and returns once the index it replaces is freed
+    void publish(Index *idx)
+    {
+        Index *old = this->idx.exchange(idx);
+        size_t e = this->epoch++;
+        
+        this->numSwaps++;
+        
+        // No reader stays registered in epoch e any more, so its count only drops
+        while (this->numReaders[e%2] > 0)
+            this_thread::sleep_for(chrono::microseconds(INDEX_HANDLE_RETIRE_WAIT));
+        delete old;
+    };
+    
+    ~IndexHandle()
+    {
+        delete this->idx.load();
+    };
+};
+#endif // _INDEXHANDLE_H_
@@ -0,0 +1,836 @@
+/******************************************************************************
+ * Project:  hint
+ * Purpose:  Indexing interval data
+ * Author:   Panagiotis Bouros, pbour@github.io
+ * Author:   George Christodoulou
+ ******************************************************************************
+ * Copyright (c) 2020 - 2024
+ *
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************/
+
+
+#ifndef _KERNELS_H_
+#define _KERNELS_H_
+
+#include "../def_global.h"
+#include "relation.h"
+#include "sinks.h"
+#include <immintrin.h>
+
+
+
+// Scan kernels for the loops that report the ids of a partition or check a
+// timestamp of every record. Each kernel comes in a scalar, an SSE4.2 (4
+// lanes), an AVX2 (8 lanes) and an AVX-512 (16 lanes) version, compiled side
+// by side through target attributes, so that the binary does not depend on
+// the instruction set of the build machine. The version is selected once by
+// getScanKernel() from the CPU features and stored in every index at
+// construction; the dispatchers below take it as their first argument.
+//
+// The comparison kernels produce a bitmask per vector which is counted with
+// a popcount by a CountSink, otherwise the ids of the set bits are reported
+// one by one, or compress-stored first under AVX-512.
+
+#define SCAN_KERNEL_SCALAR  0
+#define SCAN_KERNEL_SSE42   1
+#define SCAN_KERNEL_AVX2    2
+#define SCAN_KERNEL_AVX512  3
+
+#define TARGET_SSE42  __attribute__((target("sse4.2,popcnt")))
+#define TARGET_AVX2   __attribute__((target("avx2,popcnt")))
+#define TARGET_AVX512 __attribute__((target("avx512f,avx2,popcnt")))
+
+#define PREFETCH_IDS_LINES 4    // Cache lines of ids prefetched ahead of a range, see prefetchIds()
+
+
+inline const char* getScanKernelName(const unsigned int kernel)
+{
+    switch (kernel)
+    {
+        case SCAN_KERNEL_SSE42:
+            return "sse4.2";
+        case SCAN_KERNEL_AVX2:
+            return "avx2";
+        case SCAN_KERNEL_AVX512:
+            return "avx512";
+        default:
+            return "scalar";
+    }
+}
+
+
+// Returns the widest kernel set the CPU supports; a narrower one can be
+// forced by setting HINT_SCAN_KERNEL to its name, e.g., for testing.
+inline unsigned int detectScanKernel()
+{
+    unsigned int kernel = SCAN_KERNEL_SCALAR;
+    const char *forced = getenv("HINT_SCAN_KERNEL");
+    
+    
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        kernel = SCAN_KERNEL_AVX512;
+    else if (__builtin_cpu_supports("avx2"))
+        kernel = SCAN_KERNEL_AVX2;
+    else if ((__builtin_cpu_supports("sse4.2")) && (__builtin_cpu_supports("popcnt")))
+        kernel = SCAN_KERNEL_SSE42;
+    
+    if (forced)
+    {
+        for (unsigned int k = SCAN_KERNEL_SCALAR; k < kernel; k++)
+        {
+            if (!strcmp(forced, getScanKernelName(k)))
+                return k;
+        }
+    }
+    
+    return kernel;
+}
+
+
+inline unsigned int getScanKernel()
+{
+    static const unsigned int kernel = detectScanKernel();
+    
+    return kernel;
+}
+
+
+
+// Reports the ids whose bits are set in mask; ids points to the id of bit 0.
+template <class Sink>
+inline void reportMask(const RecordId *ids, unsigned int mask, Sink &result)
+{
+    while (mask)
+    {
+        result.add(ids[__builtin_ctz(mask)]);
+        mask &= mask-1;
+    }
+}
+
+inline void reportMask(const RecordId *, unsigned int mask, CountSink &result)
+{
+    result.result += __builtin_popcount(mask);
+}
+
+
+template <class Sink>
+TARGET_AVX512 inline void reportMask16(const __m512i vids, __mmask16 mask, Sink &result)
+{
+    RecordId buffer[16];
+    
+    _mm512_mask_compressstoreu_epi32(buffer, mask, vids);
+    result.addRange(buffer, buffer+__builtin_popcount(mask));
+}
+
+TARGET_AVX512 inline void reportMask16(const __m512i, __mmask16 mask, CountSink &result)
+{
+    result.result += __builtin_popcount(mask);
+}
+
+
+
+// Reports ids[i] for every i in [0, n) with qt <= tstamps[i]. The timestamps
+// must be stored in a dedicated array, i.e., not interleaved with other data,
+// so that the loads are contiguous.
+template <class Sink>
+inline void scanNotBefore_Scalar(const Timestamp *tstamps, const RecordId *ids, const size_t n, const Timestamp qt, Sink &result)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        if (qt <= tstamps[i])
+            result.add(ids[i]);
+    }
+}
+
+template <class Sink>
+TARGET_SSE42 void scanNotBefore_SSE42(const Timestamp *tstamps, const RecordId *ids, const size_t n, const Timestamp qt, Sink &result)
+{
+    const __m128i vq = _mm_set1_epi32(qt);
+    size_t i = 0;
+    
+    
+    for (; i+4 <= n; i += 4)
+    {
+        // qt <= t is !(qt > t)
+        __m128i vlt = _mm_cmpgt_epi32(vq, _mm_loadu_si128((const __m128i*)(tstamps+i)));
+        unsigned int mask = ~_mm_movemask_ps(_mm_castsi128_ps(vlt)) & 0xF;
+        if (mask)
+            reportMask(ids+i, mask, result);
+    }
+    scanNotBefore_Scalar(tstamps+i, ids+i, n-i, qt, result);
+}
+
+template <class Sink>
+TARGET_AVX2 void scanNotBefore_AVX2(const Timestamp *tstamps, const RecordId *ids, const size_t n, const Timestamp qt, Sink &result)
+{
+    const __m256i vq = _mm256_set1_epi32(qt);
+    size_t i = 0;
+    
+    
+    for (; i+8 <= n; i += 8)
+    {
+        __m256i vlt = _mm256_cmpgt_epi32(vq, _mm256_loadu_si256((const __m256i*)(tstamps+i)));
+        unsigned int mask = ~_mm256_movemask_ps(_mm256_castsi256_ps(vlt)) & 0xFF;
+        if (mask)
+            reportMask(ids+i, mask, result);
+    }
+    scanNotBefore_Scalar(tstamps+i, ids+i, n-i, qt, result);
+}
+
+template <class Sink>
+TARGET_AVX512 void scanNotBefore_AVX512(const Timestamp *tstamps, const RecordId *ids, const size_t n, const Timestamp qt, Sink &result)
+{
+    const __m512i vq = _mm512_set1_epi32(qt);
+    size_t i = 0;
+    
+    
+    for (; i+16 <= n; i += 16)
+    {
+        __mmask16 mask = _mm512_cmpge_epi32_mask(_mm512_loadu_si512(tstamps+i), vq);
+        if (mask)
+            reportMask16(_mm512_loadu_si512(ids+i), mask, result);
+    }
+    scanNotBefore_Scalar(tstamps+i, ids+i, n-i, qt, result);
+}
+
+template <class Sink>
+inline void scanNotBefore(const unsigned int kernel, const Timestamp *tstamps, const RecordId *ids, const size_t n, const Timestamp qt, Sink &result)
+{
+    switch (kernel)
+    {
+        case SCAN_KERNEL_AVX512:
+            scanNotBefore_AVX512(tstamps, ids, n, qt, result);
+            break;
+        case SCAN_KERNEL_AVX2:
+            scanNotBefore_AVX2(tstamps, ids, n, qt, result);
+            break;
+        case SCAN_KERNEL_SSE42:
+            scanNotBefore_SSE42(tstamps, ids, n, qt, result);
+            break;
+        default:
+            scanNotBefore_Scalar(tstamps, ids, n, qt, result);
+    }
+}
+
+
+
+// Reports recs[i].id for every i in [0, n) with sLo <= recs[i].start <= sHi
+// and eLo <= recs[i].end <= eHi. Every predicate on a single interval is such
+// a box over its endpoints; strict comparisons become +/-1 and unbounded
+// sides numeric_limits<Timestamp>::min()/max(). The records are loaded as
+// they are stored and deinterleaved into vectors of ids, starts and ends with
+// two blends and a permutation each.
+static_assert(sizeof(Record) == 3*sizeof(Timestamp), "Record is expected to be (id, start, end)");
+
+template <class Sink>
+inline void scanRecords_Scalar(const Record *recs, const size_t n, const Timestamp sLo, const Timestamp sHi, const Timestamp eLo, const Timestamp eHi, Sink &result)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        if ((sLo <= recs[i].start) && (recs[i].start <= sHi) && (eLo <= recs[i].end) && (recs[i].end <= eHi))
+            result.add(recs[i].id);
+    }
+}
+
+template <class Sink>
+TARGET_SSE42 void scanRecords_SSE42(const Record *recs, const size_t n, const Timestamp sLo, const Timestamp sHi, const Timestamp eLo, const Timestamp eHi, Sink &result)
+{
+    const __m128i vsLo = _mm_set1_epi32(sLo), vsHi = _mm_set1_epi32(sHi);
+    const __m128i veLo = _mm_set1_epi32(eLo), veHi = _mm_set1_epi32(eHi);
+    RecordId buffer[4];
+    size_t i = 0;
+    
+    
+    for (; i+4 <= n; i += 4)
+    {
+        const __m128i *p = (const __m128i*)(recs+i);
+        __m128i a = _mm_loadu_si128(p), b = _mm_loadu_si128(p+1), c = _mm_loadu_si128(p+2);
+        __m128i vs = _mm_shuffle_epi32(_mm_blend_epi16(_mm_blend_epi16(a, b, 0xC3), c, 0x30), _MM_SHUFFLE(2,3,0,1));
+        __m128i ve = _mm_shuffle_epi32(_mm_blend_epi16(_mm_blend_epi16(a, b, 0x0C), c, 0xC3), _MM_SHUFFLE(3,0,1,2));
+        
+        // A record is out of the box if any of its bounds is violated
+        __m128i vout = _mm_or_si128(_mm_or_si128(_mm_cmpgt_epi32(vsLo, vs), _mm_cmpgt_epi32(vs, vsHi)),
+                                    _mm_or_si128(_mm_cmpgt_epi32(veLo, ve), _mm_cmpgt_epi32(ve, veHi)));
+        unsigned int mask = ~_mm_movemask_ps(_mm_castsi128_ps(vout)) & 0xF;
+        if (mask)
+        {
+            __m128i vids = _mm_shuffle_epi32(_mm_blend_epi16(_mm_blend_epi16(a, b, 0x30), c, 0x0C), _MM_SHUFFLE(1,2,3,0));
+            _mm_storeu_si128((__m128i*)buffer, vids);
+            reportMask(buffer, mask, result);
+        }
+    }
+    scanRecords_Scalar(recs+i, n-i, sLo, sHi, eLo, eHi, result);
+}
+
+template <class Sink>
+TARGET_AVX2 void scanRecords_AVX2(const Record *recs, const size_t n, const Timestamp sLo, const Timestamp sHi, const Timestamp eLo, const Timestamp eHi, Sink &result)
+{
+    const __m256i vsLo = _mm256_set1_epi32(sLo), vsHi = _mm256_set1_epi32(sHi);
+    const __m256i veLo = _mm256_set1_epi32(eLo), veHi = _mm256_set1_epi32(eHi);
+    const __m256i pids = _mm256_setr_epi32(0, 3, 6, 1, 4, 7, 2, 5);
+    const __m256i pstarts = _mm256_setr_epi32(1, 4, 7, 2, 5, 0, 3, 6);
+    const __m256i pends = _mm256_setr_epi32(2, 5, 0, 3, 6, 1, 4, 7);
+    RecordId buffer[8];
+    size_t i = 0;
+    
+    
+    for (; i+8 <= n; i += 8)
+    {
+        const __m256i *p = (const __m256i*)(recs+i);
+        __m256i a = _mm256_loadu_si256(p), b = _mm256_loadu_si256(p+1), c = _mm256_loadu_si256(p+2);
+        __m256i vs = _mm256_permutevar8x32_epi32(_mm256_blend_epi32(_mm256_blend_epi32(a, b, 0x24), c, 0x49), pstarts);
+        __m256i ve = _mm256_permutevar8x32_epi32(_mm256_blend_epi32(_mm256_blend_epi32(a, b, 0x49), c, 0x92), pends);
+        
+        __m256i vout = _mm256_or_si256(_mm256_or_si256(_mm256_cmpgt_epi32(vsLo, vs), _mm256_cmpgt_epi32(vs, vsHi)),
+                                       _mm256_or_si256(_mm256_cmpgt_epi32(veLo, ve), _mm256_cmpgt_epi32(ve, veHi)));
+        unsigned int mask = ~_mm256_movemask_ps(_mm256_castsi256_ps(vout)) & 0xFF;
+        if (mask)
+        {
+            __m256i vids = _mm256_permutevar8x32_epi32(_mm256_blend_epi32(_mm256_blend_epi32(a, b, 0x92), c, 0x24), pids);
+            _mm256_storeu_si256((__m256i*)buffer, vids);
+            reportMask(buffer, mask, result);
+        }
+    }
+    scanRecords_Scalar(recs+i, n-i, sLo, sHi, eLo, eHi, result);
+}
+
+template <class Sink>
+TARGET_AVX512 void scanRecords_AVX512(const Record *recs, const size_t n, const Timestamp sLo, const Timestamp sHi, const Timestamp eLo, const Timestamp eHi, Sink &result)
+{
+    const __m512i vsLo = _mm512_set1_epi32(sLo), vsHi = _mm512_set1_epi32(sHi);
+    const __m512i veLo = _mm512_set1_epi32(eLo), veHi = _mm512_set1_epi32(eHi);
+    const __m512i pids = _mm512_setr_epi32(0, 3, 6, 9, 12, 15, 2, 5, 8, 11, 14, 1, 4, 7, 10, 13);
+    const __m512i pstarts = _mm512_setr_epi32(1, 4, 7, 10, 13, 0, 3, 6, 9, 12, 15, 2, 5, 8, 11, 14);
+    const __m512i pends = _mm512_setr_epi32(2, 5, 8, 11, 14, 1, 4, 7, 10, 13, 0, 3, 6, 9, 12, 15);
+    size_t i = 0;
+    
+    
+    for (; i+16 <= n; i += 16)
+    {
+        const Timestamp *p = (const Timestamp*)(recs+i);
+        __m512i a = _mm512_loadu_si512(p), b = _mm512_loadu_si512(p+16), c = _mm512_loadu_si512(p+32);
+        __m512i vs = _mm512_permutexvar_epi32(pstarts, _mm512_mask_blend_epi32(0x4924, _mm512_mask_blend_epi32(0x9249, a, b), c));
+        __m512i ve = _mm512_permutexvar_epi32(pends, _mm512_mask_blend_epi32(0x9249, _mm512_mask_blend_epi32(0x2492, a, b), c));
+        
+        __mmask16 mask = _mm512_cmpge_epi32_mask(vs, vsLo);
+        mask = _mm512_mask_cmple_epi32_mask(mask, vs, vsHi);
+        mask = _mm512_mask_cmpge_epi32_mask(mask, ve, veLo);
+        mask = _mm512_mask_cmple_epi32_mask(mask, ve, veHi);
+        if (mask)
+            reportMask16(_mm512_permutexvar_epi32(pids, _mm512_mask_blend_epi32(0x2492, _mm512_mask_blend_epi32(0x4924, a, b), c)), mask, result);
+    }
+    scanRecords_Scalar(recs+i, n-i, sLo, sHi, eLo, eHi, result);
+}
+
+template <class Sink>
+inline void scanRecords(const unsigned int kernel, const Record *recs, const size_t n, const Timestamp sLo, const Timestamp sHi, const Timestamp eLo, const Timestamp eHi, Sink &result)
+{
+    switch (kernel)
+    {
+        case SCAN_KERNEL_AVX512:
+            scanRecords_AVX512(recs, n, sLo, sHi, eLo, eHi, result);
+            break;
+        case SCAN_KERNEL_AVX2:
+            scanRecords_AVX2(recs, n, sLo, sHi, eLo, eHi, result);
+            break;
+        case SCAN_KERNEL_SSE42:
+            scanRecords_SSE42(recs, n, sLo, sHi, eLo, eHi, result);
+            break;
+        default:
+            scanRecords_Scalar(recs, n, sLo, sHi, eLo, eHi, result);
+    }
+}
+
+template <class Sink>
+inline void scanRecords(const unsigned int kernel, const Relation &P, const Timestamp sLo, const Timestamp sHi, const Timestamp eLo, const Timestamp eHi, Sink &result)
+{
+    scanRecords(kernel, P.data(), P.size(), sLo, sHi, eLo, eHi, result);
+}
+
+
+
+// Reports ids[i] for every i in [0, n) with sLo <= tstamps[i].first <= sHi
+// and tstamps[i].second in [eLo, eHi], i.e., the box of scanRecords() over
+// the (start, end) pairs that the cash misses optimization keeps apart from
+// the ids. The pairs are deinterleaved into vectors of starts and ends with
+// shuffles, or two-source permutations under AVX-512.
+static_assert(sizeof(pair<Timestamp, Timestamp>) == 2*sizeof(Timestamp), "Timestamp pairs are expected to be packed");
+
+template <class Sink>
+inline void scanPairs_Scalar(const pair<Timestamp, Timestamp> *tstamps, const RecordId *ids, const size_t n, const Timestamp sLo, const Timestamp sHi, const Timestamp eLo, const Timestamp eHi, Sink &result)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        if ((sLo <= tstamps[i].first) && (tstamps[i].first <= sHi) && (eLo <= tstamps[i].second) && (tstamps[i].second <= eHi))
+            result.add(ids[i]);
+    }
+}
+
+template <class Sink>
+TARGET_SSE42 void scanPairs_SSE42(const pair<Timestamp, Timestamp> *tstamps, const RecordId *ids, const size_t n, const Timestamp sLo, const Timestamp sHi, const Timestamp eLo, const Timestamp eHi, Sink &result)
+{
+    const __m128i vsLo = _mm_set1_epi32(sLo), vsHi = _mm_set1_epi32(sHi);
+    const __m128i veLo = _mm_set1_epi32(eLo), veHi = _mm_set1_epi32(eHi);
+    size_t i = 0;
+    
+    
+    for (; i+4 <= n; i += 4)
+    {
+        const float *p = (const float*)(tstamps+i);
+        __m128 a = _mm_loadu_ps(p), b = _mm_loadu_ps(p+4);
+        __m128i vs = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2,0,2,0)));
+        __m128i ve = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(3,1,3,1)));
+        
+        __m128i vout = _mm_or_si128(_mm_or_si128(_mm_cmpgt_epi32(vsLo, vs), _mm_cmpgt_epi32(vs, vsHi)),
+                                    _mm_or_si128(_mm_cmpgt_epi32(veLo, ve), _mm_cmpgt_epi32(ve, veHi)));
+        unsigned int mask = ~_mm_movemask_ps(_mm_castsi128_ps(vout)) & 0xF;
+        if (mask)
+            reportMask(ids+i, mask, result);
+    }
+    scanPairs_Scalar(tstamps+i, ids+i, n-i, sLo, sHi, eLo, eHi, result);
+}
+
+template <class Sink>
+TARGET_AVX2 void scanPairs_AVX2(const pair<Timestamp, Timestamp> *tstamps, const RecordId *ids, const size_t n, const Timestamp sLo, const Timestamp sHi, const Timestamp eLo, const Timestamp eHi, Sink &result)
+{
+    const __m256i vsLo = _mm256_set1_epi32(sLo), vsHi = _mm256_set1_epi32(sHi);
+    const __m256i veLo = _mm256_set1_epi32(eLo), veHi = _mm256_set1_epi32(eHi);
+    size_t i = 0;
+    
+    
+    for (; i+8 <= n; i += 8)
+    {
+        const float *p = (const float*)(tstamps+i);
+        __m256 a = _mm256_loadu_ps(p), b = _mm256_loadu_ps(p+8);
+        
+        // The shuffle works within 128-bit lanes, the permutation restores
+        // the order of the 64-bit halves
+        __m256i vs = _mm256_permute4x64_epi64(_mm256_castps_si256(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(2,0,2,0))), _MM_SHUFFLE(3,1,2,0));
+        __m256i ve = _mm256_permute4x64_epi64(_mm256_castps_si256(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(3,1,3,1))), _MM_SHUFFLE(3,1,2,0));
+        
+        __m256i vout = _mm256_or_si256(_mm256_or_si256(_mm256_cmpgt_epi32(vsLo, vs), _mm256_cmpgt_epi32(vs, vsHi)),
+                                       _mm256_or_si256(_mm256_cmpgt_epi32(veLo, ve), _mm256_cmpgt_epi32(ve, veHi)));
+        unsigned int mask = ~_mm256_movemask_ps(_mm256_castsi256_ps(vout)) & 0xFF;
+        if (mask)
+            reportMask(ids+i, mask, result);
+    }
+    scanPairs_Scalar(tstamps+i, ids+i, n-i, sLo, sHi, eLo, eHi, result);
+}
+
+template <class Sink>
+TARGET_AVX512 void scanPairs_AVX512(const pair<Timestamp, Timestamp> *tstamps, const RecordId *ids, const size_t n, const Timestamp sLo, const Timestamp sHi, const Timestamp eLo, const Timestamp eHi, Sink &result)
+{
+    const __m512i vsLo = _mm512_set1_epi32(sLo), vsHi = _mm512_set1_epi32(sHi);
+    const __m512i veLo = _mm512_set1_epi32(eLo), veHi = _mm512_set1_epi32(eHi);
+    const __m512i pstarts = _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30);
+    const __m512i pends = _mm512_setr_epi32(1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31);
+    size_t i = 0;
+    
+    
+    for (; i+16 <= n; i += 16)
+    {
+        const Timestamp *p = (const Timestamp*)(tstamps+i);
+        __m512i a = _mm512_loadu_si512(p), b = _mm512_loadu_si512(p+16);
+        __m512i vs = _mm512_permutex2var_epi32(a, pstarts, b);
+        __m512i ve = _mm512_permutex2var_epi32(a, pends, b);
+        
+        __mmask16 mask = _mm512_cmpge_epi32_mask(vs, vsLo);
+        mask = _mm512_mask_cmple_epi32_mask(mask, vs, vsHi);
+        mask = _mm512_mask_cmpge_epi32_mask(mask, ve, veLo);
+        mask = _mm512_mask_cmple_epi32_mask(mask, ve, veHi);
+        if (mask)
+            reportMask16(_mm512_loadu_si512(ids+i), mask, result);
+    }
+    scanPairs_Scalar(tstamps+i, ids+i, n-i, sLo, sHi, eLo, eHi, result);
+}
+
+template <class Sink>
+inline void scanPairs(const unsigned int kernel, const pair<Timestamp, Timestamp> *tstamps, const RecordId *ids, const size_t n, const Timestamp sLo, const Timestamp sHi, const Timestamp eLo, const Timestamp eHi, Sink &result)
+{
+    switch (kernel)
+    {
+        case SCAN_KERNEL_AVX512:
+            scanPairs_AVX512(tstamps, ids, n, sLo, sHi, eLo, eHi, result);
+            break;
+        case SCAN_KERNEL_AVX2:
+            scanPairs_AVX2(tstamps, ids, n, sLo, sHi, eLo, eHi, result);
+            break;
+        case SCAN_KERNEL_SSE42:
+            scanPairs_SSE42(tstamps, ids, n, sLo, sHi, eLo, eHi, result);
+            break;
+        default:
+            scanPairs_Scalar(tstamps, ids, n, sLo, sHi, eLo, eHi, result);
+    }
+}
+
+
+
+// Reports entries[i].id for every i in [0, n) with lo <= t <= hi, t the
+// timestamp of entries[i]; an entry is an (id, timestamp) pair, i.e., a
+// RecordStart or a RecordEnd. Deinterleaved as the pairs above.
+template <class Entry, class Sink>
+inline void scanEntries_Scalar(const Entry *entries, const size_t n, const Timestamp lo, const Timestamp hi, Sink &result)
+{
+    const Timestamp *p = (const Timestamp*)entries;
+    
+    for (size_t i = 0; i < n; i++)
+    {
+        if ((lo <= p[2*i+1]) && (p[2*i+1] <= hi))
+            result.add(p[2*i]);
+    }
+}
+
+template <class Entry, class Sink>
+TARGET_SSE42 void scanEntries_SSE42(const Entry *entries, const size_t n, const Timestamp lo, const Timestamp hi, Sink &result)
+{
+    const __m128i vLo = _mm_set1_epi32(lo), vHi = _mm_set1_epi32(hi);
+    RecordId buffer[4];
+    size_t i = 0;
+    
+    
+    for (; i+4 <= n; i += 4)
+    {
+        const float *p = (const float*)(entries+i);
+        __m128 a = _mm_loadu_ps(p), b = _mm_loadu_ps(p+4);
+        __m128i vt = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(3,1,3,1)));
+        
+        __m128i vout = _mm_or_si128(_mm_cmpgt_epi32(vLo, vt), _mm_cmpgt_epi32(vt, vHi));
+        unsigned int mask = ~_mm_movemask_ps(_mm_castsi128_ps(vout)) & 0xF;
+        if (mask)
+        {
+            _mm_storeu_si128((__m128i*)buffer, _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2,0,2,0))));
+            reportMask(buffer, mask, result);
+        }
+    }
+    scanEntries_Scalar(entries+i, n-i, lo, hi, result);
+}
+
+template <class Entry, class Sink>
+TARGET_AVX2 void scanEntries_AVX2(const Entry *entries, const size_t n, const Timestamp lo, const Timestamp hi, Sink &result)
+{
+    const __m256i vLo = _mm256_set1_epi32(lo), vHi = _mm256_set1_epi32(hi);
+    RecordId buffer[8];
+    size_t i = 0;
+    
+    
+    for (; i+8 <= n; i += 8)
+    {
+        const float *p = (const float*)(entries+i);
+        __m256 a = _mm256_loadu_ps(p), b = _mm256_loadu_ps(p+8);
+        __m256i vt = _mm256_permute4x64_epi64(_mm256_castps_si256(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(3,1,3,1))), _MM_SHUFFLE(3,1,2,0));
+        
+        __m256i vout = _mm256_or_si256(_mm256_cmpgt_epi32(vLo, vt), _mm256_cmpgt_epi32(vt, vHi));
+        unsigned int mask = ~_mm256_movemask_ps(_mm256_castsi256_ps(vout)) & 0xFF;
+        if (mask)
+        {
+            _mm256_storeu_si256((__m256i*)buffer, _mm256_permute4x64_epi64(_mm256_castps_si256(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(2,0,2,0))), _MM_SHUFFLE(3,1,2,0)));
+            reportMask(buffer, mask, result);
+        }
+    }
+    scanEntries_Scalar(entries+i, n-i, lo, hi, result);
+}
+
+template <class Entry, class Sink>
+TARGET_AVX512 void scanEntries_AVX512(const Entry *entries, const size_t n, const Timestamp lo, const Timestamp hi, Sink &result)
+{
+    const __m512i vLo = _mm512_set1_epi32(lo), vHi = _mm512_set1_epi32(hi);
+    const __m512i pids = _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30);
+    const __m512i ptstamps = _mm512_setr_epi32(1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31);
+    size_t i = 0;
+    
+    
+    for (; i+16 <= n; i += 16)
+    {
+        const Timestamp *p = (const Timestamp*)(entries+i);
+        __m512i a = _mm512_loadu_si512(p), b = _mm512_loadu_si512(p+16);
+        __m512i vt = _mm512_permutex2var_epi32(a, ptstamps, b);
+        
+        __mmask16 mask = _mm512_cmpge_epi32_mask(vt, vLo);
+        mask = _mm512_mask_cmple_epi32_mask(mask, vt, vHi);
+        if (mask)
+            reportMask16(_mm512_permutex2var_epi32(a, pids, b), mask, result);
+    }
+    scanEntries_Scalar(entries+i, n-i, lo, hi, result);
+}
+
+template <class Entry, class Sink>
+inline void scanEntries(const unsigned int kernel, const Entry *entries, const size_t n, const Timestamp lo, const Timestamp hi, Sink &result)
+{
+    static_assert(sizeof(Entry) == 2*sizeof(Timestamp), "An entry is expected to be (id, timestamp)");
+    
+    switch (kernel)
+    {
+        case SCAN_KERNEL_AVX512:
+            scanEntries_AVX512(entries, n, lo, hi, result);
+            break;
+        case SCAN_KERNEL_AVX2:
+            scanEntries_AVX2(entries, n, lo, hi, result);
+            break;
+        case SCAN_KERNEL_SSE42:
+            scanEntries_SSE42(entries, n, lo, hi, result);
+            break;
+        default:
+            scanEntries_Scalar(entries, n, lo, hi, result);
+    }
+}
+
+template <class Entry, class Sink>
+inline void scanEntries(const unsigned int kernel, const vector<Entry> &P, const Timestamp lo, const Timestamp hi, Sink &result)
+{
+    scanEntries(kernel, P.data(), P.size(), lo, hi, result);
+}
+
+
+
+// Id accumulation, i.e., reporting every id of a range without checks. Only
+// XorSink gains from a dedicated kernel; a CountSink is already O(1) and the
+// rest of the sinks have to touch every id anyway.
+inline RecordId xorIds_Scalar(const RecordId *ids, const size_t n)
+{
+    RecordId x = 0;
+    
+    for (size_t i = 0; i < n; i++)
+        x ^= ids[i];
+    
+    return x;
+}
+
+TARGET_SSE42 inline RecordId xorIds_SSE42(const RecordId *ids, const size_t n)
+{
+    __m128i vx = _mm_setzero_si128();
+    size_t i = 0;
+    
+    
+    for (; i+4 <= n; i += 4)
+        vx = _mm_xor_si128(vx, _mm_loadu_si128((const __m128i*)(ids+i)));
+    vx = _mm_xor_si128(vx, _mm_shuffle_epi32(vx, _MM_SHUFFLE(1,0,3,2)));
+    vx = _mm_xor_si128(vx, _mm_shuffle_epi32(vx, _MM_SHUFFLE(2,3,0,1)));
+    
+    return _mm_cvtsi128_si32(vx) ^ xorIds_Scalar(ids+i, n-i);
+}
+
+TARGET_AVX2 inline RecordId xorIds_AVX2(const RecordId *ids, const size_t n)
+{
+    __m256i vx = _mm256_setzero_si256();
+    size_t i = 0;
+    
+    
+    for (; i+8 <= n; i += 8)
+        vx = _mm256_xor_si256(vx, _mm256_loadu_si256((const __m256i*)(ids+i)));
+    __m128i vh = _mm_xor_si128(_mm256_castsi256_si128(vx), _mm256_extracti128_si256(vx, 1));
+    vh = _mm_xor_si128(vh, _mm_shuffle_epi32(vh, _MM_SHUFFLE(1,0,3,2)));
+    vh = _mm_xor_si128(vh, _mm_shuffle_epi32(vh, _MM_SHUFFLE(2,3,0,1)));
+    
+    return _mm_cvtsi128_si32(vh) ^ xorIds_Scalar(ids+i, n-i);
+}
+
+TARGET_AVX512 inline RecordId xorIds_AVX512(const RecordId *ids, const size_t n)
+{
+    __m512i vx = _mm512_setzero_si512();
+    size_t i = 0;
+    
+    
+    for (; i+16 <= n; i += 16)
+        vx = _mm512_xor_si512(vx, _mm512_loadu_si512(ids+i));
+    __m256i vh = _mm256_xor_si256(_mm512_castsi512_si256(vx), _mm512_extracti64x4_epi64(vx, 1));
+    __m128i vq = _mm_xor_si128(_mm256_castsi256_si128(vh), _mm256_extracti128_si256(vh, 1));
+    vq = _mm_xor_si128(vq, _mm_shuffle_epi32(vq, _MM_SHUFFLE(1,0,3,2)));
+    vq = _mm_xor_si128(vq, _mm_shuffle_epi32(vq, _MM_SHUFFLE(2,3,0,1)));
+    
+    return _mm_cvtsi128_si32(vq) ^ xorIds_Scalar(ids+i, n-i);
+}
+
+inline RecordId xorIds(const unsigned int kernel, const RecordId *ids, const size_t n)
+{
+    switch (kernel)
+    {
+        case SCAN_KERNEL_AVX512:
+            return xorIds_AVX512(ids, n);
+        case SCAN_KERNEL_AVX2:
+            return xorIds_AVX2(ids, n);
+        case SCAN_KERNEL_SSE42:
+            return xorIds_SSE42(ids, n);
+        default:
+            return xorIds_Scalar(ids, n);
+    }
+}
+
+
+// Brings the first PREFETCH_IDS_LINES cache lines of the ids in [first,
+// last) into the cache, so that reporting the range after the current one
+// does not start with a miss; the hardware prefetcher takes over from there.
+template <class Iterator>
+inline void prefetchIds(Iterator first, Iterator last)
+{
+    if (first == last)
+        return;
+    
+    const char *from = (const char*)&(*first), *to = from+(last-first)*sizeof(RecordId);
+    
+    for (auto i = 0; (i < PREFETCH_IDS_LINES) && (from < to); i++, from += 64)
+        __builtin_prefetch(from);
+}
+
+
+// Reports the contiguous ids in [first, last), all of which qualify.
+template <class Iterator, class Sink>
+inline void reportIds(const unsigned int, Iterator first, Iterator last, Sink &result)
+{
+    result.addRange(first, last);
+}
+
+template <class Iterator>
+inline void reportIds(const unsigned int kernel, Iterator first, Iterator last, XorSink &result)
+{
+    // Sign-extending the XOR of the 32-bit ids gives the XOR of the
+    // sign-extended ids, i.e., what XorSink::add() accumulates.
+    if (first != last)
+        result.result ^= (size_t)xorIds(kernel, &(*first), last-first);
+}
+
+
+// The same over the ids of records. The records are XORed as they are
+// loaded, 3 vectors at a time, and the ids are picked from the accumulators at
+// the end: every third lane, as the records are (id, start, end) triples.
+inline RecordId xorRecordIds_Scalar(const Record *recs, const size_t n)
+{
+    RecordId x = 0;
+    
+    for (size_t i = 0; i < n; i++)
+        x ^= recs[i].id;
+    
+    return x;
+}
+
+TARGET_SSE42 inline RecordId xorRecordIds_SSE42(const Record *recs, const size_t n)
+{
+    __m128i va = _mm_setzero_si128(), vb = _mm_setzero_si128(), vc = _mm_setzero_si128();
+    Timestamp buffer[12];
+    RecordId x = 0;
+    size_t i = 0;
+    
+    
+    for (; i+4 <= n; i += 4)
+    {
+        const __m128i *p = (const __m128i*)(recs+i);
+        va = _mm_xor_si128(va, _mm_loadu_si128(p));
+        vb = _mm_xor_si128(vb, _mm_loadu_si128(p+1));
+        vc = _mm_xor_si128(vc, _mm_loadu_si128(p+2));
+    }
+    _mm_storeu_si128((__m128i*)buffer, va);
+    _mm_storeu_si128((__m128i*)(buffer+4), vb);
+    _mm_storeu_si128((__m128i*)(buffer+8), vc);
+    for (auto k = 0; k < 12; k += 3)
+        x ^= buffer[k];
+    
+    return x ^ xorRecordIds_Scalar(recs+i, n-i);
+}
+
+TARGET_AVX2 inline RecordId xorRecordIds_AVX2(const Record *recs, const size_t n)
+{
+    __m256i va = _mm256_setzero_si256(), vb = _mm256_setzero_si256(), vc = _mm256_setzero_si256();
+    Timestamp buffer[24];
+    RecordId x = 0;
+    size_t i = 0;
+    
+    
+    for (; i+8 <= n; i += 8)
+    {
+        const __m256i *p = (const __m256i*)(recs+i);
+        va = _mm256_xor_si256(va, _mm256_loadu_si256(p));
+        vb = _mm256_xor_si256(vb, _mm256_loadu_si256(p+1));
+        vc = _mm256_xor_si256(vc, _mm256_loadu_si256(p+2));
+    }
+    _mm256_storeu_si256((__m256i*)buffer, va);
+    _mm256_storeu_si256((__m256i*)(buffer+8), vb);
+    _mm256_storeu_si256((__m256i*)(buffer+16), vc);
+    for (auto k = 0; k < 24; k += 3)
+        x ^= buffer[k];
+    
+    return x ^ xorRecordIds_Scalar(recs+i, n-i);
+}
+
+TARGET_AVX512 inline RecordId xorRecordIds_AVX512(const Record *recs, const size_t n)
+{
+    __m512i va = _mm512_setzero_si512(), vb = _mm512_setzero_si512(), vc = _mm512_setzero_si512();
+    Timestamp buffer[48];
+    RecordId x = 0;
+    size_t i = 0;
+    
+    
+    for (; i+16 <= n; i += 16)
+    {
+        const Timestamp *p = (const Timestamp*)(recs+i);
+        va = _mm512_xor_si512(va, _mm512_loadu_si512(p));
+        vb = _mm512_xor_si512(vb, _mm512_loadu_si512(p+16));
+        vc = _mm512_xor_si512(vc, _mm512_loadu_si512(p+32));
+    }
+    _mm512_storeu_si512(buffer, va);
+    _mm512_storeu_si512(buffer+16, vb);
+    _mm512_storeu_si512(buffer+32, vc);
+    for (auto k = 0; k < 48; k += 3)
+        x ^= buffer[k];
+    
+    return x ^ xorRecordIds_Scalar(recs+i, n-i);
+}
+
+inline RecordId xorRecordIds(const unsigned int kernel, const Record *recs, const size_t n)
+{
+    switch (kernel)
+    {
+        case SCAN_KERNEL_AVX512:
+            return xorRecordIds_AVX512(recs, n);
+        case SCAN_KERNEL_AVX2:
+            return xorRecordIds_AVX2(recs, n);
+        case SCAN_KERNEL_SSE42:
+            return xorRecordIds_SSE42(recs, n);
+        default:
+            return xorRecordIds_Scalar(recs, n);
+    }
+}
+
+
+// Reports the ids of all records in P.
+template <class Sink>
+inline void reportRecords(const unsigned int, const Record *recs, const size_t n, Sink &result)
+{
+    for (size_t i = 0; i < n; i++)
+        result.add(recs[i].id);
+}
+
+inline void reportRecords(const unsigned int, const Record *, const size_t n, CountSink &result)
+{
+    result.result += n;
+}
+
+inline void reportRecords(const unsigned int kernel, const Record *recs, const size_t n, XorSink &result)
+{
+    result.result ^= (size_t)xorRecordIds(kernel, recs, n);
+}
+
+template <class Sink>
+inline void reportRecords(const unsigned int kernel, const Relation &P, Sink &result)
+{
+    reportRecords(kernel, P.data(), P.size(), result);
+}
+#endif //_KERNELS_H_
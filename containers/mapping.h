@@ -0,0 +1,135 @@
+/******************************************************************************
+ * Project:  hint
+ * Purpose:  Indexing interval data
+ * Author:   Panagiotis Bouros, pbour@github.io
+ * Author:   George Christodoulou
+ ******************************************************************************
+ * Copyright (c) 2020 - 2024
+ *
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************/
+
+#ifndef _MAPPING_H_
+#define _MAPPING_H_
+
+#include "../def_global.h"
+
+
+
+// A section of a memory-mapped file to be viewed as an array, see
+// MappedAllocator; owned by whoever mapped the file, and must outlive the
+// arrays viewing it.
+struct MappedRegion
+{
+    void   *data;
+    size_t count;       // in elements
+    bool   taken;       // true once an array views it
+    bool   viewing;     // true while an array turns into a view of it
+    
+    MappedRegion() : data(NULL), count(0), taken(false), viewing(false) {};
+};
+
+
+// Allocator of the arrays that may view a memory-mapped file instead of
+// holding a copy, e.g., the arrays of an index reopened from a file, see
+// HINT_M_ALL(filename). Without a region, it allocates on the heap, as
+// std::allocator. Given a region, the first allocation of exactly its count
+// elements returns the region itself, and the elements are not constructed
+// while the region is being viewed, i.e., viewRegion() turns an empty array into a
+// view of the region without touching its contents. A view that grows is
+// moved to the heap as any array, and the region is never freed here.
+template <class T>
+class MappedAllocator
+{
+public:
+    typedef T value_type;
+    typedef true_type propagate_on_container_move_assignment;
+    typedef true_type propagate_on_container_swap;
+    
+    MappedRegion *region;
+    
+    MappedAllocator() : region(NULL) {};
+    MappedAllocator(MappedRegion *region) : region(region) {};
+    template <class U> MappedAllocator(const MappedAllocator<U> &rhs) : region(rhs.region) {};
+    
+    T* allocate(const size_t n)
+    {
+        if ((this->region != NULL) && (!this->region->taken) && (n == this->region->count))
+        {
+            this->region->taken = true;
+            return (T*)this->region->data;
+        }
+        
+        return (T*)::operator new(n*sizeof(T));
+    };
+    
+    void deallocate(T *p, const size_t)
+    {
+        if ((this->region == NULL) || (p != this->region->data))
+            ::operator delete(p);
+    };
+    
+    template <class U>
+    inline void construct(U *p)
+    {
+        if ((this->region == NULL) || (!this->region->viewing))
+            ::new((void*)p) U();
+    };
+    
+    template <class U, class... Args>
+    inline void construct(U *p, Args&&... args)
+    {
+        ::new((void*)p) U(std::forward<Args>(args)...);
+    };
+    
+    // Copies are plain heap arrays
+    MappedAllocator select_on_container_copy_construction() const
+    {
+        return MappedAllocator();
+    };
+};
+
+template <class T, class U>
+inline bool operator == (const MappedAllocator<T> &lhs, const MappedAllocator<U> &rhs)
+{
+    return (lhs.region == rhs.region);
+}
+
+template <class T, class U>
+inline bool operator != (const MappedAllocator<T> &lhs, const MappedAllocator<U> &rhs)
+{
+    return (lhs.region != rhs.region);
+}
+
+
+// Turns the empty array v, with a MappedAllocator, into a view of region
+template <class Array>
+inline void viewRegion(Array &v, MappedRegion &region)
+{
+    typedef vector<typename Array::value_type, typename Array::allocator_type> Base;
+    Base tmp((typename Array::allocator_type(&region)));
+    
+    region.viewing = true;
+    tmp.resize(region.count);
+    region.viewing = false;
+    static_cast<Base&>(v).swap(tmp);
+}
+#endif //_MAPPING_H_
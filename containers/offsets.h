@@ -31,27 +31,28 @@
 #define _OFFSETS_H_
 
 #include "relation.h"
+#include "bitvector.h"
 
+#define OFFSETS_TREE_FANOUT 16
 
 
+// The entries are defined inline, as they are rebuilt from the compact
+// offsets below on every access; see CompactOffsets.
 class OffsetEntry_SS_CM
 {
 public:
     Timestamp tstamp;
     RelationIdIterator iterI;
-    vector<pair<Timestamp, Timestamp> >::iterator iterT;
+    TimestampPairs::iterator iterT;
     PartitionId pid;
     
     OffsetEntry_SS_CM();
-    OffsetEntry_SS_CM(Timestamp tstamp, RelationIdIterator iterI, vector<pair<Timestamp, Timestamp> >::iterator iterT, PartitionId pid);
+    OffsetEntry_SS_CM(Timestamp tstamp, RelationIdIterator iterI, TimestampPairs::iterator iterT, PartitionId pid);
     bool operator < (const OffsetEntry_SS_CM &rhs) const;
     bool operator >= (const OffsetEntry_SS_CM &rhs) const;
     ~OffsetEntry_SS_CM();
 };
 
-typedef vector<OffsetEntry_SS_CM> Offsets_SS_CM;
-typedef Offsets_SS_CM::const_iterator Offsets_SS_CM_Iterator;
-
 
 
 class OffsetEntry_ALL
@@ -72,40 +73,476 @@ public:
 class OffsetEntry_ALL_Timestamp : public OffsetEntry_ALL
 {
 public:
-    vector<Timestamp>::iterator iterT;
+    TimestampArrayIterator iterT;
     
     OffsetEntry_ALL_Timestamp();
-    OffsetEntry_ALL_Timestamp(Timestamp tstamp, RelationIdIterator iterI, vector<Timestamp>::iterator iterT, PartitionId pid);
+    OffsetEntry_ALL_Timestamp(Timestamp tstamp, RelationIdIterator iterI, TimestampArrayIterator iterT, PartitionId pid);
     bool operator < (const OffsetEntry_ALL_Timestamp &rhs) const;
     bool operator >= (const OffsetEntry_ALL_Timestamp &rhs) const;
     ~OffsetEntry_ALL_Timestamp();
 };
 
 
-class OffsetEntry_ALL_Timestamps : public OffsetEntry_ALL
+typedef OffsetEntry_ALL_Timestamp  OffsetEntry_ALL_OrgsIn;
+typedef OffsetEntry_ALL_Timestamp  OffsetEntry_ALL_OrgsAft;
+typedef OffsetEntry_ALL_Timestamp  OffsetEntry_ALL_RepsIn;
+typedef OffsetEntry_ALL            OffsetEntry_ALL_RepsAft;
+
+
+
+inline OffsetEntry_SS_CM::OffsetEntry_SS_CM()
+{
+}
+
+
+inline OffsetEntry_SS_CM::OffsetEntry_SS_CM(Timestamp tstamp, RelationIdIterator iterI, TimestampPairs::iterator iterT, PartitionId pid)
+{
+    this->tstamp = tstamp;
+    this->iterI  = iterI;
+    this->iterT  = iterT;
+    this->pid    = pid;
+}
+
+
+inline bool OffsetEntry_SS_CM::operator < (const OffsetEntry_SS_CM &rhs) const
+{
+    return this->tstamp < rhs.tstamp;
+}
+
+
+inline bool OffsetEntry_SS_CM::operator >= (const OffsetEntry_SS_CM &rhs) const
+{
+    return this->tstamp >= rhs.tstamp;
+}
+
+
+inline OffsetEntry_SS_CM::~OffsetEntry_SS_CM()
+{
+}
+
+
+
+inline OffsetEntry_ALL::OffsetEntry_ALL()
+{
+}
+
+
+inline OffsetEntry_ALL::OffsetEntry_ALL(Timestamp tstamp, RelationIdIterator iterI, PartitionId pid)
+{
+    this->tstamp = tstamp;
+    this->iterI  = iterI;
+    this->pid    = pid;
+}
+
+
+inline bool OffsetEntry_ALL::operator < (const OffsetEntry_ALL &rhs) const
+{
+    return this->tstamp < rhs.tstamp;
+}
+
+
+inline bool OffsetEntry_ALL::operator >= (const OffsetEntry_ALL &rhs) const
+{
+    return this->tstamp >= rhs.tstamp;
+}
+
+
+inline OffsetEntry_ALL::~OffsetEntry_ALL()
+{
+}
+
+
+
+inline OffsetEntry_ALL_Timestamp::OffsetEntry_ALL_Timestamp()
+{
+}
+
+
+inline OffsetEntry_ALL_Timestamp::OffsetEntry_ALL_Timestamp(Timestamp tstamp, RelationIdIterator iterI, TimestampArrayIterator iterT, PartitionId pid) : OffsetEntry_ALL(tstamp, iterI, pid)
+{
+    this->iterT = iterT;
+}
+
+
+inline bool OffsetEntry_ALL_Timestamp::operator < (const OffsetEntry_ALL_Timestamp &rhs) const
+{
+    return this->tstamp < rhs.tstamp;
+}
+
+
+inline bool OffsetEntry_ALL_Timestamp::operator >= (const OffsetEntry_ALL_Timestamp &rhs) const
+{
+    return this->tstamp >= rhs.tstamp;
+}
+
+
+inline OffsetEntry_ALL_Timestamp::~OffsetEntry_ALL_Timestamp()
+{
+}
+
+
+
+// Offsets of a level in compact form, as a structure of arrays: the
+// timestamps of the non-empty partitions, i.e., the keys of the binary
+// searches, the positions of their contents in the id (and timestamp) arrays
+// of the level, each ending where the next one starts, and the vertical
+// pointers (pid), 12 bytes per partition instead of 24-32 for the entries.
+// The entries are returned by value, rebuilt from these arrays and the
+// beginning of the arrays of the level, set by setBase(); lower_bound() and
+// upper_bound() over the offsets only search the timestamps.
+//
+// Optionally, buildSearchTree() adds a static B+-tree on the timestamps, with
+// 16 keys (one cache line) per node and the sorted timestamps themselves as
+// leaves; a lower_bound() over all the offsets then descends it, counting the
+// keys before t in every node without branches, instead of binary searching
+// the timestamps, i.e., touches about log16(n) cache lines instead of log2(n).
+// Offsets with up to 256 timestamps get no tree.
+//
+// As the timestamps are the ids of the non-empty partitions of a level,
+// buildDirectory() marks these partitions in a rank bitvector; lower_bound()
+// over all the offsets and upper_bound() up to their end then take a rank,
+// i.e., a constant number of lookups, instead of any search.
+//
+// The directory and the tree are exclusive: the indices build the directory
+// by default, and buildSearchTree() replaces it wherever it builds a tree,
+// i.e., with -e the offsets with more than 256 timestamps are searched in
+// the tree and the rest keep the directory; buildDirectory() drops the tree.
+struct NoTimestamps
+{
+    NoTimestamps operator + (const size_t) const {return *this;};
+};
+
+template <class Entry, class TimestampsIterator>
+inline Entry makeOffsetEntry(Timestamp tstamp, RelationIdIterator iterI, TimestampsIterator iterT, PartitionId pid)
+{
+    return Entry(tstamp, iterI, iterT, pid);
+}
+
+template <class Entry>
+inline Entry makeOffsetEntry(Timestamp tstamp, RelationIdIterator iterI, NoTimestamps, PartitionId pid)
+{
+    return Entry(tstamp, iterI, pid);
+}
+
+
+template <class Entry, class TimestampsIterator> class CompactOffsets;
+
+template <class Entry, class TimestampsIterator>
+class CompactOffsetsIterator
 {
 public:
-    vector<pair<Timestamp, Timestamp> >::iterator iterT;
+    typedef random_access_iterator_tag iterator_category;
+    typedef Entry value_type;
+    typedef ptrdiff_t difference_type;
+    typedef const Entry* pointer;
+    typedef Entry reference;
     
-    OffsetEntry_ALL_Timestamps();
-    OffsetEntry_ALL_Timestamps(Timestamp tstamp, RelationIdIterator iterI, vector<pair<Timestamp, Timestamp> >::iterator iterT, PartitionId pid);
-    bool operator < (const OffsetEntry_ALL_Timestamps &rhs) const;
-    bool operator >= (const OffsetEntry_ALL_Timestamps &rhs) const;
-    ~OffsetEntry_ALL_Timestamps();
+    // Result of operator->, keeping the rebuilt entry alive
+    class EntryPointer
+    {
+    public:
+        Entry entry;
+        
+        EntryPointer(const Entry &entry) : entry(entry) {};
+        const Entry* operator -> () const {return &this->entry;};
+    };
+    
+    const CompactOffsets<Entry, TimestampsIterator> *offsets;
+    size_t pos;
+    
+    CompactOffsetsIterator() : offsets(NULL), pos(0) {};
+    CompactOffsetsIterator(const CompactOffsets<Entry, TimestampsIterator> *offsets, const size_t pos) : offsets(offsets), pos(pos) {};
+    
+    Entry operator * () const {return (*this->offsets)[this->pos];};
+    EntryPointer operator -> () const {return EntryPointer((*this->offsets)[this->pos]);};
+    Entry operator [] (const difference_type n) const {return (*this->offsets)[this->pos+n];};
+    
+    CompactOffsetsIterator& operator ++ () {this->pos++; return *this;};
+    CompactOffsetsIterator& operator -- () {this->pos--; return *this;};
+    CompactOffsetsIterator operator ++ (int) {CompactOffsetsIterator tmp = *this; this->pos++; return tmp;};
+    CompactOffsetsIterator operator -- (int) {CompactOffsetsIterator tmp = *this; this->pos--; return tmp;};
+    CompactOffsetsIterator& operator += (const difference_type n) {this->pos += n; return *this;};
+    CompactOffsetsIterator& operator -= (const difference_type n) {this->pos -= n; return *this;};
+    CompactOffsetsIterator operator + (const difference_type n) const {return CompactOffsetsIterator(this->offsets, this->pos+n);};
+    CompactOffsetsIterator operator - (const difference_type n) const {return CompactOffsetsIterator(this->offsets, this->pos-n);};
+    difference_type operator - (const CompactOffsetsIterator &rhs) const {return (difference_type)this->pos-(difference_type)rhs.pos;};
+    
+    bool operator == (const CompactOffsetsIterator &rhs) const {return this->pos == rhs.pos;};
+    bool operator != (const CompactOffsetsIterator &rhs) const {return this->pos != rhs.pos;};
+    bool operator < (const CompactOffsetsIterator &rhs) const {return this->pos < rhs.pos;};
+    bool operator > (const CompactOffsetsIterator &rhs) const {return this->pos > rhs.pos;};
+    bool operator <= (const CompactOffsetsIterator &rhs) const {return this->pos <= rhs.pos;};
+    bool operator >= (const CompactOffsetsIterator &rhs) const {return this->pos >= rhs.pos;};
 };
 
-typedef OffsetEntry_ALL_Timestamps OffsetEntry_ALL_OrgsIn;
-typedef OffsetEntry_ALL_Timestamp  OffsetEntry_ALL_OrgsAft;
-typedef OffsetEntry_ALL_Timestamp  OffsetEntry_ALL_RepsIn;
-typedef OffsetEntry_ALL            OffsetEntry_ALL_RepsAft;
 
-typedef vector<OffsetEntry_ALL_OrgsIn>  Offsets_ALL_OrgsIn;
-typedef vector<OffsetEntry_ALL_OrgsAft> Offsets_ALL_OrgsAft;
-typedef vector<OffsetEntry_ALL_RepsIn>  Offsets_ALL_RepsIn;
-typedef vector<OffsetEntry_ALL_RepsAft> Offsets_ALL_RepsAft;
+template <class Entry, class TimestampsIterator>
+class CompactOffsets
+{
+public:
+    typedef CompactOffsetsIterator<Entry, TimestampsIterator> const_iterator;
+    typedef const_iterator iterator;
+    
+    // May view a file, see containers/mapping.h
+    vector<Timestamp, MappedAllocator<Timestamp> >     tstamps;
+    vector<uint32_t, MappedAllocator<uint32_t> >       positions;
+    vector<PartitionId, MappedAllocator<PartitionId> > pids;
+    RelationIdIterator  baseI;
+    TimestampsIterator  baseT;
+    RankBitvector       dir;            // empty unless buildDirectory() is called
+    vector<Timestamp>   tree;           // empty unless buildSearchTree() is called
+    vector<size_t>      treeLevels;     // start of every level in tree, bottom-up
+    
+    void setBase(RelationIdIterator baseI, TimestampsIterator baseT = TimestampsIterator())
+    {
+        this->baseI = baseI;
+        this->baseT = baseT;
+    };
+    
+    size_t size() const {return this->tstamps.size();};
+    bool empty() const {return this->tstamps.empty();};
+    const_iterator begin() const {return const_iterator(this, 0);};
+    const_iterator end() const {return const_iterator(this, this->tstamps.size());};
+    
+    Entry operator [] (const size_t i) const
+    {
+        return makeOffsetEntry<Entry>(this->tstamps[i], this->baseI+this->positions[i], this->baseT+this->positions[i], this->pids[i]);
+    };
+    
+    void reserve(const size_t n)
+    {
+        this->tstamps.reserve(n);
+        this->positions.reserve(n);
+        this->pids.reserve(n);
+    };
+    
+    // The entry must point in the arrays given to setBase()
+    void push_back(const Entry &entry)
+    {
+        this->tstamps.push_back(entry.tstamp);
+        this->positions.push_back(entry.iterI-this->baseI);
+        this->pids.push_back(entry.pid);
+    };
+    
+    void resize(const size_t n)
+    {
+        this->tstamps.resize(n);
+        this->positions.resize(n);
+        this->pids.resize(n);
+    };
+    
+    // Same as push_back() for the i-th entry, after a resize()
+    void set(const size_t i, const Entry &entry)
+    {
+        this->tstamps[i]   = entry.tstamp;
+        this->positions[i] = entry.iterI-this->baseI;
+        this->pids[i]      = entry.pid;
+    };
+    
+    size_t getSize() const
+    {
+        return this->tstamps.size()*(sizeof(Timestamp)+sizeof(uint32_t)+sizeof(PartitionId));
+    };
+    
+    // Inverse of the push_back()s: the offsets of all numPartitions
+    // partitions of the level in its arrays of numRecords entries, with an
+    // empty partition starting where the next one does
+    template <class Offset>
+    void getPartitionOffsets(const PartitionId numPartitions, const size_t numRecords, Offset *offsets) const
+    {
+        size_t i = this->tstamps.size();
+        
+        offsets[numPartitions] = numRecords;
+        for (auto pId = numPartitions-1; pId >= 0; pId--)
+        {
+            if ((i > 0) && (this->tstamps[i-1] == pId))
+                i--;
+            offsets[pId] = (i < this->tstamps.size())? this->positions[i]: numRecords;
+        }
+    };
+    
+    // Range [first, last) of partition pId in the arrays of the level, of
+    // numRecords entries, given the directory; false if it is empty
+    inline bool getPartition(const PartitionId pId, const size_t numRecords, size_t &first, size_t &last) const
+    {
+        size_t i = this->rank(pId);
+        
+        if ((i == this->tstamps.size()) || (this->tstamps[i] != pId))
+            return false;
+        first = this->positions[i];
+        last  = (i+1 < this->tstamps.size())? this->positions[i+1]: numRecords;
+        
+        return true;
+    };
+    
+    // To be called after the last push_back()
+    void buildDirectory(const size_t numPartitions)
+    {
+        this->tree.clear();
+        this->treeLevels.clear();
+        this->dir.init(numPartitions);
+        for (const Timestamp t : this->tstamps)
+            this->dir.set(t);
+        this->dir.buildRank();
+    };
+    
+    // Position of the first timestamp not before t, given the directory or
+    // else the tree
+    inline size_t rank(const Timestamp t) const
+    {
+        if (!this->dir.empty())
+            return (t <= 0)? 0: this->dir.rank(min((size_t)t, this->dir.numBits));
+        if (!this->tree.empty())
+            return this->searchTree(t);
+        
+        return std::lower_bound(this->tstamps.begin(), this->tstamps.end(), t)-this->tstamps.begin();
+    };
+    
+    // To be called after the last push_back()
+    void buildSearchTree()
+    {
+        size_t n = this->tstamps.size();
+        const Timestamp *keys = this->tstamps.data();
+        
+        this->tree.clear();
+        this->treeLevels.clear();
+        // Small offsets are binary searched within a few cache lines anyway,
+        // or keep the directory if they have one
+        if (n <= OFFSETS_TREE_FANOUT*OFFSETS_TREE_FANOUT)
+            return;
+        this->dir.clear();
+        
+        // Every node keeps the last key of each of its children, padded
+        do
+        {
+            size_t numNodes = (n+OFFSETS_TREE_FANOUT-1)/OFFSETS_TREE_FANOUT;
+            vector<Timestamp> level(((numNodes+OFFSETS_TREE_FANOUT-1)/OFFSETS_TREE_FANOUT)*OFFSETS_TREE_FANOUT, numeric_limits<Timestamp>::max());
+            
+            for (size_t i = 0; i < numNodes; i++)
+                level[i] = keys[min((i+1)*OFFSETS_TREE_FANOUT, n)-1];
+            this->treeLevels.push_back(this->tree.size());
+            this->tree.insert(this->tree.end(), level.begin(), level.end());
+            keys = this->tree.data()+this->treeLevels.back();
+            n = numNodes;
+        } while (n > OFFSETS_TREE_FANOUT);
+    };
+    
+    size_t getSearchTreeSize() const
+    {
+        return this->tree.size()*sizeof(Timestamp);
+    };
+    
+    // Position of the first timestamp not before t, or size()
+    inline size_t searchTree(const Timestamp t) const
+    {
+        const Timestamp *tree = this->tree.data();
+        const size_t n = this->tstamps.size();
+        size_t i = 0;
+        
+        // Otherwise, every node has a key not before t
+        if (t > this->tstamps[n-1])
+            return n;
+        
+        for (int l = (int)this->treeLevels.size()-1; l >= 0; l--)
+        {
+            const Timestamp *node = tree+this->treeLevels[l]+i*OFFSETS_TREE_FANOUT;
+            size_t j = 0;
+            
+            for (auto k = 0; k < OFFSETS_TREE_FANOUT; k++)
+                j += (node[k] < t);
+            i = i*OFFSETS_TREE_FANOUT+j;
+        }
+        
+        const Timestamp *leaf = this->tstamps.data()+i*OFFSETS_TREE_FANOUT;
+        const size_t size = min((size_t)OFFSETS_TREE_FANOUT, n-i*OFFSETS_TREE_FANOUT);
+        
+        return std::lower_bound(leaf, leaf+size, t)-this->tstamps.data();
+    };
+};
+
+
+template <class Entry, class TimestampsIterator>
+inline CompactOffsetsIterator<Entry, TimestampsIterator> lower_bound(CompactOffsetsIterator<Entry, TimestampsIterator> first, CompactOffsetsIterator<Entry, TimestampsIterator> last, const Entry &value)
+{
+    const Timestamp *tstamps = first.offsets->tstamps.data();
+    
+    if ((!first.offsets->dir.empty()) && (first.pos == 0) && (last.pos == first.offsets->size()))
+        return CompactOffsetsIterator<Entry, TimestampsIterator>(first.offsets, first.offsets->rank(value.tstamp));
+    if ((!first.offsets->tree.empty()) && (first.pos == 0) && (last.pos == first.offsets->size()))
+        return CompactOffsetsIterator<Entry, TimestampsIterator>(first.offsets, first.offsets->searchTree(value.tstamp));
+    
+    return CompactOffsetsIterator<Entry, TimestampsIterator>(first.offsets, std::lower_bound(tstamps+first.pos, tstamps+last.pos, value.tstamp)-tstamps);
+}
+
+template <class Entry, class TimestampsIterator>
+inline CompactOffsetsIterator<Entry, TimestampsIterator> upper_bound(CompactOffsetsIterator<Entry, TimestampsIterator> first, CompactOffsetsIterator<Entry, TimestampsIterator> last, const Entry &value)
+{
+    const Timestamp *tstamps = first.offsets->tstamps.data();
+    
+    if (((!first.offsets->dir.empty()) || (!first.offsets->tree.empty())) && (last.pos == first.offsets->size()))
+        return CompactOffsetsIterator<Entry, TimestampsIterator>(first.offsets, max(first.pos, first.offsets->rank(value.tstamp+1)));
+    
+    return CompactOffsetsIterator<Entry, TimestampsIterator>(first.offsets, std::upper_bound(tstamps+first.pos, tstamps+last.pos, value.tstamp)-tstamps);
+}
+
+
+typedef CompactOffsets<OffsetEntry_SS_CM, TimestampPairs::iterator> Offsets_SS_CM;
+typedef Offsets_SS_CM::const_iterator Offsets_SS_CM_Iterator;
+
+typedef CompactOffsets<OffsetEntry_ALL_OrgsIn,  TimestampArrayIterator> Offsets_ALL_OrgsIn;
+typedef CompactOffsets<OffsetEntry_ALL_OrgsAft, TimestampArrayIterator> Offsets_ALL_OrgsAft;
+typedef CompactOffsets<OffsetEntry_ALL_RepsIn,  TimestampArrayIterator> Offsets_ALL_RepsIn;
+typedef CompactOffsets<OffsetEntry_ALL_RepsAft, NoTimestamps> Offsets_ALL_RepsAft;
 
 typedef Offsets_ALL_OrgsIn::const_iterator  Offsets_ALL_OrgsIn_Iterator;
 typedef Offsets_ALL_OrgsAft::const_iterator Offsets_ALL_OrgsAft_Iterator;
 typedef Offsets_ALL_RepsIn::const_iterator  Offsets_ALL_RepsIn_Iterator;
 typedef Offsets_ALL_RepsAft::const_iterator Offsets_ALL_RepsAft_Iterator;
+
+
+// Position of a sweep over the offsets of a level, used to evaluate a batch of
+// queries sorted by start. Every lookup moves the cursor from where the
+// previous one left it, so consecutive queries with close timestamps take a
+// few steps instead of a binary search. The returned positions are meant as
+// the initial next_from/next_to of the getBounds() functions; -1 falls back
+// to their binary search.
+class OffsetsCursor
+{
+public:
+    size_t pos;
+    
+    OffsetsCursor()
+    {
+        this->pos = 0;
+    };
+    
+    // Moves to the first entry with a timestamp not before t.
+    template <class Offsets>
+    inline void seek(const Offsets &offsets, const Timestamp t)
+    {
+        while ((this->pos < offsets.size()) && (offsets[this->pos].tstamp < t))
+            this->pos++;
+        while ((this->pos > 0) && (offsets[this->pos-1].tstamp >= t))
+            this->pos--;
+    };
+    
+    // Cursor for a lookup of partition t, or for the first partition of a
+    // range starting at t.
+    template <class Offsets>
+    inline PartitionId from(const Offsets &offsets, const Timestamp t)
+    {
+        this->seek(offsets, t);
+        
+        return ((this->pos < offsets.size()) && ((this->pos > 0) || (offsets[0].tstamp == t))) ? this->pos : -1;
+    };
+    
+    // Cursor for the end of a range of partitions ending at t.
+    template <class Offsets>
+    inline PartitionId to(const Offsets &offsets, const Timestamp t)
+    {
+        this->seek(offsets, t+1);
+        
+        return ((this->pos > 0) && (this->pos < offsets.size())) ? this->pos : -1;
+    };
+};
 #endif //_OFFSETS_H_
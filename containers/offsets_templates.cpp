@@ -73,6 +73,44 @@ Offsets_SS<T>::Offsets_SS()
 }
 
 
+// To be called after the last entry is added
+template <class T>
+void Offsets_SS<T>::buildDirectory(const size_t numPartitions)
+{
+    this->dir.clear();
+    this->sdir.clear();
+    if (SparseRankBitvector::getSize(numPartitions, this->size()) < RankBitvector::getSize(numPartitions))
+    {
+        this->sdir.init(numPartitions, this->size());
+        for (const OffsetEntry_SS<T> &entry : *this)
+            this->sdir.set(entry.tstamp);
+        this->sdir.buildRank();
+    }
+    else
+    {
+        this->dir.init(numPartitions);
+        for (const OffsetEntry_SS<T> &entry : *this)
+            this->dir.set(entry.tstamp);
+        this->dir.buildRank();
+    }
+}
+
+
+// Same as buildDirectory(), given the partitions of the entries marked in a
+// bitvector with its rank built, which is taken over or released
+template <class T>
+void Offsets_SS<T>::setDirectory(RankBitvector &dir)
+{
+    this->dir.clear();
+    this->sdir.clear();
+    if (SparseRankBitvector::getSize(dir.numBits, this->size()) < RankBitvector::getSize(dir.numBits))
+        this->sdir.build(dir);
+    else
+        this->dir.swap(dir);
+    dir.clear();
+}
+
+
 template <class T>
 Offsets_SS<T>::~Offsets_SS()
 {
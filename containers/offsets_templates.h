@@ -31,6 +31,7 @@
 #define _OFFSETS_TEMPLATES_H_
 
 #include "relation.h"
+#include "bitvector.h"
 
 
 
@@ -60,12 +61,32 @@ typedef OffsetEntry_SS<RelationId>    OffsetEntry_SS_RepsAft;
 
 
 
+// The entries of the non-empty partitions of a level, sorted by partition
+// id (tstamp); the directory marks these partitions, so the position of the
+// first entry from partition t on is the rank of t, instead of a binary search.
+// Where fewer than a partition in 16 is non-empty, the directory is a
+// SparseRankBitvector instead (sdir), i.e., a rank searches a bucket of about
+// 8 entries.
 template <class T>
 class Offsets_SS : public vector<OffsetEntry_SS<T> >
 {
 public:
+    RankBitvector dir;
+    SparseRankBitvector sdir;
+    
     Offsets_SS();
+    void buildDirectory(const size_t numPartitions);
+    void setDirectory(RankBitvector &dir);
     ~Offsets_SS();
+    
+    // Position of the first entry with a tstamp not before t
+    inline size_t rank(const Timestamp t) const
+    {
+        if (t <= 0)
+            return 0;
+        
+        return (!this->dir.empty())? this->dir.rank(min((size_t)t, this->dir.numBits)): this->sdir.rank(min((size_t)t, this->sdir.numBits));
+    };
 };
 
 // For HINT
@@ -0,0 +1,162 @@
+/******************************************************************************
+ * Project:  hint
+ * Purpose:  Indexing interval data
+ * Author:   Panagiotis Bouros, pbour@github.io
+ * Author:   George Christodoulou
+ ******************************************************************************
+ * Copyright (c) 2020 - 2024
+ *
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************/
+
+
+#ifndef _OPENINTERVALS_H_
+#define _OPENINTERVALS_H_
+
+#include "../def_global.h"
+#include "relation.h"
+#include "kernels.h"
+
+
+
+// Open intervals of an index, i.e., the ones still ongoing, see OPEN_END.
+// They are treated as extending past the end of the domain, so for every
+// predicate an open interval qualifies depending only on its start: they
+// are kept sorted by start, and a query reports a range of them, found by
+// binary search, without comparisons. Nothing depends on the current time,
+// so advancing it costs nothing; an interval that ends is closed, see
+// HierarchicalIndex::closeRecord().
+class OpenIntervals
+{
+private:
+    vector<Timestamp> starts;
+    vector<RecordId> ids;
+    
+    // Reports the intervals with sLo <= start <= sHi
+    template <class Sink>
+    inline void report(const unsigned int kernel, const Timestamp sLo, const Timestamp sHi, Sink &result) const
+    {
+        if (sLo > sHi)
+            return;
+        
+        size_t first = lower_bound(this->starts.begin(), this->starts.end(), sLo)-this->starts.begin();
+        size_t last  = upper_bound(this->starts.begin()+first, this->starts.end(), sHi)-this->starts.begin();
+        
+        if (first < last)
+            reportIds(kernel, this->ids.data()+first, this->ids.data()+last, result);
+    };
+    
+public:
+    inline size_t size() const {return this->ids.size();};
+    inline bool empty() const {return this->ids.empty();};
+    
+    void build(const vector<RecordStart> &records)
+    {
+        vector<RecordStart> sorted(records);
+        
+        sort(sorted.begin(), sorted.end());
+        this->starts.resize(sorted.size());
+        this->ids.resize(sorted.size());
+        for (size_t i = 0; i < sorted.size(); i++)
+        {
+            this->starts[i] = sorted[i].start;
+            this->ids[i]    = sorted[i].id;
+        }
+    };
+    
+    inline void insert(const RecordId id, const Timestamp start)
+    {
+        size_t i = upper_bound(this->starts.begin(), this->starts.end(), start)-this->starts.begin();
+        
+        this->starts.insert(this->starts.begin()+i, start);
+        this->ids.insert(this->ids.begin()+i, id);
+    };
+    
+    // Removes the open interval id starting at start; false if there is none
+    inline bool erase(const RecordId id, const Timestamp start)
+    {
+        size_t i = lower_bound(this->starts.begin(), this->starts.end(), start)-this->starts.begin();
+        
+        for (; (i < this->starts.size()) && (this->starts[i] == start); i++)
+        {
+            if (this->ids[i] == id)
+            {
+                this->starts.erase(this->starts.begin()+i);
+                this->ids.erase(this->ids.begin()+i);
+                return true;
+            }
+        }
+        
+        return false;
+    };
+    
+    // Basic predicates of Allen's algebra, see Relation; none of the
+    // predicates that bound the end of an interval by the query holds
+    template <class Sink> inline void execute_Equals(const unsigned int, RangeQuery, Sink &) const {};
+    
+    template <class Sink> inline void execute_Starts(const unsigned int kernel, RangeQuery Q, Sink &result) const
+    {
+        this->report(kernel, Q.start, Q.start, result);
+    };
+    
+    template <class Sink> inline void execute_Started(const unsigned int, RangeQuery, Sink &) const {};
+    template <class Sink> inline void execute_Finishes(const unsigned int, RangeQuery, Sink &) const {};
+    template <class Sink> inline void execute_Finished(const unsigned int, RangeQuery, Sink &) const {};
+    
+    template <class Sink> inline void execute_Meets(const unsigned int kernel, RangeQuery Q, Sink &result) const
+    {
+        this->report(kernel, Q.end, Q.end, result);
+    };
+    
+    template <class Sink> inline void execute_Met(const unsigned int, RangeQuery, Sink &) const {};
+    
+    template <class Sink> inline void execute_Overlaps(const unsigned int kernel, RangeQuery Q, Sink &result) const
+    {
+        this->report(kernel, Q.start+1, Q.end-1, result);
+    };
+    
+    template <class Sink> inline void execute_Overlapped(const unsigned int, RangeQuery, Sink &) const {};
+    template <class Sink> inline void execute_Contains(const unsigned int, RangeQuery, Sink &) const {};
+    
+    template <class Sink> inline void execute_Contained(const unsigned int kernel, RangeQuery Q, Sink &result) const
+    {
+        this->report(kernel, numeric_limits<Timestamp>::min(), Q.start-1, result);
+    };
+    
+    template <class Sink> inline void execute_Precedes(const unsigned int kernel, RangeQuery Q, Sink &result) const
+    {
+        this->report(kernel, Q.end+1, numeric_limits<Timestamp>::max(), result);
+    };
+    
+    template <class Sink> inline void execute_Preceded(const unsigned int, RangeQuery, Sink &) const {};
+    
+    // Generalized predicate, ACM SIGMOD'22 gOverlaps
+    template <class Sink> inline void execute_gOverlaps(const unsigned int kernel, StabbingQuery Q, Sink &result) const
+    {
+        this->report(kernel, numeric_limits<Timestamp>::min(), Q.point, result);
+    };
+    
+    template <class Sink> inline void execute_gOverlaps(const unsigned int kernel, RangeQuery Q, Sink &result) const
+    {
+        this->report(kernel, numeric_limits<Timestamp>::min(), Q.end, result);
+    };
+};
+#endif // _OPENINTERVALS_H_
@@ -0,0 +1,133 @@
+/******************************************************************************
+ * Project:  hint
+ * Purpose:  Indexing interval data
+ * Author:   Panagiotis Bouros, pbour@github.io
+ * Author:   George Christodoulou
+ ******************************************************************************
+ * Copyright (c) 2020 - 2024
+ *
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************/
+
+
+#ifndef _RADIXSORT_H_
+#define _RADIXSORT_H_
+
+#include "../def_global.h"
+
+#define RADIX_SORT_DIGIT_BITS 11
+
+
+
+// Stable LSD radix sort of [first, last) by key(), an unsigned integer of
+// numBits bits, in passes of RADIX_SORT_DIGIT_BITS bits. The histograms of
+// all digits are built in one pass, and the digits on which all the keys
+// agree are skipped.
+template <class T, class Key>
+void radixSort(T *first, T *last, const unsigned int numBits, Key key)
+{
+    const size_t n = last-first;
+    const unsigned int numDigits = (numBits+RADIX_SORT_DIGIT_BITS-1)/RADIX_SORT_DIGIT_BITS;
+    const size_t numBuckets = ((size_t)1) << RADIX_SORT_DIGIT_BITS;
+    const uint64_t mask = numBuckets-1;
+    
+    if (n < 2)
+        return;
+    
+    vector<size_t> counts(numDigits*numBuckets, 0);
+    for (T *x = first; x != last; x++)
+    {
+        uint64_t k = key(*x);
+        
+        for (auto d = 0; d < numDigits; d++)
+            counts[d*numBuckets+((k >> (d*RADIX_SORT_DIGIT_BITS)) & mask)]++;
+    }
+    
+    vector<T> buffer;
+    T *src = first, *dst = NULL;
+    for (auto d = 0; d < numDigits; d++)
+    {
+        size_t *pos = counts.data()+d*numBuckets;
+        unsigned int shift = d*RADIX_SORT_DIGIT_BITS;
+        size_t sum = 0;
+        
+        if (pos[(key(*src) >> shift) & mask] == n)
+            continue;
+        
+        if (dst == NULL)
+        {
+            buffer.resize(n);
+            dst = buffer.data();
+        }
+        for (auto b = 0; b < numBuckets; b++)
+        {
+            size_t c = pos[b];
+            
+            pos[b] = sum;
+            sum += c;
+        }
+        for (size_t i = 0; i < n; i++)
+            dst[pos[(key(src[i]) >> shift) & mask]++] = src[i];
+        swap(src, dst);
+    }
+    
+    if (src != first)
+        copy(src, src+n, first);
+}
+
+
+// Sorts the partition [first, last) by comp(), or by radix sort if it holds
+// at least RADIX_SORT_MIN_SIZE records, see def_global.h; key() must give
+// the same order, and the records with equal keys must be in the order
+// comp() puts them in, as the radix sort is stable. The bits that all the
+// records of a partition share, e.g., those of the partition in the starts
+// of its originals, can be left out of the key.
+template <class T, class Key, class Compare>
+inline void sortPartition(T *first, T *last, const unsigned int numKeyBits, Key key, Compare comp)
+{
+    if (last-first >= RADIX_SORT_MIN_SIZE)
+        radixSort(first, last, numKeyBits, key);
+    else
+        sort(first, last, comp);
+}
+
+template <class T, class Key>
+inline void sortPartition(T *first, T *last, const unsigned int numKeyBits, Key key)
+{
+    sortPartition(first, last, numKeyBits, key, less<T>());
+}
+
+
+// Sorts the partitions [data+offsets[p], data+offsets[p+1]) for p in
+// [from, to), see sortPartition().
+template <class T, class Offset, class Key, class Compare>
+void sortPartitions(T *data, const Offset *offsets, const PartitionId from, const PartitionId to, const unsigned int numKeyBits, Key key, Compare comp)
+{
+    for (auto pId = from; pId < to; pId++)
+        sortPartition(data+offsets[pId], data+offsets[pId+1], numKeyBits, key, comp);
+}
+
+template <class T, class Offset, class Key>
+void sortPartitions(T *data, const Offset *offsets, const PartitionId from, const PartitionId to, const unsigned int numKeyBits, Key key)
+{
+    sortPartitions(data, offsets, from, to, numKeyBits, key, less<T>());
+}
+#endif // _RADIXSORT_H_
@@ -28,6 +28,11 @@
  ******************************************************************************/
 
 #include "relation.h"
+#include "kernels.h"
+#include "textparser.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 
 
@@ -190,20 +195,38 @@ Relation::Relation()
     this->gend            = std::numeric_limits<Timestamp>::min();
 	this->longestRecord   = std::numeric_limits<Timestamp>::min();
     this->avgRecordExtent = 0;
+    this->kernel          = getScanKernel();
+    this->mapping         = NULL;
+    this->mappingSize     = 0;
+    this->region          = NULL;
 }
 
 
-Relation::Relation(Relation &R) : vector<Record>(R)
+// The copy is on the heap
+Relation::Relation(Relation &R) : vector<Record, MappedAllocator<Record> >(R)
 {
+    this->kernel      = getScanKernel();
+    this->openRecords = R.openRecords;
+    this->mapping     = NULL;
+    this->mappingSize = 0;
+    this->region      = NULL;
+}
+
+
+// Swaps the records, along with the file they view
+void Relation::swap(Relation &R)
+{
+    vector<Record, MappedAllocator<Record> >::swap(R);
+    std::swap(this->mapping, R.mapping);
+    std::swap(this->mappingSize, R.mappingSize);
+    std::swap(this->region, R.region);
 }
 
 
 void Relation::load(const char *filename)
 {
-	Timestamp rstart, rend;
 	ifstream inp(filename);
-    size_t sum = 0;
-    RecordId numRecords = 0;
+    IntervalFileStats stats;
 
 	
 	if (!inp)
@@ -212,25 +235,169 @@ void Relation::load(const char *filename)
 		exit(1);
 	}
 
-	while (inp >> rstart >> rend)
-	{
-        if (rstart > rend)
-        {
-            cerr << endl << "Error - start is after end for interval [" << rstart << ".." << rend << "]" << endl << endl;
-            exit(1);
-        }
+    // Binary files are mapped instead of parsed
+    char magic[sizeof(RelationFileHeader::magic)];
+    if ((inp.read(magic, sizeof(magic))) && (isRelationFileMagic(magic)))
+    {
+        inp.close();
+        this->loadBinary(filename);
         
-        this->emplace_back(numRecords, rstart, rend);
-        numRecords++;
-
-        this->gstart = std::min(this->gstart, rstart);
-        this->gend   = std::max(this->gend  , rend);
-		this->longestRecord = std::max(this->longestRecord, rend-rstart+1);
-        sum += rend-rstart;
-	}
+        return;
+    }
 	inp.close();
-	
-    this->avgRecordExtent = (float)sum/this->size();
+
+    // Text files are parsed in parallel, see textparser.h
+    parseIntervalFile(filename, "data", 0, *this, stats);
+    if (stats.invalid)
+    {
+        cerr << endl << "Error - start is after end for interval [" << stats.invalidStart << ".." << stats.invalidEnd << "]" << endl << endl;
+        exit(1);
+    }
+    if (stats.numOpen > 0)
+        this->extractOpenRecords();
+
+    this->gstart        = std::min(this->gstart, stats.gstart);
+    this->gend          = std::max(this->gend  , stats.gend);
+    this->longestRecord = std::max(this->longestRecord, stats.longestRecord);
+    this->avgRecordExtent = (float)stats.sumExtent/this->size();
+}
+
+
+// Loads a relation in the binary format, see RelationFileHeader. The file is
+// mapped and, into an empty relation, the records are a view of it, i.e.,
+// they are not copied, only read once for the open intervals; the mapping is
+// private, so sorting the records or moving out the open
+// intervals copies only the pages written, and the file is never modified.
+// Otherwise, or for the columnar format, the records are copied from it. The
+// statistics are taken from the header.
+void Relation::loadBinary(const char *filename)
+{
+    int fd = open(filename, O_RDONLY);
+    struct stat st;
+    char *data;
+    const RelationFileHeader *header;
+    size_t numOpen = 0;
+    bool columns;
+    
+    
+    if ((fd == -1) || (fstat(fd, &st) == -1))
+    {
+        cerr << endl << "Error - cannot open data file \"" << filename << "\"" << endl << endl;
+        exit(1);
+    }
+    if ((size_t)st.st_size < sizeof(RelationFileHeader))
+    {
+        cerr << endl << "Error - data file \"" << filename << "\" is truncated" << endl << endl;
+        exit(1);
+    }
+    data = (char*)mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        cerr << endl << "Error - cannot map data file \"" << filename << "\"" << endl << endl;
+        exit(1);
+    }
+    
+    header  = (const RelationFileHeader*)data;
+    columns = (!memcmp(header->magic, RELATION_FILE_MAGIC_COLUMNS, sizeof(header->magic)));
+    if ((!isRelationFileMagic(header->magic)) || ((size_t)st.st_size != sizeof(RelationFileHeader)+header->numRecords*((columns)? 2*sizeof(Timestamp): sizeof(Record))))
+    {
+        cerr << endl << "Error - data file \"" << filename << "\" is not in the binary format or is truncated" << endl << endl;
+        exit(1);
+    }
+    
+    if (columns)
+    {
+        const Timestamp *starts = (const Timestamp*)(header+1);
+        const Timestamp *ends   = starts+header->numRecords;
+        
+        this->reserve(this->size()+header->numRecords);
+        for (size_t i = 0; i < header->numRecords; i++)
+            this->emplace_back(i, starts[i], ends[i]);
+    }
+    else if (this->empty())
+    {
+        this->region        = new MappedRegion();
+        this->region->data  = data+sizeof(RelationFileHeader);
+        this->region->count = header->numRecords;
+        viewRegion(*this, *this->region);
+    }
+    else
+    {
+        const Record *records = (const Record*)(header+1);
+        
+        this->insert(this->end(), records, records+header->numRecords);
+    }
+    for (const Record &r : (*this))
+        numOpen += (r.end == OPEN_END);
+    if (numOpen > 0)
+        this->extractOpenRecords();
+    
+    this->gstart          = header->gstart;
+    this->gend            = header->gend;
+    this->longestRecord   = header->longestRecord;
+    this->avgRecordExtent = header->avgRecordExtent;
+    
+    if (this->region != NULL)
+    {
+        this->mapping     = data;
+        this->mappingSize = st.st_size;
+    }
+    else
+        munmap(data, st.st_size);
+}
+
+
+// Saves the relation in the binary format, see RelationFileHeader. The ids
+// of the records and of the open intervals together must be 0..n-1 in any
+// order, as after load(); the records are written in the order of their ids,
+// and the open intervals with OPEN_END as their end.
+void Relation::save(const char *filename)
+{
+    RelationFileHeader header;
+    ofstream out(filename, ios::binary);
+    vector<Record> records(this->size()+this->openRecords.size());
+    
+    
+    if (!out)
+    {
+        cerr << endl << "Error - cannot create data file \"" << filename << "\"" << endl << endl;
+        exit(1);
+    }
+    
+    memcpy(header.magic, RELATION_FILE_MAGIC, sizeof(header.magic));
+    header.numRecords      = records.size();
+    header.gstart          = this->gstart;
+    header.gend            = this->gend;
+    header.longestRecord   = this->longestRecord;
+    header.avgRecordExtent = this->avgRecordExtent;
+    out.write((const char*)&header, sizeof(header));
+    
+    for (const Record &r : (*this))
+        records[r.id] = r;
+    for (const RecordStart &r : this->openRecords)
+        records[r.id] = Record(r.id, r.start, OPEN_END);
+    out.write((const char*)records.data(), records.size()*sizeof(Record));
+    
+    out.close();
+    if (!out)
+    {
+        cerr << endl << "Error - cannot write data file \"" << filename << "\"" << endl << endl;
+        exit(1);
+    }
+}
+
+
+// Moves the open intervals of the relation to openRecords, keeping the order
+// of the rest.
+void Relation::extractOpenRecords()
+{
+    for (const Record &r : (*this))
+    {
+        if (r.end == OPEN_END)
+            this->openRecords.emplace_back(r.id, r.start);
+    }
+    this->erase(remove_if(this->begin(), this->end(), [](const Record &r) {return (r.end == OPEN_END);}), this->end());
 }
 
 
@@ -255,321 +422,326 @@ void Relation::print(char c)
 
 Relation::~Relation()
 {
+    // The records go before the file they view
+    if (this->mapping != NULL)
+    {
+        vector<Record, MappedAllocator<Record> >().swap(*this);
+        munmap(this->mapping, this->mappingSize);
+        delete this->region;
+    }
 }
 
 
 // Querying
+template <class Sink>
+void Relation::execute_Equals(RangeQuery Q, Sink &result)
+{
+    // start = Q.start, end = Q.end
+    scanRecords(this->kernel, *this, Q.start, Q.start, Q.end, Q.end, result);
+    this->scanOpenRecords(Q.start, Q.start, Q.end, Q.end, result);
+}
+
+
 size_t Relation::execute_Equals(RangeQuery Q)
 {
-    size_t result = 0;
+    WorkloadSink result;
     
-    RelationIterator iterEnd = this->end();
-    for (RelationIterator iter = this->begin(); iter != iterEnd; iter++)
-    {
-        if (iter->start == Q.start && iter->end == Q.end)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= iter->id;
-#endif
-        }
-    }
+    this->execute_Equals(Q, result);
     
-    return result;
+    return result.get();
 }
 
 
-size_t Relation::execute_Starts(RangeQuery Q) //Q.start == interval.start, Q.end < interval.end
+template <class Sink>
+void Relation::execute_Starts(RangeQuery Q, Sink &result) //Q.start == interval.start, Q.end < interval.end
 {
-    size_t result = 0;
+    const Timestamp tmax = numeric_limits<Timestamp>::max();
     
-    RelationIterator iterEnd = this->end();
-    for (RelationIterator iter = this->begin(); iter != iterEnd; iter++)
-    {
-        if ((iter->start == Q.start) && (iter->end > Q.end))
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= iter->id;
-#endif
-        }
-    }
+    // start = Q.start, end > Q.end
+    scanRecords(this->kernel, *this, Q.start, Q.start, Q.end+1, tmax, result);
+    this->scanOpenRecords(Q.start, Q.start, Q.end+1, tmax, result);
+}
+
+
+size_t Relation::execute_Starts(RangeQuery Q)
+{
+    WorkloadSink result;
     
-    return result;
+    this->execute_Starts(Q, result);
+    
+    return result.get();
+}
+
+
+template <class Sink>
+void Relation::execute_Started(RangeQuery Q, Sink &result)
+{
+    const Timestamp tmin = numeric_limits<Timestamp>::min();
+    
+    // start = Q.start, end < Q.end
+    scanRecords(this->kernel, *this, Q.start, Q.start, tmin, Q.end-1, result);
+    this->scanOpenRecords(Q.start, Q.start, tmin, Q.end-1, result);
 }
 
 
 size_t Relation::execute_Started(RangeQuery Q)
 {
-    size_t result = 0;
+    WorkloadSink result;
     
-    RelationIterator iterEnd = this->end();
-    for (RelationIterator iter = this->begin(); iter != iterEnd; iter++)
-    {
-        if ((iter->start == Q.start) && (iter->end < Q.end))
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= iter->id;
-#endif
-        }
-    }
+    this->execute_Started(Q, result);
     
-    return result;
+    return result.get();
 }
 
 
-size_t Relation::execute_Finishes(RangeQuery Q) // same end, Q.start > interval.start
+template <class Sink>
+void Relation::execute_Finishes(RangeQuery Q, Sink &result) // same end, Q.start > interval.start
 {
-    size_t result = 0;
+    const Timestamp tmin = numeric_limits<Timestamp>::min();
     
-    RelationIterator iterEnd = this->end();
-    for (RelationIterator iter = this->begin(); iter != iterEnd; iter++)
-    {
-        if ((iter->end == Q.end) && (iter->start < Q.start))
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= iter->id;
-#endif
-        }
-    }
+    // start < Q.start, end = Q.end
+    scanRecords(this->kernel, *this, tmin, Q.start-1, Q.end, Q.end, result);
+    this->scanOpenRecords(tmin, Q.start-1, Q.end, Q.end, result);
+}
+
+
+size_t Relation::execute_Finishes(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->execute_Finishes(Q, result);
     
-    return result;
+    return result.get();
+}
+
+
+template <class Sink>
+void Relation::execute_Finished(RangeQuery Q, Sink &result)
+{
+    const Timestamp tmax = numeric_limits<Timestamp>::max();
+    
+    // start > Q.start, end = Q.end
+    scanRecords(this->kernel, *this, Q.start+1, tmax, Q.end, Q.end, result);
+    this->scanOpenRecords(Q.start+1, tmax, Q.end, Q.end, result);
 }
 
 
 size_t Relation::execute_Finished(RangeQuery Q)
 {
-    size_t result = 0;
+    WorkloadSink result;
     
-    RelationIterator iterEnd = this->end();
-    for (RelationIterator iter = this->begin(); iter != iterEnd; iter++)
-    {
-        if ((iter->end == Q.end) && (iter->start > Q.start))
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= iter->id;
-#endif
-        }
-    }
+    this->execute_Finished(Q, result);
     
-    return result;
+    return result.get();
+}
+
+
+template <class Sink>
+void Relation::execute_Meets(RangeQuery Q, Sink &result)
+{
+    const Timestamp tmin = numeric_limits<Timestamp>::min(), tmax = numeric_limits<Timestamp>::max();
+    
+    // start = Q.end
+    scanRecords(this->kernel, *this, Q.end, Q.end, tmin, tmax, result);
+    this->scanOpenRecords(Q.end, Q.end, tmin, tmax, result);
 }
 
 
 size_t Relation::execute_Meets(RangeQuery Q)
 {
-    size_t result = 0;
+    WorkloadSink result;
     
-    RelationIterator iterEnd = this->end();
-    for (RelationIterator iter = this->begin(); iter != iterEnd; iter++)
-    {
-        if (iter->start == Q.end)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= iter->id;
-#endif
-        }
-    }
+    this->execute_Meets(Q, result);
+    
+    return result.get();
+}
+
+
+template <class Sink>
+void Relation::execute_Met(RangeQuery Q, Sink &result)
+{
+    const Timestamp tmin = numeric_limits<Timestamp>::min(), tmax = numeric_limits<Timestamp>::max();
     
-    return result;
+    // end = Q.start
+    scanRecords(this->kernel, *this, tmin, tmax, Q.start, Q.start, result);
+    this->scanOpenRecords(tmin, tmax, Q.start, Q.start, result);
 }
 
 
 size_t Relation::execute_Met(RangeQuery Q)
 {
-    size_t result = 0;
+    WorkloadSink result;
     
-    RelationIterator iterEnd = this->end();
-    for (RelationIterator iter = this->begin(); iter != iterEnd; iter++)
-    {
-        if (iter->end == Q.start)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= iter->id;
-#endif
-        }
-    }
+    this->execute_Met(Q, result);
     
-    return result;
+    return result.get();
+}
+
+
+template <class Sink>
+void Relation::execute_Overlaps(RangeQuery Q, Sink &result)
+{
+    const Timestamp tmax = numeric_limits<Timestamp>::max();
+    
+    // Q.start < start < Q.end, end > Q.end
+    scanRecords(this->kernel, *this, Q.start+1, Q.end-1, Q.end+1, tmax, result);
+    this->scanOpenRecords(Q.start+1, Q.end-1, Q.end+1, tmax, result);
 }
 
 
 size_t Relation::execute_Overlaps(RangeQuery Q)
 {
-    size_t result = 0;
+    WorkloadSink result;
     
-    RelationIterator iterEnd = this->end();
-    for (RelationIterator iter = this->begin(); iter != iterEnd; iter++)
-    {
-        if ((Q.start < iter->start) && (iter->start < Q.end) && (Q.end < iter->end))
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result^= iter->id;
-#endif
-        }
-    }
+    this->execute_Overlaps(Q, result);
     
-    return result;
+    return result.get();
 }
 
+template <class Sink>
+void Relation::execute_Overlapped(RangeQuery Q, Sink &result)
+{
+    const Timestamp tmin = numeric_limits<Timestamp>::min();
+    
+    // start < Q.start, Q.start < end < Q.end
+    scanRecords(this->kernel, *this, tmin, Q.start-1, Q.start+1, Q.end-1, result);
+    this->scanOpenRecords(tmin, Q.start-1, Q.start+1, Q.end-1, result);
+}
+
+
 size_t Relation::execute_Overlapped(RangeQuery Q)
 {
-    size_t result = 0;
+    WorkloadSink result;
     
-    RelationIterator iterEnd = this->end();
-    for (RelationIterator iter = this->begin(); iter != iterEnd; iter++)
-    {
-        if ((Q.start > iter->start) && (Q.start < iter->end) && (Q.end > iter->end))
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result^= iter->id;
-#endif
-        }
-    }
+    this->execute_Overlapped(Q, result);
+    
+    return result.get();
+}
+
+
+template <class Sink>
+void Relation::execute_Contains(RangeQuery Q, Sink &result)
+{
+    const Timestamp tmin = numeric_limits<Timestamp>::min(), tmax = numeric_limits<Timestamp>::max();
     
-    return result;
+    // start > Q.start, end < Q.end
+    scanRecords(this->kernel, *this, Q.start+1, tmax, tmin, Q.end-1, result);
+    this->scanOpenRecords(Q.start+1, tmax, tmin, Q.end-1, result);
 }
 
 
 size_t Relation::execute_Contains(RangeQuery Q)
 {
-    size_t result = 0;
+    WorkloadSink result;
     
-    RelationIterator iterEnd = this->end();
-    for (RelationIterator iter = this->begin(); iter != iterEnd; iter++)
-    {
-        if ((iter->start > Q.start) && (iter->end < Q.end))
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= iter->id;
-#endif
-        }
-    }
+    this->execute_Contains(Q, result);
     
-    return result;
+    return result.get();
+}
+
+
+template <class Sink>
+void Relation::execute_Contained(RangeQuery Q, Sink &result)
+{
+    const Timestamp tmin = numeric_limits<Timestamp>::min(), tmax = numeric_limits<Timestamp>::max();
+    
+    // start < Q.start, end > Q.end
+    scanRecords(this->kernel, *this, tmin, Q.start-1, Q.end+1, tmax, result);
+    this->scanOpenRecords(tmin, Q.start-1, Q.end+1, tmax, result);
 }
 
 
 size_t Relation::execute_Contained(RangeQuery Q)
 {
-    size_t result = 0;
+    WorkloadSink result;
     
-    RelationIterator iterEnd = this->end();
-    for (RelationIterator iter = this->begin(); iter != iterEnd; iter++)
-    {
-        if ((iter->start < Q.start) && (iter->end > Q.end))
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= iter->id;
-#endif
-        }
-    }
+    this->execute_Contained(Q, result);
     
-    return result;
+    return result.get();
+}
+
+
+template <class Sink>
+void Relation::execute_Precedes(RangeQuery Q, Sink &result)
+{
+    const Timestamp tmin = numeric_limits<Timestamp>::min(), tmax = numeric_limits<Timestamp>::max();
+    
+    // start > Q.end
+    scanRecords(this->kernel, *this, Q.end+1, tmax, tmin, tmax, result);
+    this->scanOpenRecords(Q.end+1, tmax, tmin, tmax, result);
 }
 
 
 size_t Relation::execute_Precedes(RangeQuery Q)
 {
-    size_t result = 0;
+    WorkloadSink result;
     
-    RelationIterator iterEnd = this->end();
-    for (RelationIterator iter = this->begin(); iter != iterEnd; iter++)
-    {
-        if (iter->start > Q.end)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= iter->id;
-#endif
-        }
-    }
+    this->execute_Precedes(Q, result);
+    
+    return result.get();
+}
+
+
+template <class Sink>
+void Relation::execute_Preceded(RangeQuery Q, Sink &result)
+{
+    const Timestamp tmin = numeric_limits<Timestamp>::min(), tmax = numeric_limits<Timestamp>::max();
     
-    return result;
+    // end < Q.start
+    scanRecords(this->kernel, *this, tmin, tmax, tmin, Q.start-1, result);
+    this->scanOpenRecords(tmin, tmax, tmin, Q.start-1, result);
 }
 
 
 size_t Relation::execute_Preceded(RangeQuery Q)
 {
-    size_t result = 0;
+    WorkloadSink result;
     
-    RelationIterator iterEnd = this->end();
-    for (RelationIterator iter = this->begin(); iter != iterEnd; iter++)
-    {
-        if (iter->end < Q.start)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= iter->id;
-#endif
-        }
-    }
+    this->execute_Preceded(Q, result);
     
-    return result;
+    return result.get();
+}
+
+
+template <class Sink>
+void Relation::execute_gOverlaps(StabbingQuery Q, Sink &result)
+{
+    const Timestamp tmin = numeric_limits<Timestamp>::min(), tmax = numeric_limits<Timestamp>::max();
+    
+    // start <= Q.point <= end
+    scanRecords(this->kernel, *this, tmin, Q.point, Q.point, tmax, result);
+    this->scanOpenRecords(tmin, Q.point, Q.point, tmax, result);
 }
 
 
 size_t Relation::execute_gOverlaps(StabbingQuery Q)
 {
-    size_t result = 0;
+    WorkloadSink result;
     
-    RelationIterator iterEnd = this->end();
-    for (RelationIterator iter = this->begin(); iter != iterEnd; iter++)
-    {
-        if ((iter->start <= Q.point) && (Q.point <= iter->end))
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= iter->id;
-#endif
-        }
-    }
+    this->execute_gOverlaps(Q, result);
     
-    return result;
+    return result.get();
+}
+
+
+template <class Sink>
+void Relation::execute_gOverlaps(RangeQuery Q, Sink &result)
+{
+    const Timestamp tmin = numeric_limits<Timestamp>::min(), tmax = numeric_limits<Timestamp>::max();
+    
+    // start <= Q.end, Q.start <= end
+    scanRecords(this->kernel, *this, tmin, Q.end, Q.start, tmax, result);
+    this->scanOpenRecords(tmin, Q.end, Q.start, tmax, result);
 }
 
 
 size_t Relation::execute_gOverlaps(RangeQuery Q)
 {
-    size_t result = 0;
+    WorkloadSink result;
     
-    RelationIterator iterEnd = this->end();
-    for (RelationIterator iter = this->begin(); iter != iterEnd; iter++)
-    {
-        if ((iter->start <= Q.end) && (Q.start <= iter->end))
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= iter->id;
-#endif
-        }
-    }
+    this->execute_gOverlaps(Q, result);
     
-    return result;
+    return result.get();
 }
 
 
@@ -636,3 +808,25 @@ void RelationId::print(char c)
 RelationId::~RelationId()
 {
 }
+
+
+
+// Explicit instantiations for every result sink
+#define INSTANTIATE_RELATION(Sink) \
+    template void Relation::execute_Equals(RangeQuery, Sink&); \
+    template void Relation::execute_Starts(RangeQuery, Sink&); \
+    template void Relation::execute_Started(RangeQuery, Sink&); \
+    template void Relation::execute_Finishes(RangeQuery, Sink&); \
+    template void Relation::execute_Finished(RangeQuery, Sink&); \
+    template void Relation::execute_Meets(RangeQuery, Sink&); \
+    template void Relation::execute_Met(RangeQuery, Sink&); \
+    template void Relation::execute_Overlaps(RangeQuery, Sink&); \
+    template void Relation::execute_Overlapped(RangeQuery, Sink&); \
+    template void Relation::execute_Contains(RangeQuery, Sink&); \
+    template void Relation::execute_Contained(RangeQuery, Sink&); \
+    template void Relation::execute_Precedes(RangeQuery, Sink&); \
+    template void Relation::execute_Preceded(RangeQuery, Sink&); \
+    template void Relation::execute_gOverlaps(StabbingQuery, Sink&); \
+    template void Relation::execute_gOverlaps(RangeQuery, Sink&);
+
+FOR_EACH_SINK(INSTANTIATE_RELATION)
@@ -31,6 +31,7 @@
 #define _RELATION_H_
 
 #include "../def_global.h"
+#include "mapping.h"
 
 
 
@@ -124,17 +125,56 @@ inline bool CompareByEnd(const Record &lhs, const Record &rhs)
 
 
 
-class Relation : public vector<Record>
+// Binary format of a relation, see Relation::save() and Relation::load():
+// this header, followed by the records, i.e., (id, start, end) each, in the
+// order of their ids, exactly as they are in memory, so that a relation is
+// loaded as a view of the mapped file. Files of the older columnar format,
+// i.e., the starts and then the ends of the records, Timestamp each, with the
+// ids being the positions in these arrays, are still read, into a copy.
+#define RELATION_FILE_MAGIC         "HINTREL2"
+#define RELATION_FILE_MAGIC_COLUMNS "HINTREL1"
+
+struct RelationFileHeader
+{
+    char     magic[8];
+    uint64_t numRecords;
+    Timestamp gstart;
+    Timestamp gend;
+    Timestamp longestRecord;
+    float    avgRecordExtent;
+};
+
+inline bool isRelationFileMagic(const char *magic)
+{
+    return ((!memcmp(magic, RELATION_FILE_MAGIC, 8)) || (!memcmp(magic, RELATION_FILE_MAGIC_COLUMNS, 8)));
+}
+
+
+
+// May view a memory-mapped file, see loadBinary() and containers/mapping.h
+class Relation : public vector<Record, MappedAllocator<Record> >
 {
 public:
     Timestamp gstart;
     Timestamp gend;
     Timestamp longestRecord;
     float avgRecordExtent;
+    unsigned int kernel;    // Scan kernel set, see containers/kernels.h
+    vector<RecordStart> openRecords;    // Open intervals, kept apart, see OPEN_END
+    
+    // The binary file the records view, if any, unmapped with the relation
+    void *mapping;
+    size_t mappingSize;
+    MappedRegion *region;
     
     Relation();
     Relation(Relation &R);
+    Relation& operator = (const Relation &R) = delete;
+    void swap(Relation &R);
     void load(const char *filename);
+    void loadBinary(const char *filename);
+    void save(const char *filename);
+    void extractOpenRecords();
     void sortByStart();
     void sortByEnd();
     void print(char c);
@@ -159,6 +199,38 @@ public:
     // Generalized predicate, ACM SIGMOD'22 gOverlaps
     size_t execute_gOverlaps(StabbingQuery Q);
     size_t execute_gOverlaps(RangeQuery Q);
+
+    // Querying with an explicit result sink, see containers/sinks.h
+    template <class Sink> void execute_Equals(RangeQuery Q, Sink &result);
+    template <class Sink> void execute_Starts(RangeQuery Q, Sink &result);
+    template <class Sink> void execute_Started(RangeQuery Q, Sink &result);
+    template <class Sink> void execute_Finishes(RangeQuery Q, Sink &result);
+    template <class Sink> void execute_Finished(RangeQuery Q, Sink &result);
+    template <class Sink> void execute_Meets(RangeQuery Q, Sink &result);
+    template <class Sink> void execute_Met(RangeQuery Q, Sink &result);
+    template <class Sink> void execute_Overlaps(RangeQuery Q, Sink &result);
+    template <class Sink> void execute_Overlapped(RangeQuery Q, Sink &result);
+    template <class Sink> void execute_Contains(RangeQuery Q, Sink &result);
+    template <class Sink> void execute_Contained(RangeQuery Q, Sink &result);
+    template <class Sink> void execute_Precedes(RangeQuery Q, Sink &result);
+    template <class Sink> void execute_Preceded(RangeQuery Q, Sink &result);
+    template <class Sink> void execute_gOverlaps(StabbingQuery Q, Sink &result);
+    template <class Sink> void execute_gOverlaps(RangeQuery Q, Sink &result);
+    
+    // Reports the open intervals in the box of a predicate, see scanRecords()
+    // in containers/kernels.h; their end is past any other timestamp
+    template <class Sink>
+    inline void scanOpenRecords(const Timestamp sLo, const Timestamp sHi, const Timestamp, const Timestamp eHi, Sink &result) const
+    {
+        if (eHi < OPEN_END)
+            return;
+        
+        for (const RecordStart &r : this->openRecords)
+        {
+            if ((r.start >= sLo) && (r.start <= sHi))
+                result.add(r.id);
+        }
+    };
 };
 typedef Relation::const_iterator RelationIterator;
 
@@ -189,7 +261,8 @@ typedef RelationEnd::const_iterator RelationEndIterator;
 
 
 
-class RelationId : public vector<RecordId>
+// May view a memory-mapped file, see containers/mapping.h
+class RelationId : public vector<RecordId, MappedAllocator<RecordId> >
 {
 public:
     RelationId();
@@ -197,4 +270,73 @@ public:
     ~RelationId();
 };
 typedef RelationId::iterator RelationIdIterator;
+
+// Timestamps along a RelationId, e.g., in HINT_M_ALL
+typedef vector<Timestamp, MappedAllocator<Timestamp> > TimestampArray;
+typedef TimestampArray::iterator TimestampArrayIterator;
+
+
+
+// The (start, end) pairs of a partition class, kept as two arrays so that
+// the comparison kernels load either timestamp contiguously, see
+// containers/kernels.h. The iterators still read a pair<Timestamp, Timestamp>,
+// i.e., the searches and scans over an array of pairs work unchanged.
+class TimestampPairs
+{
+public:
+    vector<Timestamp> starts;
+    vector<Timestamp> ends;
+
+    class iterator
+    {
+    public:
+        typedef random_access_iterator_tag iterator_category;
+        typedef pair<Timestamp, Timestamp> value_type;
+        typedef ptrdiff_t difference_type;
+        typedef const value_type* pointer;
+        typedef value_type reference;
+
+        // Holds the pair read, for iter->first and iter->second
+        struct Proxy
+        {
+            value_type value;
+
+            const value_type* operator -> () const {return &this->value;};
+        };
+
+        const Timestamp *start;
+        const Timestamp *end;
+
+        iterator() : start(NULL), end(NULL) {};
+        iterator(const Timestamp *start, const Timestamp *end) : start(start), end(end) {};
+
+        inline value_type operator * () const {return value_type(*this->start, *this->end);};
+        inline Proxy operator -> () const {return Proxy{value_type(*this->start, *this->end)};};
+        inline value_type operator [] (const difference_type i) const {return value_type(this->start[i], this->end[i]);};
+        inline iterator& operator ++ () {this->start++; this->end++; return *this;};
+        inline iterator operator ++ (int) {iterator tmp = *this; this->start++; this->end++; return tmp;};
+        inline iterator& operator -- () {this->start--; this->end--; return *this;};
+        inline iterator operator -- (int) {iterator tmp = *this; this->start--; this->end--; return tmp;};
+        inline iterator& operator += (const difference_type n) {this->start += n; this->end += n; return *this;};
+        inline iterator& operator -= (const difference_type n) {this->start -= n; this->end -= n; return *this;};
+        inline iterator operator + (const difference_type n) const {return iterator(this->start+n, this->end+n);};
+        inline iterator operator - (const difference_type n) const {return iterator(this->start-n, this->end-n);};
+        inline difference_type operator - (const iterator &rhs) const {return this->start-rhs.start;};
+        inline bool operator == (const iterator &rhs) const {return this->start == rhs.start;};
+        inline bool operator != (const iterator &rhs) const {return this->start != rhs.start;};
+        inline bool operator < (const iterator &rhs) const {return this->start < rhs.start;};
+        inline bool operator > (const iterator &rhs) const {return this->start > rhs.start;};
+        inline bool operator <= (const iterator &rhs) const {return this->start <= rhs.start;};
+        inline bool operator >= (const iterator &rhs) const {return this->start >= rhs.start;};
+    };
+
+    inline size_t size() const {return this->starts.size();};
+    inline void resize(const size_t n) {this->starts.resize(n); this->ends.resize(n);};
+    inline void swap(TimestampPairs &rhs) {this->starts.swap(rhs.starts); this->ends.swap(rhs.ends);};
+    inline iterator begin() const {return iterator(this->starts.data(), this->ends.data());};
+    inline iterator end() const {return iterator(this->starts.data()+this->starts.size(), this->ends.data()+this->ends.size());};
+    inline pair<Timestamp, Timestamp> operator [] (const size_t i) const {return pair<Timestamp, Timestamp>(this->starts[i], this->ends[i]);};
+    inline void set(const size_t i, const Timestamp start, const Timestamp end) {this->starts[i] = start; this->ends[i] = end;};
+    inline void set(const size_t i, const pair<Timestamp, Timestamp> &p) {this->starts[i] = p.first; this->ends[i] = p.second;};
+};
 #endif //_RELATION_H_
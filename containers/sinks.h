@@ -0,0 +1,342 @@
+/******************************************************************************
+ * Project:  hint
+ * Purpose:  Indexing interval data
+ * Author:   Panagiotis Bouros, pbour@github.io
+ * Author:   George Christodoulou
+ ******************************************************************************
+ * Copyright (c) 2020 - 2024
+ *
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************/
+
+
+#ifndef _SINKS_H_
+#define _SINKS_H_
+
+#include "../def_global.h"
+#include "relation.h"
+
+
+
+// Result sinks. Every querying method takes the sink as a template parameter,
+// so reporting a qualifying record is inlined inside the scan loops; no
+// virtual call is involved per record.
+//
+// When a query is evaluated in parallel, every thread reports to a private
+// sink of type Sink::Partial; the partial sinks are then merged into the
+// query's sink, in thread order, by the calling thread.
+//
+// Ranges of ids known to qualify without comparisons are reported at once by
+// addRange(); a sink that only counts (countsOnly) handles them in O(1).
+
+// Counts the qualifying records.
+class CountSink
+{
+public:
+    typedef CountSink Partial;
+    static const bool countsOnly = true;
+    
+    size_t result;
+    
+    CountSink()
+    {
+        this->result = 0;
+    };
+    
+    inline void add(const RecordId)
+    {
+        this->result++;
+    };
+    
+    // Counting a contiguous range of ids needs no access to the ids.
+    template <class Iterator>
+    inline void addRange(Iterator first, Iterator last)
+    {
+        this->result += last-first;
+    };
+    
+    inline void merge(const CountSink &other)
+    {
+        this->result += other.result;
+    };
+    
+    inline size_t get() const
+    {
+        return this->result;
+    };
+};
+
+
+
+// XOR'es the ids of the qualifying records.
+class XorSink
+{
+public:
+    typedef XorSink Partial;
+    static const bool countsOnly = false;
+    
+    size_t result;
+    
+    XorSink()
+    {
+        this->result = 0;
+    };
+    
+    inline void add(const RecordId id)
+    {
+        this->result ^= id;
+    };
+    
+    // Reports the contiguous ids in [first, last), all of which qualify.
+    template <class Iterator>
+    inline void addRange(Iterator first, Iterator last)
+    {
+        for (Iterator iter = first; iter != last; iter++)
+            this->add(*iter);
+    };
+    
+    inline void merge(const XorSink &other)
+    {
+        this->result ^= other.result;
+    };
+    
+    inline size_t get() const
+    {
+        return this->result;
+    };
+};
+
+
+
+// Appends the ids of the qualifying records to a vector.
+class VectorSink
+{
+public:
+    typedef VectorSink Partial;
+    static const bool countsOnly = false;
+    
+    vector<RecordId> ids;
+    
+    VectorSink()
+    {
+    };
+    
+    inline void add(const RecordId id)
+    {
+        this->ids.push_back(id);
+    };
+    
+    // Reports the contiguous ids in [first, last), all of which qualify.
+    template <class Iterator>
+    inline void addRange(Iterator first, Iterator last)
+    {
+        for (Iterator iter = first; iter != last; iter++)
+            this->add(*iter);
+    };
+    
+    inline void merge(const VectorSink &other)
+    {
+        this->ids.insert(this->ids.end(), other.ids.begin(), other.ids.end());
+    };
+    
+    inline size_t get() const
+    {
+        return this->ids.size();
+    };
+};
+
+
+
+// Writes the ids of the qualifying records in a caller-provided buffer of
+// fixed capacity; the ids that do not fit are only counted.
+class BufferSink
+{
+public:
+    typedef VectorSink Partial;
+    static const bool countsOnly = false;
+    
+    RecordId *buffer;
+    size_t capacity;
+    size_t numResults;
+    
+    BufferSink(RecordId *buffer, const size_t capacity)
+    {
+        this->buffer     = buffer;
+        this->capacity   = capacity;
+        this->numResults = 0;
+    };
+    
+    inline void add(const RecordId id)
+    {
+        if (this->numResults < this->capacity)
+            this->buffer[this->numResults] = id;
+        this->numResults++;
+    };
+    
+    template <class Iterator>
+    inline void addRange(Iterator first, Iterator last)
+    {
+        for (Iterator iter = first; iter != last; iter++)
+            this->add(*iter);
+    };
+    
+    inline void merge(const VectorSink &other)
+    {
+        for (const RecordId &id : other.ids)
+            this->add(id);
+    };
+    
+    inline bool isOverflown() const
+    {
+        return (this->numResults > this->capacity);
+    };
+    
+    inline size_t get() const
+    {
+        return min(this->numResults, this->capacity);
+    };
+};
+
+
+
+// Invokes a plain function for every qualifying record.
+class CallbackSink
+{
+public:
+    typedef void (*Callback)(const RecordId id, void *arg);
+    typedef VectorSink Partial;
+    static const bool countsOnly = false;
+    
+    Callback callback;
+    void *arg;
+    size_t numResults;
+    
+    CallbackSink(Callback callback, void *arg)
+    {
+        this->callback   = callback;
+        this->arg        = arg;
+        this->numResults = 0;
+    };
+    
+    inline void add(const RecordId id)
+    {
+        this->callback(id, this->arg);
+        this->numResults++;
+    };
+    
+    template <class Iterator>
+    inline void addRange(Iterator first, Iterator last)
+    {
+        for (Iterator iter = first; iter != last; iter++)
+            this->add(*iter);
+    };
+    
+    // The callback is always invoked by the thread that issued the query.
+    inline void merge(const VectorSink &other)
+    {
+        for (const RecordId &id : other.ids)
+            this->add(id);
+    };
+    
+    inline size_t get() const
+    {
+        return this->numResults;
+    };
+};
+
+
+
+// Aggregates the qualifying records: their number, the XOR of their ids and
+// the sum of their durations. Records are looked up by id, i.e., the ids must
+// be the positions of the records in R, as assigned by Relation::load(); see
+// also containers/aggregates.h for answering with O(1) cost per partition
+// range.
+class AggregateSink
+{
+public:
+    typedef VectorSink Partial;
+    static const bool countsOnly = false;
+    
+    const Relation &R;
+    size_t numResults;
+    size_t xorIds;
+    size_t sumDurations;
+    
+    AggregateSink(const Relation &R) : R(R)
+    {
+        this->numResults   = 0;
+        this->xorIds       = 0;
+        this->sumDurations = 0;
+    };
+    
+    inline void add(const RecordId id)
+    {
+        this->numResults++;
+        this->xorIds ^= id;
+        this->sumDurations += this->R[id].end-this->R[id].start;
+    };
+    
+    template <class Iterator>
+    inline void addRange(Iterator first, Iterator last)
+    {
+        for (Iterator iter = first; iter != last; iter++)
+            this->add(*iter);
+    };
+    
+    // Adds the precomputed aggregates of a set of qualifying records.
+    inline void addAggregates(const size_t numResults, const size_t xorIds, const size_t sumDurations)
+    {
+        this->numResults   += numResults;
+        this->xorIds       ^= xorIds;
+        this->sumDurations += sumDurations;
+    };
+    
+    inline void merge(const VectorSink &other)
+    {
+        for (const RecordId &id : other.ids)
+            this->add(id);
+    };
+    
+    inline size_t get() const
+    {
+        return this->numResults;
+    };
+};
+
+
+
+// Sink used by the size_t-returning querying methods; see WORKLOAD_COUNT.
+#ifdef WORKLOAD_COUNT
+typedef CountSink WorkloadSink;
+#else
+typedef XorSink WorkloadSink;
+#endif
+
+// Applies macro M to every sink; used for the explicit instantiations of the
+// templated querying methods.
+#define FOR_EACH_SINK(M) \
+    M(CountSink) \
+    M(XorSink) \
+    M(VectorSink) \
+    M(BufferSink) \
+    M(CallbackSink) \
+    M(AggregateSink)
+#endif //_SINKS_H_
@@ -0,0 +1,282 @@
+/******************************************************************************
+ * Project:  hint
+ * Purpose:  Indexing interval data
+ * Author:   Panagiotis Bouros, pbour@github.io
+ * Author:   George Christodoulou
+ ******************************************************************************
+ * Copyright (c) 2020 - 2024
+ *
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************/
+
+
+
+#ifndef _TEXTPARSER_H_
+#define _TEXTPARSER_H_
+
+#include "../def_global.h"
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+
+
+// Parser for the text format of the data and the query files, i.e., one
+// "start end" interval per line, where the end of an open interval is "now".
+// The file is mapped and split into chunks that end at a newline, which are
+// parsed by separate threads; the intervals get the ids they would get from
+// reading the file sequentially. The parser stops at the first token that
+// is not a number, like operator>> does.
+
+// Minimum size of a chunk, to avoid threads for small files
+#define TEXT_PARSER_MIN_CHUNK_SIZE (1 << 20)
+
+
+
+// Statistics of the parsed intervals, aggregated per chunk and then merged
+struct IntervalFileStats
+{
+    Timestamp gstart;
+    Timestamp gend;
+    Timestamp longestRecord;
+    size_t    sumExtent;
+    bool      invalid;                      // some interval starts after its end
+    Timestamp invalidStart, invalidEnd;     // the first such interval
+    size_t    numOpen;                      // open intervals, see OPEN_END
+    
+    void init()
+    {
+        gstart        = std::numeric_limits<Timestamp>::max();
+        gend          = std::numeric_limits<Timestamp>::min();
+        longestRecord = std::numeric_limits<Timestamp>::min();
+        sumExtent     = 0;
+        invalid       = false;
+        numOpen       = 0;
+    };
+    
+    // An open interval counts only with its start
+    void add(Timestamp start, Timestamp end)
+    {
+        if (end == OPEN_END)
+        {
+            gstart = std::min(gstart, start);
+            gend   = std::max(gend, start);
+            numOpen++;
+            return;
+        }
+        if ((start > end) && (!invalid))
+        {
+            invalid      = true;
+            invalidStart = start;
+            invalidEnd   = end;
+        }
+        gstart        = std::min(gstart, start);
+        gend          = std::max(gend, end);
+        longestRecord = std::max(longestRecord, end-start+1);
+        sumExtent    += end-start;
+    };
+    
+    // rhs comes after this in the file
+    void merge(const IntervalFileStats &rhs)
+    {
+        if ((rhs.invalid) && (!invalid))
+        {
+            invalid      = true;
+            invalidStart = rhs.invalidStart;
+            invalidEnd   = rhs.invalidEnd;
+        }
+        gstart        = std::min(gstart, rhs.gstart);
+        gend          = std::max(gend, rhs.gend);
+        longestRecord = std::max(longestRecord, rhs.longestRecord);
+        sumExtent    += rhs.sumExtent;
+        numOpen      += rhs.numOpen;
+    };
+};
+
+
+inline bool isTextSpace(const char c)
+{
+    return ((c == ' ') || (c == '\n') || (c == '\t') || (c == '\r') || (c == '\v') || (c == '\f'));
+}
+
+
+// Parses the next decimal number in [p, end); returns false if there is no
+// number before the next token or the end, leaving p at that token
+inline bool parseTimestamp(const char *&p, const char *end, Timestamp &t)
+{
+    const char *q;
+    long long v = 0;
+    bool negative = false;
+    
+    
+    while ((p < end) && (isTextSpace(*p)))
+        p++;
+    
+    q = p;
+    if ((q < end) && ((*q == '-') || (*q == '+')))
+    {
+        negative = (*q == '-');
+        q++;
+    }
+    if ((q == end) || (*q < '0') || (*q > '9'))
+        return false;
+    
+    while ((q < end) && (*q >= '0') && (*q <= '9'))
+    {
+        v = v*10 + (*q-'0');
+        q++;
+    }
+    t = (negative)? -v: v;
+    p = q;
+    
+    return true;
+}
+
+
+// Parses the intervals in [p, end) into chunk, with ids 0, 1, ...; sets
+// stopped if the parsing ended before the end of the chunk
+template <class T, class Allocator>
+void parseIntervalChunk(const char *p, const char *end, vector<T, Allocator> &chunk, IntervalFileStats &stats, bool &stopped)
+{
+    Timestamp start, finish;
+    
+    
+    stats.init();
+    while (parseTimestamp(p, end, start))
+    {
+        if (!parseTimestamp(p, end, finish))
+        {
+            if ((end-p < 3) || (memcmp(p, "now", 3)))
+            {
+                stopped = true;
+                return;
+            }
+            finish = OPEN_END;
+            p += 3;
+        }
+        chunk.emplace_back(chunk.size(), start, finish);
+        stats.add(start, finish);
+    }
+    stopped = (p != end);
+}
+
+
+// Appends the intervals of a text file to result, with ids firstId,
+// firstId+1, ... in the order of the file; T needs a constructor T(id, start,
+// end) and an id member. The kind of file is used only in error messages.
+template <class T, class Allocator>
+void parseIntervalFile(const char *filename, const char *kind, size_t firstId, vector<T, Allocator> &result, IntervalFileStats &stats)
+{
+    int fd = open(filename, O_RDONLY);
+    struct stat st;
+    const char *data = NULL;
+    size_t size, numThreads, numChunks, numIntervals = 0, base = result.size();
+    
+    
+    if ((fd == -1) || (fstat(fd, &st) == -1))
+    {
+        cerr << endl << "Error - cannot open " << kind << " file \"" << filename << "\"" << endl << endl;
+        exit(1);
+    }
+    size = st.st_size;
+    if (size > 0)
+    {
+        data = (const char*)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            cerr << endl << "Error - cannot map " << kind << " file \"" << filename << "\"" << endl << endl;
+            exit(1);
+        }
+        madvise((void*)data, size, MADV_SEQUENTIAL);
+    }
+    close(fd);
+    
+    // Split into chunks that end right after a newline
+    numThreads = std::max(1u, std::thread::hardware_concurrency());
+    numThreads = std::max((size_t)1, std::min(numThreads, size/TEXT_PARSER_MIN_CHUNK_SIZE));
+    vector<const char*> bounds(numThreads+1);
+    bounds[0] = data;
+    bounds[numThreads] = data+size;
+    for (size_t t = 1; t < numThreads; t++)
+    {
+        const char *p = (const char*)memchr(data+t*size/numThreads, '\n', size-t*size/numThreads);
+        bounds[t] = std::max(bounds[t-1], (p)? p+1: data+size);
+    }
+    
+    // Parse the chunks
+    vector<vector<T, Allocator> > chunks(numThreads);
+    vector<IntervalFileStats> chunkStats(numThreads);
+    vector<char> stopped(numThreads);
+    vector<thread> workers;
+    for (size_t t = 1; t < numThreads; t++)
+        workers.emplace_back([&, t]() { bool s; parseIntervalChunk(bounds[t], bounds[t+1], chunks[t], chunkStats[t], s); stopped[t] = s; });
+    {
+        bool s;
+        parseIntervalChunk(bounds[0], bounds[1], chunks[0], chunkStats[0], s);
+        stopped[0] = s;
+    }
+    for (auto &w : workers)
+        w.join();
+    workers.clear();
+    if (data != NULL)
+        munmap((void*)data, size);
+    
+    // Keep the chunks up to the first one where the parsing stopped
+    vector<size_t> offsets(numThreads+1, 0);
+    numChunks = 0;
+    stats.init();
+    while (numChunks < numThreads)
+    {
+        offsets[numChunks] = numIntervals;
+        numIntervals += chunks[numChunks].size();
+        stats.merge(chunkStats[numChunks]);
+        numChunks++;
+        if (stopped[numChunks-1])
+            break;
+    }
+    
+    // Move the chunks into place, fixing the ids
+    if ((numChunks == 1) && (base == 0) && (firstId == 0))
+    {
+        result.swap(chunks[0]);
+        return;
+    }
+    result.resize(base+numIntervals);
+    auto place = [&](size_t t)
+    {
+        T *out = result.data()+base+offsets[t];
+        for (const T &x : chunks[t])
+        {
+            *out = x;
+            out->id += firstId+offsets[t];
+            out++;
+        }
+        vector<T, Allocator>().swap(chunks[t]);
+    };
+    for (size_t t = 1; t < numChunks; t++)
+        workers.emplace_back(place, t);
+    place(0);
+    for (auto &w : workers)
+        w.join();
+}
+
+#endif // _TEXTPARSER_H_
@@ -0,0 +1,129 @@
+/******************************************************************************
+ * Project:  hint
+ * Purpose:  Indexing interval data
+ * Author:   Panagiotis Bouros, pbour@github.io
+ * Author:   George Christodoulou
+ ******************************************************************************
+ * Copyright (c) 2020 - 2024
+ *
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************/
+
+
+#ifndef _THREADPOOL_H_
+#define _THREADPOOL_H_
+
+#include "../def_global.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+
+
+// Fixed set of threads used to evaluate a single query in parallel. The
+// threads are created once and sleep between jobs, so handing them a job
+// costs a wake-up instead of a thread creation. The calling thread takes
+// part in every job as thread 0.
+class ThreadPool
+{
+private:
+    vector<thread> workers;
+    mutex lock;                     // Protects the job state below
+    mutex jobLock;                  // Serializes concurrent callers of run()
+    condition_variable cvJob, cvDone;
+    function<void(unsigned int)> job;
+    size_t jobId;
+    unsigned int numPending;
+    bool stop;
+    
+    void work(const unsigned int t)
+    {
+        size_t lastJobId = 0;
+        
+        while (true)
+        {
+            {
+                unique_lock<mutex> guard(this->lock);
+                this->cvJob.wait(guard, [&] { return (this->stop || this->jobId != lastJobId); });
+                if (this->stop)
+                    return;
+                lastJobId = this->jobId;
+            }
+            
+            this->job(t);
+            
+            {
+                lock_guard<mutex> guard(this->lock);
+                if (--this->numPending == 0)
+                    this->cvDone.notify_one();
+            }
+        }
+    };
+    
+public:
+    ThreadPool(const unsigned int numThreads)
+    {
+        this->jobId      = 0;
+        this->numPending = 0;
+        this->stop       = false;
+        for (auto t = 1; t < numThreads; t++)
+            this->workers.emplace_back(&ThreadPool::work, this, t);
+    };
+    
+    // Number of threads taking part in a job, including the caller.
+    inline unsigned int size() const
+    {
+        return this->workers.size()+1;
+    };
+    
+    // Invokes task(t) for every t in [0, size()) and waits until all calls
+    // have returned.
+    void run(const function<void(unsigned int)> &task)
+    {
+        lock_guard<mutex> jobGuard(this->jobLock);
+        
+        {
+            lock_guard<mutex> guard(this->lock);
+            this->job = task;
+            this->numPending = this->workers.size();
+            this->jobId++;
+        }
+        this->cvJob.notify_all();
+        
+        task(0);
+        
+        unique_lock<mutex> guard(this->lock);
+        this->cvDone.wait(guard, [&] { return (this->numPending == 0); });
+    };
+    
+    ~ThreadPool()
+    {
+        {
+            lock_guard<mutex> guard(this->lock);
+            this->stop = true;
+        }
+        this->cvJob.notify_all();
+        for (auto &w : this->workers)
+            w.join();
+    };
+};
+#endif //_THREADPOOL_H_
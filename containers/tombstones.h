@@ -0,0 +1,268 @@
+/******************************************************************************
+ * Project:  hint
+ * Purpose:  Indexing interval data
+ * Author:   Panagiotis Bouros, pbour@github.io
+ * Author:   George Christodoulou
+ ******************************************************************************
+ * Copyright (c) 2020 - 2024
+ *
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************/
+
+#ifndef _TOMBSTONES_H_
+#define _TOMBSTONES_H_
+
+#include "../def_global.h"
+#include "relation.h"
+#include "sinks.h"
+#include "kernels.h"
+
+#define TOMBSTONES_PURGE_RATIO 0.05 // Default fraction of erased records that triggers a purge
+#define TOMBSTONES_SAMPLE_RATE 64   // One in this many positions is sampled, see Tombstones::lowerBound()
+
+
+
+// Records erased from an index, see HierarchicalIndex::erase(); they stay in
+// the partitions until the next purge. An erased record is marked in a bitmap
+// over the ids, checked for every record reported after a comparison, and
+// the positions of its copies in the arrays of the index are kept sorted,
+// so that a range of ids that qualify without comparisons is reported as
+// the sub-ranges between the erased ones, in O(log n) plus their number; a
+// count instead subtracts the number of erased copies in the range, and an
+// XOR takes them out again.
+//
+// The positions are kept in two sorted runs, the recent ones being merged in
+// the rest when they exceed its square root, so that an erasure costs
+// O(sqrt(n)) amortized instead of O(n). A query searches the runs for every
+// range it reports, so the large run is searched through a sample of its
+// positions, small enough to stay in the cache, and then only within one
+// block of TOMBSTONES_SAMPLE_RATE positions.
+class Tombstones
+{
+public:
+    typedef vector<const RecordId*>::const_iterator Iterator;
+    
+    vector<uint64_t> bits;
+    vector<const RecordId*> slots, recent, sample;
+    size_t numErased;
+    float purgeRatio;
+    
+    Tombstones()
+    {
+        this->numErased  = 0;
+        this->purgeRatio = TOMBSTONES_PURGE_RATIO;
+    };
+    
+    inline bool empty() const {return (this->numErased == 0);};
+    inline size_t size() const {return this->numErased;};
+    
+    inline bool isErased(const RecordId id) const
+    {
+        size_t w = ((size_t)id) >> 6;
+        
+        return ((w < this->bits.size()) && ((this->bits[w] >> (id & 63)) & 1));
+    };
+    
+    // Marks the record with the given id, whose copies are in slots
+    void insert(const RecordId id, const vector<const RecordId*> &slots)
+    {
+        size_t w = ((size_t)id) >> 6;
+        
+        if (w >= this->bits.size())
+            this->bits.resize(w+1, 0);
+        this->bits[w] |= ((uint64_t)1) << (id & 63);
+        for (const RecordId *s : slots)
+            this->recent.insert(upper_bound(this->recent.begin(), this->recent.end(), s), s);
+        if (this->recent.size()*this->recent.size() > this->slots.size())
+        {
+            size_t n = this->slots.size();
+            
+            this->slots.insert(this->slots.end(), this->recent.begin(), this->recent.end());
+            inplace_merge(this->slots.begin(), this->slots.begin()+n, this->slots.end());
+            this->recent.clear();
+            
+            this->sample.clear();
+            for (auto i = 0; i < this->slots.size(); i += TOMBSTONES_SAMPLE_RATE)
+                this->sample.push_back(this->slots[i]);
+        }
+        this->numErased++;
+    };
+    
+    // First position of the large run not before p
+    inline Iterator lowerBound(const RecordId *p) const
+    {
+        size_t j = lower_bound(this->sample.begin(), this->sample.end(), p)-this->sample.begin();
+        Iterator first = this->slots.begin()+((j > 0)? (j-1)*TOMBSTONES_SAMPLE_RATE: 0);
+        Iterator last  = this->slots.begin()+min(j*TOMBSTONES_SAMPLE_RATE, this->slots.size());
+        
+        return lower_bound(first, last, p);
+    };
+    
+    // First position of the recent run not before p
+    inline Iterator lowerBoundRecent(const RecordId *p) const
+    {
+        return lower_bound(this->recent.begin(), this->recent.end(), p);
+    };
+    
+    // First position in [first, last) not before p, searching forward from
+    // first in steps that double, as it is usually close
+    static inline Iterator gallop(Iterator first, Iterator last, const RecordId *p)
+    {
+        size_t step = 1;
+        
+        if ((first == last) || (*first >= p))
+            return first;
+        while ((step < last-first) && (first[step] < p))
+        {
+            first += step;
+            step <<= 1;
+        }
+        
+        return lower_bound(first+1, (step < last-first)? first+step+1: last, p);
+    };
+    
+    // Number of positions in [from, to)
+    inline size_t count(const RecordId *from, const RecordId *to) const
+    {
+        Iterator iter = this->lowerBound(from), iterR = this->lowerBoundRecent(from);
+        
+        return (gallop(iter, this->slots.end(), to)-iter)+(gallop(iterR, this->recent.end(), to)-iterR);
+    };
+    
+    void clear()
+    {
+        this->bits.clear();
+        this->slots.clear();
+        this->recent.clear();
+        this->sample.clear();
+        this->numErased = 0;
+    };
+};
+
+
+
+// Wraps the sink of a query to skip the erased records, see
+// HierarchicalIndex::skipErased(). Evaluating a query in parallel, every
+// thread collects all the ids of its slice, which are checked on merging.
+template <class Sink>
+class TombstoneSink
+{
+public:
+    typedef VectorSink Partial;
+    static const bool countsOnly = Sink::countsOnly;
+    
+    const Tombstones &tombstones;
+    const unsigned int kernel;
+    Sink &sink;
+    
+    TombstoneSink(const Tombstones &tombstones, const unsigned int kernel, Sink &sink) : tombstones(tombstones), kernel(kernel), sink(sink)
+    {
+    };
+    
+    inline void add(const RecordId id)
+    {
+        if (!this->tombstones.isErased(id))
+            this->sink.add(id);
+    };
+    
+    template <class Iterator>
+    inline void addRange(Iterator first, Iterator last)
+    {
+        for (Iterator iter = first; iter != last; iter++)
+            this->add(*iter);
+    };
+    
+    inline void merge(const VectorSink &other)
+    {
+        for (const RecordId &id : other.ids)
+            this->add(id);
+    };
+    
+    inline size_t get() const
+    {
+        return this->sink.get();
+    };
+};
+
+
+// Reports the ids in [first, last), a range of the arrays of the index all
+// of which qualify, except for the erased ones
+template <class Iterator, class Sink>
+inline void reportIds(const unsigned int kernel, Iterator first, Iterator last, TombstoneSink<Sink> &result)
+{
+    if (first == last)
+        return;
+    
+    const Tombstones &tombstones = result.tombstones;
+    const RecordId *from = &(*first), *to = from+(last-first);
+    Tombstones::Iterator iter = tombstones.lowerBound(from), iterR = tombstones.lowerBoundRecent(from);
+    
+    while (true)
+    {
+        const RecordId *next = to;
+        
+        if ((iter != tombstones.slots.end()) && (*iter < next))
+            next = *iter;
+        if ((iterR != tombstones.recent.end()) && (*iterR < next))
+            next = *iterR;
+        if (next == to)
+            break;
+        
+        reportIds(kernel, from, next, result.sink);
+        from = next+1;
+        if ((iter != tombstones.slots.end()) && (*iter == next))
+            iter++;
+        else
+            iterR++;
+    }
+    reportIds(kernel, from, to, result.sink);
+}
+
+
+template <class Iterator>
+inline void reportIds(const unsigned int kernel, Iterator first, Iterator last, TombstoneSink<CountSink> &result)
+{
+    if (first == last)
+        return;
+    
+    const RecordId *from = &(*first), *to = from+(last-first);
+    
+    reportIds(kernel, first, last, result.sink);
+    result.sink.result -= result.tombstones.count(from, to);
+}
+
+
+template <class Iterator>
+inline void reportIds(const unsigned int kernel, Iterator first, Iterator last, TombstoneSink<XorSink> &result)
+{
+    if (first == last)
+        return;
+    
+    const Tombstones &tombstones = result.tombstones;
+    const RecordId *from = &(*first), *to = from+(last-first);
+    
+    reportIds(kernel, first, last, result.sink);
+    for (auto iter = tombstones.lowerBound(from); (iter != tombstones.slots.end()) && (*iter < to); iter++)
+        result.sink.add(**iter);
+    for (auto iter = tombstones.lowerBoundRecent(from); (iter != tombstones.recent.end()) && (*iter < to); iter++)
+        result.sink.add(**iter);
+}
+#endif // _TOMBSTONES_H_
@@ -33,6 +33,7 @@
 
 #include <cstdio>
 #include <cstdlib>
+#include <cstdint>
 #include <cmath>
 #include <cstring>
 #include <iostream>
@@ -40,6 +41,7 @@
 #include <vector>
 #include <string>
 #include <algorithm>
+#include <numeric>
 #include <fstream>
 #include <chrono>
 #include <unistd.h>
@@ -87,6 +89,16 @@ typedef int PartitionId;
 typedef int RecordId;
 typedef int Timestamp;
 
+// End of an open interval, i.e., one still ongoing; "now" in the text
+// format of the data files
+#define OPEN_END numeric_limits<Timestamp>::max()
+
+// Smallest partition radix sorted by the construction of HINT^m, see
+// containers/radixsort.h; smaller ones are sorted by comparisons
+#ifndef RADIX_SORT_MIN_SIZE
+#define RADIX_SORT_MIN_SIZE 256
+#endif
+
 
 struct RunSettings
 {
@@ -102,6 +114,22 @@ struct RunSettings
 	bool         topDown;
 	unsigned int numRuns;
     	unsigned int typeOptimizations;
+	unsigned int numThreads;
+	unsigned int numQueryThreads;
+	unsigned int numBuildThreads;
+	float        parallelSelectivity;
+	bool         buildAggregates;
+	bool         aggregateQueries;
+	bool         buildSearchLayout;
+	bool         batch;
+	const char   *indexFile;
+	bool         openIndex;
+	float        updateFraction;
+	unsigned int deltaCapacity;
+	float        deleteFraction;
+	float        purgeRatio;
+	unsigned int segmentFanout;
+	bool         rebuild;
 	
 	void init()
 	{
@@ -110,6 +138,22 @@ struct RunSettings
         	numBits           = 0;
 		numRuns           = 1;
         typeOptimizations = 0;
+		numThreads        = 1;
+		numQueryThreads   = 1;
+		numBuildThreads   = 1;
+		parallelSelectivity = 0.01;
+		buildAggregates   = false;
+		aggregateQueries  = false;
+		buildSearchLayout = false;
+		batch             = false;
+		indexFile         = NULL;
+		openIndex         = false;
+		updateFraction    = 0;
+		deltaCapacity     = 0;
+		deleteFraction    = 0;
+		purgeRatio        = -1;
+		segmentFanout     = 0;
+		rebuild           = false;
 	};
 };
 
@@ -186,5 +230,8 @@ string toUpperCase(char *buf);
 bool checkPredicate(string strPredicate, RunSettings &settings);
 bool checkOptimizations(string strOptimizations, RunSettings &settings);
 void process_mem_usage(double& vm_usage, double& resident_set);
+void reset_peak_mem_usage();
+double peak_mem_usage();
 unsigned int determineOptimalNumBitsForHINT_M(const Relation &R, const float qe_precentage);
+void loadQueries(const char *filename, vector<RangeQuery> &queries);
 #endif // _GLOBAL_DEF_H_
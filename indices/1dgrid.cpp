@@ -73,6 +73,7 @@ OneDimensionalGrid::OneDimensionalGrid(const Relation &R, const PartitionId numP
     this->gend                = R.gend;
     this->partitionExtent     = (Timestamp)ceil((double)(this->gend-this->gstart)/this->numPartitions);
     this->numReplicas = 0;
+    this->kernel = getScanKernel();
 
     // Step 1: one pass to count the contents inside each partition.
     this->pRecs_sizes = (size_t*)calloc(this->numPartitions, sizeof(size_t));
@@ -134,86 +135,156 @@ void OneDimensionalGrid::getStats()
 }
 
 
-size_t OneDimensionalGrid::execute_Equals(RangeQuery Q)
+template <class Sink>
+void OneDimensionalGrid::execute_Equals(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
     RelationIterator iterBegin, iterEnd;
     auto s_pId = (Q.start == this->gend)? this->numPartitionsMinus1: Q.start/this->partitionExtent;
     
     // Handle the first partition.
-    return this->pRecs[s_pId].execute_Equals(Q);
+    this->pRecs[s_pId].execute_Equals(Q, result);
 }
 
 
-size_t OneDimensionalGrid::execute_Starts(RangeQuery Q)
+size_t OneDimensionalGrid::execute_Equals(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->execute_Equals(Q, result);
+    
+    return result.get();
+}
+
+
+template <class Sink>
+void OneDimensionalGrid::execute_Starts(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
     RelationIterator iterBegin, iterEnd;
     auto s_pId = (Q.start == this->gend)? this->numPartitionsMinus1: Q.start/this->partitionExtent;
     
     // Handle the first partition.
-    return this->pRecs[s_pId].execute_Starts(Q);
+    this->pRecs[s_pId].execute_Starts(Q, result);
 }
 
 
-size_t OneDimensionalGrid::execute_Started(RangeQuery Q)
+size_t OneDimensionalGrid::execute_Starts(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->execute_Starts(Q, result);
+    
+    return result.get();
+}
+
+
+template <class Sink>
+void OneDimensionalGrid::execute_Started(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
     RelationIterator iterBegin, iterEnd;
     auto s_pId = (Q.start == this->gend)? this->numPartitionsMinus1: Q.start/this->partitionExtent;
     
     // Handle the first partition.
-    return this->pRecs[s_pId].execute_Started(Q);
+    this->pRecs[s_pId].execute_Started(Q, result);
 }
 
 
-size_t OneDimensionalGrid::execute_Finishes(RangeQuery Q)
+size_t OneDimensionalGrid::execute_Started(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->execute_Started(Q, result);
+    
+    return result.get();
+}
+
+
+template <class Sink>
+void OneDimensionalGrid::execute_Finishes(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
     RelationIterator iterBegin, iterEnd;
     auto e_pId = (Q.end == this->gend)? this->numPartitionsMinus1: Q.end/this->partitionExtent;
 
     // Handle the last partition.
-    return this->pRecs[e_pId].execute_Finishes(Q);
+    this->pRecs[e_pId].execute_Finishes(Q, result);
 }
 
 
-size_t OneDimensionalGrid::execute_Finished(RangeQuery Q)
+size_t OneDimensionalGrid::execute_Finishes(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->execute_Finishes(Q, result);
+    
+    return result.get();
+}
+
+
+template <class Sink>
+void OneDimensionalGrid::execute_Finished(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
     RelationIterator iterBegin, iterEnd;
     auto e_pId = (Q.end == this->gend)? this->numPartitionsMinus1: Q.end/this->partitionExtent;
 
     // Handle the last partition.
-    return this->pRecs[e_pId].execute_Finished(Q);
+    this->pRecs[e_pId].execute_Finished(Q, result);
 }
 
 
-size_t OneDimensionalGrid::execute_Meets(RangeQuery Q)
+size_t OneDimensionalGrid::execute_Finished(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->execute_Finished(Q, result);
+    
+    return result.get();
+}
+
+
+template <class Sink>
+void OneDimensionalGrid::execute_Meets(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
     RelationIterator iterBegin, iterEnd;
     auto e_pId = (Q.end == this->gend)? this->numPartitionsMinus1: Q.end/this->partitionExtent;
 
     // Handle the last partition.
-    return this->pRecs[e_pId].execute_Meets(Q);
+    this->pRecs[e_pId].execute_Meets(Q, result);
 }
 
 
-size_t OneDimensionalGrid::execute_Met(RangeQuery Q)
+size_t OneDimensionalGrid::execute_Meets(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->execute_Meets(Q, result);
+    
+    return result.get();
+}
+
+
+template <class Sink>
+void OneDimensionalGrid::execute_Met(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
     RelationIterator iterBegin, iterEnd;
     auto s_pId = (Q.start == this->gend)? this->numPartitionsMinus1: Q.start/this->partitionExtent;
     
     // Handle the first partition.
-    return this->pRecs[s_pId].execute_Met(Q);
+    this->pRecs[s_pId].execute_Met(Q, result);
 }
 
 
-size_t OneDimensionalGrid::execute_Overlaps(RangeQuery Q)
+size_t OneDimensionalGrid::execute_Met(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->execute_Met(Q, result);
+    
+    return result.get();
+}
+
+
+template <class Sink>
+void OneDimensionalGrid::execute_Overlaps(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
     RelationIterator iter, iterBegin, iterEnd;
     auto s_pId = (Q.start == this->gend)? this->numPartitionsMinus1: Q.start/this->partitionExtent;
     auto e_pId = (Q.end   == this->gend)? this->numPartitionsMinus1: Q.end/this->partitionExtent;
@@ -226,11 +297,7 @@ size_t OneDimensionalGrid::execute_Overlaps(RangeQuery Q)
     {
         if ((iter->start < Q.end) && (Q.start < iter->end) && (Q.start < iter->start) && (Q.end < iter->end))
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= iter->id;
-#endif
+            result.add(iter->id);
         }
     }
 
@@ -246,11 +313,7 @@ size_t OneDimensionalGrid::execute_Overlaps(RangeQuery Q)
 //            if (max(Q.start, iter->start) >= p.gstart)
             if ((Q.end < iter->end) && (iter->start >= p.gstart))
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= iter->id;
-#endif
+                result.add(iter->id);
             }
         }
     }
@@ -264,23 +327,26 @@ size_t OneDimensionalGrid::execute_Overlaps(RangeQuery Q)
         {
             if ((iter->start < Q.end) && (Q.end < iter->end) && (iter->start >= this->pRecs[e_pId].gstart))
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= iter->id;
-#endif
+                result.add(iter->id);
             }
         }
     }
+}
 
 
-    return result;
+size_t OneDimensionalGrid::execute_Overlaps(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->execute_Overlaps(Q, result);
+    
+    return result.get();
 }
 
 
-size_t OneDimensionalGrid::execute_Overlapped(RangeQuery Q)
+template <class Sink>
+void OneDimensionalGrid::execute_Overlapped(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
     RelationIterator iter, iterBegin, iterEnd;
     auto s_pId = (Q.start == this->gend)? this->numPartitionsMinus1: Q.start/this->partitionExtent;
     auto e_pId = (Q.end   == this->gend)? this->numPartitionsMinus1: Q.end/this->partitionExtent;
@@ -293,21 +359,25 @@ size_t OneDimensionalGrid::execute_Overlapped(RangeQuery Q)
     {
         if ((Q.start < iter->end) && (Q.start > iter->start) && (Q.end > iter->end))
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= iter->id;
-#endif
+            result.add(iter->id);
         }
     }
+}
+
 
-    return result;
+size_t OneDimensionalGrid::execute_Overlapped(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->execute_Overlapped(Q, result);
+    
+    return result.get();
 }
 
 
-size_t OneDimensionalGrid::execute_Contains(RangeQuery Q)
+template <class Sink>
+void OneDimensionalGrid::execute_Contains(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
     RelationIterator iter, iterBegin, iterEnd;
     auto s_pId = (Q.start == this->gend)? this->numPartitionsMinus1: Q.start/this->partitionExtent;
     auto e_pId = (Q.end   == this->gend)? this->numPartitionsMinus1: Q.end/this->partitionExtent;
@@ -320,11 +390,7 @@ size_t OneDimensionalGrid::execute_Contains(RangeQuery Q)
     {
         if ((iter->start > Q.start) && (Q.end > iter->end))
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= iter->id;
-#endif
+            result.add(iter->id);
         }
     }
 
@@ -340,11 +406,7 @@ size_t OneDimensionalGrid::execute_Contains(RangeQuery Q)
 //            if (max(Q.start, iter->start) >= p.gstart)
             if ((iter->start >= p.gstart && iter->end < Q.end))
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result^= iter->id;
-#endif
+                result.add(iter->id);
             }
         }
     }
@@ -359,34 +421,47 @@ size_t OneDimensionalGrid::execute_Contains(RangeQuery Q)
 //            if ((max(Q.start, iter->start) >= this->pRecs[e_pId].gstart) && (iter->start <= Q.end && Q.start <= iter->end))
             if ((iter->start >= this->pRecs[e_pId].gstart) && (iter->start > Q.start) && (Q.end > iter->end))
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= iter->id;
-#endif
+                result.add(iter->id);
             }
         }
     }
+}
 
-    return result;
 
+size_t OneDimensionalGrid::execute_Contains(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->execute_Contains(Q, result);
+    
+    return result.get();
 }
 
 
-size_t OneDimensionalGrid::execute_Contained(RangeQuery Q)
+template <class Sink>
+void OneDimensionalGrid::execute_Contained(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
     RelationIterator iterBegin, iterEnd;
     auto s_pId = (Q.start == this->gend)? this->numPartitionsMinus1: Q.start/this->partitionExtent;
     
-    return this->pRecs[s_pId].execute_Contained(Q);
+    this->pRecs[s_pId].execute_Contained(Q, result);
+}
+
+
+size_t OneDimensionalGrid::execute_Contained(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->execute_Contained(Q, result);
+    
+    return result.get();
 }
 
 
 
-size_t OneDimensionalGrid::execute_Precedes(RangeQuery Q)
+template <class Sink>
+void OneDimensionalGrid::execute_Precedes(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
     RelationIterator iter, iterBegin, iterEnd;
     auto s_pId = (Q.end == this->gend)? this->numPartitionsMinus1: Q.end/this->partitionExtent;
     auto e_pId = this->numPartitionsMinus1;
@@ -399,11 +474,7 @@ size_t OneDimensionalGrid::execute_Precedes(RangeQuery Q)
     {
         if (iter->start > Q.end)
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= iter->id;
-#endif
+            result.add(iter->id);
         }
     }
 
@@ -416,21 +487,25 @@ size_t OneDimensionalGrid::execute_Precedes(RangeQuery Q)
         {
             if (iter->start >= p.gstart)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= iter->id;
-#endif
+                result.add(iter->id);
             }
         }
     }
+}
 
-    return result;
+
+size_t OneDimensionalGrid::execute_Precedes(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->execute_Precedes(Q, result);
+    
+    return result.get();
 }
 
-size_t OneDimensionalGrid::execute_Preceded(RangeQuery Q)
+template <class Sink>
+void OneDimensionalGrid::execute_Preceded(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
     RelationIterator iter, iterBegin, iterEnd;
     auto s_pId = 0;
     auto e_pId = (Q.start == this->gend)? this->numPartitionsMinus1: Q.start/this->partitionExtent;
@@ -443,11 +518,7 @@ size_t OneDimensionalGrid::execute_Preceded(RangeQuery Q)
     {
         if (iter->end < Q.start)
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= iter->id;
-#endif
+            result.add(iter->id);
         }
     }
 
@@ -461,94 +532,101 @@ size_t OneDimensionalGrid::execute_Preceded(RangeQuery Q)
         {
             if ((iter->start >= p.gstart) && (iter->end <  Q.start))
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= iter->id;
-#endif
+                result.add(iter->id);
             }
         }
     }
+}
 
-    return result;
+
+size_t OneDimensionalGrid::execute_Preceded(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->execute_Preceded(Q, result);
+    
+    return result.get();
 }
 
 
-size_t OneDimensionalGrid::execute_gOverlaps(StabbingQuery Q)
+template <class Sink>
+void OneDimensionalGrid::execute_gOverlaps(StabbingQuery Q, Sink &result)
 {
-    size_t result = 0;
     RelationIterator iterBegin, iterEnd;
     auto pId = (Q.point == this->gend)? this->numPartitionsMinus1: Q.point/this->partitionExtent;
     
     
     // Handle the first partition.
-    return this->pRecs[pId].execute_gOverlaps(Q);
+    this->pRecs[pId].execute_gOverlaps(Q, result);
 }
 
 
-size_t OneDimensionalGrid::execute_gOverlaps(RangeQuery Q)
+size_t OneDimensionalGrid::execute_gOverlaps(StabbingQuery Q)
 {
-    size_t result = 0;
-    RelationIterator iter, iterBegin, iterEnd;
+    WorkloadSink result;
+    
+    this->execute_gOverlaps(Q, result);
+    
+    return result.get();
+}
+
+
+template <class Sink>
+void OneDimensionalGrid::execute_gOverlaps(RangeQuery Q, Sink &result)
+{
+    const Timestamp tmin = numeric_limits<Timestamp>::min(), tmax = numeric_limits<Timestamp>::max();
     auto s_pId = (Q.start == this->gend)? this->numPartitionsMinus1: Q.start/this->partitionExtent;
     auto e_pId = (Q.end   == this->gend)? this->numPartitionsMinus1: Q.end/this->partitionExtent;
     
     
-    // Handle the first partition.
-    iterBegin = this->pRecs[s_pId].begin();
-    iterEnd   = this->pRecs[s_pId].end();
-    for (RelationIterator iter = iterBegin; iter != iterEnd; iter++)
-    {
-        if ((iter->start <= Q.end) && (Q.start <= iter->end))
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= iter->id;
-#endif
-        }
-    }
+    // Handle the first partition: start <= Q.end, Q.start <= end.
+    scanRecords(this->kernel, this->pRecs[s_pId], tmin, Q.end, Q.start, tmax, result);
 
     // Handle partitions completely contained inside the query range.
     for (auto pId = s_pId+1; pId < e_pId; pId++)
     {
         Relation &p = this->pRecs[pId];
-        iterBegin = p.begin();
-        iterEnd = p.end();
-        for (iter = p.begin(); iter != iterEnd; iter++)
-        {
-            // Perform de-duplication test.
-//            if (max(Q.start, iter->start) >= p.gstart)
-            if (iter->start >= p.gstart)
-            {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= iter->id;
-#endif
-            }
-        }
+        
+        // Perform de-duplication test: start >= p.gstart.
+        scanRecords(this->kernel, p, p.gstart, tmax, tmin, tmax, result);
     }
 
     // Handle the last partition.
     if (e_pId != s_pId)
     {
-        iterBegin = this->pRecs[e_pId].begin();
-        iterEnd = this->pRecs[e_pId].end();
-        for (iter = iterBegin; iter != iterEnd; iter++)
-        {
-//            if ((max(Q.start, iter->start) >= this->pRecs[e_pId].gstart) && (iter->start <= Q.end && Q.start <= iter->end))
-            if ((iter->start >= this->pRecs[e_pId].gstart) && (iter->start <= Q.end) && (Q.start <= iter->end))
-            {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= iter->id;
-#endif
-            }
-        }
+        // De-duplication test and start <= Q.end, Q.start <= end.
+        scanRecords(this->kernel, this->pRecs[e_pId], this->pRecs[e_pId].gstart, Q.end, Q.start, tmax, result);
     }
+}
 
 
-    return result;
+size_t OneDimensionalGrid::execute_gOverlaps(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->execute_gOverlaps(Q, result);
+    
+    return result.get();
 }
+
+
+
+// Explicit instantiations for every result sink
+#define INSTANTIATE_ONEDIMENSIONALGRID(Sink) \
+    template void OneDimensionalGrid::execute_Equals(RangeQuery, Sink&); \
+    template void OneDimensionalGrid::execute_Starts(RangeQuery, Sink&); \
+    template void OneDimensionalGrid::execute_Started(RangeQuery, Sink&); \
+    template void OneDimensionalGrid::execute_Finishes(RangeQuery, Sink&); \
+    template void OneDimensionalGrid::execute_Finished(RangeQuery, Sink&); \
+    template void OneDimensionalGrid::execute_Meets(RangeQuery, Sink&); \
+    template void OneDimensionalGrid::execute_Met(RangeQuery, Sink&); \
+    template void OneDimensionalGrid::execute_Overlaps(RangeQuery, Sink&); \
+    template void OneDimensionalGrid::execute_Overlapped(RangeQuery, Sink&); \
+    template void OneDimensionalGrid::execute_Contains(RangeQuery, Sink&); \
+    template void OneDimensionalGrid::execute_Contained(RangeQuery, Sink&); \
+    template void OneDimensionalGrid::execute_Precedes(RangeQuery, Sink&); \
+    template void OneDimensionalGrid::execute_Preceded(RangeQuery, Sink&); \
+    template void OneDimensionalGrid::execute_gOverlaps(StabbingQuery, Sink&); \
+    template void OneDimensionalGrid::execute_gOverlaps(RangeQuery, Sink&);
+
+FOR_EACH_SINK(INSTANTIATE_ONEDIMENSIONALGRID)
@@ -32,6 +32,7 @@
 
 #include "../def_global.h"
 #include "../containers/relation.h"
+#include "../containers/kernels.h"
 
 
 
@@ -44,6 +45,7 @@ private:
     Timestamp gend;
     Timestamp partitionExtent;
     RecordId numIndexedRecords;
+    unsigned int kernel;
 
     Relation *pRecs;
     size_t *pRecs_sizes;
@@ -83,5 +85,22 @@ public:
     // Generalized predicate, ACM SIGMOD'22 gOverlaps
     size_t execute_gOverlaps(StabbingQuery Q);
     size_t execute_gOverlaps(RangeQuery Q);
+
+    // Querying with an explicit result sink, see containers/sinks.h
+    template <class Sink> void execute_Equals(RangeQuery Q, Sink &result);
+    template <class Sink> void execute_Starts(RangeQuery Q, Sink &result);
+    template <class Sink> void execute_Started(RangeQuery Q, Sink &result);
+    template <class Sink> void execute_Finishes(RangeQuery Q, Sink &result);
+    template <class Sink> void execute_Finished(RangeQuery Q, Sink &result);
+    template <class Sink> void execute_Meets(RangeQuery Q, Sink &result);
+    template <class Sink> void execute_Met(RangeQuery Q, Sink &result);
+    template <class Sink> void execute_Overlaps(RangeQuery Q, Sink &result);
+    template <class Sink> void execute_Overlapped(RangeQuery Q, Sink &result);
+    template <class Sink> void execute_Contains(RangeQuery Q, Sink &result);
+    template <class Sink> void execute_Contained(RangeQuery Q, Sink &result);
+    template <class Sink> void execute_Precedes(RangeQuery Q, Sink &result);
+    template <class Sink> void execute_Preceded(RangeQuery Q, Sink &result);
+    template <class Sink> void execute_gOverlaps(StabbingQuery Q, Sink &result);
+    template <class Sink> void execute_gOverlaps(RangeQuery Q, Sink &result);
 };
 #endif // _1D_GRID_H_
@@ -31,10 +31,16 @@
 
 
 
-HierarchicalIndex::HierarchicalIndex(const Relation &R, const unsigned int numBits, const unsigned int maxBits)
+HierarchicalIndex::HierarchicalIndex(const Relation &R, const unsigned int numBits, const unsigned int maxBits) : HierarchicalIndex(R.size(), numBits, maxBits)
+{
+    this->openRecords.build(R.openRecords);
+}
+
+
+HierarchicalIndex::HierarchicalIndex(const size_t numIndexedRecords, const unsigned int numBits, const unsigned int maxBits)
 {
     this->numPartitions      = 0;
-    this->numIndexedRecords  = R.size();
+    this->numIndexedRecords  = numIndexedRecords;
     this->numBits            = numBits;
     this->maxBits            = maxBits;
     this->numEmptyPartitions = 0;
@@ -46,4 +52,149 @@ HierarchicalIndex::HierarchicalIndex(const Relation &R, const unsigned int numBi
     this->numOriginalsAft    = 0;
     this->numReplicasIn      = 0;
     this->numReplicasAft     = 0;
+    this->sizeAggregates     = 0;
+    this->sizeSearchLayout   = 0;
+    this->numMerges          = 0;
+    this->numPurges          = 0;
+    this->pQueryPool         = NULL;
+    this->parallelThreshold  = 0;
+    this->kernel             = getScanKernel();
+}
+
+
+void HierarchicalIndex::setQueryParallelism(const unsigned int numThreads, const float selectivity)
+{
+    delete this->pQueryPool;
+    this->pQueryPool = (numThreads > 1)? new ThreadPool(numThreads): NULL;
+
+    // Below this many results the cost of waking up the threads dominates
+    this->parallelThreshold = max((size_t)ceil(selectivity*this->numIndexedRecords), (size_t)QUERY_PARALLEL_MIN_IDS);
+}
+
+
+// Inserts record r, which must lie in the domain of the index; it is kept in
+// the delta buffer until the buffer fills up, and is then merged in the
+// partitions with the rest of the buffer. An open record only needs its
+// start in the domain, and goes straight to the open intervals.
+void HierarchicalIndex::insert(const Record &r)
+{
+    if (!this->supportsUpdates())
+    {
+        cerr << endl << "Error - insertions are not supported by this index" << endl << endl;
+        exit(1);
+    }
+    
+    if ((r.end == OPEN_END) && (r.start >= 0) && ((r.start >> this->maxBits) == 0))
+    {
+        this->openRecords.insert(r.id, r.start);
+        return;
+    }
+    
+    if ((r.start < 0) || (r.start > r.end) || ((r.end >> this->maxBits) != 0))
+    {
+        cerr << endl << "Error - record [" << r.start << "," << r.end << "] is out of the domain of the index" << endl << endl;
+        exit(1);
+    }
+    
+    this->delta.insert(r);
+    this->numIndexedRecords++;
+    if (this->delta.isFull())
+        this->merge();
+}
+
+
+// Merges the delta buffer in the partitions, e.g., before saving the index;
+// the erased records are purged first, as merging moves the rest around.
+void HierarchicalIndex::merge()
+{
+    this->purge();
+    if (this->delta.empty())
+        return;
+    
+    this->mergeDelta();
+    this->delta.clear();
+    this->numMerges++;
+}
+
+
+// Erases record r, which must be indexed; if it was inserted since the last
+// merge it is dropped from the delta buffer, otherwise it is marked as erased
+// until the erased records exceed the purge ratio of the index, and are then
+// purged from the partitions all together.
+void HierarchicalIndex::erase(const Record &r)
+{
+    vector<const RecordId*> slots;
+    
+    if ((r.end == OPEN_END) && (this->openRecords.erase(r.id, r.start)))
+        return;
+    
+    if (this->delta.erase(r))
+    {
+        this->numIndexedRecords--;
+        return;
+    }
+    
+    if ((r.start < 0) || (r.start > r.end) || ((r.end >> this->maxBits) != 0) || (this->tombstones.isErased(r.id)) || (!this->locate(r, slots)))
+    {
+        cerr << endl << "Error - record " << r.id << " [" << r.start << "," << r.end << "] is not in the index" << endl << endl;
+        exit(1);
+    }
+    
+    this->tombstones.insert(r.id, slots);
+    this->numIndexedRecords--;
+    if (this->tombstones.size() > this->tombstones.purgeRatio*this->numIndexedRecords)
+        this->purge();
+}
+
+
+// Closes open record r, i.e., replaces it by the record ending at end, which
+// is inserted as any other, see insert().
+void HierarchicalIndex::closeRecord(const Record &r, const Timestamp end)
+{
+    if (!this->openRecords.erase(r.id, r.start))
+    {
+        cerr << endl << "Error - record " << r.id << " [" << r.start << ",now] is not open in the index" << endl << endl;
+        exit(1);
+    }
+    
+    this->insert(Record(r.id, r.start, end));
+}
+
+
+// Drops the erased records from the partitions.
+void HierarchicalIndex::purge()
+{
+    if (this->tombstones.empty())
+        return;
+    
+    this->purgeTombstones();
+    this->tombstones.clear();
+    this->numPurges++;
+}
+
+
+HierarchicalIndex::~HierarchicalIndex()
+{
+    delete this->pQueryPool;
+}
+
+
+// Order in which a batch of queries is evaluated: by start, then by end.
+void HierarchicalIndex::getBatchOrder(const vector<RangeQuery> &queries, vector<size_t> &order)
+{
+    order.resize(queries.size());
+    for (auto i = 0; i < queries.size(); i++)
+        order[i] = i;
+    sort(order.begin(), order.end(), [&](size_t i, size_t j)
+    {
+        return (queries[i].start < queries[j].start) || ((queries[i].start == queries[j].start) && (queries[i].end < queries[j].end));
+    });
+}
+
+
+void HierarchicalIndex::executeBottomUp_gOverlaps(const vector<RangeQuery> &queries, vector<size_t> &results)
+{
+    results.resize(queries.size());
+    for (auto i = 0; i < queries.size(); i++)
+        results[i] = this->executeBottomUp_gOverlaps(queries[i]);
 }
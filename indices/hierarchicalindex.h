@@ -32,6 +32,15 @@
 
 #include "../def_global.h"
 #include "../containers/relation.h"
+#include "../containers/candidates.h"
+#include "../containers/threadpool.h"
+#include "../containers/kernels.h"
+#include "../containers/deltabuffer.h"
+#include "../containers/tombstones.h"
+#include "../containers/openintervals.h"
+
+// Minimum number of ids to scan before a query is evaluated in parallel
+#define QUERY_PARALLEL_MIN_IDS 4096
 
 
 
@@ -43,10 +52,54 @@ protected:
     unsigned int numBits;
     unsigned int maxBits;
     unsigned int height;
+    unsigned int kernel;    // Scan kernel set, see containers/kernels.h
+    
+    // Intra-query parallelism, see setQueryParallelism()
+    ThreadPool *pQueryPool;
+    size_t parallelThreshold;
     
     // Construction
     virtual inline void updateCounters(const Record &r) {};
     virtual inline void updatePartitions(const Record &r) {};
+    
+    // Construction from a file, see HINT_M_ALL(const char *filename)
+    HierarchicalIndex(const size_t numIndexedRecords, const unsigned int numBits, const unsigned int maxBits);
+    
+    // Updates, see insert(); the delta buffer is probed by every query of
+    // the indices that support updates, and mergeDelta() folds it in the
+    // partitions; the rest of the indices never probe it, and reject insert()
+    DeltaBuffer delta;
+    virtual bool supportsUpdates() const {return false;};
+    virtual void mergeDelta() {};
+    
+    // Deletions, see erase(); locate() collects the positions of the copies
+    // of a record in the arrays of the index, and purgeTombstones() drops the
+    // erased records from the partitions
+    Tombstones tombstones;
+    virtual bool locate(const Record &, vector<const RecordId*> &) {return false;};
+    virtual void purgeTombstones() {};
+    
+    // Evaluates query on a sink that skips the erased records, if any;
+    // returns false if there are none, and the query is to be evaluated as is
+    template <class Sink, class Query> inline bool skipErased(Sink &result, const Query &query)
+    {
+        if (this->tombstones.empty())
+            return false;
+        
+        TombstoneSink<Sink> filtered(this->tombstones, this->kernel, result);
+        query(filtered);
+        
+        return true;
+    };
+    template <class Sink, class Query> inline bool skipErased(TombstoneSink<Sink> &, const Query &) {return false;};
+    
+    // Open intervals, see OPEN_END; kept out of the partitions, and probed by
+    // every query of the indices that support updates
+    OpenIntervals openRecords;
+    
+    // Querying
+    template <class Sink> inline void scanRanges(const vector<IdRange> &ranges, Sink &result);
+    void getBatchOrder(const vector<RangeQuery> &queries, vector<size_t> &order);
 
 public:
     // Statistics
@@ -55,13 +108,39 @@ public:
     float avgPartitionSize;
     size_t numOriginals, numReplicas;
     size_t numOriginalsIn, numOriginalsAft, numReplicasIn, numReplicasAft;
+    size_t sizeAggregates;
+    size_t sizeSearchLayout;
+    size_t numMerges;
+    size_t numPurges;
 
 
     // Construction
     HierarchicalIndex(const Relation &R, const unsigned int numBits, const unsigned int maxBits);
     virtual void print(const char c) {};
+    virtual void buildAggregates(const Relation &) {};      // Optional, see containers/aggregates.h
+    virtual void buildSearchLayout() {};                     // Optional, see CompactOffsets in containers/offsets.h
     virtual void getStats() {};
-    virtual ~HierarchicalIndex() {};
+    unsigned int getNumBits() const {return this->numBits;};
+    size_t getNumIndexedRecords() const {return this->numIndexedRecords;};
+    virtual ~HierarchicalIndex();
+    
+    // Evaluate queries expected to report at least the given fraction of the
+    // indexed records using numThreads threads; currently used by the
+    // gOverlaps range queries of HINT^m with all optimizations.
+    void setQueryParallelism(const unsigned int numThreads, const float selectivity);
+    
+    // Updates; currently supported by HINT^m with subs+sort+ss+cm and with
+    // all optimizations
+    void insert(const Record &r);
+    void merge();
+    void setDeltaCapacity(const size_t capacity) {this->delta.capacity = capacity;};
+    size_t getDeltaSize() const {return this->delta.size();};
+    void erase(const Record &r);
+    void purge();
+    void setPurgeRatio(const float ratio) {this->tombstones.purgeRatio = ratio;};
+    size_t getNumErased() const {return this->tombstones.size();};
+    void closeRecord(const Record &r, const Timestamp end);
+    size_t getNumOpen() const {return this->openRecords.size();};
     
 
     // Querying
@@ -107,5 +186,68 @@ public:
     virtual size_t executeTopDown_gOverlaps(RangeQuery Q) {return 0;};
     virtual size_t executeBottomUp_gOverlaps(StabbingQuery Q) {return 0;};
     virtual size_t executeBottomUp_gOverlaps(RangeQuery Q) {return 0;};
+    
+    // Evaluate a batch of queries, reporting the result of queries[i] in
+    // results[i]; the variants with the cache misses optimization sort the
+    // batch and share the lookups at the bottom level among the queries,
+    // the rest evaluate the queries one by one.
+    virtual void executeBottomUp_gOverlaps(const vector<RangeQuery> &queries, vector<size_t> &results);
 };
+
+
+
+// Reports every id in the given ranges. If the ranges hold enough ids (the
+// number is known from the partition offsets before touching any id), they are
+// viewed as one concatenated sequence which is split into equal slices, one
+// per thread of the query pool; the partial results are merged in slice order.
+// Otherwise, the head of the next range is prefetched while one is reported,
+// see prefetchIds() in containers/kernels.h.
+template <class Sink>
+inline void HierarchicalIndex::scanRanges(const vector<IdRange> &ranges, Sink &result)
+{
+    size_t numIds = 0;
+
+
+    for (const IdRange &r : ranges)
+        numIds += r.second-r.first;
+
+    // Counting needs no access to the ids, there is nothing to parallelize
+    if ((this->pQueryPool == NULL) || (numIds < this->parallelThreshold) || (Sink::countsOnly))
+    {
+        for (auto i = 0; i < ranges.size(); i++)
+        {
+            if ((i+1 < ranges.size()) && (!Sink::countsOnly))
+                prefetchIds(ranges[i+1].first, ranges[i+1].second);
+            reportIds(this->kernel, ranges[i].first, ranges[i].second, result);
+        }
+    }
+    else
+    {
+        unsigned int numThreads = this->pQueryPool->size();
+        vector<typename Sink::Partial> partials(numThreads);
+
+        this->pQueryPool->run([&](unsigned int t)
+        {
+            typename Sink::Partial &partial = partials[t];
+            size_t from = numIds*t/numThreads, to = numIds*(t+1)/numThreads;
+            size_t pos = 0;
+
+            for (const IdRange &r : ranges)
+            {
+                size_t len = r.second-r.first;
+
+                if (pos+len > from)
+                {
+                    reportIds(this->kernel, r.first + (max(from, pos)-pos), r.first + (min(to, pos+len)-pos), partial);
+                }
+                pos += len;
+                if (pos >= to)
+                    break;
+            }
+        });
+
+        for (auto t = 0; t < numThreads; t++)
+            result.merge(partials[t]);
+    }
+}
 #endif // _HIERARCHICALINDEX_H_
@@ -33,7 +33,8 @@
 
 
 
-inline void HINT::updateCounters(const Record &r)
+// Marks the non-empty partitions of the sparse levels in their directories.
+inline void HINT::markPartitions(const Record &r)
 {
     int level = 0;
     Timestamp a = r.start >> (this->maxBits-this->numBits);
@@ -42,39 +43,65 @@ inline void HINT::updateCounters(const Record &r)
     int firstfound = 0;
     
     
-    while ((level < this->height) && (a <= b))
+    while (level < this->numSparseLevels && a <= b)
     {
         if (a%2)
         { //last bit of a is 1
             if (firstfound)
-            {
-                //printf("added to level %d, bucket %d, class B\n",level,a);
-                this->pReps_sizes[level][a]++;
-            }
+                this->pReps_dir[level].set(a);
             else
             {
-                //printf("added to level %d, bucket %d, class A\n",level,a);
-                this->pOrgs_sizes[level][a]++;
+                this->pOrgs_dir[level].set(a);
                 firstfound = 1;
             }
-            //a+=(int)(pow(2,level));
             a++;
         }
         if (!(b%2))
         { //last bit of b is 0
             prevb = b;
-            //b-=(int)(pow(2,level));
             b--;
-            if ((!firstfound) && b<a)
-            {
-                //printf("added to level %d, bucket %d, class A\n",level,prevb);
-                this->pOrgs_sizes[level][prevb]++;
-            }
+            if ((!firstfound) && b < a)
+                this->pOrgs_dir[level].set(prevb);
+            else
+                this->pReps_dir[level].set(prevb);
+        }
+        a >>= 1; // a = a div 2
+        b >>= 1; // b = b div 2
+        level++;
+    }
+}
+
+
+inline void HINT::updateCounters(const Record &r)
+{
+    int level = 0;
+    Timestamp a = r.start >> (this->maxBits-this->numBits);
+    Timestamp b = r.end   >> (this->maxBits-this->numBits);
+    Timestamp prevb;
+    int firstfound = 0;
+    
+    
+    while (level < this->height && a <= b)
+    {
+        if (a%2)
+        { //last bit of a is 1
+            if (firstfound)
+                this->pReps_sizes[level][this->getCounter(this->pReps_dir, level, a)]++;
             else
             {
-                //printf("added to level %d, bucket %d, class B\n",level,prevb);
-                this->pReps_sizes[level][prevb]++;
+                this->pOrgs_sizes[level][this->getCounter(this->pOrgs_dir, level, a)]++;
+                firstfound = 1;
             }
+            a++;
+        }
+        if (!(b%2))
+        { //last bit of b is 0
+            prevb = b;
+            b--;
+            if ((!firstfound) && b < a)
+                this->pOrgs_sizes[level][this->getCounter(this->pOrgs_dir, level, prevb)]++;
+            else
+                this->pReps_sizes[level][this->getCounter(this->pReps_dir, level, prevb)]++;
         }
         a >>= 1; // a = a div 2
         b >>= 1; // b = b div 2
@@ -97,34 +124,22 @@ inline void HINT::updatePartitions(const Record &r)
         if (a%2)
         { //last bit of a is 1
             if (firstfound)
-            {
-                this->pReps[level][a][this->pReps_sizes[level][a]] = r.id;
-                this->pReps_sizes[level][a]++;
-            }
+                this->pReps[level][this->pReps_sizes[level][this->getCounter(this->pReps_dir, level, a)]++] = r.id;
             else
             {
-                this->pOrgs[level][a][this->pOrgs_sizes[level][a]] = r.id;
-                this->pOrgs_sizes[level][a]++;
+                this->pOrgs[level][this->pOrgs_sizes[level][this->getCounter(this->pOrgs_dir, level, a)]++] = r.id;
                 firstfound = 1;
             }
-            //a+=(int)(pow(2,level));
             a++;
         }
         if (!(b%2))
         { //last bit of b is 0
             prevb = b;
             b--;
-            //b-=(int)(pow(2,level));
             if ((!firstfound) && b < a)
-            {
-                this->pOrgs[level][prevb][this->pOrgs_sizes[level][prevb]] = r.id;
-                this->pOrgs_sizes[level][prevb]++;
-            }
+                this->pOrgs[level][this->pOrgs_sizes[level][this->getCounter(this->pOrgs_dir, level, prevb)]++] = r.id;
             else
-            {
-                this->pReps[level][prevb][this->pReps_sizes[level][prevb]] = r.id;
-                this->pReps_sizes[level][prevb]++;
-            }
+                this->pReps[level][this->pReps_sizes[level][this->getCounter(this->pReps_dir, level, prevb)]++] = r.id;
         }
         a >>= 1; // a = a div 2
         b >>= 1; // b = b div 2
@@ -135,72 +150,142 @@ inline void HINT::updatePartitions(const Record &r)
 
 HINT::HINT(const Relation &R, const unsigned int numBits) : HierarchicalIndex(R, numBits, numBits)
 {
-    // Step 1: one pass to count the contents inside each partition.
+    // Step 1: count the contents inside each partition. Levels with more
+    // partitions than records (sparse levels) only get a counter for every
+    // non-empty partition, found by a first pass and addressed by its rank in
+    // the directory of the level; the rest get a counter for every partition.
+    this->numSparseLevels = 0;
+    while ((this->numSparseLevels < this->height) && ((((size_t)1) << (this->numBits-this->numSparseLevels)) > this->numIndexedRecords))
+        this->numSparseLevels++;
+    
+    this->pOrgs_dir = new RankBitvector[this->height];
+    this->pReps_dir = new RankBitvector[this->height];
+    for (auto l = 0; l < this->numSparseLevels; l++)
+    {
+        this->pOrgs_dir[l].init(((size_t)1) << (this->numBits-l));
+        this->pReps_dir[l].init(((size_t)1) << (this->numBits-l));
+    }
+    if (this->numSparseLevels > 0)
+    {
+        for (const Record &r : R)
+            this->markPartitions(r);
+    }
+    
     this->pOrgs_sizes = (RecordId **)malloc(this->height*sizeof(RecordId *));
     this->pReps_sizes = (size_t **)malloc(this->height*sizeof(size_t *));
-
     for (auto l = 0; l < this->height; l++)
     {
-        auto cnt = (int)(pow(2, this->numBits-l));
+        size_t cntO = ((size_t)1) << (this->numBits-l), cntR = cntO;
+        
+        if (l < this->numSparseLevels)
+        {
+            this->pOrgs_dir[l].buildRank();
+            this->pReps_dir[l].buildRank();
+            cntO = this->pOrgs_dir[l].getNumSetBits();
+            cntR = this->pReps_dir[l].getNumSetBits();
+        }
         
         //calloc allocates memory and sets each counter to 0
-        this->pOrgs_sizes[l] = (RecordId *)calloc(cnt, sizeof(RecordId));
-        this->pReps_sizes[l] = (size_t *)calloc(cnt, sizeof(size_t));
+        this->pOrgs_sizes[l] = (RecordId *)calloc(cntO, sizeof(RecordId));
+        this->pReps_sizes[l] = (size_t *)calloc(cntR, sizeof(size_t));
     }
     
     for (const Record &r : R)
         this->updateCounters(r);
-
-    // Step 2: allocate necessary memory.
-    this->pOrgs = new RelationId*[this->height];
-    this->pReps = new RelationId*[this->height];
+    
+    
+    // Step 2: allocate necessary memory and build the directories of the rest
+    // of the levels; the counters become the positions to write the ids of
+    // every partition at.
+    this->pOrgs = new RelationId[this->height];
+    this->pReps = new RelationId[this->height];
+    this->pOrgs_offsets = (RecordId **)malloc(this->height*sizeof(RecordId *));
+    this->pReps_offsets = (size_t **)malloc(this->height*sizeof(size_t *));
     for (auto l = 0; l < this->height; l++)
     {
-        auto cnt = (int)(pow(2, this->numBits-l));
-
-        this->pOrgs[l] = new RelationId[cnt];
-        this->pReps[l] = new RelationId[cnt];
-
-        for (auto j = 0; j < cnt; j++)
+        size_t cntO = ((size_t)1) << (this->numBits-l), cntR = cntO;
+        size_t sumO = 0, sumR = 0, kO = 0, kR = 0;
+        
+        if (l < this->numSparseLevels)
         {
-            this->pOrgs[l][j].resize(this->pOrgs_sizes[l][j]);
-            this->pReps[l][j].resize(this->pReps_sizes[l][j]);
+            cntO = this->pOrgs_dir[l].getNumSetBits();
+            cntR = this->pReps_dir[l].getNumSetBits();
         }
+        else
+        {
+            this->pOrgs_dir[l].init(cntO);
+            this->pReps_dir[l].init(cntR);
+            for (size_t j = 0; j < cntO; j++)
+            {
+                if (this->pOrgs_sizes[l][j] > 0)
+                    this->pOrgs_dir[l].set(j);
+                if (this->pReps_sizes[l][j] > 0)
+                    this->pReps_dir[l].set(j);
+            }
+            this->pOrgs_dir[l].buildRank();
+            this->pReps_dir[l].buildRank();
+        }
+        
+        this->pOrgs_offsets[l] = (RecordId *)malloc((this->pOrgs_dir[l].getNumSetBits()+1)*sizeof(RecordId));
+        this->pReps_offsets[l] = (size_t *)malloc((this->pReps_dir[l].getNumSetBits()+1)*sizeof(size_t));
+        for (size_t j = 0; j < cntO; j++)
+        {
+            auto size = this->pOrgs_sizes[l][j];
+            
+            if (size > 0)
+                this->pOrgs_offsets[l][kO++] = sumO;
+            this->pOrgs_sizes[l][j] = sumO;
+            sumO += size;
+        }
+        for (size_t j = 0; j < cntR; j++)
+        {
+            auto size = this->pReps_sizes[l][j];
+            
+            if (size > 0)
+                this->pReps_offsets[l][kR++] = sumR;
+            this->pReps_sizes[l][j] = sumR;
+            sumR += size;
+        }
+        this->pOrgs_offsets[l][kO] = sumO;
+        this->pReps_offsets[l][kR] = sumR;
+        
+        this->pOrgs[l].resize(sumO);
+        this->pReps[l].resize(sumR);
     }
-    for (auto l = 0; l < this->height; l++)
-    {
-        auto cnt = (int)(pow(2, this->numBits-l));
-
-        memset(this->pOrgs_sizes[l], 0, cnt*sizeof(RecordId));
-        memset(this->pReps_sizes[l], 0, cnt*sizeof(size_t));
-    }
-
+    
+    
     // Step 3: fill partitions.
     for (const Record &r : R)
         this->updatePartitions(r);
-	
-
+    
+    
+    // Step 4: swap the directories of the levels with few non-empty
+    // partitions for sparse ones, whichever takes less space.
+    this->pOrgs_sdir = new SparseRankBitvector[this->height];
+    this->pReps_sdir = new SparseRankBitvector[this->height];
+    this->numNonEmptyPartitions = 0;
+    for (auto l = 0; l < this->height; l++)
+    {
+        size_t cnt = ((size_t)1) << (this->numBits-l);
+        
+        for (auto w = 0; w < this->pOrgs_dir[l].words.size(); w++)
+            this->numNonEmptyPartitions += popcount64(this->pOrgs_dir[l].words[w] | this->pReps_dir[l].words[w]);
+        if (SparseRankBitvector::getSize(cnt, this->pOrgs_dir[l].getNumSetBits()) < RankBitvector::getSize(cnt))
+        {
+            this->pOrgs_sdir[l].build(this->pOrgs_dir[l]);
+            this->pOrgs_dir[l].clear();
+        }
+        if (SparseRankBitvector::getSize(cnt, this->pReps_dir[l].getNumSetBits()) < RankBitvector::getSize(cnt))
+        {
+            this->pReps_sdir[l].build(this->pReps_dir[l]);
+            this->pReps_dir[l].clear();
+        }
+    }
+    
+    
     // Free auxiliary memory.
     for (auto l = 0; l < this->height; l++)
     {
-//        auto cnt = (int)(pow(2, this->numBits-l));
-//        auto countR = 0, countO = 0, sumO = 0, sumR = 0;
-//        for (int i = 0; i < cnt; i++)
-//        {
-//            if (this->pOrgs_sizes[l][i] > 0)
-//            {
-//                countO++;
-//                sumO += this->pOrgs_sizes[l][i];
-//            }
-//        }
-//        for (int i = 0; i < cnt; i++)
-//        {
-//            if (this->pReps_sizes[l][i] > 0)
-//            {
-//                countR++;
-//                sumR += this->pReps_sizes[l][i];
-//            }
-//        }
         free(this->pOrgs_sizes[l]);
         free(this->pReps_sizes[l]);
     }
@@ -213,18 +298,14 @@ void HINT::print(char c)
 {
     for (auto l = 0; l < this->height; l++)
     {
-        auto cnt = pow(2, this->numBits-l);
+        size_t cnt = ((size_t)1) << (this->numBits-l);
         
-        printf("Level %d: %d partitions\n", l, cnt);
-        for (auto j = 0; j < cnt; j++)
+        printf("Level %d: %zu partitions\n", l, cnt);
+        for (size_t j = 0; j < cnt; j++)
         {
-            printf("Orgs %d (%d): ", j, this->pOrgs[l][j].size());
-//            for (auto k = 0; k < this->bucketcountersA[i][j]; k++)
-//                printf("%d ", this->pOrgs[i][j][k].id);
+            printf("Orgs %zu (%zu): ", j, (size_t)(this->getOrgsEnd(l, j)-this->getOrgsBegin(l, j)));
             printf("\n");
-            printf("Reps %d (%d): ", j, this->pReps[l][j].size());
-//            for (auto k = 0; k < this->bucketcountersB[i][j]; k++)
-//                printf("%d ", this->pReps[i][j][k].id);
+            printf("Reps %zu (%zu): ", j, (size_t)(this->getRepsEnd(l, j)-this->getRepsBegin(l, j)));
             printf("\n\n");
         }
     }
@@ -235,18 +316,14 @@ void HINT::getStats()
 {
     for (auto l = 0; l < this->height; l++)
     {
-        auto cnt = pow(2, this->numBits-l);
-        size_t yo = this->numEmptyPartitions;
-
+        size_t cnt = ((size_t)1) << (this->numBits-l);
+        
         this->numPartitions += cnt;
-        for (int j = 0; j < cnt; j++)
-        {
-            this->numOriginals += this->pOrgs[l][j].size();
-            this->numReplicas += this->pReps[l][j].size();
-            if ((this->pOrgs[l][j].empty()) && (this->pReps[l][j].empty()))
-                this->numEmptyPartitions++;
-        }
+        this->numOriginals += this->pOrgs[l].size();
+        this->numReplicas += this->pReps[l].size();
+        this->numEmptyPartitions += cnt;
     }
+    this->numEmptyPartitions -= this->numNonEmptyPartitions;
 
     this->avgPartitionSize = (float)(this->numIndexedRecords+this->numReplicas)/(this->numPartitions-numEmptyPartitions);
 }
@@ -256,17 +333,23 @@ HINT::~HINT()
 {
     for (auto l = 0; l < this->height; l++)
     {
-        delete[] this->pOrgs[l];
-        delete[] this->pReps[l];
+        free(this->pOrgs_offsets[l]);
+        free(this->pReps_offsets[l]);
     }
+    free(this->pOrgs_offsets);
+    free(this->pReps_offsets);
+    delete[] this->pOrgs_dir;
+    delete[] this->pReps_dir;
+    delete[] this->pOrgs_sdir;
+    delete[] this->pReps_sdir;
     delete[] this->pOrgs;
     delete[] this->pReps;
 }
 
 
-size_t HINT::execute_gOverlaps(StabbingQuery Q)
+template <class Sink>
+void HINT::execute_gOverlaps(StabbingQuery Q, Sink &result)
 {
-    size_t result = 0;
     RelationIdIterator iter, iterBegin, iterEnd;
     Timestamp a = Q.point;
 
@@ -275,51 +358,47 @@ size_t HINT::execute_gOverlaps(StabbingQuery Q)
     for (auto l = 0; l < this->numBits; l++)
     {
         // Handle the partition that contains a.
-        iterBegin = this->pOrgs[l][a].begin();
-        iterEnd = this->pOrgs[l][a].end();
+        iterBegin = this->getOrgsBegin(l, a);
+        iterEnd = this->getOrgsEnd(l, a);
         for (iter = iterBegin; iter != iterEnd; iter++)
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iter);
-#endif
+            result.add(*iter);
         }
         
-        iterBegin = this->pReps[l][a].begin();
-        iterEnd = this->pReps[l][a].end();
+        iterBegin = this->getRepsBegin(l, a);
+        iterEnd = this->getRepsEnd(l, a);
         for (iter = iterBegin; iter != iterEnd; iter++)
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iter);
-#endif
+            result.add(*iter);
         }
 
         a >>= 1; // a = a div 2
     }
     
     // Handle root.
-    iterBegin = this->pOrgs[this->numBits][0].begin();
-    iterEnd = this->pOrgs[this->numBits][0].end();
+    iterBegin = this->pOrgs[this->numBits].begin();
+    iterEnd = this->pOrgs[this->numBits].end();
     for (iter = iterBegin; iter != iterEnd; iter++)
     {
-#ifdef WORKLOAD_COUNT
-        result++;
-#else
-        result ^= (*iter);
-#endif
+        result.add(*iter);
     }
     
+}
 
-    return result;
+
+size_t HINT::execute_gOverlaps(StabbingQuery Q)
+{
+    WorkloadSink result;
+    
+    this->execute_gOverlaps(Q, result);
+    
+    return result.get();
 }
 
 
-size_t HINT::execute_gOverlaps(RangeQuery Q)
+template <class Sink>
+void HINT::execute_gOverlaps(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
     RelationIdIterator iter, iterBegin, iterEnd;
     Timestamp a = Q.start;
     Timestamp b = Q.end;
@@ -328,54 +407,48 @@ size_t HINT::execute_gOverlaps(RangeQuery Q)
     for (auto l = 0; l < this->numBits; l++)
     {
         // Handle the partition that contains a - only reps here.
-        iterBegin = this->pReps[l][a].begin();
-        iterEnd = this->pReps[l][a].end();
+        iterBegin = this->getRepsBegin(l, a);
+        iterEnd = this->getRepsEnd(l, a);
         for (iter = iterBegin; iter != iterEnd; iter++)
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iter);
-#endif
+            result.add(*iter);
         }
         
-        // Handle the all relevant partitions.
-        for (auto j = a; j <= b; j++)
+        // Handle the all relevant partitions, stored contiguously.
+        iterBegin = this->getOrgsBegin(l, a);
+        iterEnd = this->getOrgsEnd(l, b);
+        for (iter = iterBegin; iter != iterEnd; iter++)
         {
-            iterBegin = this->pOrgs[l][j].begin();
-            iterEnd = this->pOrgs[l][j].end();
-            for (iter = iterBegin; iter != iterEnd; iter++)
-            {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iter);
-#endif
-            }
+            result.add(*iter);
         }
         a >>= 1; // a = a div 2
         b >>= 1; // b = b div 2
     }
     
     // Handle root.
-    iterBegin = this->pOrgs[this->numBits][0].begin();
-    iterEnd = this->pOrgs[this->numBits][0].end();
+    iterBegin = this->pOrgs[this->numBits].begin();
+    iterEnd = this->pOrgs[this->numBits].end();
     for (iter = iterBegin; iter != iterEnd; iter++)
     {
-#ifdef WORKLOAD_COUNT
-        result++;
-#else
-        result ^= (*iter);
-#endif
+        result.add(*iter);
     }
     
+}
+
+
+size_t HINT::execute_gOverlaps(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->execute_gOverlaps(Q, result);
     
-    return result;
+    return result.get();
 }
 
 
 
-inline void HINT_SS::updateCounters(const Record &r)
+// Marks the non-empty partitions of the sparse levels in their directories.
+inline void HINT_SS::markPartitions(const Record &r)
 {
     int level = 0;
     Timestamp a = r.start >> (this->maxBits-this->numBits);
@@ -384,39 +457,65 @@ inline void HINT_SS::updateCounters(const Record &r)
     int firstfound = 0;
     
     
-    while (level < this->height && a <= b)
+    while (level < this->numSparseLevels && a <= b)
     {
         if (a%2)
         { //last bit of a is 1
             if (firstfound)
-            {
-                //printf("added to level %d, bucket %d, class B\n",level,a);
-                this->pReps_sizes[level][a]++;
-            }
+                this->pReps_dir[level].set(a);
             else
             {
-                //printf("added to level %d, bucket %d, class A\n",level,a);
-                this->pOrgs_sizes[level][a]++;
+                this->pOrgs_dir[level].set(a);
                 firstfound = 1;
             }
-            //a+=(int)(pow(2,level));
             a++;
         }
         if (!(b%2))
         { //last bit of b is 0
             prevb = b;
-            //b-=(int)(pow(2,level));
             b--;
-            if ((!firstfound) && b<a)
-            {
-                //printf("added to level %d, bucket %d, class A\n",level,prevb);
-                this->pOrgs_sizes[level][prevb]++;
-            }
+            if ((!firstfound) && b < a)
+                this->pOrgs_dir[level].set(prevb);
+            else
+                this->pReps_dir[level].set(prevb);
+        }
+        a >>= 1; // a = a div 2
+        b >>= 1; // b = b div 2
+        level++;
+    }
+}
+
+
+inline void HINT_SS::updateCounters(const Record &r)
+{
+    int level = 0;
+    Timestamp a = r.start >> (this->maxBits-this->numBits);
+    Timestamp b = r.end   >> (this->maxBits-this->numBits);
+    Timestamp prevb;
+    int firstfound = 0;
+    
+    
+    while (level < this->height && a <= b)
+    {
+        if (a%2)
+        { //last bit of a is 1
+            if (firstfound)
+                this->pReps_sizes[level][this->getCounter(this->pReps_dir, level, a)]++;
             else
             {
-                //printf("added to level %d, bucket %d, class B\n",level,prevb);
-                this->pReps_sizes[level][prevb]++;
+                this->pOrgs_sizes[level][this->getCounter(this->pOrgs_dir, level, a)]++;
+                firstfound = 1;
             }
+            a++;
+        }
+        if (!(b%2))
+        { //last bit of b is 0
+            prevb = b;
+            b--;
+            if ((!firstfound) && b < a)
+                this->pOrgs_sizes[level][this->getCounter(this->pOrgs_dir, level, prevb)]++;
+            else
+                this->pReps_sizes[level][this->getCounter(this->pReps_dir, level, prevb)]++;
         }
         a >>= 1; // a = a div 2
         b >>= 1; // b = b div 2
@@ -430,8 +529,8 @@ inline void HINT_SS::updatePartitions(const Record &r)
     int level = 0;
     Timestamp a = r.start >> (this->maxBits-this->numBits);
     Timestamp b = r.end   >> (this->maxBits-this->numBits);
-    int firstfound = 0;
     Timestamp prevb;
+    int firstfound = 0;
     
     
     while (level < this->height && a <= b)
@@ -439,24 +538,22 @@ inline void HINT_SS::updatePartitions(const Record &r)
         if (a%2)
         { //last bit of a is 1
             if (firstfound)
-                this->pReps[level][this->pReps_offsets[level][a]++] = r.id;
+                this->pReps[level][this->pReps_sizes[level][this->getCounter(this->pReps_dir, level, a)]++] = r.id;
             else
             {
-                this->pOrgs[level][this->pOrgs_offsets[level][a]++] = r.id;
+                this->pOrgs[level][this->pOrgs_sizes[level][this->getCounter(this->pOrgs_dir, level, a)]++] = r.id;
                 firstfound = 1;
             }
-            //a+=(int)(pow(2,level));
             a++;
         }
         if (!(b%2))
         { //last bit of b is 0
             prevb = b;
             b--;
-            //b-=(int)(pow(2,level));
             if ((!firstfound) && b < a)
-                this->pOrgs[level][this->pOrgs_offsets[level][prevb]++] = r.id;
+                this->pOrgs[level][this->pOrgs_sizes[level][this->getCounter(this->pOrgs_dir, level, prevb)]++] = r.id;
             else
-                this->pReps[level][this->pReps_offsets[level][prevb]++] = r.id;
+                this->pReps[level][this->pReps_sizes[level][this->getCounter(this->pReps_dir, level, prevb)]++] = r.id;
         }
         a >>= 1; // a = a div 2
         b >>= 1; // b = b div 2
@@ -467,51 +564,109 @@ inline void HINT_SS::updatePartitions(const Record &r)
 
 HINT_SS::HINT_SS(const Relation &R, const unsigned int numBits) : HierarchicalIndex(R, numBits, numBits)
 {
-//    tuple<Timestamp, RelationIdIterator, PartitionId> dummy;
-//    vector<tuple<Timestamp, RelationIdIterator, PartitionId> >::iterator iterIO, iterIOStart, iterIOEnd;
     OffsetEntry_SS_HINT dummy;
     Offsets_SS_HINT_Iterator iterIO, iterIOStart, iterIOEnd;
     PartitionId tmp = -1;
     
 
-    // Step 1: one pass to count the contents inside each partition.
-    this->pOrgs_sizes   = (RecordId **)malloc(this->height*sizeof(RecordId *));
-    this->pReps_sizes   = (size_t **)malloc(this->height*sizeof(size_t *));
-    this->pOrgs_offsets = (RecordId **)malloc(this->height*sizeof(RecordId *));
-    this->pReps_offsets = (size_t **)malloc(this->height*sizeof(size_t *));
+    // Step 1: count the contents inside each partition. Levels with more
+    // partitions than records (sparse levels) only get a counter for every
+    // non-empty partition, found by a first pass and addressed by its rank in
+    // the directory of the level; the rest get a counter for every partition.
+    this->numSparseLevels = 0;
+    while ((this->numSparseLevels < this->height) && ((((size_t)1) << (this->numBits-this->numSparseLevels)) > this->numIndexedRecords))
+        this->numSparseLevels++;
     
+    this->pOrgs_dir = new RankBitvector[this->height];
+    this->pReps_dir = new RankBitvector[this->height];
+    for (auto l = 0; l < this->numSparseLevels; l++)
+    {
+        this->pOrgs_dir[l].init(((size_t)1) << (this->numBits-l));
+        this->pReps_dir[l].init(((size_t)1) << (this->numBits-l));
+    }
+    if (this->numSparseLevels > 0)
+    {
+        for (const Record &r : R)
+            this->markPartitions(r);
+    }
+    
+    this->pOrgs_sizes = (RecordId **)malloc(this->height*sizeof(RecordId *));
+    this->pReps_sizes = (size_t **)malloc(this->height*sizeof(size_t *));
     for (auto l = 0; l < this->height; l++)
     {
-        auto cnt = (int)(pow(2, this->numBits-l));
+        size_t cntO = ((size_t)1) << (this->numBits-l), cntR = cntO;
+        
+        if (l < this->numSparseLevels)
+        {
+            this->pOrgs_dir[l].buildRank();
+            this->pReps_dir[l].buildRank();
+            cntO = this->pOrgs_dir[l].getNumSetBits();
+            cntR = this->pReps_dir[l].getNumSetBits();
+        }
         
         //calloc allocates memory and sets each counter to 0
-        this->pOrgs_sizes[l]   = (RecordId *)calloc(cnt, sizeof(RecordId));
-        this->pReps_sizes[l]   = (size_t *)calloc(cnt, sizeof(size_t));
-        this->pOrgs_offsets[l] = (RecordId *)calloc(cnt+1, sizeof(RecordId));
-        this->pReps_offsets[l] = (size_t *)calloc(cnt+1, sizeof(size_t));
+        this->pOrgs_sizes[l] = (RecordId *)calloc(cntO, sizeof(RecordId));
+        this->pReps_sizes[l] = (size_t *)calloc(cntR, sizeof(size_t));
     }
     
     for (const Record &r : R)
         this->updateCounters(r);
     
     
-    // Step 2: allocate necessary memory.
+    // Step 2: allocate necessary memory and build the directories of the rest
+    // of the levels; the counters become the positions to write the ids of
+    // every partition at.
     this->pOrgs = new RelationId[this->height];
     this->pReps = new RelationId[this->height];
+    this->pOrgs_offsets = (RecordId **)malloc(this->height*sizeof(RecordId *));
+    this->pReps_offsets = (size_t **)malloc(this->height*sizeof(size_t *));
     for (auto l = 0; l < this->height; l++)
     {
-        auto cnt = (int)(pow(2, this->numBits-l));
-        size_t sumO = 0, sumR = 0;
+        size_t cntO = ((size_t)1) << (this->numBits-l), cntR = cntO;
+        size_t sumO = 0, sumR = 0, kO = 0, kR = 0;
+        
+        if (l < this->numSparseLevels)
+        {
+            cntO = this->pOrgs_dir[l].getNumSetBits();
+            cntR = this->pReps_dir[l].getNumSetBits();
+        }
+        else
+        {
+            this->pOrgs_dir[l].init(cntO);
+            this->pReps_dir[l].init(cntR);
+            for (size_t j = 0; j < cntO; j++)
+            {
+                if (this->pOrgs_sizes[l][j] > 0)
+                    this->pOrgs_dir[l].set(j);
+                if (this->pReps_sizes[l][j] > 0)
+                    this->pReps_dir[l].set(j);
+            }
+            this->pOrgs_dir[l].buildRank();
+            this->pReps_dir[l].buildRank();
+        }
         
-        for (auto pId = 0; pId < cnt; pId++)
+        this->pOrgs_offsets[l] = (RecordId *)malloc((this->pOrgs_dir[l].getNumSetBits()+1)*sizeof(RecordId));
+        this->pReps_offsets[l] = (size_t *)malloc((this->pReps_dir[l].getNumSetBits()+1)*sizeof(size_t));
+        for (size_t j = 0; j < cntO; j++)
+        {
+            auto size = this->pOrgs_sizes[l][j];
+            
+            if (size > 0)
+                this->pOrgs_offsets[l][kO++] = sumO;
+            this->pOrgs_sizes[l][j] = sumO;
+            sumO += size;
+        }
+        for (size_t j = 0; j < cntR; j++)
         {
-            this->pOrgs_offsets[l][pId] = sumO;
-            this->pReps_offsets[l][pId] = sumR;
-            sumO += this->pOrgs_sizes[l][pId];
-            sumR += this->pReps_sizes[l][pId];
+            auto size = this->pReps_sizes[l][j];
+            
+            if (size > 0)
+                this->pReps_offsets[l][kR++] = sumR;
+            this->pReps_sizes[l][j] = sumR;
+            sumR += size;
         }
-        this->pOrgs_offsets[l][cnt] = sumO;
-        this->pReps_offsets[l][cnt] = sumR;
+        this->pOrgs_offsets[l][kO] = sumO;
+        this->pReps_offsets[l][kR] = sumR;
         
         this->pOrgs[l].resize(sumO);
         this->pReps[l].resize(sumR);
@@ -523,73 +678,77 @@ HINT_SS::HINT_SS(const Relation &R, const unsigned int numBits) : HierarchicalIn
         this->updatePartitions(r);
     
     
-    // Free auxliary memory.
+    // Free auxiliary memory.
     for (auto l = 0; l < this->height; l++)
     {
-        free(this->pOrgs_offsets[l]);
-        free(this->pReps_offsets[l]);
+        free(this->pOrgs_sizes[l]);
+        free(this->pReps_sizes[l]);
     }
-    free(this->pOrgs_offsets);
-    free(this->pReps_offsets);
+    free(this->pOrgs_sizes);
+    free(this->pReps_sizes);
     
     
-    // Step 4: create offset pointers.
+    // Step 4: create offset pointers for the non-empty partitions.
     this->pOrgs_ioffsets = new Offsets_SS_HINT[this->height];
     this->pReps_ioffsets = new Offsets_SS_HINT[this->height];
     for (int l = this->height-1; l > -1; l--)
     {
-        auto cnt = (int)(pow(2, this->numBits-l));
-        size_t sumO = 0, sumR = 0;
+        auto cntO = this->pOrgs_dir[l].getNumSetBits();
+        auto cntR = this->pReps_dir[l].getNumSetBits();
+        size_t pId = 0;
         
-        for (auto pId = 0; pId < cnt; pId++)
+        this->pOrgs_ioffsets[l].reserve(cntO);
+        for (auto k = 0; k < cntO; k++)
         {
-//            get<0>(dummy) = pId >> 1;   //((pId >> (this->maxBits-this->numBits)) >> 1); ????
+            pId = this->pOrgs_dir[l].nextSetBit(pId);
             dummy.tstamp = pId >> 1;
-            if (this->pOrgs_sizes[l][pId] > 0)
+            tmp = -1;
+            if (l < this->height-1)
             {
-                tmp = -1;
-                if (l < this->height-1)
-                {
-                    iterIOStart = this->pOrgs_ioffsets[l+1].begin();
-                    iterIOEnd = this->pOrgs_ioffsets[l+1].end();
-                    iterIO = lower_bound(iterIOStart, iterIOEnd, dummy);//, Compare2);
-                    tmp = (iterIO != iterIOEnd)? (iterIO-iterIOStart): -1;
-                }
-                
-//                this->pOrgs_ioffsets[l].push_back(tuple<Timestamp, RelationIdIterator, PartitionId>(pId, this->pOrgs[l].begin()+sumO, tmp));
-                this->pOrgs_ioffsets[l].emplace_back(pId, this->pOrgs[l].begin()+sumO, tmp);
+                iterIOStart = this->pOrgs_ioffsets[l+1].begin();
+                iterIOEnd = this->pOrgs_ioffsets[l+1].end();
+                iterIO = iterIOStart+this->pOrgs_ioffsets[l+1].rank(dummy.tstamp);
+                tmp = (iterIO != iterIOEnd)? (iterIO-iterIOStart): -1;
             }
-            if (this->pReps_sizes[l][pId] > 0)
+            this->pOrgs_ioffsets[l].emplace_back(pId, this->pOrgs[l].begin()+this->pOrgs_offsets[l][k], tmp);
+            pId++;
+        }
+        
+        pId = 0;
+        this->pReps_ioffsets[l].reserve(cntR);
+        for (auto k = 0; k < cntR; k++)
+        {
+            pId = this->pReps_dir[l].nextSetBit(pId);
+            dummy.tstamp = pId >> 1;
+            tmp = -1;
+            if (l < this->height-1)
             {
-                tmp = -1;
-                if (l < this->height-1)
-                {
-                    iterIOStart = this->pReps_ioffsets[l+1].begin();
-                    iterIOEnd = this->pReps_ioffsets[l+1].end();
-                    iterIO = lower_bound(iterIOStart, iterIOEnd, dummy);//, Compare2);
-                    tmp = (iterIO != iterIOEnd)? (iterIO-iterIOStart): -1;
-                }
-
-//                this->pReps_ioffsets[l].push_back(tuple<Timestamp, RelationIdIterator, PartitionId>(pId, this->pReps[l].begin()+sumR, tmp));
-                this->pReps_ioffsets[l].emplace_back(pId, this->pReps[l].begin()+sumR, tmp);
+                iterIOStart = this->pReps_ioffsets[l+1].begin();
+                iterIOEnd = this->pReps_ioffsets[l+1].end();
+                iterIO = iterIOStart+this->pReps_ioffsets[l+1].rank(dummy.tstamp);
+                tmp = (iterIO != iterIOEnd)? (iterIO-iterIOStart): -1;
             }
-            
-            sumO += this->pOrgs_sizes[l][pId];
-            sumR += this->pReps_sizes[l][pId];
+            this->pReps_ioffsets[l].emplace_back(pId, this->pReps[l].begin()+this->pReps_offsets[l][k], tmp);
+            pId++;
         }
-//        this->pOrgs_ioffsets[l][cnt] = this->pOrgs[l].end();
-//        this->pReps_ioffsets[l][cnt] = this->pReps[l].end();        
+        
+        // The directories of the level index its offsets from now on, sparse
+        // ones where fewer than a partition in 16 is non-empty.
+        this->pOrgs_ioffsets[l].setDirectory(this->pOrgs_dir[l]);
+        this->pReps_ioffsets[l].setDirectory(this->pReps_dir[l]);
     }
     
     
-    // Free auxliary memory.
+    // Free auxiliary memory.
     for (auto l = 0; l < this->height; l++)
     {
-        free(this->pOrgs_sizes[l]);
-        free(this->pReps_sizes[l]);
+        free(this->pOrgs_offsets[l]);
+        free(this->pReps_offsets[l]);
     }
-    free(this->pOrgs_sizes);
-    free(this->pReps_sizes);
+    free(this->pOrgs_offsets);
+    free(this->pReps_offsets);
+    delete[] this->pOrgs_dir;
+    delete[] this->pReps_dir;
 }
 
 
@@ -625,7 +784,8 @@ HINT_SS::~HINT_SS()
 }
 
 
-inline void HINT_SS::scanPartitions_Orgs_gOverlaps(unsigned int level, Timestamp a, Timestamp b, PartitionId &next_from, PartitionId &next_to, size_t &result)
+template <class Sink>
+inline void HINT_SS::scanPartitions_Orgs_gOverlaps(unsigned int level, Timestamp a, Timestamp b, PartitionId &next_from, PartitionId &next_to, Sink &result)
 {
     RelationIdIterator iter, iterBegin, iterEnd;
     OffsetEntry_SS_HINT qdummyA, qdummyB;
@@ -639,13 +799,13 @@ inline void HINT_SS::scanPartitions_Orgs_gOverlaps(unsigned int level, Timestamp
         to = next_to;
         
         // Adjusting pointers.
-        if ((from == -1) || (to == -1))
+        if ((from == -1) || (from >= cnt) || (to == -1))
         {
 //            get<0>(qdummyA) = a;
             qdummyA.tstamp = a;
             iterIOStart = this->pOrgs_ioffsets[level].begin();
             iterIOEnd = this->pOrgs_ioffsets[level].end();
-            iterIO = lower_bound(iterIOStart, iterIOEnd, qdummyA);//, Compare2);
+            iterIO = iterIOStart+this->pOrgs_ioffsets[level].rank(qdummyA.tstamp);
             if ((iterIO != iterIOEnd) && (iterIO->tstamp <= b))
             {
                 next_from = iterIO->pid;
@@ -653,7 +813,7 @@ inline void HINT_SS::scanPartitions_Orgs_gOverlaps(unsigned int level, Timestamp
                 qdummyB.tstamp = b;
                 iterBegin = iterIO->iter;
                 
-                iterIO2 = upper_bound(iterIO, iterIOEnd, qdummyB);//, Compare2);
+                iterIO2 = iterIOStart+this->pOrgs_ioffsets[level].rank(qdummyB.tstamp+1);
 //                vector<tuple<Timestamp, RelationIdIterator, PartitionId> >::iterator  yo = upper_bound(iterIO, iterIOEnd, qdummyB, Compare2);
 //                iterIO2 = iterIO;
 //                while ((iterIO2 != iterIOEnd) && (get<0>(*iterIO2) <= b))
@@ -662,11 +822,7 @@ inline void HINT_SS::scanPartitions_Orgs_gOverlaps(unsigned int level, Timestamp
                 iterEnd = ((iterIO2 != iterIOEnd) ? iterEnd = iterIO2->iter: pOrgs[level].end());
                 for (iter = iterBegin; iter != iterEnd; iter++)
                 {
-#ifdef WORKLOAD_COUNT
-                    result++;
-#else
-                    result ^= (*iter);
-#endif
+                    result.add(*iter);
                 }
                 
                 if (iterIO2 != iterIOEnd)
@@ -682,28 +838,28 @@ inline void HINT_SS::scanPartitions_Orgs_gOverlaps(unsigned int level, Timestamp
             Timestamp tmp = (this->pOrgs_ioffsets[level][from]).tstamp;
             if (tmp < a)
             {
-                while (((this->pOrgs_ioffsets[level][from]).tstamp < a) && (from < cnt))
+                while ((from < cnt) && ((this->pOrgs_ioffsets[level][from]).tstamp < a))
                     from++;
             }
             else if (tmp > a)
             {
-                while (((this->pOrgs_ioffsets[level][from]).tstamp > a) && (from > -1))
+                while ((from > -1) && ((this->pOrgs_ioffsets[level][from]).tstamp > a))
                     from--;
-                if (((this->pOrgs_ioffsets[level][from]).tstamp != a) || (from == -1))
+                if ((from == -1) || ((this->pOrgs_ioffsets[level][from]).tstamp != a))
                     from++;
             }
             
             tmp = (this->pOrgs_ioffsets[level][to]).tstamp;
             if (tmp > b)
             {
-                while (((this->pOrgs_ioffsets[level][to]).tstamp > b) && (to > -1))
+                while ((to > -1) && ((this->pOrgs_ioffsets[level][to]).tstamp > b))
                     to--;
                 to++;
             }
 //                else if (tmp <= b)
             else if (tmp == b)
             {
-                while (((this->pOrgs_ioffsets[level][to]).tstamp <= b) && (to < cnt))
+                while ((to < cnt) && ((this->pOrgs_ioffsets[level][to]).tstamp <= b))
                     to++;
             }
             
@@ -713,11 +869,7 @@ inline void HINT_SS::scanPartitions_Orgs_gOverlaps(unsigned int level, Timestamp
                 iterEnd   = (to != cnt)? (this->pOrgs_ioffsets[level][to]).iter: this->pOrgs[level].end();
                 for (iter = iterBegin; iter != iterEnd; iter++)
                 {
-#ifdef WORKLOAD_COUNT
-                    result++;
-#else
-                    result ^= (*iter);
-#endif
+                    result.add(*iter);
                 }
                 
                 next_from = (this->pOrgs_ioffsets[level][from]).pid;
@@ -735,7 +887,8 @@ inline void HINT_SS::scanPartitions_Orgs_gOverlaps(unsigned int level, Timestamp
 }
 
 
-inline void HINT_SS::scanPartition_Reps_gOverlaps(unsigned int level, Timestamp t, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_SS::scanPartition_Reps_gOverlaps(unsigned int level, Timestamp t, PartitionId &next_from, Sink &result)
 {
     RelationIdIterator iter, iterBegin, iterEnd;
     OffsetEntry_SS_HINT qdummy;
@@ -746,23 +899,19 @@ inline void HINT_SS::scanPartition_Reps_gOverlaps(unsigned int level, Timestamp
     
     if (cnt > 0)
     {
-        if (from == -1)
+        if ((from == -1) || (from >= cnt))
         {
             qdummy.tstamp = t;
             iterIOStart = this->pReps_ioffsets[level].begin();
             iterIOEnd = this->pReps_ioffsets[level].end();
-            iterIO = lower_bound(iterIOStart, iterIOEnd, qdummy);//, Compare2);
+            iterIO = iterIOStart+this->pReps_ioffsets[level].rank(qdummy.tstamp);
             if ((iterIO != iterIOEnd) && (iterIO->tstamp == t))
             {
                 iterBegin = iterIO->iter;
                 iterEnd = ((iterIO+1 != iterIOEnd) ? (iterIO+1)->iter : this->pReps[level].end());
                 for (iter = iterBegin; iter != iterEnd; iter++)
                 {
-#ifdef WORKLOAD_COUNT
-                    result++;
-#else
-                    result ^= (*iter);
-#endif
+                    result.add(*iter);
                 }
                 
                 next_from = iterIO->pid;
@@ -773,14 +922,14 @@ inline void HINT_SS::scanPartition_Reps_gOverlaps(unsigned int level, Timestamp
             Timestamp tmp = (this->pReps_ioffsets[level][from]).tstamp;
             if (tmp < t)
             {
-                while (((this->pReps_ioffsets[level][from]).tstamp < t) && (from < cnt))
+                while ((from < cnt) && ((this->pReps_ioffsets[level][from]).tstamp < t))
                     from++;
             }
             else if (tmp > t)
             {
-                while (((this->pReps_ioffsets[level][from]).tstamp > t) && (from > -1))
+                while ((from > -1) && ((this->pReps_ioffsets[level][from]).tstamp > t))
                     from--;
-                if (((this->pReps_ioffsets[level][from]).tstamp != t) || (from == -1))
+                if ((from == -1) || ((this->pReps_ioffsets[level][from]).tstamp != t))
                     from++;
             }
             
@@ -790,11 +939,7 @@ inline void HINT_SS::scanPartition_Reps_gOverlaps(unsigned int level, Timestamp
                 iterEnd = ((from+1 != cnt) ? (this->pReps_ioffsets[level][from+1]).iter : this->pReps[level].end());
                 for (iter = iterBegin; iter != iterEnd; iter++)
                 {
-#ifdef WORKLOAD_COUNT
-                    result++;
-#else
-                    result ^= (*iter);
-#endif
+                    result.add(*iter);
                 }
                 
                 next_from = (this->pReps_ioffsets[level][from]).pid;
@@ -808,9 +953,9 @@ inline void HINT_SS::scanPartition_Reps_gOverlaps(unsigned int level, Timestamp
 }
 
 
-size_t HINT_SS::execute_gOverlaps(StabbingQuery Q)
+template <class Sink>
+void HINT_SS::execute_gOverlaps(StabbingQuery Q, Sink &result)
 {
-    size_t result = 0;
     RelationIdIterator iter, iterBegin, iterEnd;
     Timestamp a = Q.point;
     OffsetEntry_SS_HINT qdummyA;
@@ -825,23 +970,19 @@ size_t HINT_SS::execute_gOverlaps(StabbingQuery Q)
         fromR = next_fromR;
         if (cnt > 0)
         {
-            if (fromR == -1)
+            if ((fromR == -1) || (fromR >= cnt))
             {
                 qdummyA.tstamp = a;
                 iterIOStart = this->pReps_ioffsets[l].begin();
                 iterIOEnd = this->pReps_ioffsets[l].end();
-                iterIO = lower_bound(iterIOStart, iterIOEnd, qdummyA);//, Compare2);
+                iterIO = iterIOStart+this->pReps_ioffsets[l].rank(qdummyA.tstamp);
                 if ((iterIO != iterIOEnd) && (iterIO->tstamp == a))
                 {
                     iterBegin = iterIO->iter;
                     iterEnd = ((iterIO+1 != iterIOEnd) ? (iterIO+1)->iter : this->pReps[l].end());
                     for (iter = iterBegin; iter != iterEnd; iter++)
                     {
-#ifdef WORKLOAD_COUNT
-                        result++;
-#else
-                        result ^= (*iter);
-#endif
+                        result.add(*iter);
                     }
                     
                     next_fromR = iterIOStart->pid;
@@ -852,14 +993,14 @@ size_t HINT_SS::execute_gOverlaps(StabbingQuery Q)
                 Timestamp tmp = (this->pReps_ioffsets[l][fromR]).tstamp;
                 if (tmp < a)
                 {
-                    while (((this->pReps_ioffsets[l][fromR]).tstamp < a) && (fromR < cnt))
+                    while ((fromR < cnt) && ((this->pReps_ioffsets[l][fromR]).tstamp < a))
                         fromR++;
                 }
                 else if (tmp > a)
                 {
-                    while (((this->pReps_ioffsets[l][fromR]).tstamp > a) && (fromR > -1))
+                    while ((fromR > -1) && ((this->pReps_ioffsets[l][fromR]).tstamp > a))
                         fromR--;
-                    if (((this->pReps_ioffsets[l][fromR]).tstamp != a) || (fromR == -1))
+                    if ((fromR == -1) || ((this->pReps_ioffsets[l][fromR]).tstamp != a))
                         fromR++;
                 }
                 
@@ -869,11 +1010,7 @@ size_t HINT_SS::execute_gOverlaps(StabbingQuery Q)
                     iterEnd = ((fromR+1 != cnt) ? (this->pReps_ioffsets[l][fromR+1]).iter : this->pReps[l].end());
                     for (iter = iterBegin; iter != iterEnd; iter++)
                     {
-#ifdef WORKLOAD_COUNT
-                        result++;
-#else
-                        result ^= (*iter);
-#endif
+                        result.add(*iter);
                     }
                     
                     next_fromR = (this->pReps_ioffsets[l][fromR]).pid;
@@ -888,23 +1025,19 @@ size_t HINT_SS::execute_gOverlaps(StabbingQuery Q)
         if (cnt > 0)
         {
             // Adjusting pointers.
-            if (fromO == -1)
+            if ((fromO == -1) || (fromO >= cnt))
             {
                 qdummyA.tstamp = a;
                 iterIOStart = this->pOrgs_ioffsets[l].begin();
                 iterIOEnd = this->pOrgs_ioffsets[l].end();
-                iterIO = lower_bound(iterIOStart, iterIOEnd, qdummyA);//, Compare2);
+                iterIO = iterIOStart+this->pOrgs_ioffsets[l].rank(qdummyA.tstamp);
                 if ((iterIO != iterIOEnd) && (iterIO->tstamp == a))
                 {
                     iterBegin = iterIO->iter;
                     iterEnd = ((iterIO+1 != iterIOEnd) ? (iterIO+1)->iter : this->pOrgs[l].end());
                     for (iter = iterBegin; iter != iterEnd; iter++)
                     {
-#ifdef WORKLOAD_COUNT
-                        result++;
-#else
-                        result ^= (*iter);
-#endif
+                        result.add(*iter);
                     }
                     
                     next_fromO = iterIO->pid;
@@ -915,14 +1048,14 @@ size_t HINT_SS::execute_gOverlaps(StabbingQuery Q)
                 Timestamp tmp = (this->pOrgs_ioffsets[l][fromO]).tstamp;
                 if (tmp < a)
                 {
-                    while (((this->pOrgs_ioffsets[l][fromO]).tstamp < a) && (fromO < cnt))
+                    while ((fromO < cnt) && ((this->pOrgs_ioffsets[l][fromO]).tstamp < a))
                         fromO++;
                 }
                 else if (tmp > a)
                 {
-                    while (((this->pOrgs_ioffsets[l][fromO]).tstamp > a) && (fromO > -1))
+                    while ((fromO > -1) && ((this->pOrgs_ioffsets[l][fromO]).tstamp > a))
                         fromO--;
-                    if (((this->pOrgs_ioffsets[l][fromO]).tstamp != a) || (fromO == -1))
+                    if ((fromO == -1) || ((this->pOrgs_ioffsets[l][fromO]).tstamp != a))
                         fromO++;
                 }
                 
@@ -932,11 +1065,7 @@ size_t HINT_SS::execute_gOverlaps(StabbingQuery Q)
                     iterEnd = ((fromO+1 != cnt) ? (this->pOrgs_ioffsets[l][fromO+1]).iter : this->pOrgs[l].end());
                     for (iter = iterBegin; iter != iterEnd; iter++)
                     {
-#ifdef WORKLOAD_COUNT
-                        result++;
-#else
-                        result ^= (*iter);
-#endif
+                        result.add(*iter);
                     }
                     
                     next_fromO = (this->pOrgs_ioffsets[l][fromO]).pid;
@@ -954,20 +1083,24 @@ size_t HINT_SS::execute_gOverlaps(StabbingQuery Q)
     iterEnd = this->pOrgs[this->numBits].end();
     for (iter = iterBegin; iter != iterEnd; iter++)
     {
-#ifdef WORKLOAD_COUNT
-        result++;
-#else
-        result ^= (*iter);
-#endif
+        result.add(*iter);
     }
+}
+
+
+size_t HINT_SS::execute_gOverlaps(StabbingQuery Q)
+{
+    WorkloadSink result;
+    
+    this->execute_gOverlaps(Q, result);
     
-    return result;
+    return result.get();
 }
 
 
-size_t HINT_SS::execute_gOverlaps(RangeQuery Q)
+template <class Sink>
+void HINT_SS::execute_gOverlaps(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
     RelationIdIterator iter, iterBegin, iterEnd;
     Timestamp a = Q.start;
     Timestamp b = Q.end;
@@ -990,13 +1123,28 @@ size_t HINT_SS::execute_gOverlaps(RangeQuery Q)
     iterEnd = this->pOrgs[this->numBits].end();
     for (iter = iterBegin; iter != iterEnd; iter++)
     {
-#ifdef WORKLOAD_COUNT
-        result++;
-#else
-        result ^= (*iter);
-#endif
+        result.add(*iter);
     }
     
+}
+
+
+size_t HINT_SS::execute_gOverlaps(RangeQuery Q)
+{
+    WorkloadSink result;
     
-    return result;
+    this->execute_gOverlaps(Q, result);
+    
+    return result.get();
 }
+
+
+
+// Explicit instantiations for every result sink
+#define INSTANTIATE_HINT(Sink) \
+    template void HINT::execute_gOverlaps(StabbingQuery, Sink&); \
+    template void HINT::execute_gOverlaps(RangeQuery, Sink&); \
+    template void HINT_SS::execute_gOverlaps(StabbingQuery, Sink&); \
+    template void HINT_SS::execute_gOverlaps(RangeQuery, Sink&);
+
+FOR_EACH_SINK(INSTANTIATE_HINT)
@@ -33,6 +33,7 @@
 
 #include "../def_global.h"
 #include "../containers/relation.h"
+#include "../containers/bitvector.h"
 #include "../containers/offsets_templates.cpp"
 #include "../indices/hierarchicalindex.h"
 
@@ -42,13 +43,37 @@
 class HINT : public HierarchicalIndex
 {
 private:
-    RelationId **pOrgs, **pReps;
-    RecordId   **pOrgs_sizes;
-    size_t     **pReps_sizes;
+    // The ids of the non-empty partitions of a level are stored contiguously;
+    // the directory of the level marks these partitions, so partition j, the
+    // k-th non-empty one for k = dir.rank(j), spans [offsets[k], offsets[k+1]).
+    // Every partition takes 1.25 bits in each directory, with the rank index;
+    // where fewer than a partition in 16 is non-empty, the directory is a
+    // SparseRankBitvector instead, of about 20 bits per non-empty partition.
+    RelationId    *pOrgs, *pReps;
+    RankBitvector *pOrgs_dir, *pReps_dir;
+    SparseRankBitvector *pOrgs_sdir, *pReps_sdir;
+    RecordId      **pOrgs_sizes;
+    size_t        **pReps_sizes;
+    RecordId      **pOrgs_offsets;
+    size_t        **pReps_offsets;
+    int           numSparseLevels;
+    size_t        numNonEmptyPartitions;
 
     // Construction
+    // Position of the counter of partition p of a level, see the constructor.
+    inline size_t getCounter(const RankBitvector *dir, const int level, const size_t p) const {return (level < this->numSparseLevels)? dir[level].rank(p): p;};
+    inline void markPartitions(const Record &r);
     inline void updateCounters(const Record &r);
     inline void updatePartitions(const Record &r);
+    
+    // Querying
+    // Auxiliary functions to locate the ids of partitions from..to of a level.
+    inline size_t getOrgsRank(const unsigned int level, const size_t p) const {return (!this->pOrgs_dir[level].empty())? this->pOrgs_dir[level].rank(p): this->pOrgs_sdir[level].rank(p);};
+    inline size_t getRepsRank(const unsigned int level, const size_t p) const {return (!this->pReps_dir[level].empty())? this->pReps_dir[level].rank(p): this->pReps_sdir[level].rank(p);};
+    inline RelationIdIterator getOrgsBegin(const unsigned int level, const size_t from) {return this->pOrgs[level].begin()+this->pOrgs_offsets[level][this->getOrgsRank(level, from)];};
+    inline RelationIdIterator getOrgsEnd(const unsigned int level, const size_t to) {return this->pOrgs[level].begin()+this->pOrgs_offsets[level][this->getOrgsRank(level, to+1)];};
+    inline RelationIdIterator getRepsBegin(const unsigned int level, const size_t from) {return this->pReps[level].begin()+this->pReps_offsets[level][this->getRepsRank(level, from)];};
+    inline RelationIdIterator getRepsEnd(const unsigned int level, const size_t to) {return this->pReps[level].begin()+this->pReps_offsets[level][this->getRepsRank(level, to+1)];};
 
 public:
     // Construction
@@ -60,6 +85,10 @@ public:
     // Querying
     size_t execute_gOverlaps(StabbingQuery Q);
     size_t execute_gOverlaps(RangeQuery Q);
+
+    // Querying with an explicit result sink, see containers/sinks.h
+    template <class Sink> void execute_gOverlaps(StabbingQuery Q, Sink &result);
+    template <class Sink> void execute_gOverlaps(RangeQuery Q, Sink &result);
 };
 
 
@@ -69,20 +98,25 @@ class HINT_SS : public HierarchicalIndex
 {
 private:
     RelationId *pOrgs, *pReps;
+    RankBitvector *pOrgs_dir, *pReps_dir;
     RecordId   **pOrgs_sizes;
     size_t     **pReps_sizes;
     RecordId   **pOrgs_offsets;
     size_t     **pReps_offsets;
     Offsets_SS_HINT *pOrgs_ioffsets, *pReps_ioffsets;
+    int        numSparseLevels;
     
     // Construction
+    // Position of the counter of partition p of a level, see the constructor.
+    inline size_t getCounter(const RankBitvector *dir, const int level, const size_t p) const {return (level < this->numSparseLevels)? dir[level].rank(p): p;};
+    inline void markPartitions(const Record &r);
     inline void updateCounters(const Record &r);
     inline void updatePartitions(const Record &r);
     
     // Querying
     // Auxiliary functions to scan a partition.
-    inline void scanPartitions_Orgs_gOverlaps(unsigned int level, Timestamp a, Timestamp b, PartitionId &next_from, PartitionId &next_to, size_t &result);
-    inline void scanPartition_Reps_gOverlaps(unsigned int level, Timestamp t, PartitionId &next_from, size_t &result);
+    template <class Sink> inline void scanPartitions_Orgs_gOverlaps(unsigned int level, Timestamp a, Timestamp b, PartitionId &next_from, PartitionId &next_to, Sink &result);
+    template <class Sink> inline void scanPartition_Reps_gOverlaps(unsigned int level, Timestamp t, PartitionId &next_from, Sink &result);
     
 public:
     // Construction
@@ -96,5 +130,9 @@ public:
     // Generalized predicates, ACM SIGMOD'22 gOverlaps
     size_t execute_gOverlaps(StabbingQuery Q);
     size_t execute_gOverlaps(RangeQuery Q);
+
+    // Querying with an explicit result sink, see containers/sinks.h
+    template <class Sink> void execute_gOverlaps(StabbingQuery Q, Sink &result);
+    template <class Sink> void execute_gOverlaps(RangeQuery Q, Sink &result);
 };
 #endif // _HINT_H_
@@ -96,14 +96,10 @@ inline void HINT_M::updatePartitions(const Record &r)
         if (a%2)
         { //last bit of a is 1
             if (firstfound)
-            {
-                this->pReps[level][a][this->pReps_sizes[level][a]] = r;
-                this->pReps_sizes[level][a]++;
-            }
+                this->pReps[level][this->pReps_sizes[level][a]++] = r;
             else
             {
-                this->pOrgs[level][a][this->pOrgs_sizes[level][a]] = r;
-                this->pOrgs_sizes[level][a]++;
+                this->pOrgs[level][this->pOrgs_sizes[level][a]++] = r;
                 firstfound = 1;
             }
             //a+=(int)(pow(2,level));
@@ -115,15 +111,9 @@ inline void HINT_M::updatePartitions(const Record &r)
             b--;
             //b-=(int)(pow(2,level));
             if ((!firstfound) && b < a)
-            {
-                this->pOrgs[level][prevb][this->pOrgs_sizes[level][prevb]] = r;
-                this->pOrgs_sizes[level][prevb]++;
-            }
+                this->pOrgs[level][this->pOrgs_sizes[level][prevb]++] = r;
             else
-            {
-                this->pReps[level][prevb][this->pReps_sizes[level][prevb]] = r;
-                this->pReps_sizes[level][prevb]++;
-            }
+                this->pReps[level][this->pReps_sizes[level][prevb]++] = r;
         }
         a >>= 1; // a = a div 2
         b >>= 1; // b = b div 2
@@ -151,28 +141,33 @@ HINT_M::HINT_M(const Relation &R, const unsigned int numBits, const unsigned int
         this->updateCounters(r);
 
     
-    // Step 2: allocate necessary memory.
-    this->pOrgs = new Relation*[this->height];
-    this->pReps = new Relation*[this->height];
+    // Step 2: allocate necessary memory; the sizes become the positions to
+    // write the contents of every partition at.
+    this->pOrgs = new Relation[this->height];
+    this->pReps = new Relation[this->height];
+    this->pOrgs_offsets = (RecordId **)malloc(this->height*sizeof(RecordId *));
+    this->pReps_offsets = (size_t **)malloc(this->height*sizeof(size_t *));
     for (auto l = 0; l < this->height; l++)
     {
         auto cnt = (int)(pow(2, this->numBits-l));
-
-        this->pOrgs[l] = new Relation[cnt];
-        this->pReps[l] = new Relation[cnt];
-
+        size_t sumO = 0, sumR = 0;
+        
+        this->pOrgs_offsets[l] = (RecordId *)malloc((cnt+1)*sizeof(RecordId));
+        this->pReps_offsets[l] = (size_t *)malloc((cnt+1)*sizeof(size_t));
         for (auto j = 0; j < cnt; j++)
         {
-            this->pOrgs[l][j].resize(this->pOrgs_sizes[l][j]);
-            this->pReps[l][j].resize(this->pReps_sizes[l][j]);
+            this->pOrgs_offsets[l][j] = sumO;
+            this->pReps_offsets[l][j] = sumR;
+            sumO += this->pOrgs_sizes[l][j];
+            sumR += this->pReps_sizes[l][j];
         }
-    }
-    for (auto l = 0; l < this->height; l++)
-    {
-        auto cnt = (int)(pow(2, this->numBits-l));
+        this->pOrgs_offsets[l][cnt] = sumO;
+        this->pReps_offsets[l][cnt] = sumR;
         
-        memset(this->pOrgs_sizes[l], 0, cnt*sizeof(RecordId));
-        memset(this->pReps_sizes[l], 0, cnt*sizeof(size_t));
+        this->pOrgs[l].resize(sumO);
+        this->pReps[l].resize(sumR);
+        memcpy(this->pOrgs_sizes[l], this->pOrgs_offsets[l], cnt*sizeof(RecordId));
+        memcpy(this->pReps_sizes[l], this->pReps_offsets[l], cnt*sizeof(size_t));
     }
 
 
@@ -201,11 +196,11 @@ void HINT_M::print(char c)
         printf("Level %d: %d partitions\n", l, cnt);
         for (auto j = 0; j < cnt; j++)
         {
-            printf("Orgs %d (%d): ", j, this->pOrgs[l][j].size());
+            printf("Orgs %d (%d): ", j, this->pOrgs_offsets[l][j+1]-this->pOrgs_offsets[l][j]);
 //            for (auto k = 0; k < this->bucketcountersA[i][j]; k++)
 //                printf("%d ", this->pOrgs[i][j][k].id);
             printf("\n");
-            printf("Reps %d (%d): ", j, this->pReps[l][j].size());
+            printf("Reps %d (%d): ", j, this->pReps_offsets[l][j+1]-this->pReps_offsets[l][j]);
 //            for (auto k = 0; k < this->bucketcountersB[i][j]; k++)
 //                printf("%d ", this->pReps[i][j][k].id);
             printf("\n\n");
@@ -221,11 +216,11 @@ void HINT_M::getStats()
         auto cnt = pow(2, this->numBits-l);
 
         this->numPartitions += cnt;
+        this->numOriginals += this->pOrgs[l].size();
+        this->numReplicas += this->pReps[l].size();
         for (int p = 0; p < cnt; p++)
         {
-            this->numOriginals += this->pOrgs[l][p].size();
-            this->numReplicas += this->pReps[l][p].size();
-            if ((this->pOrgs[l][p].empty()) && (this->pReps[l][p].empty()))
+            if ((this->pOrgs_offsets[l][p] == this->pOrgs_offsets[l][p+1]) && (this->pReps_offsets[l][p] == this->pReps_offsets[l][p+1]))
                 this->numEmptyPartitions++;
         }
     }
@@ -238,19 +233,21 @@ HINT_M::~HINT_M()
 {
     for (auto l = 0; l < this->height; l++)
     {
-        delete[] this->pOrgs[l];
-        delete[] this->pReps[l];
+        free(this->pOrgs_offsets[l]);
+        free(this->pReps_offsets[l]);
     }
+    free(this->pOrgs_offsets);
+    free(this->pReps_offsets);
     delete[] this->pOrgs;
     delete[] this->pReps;
 }
 
 
 // Generalized predicates, ACM SIGMOD'22 gOverlaps
-size_t HINT_M::executeTopDown_gOverlaps(RangeQuery Q)
+template <class Sink>
+void HINT_M::executeTopDown_gOverlaps(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
-    RelationIterator iter, iterBegin, iterEnd;
+    const Timestamp tmin = numeric_limits<Timestamp>::min(), tmax = numeric_limits<Timestamp>::max();
     Timestamp a = Q.start >> (this->maxBits-this->numBits); // prefix
     Timestamp b = Q.end   >> (this->maxBits-this->numBits); // prefix
     
@@ -258,65 +255,17 @@ size_t HINT_M::executeTopDown_gOverlaps(RangeQuery Q)
     for (auto l = 0; l < this->numBits; l++)
     {
         // Handle the partition that contains a: consider both originals and replicas, comparisons needed
-        iterBegin = this->pOrgs[l][a].begin();
-        iterEnd = this->pOrgs[l][a].end();
-        for (iter = iterBegin; iter != iterEnd; iter++)
-        {
-            if ((iter->start <= Q.end) && (Q.start <= iter->end))
-            {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= iter->id;
-#endif
-            }
-        }
+        scanRecords(this->kernel, this->getOrgs(l, a), this->getNumOrgs(l, a, a), tmin, Q.end, Q.start, tmax, result);
         
-        iterBegin = this->pReps[l][a].begin();
-        iterEnd = this->pReps[l][a].end();
-        for (iter = iterBegin; iter != iterEnd; iter++)
-        {
-            if ((iter->start <= Q.end) && (Q.start <= iter->end))
-            {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= iter->id;
-#endif
-            }
-        }
+        scanRecords(this->kernel, this->getReps(l, a), this->getNumReps(l, a, a), tmin, Q.end, Q.start, tmax, result);
         
         if (a < b)
         {
             // Handle the rest before the partition that contains b: consider only originals, no comparisons needed
-            for (auto j = a+1; j < b; j++)
-            {
-                iterBegin = this->pOrgs[l][j].begin();
-                iterEnd = this->pOrgs[l][j].end();
-                for (iter = iterBegin; iter != iterEnd; iter++)
-                {
-#ifdef WORKLOAD_COUNT
-                    result++;
-#else
-                    result ^= iter->id;
-#endif
-                }
-            }
+            reportRecords(this->kernel, this->getOrgs(l, a+1), this->getNumOrgs(l, a+1, b-1), result);
             
             // Handle the partition that contains b: consider only originals, comparisons needed
-            iterBegin = this->pOrgs[l][b].begin();
-            iterEnd = this->pOrgs[l][b].end();
-            for (iter = iterBegin; iter != iterEnd; iter++)
-            {
-                if (iter->start <= Q.end)
-                {
-#ifdef WORKLOAD_COUNT
-                    result++;
-#else
-                    result ^= iter->id;
-#endif
-                }
-            }
+            scanRecords(this->kernel, this->getOrgs(l, b), this->getNumOrgs(l, b, b), tmin, Q.end, tmin, tmax, result);
         }
         
         a >>= 1; // a = a div 2
@@ -324,29 +273,25 @@ size_t HINT_M::executeTopDown_gOverlaps(RangeQuery Q)
     }
     
     // Handle root: consider only originals, comparisons needed
-    iterBegin = this->pOrgs[this->numBits][0].begin();
-    iterEnd = this->pOrgs[this->numBits][0].end();
-    for (iter = iterBegin; iter != iterEnd; iter++)
-    {
-        if ((iter->start <= Q.end) && (Q.start <= iter->end))
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= iter->id;
-#endif
-        }
-    }
+    scanRecords(this->kernel, this->getOrgs(this->numBits, 0), this->getNumOrgs(this->numBits, 0, 0), tmin, Q.end, Q.start, tmax, result);
     
+}
+
+
+size_t HINT_M::executeTopDown_gOverlaps(RangeQuery Q)
+{
+    WorkloadSink result;
     
-    return result;
+    this->executeTopDown_gOverlaps(Q, result);
+    
+    return result.get();
 }
 
 
-size_t HINT_M::executeBottomUp_gOverlaps(RangeQuery Q)
+template <class Sink>
+void HINT_M::executeBottomUp_gOverlaps(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
-    RelationIterator iter, iterBegin, iterEnd;
+    const Timestamp tmin = numeric_limits<Timestamp>::min(), tmax = numeric_limits<Timestamp>::max();
     Timestamp a = Q.start >> (this->maxBits-this->numBits); // prefix
     Timestamp b = Q.end   >> (this->maxBits-this->numBits); // prefix
     bool foundzero = false;
@@ -361,31 +306,10 @@ size_t HINT_M::executeBottomUp_gOverlaps(RangeQuery Q)
             // all contents are guaranteed to be results
             
             // Handle the partition that contains a: consider both originals and replicas
-            iterBegin = this->pReps[l][a].begin();
-            iterEnd = this->pReps[l][a].end();
-            for (iter = iterBegin; iter != iterEnd; iter++)
-            {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= iter->id;
-#endif
-            }
+            reportRecords(this->kernel, this->getReps(l, a), this->getNumReps(l, a, a), result);
             
             // Handle rest: consider only originals
-            for (auto j = a; j <= b; j++)
-            {
-                iterBegin = this->pOrgs[l][j].begin();
-                iterEnd = this->pOrgs[l][j].end();
-                for (iter = iterBegin; iter != iterEnd; iter++)
-                {
-#ifdef WORKLOAD_COUNT
-                    result++;
-#else
-                    result ^= iter->id;
-#endif
-                }
-            }
+            reportRecords(this->kernel, this->getOrgs(l, a), this->getNumOrgs(l, a, b), result);
         }
         else
         {
@@ -397,51 +321,15 @@ size_t HINT_M::executeBottomUp_gOverlaps(RangeQuery Q)
                 // Special case when query overlaps only one partition, Lemma 3
                 if (!foundzero && !foundone)
                 {
-                    iterBegin = this->pOrgs[l][a].begin();
-                    iterEnd = this->pOrgs[l][a].end();
-                    for (iter = iterBegin; iter != iterEnd; iter++)
-                    {
-                        if ((iter->start <= Q.end) && (Q.start <= iter->end))
-                        {
-#ifdef WORKLOAD_COUNT
-                            result++;
-#else
-                            result ^= iter->id;
-#endif
-                        }
-                    }
+                    scanRecords(this->kernel, this->getOrgs(l, a), this->getNumOrgs(l, a, a), tmin, Q.end, Q.start, tmax, result);
                 }
                 else if (foundzero)
                 {
-                    iterBegin = this->pOrgs[l][a].begin();
-                    iterEnd = this->pOrgs[l][a].end();
-                    for (iter = iterBegin; iter != iterEnd; iter++)
-                    {
-                        if (iter->start <= Q.end)
-                        {
-#ifdef WORKLOAD_COUNT
-                            result++;
-#else
-                            result ^= iter->id;
-#endif
-                        }
-                    }
+                    scanRecords(this->kernel, this->getOrgs(l, a), this->getNumOrgs(l, a, a), tmin, Q.end, tmin, tmax, result);
                 }
                 else if (foundone)
                 {
-                    iterBegin = this->pOrgs[l][a].begin();
-                    iterEnd = this->pOrgs[l][a].end();
-                    for (iter = iterBegin; iter != iterEnd; iter++)
-                    {
-                        if (Q.start <= iter->end)
-                        {
-#ifdef WORKLOAD_COUNT
-                            result++;
-#else
-                            result ^= iter->id;
-#endif
-                        }
-                    }
+                    scanRecords(this->kernel, this->getOrgs(l, a), this->getNumOrgs(l, a, a), tmin, tmax, Q.start, tmax, result);
                 }
             }
             else
@@ -449,32 +337,11 @@ size_t HINT_M::executeBottomUp_gOverlaps(RangeQuery Q)
                 // Lemma 1
                 if (!foundzero)
                 {
-                    iterBegin = this->pOrgs[l][a].begin();
-                    iterEnd = this->pOrgs[l][a].end();
-                    for (iter = iterBegin; iter != iterEnd; iter++)
-                    {
-                        if (Q.start <= iter->end)
-                        {
-#ifdef WORKLOAD_COUNT
-                            result++;
-#else
-                            result ^= iter->id;
-#endif
-                        }
-                    }
+                    scanRecords(this->kernel, this->getOrgs(l, a), this->getNumOrgs(l, a, a), tmin, tmax, Q.start, tmax, result);
                 }
                 else
                 {
-                    iterBegin = this->pOrgs[l][a].begin();
-                    iterEnd = this->pOrgs[l][a].end();
-                    for (iter = iterBegin; iter != iterEnd; iter++)
-                    {
-#ifdef WORKLOAD_COUNT
-                        result++;
-#else
-                        result ^= iter->id;
-#endif
-                    }
+                    reportRecords(this->kernel, this->getOrgs(l, a), this->getNumOrgs(l, a, a), result);
                 }
             }
             
@@ -482,32 +349,11 @@ size_t HINT_M::executeBottomUp_gOverlaps(RangeQuery Q)
             if (!foundzero)
             {
                 //TODO with
-                iterBegin = this->pReps[l][a].begin();
-                iterEnd = this->pReps[l][a].end();
-                for (iter = iterBegin; iter != iterEnd; iter++)
-                {
-                    if (Q.start <= iter->end)
-                    {
-#ifdef WORKLOAD_COUNT
-                        result++;
-#else
-                        result ^= iter->id;
-#endif
-                    }
-                }
+                scanRecords(this->kernel, this->getReps(l, a), this->getNumReps(l, a, a), tmin, tmax, Q.start, tmax, result);
             }
             else
             {
-                iterBegin = this->pReps[l][a].begin();
-                iterEnd = this->pReps[l][a].end();
-                for (iter = iterBegin; iter != iterEnd; iter++)
-                {
-#ifdef WORKLOAD_COUNT
-                    result++;
-#else
-                    result ^= iter->id;
-#endif
-                }
+                reportRecords(this->kernel, this->getReps(l, a), this->getNumReps(l, a, a), result);
             }
             
             if (a < b)
@@ -515,50 +361,14 @@ size_t HINT_M::executeBottomUp_gOverlaps(RangeQuery Q)
                 if (!foundone)
                 {
                     // Handle the rest before the partition that contains b: consider only originals, no comparisons needed
-                    for (auto j = a+1; j < b; j++)
-                    {
-                        iterBegin = this->pOrgs[l][j].begin();
-                        iterEnd = this->pOrgs[l][j].end();
-                        for (iter = iterBegin; iter != iterEnd; iter++)
-                        {
-#ifdef WORKLOAD_COUNT
-                            result++;
-#else
-                            result ^= iter->id;
-#endif
-                        }
-                    }
+                    reportRecords(this->kernel, this->getOrgs(l, a+1), this->getNumOrgs(l, a+1, b-1), result);
                     
                     // Handle the partition that contains b: consider only originals, comparisons needed
-                    iterBegin = this->pOrgs[l][b].begin();
-                    iterEnd = this->pOrgs[l][b].end();
-                    for (iter = iterBegin; iter != iterEnd; iter++)
-                    {
-                        if (iter->start <= Q.end)
-                        {
-#ifdef WORKLOAD_COUNT
-                            result++;
-#else
-                            result ^= iter->id;
-#endif
-                        }
-                    }
+                    scanRecords(this->kernel, this->getOrgs(l, b), this->getNumOrgs(l, b, b), tmin, Q.end, tmin, tmax, result);
                 }
                 else
                 {
-                    for (auto j = a+1; j <= b; j++)
-                    {
-                        iterBegin = this->pOrgs[l][j].begin();
-                        iterEnd = this->pOrgs[l][j].end();
-                        for (iter = iterBegin; iter != iterEnd; iter++)
-                        {
-#ifdef WORKLOAD_COUNT
-                            result++;
-#else
-                            result ^= iter->id;
-#endif
-                        }
-                    }
+                    reportRecords(this->kernel, this->getOrgs(l, a+1), this->getNumOrgs(l, a+1, b), result);
                 }
             }
             
@@ -575,35 +385,31 @@ size_t HINT_M::executeBottomUp_gOverlaps(RangeQuery Q)
     if (foundone && foundzero)
     {
         // All contents are guaranteed to be results
-        iterBegin = this->pOrgs[this->numBits][0].begin();
-        iterEnd = this->pOrgs[this->numBits][0].end();
-        for (iter = iterBegin; iter != iterEnd; iter++)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= iter->id;
-#endif
-        }
+        reportRecords(this->kernel, this->getOrgs(this->numBits, 0), this->getNumOrgs(this->numBits, 0, 0), result);
     }
     else
     {
         // Comparisons needed
-        iterBegin = this->pOrgs[this->numBits][0].begin();
-        iterEnd = this->pOrgs[this->numBits][0].end();
-        for (iter = iterBegin; iter != iterEnd; iter++)
-        {
-            if ((iter->start <= Q.end) && (Q.start <= iter->end))
-            {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= iter->id;
-#endif
-            }
-        }
+        scanRecords(this->kernel, this->getOrgs(this->numBits, 0), this->getNumOrgs(this->numBits, 0, 0), tmin, Q.end, Q.start, tmax, result);
     }
     
+}
+
+
+size_t HINT_M::executeBottomUp_gOverlaps(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_gOverlaps(Q, result);
     
-    return result;
+    return result.get();
 }
+
+
+
+// Explicit instantiations for every result sink
+#define INSTANTIATE_HINT_M(Sink) \
+    template void HINT_M::executeTopDown_gOverlaps(RangeQuery, Sink&); \
+    template void HINT_M::executeBottomUp_gOverlaps(RangeQuery, Sink&);
+
+FOR_EACH_SINK(INSTANTIATE_HINT_M)
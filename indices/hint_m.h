@@ -35,8 +35,58 @@
 #include "../containers/relation.h"
 #include "../containers/offsets.h"
 #include "../containers/offsets_templates.cpp"
+#include "../containers/candidates.h"
+#include "../containers/aggregates.h"
+#include "../containers/kernels.h"
+#include "../containers/radixsort.h"
 #include "../indices/hierarchicalindex.h"
-#include <boost/dynamic_bitset.hpp>
+
+
+
+// Cursors over the bottom-level offsets shared by the queries of a batch, one
+// per lookup of a gOverlaps range query; named after the next_from/next_to
+// cursors they initialize.
+struct gOverlapsSweep
+{
+    OffsetsCursor OinA, OaftA, RinA, RaftA, OinB, OaftB, OinAB, toOinAB, OaftAB, toOaftAB;
+};
+
+
+
+// File format of HINT^m with all optimizations, see HINT_M_ALL::save(): the
+// header, a directory with INDEX_FILE_SECTIONS_PER_LEVEL sections per level
+// and the sections, each starting at a page boundary. The sections of a level
+// are its 8 id and timestamp arrays, followed by the 5 arrays of each of its 4
+// offsets, i.e., the timestamps, the positions, the vertical pointers and the
+// rank directory (words and counts), exactly as they are in memory, so that
+// the index is reopened as views of the mapped file, see
+// HINT_M_ALL(filename). The offsets keep the position of their partition in
+// the arrays of the level instead of iterators, so that the file does not
+// depend on the address it is mapped at. The header records the version of
+// the format and the sizes of the types it depends on, a file that does not
+// match the build is rejected instead of misread.
+#define INDEX_FILE_MAGIC "HINTIDX1"
+#define INDEX_FILE_VERSION 4
+#define INDEX_FILE_PAGE_SIZE 4096
+#define INDEX_FILE_SECTIONS_PER_LEVEL 28
+
+struct IndexFileHeader
+{
+    char     magic[8];
+    uint32_t version;
+    uint16_t timestampSize;
+    uint16_t recordIdSize;
+    uint32_t numBits;
+    uint32_t maxBits;
+    uint64_t numIndexedRecords;
+    uint64_t numEmptyPartitions;
+};
+
+struct IndexFileSection
+{
+    uint64_t offset;    // in bytes, from the beginning of the file
+    uint64_t count;     // in elements
+};
 
 
 
@@ -44,14 +94,25 @@
 class HINT_M : public HierarchicalIndex
 {
 private:
-    Relation **pOrgs, **pReps;
+    // The contents of all partitions of a level are stored contiguously;
+    // partition j spans [offsets[j], offsets[j+1]) of the level
+    Relation *pOrgs, *pReps;
     RecordId **pOrgs_sizes;
     size_t   **pReps_sizes;
+    RecordId **pOrgs_offsets;
+    size_t   **pReps_offsets;
     
     // Construction
     inline void updateCounters(const Record &r);
     inline void updatePartitions(const Record &r);
     
+    // Querying
+    // Auxiliary functions to access the contents of partitions from..to of a level.
+    inline const Record* getOrgs(const unsigned int level, const Timestamp from) const {return this->pOrgs[level].data()+this->pOrgs_offsets[level][from];};
+    inline const Record* getReps(const unsigned int level, const Timestamp from) const {return this->pReps[level].data()+this->pReps_offsets[level][from];};
+    inline size_t getNumOrgs(const unsigned int level, const Timestamp from, const Timestamp to) const {return this->pOrgs_offsets[level][to+1]-this->pOrgs_offsets[level][from];};
+    inline size_t getNumReps(const unsigned int level, const Timestamp from, const Timestamp to) const {return this->pReps_offsets[level][to+1]-this->pReps_offsets[level][from];};
+    
 public:
     // Construction
     HINT_M(const Relation &R, const unsigned int numBits, const unsigned int maxBits);
@@ -62,6 +123,10 @@ public:
     // Querying
     size_t executeTopDown_gOverlaps(RangeQuery Q);
     size_t executeBottomUp_gOverlaps(RangeQuery Q);
+
+    // Querying with an explicit result sink, see containers/sinks.h
+    template <class Sink> void executeTopDown_gOverlaps(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_gOverlaps(RangeQuery Q, Sink &result);
 };
 
 
@@ -89,6 +154,9 @@ public:
     
     // Querying
     size_t executeBottomUp_gOverlaps(RangeQuery Q);
+
+    // Querying with an explicit result sink, see containers/sinks.h
+    template <class Sink> void executeBottomUp_gOverlaps(RangeQuery Q, Sink &result);
 };
 
 
@@ -117,6 +185,9 @@ public:
     
     // Querying
     size_t executeBottomUp_gOverlaps(RangeQuery Q);
+
+    // Querying with an explicit result sink, see containers/sinks.h
+    template <class Sink> void executeBottomUp_gOverlaps(RangeQuery Q, Sink &result);
 };
 
 
@@ -145,6 +216,9 @@ public:
     
     // Querying
     size_t executeBottomUp_gOverlaps(RangeQuery Q);
+
+    // Querying with an explicit result sink, see containers/sinks.h
+    template <class Sink> void executeBottomUp_gOverlaps(RangeQuery Q, Sink &result);
 };
 
 
@@ -180,17 +254,17 @@ private:
     inline bool getBounds_RepsAft(unsigned int level, Timestamp t, PartitionId &next_from, RelationIdIterator &iterStart, RelationIdIterator &iterEnd);
     
     // Auxiliary functions to scan partitions.
-    inline void scanFirstPartition_OrgsIn_gOverlaps(unsigned int level, Timestamp a, PartitionId &next_from, size_t &result);
-    inline void scanFirstPartition_OrgsIn_gOverlaps(unsigned int level, Timestamp a, Timestamp qstart, Record qdummyE, PartitionId &next_from, size_t &result);
-    inline void scanFirstPartition_OrgsIn_gOverlaps(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, size_t &result);
-    inline void scanFirstPartition_OrgsAft_gOverlaps(unsigned int level, Timestamp a, PartitionId &next_from, size_t &result);
-    inline void scanFirstPartition_RepsIn_gOverlaps(unsigned int level, Timestamp a, PartitionId &next_from, size_t &result);
-    inline void scanFirstPartition_RepsIn_gOverlaps(unsigned int level, Timestamp a, RecordEnd qdummyS, PartitionId &next_from, size_t &result);
-    inline void scanFirstPartition_RepsAft_gOverlaps(unsigned int level, Timestamp a, PartitionId &next_from, size_t &result);
-    inline void scanPartitions_OrgsIn_gOverlaps(unsigned int level, Timestamp a, Timestamp b, PartitionId &next_from, PartitionId &next_to, size_t &result);
-    inline void scanPartitions_OrgsAft_gOverlaps(unsigned int level, Timestamp a, Timestamp b, PartitionId &next_from, PartitionId &next_to, size_t &result);
-    inline void scanLastPartition_OrgsIn_gOverlaps(unsigned int level, Timestamp b, Record qdummyE, PartitionId &next_from, size_t &result);
-    inline void scanLastPartition_OrgsAft_gOverlaps(unsigned int level, Timestamp b, RecordStart qdummySE, PartitionId &next_from, size_t &result);
+    template <class Sink> inline void scanFirstPartition_OrgsIn_gOverlaps(unsigned int level, Timestamp a, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanFirstPartition_OrgsIn_gOverlaps(unsigned int level, Timestamp a, Timestamp qstart, Record qdummyE, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanFirstPartition_OrgsIn_gOverlaps(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanFirstPartition_OrgsAft_gOverlaps(unsigned int level, Timestamp a, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanFirstPartition_RepsIn_gOverlaps(unsigned int level, Timestamp a, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanFirstPartition_RepsIn_gOverlaps(unsigned int level, Timestamp a, RecordEnd qdummyS, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanFirstPartition_RepsAft_gOverlaps(unsigned int level, Timestamp a, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartitions_OrgsIn_gOverlaps(unsigned int level, Timestamp a, Timestamp b, PartitionId &next_from, PartitionId &next_to, Sink &result);
+    template <class Sink> inline void scanPartitions_OrgsAft_gOverlaps(unsigned int level, Timestamp a, Timestamp b, PartitionId &next_from, PartitionId &next_to, Sink &result);
+    template <class Sink> inline void scanLastPartition_OrgsIn_gOverlaps(unsigned int level, Timestamp b, Record qdummyE, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanLastPartition_OrgsAft_gOverlaps(unsigned int level, Timestamp b, RecordStart qdummySE, PartitionId &next_from, Sink &result);
     
 public:
     // Construction
@@ -200,6 +274,9 @@ public:
     
     // Querying
     size_t executeBottomUp_gOverlaps(RangeQuery Q);
+
+    // Querying with an explicit result sink, see containers/sinks.h
+    template <class Sink> void executeBottomUp_gOverlaps(RangeQuery Q, Sink &result);
 };
 
 
@@ -231,12 +308,12 @@ private:
     
     // Querying
     // Auxiliary functions to scan a partition.
-    inline void scanPartition_CheckBothTimestamps_gOverlaps(unsigned int level, Timestamp t, RelationId **ids, vector<pair<Timestamp, Timestamp>> **timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), RangeQuery &Q, size_t &result);
-    inline void scanPartition_CheckEnd_gOverlaps(unsigned int level, Timestamp t, RelationId **ids, vector<pair<Timestamp, Timestamp>> **timestamps, RangeQuery &Q, size_t &result);
-    inline void scanPartition_CheckEnd_gOverlaps(unsigned int level, Timestamp t, RelationId **ids, vector<pair<Timestamp, Timestamp>> **timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), RangeQuery &Q, size_t &result);
-    inline void scanPartition_CheckStart_gOverlaps(unsigned int level, Timestamp t, RelationId **ids, vector<pair<Timestamp, Timestamp>> **timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), RangeQuery &Q, size_t &result);
-    inline void scanPartition_NoChecks_gOverlaps(unsigned int level, Timestamp t, RelationId **ids, size_t &result);
-    inline void scanPartitions_NoChecks_gOverlaps(unsigned int level, Timestamp ts, Timestamp te, RelationId **ids, size_t &result);
+    template <class Sink> inline void scanPartition_CheckBothTimestamps_gOverlaps(unsigned int level, Timestamp t, RelationId **ids, vector<pair<Timestamp, Timestamp>> **timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), RangeQuery &Q, Sink &result);
+    template <class Sink> inline void scanPartition_CheckEnd_gOverlaps(unsigned int level, Timestamp t, RelationId **ids, vector<pair<Timestamp, Timestamp>> **timestamps, RangeQuery &Q, Sink &result);
+    template <class Sink> inline void scanPartition_CheckEnd_gOverlaps(unsigned int level, Timestamp t, RelationId **ids, vector<pair<Timestamp, Timestamp>> **timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), RangeQuery &Q, Sink &result);
+    template <class Sink> inline void scanPartition_CheckStart_gOverlaps(unsigned int level, Timestamp t, RelationId **ids, vector<pair<Timestamp, Timestamp>> **timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), RangeQuery &Q, Sink &result);
+    template <class Sink> inline void scanPartition_NoChecks_gOverlaps(unsigned int level, Timestamp t, RelationId **ids, Sink &result);
+    template <class Sink> inline void scanPartitions_NoChecks_gOverlaps(unsigned int level, Timestamp ts, Timestamp te, RelationId **ids, Sink &result);
     
 public:
     // Construction
@@ -246,6 +323,9 @@ public:
     
     // Querying
     size_t executeBottomUp_gOverlaps(RangeQuery q);
+
+    // Querying with an explicit result sink, see containers/sinks.h
+    template <class Sink> void executeBottomUp_gOverlaps(RangeQuery q, Sink &result);
 };
 
 
@@ -279,6 +359,9 @@ public:
     
     // Querying
     size_t executeBottomUp_gOverlaps(RangeQuery Q);
+
+    // Querying with an explicit result sink, see containers/sinks.h
+    template <class Sink> void executeBottomUp_gOverlaps(RangeQuery Q, Sink &result);
 };
 
 
@@ -293,13 +376,13 @@ private:
     Relation      *pRepsAftTmp;
     
     RelationId    *pOrgsInIds;
-    vector<pair<Timestamp, Timestamp> > *pOrgsInTimestamps;
+    TimestampPairs *pOrgsInTimestamps;
     RelationId    *pOrgsAftIds;
-    vector<pair<Timestamp, Timestamp> > *pOrgsAftTimestamps;
+    TimestampPairs *pOrgsAftTimestamps;
     RelationId    *pRepsInIds;
-    vector<pair<Timestamp, Timestamp> > *pRepsInTimestamps;
+    TimestampPairs *pRepsInTimestamps;
     RelationId    *pRepsAftIds;
-    vector<pair<Timestamp, Timestamp> > *pRepsAftTimestamps;
+    TimestampPairs *pRepsAftTimestamps;
     
     RecordId      **pOrgsIn_sizes, **pOrgsAft_sizes;
     size_t        **pRepsIn_sizes, **pRepsAft_sizes;
@@ -314,68 +397,77 @@ private:
     // Construction
     inline void updateCounters(const Record &r);
     inline void updatePartitions(const Record &r);
+    void buildOffsets();
+    
+    // Updating
+    bool supportsUpdates() const {return true;};
+    void mergeDelta();
+    bool locate(const Record &r, vector<const RecordId*> &slots);
+    void purgeTombstones();
     
     // Querying
     // Auxiliary functions to determine exactly how to scan a partition.
-    inline bool getBounds(unsigned int level, Timestamp t, PartitionId &next_from, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, vector<pair<Timestamp, Timestamp> >::iterator &iterStart, vector<pair<Timestamp, Timestamp> >::iterator &iterEnd, RelationIdIterator &iterI);
+    inline bool getBounds(unsigned int level, Timestamp t, PartitionId &next_from, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, TimestampPairs::iterator &iterStart, TimestampPairs::iterator &iterEnd, RelationIdIterator &iterI);
     inline bool getBounds(unsigned int level, Timestamp t, PartitionId &next_from, Offsets_SS_CM *ioffsets, RelationId *ids, RelationIdIterator &iterIStart, RelationIdIterator &iterIEnd);
-    inline bool getBoundsS(unsigned int level, Timestamp t, PartitionId &next_from, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, RelationIdIterator &iterIStart, RelationIdIterator &iterIEnd);
-    inline bool getBoundsE(unsigned int level, Timestamp t, PartitionId &next_from, Offsets_SS_CM *ioffsets, RelationId *ids, vector<pair<Timestamp, Timestamp> > *timestamps, RelationIdIterator &iterIStart, RelationIdIterator &iterIEnd);
-    inline bool getBounds(unsigned int level, Timestamp ts, Timestamp te, PartitionId &next_from, PartitionId &next_to, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, vector<pair<Timestamp, Timestamp> >::iterator &iterStart, vector<pair<Timestamp, Timestamp> >::iterator &iterEnd, RelationIdIterator &iterI);
+    inline bool getBoundsS(unsigned int level, Timestamp t, PartitionId &next_from, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, RelationIdIterator &iterIStart, RelationIdIterator &iterIEnd);
+    inline bool getBoundsE(unsigned int level, Timestamp t, PartitionId &next_from, Offsets_SS_CM *ioffsets, RelationId *ids, TimestampPairs *timestamps, RelationIdIterator &iterIStart, RelationIdIterator &iterIEnd);
+    inline bool getBounds(unsigned int level, Timestamp ts, Timestamp te, PartitionId &next_from, PartitionId &next_to, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, TimestampPairs::iterator &iterStart, TimestampPairs::iterator &iterEnd, RelationIdIterator &iterI);
     inline bool getBounds(unsigned int level, Timestamp ts, Timestamp te, PartitionId &next_from, PartitionId &next_to, Offsets_SS_CM *ioffsets, RelationId *ids, RelationIdIterator &iterIStart, RelationIdIterator &iterIEnd);
     
     // Auxiliary functions to scan a partition.
-    inline void scanPartition_CheckBothTimestamps_Equals(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, size_t &result);
-    inline void scanPartition_CheckBothTimestamps_Starts(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, size_t &result);
-    inline void scanPartition_CheckStart_Starts(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, size_t &result);
-    inline void scanPartition_CheckBothTimestamps_Started(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, size_t &result);
-    inline void scanPartition_CheckBothTimestamps_Finishes(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, size_t &result);
-    inline void scanPartition_CheckBothTimestamps2_Finishes(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, size_t &result);
-    inline void scanPartition_CheckEnd_Finishes(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, size_t &result);
-    inline void scanPartition_CheckBothTimestamps_Finished(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, size_t &result);
-    inline void scanPartition_CheckBothTimestamps2_Finished(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, size_t &result);
-    inline void scanPartition_CheckEnd_Finished(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, Timestamp qt, PartitionId &next_from, size_t &result);
-    inline void scanPartition_CheckEnd_Met(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, size_t &result);
-    inline void scanPartition_CheckAllConditions_Overlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, size_t &result);
-    inline void scanPartition_CheckTwoConditions1_Overlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, size_t &result);
-    inline void scanPartition_CheckTwoConditions2_Overlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, size_t &result);
-    inline void scanPartition_CheckOneCondition_Overlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamp, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, size_t &result);
-    inline void scanPartition_CheckTwoConditions_Overlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, size_t &result);
-    inline void scanPartition_CheckTwoConditions3_Overlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, size_t &result);
-    inline void scanPartitions_CheckOneCondition_Overlaps(unsigned int level, Timestamp ts, Timestamp te, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, Timestamp qt, PartitionId &next_from, PartitionId &next_to, size_t &result);
-    inline void scanPartition_CheckOneCondition2_Overlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, Timestamp qt, PartitionId &next_from, size_t &result);
-  inline void scanPartition_CheckAllConditions_Overlapped(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, size_t &result);
-    inline void scanPartition_CheckTwoConditions1_Overlapped(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, size_t &result);
-    inline void scanPartition_CheckTwoConditions2_Overlapped(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, size_t &result);
-    inline void scanPartition_CheckTwoConditions3_Overlapped(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, size_t &result);
-    inline void scanPartition_CheckTwoConditions4_Overlapped(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, size_t &result);
-    inline void scanPartition_CheckOneCondition_Overlapped(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, Timestamp qt, PartitionId &next_from, size_t &result);
-    inline void scanPartition_CheckOneCondition_Overlapped(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, PartitionId &next_from, size_t &result);
-    inline void scanPartition_CheckEnd_Overlapped(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, Timestamp qend, PartitionId &next_from, size_t &result);
-    inline void scanPartitions_CheckOneCondition_Overlapped(unsigned int level, Timestamp ts, Timestamp te, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, Timestamp qt, PartitionId &next_from, PartitionId &next_to, size_t &result);
-    inline void scanPartition_CheckBothTimestamps_Contains(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, size_t &result);
-    inline void scanPartition_CheckStart_Contains(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, size_t &result);
-    inline void scanPartitions_CheckEnd_Contains(unsigned int level, Timestamp ts, Timestamp te, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, Timestamp qt, PartitionId &next_from, PartitionId &next_to, size_t &result);
-    inline void scanPartition_CheckBothTimestamps_Contained(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, size_t &result);
-    inline void scanPartition_CheckStart_Contained(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, size_t &result);
-    inline void scanPartition_CheckEnd_Contained(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, size_t &result);
-
-    inline void scanPartition_Precedes(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, size_t &result);
-    inline void scanPartitions_Precedes(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, PartitionId &next_from, size_t &result);
-    inline void scanPartition_Preceded(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, Timestamp qt, PartitionId &next_from, size_t &result);
-    inline void scanPartition_Preceded(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, size_t &result);
-    inline void scanPartitions_Preceded(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, RelationId *ids, vector<pair<Timestamp, Timestamp> > *timestamps, PartitionId &next_from, size_t &result);
-
-    inline void scanPartition_CheckBothTimestamps_gOverlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, size_t &result);
-    inline void scanPartition_CheckEnd_gOverlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, Timestamp qt, PartitionId &next_from, size_t &result);
-    inline void scanPartition_CheckEnd_gOverlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, size_t &result);
-    inline void scanPartition_CheckStart_gOverlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, size_t &result);
-    inline void scanPartition_NoChecks_gOverlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, RelationId *ids, PartitionId &next_from, size_t &result);
-    inline void scanPartitions_NoChecks_gOverlaps(unsigned int level, Timestamp ts, Timestamp te, Offsets_SS_CM *ioffsets, RelationId *ids, PartitionId &next_from, PartitionId &next_to, size_t &result);
+    template <class Sink> inline void scanPartition_CheckBothTimestamps_Equals(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartition_CheckBothTimestamps_Starts(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartition_CheckStart_Starts(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartition_CheckBothTimestamps_Started(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartition_CheckBothTimestamps_Finishes(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartition_CheckBothTimestamps2_Finishes(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartition_CheckEnd_Finishes(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartition_CheckBothTimestamps_Finished(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartition_CheckBothTimestamps2_Finished(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartition_CheckEnd_Finished(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, Timestamp qt, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartition_CheckEnd_Met(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartition_CheckAllConditions_Overlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartition_CheckTwoConditions1_Overlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartition_CheckTwoConditions2_Overlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartition_CheckOneCondition_Overlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamp, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartition_CheckTwoConditions_Overlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartition_CheckTwoConditions3_Overlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartitions_CheckOneCondition_Overlaps(unsigned int level, Timestamp ts, Timestamp te, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, Timestamp qt, PartitionId &next_from, PartitionId &next_to, Sink &result);
+    template <class Sink> inline void scanPartition_CheckOneCondition2_Overlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, Timestamp qt, PartitionId &next_from, Sink &result);
+  template <class Sink> inline void scanPartition_CheckAllConditions_Overlapped(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartition_CheckTwoConditions1_Overlapped(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartition_CheckTwoConditions2_Overlapped(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartition_CheckTwoConditions3_Overlapped(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartition_CheckTwoConditions4_Overlapped(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartition_CheckOneCondition_Overlapped(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, Timestamp qt, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartition_CheckOneCondition_Overlapped(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartition_CheckEnd_Overlapped(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, Timestamp qend, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartitions_CheckOneCondition_Overlapped(unsigned int level, Timestamp ts, Timestamp te, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, Timestamp qt, PartitionId &next_from, PartitionId &next_to, Sink &result);
+    template <class Sink> inline void scanPartition_CheckBothTimestamps_Contains(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartition_CheckStart_Contains(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartitions_CheckEnd_Contains(unsigned int level, Timestamp ts, Timestamp te, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, Timestamp qt, PartitionId &next_from, PartitionId &next_to, Sink &result);
+    template <class Sink> inline void scanPartition_CheckBothTimestamps_Contained(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartition_CheckStart_Contained(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartition_CheckEnd_Contained(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, Sink &result);
+
+    template <class Sink> inline void scanPartition_Precedes(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartitions_Precedes(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartition_Preceded(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, Timestamp qt, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartition_Preceded(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartitions_Preceded(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, RelationId *ids, TimestampPairs *timestamps, PartitionId &next_from, Sink &result);
+
+    template <class Sink> inline void scanPartition_CheckBothTimestamps_gOverlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, RelationId *ids, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartition_CheckEnd_gOverlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, RelationId *ids, Timestamp qt, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartition_CheckEnd_gOverlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartition_CheckStart_gOverlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartition_NoChecks_gOverlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, RelationId *ids, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartitions_NoChecks_gOverlaps(unsigned int level, Timestamp ts, Timestamp te, Offsets_SS_CM *ioffsets, RelationId *ids, PartitionId &next_from, PartitionId &next_to, Sink &result);
+    template <class Sink> inline void executeBottomUp_gOverlaps(RangeQuery Q, gOverlapsSweep *sweep, Sink &result);
 
 public:
     // Construction
     HINT_M_SubsSort_SS_CM(const Relation &R, const unsigned int numBits, const unsigned int maxBits);
+    void buildSearchLayout();
     void getStats();
     ~HINT_M_SubsSort_SS_CM();
     
@@ -397,6 +489,24 @@ public:
 
     // Generalized predicates, ACM SIGMOD'22 gOverlaps
     size_t executeBottomUp_gOverlaps(RangeQuery Q);
+    void executeBottomUp_gOverlaps(const vector<RangeQuery> &queries, vector<size_t> &results);
+
+    // Querying with an explicit result sink, see containers/sinks.h
+    template <class Sink> void executeBottomUp_Equals(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_Starts(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_Started(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_Finishes(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_Finished(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_Meets(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_Met(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_Overlaps(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_Overlapped(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_Contains(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_Contained(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_Precedes(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_Preceded(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_gOverlaps(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_gOverlaps(const vector<RangeQuery> &queries, vector<Sink> &results);
 };
 
 
@@ -405,118 +515,151 @@ public:
 class HINT_M_ALL : public HierarchicalIndex
 {
 private:
-    Relation      *pOrgsInTmp;
-    RelationStart *pOrgsAftTmp;
-    RelationEnd   *pRepsInTmp;
-    
-    RelationId    *pOrgsInIds;
-    vector<pair<Timestamp, Timestamp> > *pOrgsInTimestamps;
-    RelationId    *pOrgsAftIds;
-    vector<Timestamp> *pOrgsAftTimestamp;
-    RelationId    *pRepsInIds;
-    vector<Timestamp> *pRepsInTimestamp;
-    RelationId    *pRepsAft;
-    
-    RecordId      **pOrgsIn_sizes,   **pOrgsAft_sizes;
-    size_t        **pRepsIn_sizes,   **pRepsAft_sizes;
+    RelationId     *pOrgsInIds;
+    TimestampArray *pOrgsInStarts, *pOrgsInEnds;        // Kept apart for the comparison kernels, see containers/kernels.h
+    RelationId     *pOrgsAftIds;
+    TimestampArray *pOrgsAftTimestamp;
+    RelationId     *pRepsInIds;
+    TimestampArray *pRepsInTimestamp;
+    RelationId     *pRepsAft;
+    
+    // Build-time only: the offsets of the non-empty partitions of every level
+    // and class, i.e., partition j, the k-th non-empty one for k = dir.rank(j),
+    // spans [offsets[k], offsets[k+1]); see buildOffsets(). An update keeps
+    // them for all partitions until compactOffsets().
     RecordId      **pOrgsIn_offsets, **pOrgsAft_offsets;
     size_t        **pRepsIn_offsets, **pRepsAft_offsets;
+    RankBitvector *pOrgsIn_dir, *pOrgsAft_dir, *pRepsIn_dir, *pRepsAft_dir;
     Offsets_ALL_OrgsIn  *pOrgsIn_ioffsets;
     Offsets_ALL_OrgsAft *pOrgsAft_ioffsets;
     Offsets_ALL_RepsIn  *pRepsIn_ioffsets;
     Offsets_ALL_RepsAft *pRepsAft_ioffsets;
-    
-    
-    // Construction
-    inline void updateCounters(const Record &r);
-    inline void updatePartitions(const Record &r);
+    PrefixAggregates    *pOrgsInAggregates, *pOrgsAftAggregates, *pRepsInAggregates, *pRepsAftAggregates;
+    
+    // The file the index was reopened from, viewed by the arrays and the
+    // offsets, see HINT_M_ALL(filename); NULL for a built index
+    char          *mapping;
+    size_t        mappingSize;
+    MappedRegion  *regions;
+    
+    
+    // Construction; the directories, counters and positions of the partitions
+    // are given, as every thread of the construction keeps its own. For a
+    // level and class with a directory, the counters and positions are kept
+    // only for the non-empty partitions, see getCounter().
+    inline size_t getCounter(const RankBitvector *dir, const int level, const size_t p) const {return ((dir != NULL) && (!dir[level].empty()))? dir[level].rank(p): p;};
+    inline size_t getNumCounters(const RankBitvector *dir, const int level) const {return ((dir != NULL) && (!dir[level].empty()))? dir[level].getNumSetBits(): (size_t)pow(2, this->numBits-level);};
+    inline void markPartitions(const Record &r, RankBitvector *pOrgsIn_dir, RankBitvector *pOrgsAft_dir, RankBitvector *pRepsIn_dir, RankBitvector *pRepsAft_dir);
+    inline void updateCounters(const Record &r, RecordId **pOrgsIn_sizes, RecordId **pOrgsAft_sizes, size_t **pRepsIn_sizes, size_t **pRepsAft_sizes);
+    inline void updatePartitions(const Record &r, RecordId **pOrgsIn_offsets, RecordId **pOrgsAft_offsets, size_t **pRepsIn_offsets, size_t **pRepsAft_offsets);
+    void buildDirectories(const Relation &R, ThreadPool &pool);
+    void compactOffsets();
+    void buildOffsets(ThreadPool &pool);
+    
+    // Updating
+    bool supportsUpdates() const {return true;};
+    void mergeDelta();
+    bool locate(const Record &r, vector<const RecordId*> &slots);
+    void purgeTombstones();
     
     // Querying
     // Auxiliary functions to determine exactly how to scan a partition.
     inline bool getBounds_OrgsIn(unsigned int level, Timestamp t, PartitionId &next_from, RelationIdIterator &iterIStart, RelationIdIterator &iterIEnd);
-    inline bool getBounds_OrgsIn(unsigned int level, Timestamp t, PartitionId &next_from, vector<pair<Timestamp, Timestamp> >::iterator &iterStart, vector<pair<Timestamp, Timestamp> >::iterator &iterEnd, RelationIdIterator &iterI);
-    inline bool getBoundsS_OrgsIn(unsigned int level, Timestamp t, PartitionId &next_from, vector<pair<Timestamp, Timestamp> >::iterator &iterStart, RelationIdIterator &iterI);
-    inline bool getBoundsE_OrgsIn(unsigned int level, Timestamp t, PartitionId &next_from, vector<pair<Timestamp, Timestamp> >::iterator &iterEnd, RelationIdIterator &iterI);
+    inline bool getBounds_OrgsIn(unsigned int level, Timestamp t, PartitionId &next_from, TimestampArrayIterator &iterStart, TimestampArrayIterator &iterEnd, RelationIdIterator &iterI);
+    inline bool getBoundsS_OrgsIn(unsigned int level, Timestamp t, PartitionId &next_from, TimestampArrayIterator &iterStart, RelationIdIterator &iterI);
+    inline bool getBoundsE_OrgsIn(unsigned int level, Timestamp t, PartitionId &next_from, TimestampArrayIterator &iterEnd, RelationIdIterator &iterI);
     inline bool getBounds_OrgsIn(unsigned int level, Timestamp a, Timestamp b, PartitionId &next_from, PartitionId &next_to, RelationIdIterator &iterIStart, RelationIdIterator &iterIEnd);
     inline bool getBounds_OrgsAft(unsigned int level, Timestamp t, PartitionId &next_from, RelationIdIterator &iterIStart, RelationIdIterator &iterIEnd);
-    inline bool getBounds_OrgsAft(unsigned int level, Timestamp t, PartitionId &next_from, vector<Timestamp>::iterator &iterStart, vector<Timestamp>::iterator &iterEnd, RelationIdIterator &iterI);
-    inline bool getBoundsS_OrgsAft(unsigned int level, Timestamp t, PartitionId &next_from, vector<Timestamp>::iterator &iterStart, RelationIdIterator &iterI);
+    inline bool getBounds_OrgsAft(unsigned int level, Timestamp t, PartitionId &next_from, TimestampArrayIterator &iterStart, TimestampArrayIterator &iterEnd, RelationIdIterator &iterI);
+    inline bool getBoundsS_OrgsAft(unsigned int level, Timestamp t, PartitionId &next_from, TimestampArrayIterator &iterStart, RelationIdIterator &iterI);
     inline bool getBounds_OrgsAft(unsigned int level, Timestamp a, Timestamp b, PartitionId &next_from, PartitionId &next_to, RelationIdIterator &iterIStart, RelationIdIterator &iterIEnd);
-    inline bool getBounds_OrgsAft(unsigned int level, Timestamp a, Timestamp b, PartitionId &next_from, PartitionId &next_to, vector<Timestamp>::iterator &iterStart, vector<Timestamp>::iterator &iterEnd, RelationIdIterator &iterI);
+    inline bool getBounds_OrgsAft(unsigned int level, Timestamp a, Timestamp b, PartitionId &next_from, PartitionId &next_to, TimestampArrayIterator &iterStart, TimestampArrayIterator &iterEnd, RelationIdIterator &iterI);
     inline bool getBounds_RepsIn(unsigned int level, Timestamp t, PartitionId &next_from, RelationIdIterator &iterIStart, RelationIdIterator &iterIEnd);
-    inline bool getBounds_RepsIn(unsigned int level, Timestamp t, PartitionId &next_from, vector<Timestamp>::iterator &iterStart, vector<Timestamp>::iterator &iterEnd, RelationIdIterator &iterI);
-    inline bool getBoundsE_RepsIn(unsigned int level, Timestamp t, PartitionId &next_from, vector<Timestamp>::iterator &iterEnd, RelationIdIterator &iterI);
+    inline bool getBounds_RepsIn(unsigned int level, Timestamp t, PartitionId &next_from, TimestampArrayIterator &iterStart, TimestampArrayIterator &iterEnd, RelationIdIterator &iterI);
+    inline bool getBoundsE_RepsIn(unsigned int level, Timestamp t, PartitionId &next_from, TimestampArrayIterator &iterEnd, RelationIdIterator &iterI);
     inline bool getBounds_RepsIn(unsigned int level, Timestamp a, Timestamp b, PartitionId &next_from, PartitionId &next_to, RelationIdIterator &iterIStart, RelationIdIterator &iterIEnd);
     inline bool getBounds_RepsAft(unsigned int level, Timestamp t, PartitionId &next_from, RelationIdIterator &iterStart, RelationIdIterator &iterEnd);
     
     // Auxiliary functions to scan a partition.
-    inline void scanFirstPartition_OrgsIn_Equals(unsigned int level, Timestamp a, Timestamp qend, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, size_t &result);
-    inline void scanFirstPartition_OrgsAft_Equals(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, boost::dynamic_bitset<> &vcand);
-    inline void scanLastPartition_RepsIn_Equals(unsigned int level, Timestamp a, Timestamp qend, PartitionId &next_from, boost::dynamic_bitset<> &vcand, size_t &result);
-    inline void scanFirstPartition_OrgsIn_Starts(unsigned int level, Timestamp a, Timestamp qend, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, size_t &result);
-    inline void scanFirstPartition_OrgsAft_Starts(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, size_t &result);
-    inline void scanFirstPartition_OrgsAft_Starts(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, boost::dynamic_bitset<> &vcand, size_t &result);
-    inline void scanLastPartition_RepsIn_Starts(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, boost::dynamic_bitset<> &vcand, size_t &result);
-    inline void scanLastPartition_RepsAft_Starts(unsigned int level, Timestamp a, PartitionId &next_from, boost::dynamic_bitset<> &vcand, size_t &result);
-    inline void scanFirstPartition_OrgsIn_Started(unsigned int level, Timestamp a, Timestamp qend, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, size_t &result);
-    inline void scanFirstPartition_OrgsIn_Started(unsigned int level, Timestamp a, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, size_t &result);
-    inline void scanPartitions_RepsIn_Started(unsigned int level, Timestamp a, Timestamp b, PartitionId &next_from, PartitionId &next_to, boost::dynamic_bitset<> &vcand, size_t &result);
-    inline void scanLastPartition_RepsIn_Started(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, boost::dynamic_bitset<> &vcand, size_t &result);
-    inline void scanLastPartition_OrgsIn_Finishes(unsigned int level, Timestamp b, Timestamp qend, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, size_t &result);
-    inline void scanFirstPartition_OrgsAft_Finishes(unsigned int level, Timestamp a, PartitionId &next_from, boost::dynamic_bitset<> &vcand, size_t &result);
-    inline void scanFirstPartition_OrgsAft_Finishes(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, boost::dynamic_bitset<> &vcand, size_t &result);
-    inline void scanLastPartition_RepsIn_Finishes(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, size_t &result);
-    inline void scanLastPartition_RepsIn_Finishes(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, boost::dynamic_bitset<> &vcand, size_t &result);
-    inline void scanLastPartition_OrgsIn_Finished(unsigned int level, Timestamp b, Timestamp qend, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, size_t &result);
-    inline void scanLastPartition_OrgsIn_Finished(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, size_t &result);
-    inline void scanFirstPartition_OrgsAft_Finished(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, boost::dynamic_bitset<> &vcand, size_t &result);
-    inline void scanPartitions_OrgsAft_Finished(unsigned int level, Timestamp a, Timestamp b, PartitionId &next_from, PartitionId &next_to, boost::dynamic_bitset<> &vcand, size_t &result);
-    inline void scanFirstPartition_OrgsIn_Meets(unsigned int level, Timestamp a, Timestamp qstart, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, size_t &result);
-    inline void scanFirstPartition_OrgsAft_Meets(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, size_t &result);
-    inline void scanLastPartition_OrgsIn_Met(unsigned int level, Timestamp a, Timestamp qend, PartitionId &next_from, size_t &result);
-    inline void scanLastPartition_RepsIn_Met(unsigned int level, Timestamp a, Timestamp qend, PartitionId &next_from, size_t &result);
-    inline void scanFirstPartition_OrgsIn_Overlaps(unsigned int level, Timestamp a, Timestamp qend, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, size_t &result);
-    inline void scanFirstPartition_OrgsAft_Overlaps(unsigned int level, Timestamp a, Timestamp qstart, Timestamp qend, PartitionId &next_from, size_t &result);
-    inline void scanLastPartition_OrgsIn_Overlaps(unsigned int level, Timestamp b, pair<Timestamp, Timestamp> qdummyE, PartitionId &next_from, size_t &result);
-    inline void scanLastPartition_OrgsAft_Overlaps(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, size_t &result);
-    inline void scanFirstPartition_OrgsIn_Overlapped(unsigned int level, Timestamp a, Timestamp qend, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, size_t &result);
-    inline void scanFirstPartition_OrgsIn_Overlapped(unsigned int level, Timestamp a, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, size_t &result);
-    inline void scanFirstPartition_OrgsIn_Overlapped(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, size_t &result);
-    inline void scanFirstPartition_RepsIn_Overlapped(unsigned int level, Timestamp b, Timestamp qstart, Timestamp qend, PartitionId &next_from, size_t &result);
-    inline void scanFirstPartition_RepsIn_Overlapped(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, size_t &result);
-    inline void scanLastPartition_RepsIn_Overlapped(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, boost::dynamic_bitset<> &vcand, size_t &result);
-    inline void scanFirstPartition_OrgsIn_Contains(unsigned int level, Timestamp a, Timestamp qend, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, size_t &result);
-    inline void scanFirstPartition_OrgsIn_Contains(unsigned int level, Timestamp a, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, size_t &result);
-    inline void scanLastPartition_OrgsIn_Contains(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, size_t &result);
-    inline void scanFirstPartition_OrgsAft_Contains(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, boost::dynamic_bitset<> &vcand, size_t &result);
-    inline void scanFirstPartition_OrgsIn_Contained(unsigned int level, Timestamp a, Timestamp qend, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, size_t &result);
-    inline void scanFirstPartition_OrgsAft_Contained(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, size_t &result);
-    inline void scanFirstPartition_OrgsAft_Contained(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, boost::dynamic_bitset<> &vcand, size_t &result);
-    inline void scanFirstPartition_RepsAft_Contained(unsigned int level, Timestamp a, PartitionId &next_from, boost::dynamic_bitset<> &vcand, size_t &result);
-    inline void scanLastPartition_OrgsIn_Precedes(unsigned int level, Timestamp b, pair<Timestamp, Timestamp> qdummyE, PartitionId &next_from, size_t &result);
-    inline void scanLastPartition_OrgsAft_Precedes(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, size_t &result);
-    inline void scanPartitions_OrgsIn_Precedes(unsigned int level, Timestamp b, PartitionId &next_from, size_t &result);
-    inline void scanPartitions_OrgsAft_Precedes(unsigned int level, Timestamp b, PartitionId &next_from, size_t &result);
-    inline void scanFirstPartition_OrgsIn_Preceded(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, size_t &result);
-    inline void scanFirstPartition_RepsIn_Preceded(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, size_t &result);
-    inline void scanPartitions_OrgsIn_Preceded(unsigned int level, Timestamp a, PartitionId &next_from, size_t &result);
-    inline void scanPartitions_RepsIn_Preceded(unsigned int level, Timestamp a, PartitionId &next_from, size_t &result);
-    inline void scanFirstPartition_OrgsIn_gOverlaps(unsigned int level, Timestamp a, PartitionId &next_from, size_t &result);
-    inline void scanFirstPartition_OrgsIn_gOverlaps(unsigned int level, Timestamp a, Timestamp qstart, pair<Timestamp, Timestamp> qdummyE, PartitionId &next_from, size_t &result);
-    inline void scanFirstPartition_OrgsIn_gOverlaps(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, size_t &result);
-    inline void scanFirstPartition_OrgsAft_gOverlaps(unsigned int level, Timestamp a, PartitionId &next_from, size_t &result);
-    inline void scanFirstPartition_RepsIn_gOverlaps(unsigned int level, Timestamp a, PartitionId &next_from, size_t &result);
-    inline void scanFirstPartition_RepsIn_gOverlaps(unsigned int level, Timestamp a, RecordEnd qdummyS, PartitionId &next_from, size_t &result);
-    inline void scanFirstPartition_RepsAft_gOverlaps(unsigned int level, Timestamp a, PartitionId &next_from, size_t &result);
-    inline void scanPartitions_OrgsIn_gOverlaps(unsigned int level, Timestamp a, Timestamp b, PartitionId &next_from, PartitionId &next_to, size_t &result);
-    inline void scanPartitions_OrgsAft_gOverlaps(unsigned int level, Timestamp a, Timestamp b, PartitionId &next_from, PartitionId &next_to, size_t &result);
-    inline void scanLastPartition_OrgsIn_gOverlaps(unsigned int level, Timestamp b, pair<Timestamp, Timestamp> qdummyE, PartitionId &next_from, size_t &result);
-    inline void scanLastPartition_OrgsAft_gOverlaps(unsigned int level, Timestamp b, RecordStart qdummySE, PartitionId &next_from, size_t &result);
+    template <class Sink> inline void scanFirstPartition_OrgsIn_Equals(unsigned int level, Timestamp a, Timestamp qend, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, Sink &result);
+    inline void scanFirstPartition_OrgsAft_Equals(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, CandidateSet &vcand);
+    template <class Sink> inline void scanLastPartition_RepsIn_Equals(unsigned int level, Timestamp a, Timestamp qend, PartitionId &next_from, CandidateSet &vcand, Sink &result);
+    template <class Sink> inline void scanFirstPartition_OrgsIn_Starts(unsigned int level, Timestamp a, Timestamp qend, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanFirstPartition_OrgsAft_Starts(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanFirstPartition_OrgsAft_Starts(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, CandidateSet &vcand, Sink &result);
+    template <class Sink> inline void scanLastPartition_RepsIn_Starts(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, CandidateSet &vcand, Sink &result);
+    template <class Sink> inline void scanLastPartition_RepsAft_Starts(unsigned int level, Timestamp a, PartitionId &next_from, CandidateSet &vcand, Sink &result);
+    template <class Sink> inline void scanFirstPartition_OrgsIn_Started(unsigned int level, Timestamp a, Timestamp qend, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanFirstPartition_OrgsIn_Started(unsigned int level, Timestamp a, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartitions_RepsIn_Started(unsigned int level, Timestamp a, Timestamp b, PartitionId &next_from, PartitionId &next_to, CandidateSet &vcand, Sink &result);
+    template <class Sink> inline void scanLastPartition_RepsIn_Started(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, CandidateSet &vcand, Sink &result);
+    template <class Sink> inline void scanLastPartition_OrgsIn_Finishes(unsigned int level, Timestamp b, Timestamp qend, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanFirstPartition_OrgsAft_Finishes(unsigned int level, Timestamp a, PartitionId &next_from, CandidateSet &vcand, Sink &result);
+    template <class Sink> inline void scanFirstPartition_OrgsAft_Finishes(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, CandidateSet &vcand, Sink &result);
+    template <class Sink> inline void scanLastPartition_RepsIn_Finishes(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanLastPartition_RepsIn_Finishes(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, CandidateSet &vcand, Sink &result);
+    template <class Sink> inline void scanLastPartition_OrgsIn_Finished(unsigned int level, Timestamp b, Timestamp qend, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanLastPartition_OrgsIn_Finished(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanFirstPartition_OrgsAft_Finished(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, CandidateSet &vcand, Sink &result);
+    template <class Sink> inline void scanPartitions_OrgsAft_Finished(unsigned int level, Timestamp a, Timestamp b, PartitionId &next_from, PartitionId &next_to, CandidateSet &vcand, Sink &result);
+    template <class Sink> inline void scanFirstPartition_OrgsIn_Meets(unsigned int level, Timestamp a, Timestamp qstart, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanFirstPartition_OrgsAft_Meets(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanLastPartition_OrgsIn_Met(unsigned int level, Timestamp a, Timestamp qend, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanLastPartition_RepsIn_Met(unsigned int level, Timestamp a, Timestamp qend, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanFirstPartition_OrgsIn_Overlaps(unsigned int level, Timestamp a, Timestamp qend, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanFirstPartition_OrgsAft_Overlaps(unsigned int level, Timestamp a, Timestamp qstart, Timestamp qend, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanLastPartition_OrgsIn_Overlaps(unsigned int level, Timestamp b, pair<Timestamp, Timestamp> qdummyE, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanLastPartition_OrgsAft_Overlaps(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanFirstPartition_OrgsIn_Overlapped(unsigned int level, Timestamp a, Timestamp qend, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanFirstPartition_OrgsIn_Overlapped(unsigned int level, Timestamp a, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanFirstPartition_OrgsIn_Overlapped(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanFirstPartition_RepsIn_Overlapped(unsigned int level, Timestamp b, Timestamp qstart, Timestamp qend, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanFirstPartition_RepsIn_Overlapped(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanLastPartition_RepsIn_Overlapped(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, CandidateSet &vcand, Sink &result);
+    template <class Sink> inline void scanFirstPartition_OrgsIn_Contains(unsigned int level, Timestamp a, Timestamp qend, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanFirstPartition_OrgsIn_Contains(unsigned int level, Timestamp a, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanLastPartition_OrgsIn_Contains(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanFirstPartition_OrgsAft_Contains(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, CandidateSet &vcand, Sink &result);
+    template <class Sink> inline void scanFirstPartition_OrgsIn_Contained(unsigned int level, Timestamp a, Timestamp qend, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanFirstPartition_OrgsAft_Contained(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanFirstPartition_OrgsAft_Contained(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, CandidateSet &vcand, Sink &result);
+    template <class Sink> inline void scanFirstPartition_RepsAft_Contained(unsigned int level, Timestamp a, PartitionId &next_from, CandidateSet &vcand, Sink &result);
+    template <class Sink> inline void scanLastPartition_OrgsIn_Precedes(unsigned int level, Timestamp b, pair<Timestamp, Timestamp> qdummyE, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanLastPartition_OrgsAft_Precedes(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartitions_OrgsIn_Precedes(unsigned int level, Timestamp b, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartitions_OrgsAft_Precedes(unsigned int level, Timestamp b, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanFirstPartition_OrgsIn_Preceded(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanFirstPartition_RepsIn_Preceded(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartitions_OrgsIn_Preceded(unsigned int level, Timestamp a, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartitions_RepsIn_Preceded(unsigned int level, Timestamp a, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanFirstPartition_OrgsIn_gOverlaps(unsigned int level, Timestamp a, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanFirstPartition_OrgsIn_gOverlaps(unsigned int level, Timestamp a, Timestamp qstart, pair<Timestamp, Timestamp> qdummyE, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanFirstPartition_OrgsIn_gOverlaps(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanFirstPartition_OrgsAft_gOverlaps(unsigned int level, Timestamp a, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanFirstPartition_RepsIn_gOverlaps(unsigned int level, Timestamp a, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanFirstPartition_RepsIn_gOverlaps(unsigned int level, Timestamp a, RecordEnd qdummyS, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanFirstPartition_RepsAft_gOverlaps(unsigned int level, Timestamp a, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanPartitions_OrgsIn_gOverlaps(unsigned int level, Timestamp a, Timestamp b, PartitionId &next_from, PartitionId &next_to, Sink &result);
+    template <class Sink> inline void scanPartitions_OrgsAft_gOverlaps(unsigned int level, Timestamp a, Timestamp b, PartitionId &next_from, PartitionId &next_to, Sink &result);
+    template <class Sink> inline void scanLastPartition_OrgsIn_gOverlaps(unsigned int level, Timestamp b, pair<Timestamp, Timestamp> qdummyE, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void scanLastPartition_OrgsAft_gOverlaps(unsigned int level, Timestamp b, RecordStart qdummySE, PartitionId &next_from, Sink &result);
+    template <class Sink> inline void reportRange(PrefixAggregates *aggregates, unsigned int level, RelationId &ids, RelationIdIterator iterIStart, RelationIdIterator iterIEnd, Sink &result);
+    inline void reportRange(PrefixAggregates *aggregates, unsigned int level, RelationId &ids, RelationIdIterator iterIStart, RelationIdIterator iterIEnd, AggregateSink &result);
+    inline void reportRange(PrefixAggregates *aggregates, unsigned int level, RelationId &ids, RelationIdIterator iterIStart, RelationIdIterator iterIEnd, XorSink &result);
+    template <class Sink> inline void collectRange(PrefixAggregates *aggregates, unsigned int level, RelationId &ids, RelationIdIterator iterIStart, RelationIdIterator iterIEnd, vector<IdRange> &ranges, Sink &result);
+    inline void collectRange(PrefixAggregates *aggregates, unsigned int level, RelationId &ids, RelationIdIterator iterIStart, RelationIdIterator iterIEnd, vector<IdRange> &ranges, AggregateSink &result);
+    inline void collectRange(PrefixAggregates *aggregates, unsigned int level, RelationId &ids, RelationIdIterator iterIStart, RelationIdIterator iterIEnd, vector<IdRange> &ranges, XorSink &result);
+    template <class Sink> inline void executeBottomUp_gOverlaps(RangeQuery Q, gOverlapsSweep *sweep, Sink &result);
 
 public:
     // Construction
-    HINT_M_ALL(const Relation &R, const unsigned int numBits, const unsigned int maxBits);
+    HINT_M_ALL(const Relation &R, const unsigned int numBits, const unsigned int maxBits, const unsigned int numThreads = 1);
+    HINT_M_ALL(const char *filename);
+    void save(const char *filename);
+    void buildAggregates(const Relation &R);
+    void buildSearchLayout();
     void getStats();
+    void getRecords(Relation &R) const;
     ~HINT_M_ALL();
     
     // Querying
@@ -538,6 +681,25 @@ public:
     // Generalized predicates, ACM SIGMOD'22 gOverlaps
     size_t executeBottomUp_gOverlaps(StabbingQuery Q);
     size_t executeBottomUp_gOverlaps(RangeQuery Q);
+    void executeBottomUp_gOverlaps(const vector<RangeQuery> &queries, vector<size_t> &results);
+
+    // Querying with an explicit result sink, see containers/sinks.h
+    template <class Sink> void executeBottomUp_Equals(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_Starts(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_Started(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_Finishes(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_Finished(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_Meets(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_Met(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_Overlaps(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_Overlapped(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_Contains(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_Contained(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_Precedes(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_Preceded(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_gOverlaps(StabbingQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_gOverlaps(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_gOverlaps(const vector<RangeQuery> &queries, vector<Sink> &results);
 };
 
 
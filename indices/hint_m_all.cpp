@@ -29,10 +29,13 @@
  ******************************************************************************/
 
 #include "hint_m.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 
 
-inline void HINT_M_ALL::updateCounters(const Record &r)
+inline void HINT_M_ALL::markPartitions(const Record &r, RankBitvector *pOrgsIn_dir, RankBitvector *pOrgsAft_dir, RankBitvector *pRepsIn_dir, RankBitvector *pRepsAft_dir)
 {
     int level = 0;
     Timestamp a = r.start >> (this->maxBits-this->numBits);
@@ -49,18 +52,24 @@ inline void HINT_M_ALL::updateCounters(const Record &r)
             {
                 if ((a == b) && (!lastfound))
                 {
-                    this->pRepsIn_sizes[level][a]++;
+                    pRepsIn_dir[level].set(a);
                     lastfound = 1;
                 }
                 else
-                    this->pRepsAft_sizes[level][a]++;
+                {
+                    pRepsAft_dir[level].set(a);
+                }
             }
             else
             {
                 if ((a == b) && (!lastfound))
-                    this->pOrgsIn_sizes[level][a]++;
+                {
+                    pOrgsIn_dir[level].set(a);
+                }
                 else
-                    this->pOrgsAft_sizes[level][a]++;
+                {
+                    pOrgsAft_dir[level].set(a);
+                }
                 firstfound = 1;
             }
             a++;
@@ -72,20 +81,24 @@ inline void HINT_M_ALL::updateCounters(const Record &r)
             if ((!firstfound) && b < a)
             {
                 if (!lastfound)
-                    this->pOrgsIn_sizes[level][prevb]++;
+                {
+                    pOrgsIn_dir[level].set(prevb);
+                }
                 else
-                    this->pOrgsAft_sizes[level][prevb]++;
+                {
+                    pOrgsAft_dir[level].set(prevb);
+                }
             }
             else
             {
                 if (!lastfound)
                 {
-                    this->pRepsIn_sizes[level][prevb]++;
+                    pRepsIn_dir[level].set(prevb);
                     lastfound = 1;
                 }
                 else
                 {
-                    this->pRepsAft_sizes[level][prevb]++;
+                    pRepsAft_dir[level].set(prevb);
                 }
             }
         }
@@ -96,7 +109,7 @@ inline void HINT_M_ALL::updateCounters(const Record &r)
 }
 
 
-inline void HINT_M_ALL::updatePartitions(const Record &r)
+inline void HINT_M_ALL::updateCounters(const Record &r, RecordId **pOrgsIn_sizes, RecordId **pOrgsAft_sizes, size_t **pRepsIn_sizes, size_t **pRepsAft_sizes)
 {
     int level = 0;
     Timestamp a = r.start >> (this->maxBits-this->numBits);
@@ -113,23 +126,95 @@ inline void HINT_M_ALL::updatePartitions(const Record &r)
             {
                 if ((a == b) && (!lastfound))
                 {
-                    this->pRepsInTmp[level][this->pRepsIn_offsets[level][a]++] = RecordEnd(r.id, r.end);
+                    pRepsIn_sizes[level][this->getCounter(this->pRepsIn_dir, level, a)]++;
+                    lastfound = 1;
+                }
+                else
+                    pRepsAft_sizes[level][this->getCounter(this->pRepsAft_dir, level, a)]++;
+            }
+            else
+            {
+                if ((a == b) && (!lastfound))
+                    pOrgsIn_sizes[level][this->getCounter(this->pOrgsIn_dir, level, a)]++;
+                else
+                    pOrgsAft_sizes[level][this->getCounter(this->pOrgsAft_dir, level, a)]++;
+                firstfound = 1;
+            }
+            a++;
+        }
+        if (!(b%2))
+        { //last bit of b is 0
+            prevb = b;
+            b--;
+            if ((!firstfound) && b < a)
+            {
+                if (!lastfound)
+                    pOrgsIn_sizes[level][this->getCounter(this->pOrgsIn_dir, level, prevb)]++;
+                else
+                    pOrgsAft_sizes[level][this->getCounter(this->pOrgsAft_dir, level, prevb)]++;
+            }
+            else
+            {
+                if (!lastfound)
+                {
+                    pRepsIn_sizes[level][this->getCounter(this->pRepsIn_dir, level, prevb)]++;
                     lastfound = 1;
                 }
                 else
                 {
-                    this->pRepsAft[level][this->pRepsAft_offsets[level][a]++] = r.id;
+                    pRepsAft_sizes[level][this->getCounter(this->pRepsAft_dir, level, prevb)]++;
+                }
+            }
+        }
+        a >>= 1; // a = a div 2
+        b >>= 1; // b = b div 2
+        level++;
+    }
+}
+
+
+inline void HINT_M_ALL::updatePartitions(const Record &r, RecordId **pOrgsIn_offsets, RecordId **pOrgsAft_offsets, size_t **pRepsIn_offsets, size_t **pRepsAft_offsets)
+{
+    int level = 0;
+    Timestamp a = r.start >> (this->maxBits-this->numBits);
+    Timestamp b = r.end   >> (this->maxBits-this->numBits);
+    Timestamp prevb;
+    int firstfound = 0, lastfound = 0;
+    size_t pos;
+    
+    
+    while (level < this->height && a <= b)
+    {
+        if (a%2)
+        { //last bit of a is 1
+            if (firstfound)
+            {
+                if ((a == b) && (!lastfound))
+                {
+                    pos = pRepsIn_offsets[level][this->getCounter(this->pRepsIn_dir, level, a)]++;
+                    this->pRepsInIds[level][pos] = r.id;
+                    this->pRepsInTimestamp[level][pos] = r.end;
+                    lastfound = 1;
+                }
+                else
+                {
+                    this->pRepsAft[level][pRepsAft_offsets[level][this->getCounter(this->pRepsAft_dir, level, a)]++] = r.id;
                 }
             }
             else
             {
                 if ((a == b) && (!lastfound))
                 {
-                    this->pOrgsInTmp[level][this->pOrgsIn_offsets[level][a]++] = Record(r.id, r.start, r.end);
+                    pos = pOrgsIn_offsets[level][this->getCounter(this->pOrgsIn_dir, level, a)]++;
+                    this->pOrgsInIds[level][pos] = r.id;
+                    this->pOrgsInStarts[level][pos] = r.start;
+                    this->pOrgsInEnds[level][pos] = r.end;
                 }
                 else
                 {
-                    this->pOrgsAftTmp[level][this->pOrgsAft_offsets[level][a]++] = RecordStart(r.id, r.start);
+                    pos = pOrgsAft_offsets[level][this->getCounter(this->pOrgsAft_dir, level, a)]++;
+                    this->pOrgsAftIds[level][pos] = r.id;
+                    this->pOrgsAftTimestamp[level][pos] = r.start;
                 }
                 firstfound = 1;
             }
@@ -143,23 +228,30 @@ inline void HINT_M_ALL::updatePartitions(const Record &r)
             {
                 if (!lastfound)
                 {
-                    this->pOrgsInTmp[level][this->pOrgsIn_offsets[level][prevb]++] = Record(r.id, r.start, r.end);
+                    pos = pOrgsIn_offsets[level][this->getCounter(this->pOrgsIn_dir, level, prevb)]++;
+                    this->pOrgsInIds[level][pos] = r.id;
+                    this->pOrgsInStarts[level][pos] = r.start;
+                    this->pOrgsInEnds[level][pos] = r.end;
                 }
                 else
                 {
-                    this->pOrgsAftTmp[level][this->pOrgsAft_offsets[level][prevb]++] = RecordStart(r.id, r.start);
+                    pos = pOrgsAft_offsets[level][this->getCounter(this->pOrgsAft_dir, level, prevb)]++;
+                    this->pOrgsAftIds[level][pos] = r.id;
+                    this->pOrgsAftTimestamp[level][pos] = r.start;
                 }
             }
             else
             {
                 if (!lastfound)
                 {
-                    this->pRepsInTmp[level][this->pRepsIn_offsets[level][prevb]++] = RecordEnd(r.id, r.end);
+                    pos = pRepsIn_offsets[level][this->getCounter(this->pRepsIn_dir, level, prevb)]++;
+                    this->pRepsInIds[level][pos] = r.id;
+                    this->pRepsInTimestamp[level][pos] = r.end;
                     lastfound = 1;
                 }
                 else
                 {
-                    this->pRepsAft[level][this->pRepsAft_offsets[level][prevb]++] = r.id;
+                    this->pRepsAft[level][pRepsAft_offsets[level][this->getCounter(this->pRepsAft_dir, level, prevb)]++] = r.id;
                 }
             }
         }
@@ -170,283 +262,962 @@ inline void HINT_M_ALL::updatePartitions(const Record &r)
 }
 
 
-HINT_M_ALL::HINT_M_ALL(const Relation &R, const unsigned int numBits, const unsigned int maxBits)  : HierarchicalIndex(R, numBits, maxBits)
+// Marks the non-empty partitions of every level and class; every thread
+// marks its own slice of R in its own directories, which are then merged.
+void HINT_M_ALL::buildDirectories(const Relation &R, ThreadPool &pool)
 {
-    OffsetEntry_ALL_OrgsIn  dummySE;
-    OffsetEntry_ALL_OrgsAft dummyS;
-    OffsetEntry_ALL_RepsIn  dummyE;
-    OffsetEntry_ALL_RepsAft dummyI;
-    Offsets_ALL_OrgsIn_Iterator  iterSEO, iterSEOStart, iterSEOEnd;
-    Offsets_ALL_OrgsAft_Iterator iterSO, iterSOStart, iterSOEnd;
-    Offsets_ALL_RepsIn_Iterator  iterEO, iterEOStart, iterEOEnd;
-    Offsets_ALL_RepsAft_Iterator iterIO, iterIOBegin, iterIOEnd;
-    PartitionId tmp = -1;
+    const unsigned int numThreads = pool.size();
+    vector<RankBitvector *> vOrgsIn_dir(numThreads), vOrgsAft_dir(numThreads), vRepsIn_dir(numThreads), vRepsAft_dir(numThreads);
     
+    for (auto t = 0; t < numThreads; t++)
+    {
+        vOrgsIn_dir[t]  = new RankBitvector[this->height];
+        vOrgsAft_dir[t] = new RankBitvector[this->height];
+        vRepsIn_dir[t]  = new RankBitvector[this->height];
+        vRepsAft_dir[t] = new RankBitvector[this->height];
+        for (auto l = 0; l < this->height; l++)
+        {
+            auto cnt = (int)(pow(2, this->numBits-l));
+            
+            vOrgsIn_dir[t][l].init(cnt);
+            vOrgsAft_dir[t][l].init(cnt);
+            vRepsIn_dir[t][l].init(cnt);
+            vRepsAft_dir[t][l].init(cnt);
+        }
+    }
+    
+    pool.run([&](const unsigned int t)
+    {
+        size_t from = R.size()*t/numThreads, to = R.size()*(t+1)/numThreads;
+        
+        for (auto i = from; i < to; i++)
+            this->markPartitions(R[i], vOrgsIn_dir[t], vOrgsAft_dir[t], vRepsIn_dir[t], vRepsAft_dir[t]);
+    });
+    
+    this->pOrgsIn_dir  = vOrgsIn_dir[0];
+    this->pOrgsAft_dir = vOrgsAft_dir[0];
+    this->pRepsIn_dir  = vRepsIn_dir[0];
+    this->pRepsAft_dir = vRepsAft_dir[0];
+    for (auto l = 0; l < this->height; l++)
+    {
+        auto merge = [&](vector<RankBitvector *> &vDir)
+        {
+            for (auto t = 1; t < numThreads; t++)
+            {
+                for (auto w = 0; w < vDir[0][l].words.size(); w++)
+                    vDir[0][l].words[w] |= vDir[t][l].words[w];
+            }
+            vDir[0][l].buildRank();
+        };
+        
+        merge(vOrgsIn_dir);
+        merge(vOrgsAft_dir);
+        merge(vRepsIn_dir);
+        merge(vRepsAft_dir);
+    }
+    
+    for (auto t = 1; t < numThreads; t++)
+    {
+        delete[] vOrgsIn_dir[t];
+        delete[] vOrgsAft_dir[t];
+        delete[] vRepsIn_dir[t];
+        delete[] vRepsAft_dir[t];
+    }
+}
+
+
+// Builds the index using numThreads threads; every step splits its work into
+// one slice per thread, and the records of every thread are placed after
+// those of the threads before it, in each partition, so the index is the
+// same as the one built by a single thread.
+HINT_M_ALL::HINT_M_ALL(const Relation &R, const unsigned int numBits, const unsigned int maxBits, const unsigned int numThreads)  : HierarchicalIndex(R, numBits, maxBits)
+{
+    ThreadPool pool(numThreads);
+    vector<RecordId **> vOrgsIn_sizes(numThreads), vOrgsAft_sizes(numThreads);
+    vector<size_t **>   vRepsIn_sizes(numThreads), vRepsAft_sizes(numThreads);
+    
+    
+    this->pOrgsInAggregates = this->pOrgsAftAggregates = this->pRepsInAggregates = this->pRepsAftAggregates = NULL;
+    this->pOrgsIn_dir = this->pOrgsAft_dir = this->pRepsIn_dir = this->pRepsAft_dir = NULL;
+    this->mapping     = NULL;
+    this->mappingSize = 0;
+    this->regions     = NULL;
+    
+    // Step 1: count the contents of each partition; every thread counts its
+    // own slice of R in its own counters, the last one directly in the
+    // offsets. The partitions of every level and class are marked first, so
+    // the counters are kept only for the non-empty ones and no array of the
+    // build is sized by the domain, see buildDirectories().
+    this->buildDirectories(R, pool);
     
-    // Step 1: one pass to count the contents inside each partition.
-    this->pOrgsIn_sizes  = (RecordId **)malloc(this->height*sizeof(RecordId *));
-    this->pOrgsAft_sizes = (RecordId **)malloc(this->height*sizeof(RecordId *));
-    this->pRepsIn_sizes  = (size_t **)malloc(this->height*sizeof(size_t *));
-    this->pRepsAft_sizes = (size_t **)malloc(this->height*sizeof(size_t *));
     this->pOrgsIn_offsets  = (RecordId **)malloc(this->height*sizeof(RecordId *));
     this->pOrgsAft_offsets = (RecordId **)malloc(this->height*sizeof(RecordId *));
     this->pRepsIn_offsets  = (size_t **)malloc(this->height*sizeof(size_t *));
     this->pRepsAft_offsets = (size_t **)malloc(this->height*sizeof(size_t *));
-    
     for (auto l = 0; l < this->height; l++)
     {
-        auto cnt = (int)(pow(2, this->numBits-l));
-        
         //calloc allocates memory and sets each counter to 0
-        this->pOrgsIn_sizes[l]  = (RecordId *)calloc(cnt, sizeof(RecordId));
-        this->pOrgsAft_sizes[l] = (RecordId *)calloc(cnt, sizeof(RecordId));
-        this->pRepsIn_sizes[l]  = (size_t *)calloc(cnt, sizeof(size_t));
-        this->pRepsAft_sizes[l] = (size_t *)calloc(cnt, sizeof(size_t));
-        this->pOrgsIn_offsets[l]  = (RecordId *)calloc(cnt+1, sizeof(RecordId));
-        this->pOrgsAft_offsets[l] = (RecordId *)calloc(cnt+1, sizeof(RecordId));
-        this->pRepsIn_offsets[l]  = (size_t *)calloc(cnt+1, sizeof(size_t));
-        this->pRepsAft_offsets[l] = (size_t *)calloc(cnt+1, sizeof(size_t));
+        this->pOrgsIn_offsets[l]  = (RecordId *)calloc(this->getNumCounters(this->pOrgsIn_dir, l)+1, sizeof(RecordId));
+        this->pOrgsAft_offsets[l] = (RecordId *)calloc(this->getNumCounters(this->pOrgsAft_dir, l)+1, sizeof(RecordId));
+        this->pRepsIn_offsets[l]  = (size_t *)calloc(this->getNumCounters(this->pRepsIn_dir, l)+1, sizeof(size_t));
+        this->pRepsAft_offsets[l] = (size_t *)calloc(this->getNumCounters(this->pRepsAft_dir, l)+1, sizeof(size_t));
+    }
+    vOrgsIn_sizes[numThreads-1]  = this->pOrgsIn_offsets;
+    vOrgsAft_sizes[numThreads-1] = this->pOrgsAft_offsets;
+    vRepsIn_sizes[numThreads-1]  = this->pRepsIn_offsets;
+    vRepsAft_sizes[numThreads-1] = this->pRepsAft_offsets;
+    for (auto t = 0; t < numThreads-1; t++)
+    {
+        vOrgsIn_sizes[t]  = (RecordId **)malloc(this->height*sizeof(RecordId *));
+        vOrgsAft_sizes[t] = (RecordId **)malloc(this->height*sizeof(RecordId *));
+        vRepsIn_sizes[t]  = (size_t **)malloc(this->height*sizeof(size_t *));
+        vRepsAft_sizes[t] = (size_t **)malloc(this->height*sizeof(size_t *));
+        for (auto l = 0; l < this->height; l++)
+        {
+            vOrgsIn_sizes[t][l]  = (RecordId *)calloc(this->getNumCounters(this->pOrgsIn_dir, l), sizeof(RecordId));
+            vOrgsAft_sizes[t][l] = (RecordId *)calloc(this->getNumCounters(this->pOrgsAft_dir, l), sizeof(RecordId));
+            vRepsIn_sizes[t][l]  = (size_t *)calloc(this->getNumCounters(this->pRepsIn_dir, l), sizeof(size_t));
+            vRepsAft_sizes[t][l] = (size_t *)calloc(this->getNumCounters(this->pRepsAft_dir, l), sizeof(size_t));
+        }
     }
     
-    for (const Record &r : R)
-        this->updateCounters(r);
+    pool.run([&](const unsigned int t)
+    {
+        size_t from = R.size()*t/numThreads, to = R.size()*(t+1)/numThreads;
+        
+        for (auto i = from; i < to; i++)
+            this->updateCounters(R[i], vOrgsIn_sizes[t], vOrgsAft_sizes[t], vRepsIn_sizes[t], vRepsAft_sizes[t]);
+    });
     
     
-    // Step 2: allocate necessary memory.
-    this->pOrgsInTmp  = new Relation[this->height];
-    this->pOrgsAftTmp = new RelationStart[this->height];
-    this->pRepsInTmp  = new RelationEnd[this->height];
+    // Step 2: compute the positions where every thread places its records and
+    // allocate the id- and timestamp-dedicated arrays. First, the counters of
+    // the threads become their running sums, so the last one holds the size
+    // of the partition; then, the prefix sums of the sizes are computed per
+    // slice of the partitions, shifted by the sums of the slices before, and
+    // every thread gets the sum before it added to them as its position.
+    this->pOrgsInIds  = new RelationId[this->height];
+    this->pOrgsAftIds = new RelationId[this->height];
+    this->pRepsInIds  = new RelationId[this->height];
     this->pRepsAft    = new RelationId[this->height];
+    this->pOrgsInStarts     = new TimestampArray[this->height];
+    this->pOrgsInEnds       = new TimestampArray[this->height];
+    this->pOrgsAftTimestamp = new TimestampArray[this->height];
+    this->pRepsInTimestamp  = new TimestampArray[this->height];
+    for (auto l = 0; l < this->height; l++)
+    {
+        auto toPositions = [&](auto &vSizes, const size_t cnt)
+        {
+            vector<size_t> sum(numThreads+1, 0);
+            
+            pool.run([&](const unsigned int t)
+            {
+                size_t from = cnt*t/numThreads, to = cnt*(t+1)/numThreads;
+                
+                for (auto k = from; k < to; k++)
+                {
+                    for (auto tt = 1; tt < numThreads; tt++)
+                        vSizes[tt][l][k] += vSizes[tt-1][l][k];
+                    sum[t+1] += vSizes[numThreads-1][l][k];
+                }
+            });
+            
+            for (auto t = 0; t < numThreads; t++)
+                sum[t+1] += sum[t];
+            
+            pool.run([&](const unsigned int t)
+            {
+                size_t from = cnt*t/numThreads, to = cnt*(t+1)/numThreads;
+                size_t s = sum[t];
+                
+                for (auto k = from; k < to; k++)
+                {
+                    auto c = vSizes[numThreads-1][l][k];
+                    
+                    for (auto tt = numThreads-1; tt > 0; tt--)
+                        vSizes[tt][l][k] = s+vSizes[tt-1][l][k];
+                    vSizes[0][l][k] = s;
+                    s += c;
+                }
+            });
+            
+            return sum[numThreads];
+        };
+        size_t n;
+        
+        n = toPositions(vOrgsIn_sizes, this->getNumCounters(this->pOrgsIn_dir, l));
+        this->pOrgsInIds[l].resize(n);
+        this->pOrgsInStarts[l].resize(n);
+        this->pOrgsInEnds[l].resize(n);
+        n = toPositions(vOrgsAft_sizes, this->getNumCounters(this->pOrgsAft_dir, l));
+        this->pOrgsAftIds[l].resize(n);
+        this->pOrgsAftTimestamp[l].resize(n);
+        n = toPositions(vRepsIn_sizes, this->getNumCounters(this->pRepsIn_dir, l));
+        this->pRepsInIds[l].resize(n);
+        this->pRepsInTimestamp[l].resize(n);
+        n = toPositions(vRepsAft_sizes, this->getNumCounters(this->pRepsAft_dir, l));
+        this->pRepsAft[l].resize(n);
+    }
+    
+    
+    // Step 3: fill partitions; every thread places its own slice of R
+    // directly in the final arrays.
+    pool.run([&](const unsigned int t)
+    {
+        size_t from = R.size()*t/numThreads, to = R.size()*(t+1)/numThreads;
+        
+        for (auto i = from; i < to; i++)
+            this->updatePartitions(R[i], vOrgsIn_sizes[t], vOrgsAft_sizes[t], vRepsIn_sizes[t], vRepsAft_sizes[t]);
+    });
     
+    // The positions of the last thread have moved to the start of the next
+    // partition, so shifting them by one gives the offsets; the classes that
+    // kept all partitions are then compacted as the rest.
+    for (auto t = 0; t < numThreads-1; t++)
+    {
+        for (auto l = 0; l < this->height; l++)
+        {
+            free(vOrgsIn_sizes[t][l]);
+            free(vOrgsAft_sizes[t][l]);
+            free(vRepsIn_sizes[t][l]);
+            free(vRepsAft_sizes[t][l]);
+        }
+        free(vOrgsIn_sizes[t]);
+        free(vOrgsAft_sizes[t]);
+        free(vRepsIn_sizes[t]);
+        free(vRepsAft_sizes[t]);
+    }
     for (auto l = 0; l < this->height; l++)
     {
-        auto cnt = (int)(pow(2, this->numBits-l));
-        size_t sumOin = 0, sumOaft = 0, sumRin = 0, sumRaft = 0;
+        auto shift = [](auto offsets, const size_t cnt)
+        {
+            memmove(offsets+1, offsets, cnt*sizeof(offsets[0]));
+            offsets[0] = 0;
+        };
         
-        for (auto pId = 0; pId < cnt; pId++)
+        shift(this->pOrgsIn_offsets[l], this->getNumCounters(this->pOrgsIn_dir, l));
+        shift(this->pOrgsAft_offsets[l], this->getNumCounters(this->pOrgsAft_dir, l));
+        shift(this->pRepsIn_offsets[l], this->getNumCounters(this->pRepsIn_dir, l));
+        shift(this->pRepsAft_offsets[l], this->getNumCounters(this->pRepsAft_dir, l));
+    }
+    
+    
+    // Step 4: sort partition contents; every thread sorts the partitions
+    // starting in its slice of the contents of a level, so that the threads
+    // get about the same number of records, whatever the partition sizes.
+    // The records of a partition are gathered from the final arrays, sorted
+    // and put back, so that only one partition is copied at any time. Large
+    // partitions are radix sorted on the bits of their timestamps below
+    // those of the partition, see containers/radixsort.h.
+    pool.run([&](const unsigned int t)
+    {
+        Relation      orgsIn;
+        RelationStart orgsAft;
+        RelationEnd   repsIn;
+        
+        for (auto l = 0; l < this->height; l++)
         {
-            this->pOrgsIn_offsets[l][pId]  = sumOin;
-            this->pOrgsAft_offsets[l][pId] = sumOaft;
-            this->pRepsIn_offsets[l][pId]  = sumRin;
-            this->pRepsAft_offsets[l][pId] = sumRaft;
-            sumOin  += this->pOrgsIn_sizes[l][pId];
-            sumOaft += this->pOrgsAft_sizes[l][pId];
-            sumRin  += this->pRepsIn_sizes[l][pId];
-            sumRaft += this->pRepsAft_sizes[l][pId];
+            unsigned int bits = this->maxBits-this->numBits+l;
+            uint64_t mask = (((uint64_t)1) << bits)-1;
+            auto getSlice = [&](auto offsets, const size_t cnt, size_t &from, size_t &to)
+            {
+                from = lower_bound(offsets, offsets+cnt, (size_t)offsets[cnt]*t/numThreads)-offsets;
+                to   = (t == numThreads-1)? cnt: lower_bound(offsets, offsets+cnt, (size_t)offsets[cnt]*(t+1)/numThreads)-offsets;
+            };
+            size_t from, to;
+            
+            // Both the start and the end of an In original are in the partition
+            getSlice(this->pOrgsIn_offsets[l], this->pOrgsIn_dir[l].getNumSetBits(), from, to);
+            for (auto k = from; k < to; k++)
+            {
+                size_t first = this->pOrgsIn_offsets[l][k], n = this->pOrgsIn_offsets[l][k+1]-first;
+                
+                if (n < 2)
+                    continue;
+                
+                orgsIn.resize(n);
+                for (auto j = 0; j < n; j++)
+                    orgsIn[j] = Record(this->pOrgsInIds[l][first+j], this->pOrgsInStarts[l][first+j], this->pOrgsInEnds[l][first+j]);
+                sortPartition(orgsIn.data(), orgsIn.data()+n, 2*bits, [&](const Record &r) {return (((r.start & mask) << bits) | (r.end & mask));});
+                for (auto j = 0; j < n; j++)
+                {
+                    this->pOrgsInIds[l][first+j] = orgsIn[j].id;
+                    this->pOrgsInStarts[l][first+j] = orgsIn[j].start;
+                    this->pOrgsInEnds[l][first+j] = orgsIn[j].end;
+                }
+            }
+            
+            getSlice(this->pOrgsAft_offsets[l], this->pOrgsAft_dir[l].getNumSetBits(), from, to);
+            for (auto k = from; k < to; k++)
+            {
+                size_t first = this->pOrgsAft_offsets[l][k], n = this->pOrgsAft_offsets[l][k+1]-first;
+                
+                if (n < 2)
+                    continue;
+                
+                orgsAft.resize(n);
+                for (auto j = 0; j < n; j++)
+                    orgsAft[j] = RecordStart(this->pOrgsAftIds[l][first+j], this->pOrgsAftTimestamp[l][first+j]);
+                sortPartition(orgsAft.data(), orgsAft.data()+n, bits, [&](const RecordStart &r) {return (r.start & mask);});
+                for (auto j = 0; j < n; j++)
+                {
+                    this->pOrgsAftIds[l][first+j] = orgsAft[j].id;
+                    this->pOrgsAftTimestamp[l][first+j] = orgsAft[j].start;
+                }
+            }
+            
+            getSlice(this->pRepsIn_offsets[l], this->pRepsIn_dir[l].getNumSetBits(), from, to);
+            for (auto k = from; k < to; k++)
+            {
+                size_t first = this->pRepsIn_offsets[l][k], n = this->pRepsIn_offsets[l][k+1]-first;
+                
+                if (n < 2)
+                    continue;
+                
+                repsIn.resize(n);
+                for (auto j = 0; j < n; j++)
+                    repsIn[j] = RecordEnd(this->pRepsInIds[l][first+j], this->pRepsInTimestamp[l][first+j]);
+                sortPartition(repsIn.data(), repsIn.data()+n, bits, [&](const RecordEnd &r) {return (r.end & mask);});
+                for (auto j = 0; j < n; j++)
+                {
+                    this->pRepsInIds[l][first+j] = repsIn[j].id;
+                    this->pRepsInTimestamp[l][first+j] = repsIn[j].end;
+                }
+            }
         }
-        this->pOrgsIn_offsets[l][cnt]  = sumOin;
-        this->pOrgsAft_offsets[l][cnt] = sumOaft;
-        this->pRepsIn_offsets[l][cnt]  = sumRin;
-        this->pRepsAft_offsets[l][cnt] = sumRaft;
+    });
+    
+    
+    // Step 5: create offset pointers
+    this->buildOffsets(pool);
+}
+
+
+// Turns the offsets of all partitions of a level and class, as restored by
+// getPartitionOffsets() for an update, into the ones of its non-empty
+// partitions, with their directory, as buildOffsets() takes them; the
+// offsets are compacted in place.
+void HINT_M_ALL::compactOffsets()
+{
+    auto compact = [&](auto &offsets, RankBitvector &dir, const size_t cnt)
+    {
+        size_t k = 0;
+        
+        if (!dir.empty())
+            return;
         
-        this->pOrgsInTmp[l].resize(sumOin);
-        this->pOrgsAftTmp[l].resize(sumOaft);
-        this->pRepsInTmp[l].resize(sumRin);
-        this->pRepsAft[l].resize(sumRaft);
+        dir.init(cnt);
+        for (size_t pId = 0; pId < cnt; pId++)
+        {
+            if (offsets[pId+1] > offsets[pId])
+            {
+                dir.set(pId);
+                offsets[k++] = offsets[pId];
+            }
+        }
+        offsets[k] = offsets[cnt];
+        dir.buildRank();
+        offsets = (decltype(&offsets[0]))realloc(offsets, (k+1)*sizeof(offsets[0]));
+    };
+    
+    
+    if (this->pOrgsIn_dir == NULL)
+    {
+        this->pOrgsIn_dir  = new RankBitvector[this->height];
+        this->pOrgsAft_dir = new RankBitvector[this->height];
+        this->pRepsIn_dir  = new RankBitvector[this->height];
+        this->pRepsAft_dir = new RankBitvector[this->height];
     }
+    for (auto l = 0; l < this->height; l++)
+    {
+        auto cnt = (int)(pow(2, this->numBits-l));
+        
+        compact(this->pOrgsIn_offsets[l], this->pOrgsIn_dir[l], cnt);
+        compact(this->pOrgsAft_offsets[l], this->pOrgsAft_dir[l], cnt);
+        compact(this->pRepsIn_offsets[l], this->pRepsIn_dir[l], cnt);
+        compact(this->pRepsAft_offsets[l], this->pRepsAft_dir[l], cnt);
+    }
+}
+
+
+// Creates the offsets of every level from the offsets of its non-empty
+// partitions, pOrgsIn_offsets etc., and their directories, which become the
+// directories of the offsets; the levels are built top-down, as the vertical
+// pointers of a level point in the level above. Every thread takes a slice of
+// the partitions of the level, and finds where to put their entries by rank.
+// The offsets of the partitions and the directories are freed as consumed.
+void HINT_M_ALL::buildOffsets(ThreadPool &pool)
+{
+    const unsigned int numThreads = pool.size();
+    
+    
+    this->pOrgsIn_ioffsets  = new Offsets_ALL_OrgsIn[this->height];
+    this->pOrgsAft_ioffsets = new Offsets_ALL_OrgsAft[this->height];
+    this->pRepsIn_ioffsets  = new Offsets_ALL_RepsIn[this->height];
+    this->pRepsAft_ioffsets = new Offsets_ALL_RepsAft[this->height];
+    for (int l = this->height-1; l > -1; l--)
+    {
+        auto cnt = (int)(pow(2, this->numBits-l));
+        RecordId *pOrgsIn_offsets  = this->pOrgsIn_offsets[l];
+        RecordId *pOrgsAft_offsets = this->pOrgsAft_offsets[l];
+        size_t   *pRepsIn_offsets  = this->pRepsIn_offsets[l];
+        size_t   *pRepsAft_offsets = this->pRepsAft_offsets[l];
+        const RankBitvector &dirOin = this->pOrgsIn_dir[l], &dirOaft = this->pOrgsAft_dir[l], &dirRin = this->pRepsIn_dir[l], &dirRaft = this->pRepsAft_dir[l];
+        size_t numNonEmpty = 0;
+        
+        this->pOrgsIn_ioffsets[l].setBase(this->pOrgsInIds[l].begin(), this->pOrgsInStarts[l].begin());
+        this->pOrgsAft_ioffsets[l].setBase(this->pOrgsAftIds[l].begin(), this->pOrgsAftTimestamp[l].begin());
+        this->pRepsIn_ioffsets[l].setBase(this->pRepsInIds[l].begin(), this->pRepsInTimestamp[l].begin());
+        this->pRepsAft_ioffsets[l].setBase(this->pRepsAft[l].begin());
+        this->pOrgsIn_ioffsets[l].resize(dirOin.getNumSetBits());
+        this->pOrgsAft_ioffsets[l].resize(dirOaft.getNumSetBits());
+        this->pRepsIn_ioffsets[l].resize(dirRin.getNumSetBits());
+        this->pRepsAft_ioffsets[l].resize(dirRaft.getNumSetBits());
+        
+        pool.run([&](const unsigned int t)
+        {
+            OffsetEntry_ALL_OrgsIn  dummySE;
+            OffsetEntry_ALL_OrgsAft dummyS;
+            OffsetEntry_ALL_RepsIn  dummyE;
+            OffsetEntry_ALL_RepsAft dummyI;
+            Offsets_ALL_OrgsIn_Iterator  iterSEO, iterSEOStart, iterSEOEnd;
+            Offsets_ALL_OrgsAft_Iterator iterSO, iterSOStart, iterSOEnd;
+            Offsets_ALL_RepsIn_Iterator  iterEO, iterEOStart, iterEOEnd;
+            Offsets_ALL_RepsAft_Iterator iterIO, iterIOBegin, iterIOEnd;
+            PartitionId tmp = -1;
+            PartitionId from = (size_t)cnt*t/numThreads, to = (size_t)cnt*(t+1)/numThreads;
+            
+            for (size_t k = dirOin.rank(from), pId = dirOin.nextSetBit(from); pId < to; k++, pId = dirOin.nextSetBit(pId+1))
+            {
+                dummySE.tstamp = pId >> 1;//((pId >> (this->maxBits-this->numBits)) >> 1);
+                tmp = -1;
+                if (l < this->height-1)
+                {
+                    iterSEOStart = this->pOrgsIn_ioffsets[l+1].begin();
+                    iterSEOEnd = this->pOrgsIn_ioffsets[l+1].end();
+                    iterSEO = lower_bound(iterSEOStart, iterSEOEnd, dummySE);//, CompareStartEndOffesetsByTimestamp_WithCM);
+                    tmp = (iterSEO != iterSEOEnd)? (iterSEO-iterSEOStart): -1;
+                }
+                this->pOrgsIn_ioffsets[l].set(k, OffsetEntry_ALL_OrgsIn(pId, this->pOrgsInIds[l].begin()+pOrgsIn_offsets[k], this->pOrgsInStarts[l].begin()+pOrgsIn_offsets[k], tmp));
+            }
+            
+            for (size_t k = dirOaft.rank(from), pId = dirOaft.nextSetBit(from); pId < to; k++, pId = dirOaft.nextSetBit(pId+1))
+            {
+                dummyS.tstamp = pId >> 1;//((pId >> (this->maxBits-this->numBits)) >> 1);
+                tmp = -1;
+                if (l < this->height-1)
+                {
+                    iterSOStart = this->pOrgsAft_ioffsets[l+1].begin();
+                    iterSOEnd = this->pOrgsAft_ioffsets[l+1].end();
+                    iterSO = lower_bound(iterSOStart, iterSOEnd, dummyS);//, CompareStartOffesetsByTimestamp_WithCM);
+                    tmp = (iterSO != iterSOEnd)? (iterSO-iterSOStart): -1;
+                }
+                this->pOrgsAft_ioffsets[l].set(k, OffsetEntry_ALL_OrgsAft(pId, this->pOrgsAftIds[l].begin()+pOrgsAft_offsets[k], this->pOrgsAftTimestamp[l].begin()+pOrgsAft_offsets[k], tmp));
+            }
+            
+            for (size_t k = dirRin.rank(from), pId = dirRin.nextSetBit(from); pId < to; k++, pId = dirRin.nextSetBit(pId+1))
+            {
+                dummyE.tstamp = pId >> 1;//((pId >> (this->maxBits-this->numBits)) >> 1);
+                tmp = -1;
+                if (l < this->height-1)
+                {
+                    iterEOStart = this->pRepsIn_ioffsets[l+1].begin();
+                    iterEOEnd = this->pRepsIn_ioffsets[l+1].end();
+                    iterEO = lower_bound(iterEOStart, iterEOEnd, dummyE);//, CompareEndOffesetsByTimestamp_WithCM);
+                    tmp = (iterEO != iterEOEnd)? (iterEO-iterEOStart): -1;
+                }
+                this->pRepsIn_ioffsets[l].set(k, OffsetEntry_ALL_RepsIn(pId, this->pRepsInIds[l].begin()+pRepsIn_offsets[k], this->pRepsInTimestamp[l].begin()+pRepsIn_offsets[k], tmp));
+            }
+            
+            for (size_t k = dirRaft.rank(from), pId = dirRaft.nextSetBit(from); pId < to; k++, pId = dirRaft.nextSetBit(pId+1))
+            {
+                dummyI.tstamp = pId >> 1;//((pId >> (this->maxBits-this->numBits)) >> 1);
+                tmp = -1;
+                if (l < this->height-1)
+                {
+                    iterIOBegin = this->pRepsAft_ioffsets[l+1].begin();
+                    iterIOEnd = this->pRepsAft_ioffsets[l+1].end();
+                    iterIO = lower_bound(iterIOBegin, iterIOEnd, dummyI);//, CompareIdOffesetsByTimestamp);
+                    tmp = (iterIO != iterIOEnd)? (iterIO-iterIOBegin): -1;
+                }
+                this->pRepsAft_ioffsets[l].set(k, OffsetEntry_ALL_RepsAft(pId, this->pRepsAft[l].begin()+pRepsAft_offsets[k], tmp));
+            }
+        });
+        
+        // A partition is empty if it is empty in every class
+        for (auto w = 0; w < dirOin.words.size(); w++)
+            numNonEmpty += popcount64(dirOin.words[w] | dirOaft.words[w] | dirRin.words[w] | dirRaft.words[w]);
+        this->numEmptyPartitions += cnt-numNonEmpty;
+        
+        // The directories of the level index its offsets from now on
+        this->pOrgsIn_ioffsets[l].dir.swap(this->pOrgsIn_dir[l]);
+        this->pOrgsAft_ioffsets[l].dir.swap(this->pOrgsAft_dir[l]);
+        this->pRepsIn_ioffsets[l].dir.swap(this->pRepsIn_dir[l]);
+        this->pRepsAft_ioffsets[l].dir.swap(this->pRepsAft_dir[l]);
+        free(pOrgsIn_offsets);
+        free(pOrgsAft_offsets);
+        free(pRepsIn_offsets);
+        free(pRepsAft_offsets);
+    }
+    
+    free(this->pOrgsIn_offsets);
+    free(this->pOrgsAft_offsets);
+    free(this->pRepsIn_offsets);
+    free(this->pRepsAft_offsets);
+    delete[] this->pOrgsIn_dir;
+    delete[] this->pOrgsAft_dir;
+    delete[] this->pRepsIn_dir;
+    delete[] this->pRepsAft_dir;
+    this->pOrgsIn_dir = this->pOrgsAft_dir = this->pRepsIn_dir = this->pRepsAft_dir = NULL;
+}
+
+
+// Builds the prefix aggregates of every level and partition class; R must be
+// the relation the index was built on.
+void HINT_M_ALL::buildAggregates(const Relation &R)
+{
+    delete[] this->pOrgsInAggregates;
+    delete[] this->pOrgsAftAggregates;
+    delete[] this->pRepsInAggregates;
+    delete[] this->pRepsAftAggregates;
+    
+    this->pOrgsInAggregates  = new PrefixAggregates[this->height];
+    this->pOrgsAftAggregates = new PrefixAggregates[this->height];
+    this->pRepsInAggregates  = new PrefixAggregates[this->height];
+    this->pRepsAftAggregates = new PrefixAggregates[this->height];
+    for (auto l = 0; l < this->height; l++)
+    {
+        this->pOrgsInAggregates[l].build(this->pOrgsInIds[l], R);
+        this->pOrgsAftAggregates[l].build(this->pOrgsAftIds[l], R);
+        this->pRepsInAggregates[l].build(this->pRepsInIds[l], R);
+        this->pRepsAftAggregates[l].build(this->pRepsAft[l], R);
+    }
+}
+
+
+// Builds the search tree on the offsets of every level and partition
+// class, used instead of the binary searches over the offsets.
+void HINT_M_ALL::buildSearchLayout()
+{
+    for (auto l = 0; l < this->height; l++)
+    {
+        this->pOrgsIn_ioffsets[l].buildSearchTree();
+        this->pOrgsAft_ioffsets[l].buildSearchTree();
+        this->pRepsIn_ioffsets[l].buildSearchTree();
+        this->pRepsAft_ioffsets[l].buildSearchTree();
+    }
+}
+
+
+// Appends the indexed records to R. Every record is an original in exactly
+// one partition, and its end is kept in exactly one of the classes "in", as
+// an original or as a replica; hence, the originals "in" are whole records,
+// and the originals "after" are matched by id with the replicas "in".
+void HINT_M_ALL::getRecords(Relation &R) const
+{
+    RelationStart orgsAft;
+    RelationEnd   repsIn;
     
     
-    // Step 3: fill partitions.
-    for (const Record &r : R)
-        this->updatePartitions(r);
+    for (auto l = 0; l < this->height; l++)
+    {
+        for (auto j = 0; j < this->pOrgsInIds[l].size(); j++)
+            R.push_back(Record(this->pOrgsInIds[l][j], this->pOrgsInStarts[l][j], this->pOrgsInEnds[l][j]));
+        for (auto j = 0; j < this->pOrgsAftIds[l].size(); j++)
+            orgsAft.push_back(RecordStart(this->pOrgsAftIds[l][j], this->pOrgsAftTimestamp[l][j]));
+        for (auto j = 0; j < this->pRepsInIds[l].size(); j++)
+            repsIn.push_back(RecordEnd(this->pRepsInIds[l][j], this->pRepsInTimestamp[l][j]));
+    }
+    
+    sort(orgsAft.begin(), orgsAft.end(), [](const RecordStart &lhs, const RecordStart &rhs) {return (lhs.id < rhs.id);});
+    sort(repsIn.begin(), repsIn.end(), [](const RecordEnd &lhs, const RecordEnd &rhs) {return (lhs.id < rhs.id);});
+    for (auto j = 0; j < orgsAft.size(); j++)
+        R.push_back(Record(orgsAft[j].id, orgsAft[j].start, repsIn[j].end));
+}
+
+
+// Merges the delta buffer in the partitions. The partitions of a level lie
+// contiguously in its arrays, so every array is moved once, back to front,
+// opening a gap at the end of every partition that gets new records; the
+// gaps are filled as in the construction, the new records of a partition are
+// sorted and merged with the old ones, and the offsets are rebuilt. Hence,
+// a merge costs about as much as moving the index, amortized over the
+// capacity of the buffer. The prefix aggregates are dropped; call
+// buildAggregates() again to use them.
+void HINT_M_ALL::mergeDelta()
+{
+    const Relation &D = this->delta.records;
+    RecordId **pOrgsIn_sizes  = (RecordId **)malloc(this->height*sizeof(RecordId *));
+    RecordId **pOrgsAft_sizes = (RecordId **)malloc(this->height*sizeof(RecordId *));
+    size_t   **pRepsIn_sizes  = (size_t **)malloc(this->height*sizeof(size_t *));
+    size_t   **pRepsAft_sizes = (size_t **)malloc(this->height*sizeof(size_t *));
+    bool hasSearchLayout = false;
     
     
-    // Step 4: sort partition contents; first need to reset the offsets
+    // Step 1: one pass to count the new contents of each partition
     for (auto l = 0; l < this->height; l++)
     {
         auto cnt = (int)(pow(2, this->numBits-l));
-        size_t sumOin = 0, sumOaft = 0, sumRin = 0, sumRaft = 0;
         
-        for (auto pId = 0; pId < cnt; pId++)
-        {
-            this->pOrgsIn_offsets[l][pId]  = sumOin;
-            this->pOrgsAft_offsets[l][pId] = sumOaft;
-            this->pRepsIn_offsets[l][pId]  = sumRin;
-            this->pRepsAft_offsets[l][pId] = sumRaft;
-            sumOin  += this->pOrgsIn_sizes[l][pId];
-            sumOaft += this->pOrgsAft_sizes[l][pId];
-            sumRin  += this->pRepsIn_sizes[l][pId];
-            sumRaft += this->pRepsAft_sizes[l][pId];
-        }
-        this->pOrgsIn_offsets[l][cnt]  = sumOin;
-        this->pOrgsAft_offsets[l][cnt] = sumOaft;
-        this->pRepsIn_offsets[l][cnt]  = sumRin;
-        this->pRepsAft_offsets[l][cnt] = sumRaft;
+        pOrgsIn_sizes[l]  = (RecordId *)calloc(cnt, sizeof(RecordId));
+        pOrgsAft_sizes[l] = (RecordId *)calloc(cnt, sizeof(RecordId));
+        pRepsIn_sizes[l]  = (size_t *)calloc(cnt, sizeof(size_t));
+        pRepsAft_sizes[l] = (size_t *)calloc(cnt, sizeof(size_t));
     }
+    for (const Record &r : D)
+        this->updateCounters(r, pOrgsIn_sizes, pOrgsAft_sizes, pRepsIn_sizes, pRepsAft_sizes);
+    
     
+    // Step 2: open the gaps; the offsets of a partition become the position
+    // of its gap, i.e., where its new records are placed
+    this->pOrgsIn_offsets  = (RecordId **)malloc(this->height*sizeof(RecordId *));
+    this->pOrgsAft_offsets = (RecordId **)malloc(this->height*sizeof(RecordId *));
+    this->pRepsIn_offsets  = (size_t **)malloc(this->height*sizeof(size_t *));
+    this->pRepsAft_offsets = (size_t **)malloc(this->height*sizeof(size_t *));
     for (auto l = 0; l < this->height; l++)
     {
         auto cnt = (int)(pow(2, this->numBits-l));
-        for (auto pId = 0; pId < cnt; pId++)
+        auto toPositions = [&](auto offsets, auto sizes)
         {
-            sort(this->pOrgsInTmp[l].begin()+this->pOrgsIn_offsets[l][pId], this->pOrgsInTmp[l].begin()+this->pOrgsIn_offsets[l][pId+1]);
-            sort(this->pOrgsAftTmp[l].begin()+this->pOrgsAft_offsets[l][pId], this->pOrgsAftTmp[l].begin()+this->pOrgsAft_offsets[l][pId+1]);
-            sort(this->pRepsInTmp[l].begin()+this->pRepsIn_offsets[l][pId], this->pRepsInTmp[l].begin()+this->pRepsIn_offsets[l][pId+1]);
-        }
+            size_t shift = 0;
+            
+            for (auto pId = 0; pId < cnt; pId++)
+            {
+                offsets[pId] = offsets[pId+1]+shift;
+                shift += sizes[pId];
+            }
+        };
+        size_t n;
+        
+        this->pOrgsIn_offsets[l]  = (RecordId *)malloc((cnt+1)*sizeof(RecordId));
+        this->pOrgsAft_offsets[l] = (RecordId *)malloc((cnt+1)*sizeof(RecordId));
+        this->pRepsIn_offsets[l]  = (size_t *)malloc((cnt+1)*sizeof(size_t));
+        this->pRepsAft_offsets[l] = (size_t *)malloc((cnt+1)*sizeof(size_t));
+        this->pOrgsIn_ioffsets[l].getPartitionOffsets(cnt, this->pOrgsInIds[l].size(), this->pOrgsIn_offsets[l]);
+        this->pOrgsAft_ioffsets[l].getPartitionOffsets(cnt, this->pOrgsAftIds[l].size(), this->pOrgsAft_offsets[l]);
+        this->pRepsIn_ioffsets[l].getPartitionOffsets(cnt, this->pRepsInIds[l].size(), this->pRepsIn_offsets[l]);
+        this->pRepsAft_ioffsets[l].getPartitionOffsets(cnt, this->pRepsAft[l].size(), this->pRepsAft_offsets[l]);
+        hasSearchLayout |= (this->pOrgsIn_ioffsets[l].getSearchTreeSize()+this->pOrgsAft_ioffsets[l].getSearchTreeSize()+this->pRepsIn_ioffsets[l].getSearchTreeSize()+this->pRepsAft_ioffsets[l].getSearchTreeSize() > 0);
+        
+        n = accumulate(pOrgsIn_sizes[l], pOrgsIn_sizes[l]+cnt, (size_t)0);
+        openPartitionGaps(this->pOrgsInIds[l], this->pOrgsIn_offsets[l], pOrgsIn_sizes[l], cnt, n);
+        openPartitionGaps(this->pOrgsInStarts[l], this->pOrgsIn_offsets[l], pOrgsIn_sizes[l], cnt, n);
+        openPartitionGaps(this->pOrgsInEnds[l], this->pOrgsIn_offsets[l], pOrgsIn_sizes[l], cnt, n);
+        toPositions(this->pOrgsIn_offsets[l], pOrgsIn_sizes[l]);
+        
+        n = accumulate(pOrgsAft_sizes[l], pOrgsAft_sizes[l]+cnt, (size_t)0);
+        openPartitionGaps(this->pOrgsAftIds[l], this->pOrgsAft_offsets[l], pOrgsAft_sizes[l], cnt, n);
+        openPartitionGaps(this->pOrgsAftTimestamp[l], this->pOrgsAft_offsets[l], pOrgsAft_sizes[l], cnt, n);
+        toPositions(this->pOrgsAft_offsets[l], pOrgsAft_sizes[l]);
+        
+        n = accumulate(pRepsIn_sizes[l], pRepsIn_sizes[l]+cnt, (size_t)0);
+        openPartitionGaps(this->pRepsInIds[l], this->pRepsIn_offsets[l], pRepsIn_sizes[l], cnt, n);
+        openPartitionGaps(this->pRepsInTimestamp[l], this->pRepsIn_offsets[l], pRepsIn_sizes[l], cnt, n);
+        toPositions(this->pRepsIn_offsets[l], pRepsIn_sizes[l]);
+        
+        n = accumulate(pRepsAft_sizes[l], pRepsAft_sizes[l]+cnt, (size_t)0);
+        openPartitionGaps(this->pRepsAft[l], this->pRepsAft_offsets[l], pRepsAft_sizes[l], cnt, n);
+        toPositions(this->pRepsAft_offsets[l], pRepsAft_sizes[l]);
     }
     
     
-    // Step 5: break-down data to create id- and timestamp-dedicated arrays; free auxiliary memory.
-    this->pOrgsInIds  = new RelationId[this->height];
-    this->pOrgsAftIds = new RelationId[this->height];
-    this->pRepsInIds  = new RelationId[this->height];
-    this->pOrgsInTimestamps = new vector<pair<Timestamp, Timestamp> >[this->height];
-    this->pOrgsAftTimestamp = new vector<Timestamp>[this->height];
-    this->pRepsInTimestamp  = new vector<Timestamp>[this->height];
+    // Step 3: fill the gaps; as in the construction, the positions move to
+    // the start of the next partition, so shifting them by one gives the
+    // offsets
+    for (const Record &r : D)
+        this->updatePartitions(r, this->pOrgsIn_offsets, this->pOrgsAft_offsets, this->pRepsIn_offsets, this->pRepsAft_offsets);
     for (auto l = 0; l < this->height; l++)
     {
-        auto cnt = pOrgsInTmp[l].size();
+        auto cnt = (int)(pow(2, this->numBits-l));
         
-        this->pOrgsInIds[l].resize(cnt);
-        this->pOrgsInTimestamps[l].resize(cnt);
-        for (auto j = 0; j < cnt; j++)
-        {
-            this->pOrgsInIds[l][j] = this->pOrgsInTmp[l][j].id;
-            this->pOrgsInTimestamps[l][j].first = this->pOrgsInTmp[l][j].start;
-            this->pOrgsInTimestamps[l][j].second = this->pOrgsInTmp[l][j].end;
-        }
+        memmove(this->pOrgsIn_offsets[l]+1, this->pOrgsIn_offsets[l], cnt*sizeof(RecordId));
+        memmove(this->pOrgsAft_offsets[l]+1, this->pOrgsAft_offsets[l], cnt*sizeof(RecordId));
+        memmove(this->pRepsIn_offsets[l]+1, this->pRepsIn_offsets[l], cnt*sizeof(size_t));
+        memmove(this->pRepsAft_offsets[l]+1, this->pRepsAft_offsets[l], cnt*sizeof(size_t));
+        this->pOrgsIn_offsets[l][0] = this->pOrgsAft_offsets[l][0] = 0;
+        this->pRepsIn_offsets[l][0] = this->pRepsAft_offsets[l][0] = 0;
+    }
+    
+    
+    // Step 4: sort the new records of every partition and merge them with
+    // the old ones, in the orders of the construction; the replicas after
+    // the partition are not sorted
+    Relation      orgsIn;
+    RelationStart orgsAft;
+    RelationEnd   repsIn;
+    for (auto l = 0; l < this->height; l++)
+    {
+        auto cnt = (int)(pow(2, this->numBits-l));
         
-        cnt = pOrgsAftTmp[l].size();
-        this->pOrgsAftIds[l].resize(cnt);
-        this->pOrgsAftTimestamp[l].resize(cnt);
-        for (auto j = 0; j < cnt; j++)
+        for (auto pId = 0; pId < cnt; pId++)
         {
-            this->pOrgsAftIds[l][j] = this->pOrgsAftTmp[l][j].id;
-            this->pOrgsAftTimestamp[l][j] = this->pOrgsAftTmp[l][j].start;
+            if (pOrgsIn_sizes[l][pId] > 0)
+            {
+                size_t first = this->pOrgsIn_offsets[l][pId], n = this->pOrgsIn_offsets[l][pId+1]-first;
+                
+                orgsIn.resize(n);
+                for (auto j = 0; j < n; j++)
+                    orgsIn[j] = Record(this->pOrgsInIds[l][first+j], this->pOrgsInStarts[l][first+j], this->pOrgsInEnds[l][first+j]);
+                sort(orgsIn.end()-pOrgsIn_sizes[l][pId], orgsIn.end());
+                inplace_merge(orgsIn.begin(), orgsIn.end()-pOrgsIn_sizes[l][pId], orgsIn.end());
+                for (auto j = 0; j < n; j++)
+                {
+                    this->pOrgsInIds[l][first+j] = orgsIn[j].id;
+                    this->pOrgsInStarts[l][first+j] = orgsIn[j].start;
+                    this->pOrgsInEnds[l][first+j] = orgsIn[j].end;
+                }
+            }
+            
+            if (pOrgsAft_sizes[l][pId] > 0)
+            {
+                size_t first = this->pOrgsAft_offsets[l][pId], n = this->pOrgsAft_offsets[l][pId+1]-first;
+                
+                orgsAft.resize(n);
+                for (auto j = 0; j < n; j++)
+                    orgsAft[j] = RecordStart(this->pOrgsAftIds[l][first+j], this->pOrgsAftTimestamp[l][first+j]);
+                sort(orgsAft.end()-pOrgsAft_sizes[l][pId], orgsAft.end());
+                inplace_merge(orgsAft.begin(), orgsAft.end()-pOrgsAft_sizes[l][pId], orgsAft.end());
+                for (auto j = 0; j < n; j++)
+                {
+                    this->pOrgsAftIds[l][first+j] = orgsAft[j].id;
+                    this->pOrgsAftTimestamp[l][first+j] = orgsAft[j].start;
+                }
+            }
+            
+            if (pRepsIn_sizes[l][pId] > 0)
+            {
+                size_t first = this->pRepsIn_offsets[l][pId], n = this->pRepsIn_offsets[l][pId+1]-first;
+                
+                repsIn.resize(n);
+                for (auto j = 0; j < n; j++)
+                    repsIn[j] = RecordEnd(this->pRepsInIds[l][first+j], this->pRepsInTimestamp[l][first+j]);
+                sort(repsIn.end()-pRepsIn_sizes[l][pId], repsIn.end());
+                inplace_merge(repsIn.begin(), repsIn.end()-pRepsIn_sizes[l][pId], repsIn.end());
+                for (auto j = 0; j < n; j++)
+                {
+                    this->pRepsInIds[l][first+j] = repsIn[j].id;
+                    this->pRepsInTimestamp[l][first+j] = repsIn[j].end;
+                }
+            }
         }
+    }
+    
+    
+    // Step 5: rebuild the offsets, as the arrays have moved
+    delete[] this->pOrgsIn_ioffsets;
+    delete[] this->pOrgsAft_ioffsets;
+    delete[] this->pRepsIn_ioffsets;
+    delete[] this->pRepsAft_ioffsets;
+    this->numEmptyPartitions = 0;
+    this->compactOffsets();
+    {
+        ThreadPool pool(1);
         
-        
-        cnt = pRepsInTmp[l].size();
-        this->pRepsInIds[l].resize(cnt);
-        this->pRepsInTimestamp[l].resize(cnt);
-        for (auto j = 0; j < cnt; j++)
-        {
-            this->pRepsInIds[l][j] = this->pRepsInTmp[l][j].id;
-            this->pRepsInTimestamp[l][j] = this->pRepsInTmp[l][j].end;
-        }
+        this->buildOffsets(pool);
     }
+    if (hasSearchLayout)
+        this->buildSearchLayout();
+    
+    delete[] this->pOrgsInAggregates;
+    delete[] this->pOrgsAftAggregates;
+    delete[] this->pRepsInAggregates;
+    delete[] this->pRepsAftAggregates;
+    this->pOrgsInAggregates = this->pOrgsAftAggregates = this->pRepsInAggregates = this->pRepsAftAggregates = NULL;
     
     
     // Free auxliary memory
     for (auto l = 0; l < this->height; l++)
     {
-        free(this->pOrgsIn_offsets[l]);
-        free(this->pOrgsAft_offsets[l]);
-        free(this->pRepsIn_offsets[l]);
-        free(this->pRepsAft_offsets[l]);
+        free(pOrgsIn_sizes[l]);
+        free(pOrgsAft_sizes[l]);
+        free(pRepsIn_sizes[l]);
+        free(pRepsAft_sizes[l]);
     }
-    free(this->pOrgsIn_offsets);
-    free(this->pOrgsAft_offsets);
-    free(this->pRepsIn_offsets);
-    free(this->pRepsAft_offsets);
-    
-    delete[] this->pOrgsInTmp;
-    delete[] this->pOrgsAftTmp;
-    delete[] this->pRepsInTmp;
-    
+    free(pOrgsIn_sizes);
+    free(pOrgsAft_sizes);
+    free(pRepsIn_sizes);
+    free(pRepsAft_sizes);
+}
+
+// Positions of the copies of record r in the arrays of the index, placed as
+// in updatePartitions(); only the partitions of r are scanned, and false is
+// returned if a copy is missing, i.e., r is not indexed.
+bool HINT_M_ALL::locate(const Record &r, vector<const RecordId*> &slots)
+{
+    int level = 0;
+    Timestamp a = r.start >> (this->maxBits-this->numBits);
+    Timestamp b = r.end   >> (this->maxBits-this->numBits);
+    Timestamp prevb;
+    int firstfound = 0, lastfound = 0;
+    bool found = true;
+    auto find = [&](auto &ioffsets, const RelationId &ids, const PartitionId pId)
+    {
+        size_t first, last;
+        
+        if (!ioffsets.getPartition(pId, ids.size(), first, last))
+            return false;
+        
+        auto iter = std::find(ids.begin()+first, ids.begin()+last, r.id);
+        
+        if (iter == ids.begin()+last)
+            return false;
+        slots.push_back(&(*iter));
+        
+        return true;
+    };
     
-    //    vector<tuple<Timestamp, RelationIdIterator, vector<pair<Timestamp, Timestamp> >::iterator, PartitionId> >   *pOrgsIn_ioffsets;
-    //    vector<tuple<Timestamp, RelationIdIterator, vector<Timestamp>::iterator, PartitionId> > *pOrgsAft_ioffsets;
-    //    vector<tuple<Timestamp, RelationIdIterator, vector<Timestamp>::iterator, PartitionId> > *pRepsIn_ioffsets;
-    //    vector<tuple<Timestamp, RelationIdIterator, PartitionId> > *pRepsAft_ioffsets;
     
-    // Step 4: create offset pointers
-    this->pOrgsIn_ioffsets  = new Offsets_ALL_OrgsIn[this->height];
-    this->pOrgsAft_ioffsets = new Offsets_ALL_OrgsAft[this->height];
-    this->pRepsIn_ioffsets  = new Offsets_ALL_RepsIn[this->height];
-    this->pRepsAft_ioffsets = new Offsets_ALL_RepsAft[this->height];
-    for (int l = this->height-1; l > -1; l--)
+    while (level < this->height && a <= b && found)
     {
-        auto cnt = (int)(pow(2, this->numBits-l));
-        size_t sumOin = 0, sumOaft = 0, sumRin = 0, sumRaft = 0;
-        
-        for (auto pId = 0; pId < cnt; pId++)
-        {
-            bool isEmpty = true;
-            
-            dummySE.tstamp = pId >> 1;//((pId >> (this->maxBits-this->numBits)) >> 1);
-            if (this->pOrgsIn_sizes[l][pId] > 0)
+        if (a%2)
+        { //last bit of a is 1
+            if (firstfound)
             {
-                isEmpty = false;
-                tmp = -1;
-                if (l < this->height-1)
+                if ((a == b) && (!lastfound))
                 {
-                    iterSEOStart = this->pOrgsIn_ioffsets[l+1].begin();
-                    iterSEOEnd = this->pOrgsIn_ioffsets[l+1].end();
-                    iterSEO = lower_bound(iterSEOStart, iterSEOEnd, dummySE);//, CompareStartEndOffesetsByTimestamp_WithCM);
-                    tmp = (iterSEO != iterSEOEnd)? (iterSEO-iterSEOStart): -1;
+                    found = find(this->pRepsIn_ioffsets[level], this->pRepsInIds[level], a);
+                    lastfound = 1;
                 }
-                this->pOrgsIn_ioffsets[l].push_back(OffsetEntry_ALL_OrgsIn(pId, this->pOrgsInIds[l].begin()+sumOin, this->pOrgsInTimestamps[l].begin()+sumOin, tmp));
+                else
+                    found = find(this->pRepsAft_ioffsets[level], this->pRepsAft[level], a);
             }
-            
-            dummyS.tstamp = pId >> 1;//((pId >> (this->maxBits-this->numBits)) >> 1);
-            if (this->pOrgsAft_sizes[l][pId] > 0)
+            else
             {
-                isEmpty = false;
-                tmp = -1;
-                if (l < this->height-1)
-                {
-                    iterSOStart = this->pOrgsAft_ioffsets[l+1].begin();
-                    iterSOEnd = this->pOrgsAft_ioffsets[l+1].end();
-                    iterSO = lower_bound(iterSOStart, iterSOEnd, dummyS);//, CompareStartOffesetsByTimestamp_WithCM);
-                    tmp = (iterSO != iterSOEnd)? (iterSO-iterSOStart): -1;
-                }
-                this->pOrgsAft_ioffsets[l].push_back(OffsetEntry_ALL_OrgsAft(pId, this->pOrgsAftIds[l].begin()+sumOaft, this->pOrgsAftTimestamp[l].begin()+sumOaft, tmp));
+                if ((a == b) && (!lastfound))
+                    found = find(this->pOrgsIn_ioffsets[level], this->pOrgsInIds[level], a);
+                else
+                    found = find(this->pOrgsAft_ioffsets[level], this->pOrgsAftIds[level], a);
+                firstfound = 1;
             }
-            
-            dummyE.tstamp = pId >> 1;//((pId >> (this->maxBits-this->numBits)) >> 1);
-            if (this->pRepsIn_sizes[l][pId] > 0)
+            a++;
+        }
+        if ((!(b%2)) && (found))
+        { //last bit of b is 0
+            prevb = b;
+            b--;
+            if ((!firstfound) && b < a)
             {
-                isEmpty = false;
-                tmp = -1;
-                if (l < this->height-1)
+                if (!lastfound)
+                    found = find(this->pOrgsIn_ioffsets[level], this->pOrgsInIds[level], prevb);
+                else
+                    found = find(this->pOrgsAft_ioffsets[level], this->pOrgsAftIds[level], prevb);
+            }
+            else
+            {
+                if (!lastfound)
                 {
-                    iterEOStart = this->pRepsIn_ioffsets[l+1].begin();
-                    iterEOEnd = this->pRepsIn_ioffsets[l+1].end();
-                    iterEO = lower_bound(iterEOStart, iterEOEnd, dummyE);//, CompareEndOffesetsByTimestamp_WithCM);
-                    tmp = (iterEO != iterEOEnd)? (iterEO-iterEOStart): -1;
+                    found = find(this->pRepsIn_ioffsets[level], this->pRepsInIds[level], prevb);
+                    lastfound = 1;
                 }
-                this->pRepsIn_ioffsets[l].push_back(OffsetEntry_ALL_RepsIn(pId, this->pRepsInIds[l].begin()+sumRin, this->pRepsInTimestamp[l].begin()+sumRin, tmp));
+                else
+                    found = find(this->pRepsAft_ioffsets[level], this->pRepsAft[level], prevb);
             }
+        }
+        a >>= 1; // a = a div 2
+        b >>= 1; // b = b div 2
+        level++;
+    }
+    
+    return found;
+}
+
+
+// Drops the erased records from the partitions. Every array is compacted
+// once, front to back, keeping the order of the partitions, and the offsets
+// are rebuilt as after a merge; the prefix aggregates are dropped.
+void HINT_M_ALL::purgeTombstones()
+{
+    bool hasSearchLayout = false;
+    
+    
+    // Step 1: compact the arrays; the offsets of a partition become its
+    // positions after the compaction
+    this->pOrgsIn_offsets  = (RecordId **)malloc(this->height*sizeof(RecordId *));
+    this->pOrgsAft_offsets = (RecordId **)malloc(this->height*sizeof(RecordId *));
+    this->pRepsIn_offsets  = (size_t **)malloc(this->height*sizeof(size_t *));
+    this->pRepsAft_offsets = (size_t **)malloc(this->height*sizeof(size_t *));
+    for (auto l = 0; l < this->height; l++)
+    {
+        auto cnt = (int)(pow(2, this->numBits-l));
+        auto compact = [&](auto offsets, RelationId &ids, auto move)
+        {
+            size_t k = 0;
             
-            dummyI.tstamp = pId >> 1;//((pId >> (this->maxBits-this->numBits)) >> 1);
-            if (this->pRepsAft_sizes[l][pId] > 0)
+            for (auto pId = 0; pId < cnt; pId++)
             {
-                isEmpty = false;
-                tmp = -1;
-                if (l < this->height-1)
+                size_t first = offsets[pId];
+                
+                offsets[pId] = k;
+                for (auto i = first; i < offsets[pId+1]; i++)
                 {
-                    iterIOBegin = this->pRepsAft_ioffsets[l+1].begin();
-                    iterIOEnd = this->pRepsAft_ioffsets[l+1].end();
-                    iterIO = lower_bound(iterIOBegin, iterIOEnd, dummyI);//, CompareIdOffesetsByTimestamp);
-                    tmp = (iterIO != iterIOEnd)? (iterIO-iterIOBegin): -1;
+                    if (!this->tombstones.isErased(ids[i]))
+                    {
+                        ids[k] = ids[i];
+                        move(k++, i);
+                    }
                 }
-                this->pRepsAft_ioffsets[l].push_back(OffsetEntry_ALL_RepsAft(pId, this->pRepsAft[l].begin()+sumRaft, tmp));
             }
+            offsets[cnt] = k;
+            ids.resize(k);
             
-            sumOin += this->pOrgsIn_sizes[l][pId];
-            sumOaft += this->pOrgsAft_sizes[l][pId];
-            sumRin += this->pRepsIn_sizes[l][pId];
-            sumRaft += this->pRepsAft_sizes[l][pId];
-            
-            if (isEmpty)
-                this->numEmptyPartitions++;
-        }
+            return k;
+        };
+        size_t n;
+        
+        this->pOrgsIn_offsets[l]  = (RecordId *)malloc((cnt+1)*sizeof(RecordId));
+        this->pOrgsAft_offsets[l] = (RecordId *)malloc((cnt+1)*sizeof(RecordId));
+        this->pRepsIn_offsets[l]  = (size_t *)malloc((cnt+1)*sizeof(size_t));
+        this->pRepsAft_offsets[l] = (size_t *)malloc((cnt+1)*sizeof(size_t));
+        this->pOrgsIn_ioffsets[l].getPartitionOffsets(cnt, this->pOrgsInIds[l].size(), this->pOrgsIn_offsets[l]);
+        this->pOrgsAft_ioffsets[l].getPartitionOffsets(cnt, this->pOrgsAftIds[l].size(), this->pOrgsAft_offsets[l]);
+        this->pRepsIn_ioffsets[l].getPartitionOffsets(cnt, this->pRepsInIds[l].size(), this->pRepsIn_offsets[l]);
+        this->pRepsAft_ioffsets[l].getPartitionOffsets(cnt, this->pRepsAft[l].size(), this->pRepsAft_offsets[l]);
+        hasSearchLayout |= (this->pOrgsIn_ioffsets[l].getSearchTreeSize()+this->pOrgsAft_ioffsets[l].getSearchTreeSize()+this->pRepsIn_ioffsets[l].getSearchTreeSize()+this->pRepsAft_ioffsets[l].getSearchTreeSize() > 0);
+        
+        n = compact(this->pOrgsIn_offsets[l], this->pOrgsInIds[l], [&](const size_t k, const size_t i)
+        {
+            this->pOrgsInStarts[l][k] = this->pOrgsInStarts[l][i];
+            this->pOrgsInEnds[l][k] = this->pOrgsInEnds[l][i];
+        });
+        this->pOrgsInStarts[l].resize(n);
+        this->pOrgsInEnds[l].resize(n);
+        
+        n = compact(this->pOrgsAft_offsets[l], this->pOrgsAftIds[l], [&](const size_t k, const size_t i)
+        {
+            this->pOrgsAftTimestamp[l][k] = this->pOrgsAftTimestamp[l][i];
+        });
+        this->pOrgsAftTimestamp[l].resize(n);
+        
+        n = compact(this->pRepsIn_offsets[l], this->pRepsInIds[l], [&](const size_t k, const size_t i)
+        {
+            this->pRepsInTimestamp[l][k] = this->pRepsInTimestamp[l][i];
+        });
+        this->pRepsInTimestamp[l].resize(n);
+        
+        compact(this->pRepsAft_offsets[l], this->pRepsAft[l], [](const size_t, const size_t) {});
     }
     
     
-    // Free auxliary memory
-    for (auto l = 0; l < this->height; l++)
+    // Step 2: rebuild the offsets, as the arrays have moved
+    delete[] this->pOrgsIn_ioffsets;
+    delete[] this->pOrgsAft_ioffsets;
+    delete[] this->pRepsIn_ioffsets;
+    delete[] this->pRepsAft_ioffsets;
+    this->numEmptyPartitions = 0;
+    this->compactOffsets();
     {
-        free(this->pOrgsIn_sizes[l]);
-        free(this->pOrgsAft_sizes[l]);
-        free(this->pRepsIn_sizes[l]);
-        free(this->pRepsAft_sizes[l]);
+        ThreadPool pool(1);
+        
+        this->buildOffsets(pool);
     }
-    free(this->pOrgsIn_sizes);
-    free(this->pOrgsAft_sizes);
-    free(this->pRepsIn_sizes);
-    free(this->pRepsAft_sizes);
+    if (hasSearchLayout)
+        this->buildSearchLayout();
+    
+    delete[] this->pOrgsInAggregates;
+    delete[] this->pOrgsAftAggregates;
+    delete[] this->pRepsInAggregates;
+    delete[] this->pRepsAftAggregates;
+    this->pOrgsInAggregates = this->pOrgsAftAggregates = this->pRepsInAggregates = this->pRepsAftAggregates = NULL;
 }
 
 
@@ -463,6 +1234,10 @@ void HINT_M_ALL::getStats()
         this->numOriginalsAft += this->pOrgsAftIds[l].size();
         this->numReplicasIn   += this->pRepsInIds[l].size();
         this->numReplicasAft  += this->pRepsAft[l].size();
+        this->sizeSearchLayout += this->pOrgsIn_ioffsets[l].getSearchTreeSize()+this->pOrgsAft_ioffsets[l].getSearchTreeSize()+this->pRepsIn_ioffsets[l].getSearchTreeSize()+this->pRepsAft_ioffsets[l].getSearchTreeSize();
+        
+        if (this->pOrgsInAggregates != NULL)
+            this->sizeAggregates += this->pOrgsInAggregates[l].getSize()+this->pOrgsAftAggregates[l].getSize()+this->pRepsInAggregates[l].getSize()+this->pRepsAftAggregates[l].getSize();
     }
     
     this->avgPartitionSize = (float)(this->numIndexedRecords+this->numReplicasIn+this->numReplicasAft)/(this->numPartitions-numEmptyPartitions);
@@ -477,12 +1252,308 @@ HINT_M_ALL::~HINT_M_ALL()
     delete[] this->pRepsAft_ioffsets;
     
     delete[] this->pOrgsInIds;
-    delete[] this->pOrgsInTimestamps;
+    delete[] this->pOrgsInStarts;
+    delete[] this->pOrgsInEnds;
     delete[] this->pOrgsAftIds;
     delete[] this->pOrgsAftTimestamp;
     delete[] this->pRepsInIds;
     delete[] this->pRepsInTimestamp;
     delete[] this->pRepsAft;
+    
+    delete[] this->pOrgsInAggregates;
+    delete[] this->pOrgsAftAggregates;
+    delete[] this->pRepsInAggregates;
+    delete[] this->pRepsAftAggregates;
+    
+    // Only after the arrays viewing it
+    if (this->mapping != NULL)
+        munmap(this->mapping, this->mappingSize);
+    delete[] this->regions;
+}
+
+
+// Persistence, see IndexFileHeader
+
+// Turns the offsets of a level into views of their sections in the file,
+// given from the timestamps on, see save().
+template <class Offsets>
+static inline void viewFileOffsets(Offsets &offsets, MappedRegion *regions, const size_t numPartitions)
+{
+    viewRegion(offsets.tstamps, regions[0]);
+    viewRegion(offsets.positions, regions[1]);
+    viewRegion(offsets.pids, regions[2]);
+    viewRegion(offsets.dir.words, regions[3]);
+    viewRegion(offsets.dir.counts, regions[4]);
+    offsets.dir.numBits = numPartitions;
+}
+
+
+// Returns false if the offsets of a level, viewed in the file, do not fit
+// the level, i.e., a partition is not one of the numPartitions of the level
+// (after the one of the previous entry), a position is not within the
+// numRecords of the arrays (and behind the one of the previous entry), a hint
+// to the next level is negative but not -1, or the directory does not mark
+// exactly these partitions.
+template <class Offsets>
+static inline bool checkFileOffsets(const Offsets &offsets, const size_t numPartitions, const size_t numRecords)
+{
+    const size_t n = offsets.size();
+    
+    if ((offsets.positions.size() != n) || (offsets.pids.size() != n) || (!offsets.dir.check()))
+        return false;
+    for (auto i = 0; i < n; i++)
+    {
+        if ((offsets.tstamps[i] < 0) || ((size_t)offsets.tstamps[i] >= numPartitions) || ((i > 0) && (offsets.tstamps[i] <= offsets.tstamps[i-1])))
+            return false;
+        if ((offsets.positions[i] > numRecords) || ((i > 0) && (offsets.positions[i] < offsets.positions[i-1])) || (offsets.pids[i] < -1))
+            return false;
+        if ((!offsets.dir.get(offsets.tstamps[i])) || (offsets.dir.rank(offsets.tstamps[i]) != i))
+            return false;
+    }
+    
+    return (offsets.dir.getNumSetBits() == n);
+}
+
+
+// Writes the index to a file, to be reopened by HINT_M_ALL(filename); the
+// prefix aggregates are not stored, and the delta buffer is merged first.
+void HINT_M_ALL::save(const char *filename)
+{
+    ofstream out(filename, ios::binary);
+    IndexFileHeader header;
+    vector<IndexFileSection> sections;
+    
+    
+    this->merge();
+    if (!out)
+    {
+        cerr << endl << "Error - cannot create index file \"" << filename << "\"" << endl << endl;
+        exit(1);
+    }
+    
+    // Appends a section, starting at the next page boundary
+    auto writeSection = [&](const void *data, const size_t count, const size_t size)
+    {
+        size_t pos = out.tellp();
+        IndexFileSection section;
+        
+        section.offset = (pos+INDEX_FILE_PAGE_SIZE-1)/INDEX_FILE_PAGE_SIZE*INDEX_FILE_PAGE_SIZE;
+        section.count  = count;
+        for (; pos < section.offset; pos++)
+            out.put(0);
+        out.write((const char*)data, count*size);
+        sections.push_back(section);
+    };
+    
+    // Appends the sections of the offsets of a level, with their directory,
+    // built here for offsets searched in a tree instead
+    auto writeOffsets = [&](const auto &offsets, const size_t numPartitions)
+    {
+        RankBitvector tmp;
+        const RankBitvector *dir = &offsets.dir;
+        
+        if (dir->empty())
+        {
+            tmp.init(numPartitions);
+            for (const Timestamp t : offsets.tstamps)
+                tmp.set(t);
+            tmp.buildRank();
+            dir = &tmp;
+        }
+        writeSection(offsets.tstamps.data(), offsets.tstamps.size(), sizeof(Timestamp));
+        writeSection(offsets.positions.data(), offsets.positions.size(), sizeof(uint32_t));
+        writeSection(offsets.pids.data(), offsets.pids.size(), sizeof(PartitionId));
+        writeSection(dir->words.data(), dir->words.size(), sizeof(uint64_t));
+        writeSection(dir->counts.data(), dir->counts.size(), sizeof(uint64_t));
+    };
+    
+    memcpy(header.magic, INDEX_FILE_MAGIC, sizeof(header.magic));
+    header.version            = INDEX_FILE_VERSION;
+    header.timestampSize      = sizeof(Timestamp);
+    header.recordIdSize       = sizeof(RecordId);
+    header.numBits            = this->numBits;
+    header.maxBits            = this->maxBits;
+    header.numIndexedRecords  = this->numIndexedRecords;
+    header.numEmptyPartitions = this->numEmptyPartitions;
+    out.write((const char*)&header, sizeof(header));
+    
+    // Directory, filled in after the sections are written
+    sections.resize(this->height*INDEX_FILE_SECTIONS_PER_LEVEL);
+    out.write((const char*)sections.data(), sections.size()*sizeof(IndexFileSection));
+    sections.clear();
+    
+    for (auto l = 0; l < this->height; l++)
+    {
+        writeSection(this->pOrgsInIds[l].data(), this->pOrgsInIds[l].size(), sizeof(RecordId));
+        writeSection(this->pOrgsInStarts[l].data(), this->pOrgsInStarts[l].size(), sizeof(Timestamp));
+        writeSection(this->pOrgsInEnds[l].data(), this->pOrgsInEnds[l].size(), sizeof(Timestamp));
+        writeSection(this->pOrgsAftIds[l].data(), this->pOrgsAftIds[l].size(), sizeof(RecordId));
+        writeSection(this->pOrgsAftTimestamp[l].data(), this->pOrgsAftTimestamp[l].size(), sizeof(Timestamp));
+        writeSection(this->pRepsInIds[l].data(), this->pRepsInIds[l].size(), sizeof(RecordId));
+        writeSection(this->pRepsInTimestamp[l].data(), this->pRepsInTimestamp[l].size(), sizeof(Timestamp));
+        writeSection(this->pRepsAft[l].data(), this->pRepsAft[l].size(), sizeof(RecordId));
+        writeOffsets(this->pOrgsIn_ioffsets[l], ((size_t)1) << (this->numBits-l));
+        writeOffsets(this->pOrgsAft_ioffsets[l], ((size_t)1) << (this->numBits-l));
+        writeOffsets(this->pRepsIn_ioffsets[l], ((size_t)1) << (this->numBits-l));
+        writeOffsets(this->pRepsAft_ioffsets[l], ((size_t)1) << (this->numBits-l));
+    }
+    
+    out.seekp(sizeof(header));
+    out.write((const char*)sections.data(), sections.size()*sizeof(IndexFileSection));
+    out.close();
+    if (!out)
+    {
+        cerr << endl << "Error - cannot write index file \"" << filename << "\"" << endl << endl;
+        exit(1);
+    }
+}
+
+
+// Reopens an index written by save(). The file is mapped and stays mapped
+// for the lifetime of the index: the id and timestamp arrays and the offsets
+// with their directories are views of their sections, see
+// containers/mapping.h, i.e., nothing is copied or rebuilt, and the pages are
+// read as the queries touch them. The mapping is private, the file is never
+// written; an update copies only the pages it changes. The offsets are
+// checked against the arrays and their directories, the only pass over the
+// file besides the queries.
+HINT_M_ALL::HINT_M_ALL(const char *filename) : HierarchicalIndex(0, 0, 0)
+{
+    const size_t offsetsSizes[] = {sizeof(Timestamp), sizeof(uint32_t), sizeof(PartitionId), sizeof(uint64_t), sizeof(uint64_t)};
+    const size_t sizes[INDEX_FILE_SECTIONS_PER_LEVEL] = {sizeof(RecordId), sizeof(Timestamp), sizeof(Timestamp), sizeof(RecordId), sizeof(Timestamp), sizeof(RecordId), sizeof(Timestamp), sizeof(RecordId)};
+    int fd = open(filename, O_RDONLY);
+    struct stat st;
+    char *data;
+    const IndexFileHeader *header;
+    const IndexFileSection *sections;
+    size_t numSections;
+    
+    
+    if ((fd == -1) || (fstat(fd, &st) == -1))
+    {
+        cerr << endl << "Error - cannot open index file \"" << filename << "\"" << endl << endl;
+        exit(1);
+    }
+    if ((size_t)st.st_size < sizeof(IndexFileHeader))
+    {
+        cerr << endl << "Error - index file \"" << filename << "\" is truncated" << endl << endl;
+        exit(1);
+    }
+    data = (char*)mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        cerr << endl << "Error - cannot map index file \"" << filename << "\"" << endl << endl;
+        exit(1);
+    }
+    this->mapping     = data;
+    this->mappingSize = st.st_size;
+    
+    // Check the header and the directory
+    header = (const IndexFileHeader*)data;
+    if (memcmp(header->magic, INDEX_FILE_MAGIC, sizeof(header->magic)))
+    {
+        cerr << endl << "Error - \"" << filename << "\" is not an index file" << endl << endl;
+        exit(1);
+    }
+    if (header->version != INDEX_FILE_VERSION)
+    {
+        cerr << endl << "Error - index file \"" << filename << "\" has format version " << header->version << ", expected " << INDEX_FILE_VERSION << endl << endl;
+        exit(1);
+    }
+    if ((header->timestampSize != sizeof(Timestamp)) || (header->recordIdSize != sizeof(RecordId)))
+    {
+        cerr << endl << "Error - index file \"" << filename << "\" was written with " << header->timestampSize << "-byte timestamps and " << header->recordIdSize << "-byte ids, expected " << sizeof(Timestamp) << " and " << sizeof(RecordId) << endl << endl;
+        exit(1);
+    }
+    if ((header->numBits > header->maxBits) || (header->maxBits > 8*sizeof(Timestamp)))
+    {
+        cerr << endl << "Error - index file \"" << filename << "\" is corrupt" << endl << endl;
+        exit(1);
+    }
+    this->numIndexedRecords  = header->numIndexedRecords;
+    this->numBits            = header->numBits;
+    this->maxBits            = header->maxBits;
+    this->height             = this->numBits+1;
+    this->numEmptyPartitions = header->numEmptyPartitions;
+    
+    numSections = this->height*INDEX_FILE_SECTIONS_PER_LEVEL;
+    sections = (const IndexFileSection*)(header+1);
+    if ((size_t)st.st_size < sizeof(IndexFileHeader)+numSections*sizeof(IndexFileSection))
+    {
+        cerr << endl << "Error - index file \"" << filename << "\" is truncated" << endl << endl;
+        exit(1);
+    }
+    for (auto i = 0; i < numSections; i++)
+    {
+        auto j = i%INDEX_FILE_SECTIONS_PER_LEVEL;
+        auto size = (j < 8)? sizes[j]: offsetsSizes[(j-8)%5];
+        
+        if ((sections[i].offset%INDEX_FILE_PAGE_SIZE != 0) || (sections[i].offset+sections[i].count*size > (size_t)st.st_size))
+        {
+            cerr << endl << "Error - index file \"" << filename << "\" is truncated" << endl << endl;
+            exit(1);
+        }
+    }
+    
+    // View the arrays
+    this->regions     = new MappedRegion[numSections];
+    this->pOrgsInIds  = new RelationId[this->height];
+    this->pOrgsAftIds = new RelationId[this->height];
+    this->pRepsInIds  = new RelationId[this->height];
+    this->pRepsAft    = new RelationId[this->height];
+    this->pOrgsInStarts     = new TimestampArray[this->height];
+    this->pOrgsInEnds       = new TimestampArray[this->height];
+    this->pOrgsAftTimestamp = new TimestampArray[this->height];
+    this->pRepsInTimestamp  = new TimestampArray[this->height];
+    this->pOrgsIn_ioffsets  = new Offsets_ALL_OrgsIn[this->height];
+    this->pOrgsAft_ioffsets = new Offsets_ALL_OrgsAft[this->height];
+    this->pRepsIn_ioffsets  = new Offsets_ALL_RepsIn[this->height];
+    this->pRepsAft_ioffsets = new Offsets_ALL_RepsAft[this->height];
+    this->pOrgsInAggregates = this->pOrgsAftAggregates = this->pRepsInAggregates = this->pRepsAftAggregates = NULL;
+    this->pOrgsIn_dir = this->pOrgsAft_dir = this->pRepsIn_dir = this->pRepsAft_dir = NULL;
+    for (auto i = 0; i < numSections; i++)
+    {
+        this->regions[i].data  = data+sections[i].offset;
+        this->regions[i].count = sections[i].count;
+    }
+    for (auto l = 0; l < this->height; l++)
+    {
+        const IndexFileSection *s = sections+l*INDEX_FILE_SECTIONS_PER_LEVEL;
+        MappedRegion *r = this->regions+l*INDEX_FILE_SECTIONS_PER_LEVEL;
+        size_t numPartitions = ((size_t)1) << (this->numBits-l);
+        
+        // Every timestamp array must match its id array
+        if ((s[1].count != s[0].count) || (s[2].count != s[0].count) || (s[4].count != s[3].count) || (s[6].count != s[5].count))
+        {
+            cerr << endl << "Error - index file \"" << filename << "\" is corrupt" << endl << endl;
+            exit(1);
+        }
+        
+        viewRegion(this->pOrgsInIds[l], r[0]);
+        viewRegion(this->pOrgsInStarts[l], r[1]);
+        viewRegion(this->pOrgsInEnds[l], r[2]);
+        viewRegion(this->pOrgsAftIds[l], r[3]);
+        viewRegion(this->pOrgsAftTimestamp[l], r[4]);
+        viewRegion(this->pRepsInIds[l], r[5]);
+        viewRegion(this->pRepsInTimestamp[l], r[6]);
+        viewRegion(this->pRepsAft[l], r[7]);
+        
+        // View the offsets
+        this->pOrgsIn_ioffsets[l].setBase(this->pOrgsInIds[l].begin(), this->pOrgsInStarts[l].begin());
+        this->pOrgsAft_ioffsets[l].setBase(this->pOrgsAftIds[l].begin(), this->pOrgsAftTimestamp[l].begin());
+        this->pRepsIn_ioffsets[l].setBase(this->pRepsInIds[l].begin(), this->pRepsInTimestamp[l].begin());
+        this->pRepsAft_ioffsets[l].setBase(this->pRepsAft[l].begin());
+        viewFileOffsets(this->pOrgsIn_ioffsets[l], r+8, numPartitions);
+        viewFileOffsets(this->pOrgsAft_ioffsets[l], r+13, numPartitions);
+        viewFileOffsets(this->pRepsIn_ioffsets[l], r+18, numPartitions);
+        viewFileOffsets(this->pRepsAft_ioffsets[l], r+23, numPartitions);
+        if ((!checkFileOffsets(this->pOrgsIn_ioffsets[l], numPartitions, s[0].count)) || (!checkFileOffsets(this->pOrgsAft_ioffsets[l], numPartitions, s[3].count)) || (!checkFileOffsets(this->pRepsIn_ioffsets[l], numPartitions, s[5].count)) || (!checkFileOffsets(this->pRepsAft_ioffsets[l], numPartitions, s[7].count)))
+        {
+            cerr << endl << "Error - index file \"" << filename << "\" is corrupt" << endl << endl;
+            exit(1);
+        }
+    }
 }
 
 
@@ -497,7 +1568,7 @@ inline bool HINT_M_ALL::getBounds_OrgsIn(unsigned int level, Timestamp t, Partit
 
     if (cnt > 0)
     {
-        if ((from == -1) || (from > cnt))
+        if ((from == -1) || (from >= cnt))
         {
             qdummy.tstamp = t;
             iterIOBegin = this->pOrgsIn_ioffsets[level].begin();
@@ -520,14 +1591,14 @@ inline bool HINT_M_ALL::getBounds_OrgsIn(unsigned int level, Timestamp t, Partit
             Timestamp tmp = (this->pOrgsIn_ioffsets[level][from]).tstamp;
             if (tmp < t)
             {
-                while (((this->pOrgsIn_ioffsets[level][from]).tstamp < t) && (from < cnt))
+                while ((from < cnt) && ((this->pOrgsIn_ioffsets[level][from]).tstamp < t))
                     from++;
             }
             else if (tmp > t)
             {
-                while (((this->pOrgsIn_ioffsets[level][from]).tstamp > t) && (from > -1))
+                while ((from > -1) && ((this->pOrgsIn_ioffsets[level][from]).tstamp > t))
                     from--;
-                if (((this->pOrgsIn_ioffsets[level][from]).tstamp != t) || (from == -1))
+                if ((from == -1) || ((this->pOrgsIn_ioffsets[level][from]).tstamp != t))
                     from++;
             }
 
@@ -557,7 +1628,7 @@ inline bool HINT_M_ALL::getBounds_OrgsIn(unsigned int level, Timestamp t, Partit
 }
 
 
-inline bool HINT_M_ALL::getBounds_OrgsIn(unsigned int level, Timestamp t, PartitionId &next_from, vector<pair<Timestamp, Timestamp> >::iterator &iterBegin, vector<pair<Timestamp, Timestamp> >::iterator &iterEnd, RelationIdIterator &iterI)
+inline bool HINT_M_ALL::getBounds_OrgsIn(unsigned int level, Timestamp t, PartitionId &next_from, TimestampArrayIterator &iterBegin, TimestampArrayIterator &iterEnd, RelationIdIterator &iterI)
 {
     OffsetEntry_ALL_OrgsIn qdummy;
     Offsets_ALL_OrgsIn_Iterator iterIO, iterIOBegin, iterIOEnd;
@@ -568,7 +1639,7 @@ inline bool HINT_M_ALL::getBounds_OrgsIn(unsigned int level, Timestamp t, Partit
     if (cnt > 0)
     {
         // Do binary search or follow vertical pointers.
-        if ((from == -1) || (from > cnt))
+        if ((from == -1) || (from >= cnt))
         {
             qdummy.tstamp = t;
             iterIOBegin = this->pOrgsIn_ioffsets[level].begin();
@@ -578,7 +1649,7 @@ inline bool HINT_M_ALL::getBounds_OrgsIn(unsigned int level, Timestamp t, Partit
             {
                 iterI = iterIO->iterI;
                 iterBegin = iterIO->iterT;
-                iterEnd = ((iterIO+1 != iterIOEnd) ? (iterIO+1)->iterT : this->pOrgsInTimestamps[level].end());
+                iterEnd = ((iterIO+1 != iterIOEnd) ? (iterIO+1)->iterT : this->pOrgsInStarts[level].end());
 
                 next_from = iterIO->pid;
 
@@ -592,14 +1663,14 @@ inline bool HINT_M_ALL::getBounds_OrgsIn(unsigned int level, Timestamp t, Partit
             Timestamp tmp = (this->pOrgsIn_ioffsets[level][from]).tstamp;
             if (tmp < t)
             {
-                while (((this->pOrgsIn_ioffsets[level][from]).tstamp < t) && (from < cnt))
+                while ((from < cnt) && ((this->pOrgsIn_ioffsets[level][from]).tstamp < t))
                     from++;
             }
             else if (tmp > t)
             {
-                while (((this->pOrgsIn_ioffsets[level][from]).tstamp > t) && (from > -1))
+                while ((from > -1) && ((this->pOrgsIn_ioffsets[level][from]).tstamp > t))
                     from--;
-                if (((this->pOrgsIn_ioffsets[level][from]).tstamp != t) || (from == -1))
+                if ((from == -1) || ((this->pOrgsIn_ioffsets[level][from]).tstamp != t))
                     from++;
             }
 
@@ -607,7 +1678,7 @@ inline bool HINT_M_ALL::getBounds_OrgsIn(unsigned int level, Timestamp t, Partit
             {
                 iterI = (this->pOrgsIn_ioffsets[level][from]).iterI;
                 iterBegin = (this->pOrgsIn_ioffsets[level][from]).iterT;
-                iterEnd = ((from+1 != cnt) ? (this->pOrgsIn_ioffsets[level][from+1]).iterT : this->pOrgsInTimestamps[level].end());
+                iterEnd = ((from+1 != cnt) ? (this->pOrgsIn_ioffsets[level][from+1]).iterT : this->pOrgsInStarts[level].end());
 
                 next_from = (this->pOrgsIn_ioffsets[level][from]).pid;
 
@@ -630,7 +1701,7 @@ inline bool HINT_M_ALL::getBounds_OrgsIn(unsigned int level, Timestamp t, Partit
 }
 
 
-inline bool HINT_M_ALL::getBoundsS_OrgsIn(unsigned int level, Timestamp t, PartitionId &next_from, vector<pair<Timestamp, Timestamp> >::iterator &iterBegin, RelationIdIterator &iterI)
+inline bool HINT_M_ALL::getBoundsS_OrgsIn(unsigned int level, Timestamp t, PartitionId &next_from, TimestampArrayIterator &iterBegin, RelationIdIterator &iterI)
 {
     OffsetEntry_ALL_OrgsIn qdummy;
     Offsets_ALL_OrgsIn_Iterator iterIO, iterIOBegin, iterIOEnd;
@@ -641,7 +1712,7 @@ inline bool HINT_M_ALL::getBoundsS_OrgsIn(unsigned int level, Timestamp t, Parti
     if (cnt > 0)
     {
         // Do binary search or follow vertical pointers.
-        if ((from == -1) || (from > cnt))
+        if ((from == -1) || (from >= cnt))
         {
             qdummy.tstamp = t;
             iterIOBegin = this->pOrgsIn_ioffsets[level].begin();
@@ -665,14 +1736,14 @@ inline bool HINT_M_ALL::getBoundsS_OrgsIn(unsigned int level, Timestamp t, Parti
             Timestamp tmp = (this->pOrgsIn_ioffsets[level][from]).tstamp;
             if (tmp < t)
             {
-                while (((this->pOrgsIn_ioffsets[level][from]).tstamp < t) && (from < cnt))
+                while ((from < cnt) && ((this->pOrgsIn_ioffsets[level][from]).tstamp < t))
                     from++;
             }
             else if (tmp > t)
             {
-                while (((this->pOrgsIn_ioffsets[level][from]).tstamp > t) && (from > -1))
+                while ((from > -1) && ((this->pOrgsIn_ioffsets[level][from]).tstamp > t))
                     from--;
-                if (((this->pOrgsIn_ioffsets[level][from]).tstamp != t) || (from == -1))
+                if ((from == -1) || ((this->pOrgsIn_ioffsets[level][from]).tstamp != t))
                     from++;
             }
 
@@ -702,7 +1773,7 @@ inline bool HINT_M_ALL::getBoundsS_OrgsIn(unsigned int level, Timestamp t, Parti
 }
 
 
-inline bool HINT_M_ALL::getBoundsE_OrgsIn(unsigned int level, Timestamp t, PartitionId &next_from, vector<pair<Timestamp, Timestamp> >::iterator &iterEnd, RelationIdIterator &iterI)
+inline bool HINT_M_ALL::getBoundsE_OrgsIn(unsigned int level, Timestamp t, PartitionId &next_from, TimestampArrayIterator &iterEnd, RelationIdIterator &iterI)
 {
     OffsetEntry_ALL_OrgsIn qdummy;
     Offsets_ALL_OrgsIn_Iterator iterIO, iterIOBegin, iterIOEnd;
@@ -713,7 +1784,7 @@ inline bool HINT_M_ALL::getBoundsE_OrgsIn(unsigned int level, Timestamp t, Parti
     if (cnt > 0)
     {
         // Do binary search or follow vertical pointers.
-        if ((from == -1) || (from > cnt))
+        if ((from == -1) || (from >= cnt))
         {
             qdummy.tstamp = t;
             iterIOBegin = this->pOrgsIn_ioffsets[level].begin();
@@ -723,7 +1794,7 @@ inline bool HINT_M_ALL::getBoundsE_OrgsIn(unsigned int level, Timestamp t, Parti
             if ((iterIO != iterIOEnd) && (iterIO->tstamp <= t))
             {
                 iterI = this->pOrgsInIds[level].begin();
-                iterEnd = ((iterIO+1 != iterIOEnd) ? (iterIO+1)->iterT : this->pOrgsInTimestamps[level].end());
+                iterEnd = ((iterIO+1 != iterIOEnd) ? (iterIO+1)->iterT : this->pOrgsInStarts[level].end());
 
                 next_from = iterIO->pid;
 
@@ -737,13 +1808,13 @@ inline bool HINT_M_ALL::getBoundsE_OrgsIn(unsigned int level, Timestamp t, Parti
             Timestamp tmp = (this->pOrgsIn_ioffsets[level][from]).tstamp;
             if (tmp < t)
             {
-                while (((this->pOrgsIn_ioffsets[level][from]).tstamp < t) && (from < cnt))
+                while ((from < cnt) && ((this->pOrgsIn_ioffsets[level][from]).tstamp < t))
                     from++;
                 from--;
             }
             else if (tmp >= t)
             {
-                while (((this->pOrgsIn_ioffsets[level][from]).tstamp >= t) && (from > -1))
+                while ((from > -1) && ((this->pOrgsIn_ioffsets[level][from]).tstamp >= t))
                     from--;
 //                if ((get<0>(this->pOrgsIn_ioffsets[level][from]) != t) || (from == -1))
 //                    from++;
@@ -752,7 +1823,7 @@ inline bool HINT_M_ALL::getBoundsE_OrgsIn(unsigned int level, Timestamp t, Parti
             if ((from != -1) && (from != cnt))
             {
                 iterI = this->pOrgsInIds[level].begin();
-                iterEnd = ((from+1 != cnt) ? (this->pOrgsIn_ioffsets[level][from+1]).iterT : this->pOrgsInTimestamps[level].end());
+                iterEnd = ((from+1 != cnt) ? (this->pOrgsIn_ioffsets[level][from+1]).iterT : this->pOrgsInStarts[level].end());
 
                 next_from = (this->pOrgsIn_ioffsets[level][from]).pid;
 
@@ -789,7 +1860,7 @@ inline bool HINT_M_ALL::getBounds_OrgsIn(unsigned int level, Timestamp a, Timest
         to = next_to;
 
         // Do binary search or follow vertical pointers.
-        if ((from == -1) || (to == -1))
+        if ((from == -1) || (from >= cnt) || (to == -1))
         {
             qdummyA.tstamp = a;
             iterIOBegin = this->pOrgsIn_ioffsets[level].begin();
@@ -828,28 +1899,28 @@ inline bool HINT_M_ALL::getBounds_OrgsIn(unsigned int level, Timestamp a, Timest
             Timestamp tmp = (this->pOrgsIn_ioffsets[level][from]).tstamp;
             if (tmp < a)
             {
-                while (((this->pOrgsIn_ioffsets[level][from]).tstamp < a) && (from < cnt))
+                while ((from < cnt) && ((this->pOrgsIn_ioffsets[level][from]).tstamp < a))
                     from++;
             }
             else if (tmp > a)
             {
-                while (((this->pOrgsIn_ioffsets[level][from]).tstamp > a) && (from > -1))
+                while ((from > -1) && ((this->pOrgsIn_ioffsets[level][from]).tstamp > a))
                     from--;
-                if (((this->pOrgsIn_ioffsets[level][from]).tstamp != a) || (from == -1))
+                if ((from == -1) || ((this->pOrgsIn_ioffsets[level][from]).tstamp != a))
                     from++;
             }
 
             tmp = (this->pOrgsIn_ioffsets[level][to]).tstamp;
             if (tmp > b)
             {
-                while (((this->pOrgsIn_ioffsets[level][to]).tstamp > b) && (to > -1))
+                while ((to > -1) && ((this->pOrgsIn_ioffsets[level][to]).tstamp > b))
                     to--;
                 to++;
             }
 //                else if (tmp <= b)
             else if (tmp == b)
             {
-                while (((this->pOrgsIn_ioffsets[level][to]).tstamp <= b) && (to < cnt))
+                while ((to < cnt) && ((this->pOrgsIn_ioffsets[level][to]).tstamp <= b))
                     to++;
             }
 
@@ -892,7 +1963,7 @@ inline bool HINT_M_ALL::getBounds_OrgsAft(unsigned int level, Timestamp t, Parti
 
     if (cnt > 0)
     {
-        if ((from == -1) || (from > cnt))
+        if ((from == -1) || (from >= cnt))
         {
             qdummy.tstamp = t;
             iterIOBegin = this->pOrgsAft_ioffsets[level].begin();
@@ -915,14 +1986,14 @@ inline bool HINT_M_ALL::getBounds_OrgsAft(unsigned int level, Timestamp t, Parti
             Timestamp tmp = (this->pOrgsAft_ioffsets[level][from]).tstamp;
             if (tmp < t)
             {
-                while (((this->pOrgsAft_ioffsets[level][from]).tstamp < t) && (from < cnt))
+                while ((from < cnt) && ((this->pOrgsAft_ioffsets[level][from]).tstamp < t))
                     from++;
             }
             else if (tmp > t)
             {
-                while (((this->pOrgsAft_ioffsets[level][from]).tstamp > t) && (from > -1))
+                while ((from > -1) && ((this->pOrgsAft_ioffsets[level][from]).tstamp > t))
                     from--;
-                if (((this->pOrgsAft_ioffsets[level][from]).tstamp != t) || (from == -1))
+                if ((from == -1) || ((this->pOrgsAft_ioffsets[level][from]).tstamp != t))
                     from++;
             }
 
@@ -952,7 +2023,7 @@ inline bool HINT_M_ALL::getBounds_OrgsAft(unsigned int level, Timestamp t, Parti
 }
 
 
-inline bool HINT_M_ALL::getBounds_OrgsAft(unsigned int level, Timestamp t, PartitionId &next_from, vector<Timestamp>::iterator &iterBegin, vector<Timestamp>::iterator &iterEnd, RelationIdIterator &iterI)
+inline bool HINT_M_ALL::getBounds_OrgsAft(unsigned int level, Timestamp t, PartitionId &next_from, TimestampArrayIterator &iterBegin, TimestampArrayIterator &iterEnd, RelationIdIterator &iterI)
 {
     OffsetEntry_ALL_OrgsAft qdummy;
     Offsets_ALL_OrgsAft_Iterator iterIO, iterIOBegin, iterIOEnd;
@@ -962,7 +2033,7 @@ inline bool HINT_M_ALL::getBounds_OrgsAft(unsigned int level, Timestamp t, Parti
     if (cnt > 0)
     {
         // Do binary search or follow vertical pointers.
-        if ((from == -1) || (from > cnt))
+        if ((from == -1) || (from >= cnt))
         {
             qdummy.tstamp = t;
             iterIOBegin = this->pOrgsAft_ioffsets[level].begin();
@@ -986,14 +2057,14 @@ inline bool HINT_M_ALL::getBounds_OrgsAft(unsigned int level, Timestamp t, Parti
             Timestamp tmp = (this->pOrgsAft_ioffsets[level][from]).tstamp;
             if (tmp < t)
             {
-                while (((this->pOrgsAft_ioffsets[level][from]).tstamp < t) && (from < cnt))
+                while ((from < cnt) && ((this->pOrgsAft_ioffsets[level][from]).tstamp < t))
                     from++;
             }
             else if (tmp > t)
             {
-                while (((this->pOrgsAft_ioffsets[level][from]).tstamp > t) && (from > -1))
+                while ((from > -1) && ((this->pOrgsAft_ioffsets[level][from]).tstamp > t))
                     from--;
-                if (((this->pOrgsAft_ioffsets[level][from]).tstamp != t) || (from == -1))
+                if ((from == -1) || ((this->pOrgsAft_ioffsets[level][from]).tstamp != t))
                     from++;
             }
 
@@ -1024,7 +2095,7 @@ inline bool HINT_M_ALL::getBounds_OrgsAft(unsigned int level, Timestamp t, Parti
 }
 
 
-inline bool HINT_M_ALL::getBoundsS_OrgsAft(unsigned int level, Timestamp t, PartitionId &next_from, vector<Timestamp>::iterator &iterBegin, RelationIdIterator &iterI)
+inline bool HINT_M_ALL::getBoundsS_OrgsAft(unsigned int level, Timestamp t, PartitionId &next_from, TimestampArrayIterator &iterBegin, RelationIdIterator &iterI)
 {
     OffsetEntry_ALL_OrgsAft qdummy;
     Offsets_ALL_OrgsAft_Iterator iterIO, iterIOBegin, iterIOEnd;
@@ -1035,7 +2106,7 @@ inline bool HINT_M_ALL::getBoundsS_OrgsAft(unsigned int level, Timestamp t, Part
     if (cnt > 0)
     {
         // Do binary search or follow vertical pointers.
-        if ((from == -1) || (from > cnt))
+        if ((from == -1) || (from >= cnt))
         {
             qdummy.tstamp = t;
             iterIOBegin = this->pOrgsAft_ioffsets[level].begin();
@@ -1059,14 +2130,14 @@ inline bool HINT_M_ALL::getBoundsS_OrgsAft(unsigned int level, Timestamp t, Part
             Timestamp tmp = (this->pOrgsAft_ioffsets[level][from]).tstamp;
             if (tmp < t)
             {
-                while (((this->pOrgsAft_ioffsets[level][from]).tstamp < t) && (from < cnt))
+                while ((from < cnt) && ((this->pOrgsAft_ioffsets[level][from]).tstamp < t))
                     from++;
             }
             else if (tmp > t)
             {
-                while (((this->pOrgsAft_ioffsets[level][from]).tstamp > t) && (from > -1))
+                while ((from > -1) && ((this->pOrgsAft_ioffsets[level][from]).tstamp > t))
                     from--;
-                if (((this->pOrgsAft_ioffsets[level][from]).tstamp != t) || (from == -1))
+                if ((from == -1) || ((this->pOrgsAft_ioffsets[level][from]).tstamp != t))
                     from++;
             }
 
@@ -1107,7 +2178,7 @@ inline bool HINT_M_ALL::getBounds_OrgsAft(unsigned int level, Timestamp a, Times
     if (cnt > 0)
     {
         // Do binary search or follow vertical pointers.
-        if ((from == -1) || (to == -1))
+        if ((from == -1) || (from >= cnt) || (to == -1))
         {
             qdummyA.tstamp = a;
             iterIOBegin = this->pOrgsAft_ioffsets[level].begin();
@@ -1146,28 +2217,28 @@ inline bool HINT_M_ALL::getBounds_OrgsAft(unsigned int level, Timestamp a, Times
             Timestamp tmp = (this->pOrgsAft_ioffsets[level][from]).tstamp;
             if (tmp < a)
             {
-                while (((this->pOrgsAft_ioffsets[level][from]).tstamp < a) && (from < cnt))
+                while ((from < cnt) && ((this->pOrgsAft_ioffsets[level][from]).tstamp < a))
                     from++;
             }
             else if (tmp > a)
             {
-                while (((this->pOrgsAft_ioffsets[level][from]).tstamp > a) && (from > -1))
+                while ((from > -1) && ((this->pOrgsAft_ioffsets[level][from]).tstamp > a))
                     from--;
-                if (((this->pOrgsAft_ioffsets[level][from]).tstamp != a) || (from == -1))
+                if ((from == -1) || ((this->pOrgsAft_ioffsets[level][from]).tstamp != a))
                     from++;
             }
 
             tmp = (this->pOrgsAft_ioffsets[level][to]).tstamp;
             if (tmp > b)
             {
-                while (((this->pOrgsAft_ioffsets[level][to]).tstamp > b) && (to > -1))
+                while ((to > -1) && ((this->pOrgsAft_ioffsets[level][to]).tstamp > b))
                     to--;
                 to++;
             }
 //                else if (tmp <= b)
             else if (tmp == b)
             {
-                while (((this->pOrgsAft_ioffsets[level][to]).tstamp <= b) && (to < cnt))
+                while ((to < cnt) && ((this->pOrgsAft_ioffsets[level][to]).tstamp <= b))
                     to++;
             }
 
@@ -1199,7 +2270,7 @@ inline bool HINT_M_ALL::getBounds_OrgsAft(unsigned int level, Timestamp a, Times
 }
 
 
-inline bool HINT_M_ALL::getBounds_OrgsAft(unsigned int level, Timestamp a, Timestamp b, PartitionId &next_from, PartitionId &next_to, vector<Timestamp>::iterator &iterBegin, vector<Timestamp>::iterator &iterEnd, RelationIdIterator &iterI)
+inline bool HINT_M_ALL::getBounds_OrgsAft(unsigned int level, Timestamp a, Timestamp b, PartitionId &next_from, PartitionId &next_to, TimestampArrayIterator &iterBegin, TimestampArrayIterator &iterEnd, RelationIdIterator &iterI)
 {
     OffsetEntry_ALL_OrgsAft qdummyA, qdummyB;
     Offsets_ALL_OrgsAft_Iterator iterIO, iterIO2, iterIOBegin, iterIOEnd;
@@ -1210,7 +2281,7 @@ inline bool HINT_M_ALL::getBounds_OrgsAft(unsigned int level, Timestamp a, Times
     if (cnt > 0)
     {
         // Do binary search or follow vertical pointers.
-        if ((from == -1) || (to == -1))
+        if ((from == -1) || (from >= cnt) || (to == -1))
         {
             qdummyA.tstamp = a;
             iterIOBegin = this->pOrgsAft_ioffsets[level].begin();
@@ -1250,28 +2321,28 @@ inline bool HINT_M_ALL::getBounds_OrgsAft(unsigned int level, Timestamp a, Times
             Timestamp tmp = (this->pOrgsAft_ioffsets[level][from]).tstamp;
             if (tmp < a)
             {
-                while (((this->pOrgsAft_ioffsets[level][from]).tstamp < a) && (from < cnt))
+                while ((from < cnt) && ((this->pOrgsAft_ioffsets[level][from]).tstamp < a))
                     from++;
             }
             else if (tmp > a)
             {
-                while (((this->pOrgsAft_ioffsets[level][from]).tstamp > a) && (from > -1))
+                while ((from > -1) && ((this->pOrgsAft_ioffsets[level][from]).tstamp > a))
                     from--;
-                if (((this->pOrgsAft_ioffsets[level][from]).tstamp != a) || (from == -1))
+                if ((from == -1) || ((this->pOrgsAft_ioffsets[level][from]).tstamp != a))
                     from++;
             }
 
             tmp = (this->pOrgsAft_ioffsets[level][to]).tstamp;
             if (tmp > b)
             {
-                while (((this->pOrgsAft_ioffsets[level][to]).tstamp > b) && (to > -1))
+                while ((to > -1) && ((this->pOrgsAft_ioffsets[level][to]).tstamp > b))
                     to--;
                 to++;
             }
 //                else if (tmp <= b)
             else if (tmp == b)
             {
-                while (((this->pOrgsAft_ioffsets[level][to]).tstamp <= b) && (to < cnt))
+                while ((to < cnt) && ((this->pOrgsAft_ioffsets[level][to]).tstamp <= b))
                     to++;
             }
 
@@ -1315,7 +2386,7 @@ inline bool HINT_M_ALL::getBounds_RepsIn(unsigned int level, Timestamp t, Partit
     if (cnt > 0)
     {
         // Do binary search or follow vertical pointers.
-        if ((from == -1) || (from > cnt))
+        if ((from == -1) || (from >= cnt))
         {
             qdummy.tstamp = t;
             iterIOBegin = this->pRepsIn_ioffsets[level].begin();
@@ -1338,14 +2409,14 @@ inline bool HINT_M_ALL::getBounds_RepsIn(unsigned int level, Timestamp t, Partit
             Timestamp tmp = (this->pRepsIn_ioffsets[level][from]).tstamp;
             if (tmp < t)
             {
-                while (((this->pRepsIn_ioffsets[level][from]).tstamp < t) && (from < cnt))
+                while ((from < cnt) && ((this->pRepsIn_ioffsets[level][from]).tstamp < t))
                     from++;
             }
             else if (tmp > t)
             {
-                while (((this->pRepsIn_ioffsets[level][from]).tstamp > t) && (from > -1))
+                while ((from > -1) && ((this->pRepsIn_ioffsets[level][from]).tstamp > t))
                     from--;
-                if (((this->pRepsIn_ioffsets[level][from]).tstamp != t) || (from == -1))
+                if ((from == -1) || ((this->pRepsIn_ioffsets[level][from]).tstamp != t))
                     from++;
             }
 
@@ -1374,7 +2445,7 @@ inline bool HINT_M_ALL::getBounds_RepsIn(unsigned int level, Timestamp t, Partit
 }
 
 
-inline bool HINT_M_ALL::getBounds_RepsIn(unsigned int level, Timestamp t, PartitionId &next_from, vector<Timestamp>::iterator &iterBegin, vector<Timestamp>::iterator  &iterEnd, RelationIdIterator &iterI)
+inline bool HINT_M_ALL::getBounds_RepsIn(unsigned int level, Timestamp t, PartitionId &next_from, TimestampArrayIterator &iterBegin, TimestampArrayIterator  &iterEnd, RelationIdIterator &iterI)
 {
     OffsetEntry_ALL_RepsIn qdummy;
     Offsets_ALL_RepsIn_Iterator iterIO, iterIOBegin, iterIOEnd;
@@ -1385,7 +2456,7 @@ inline bool HINT_M_ALL::getBounds_RepsIn(unsigned int level, Timestamp t, Partit
     if (cnt > 0)
     {
         // Do binary search or follow vertical pointers.
-        if ((from == -1) || (from > cnt))
+        if ((from == -1) || (from >= cnt))
         {
             qdummy.tstamp = t;
             iterIOBegin = this->pRepsIn_ioffsets[level].begin();
@@ -1409,14 +2480,14 @@ inline bool HINT_M_ALL::getBounds_RepsIn(unsigned int level, Timestamp t, Partit
             Timestamp tmp = (this->pRepsIn_ioffsets[level][from]).tstamp;
             if (tmp < t)
             {
-                while (((this->pRepsIn_ioffsets[level][from]).tstamp < t) && (from < cnt))
+                while ((from < cnt) && ((this->pRepsIn_ioffsets[level][from]).tstamp < t))
                     from++;
             }
             else if (tmp > t)
             {
-                while (((this->pRepsIn_ioffsets[level][from]).tstamp > t) && (from > -1))
+                while ((from > -1) && ((this->pRepsIn_ioffsets[level][from]).tstamp > t))
                     from--;
-                if (((this->pRepsIn_ioffsets[level][from]).tstamp != t) || (from == -1))
+                if ((from == -1) || ((this->pRepsIn_ioffsets[level][from]).tstamp != t))
                     from++;
             }
 
@@ -1447,7 +2518,7 @@ inline bool HINT_M_ALL::getBounds_RepsIn(unsigned int level, Timestamp t, Partit
 }
 
 
-inline bool HINT_M_ALL::getBoundsE_RepsIn(unsigned int level, Timestamp t, PartitionId &next_from, vector<Timestamp>::iterator &iterEnd, RelationIdIterator &iterI)
+inline bool HINT_M_ALL::getBoundsE_RepsIn(unsigned int level, Timestamp t, PartitionId &next_from, TimestampArrayIterator &iterEnd, RelationIdIterator &iterI)
 {
     OffsetEntry_ALL_RepsIn qdummy;
     Offsets_ALL_RepsIn_Iterator iterIO, iterIOBegin, iterIOEnd;
@@ -1458,7 +2529,7 @@ inline bool HINT_M_ALL::getBoundsE_RepsIn(unsigned int level, Timestamp t, Parti
     if (cnt > 0)
     {
         // Do binary search or follow vertical pointers.
-        if ((from == -1) || (from > cnt))
+        if ((from == -1) || (from >= cnt))
         {
             qdummy.tstamp = t;
             iterIOBegin = this->pRepsIn_ioffsets[level].begin();
@@ -1482,13 +2553,13 @@ inline bool HINT_M_ALL::getBoundsE_RepsIn(unsigned int level, Timestamp t, Parti
             Timestamp tmp = (this->pRepsIn_ioffsets[level][from]).tstamp;
             if (tmp < t)
             {
-                while (((this->pRepsIn_ioffsets[level][from]).tstamp < t) && (from < cnt))
+                while ((from < cnt) && ((this->pRepsIn_ioffsets[level][from]).tstamp < t))
                     from++;
                 from--;
             }
             else if (tmp >= t)
             {
-                while (((this->pRepsIn_ioffsets[level][from]).tstamp >= t) && (from > -1))
+                while ((from > -1) && ((this->pRepsIn_ioffsets[level][from]).tstamp >= t))
                     from--;
 //                if ((get<0>(this->pRepsIn_ioffsets[level][from]) != t) || (from == -1))
 //                    from++;
@@ -1531,7 +2602,7 @@ inline bool HINT_M_ALL::getBounds_RepsIn(unsigned int level, Timestamp a, Timest
     if (cnt > 0)
     {
         // Adjusting pointers.
-        if ((from == -1) || (to == -1))
+        if ((from == -1) || (from >= cnt) || (to == -1))
         {
             qdummyA.tstamp = a;
             iterIOBegin = this->pRepsIn_ioffsets[level].begin();
@@ -1570,28 +2641,28 @@ inline bool HINT_M_ALL::getBounds_RepsIn(unsigned int level, Timestamp a, Timest
             Timestamp tmp = (this->pRepsIn_ioffsets[level][from]).tstamp;
             if (tmp < a)
             {
-                while (((this->pRepsIn_ioffsets[level][from]).tstamp < a) && (from < cnt))
+                while ((from < cnt) && ((this->pRepsIn_ioffsets[level][from]).tstamp < a))
                     from++;
             }
             else if (tmp > a)
             {
-                while (((this->pRepsIn_ioffsets[level][from]).tstamp > a) && (from > -1))
+                while ((from > -1) && ((this->pRepsIn_ioffsets[level][from]).tstamp > a))
                     from--;
-                if (((this->pRepsIn_ioffsets[level][from]).tstamp != a) || (from == -1))
+                if ((from == -1) || ((this->pRepsIn_ioffsets[level][from]).tstamp != a))
                     from++;
             }
 
             tmp = (this->pRepsIn_ioffsets[level][to]).tstamp;
             if (tmp > b)
             {
-                while (((this->pRepsIn_ioffsets[level][to]).tstamp > b) && (to > -1))
+                while ((to > -1) && ((this->pRepsIn_ioffsets[level][to]).tstamp > b))
                     to--;
                 to++;
             }
 //                else if (tmp <= b)
             else if (tmp == b)
             {
-                while (((this->pRepsIn_ioffsets[level][to]).tstamp <= b) && (to < cnt))
+                while ((to < cnt) && ((this->pRepsIn_ioffsets[level][to]).tstamp <= b))
                     to++;
             }
 
@@ -1634,7 +2705,7 @@ inline bool HINT_M_ALL::getBounds_RepsAft(unsigned int level, Timestamp t, Parti
     if (cnt > 0)
     {
         // Do binary search or follow vertical pointers.
-        if ((from == -1) || (from > cnt))
+        if ((from == -1) || (from >= cnt))
         {
             qdummy.tstamp = t;
             iterIOBegin = this->pRepsAft_ioffsets[level].begin();
@@ -1657,14 +2728,14 @@ inline bool HINT_M_ALL::getBounds_RepsAft(unsigned int level, Timestamp t, Parti
             Timestamp tmp = (this->pRepsAft_ioffsets[level][from]).tstamp;
             if (tmp < t)
             {
-                while (((this->pRepsAft_ioffsets[level][from]).tstamp < t) && (from < cnt))
+                while ((from < cnt) && ((this->pRepsAft_ioffsets[level][from]).tstamp < t))
                     from++;
             }
             else if (tmp > t)
             {
-                while (((this->pRepsAft_ioffsets[level][from]).tstamp > t) && (from > -1))
+                while ((from > -1) && ((this->pRepsAft_ioffsets[level][from]).tstamp > t))
                     from--;
-                if (((this->pRepsAft_ioffsets[level][from]).tstamp != t) || (from == -1))
+                if ((from == -1) || ((this->pRepsAft_ioffsets[level][from]).tstamp != t))
                     from++;
             }
 
@@ -1695,36 +2766,35 @@ inline bool HINT_M_ALL::getBounds_RepsAft(unsigned int level, Timestamp t, Parti
 
 
 // Auxiliary functions to scan partitions.
-inline void HINT_M_ALL::scanFirstPartition_OrgsIn_Equals(unsigned int level, Timestamp a, Timestamp qend, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanFirstPartition_OrgsIn_Equals(unsigned int level, Timestamp a, Timestamp qend, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd, iterE;
     RelationIdIterator iterI;
 
 
     if (this->getBounds_OrgsIn(level, a, next_from, iterBegin, iterEnd, iterI))
     {
-        iter = lower_bound(iterBegin, iterEnd, qdummyS);
+        iter = lower_bound(iterBegin, iterEnd, qdummyS.first);
         iterI += iter-iterBegin;
-        while ((iter != iterEnd) && (qdummyS.first == iter->first))
+        iterE = this->pOrgsInEnds[level].begin()+(iter-this->pOrgsInStarts[level].begin());
+        while ((iter != iterEnd) && (qdummyS.first == *iter))
         {
-            if (qend == iter->second)
+            if (qend == *iterE)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iterI++;
+            iterE++;
             iter++;
         }
     }
 }
 
 
-inline void HINT_M_ALL::scanFirstPartition_OrgsAft_Equals(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, boost::dynamic_bitset<> &vcand)
+inline void HINT_M_ALL::scanFirstPartition_OrgsAft_Equals(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, CandidateSet &vcand)
 {
-    vector<Timestamp>::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
@@ -1734,7 +2804,7 @@ inline void HINT_M_ALL::scanFirstPartition_OrgsAft_Equals(unsigned int level, Ti
         iterI += iter-iterBegin;
         while ((iter != iterEnd) && (qstart == (*iter)))
         {
-            vcand[(*iterI)] = 1;
+            vcand.insert(*iterI);
             iterI++;
             iter++;
         }
@@ -1742,9 +2812,10 @@ inline void HINT_M_ALL::scanFirstPartition_OrgsAft_Equals(unsigned int level, Ti
 }
 
 
-inline void HINT_M_ALL::scanLastPartition_RepsIn_Equals(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, boost::dynamic_bitset<> &vcand, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanLastPartition_RepsIn_Equals(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, CandidateSet &vcand, Sink &result)
 {
-    vector<Timestamp>::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
@@ -1754,13 +2825,9 @@ inline void HINT_M_ALL::scanLastPartition_RepsIn_Equals(unsigned int level, Time
         iterI += iter-iterBegin;
         while ((iter != iterEnd) && (qend == (*iter)))
         {
-            if (vcand[(*iterI)] == 1)
+            if (vcand.contains(*iterI))
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iterI++;
             iter++;
@@ -1769,36 +2836,36 @@ inline void HINT_M_ALL::scanLastPartition_RepsIn_Equals(unsigned int level, Time
 }
 
 
-inline void HINT_M_ALL::scanFirstPartition_OrgsIn_Starts(unsigned int level, Timestamp a, Timestamp qend, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanFirstPartition_OrgsIn_Starts(unsigned int level, Timestamp a, Timestamp qend, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd, iterE;
     RelationIdIterator iterI;
 
 
     if (this->getBounds_OrgsIn(level, a, next_from, iterBegin, iterEnd, iterI))
     {
-        iter = lower_bound(iterBegin, iterEnd, qdummyS, CompareTimestampPairsByStart);
+        iter = lower_bound(iterBegin, iterEnd, qdummyS.first);
         iterI += iter-iterBegin;
-        while ((iter != iterEnd) && (qdummyS.first == iter->first))
+        iterE = this->pOrgsInEnds[level].begin()+(iter-this->pOrgsInStarts[level].begin());
+        while ((iter != iterEnd) && (qdummyS.first == *iter))
         {
-            if (qend < iter->second)
+            if (qend < *iterE)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iterI++;
+            iterE++;
             iter++;
         }
     }
 }
 
 
-inline void HINT_M_ALL::scanFirstPartition_OrgsAft_Starts(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanFirstPartition_OrgsAft_Starts(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, Sink &result)
 {
-    vector<Timestamp>::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
@@ -1808,11 +2875,7 @@ inline void HINT_M_ALL::scanFirstPartition_OrgsAft_Starts(unsigned int level, Ti
         iterI += iter-iterBegin;
         while ((iter != iterEnd) && (qstart == (*iter)))
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
+            result.add(*iterI);
 
             iterI++;
             iter++;
@@ -1821,9 +2884,10 @@ inline void HINT_M_ALL::scanFirstPartition_OrgsAft_Starts(unsigned int level, Ti
 }
 
 
-inline void HINT_M_ALL::scanFirstPartition_OrgsAft_Starts(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, boost::dynamic_bitset<> &vcand, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanFirstPartition_OrgsAft_Starts(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, CandidateSet &vcand, Sink &result)
 {
-    vector<Timestamp>::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
@@ -1833,16 +2897,12 @@ inline void HINT_M_ALL::scanFirstPartition_OrgsAft_Starts(unsigned int level, Ti
         iterI += iter-iterBegin;
         while ((iter != iterEnd) && (qstart == (*iter)))
         {
-            if (vcand[(*iterI)] == 1)
+            if (vcand.contains(*iterI))
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             else
-                vcand[(*iterI)] = 1;
+                vcand.insert(*iterI);
             iterI++;
             iter++;
         }
@@ -1850,9 +2910,10 @@ inline void HINT_M_ALL::scanFirstPartition_OrgsAft_Starts(unsigned int level, Ti
 }
 
 
-inline void HINT_M_ALL::scanLastPartition_RepsIn_Starts(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, boost::dynamic_bitset<> &vcand, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanLastPartition_RepsIn_Starts(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, CandidateSet &vcand, Sink &result)
 {
-    vector<Timestamp>::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
@@ -1862,16 +2923,12 @@ inline void HINT_M_ALL::scanLastPartition_RepsIn_Starts(unsigned int level, Time
         iterI += iter-iterBegin;
         while (iter != iterEnd)
         {
-            if (vcand[(*iterI)] == 1)
+            if (vcand.contains(*iterI))
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             else
-                vcand[(*iterI)] = 1;
+                vcand.insert(*iterI);
             iter++;
             iterI++;
         }
@@ -1879,7 +2936,8 @@ inline void HINT_M_ALL::scanLastPartition_RepsIn_Starts(unsigned int level, Time
 }
 
 
-inline void HINT_M_ALL::scanLastPartition_RepsAft_Starts(unsigned int level, Timestamp a, PartitionId &next_from, boost::dynamic_bitset<> &vcand, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanLastPartition_RepsAft_Starts(unsigned int level, Timestamp a, PartitionId &next_from, CandidateSet &vcand, Sink &result)
 {
     RelationIdIterator iterI, iterIStart, iterIEnd;
 
@@ -1888,65 +2946,57 @@ inline void HINT_M_ALL::scanLastPartition_RepsAft_Starts(unsigned int level, Tim
     {
         for (iterI = iterIStart; iterI != iterIEnd; iterI++)
         {
-            if (vcand[(*iterI)] == 1)
+            if (vcand.contains(*iterI))
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             else
-                vcand[(*iterI)] = 1;
+                vcand.insert(*iterI);
         }
     }
 }
 
 
-inline void HINT_M_ALL::scanFirstPartition_OrgsIn_Started(unsigned int level, Timestamp a, Timestamp qend, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanFirstPartition_OrgsIn_Started(unsigned int level, Timestamp a, Timestamp qend, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd, iterE;
     RelationIdIterator iterI;
 
 
     if (this->getBounds_OrgsIn(level, a, next_from, iterBegin, iterEnd, iterI))
     {
-        iter = lower_bound(iterBegin, iterEnd, qdummyS, CompareTimestampPairsByStart);
+        iter = lower_bound(iterBegin, iterEnd, qdummyS.first);
         iterI += iter-iterBegin;
-        while ((iter != iterEnd) && (qdummyS.first == iter->first))
+        iterE = this->pOrgsInEnds[level].begin()+(iter-this->pOrgsInStarts[level].begin());
+        while ((iter != iterEnd) && (qdummyS.first == *iter))
         {
-            if (qend > iter->second)
+            if (qend > *iterE)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iterI++;
+            iterE++;
             iter++;
         }
     }
 }
 
 
-inline void HINT_M_ALL::scanFirstPartition_OrgsIn_Started(unsigned int level, Timestamp a, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanFirstPartition_OrgsIn_Started(unsigned int level, Timestamp a, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
     if (this->getBounds_OrgsIn(level, a, next_from, iterBegin, iterEnd, iterI))
     {
-        iter = lower_bound(iterBegin, iterEnd, qdummyS, CompareTimestampPairsByStart);
+        iter = lower_bound(iterBegin, iterEnd, qdummyS.first);
         iterI += iter-iterBegin;
-        while ((iter != iterEnd) && (qdummyS.first == iter->first))
+        while ((iter != iterEnd) && (qdummyS.first == *iter))
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
+            result.add(*iterI);
 
             iterI++;
             iter++;
@@ -1954,34 +3004,32 @@ inline void HINT_M_ALL::scanFirstPartition_OrgsIn_Started(unsigned int level, Ti
     }
 }
 
-inline void HINT_M_ALL::scanLastPartition_RepsIn_Started(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, boost::dynamic_bitset<> &vcand, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanLastPartition_RepsIn_Started(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, CandidateSet &vcand, Sink &result)
 {
-    vector<Timestamp>::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
     if (this->getBounds_RepsIn(level, b, next_from, iterBegin, iterEnd, iterI))
     {
-        vector<Timestamp>::iterator pivot = lower_bound(iterBegin, iterEnd, qend);
+        TimestampArrayIterator pivot = lower_bound(iterBegin, iterEnd, qend);
         for (iter = iterBegin; iter != pivot; iter++)
         {
-            if (vcand[(*iterI)] == 1)
+            if (vcand.contains(*iterI))
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             else
-                vcand[(*iterI)] = 1;
+                vcand.insert(*iterI);
             iterI++;
         }
     }
 }
 
 
-inline void HINT_M_ALL::scanPartitions_RepsIn_Started(unsigned int level, Timestamp a, Timestamp b, PartitionId &next_from, PartitionId &next_to, boost::dynamic_bitset<> &vcand, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanPartitions_RepsIn_Started(unsigned int level, Timestamp a, Timestamp b, PartitionId &next_from, PartitionId &next_to, CandidateSet &vcand, Sink &result)
 {
     RelationIdIterator iterI, iterIStart, iterIEnd;
 
@@ -1990,49 +3038,45 @@ inline void HINT_M_ALL::scanPartitions_RepsIn_Started(unsigned int level, Timest
     {
         for (iterI = iterIStart; iterI != iterIEnd; iterI++)
         {
-            if (vcand[(*iterI)] == 1)
+            if (vcand.contains(*iterI))
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             else
-                vcand[(*iterI)] = 1;
+                vcand.insert(*iterI);
         }
     }
 }
 
 
-inline void HINT_M_ALL::scanLastPartition_OrgsIn_Finishes(unsigned int level, Timestamp b, Timestamp qend, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanLastPartition_OrgsIn_Finishes(unsigned int level, Timestamp b, Timestamp qend, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd, iterE;
     RelationIdIterator iterI;
 
 
     if (this->getBounds_OrgsIn(level, b, next_from, iterBegin, iterEnd, iterI))
     {
-        vector<pair<Timestamp, Timestamp> >::iterator pivot = lower_bound(iterBegin, iterEnd, qdummyS, CompareTimestampPairsByStart);
+        TimestampArrayIterator pivot = lower_bound(iterBegin, iterEnd, qdummyS.first);
+        iterE = this->pOrgsInEnds[level].begin()+(iterBegin-this->pOrgsInStarts[level].begin());
         for (iter = iterBegin; iter != pivot; iter++)
         {
-            if (qend == iter->second)
+            if (qend == *iterE)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iterI++;
+            iterE++;
         }
     }
 }
 
 
-inline void HINT_M_ALL::scanFirstPartition_OrgsAft_Finishes(unsigned int level, Timestamp a, PartitionId &next_from, boost::dynamic_bitset<> &vcand, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanFirstPartition_OrgsAft_Finishes(unsigned int level, Timestamp a, PartitionId &next_from, CandidateSet &vcand, Sink &result)
 {
-    vector<Timestamp>::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
@@ -2040,52 +3084,46 @@ inline void HINT_M_ALL::scanFirstPartition_OrgsAft_Finishes(unsigned int level,
     {
         for (iter = iterBegin; iter != iterEnd; iter++)
         {
-            if (vcand[(*iterI)] == 1)
+            if (vcand.contains(*iterI))
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             else
-                vcand[(*iterI)] = 1;
+                vcand.insert(*iterI);
             iterI++;
         }
     }
 }
 
 
-inline void HINT_M_ALL::scanFirstPartition_OrgsAft_Finishes(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, boost::dynamic_bitset<> &vcand, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanFirstPartition_OrgsAft_Finishes(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, CandidateSet &vcand, Sink &result)
 {
-    vector<Timestamp>::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
     if (this->getBounds_OrgsAft(level, a, next_from, iterBegin, iterEnd, iterI))
     {
-        vector<Timestamp>::iterator pivot = lower_bound(iterBegin, iterEnd, qstart);
+        TimestampArrayIterator pivot = lower_bound(iterBegin, iterEnd, qstart);
         for (iter = iterBegin; iter != pivot; iter++)
         {
-            if (vcand[(*iterI)] == 1)
+            if (vcand.contains(*iterI))
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             else
-                vcand[(*iterI)] = 1;
+                vcand.insert(*iterI);
             iterI++;
         }
     }
 }
 
 
-inline void HINT_M_ALL::scanLastPartition_RepsIn_Finishes(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanLastPartition_RepsIn_Finishes(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, Sink &result)
 {
-    vector<Timestamp>::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
@@ -2095,11 +3133,7 @@ inline void HINT_M_ALL::scanLastPartition_RepsIn_Finishes(unsigned int level, Ti
         iterI += iter-iterBegin;
         while ((iter != iterEnd) && (qend == (*iter)))
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
+            result.add(*iterI);
 
             iterI++;
             iter++;
@@ -2108,9 +3142,10 @@ inline void HINT_M_ALL::scanLastPartition_RepsIn_Finishes(unsigned int level, Ti
 }
 
 
-inline void HINT_M_ALL::scanLastPartition_RepsIn_Finishes(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, boost::dynamic_bitset<> &vcand, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanLastPartition_RepsIn_Finishes(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, CandidateSet &vcand, Sink &result)
 {
-    vector<Timestamp>::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
@@ -2120,16 +3155,12 @@ inline void HINT_M_ALL::scanLastPartition_RepsIn_Finishes(unsigned int level, Ti
         iterI += iter-iterBegin;
         while ((iter != iterEnd) && (qend == (*iter)))
         {
-            if (vcand[(*iterI)] == 1)
+            if (vcand.contains(*iterI))
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             else
-                vcand[(*iterI)] = 1;
+                vcand.insert(*iterI);
             iterI++;
             iter++;
         }
@@ -2137,60 +3168,59 @@ inline void HINT_M_ALL::scanLastPartition_RepsIn_Finishes(unsigned int level, Ti
 }
 
 
-inline void HINT_M_ALL::scanLastPartition_OrgsIn_Finished(unsigned int level, Timestamp b, Timestamp qend, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanLastPartition_OrgsIn_Finished(unsigned int level, Timestamp b, Timestamp qend, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd, iterE;
     RelationIdIterator iterI;
 
 
     if (this->getBounds_OrgsIn(level, b, next_from, iterBegin, iterEnd, iterI))
     {
-        iter = lower_bound(iterBegin, iterEnd, qdummyS, CompareTimestampPairsByStart);
+        iter = lower_bound(iterBegin, iterEnd, qdummyS.first);
         iterI += iter-iterBegin;
+        iterE = this->pOrgsInEnds[level].begin()+(iter-this->pOrgsInStarts[level].begin());
         while (iter != iterEnd)
         {
-            if (qend == iter->second)
+            if (qend == *iterE)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iter++;
             iterI++;
+            iterE++;
         }
     }
 }
 
 
-inline void HINT_M_ALL::scanLastPartition_OrgsIn_Finished(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanLastPartition_OrgsIn_Finished(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd, iterE;
     RelationIdIterator iterI;
 
 
     if (this->getBounds_OrgsIn(level, b, next_from, iterBegin, iterEnd, iterI))
     {
+        iterE = this->pOrgsInEnds[level].begin()+(iterBegin-this->pOrgsInStarts[level].begin());
         for (iter = iterBegin; iter != iterEnd; iter++)
         {
-            if (qend == iter->second)
+            if (qend == *iterE)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iterI++;
+            iterE++;
         }
     }
 }
 
 
-inline void HINT_M_ALL::scanFirstPartition_OrgsAft_Finished(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, boost::dynamic_bitset<> &vcand, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanFirstPartition_OrgsAft_Finished(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, CandidateSet &vcand, Sink &result)
 {
-    vector<Timestamp>::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
@@ -2200,16 +3230,12 @@ inline void HINT_M_ALL::scanFirstPartition_OrgsAft_Finished(unsigned int level,
         iterI += iter-iterBegin;
         while (iter != iterEnd)
         {
-            if (vcand[(*iterI)] == 1)
+            if (vcand.contains(*iterI))
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             else
-                vcand[(*iterI)] = 1;
+                vcand.insert(*iterI);
             iterI++;
             iter++;
         }
@@ -2217,10 +3243,11 @@ inline void HINT_M_ALL::scanFirstPartition_OrgsAft_Finished(unsigned int level,
 }
 
 
-inline void HINT_M_ALL::scanPartitions_OrgsAft_Finished(unsigned int level, Timestamp a, Timestamp b, PartitionId &next_from, PartitionId &next_to, boost::dynamic_bitset<> &vcand, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanPartitions_OrgsAft_Finished(unsigned int level, Timestamp a, Timestamp b, PartitionId &next_from, PartitionId &next_to, CandidateSet &vcand, Sink &result)
 {
     RelationIdIterator iterI, iterIStart, iterIEnd;
-    vector<Timestamp>::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd;
     PartitionId from = next_from, to = next_to;
 
 
@@ -2228,39 +3255,32 @@ inline void HINT_M_ALL::scanPartitions_OrgsAft_Finished(unsigned int level, Time
     {
         for (iter = iterBegin; iter != iterEnd; iter++)
         {
-            if (vcand[(*iterI)] == 1)
+            if (vcand.contains(*iterI))
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             else
-                vcand[(*iterI)] = 1;
+                vcand.insert(*iterI);
             iterI++;
         }
     }
 }
 
 
-inline void HINT_M_ALL::scanFirstPartition_OrgsIn_Meets(unsigned int level, Timestamp a, Timestamp qstart, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanFirstPartition_OrgsIn_Meets(unsigned int level, Timestamp a, Timestamp qstart, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
     if (this->getBounds_OrgsIn(level, a, next_from, iterBegin, iterEnd, iterI))
     {
-        iter = lower_bound(iterBegin, iterEnd, qdummyS);
+        iter = lower_bound(iterBegin, iterEnd, qdummyS.first);
         iterI += iter-iterBegin;
-        while ((iter != iterEnd) && (qstart == iter->first))
+        while ((iter != iterEnd) && (qstart == *iter))
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
+            result.add(*iterI);
 
             iterI++;
             iter++;
@@ -2269,9 +3289,10 @@ inline void HINT_M_ALL::scanFirstPartition_OrgsIn_Meets(unsigned int level, Time
 }
 
 
-inline void HINT_M_ALL::scanFirstPartition_OrgsAft_Meets(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanFirstPartition_OrgsAft_Meets(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, Sink &result)
 {
-    vector<Timestamp>::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
@@ -2281,11 +3302,7 @@ inline void HINT_M_ALL::scanFirstPartition_OrgsAft_Meets(unsigned int level, Tim
         iterI += iter-iterBegin;
         while ((iter != iterEnd) && (qstart == (*iter)))
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
+            result.add(*iterI);
 
             iterI++;
             iter++;
@@ -2294,33 +3311,33 @@ inline void HINT_M_ALL::scanFirstPartition_OrgsAft_Meets(unsigned int level, Tim
 }
 
 
-inline void HINT_M_ALL::scanLastPartition_OrgsIn_Met(unsigned int level, Timestamp a, Timestamp qend, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanLastPartition_OrgsIn_Met(unsigned int level, Timestamp a, Timestamp qend, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd, iterE;
     RelationIdIterator iterI;
 
 
     if (this->getBounds_OrgsIn(level, a, next_from, iterBegin, iterEnd, iterI))
     {
+        iterE = this->pOrgsInEnds[level].begin()+(iterBegin-this->pOrgsInStarts[level].begin());
         for (iter = iterBegin; iter != iterEnd; iter++)
         {
-            if (qend == iter->second)
+            if (qend == *iterE)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iterI++;
+            iterE++;
         }
     }
 }
 
 
-inline void HINT_M_ALL::scanLastPartition_RepsIn_Met(unsigned int level, Timestamp a, Timestamp qend, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanLastPartition_RepsIn_Met(unsigned int level, Timestamp a, Timestamp qend, PartitionId &next_from, Sink &result)
 {
-    vector<Timestamp>::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
@@ -2330,11 +3347,7 @@ inline void HINT_M_ALL::scanLastPartition_RepsIn_Met(unsigned int level, Timesta
         iterI += iter-iterBegin;
         while ((iter != iterEnd) && (qend == (*iter)))
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
+            result.add(*iterI);
 
             iterI++;
             iter++;
@@ -2343,36 +3356,36 @@ inline void HINT_M_ALL::scanLastPartition_RepsIn_Met(unsigned int level, Timesta
 }
 
 
-inline void HINT_M_ALL::scanFirstPartition_OrgsIn_Overlaps(unsigned int level, Timestamp a, Timestamp qend, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanFirstPartition_OrgsIn_Overlaps(unsigned int level, Timestamp a, Timestamp qend, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd, iterE;
     RelationIdIterator iterI;
 
 
     if (this->getBounds_OrgsIn(level, a, next_from, iterBegin, iterEnd, iterI))
     {
-        iter = lower_bound(iterBegin, iterEnd, qdummyS, CompareTimestampPairsByStart);
+        iter = lower_bound(iterBegin, iterEnd, qdummyS.first);
         iterI += iter-iterBegin;
-        while ((iter != iterEnd) && (qend > iter->first))
+        iterE = this->pOrgsInEnds[level].begin()+(iter-this->pOrgsInStarts[level].begin());
+        while ((iter != iterEnd) && (qend > *iter))
         {
-            if (qend < iter->second)
+            if (qend < *iterE)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iter++;
             iterI++;
+            iterE++;
         }
     }
 }
 
 
-inline void HINT_M_ALL::scanFirstPartition_OrgsAft_Overlaps(unsigned int level, Timestamp a, Timestamp qstart, Timestamp qend, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanFirstPartition_OrgsAft_Overlaps(unsigned int level, Timestamp a, Timestamp qstart, Timestamp qend, PartitionId &next_from, Sink &result)
 {
-    vector<Timestamp>::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
@@ -2382,11 +3395,7 @@ inline void HINT_M_ALL::scanFirstPartition_OrgsAft_Overlaps(unsigned int level,
         iterI += iter-iterBegin;
         while ((iter != iterEnd) && (qend > (*iter)))
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
+            result.add(*iterI);
 
             iter++;
             iterI++;
@@ -2395,131 +3404,120 @@ inline void HINT_M_ALL::scanFirstPartition_OrgsAft_Overlaps(unsigned int level,
 }
 
 
-inline void HINT_M_ALL::scanLastPartition_OrgsIn_Overlaps(unsigned int level, Timestamp b, pair<Timestamp, Timestamp> qdummyE, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanLastPartition_OrgsIn_Overlaps(unsigned int level, Timestamp b, pair<Timestamp, Timestamp> qdummyE, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd, iterE;
     RelationIdIterator iterI;
 
 
     if (this->getBounds_OrgsIn(level, b, next_from, iterBegin, iterEnd, iterI))
     {
-        vector<pair<Timestamp, Timestamp> >::iterator pivot = lower_bound(iterBegin, iterEnd, qdummyE, CompareTimestampPairsByStart);
+        TimestampArrayIterator pivot = lower_bound(iterBegin, iterEnd, qdummyE.first);
+        iterE = this->pOrgsInEnds[level].begin()+(iterBegin-this->pOrgsInStarts[level].begin());
         for (iter = iterBegin; iter != pivot; iter++)
         {
-            if (qdummyE.first < iter->second)
+            if (qdummyE.first < *iterE)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= *iterI;
-#endif
+                result.add(*iterI);
             }
             iterI++;
+            iterE++;
         }
     }
 }
 
 
-inline void HINT_M_ALL::scanLastPartition_OrgsAft_Overlaps(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanLastPartition_OrgsAft_Overlaps(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, Sink &result)
 {
-    vector<Timestamp>::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
     if (this->getBounds_OrgsAft(level, b, next_from, iterBegin, iterEnd, iterI))
     {
-        vector<Timestamp>::iterator pivot = lower_bound(iterBegin, iterEnd, qend);
-        for (iter = iterBegin; iter != pivot; iter++)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= *iterI;
-#endif
-
-            iterI++;
-        }
+        TimestampArrayIterator pivot = lower_bound(iterBegin, iterEnd, qend);
+        reportIds(this->kernel, iterI, iterI+(pivot-iterBegin), result);
     }
 }
 
 
-inline void HINT_M_ALL::scanFirstPartition_OrgsIn_Overlapped(unsigned int level, Timestamp a, Timestamp qend, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanFirstPartition_OrgsIn_Overlapped(unsigned int level, Timestamp a, Timestamp qend, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd, iterE;
     RelationIdIterator iterI;
 
 
     if (this->getBounds_OrgsIn(level, a, next_from, iterBegin, iterEnd, iterI))
     {
-        vector<pair<Timestamp, Timestamp> >::iterator pivot = lower_bound(iterBegin, iterEnd, qdummyS, CompareTimestampPairsByStart);
+        TimestampArrayIterator pivot = lower_bound(iterBegin, iterEnd, qdummyS.first);
+        iterE = this->pOrgsInEnds[level].begin()+(iterBegin-this->pOrgsInStarts[level].begin());
         for (iter = iterBegin; iter != pivot; iter++)
         {
-             if ((qdummyS.first < iter->second) && (qend > iter->second))
+             if ((qdummyS.first < *iterE) && (qend > *iterE))
              {
- #ifdef WORKLOAD_COUNT
-                 result++;
- #else
-                 result ^= (*iterI);
- #endif
+                  result.add(*iterI);
              }
              iterI++;
+             iterE++;
          }
     }
 }
 
 
-inline void HINT_M_ALL::scanFirstPartition_OrgsIn_Overlapped(unsigned int level, Timestamp a, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanFirstPartition_OrgsIn_Overlapped(unsigned int level, Timestamp a, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd, iterE;
     RelationIdIterator iterI;
 
 
     if (this->getBounds_OrgsIn(level, a, next_from, iterBegin, iterEnd, iterI))
     {
-        vector<pair<Timestamp, Timestamp> >::iterator pivot = lower_bound(iterBegin, iterEnd, qdummyS, CompareTimestampPairsByStart);
+        TimestampArrayIterator pivot = lower_bound(iterBegin, iterEnd, qdummyS.first);
+        iterE = this->pOrgsInEnds[level].begin()+(iterBegin-this->pOrgsInStarts[level].begin());
         for (iter = iterBegin; iter != pivot; iter++)
         {
-             if (qdummyS.first < iter->second)
+             if (qdummyS.first < *iterE)
              {
- #ifdef WORKLOAD_COUNT
-                 result++;
- #else
-                 result ^= (*iterI);
- #endif
+                  result.add(*iterI);
              }
              iterI++;
+             iterE++;
          }
     }
 }
 
 
-inline void HINT_M_ALL::scanFirstPartition_OrgsIn_Overlapped(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanFirstPartition_OrgsIn_Overlapped(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd, iterE;
     RelationIdIterator iterI;
 
 
     if (this->getBounds_OrgsIn(level, a, next_from, iterBegin, iterEnd, iterI))
     {
+        iterE = this->pOrgsInEnds[level].begin()+(iterBegin-this->pOrgsInStarts[level].begin());
         for (iter = iterBegin; iter != iterEnd; iter++)
         {
-             if (qstart < iter->second)
+             if (qstart < *iterE)
              {
- #ifdef WORKLOAD_COUNT
-                 result++;
- #else
-                 result ^= (*iterI);
- #endif
+                  result.add(*iterI);
              }
              iterI++;
+             iterE++;
          }
     }
 }
 
 
-inline void HINT_M_ALL::scanFirstPartition_RepsIn_Overlapped(unsigned int level, Timestamp a, Timestamp qstart, Timestamp qend, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanFirstPartition_RepsIn_Overlapped(unsigned int level, Timestamp a, Timestamp qstart, Timestamp qend, PartitionId &next_from, Sink &result)
 {
-    vector<Timestamp>::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
@@ -2529,11 +3527,7 @@ inline void HINT_M_ALL::scanFirstPartition_RepsIn_Overlapped(unsigned int level,
         iterI += iter-iterBegin;
         while ((iter != iterEnd) && ((*iter) < qend))
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
+            result.add(*iterI);
 
             iter++;
             iterI++;
@@ -2542,9 +3536,10 @@ inline void HINT_M_ALL::scanFirstPartition_RepsIn_Overlapped(unsigned int level,
 }
 
 
-inline void HINT_M_ALL::scanFirstPartition_RepsIn_Overlapped(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanFirstPartition_RepsIn_Overlapped(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, Sink &result)
 {
-    vector<Timestamp>::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
@@ -2554,11 +3549,7 @@ inline void HINT_M_ALL::scanFirstPartition_RepsIn_Overlapped(unsigned int level,
         iterI += iter-iterBegin;
         while (iter != iterEnd)
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
+            result.add(*iterI);
 
             iter++;
             iterI++;
@@ -2567,77 +3558,70 @@ inline void HINT_M_ALL::scanFirstPartition_RepsIn_Overlapped(unsigned int level,
 }
 
 
-inline void HINT_M_ALL::scanLastPartition_RepsIn_Overlapped(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, boost::dynamic_bitset<> &vcand, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanLastPartition_RepsIn_Overlapped(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, CandidateSet &vcand, Sink &result)
 {
-    vector<Timestamp>::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
     if (this->getBounds_RepsIn(level, b, next_from, iterBegin, iterEnd, iterI))
     {
-        vector<Timestamp>::iterator pivot = lower_bound(iterBegin, iterEnd, qend);
+        TimestampArrayIterator pivot = lower_bound(iterBegin, iterEnd, qend);
         for (iter = iterBegin; iter != pivot; iter++)
         {
-            if (vcand[(*iterI)] == 1)
+            if (vcand.contains(*iterI))
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             else
-                vcand[(*iterI)] = 1;
+                vcand.insert(*iterI);
             iterI++;
         }
     }
 }
 
 
-inline void HINT_M_ALL::scanFirstPartition_OrgsIn_Contains(unsigned int level, Timestamp a, Timestamp qend, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanFirstPartition_OrgsIn_Contains(unsigned int level, Timestamp a, Timestamp qend, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd, iterE;
     RelationIdIterator iterI;
 
 
     if (this->getBounds_OrgsIn(level, a, next_from, iterBegin, iterEnd, iterI))
     {
-        iter = lower_bound(iterBegin, iterEnd, qdummyS, CompareTimestampPairsByStart);
+        iter = lower_bound(iterBegin, iterEnd, qdummyS.first);
         iterI += iter-iterBegin;
+        iterE = this->pOrgsInEnds[level].begin()+(iter-this->pOrgsInStarts[level].begin());
         while (iter != iterEnd)
         {
-            if (qend > iter->second)
+            if (qend > *iterE)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iter++;
             iterI++;
+            iterE++;
         }
     }
 }
 
 
-inline void HINT_M_ALL::scanFirstPartition_OrgsIn_Contains(unsigned int level, Timestamp a, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanFirstPartition_OrgsIn_Contains(unsigned int level, Timestamp a, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
     if (this->getBounds_OrgsIn(level, a, next_from, iterBegin, iterEnd, iterI))
     {
-        iter = lower_bound(iterBegin, iterEnd, qdummyS, CompareTimestampPairsByStart);
+        iter = lower_bound(iterBegin, iterEnd, qdummyS.first);
         iterI += iter-iterBegin;
         while (iter != iterEnd)
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
+            result.add(*iterI);
 
             iterI++;
             iter++;
@@ -2646,33 +3630,33 @@ inline void HINT_M_ALL::scanFirstPartition_OrgsIn_Contains(unsigned int level, T
 }
 
 
-inline void HINT_M_ALL::scanLastPartition_OrgsIn_Contains(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanLastPartition_OrgsIn_Contains(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd, iterE;
     RelationIdIterator iterI;
 
 
     if (this->getBounds_OrgsIn(level, b, next_from, iterBegin, iterEnd, iterI))
     {
+        iterE = this->pOrgsInEnds[level].begin()+(iterBegin-this->pOrgsInStarts[level].begin());
         for (iter = iterBegin; iter != iterEnd; iter++)
         {
-            if (qend > iter->second)
+            if (qend > *iterE)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iterI++;
+            iterE++;
         }
     }
 }
 
 
-inline void HINT_M_ALL::scanFirstPartition_OrgsAft_Contains(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, boost::dynamic_bitset<> &vcand, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanFirstPartition_OrgsAft_Contains(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, CandidateSet &vcand, Sink &result)
 {
-    vector<Timestamp>::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
@@ -2682,16 +3666,12 @@ inline void HINT_M_ALL::scanFirstPartition_OrgsAft_Contains(unsigned int level,
         iterI += iter-iterBegin;
         while (iter != iterEnd)
         {
-            if (vcand[(*iterI)] == 1)
+            if (vcand.contains(*iterI))
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             else
-                vcand[(*iterI)] = 1;
+                vcand.insert(*iterI);
             iterI++;
             iter++;
         }
@@ -2699,86 +3679,75 @@ inline void HINT_M_ALL::scanFirstPartition_OrgsAft_Contains(unsigned int level,
 }
 
 
-inline void HINT_M_ALL::scanFirstPartition_OrgsIn_Contained(unsigned int level, Timestamp a, Timestamp qend, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanFirstPartition_OrgsIn_Contained(unsigned int level, Timestamp a, Timestamp qend, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd, iterE;
     RelationIdIterator iterI;
 
 
     if (this->getBounds_OrgsIn(level, a, next_from, iterBegin, iterEnd, iterI))
     {
-        vector<pair<Timestamp, Timestamp> >::iterator pivot = lower_bound(iterBegin, iterEnd, qdummyS, CompareTimestampPairsByStart);
-//        vector<pair<Timestamp, Timestamp> >::iterator pivot = lower_bound(iterBegin, iterEnd, qdummyS);
+        TimestampArrayIterator pivot = lower_bound(iterBegin, iterEnd, qdummyS.first);
+//        TimestampArrayIterator pivot = lower_bound(iterBegin, iterEnd, qdummyS.first);
+        iterE = this->pOrgsInEnds[level].begin()+(iterBegin-this->pOrgsInStarts[level].begin());
         for (iter = iterBegin; iter != pivot; iter++)
         {
-//            if (iter->first > qdummyS.first)
+//            if (*iter > qdummyS.first)
 //                break;
 
-            if (qend < iter->second)
+            if (qend < *iterE)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iterI++;
+            iterE++;
         }
     }
 }
 
 
-inline void HINT_M_ALL::scanFirstPartition_OrgsAft_Contained(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanFirstPartition_OrgsAft_Contained(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, Sink &result)
 {
-    vector<Timestamp>::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
     if (this->getBounds_OrgsAft(level, a, next_from, iterBegin, iterEnd, iterI))
     {
-        vector<Timestamp>::iterator pivot = lower_bound(iterBegin, iterEnd, qstart);
-        for (iter = iterBegin; iter != pivot; iter++)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
-
-            iterI++;
-        }
+        TimestampArrayIterator pivot = lower_bound(iterBegin, iterEnd, qstart);
+        reportIds(this->kernel, iterI, iterI+(pivot-iterBegin), result);
     }
 }
 
 
-inline void HINT_M_ALL::scanFirstPartition_OrgsAft_Contained(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, boost::dynamic_bitset<> &vcand, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanFirstPartition_OrgsAft_Contained(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, CandidateSet &vcand, Sink &result)
 {
-    vector<Timestamp>::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
     if (this->getBounds_OrgsAft(level, a, next_from, iterBegin, iterEnd, iterI))
     {
-        vector<Timestamp>::iterator pivot = lower_bound(iterBegin, iterEnd, qstart);
+        TimestampArrayIterator pivot = lower_bound(iterBegin, iterEnd, qstart);
         for (iter = iterBegin; iter != pivot; iter++)
         {
-            if (vcand[(*iterI)] == 1)
+            if (vcand.contains(*iterI))
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             else
-                vcand[(*iterI)] = 1;
+                vcand.insert(*iterI);
             iterI++;
         }
     }
 }
 
 
-inline void HINT_M_ALL::scanFirstPartition_RepsAft_Contained(unsigned int level, Timestamp a, PartitionId &next_from, boost::dynamic_bitset<> &vcand, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanFirstPartition_RepsAft_Contained(unsigned int level, Timestamp a, PartitionId &next_from, CandidateSet &vcand, Sink &result)
 {
     RelationIdIterator iterI, iterIStart, iterIEnd;
 
@@ -2787,38 +3756,31 @@ inline void HINT_M_ALL::scanFirstPartition_RepsAft_Contained(unsigned int level,
     {
         for (iterI = iterIStart; iterI != iterIEnd; iterI++)
         {
-            if (vcand[(*iterI)] == 1)
+            if (vcand.contains(*iterI))
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             else
-                vcand[(*iterI)] = 1;
+                vcand.insert(*iterI);
         }
     }
 }
 
 
-inline void HINT_M_ALL::scanLastPartition_OrgsIn_Precedes(unsigned int level, Timestamp b, pair<Timestamp, Timestamp> qdummyE, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanLastPartition_OrgsIn_Precedes(unsigned int level, Timestamp b, pair<Timestamp, Timestamp> qdummyE, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
     if (this->getBounds_OrgsIn(level, b, next_from, iterBegin, iterEnd, iterI))
     {
-        iter = lower_bound(iterBegin, iterEnd, qdummyE);
+        iter = lower_bound(iterBegin, iterEnd, qdummyE.first);
         iterI += iter-iterBegin;
         while (iter != iterEnd)
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
+            result.add(*iterI);
 
             iterI++;
             iter++;
@@ -2827,9 +3789,10 @@ inline void HINT_M_ALL::scanLastPartition_OrgsIn_Precedes(unsigned int level, Ti
 }
 
 
-inline void HINT_M_ALL::scanLastPartition_OrgsAft_Precedes(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanLastPartition_OrgsAft_Precedes(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, Sink &result)
 {
-    vector<Timestamp>::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
@@ -2839,11 +3802,7 @@ inline void HINT_M_ALL::scanLastPartition_OrgsAft_Precedes(unsigned int level, T
         iterI += iter-iterBegin;
         while (iter != iterEnd)
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
+            result.add(*iterI);
 
             iterI++;
             iter++;
@@ -2852,415 +3811,347 @@ inline void HINT_M_ALL::scanLastPartition_OrgsAft_Precedes(unsigned int level, T
 }
 
 
-inline void HINT_M_ALL::scanPartitions_OrgsIn_Precedes(unsigned int level, Timestamp b, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanPartitions_OrgsIn_Precedes(unsigned int level, Timestamp b, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
     if (this->getBoundsS_OrgsIn(level, b, next_from, iterBegin, iterI))
     {
-        iterEnd = this->pOrgsInTimestamps[level].end();
-        for (iter = iterBegin; iter != iterEnd; iter++)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
-
-            iterI++;
-        }
+        iterEnd = this->pOrgsInStarts[level].end();
+        reportIds(this->kernel, iterI, iterI+(iterEnd-iterBegin), result);
     }
 }
 
 
-inline void HINT_M_ALL::scanPartitions_OrgsAft_Precedes(unsigned int level, Timestamp b, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanPartitions_OrgsAft_Precedes(unsigned int level, Timestamp b, PartitionId &next_from, Sink &result)
 {
-    vector<Timestamp>::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
     if (this->getBoundsS_OrgsAft(level, b, next_from, iterBegin, iterI))
     {
         iterEnd = this->pOrgsAftTimestamp[level].end();
-        for (iter = iterBegin; iter != iterEnd; iter++)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= *iterI;
-#endif
-
-            iterI++;
-        }
+        reportIds(this->kernel, iterI, iterI+(iterEnd-iterBegin), result);
     }
 }
 
 
-inline void HINT_M_ALL::scanFirstPartition_OrgsIn_Preceded(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanFirstPartition_OrgsIn_Preceded(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd, iterE;
     RelationIdIterator iterI;
 
 
     if (this->getBounds_OrgsIn(level, a, next_from, iterBegin, iterEnd, iterI))
     {
+        iterE = this->pOrgsInEnds[level].begin()+(iterBegin-this->pOrgsInStarts[level].begin());
         for (iter = iterBegin; iter != iterEnd; iter++)
         {
-            if (qstart > iter->second)
+            if (qstart > *iterE)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iterI++;
+            iterE++;
         }
     }
 }
 
 
-inline void HINT_M_ALL::scanFirstPartition_RepsIn_Preceded(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanFirstPartition_RepsIn_Preceded(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, Sink &result)
 {
-    vector<Timestamp>::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
-    tuple<Timestamp, RelationIdIterator, vector<Timestamp>::iterator, PartitionId> qdummy;
-    vector<tuple<Timestamp, RelationIdIterator, vector<Timestamp>::iterator, PartitionId> >::iterator iterIO, iterIOBegin, iterIOEnd;
+    tuple<Timestamp, RelationIdIterator, TimestampArrayIterator, PartitionId> qdummy;
+    vector<tuple<Timestamp, RelationIdIterator, TimestampArrayIterator, PartitionId> >::iterator iterIO, iterIOBegin, iterIOEnd;
     size_t cnt = this->pRepsIn_ioffsets[level].size();
     PartitionId from = next_from;
 
 
     if (this->getBounds_RepsIn(level, a, next_from, iterBegin, iterEnd, iterI))
     {
-        vector<Timestamp>::iterator pivot = lower_bound(iterBegin, iterEnd, qstart);
-        for (iter = iterBegin; iter != pivot; iter++)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= *iterI;
-#endif
-
-            iterI++;
-        }
+        TimestampArrayIterator pivot = lower_bound(iterBegin, iterEnd, qstart);
+        reportIds(this->kernel, iterI, iterI+(pivot-iterBegin), result);
     }
 }
 
 
-inline void HINT_M_ALL::scanPartitions_OrgsIn_Preceded(unsigned int level, Timestamp a, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanPartitions_OrgsIn_Preceded(unsigned int level, Timestamp a, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
-    tuple<Timestamp, RelationIdIterator, vector<pair<Timestamp, Timestamp> >::iterator, PartitionId> qdummy;
-    vector<tuple<Timestamp, RelationIdIterator, vector<pair<Timestamp, Timestamp> >::iterator, PartitionId> >::iterator iterIO, iterIOBegin, iterIOEnd;
+    tuple<Timestamp, RelationIdIterator, TimestampArrayIterator, PartitionId> qdummy;
+    vector<tuple<Timestamp, RelationIdIterator, TimestampArrayIterator, PartitionId> >::iterator iterIO, iterIOBegin, iterIOEnd;
     size_t cnt = this->pOrgsIn_ioffsets[level].size();
     PartitionId from = next_from;
 
 
     if (this->getBoundsE_OrgsIn(level, a, next_from, iterEnd, iterI))
     {
-        iterBegin = this->pOrgsInTimestamps[level].begin();
-        for (iter = iterBegin; iter != iterEnd; iter++)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
+        iterBegin = this->pOrgsInStarts[level].begin();
+        reportIds(this->kernel, iterI, iterI+(iterEnd-iterBegin), result);
+    }
+}
 
-            iterI++;
-        }
+
+template <class Sink>
+inline void HINT_M_ALL::scanPartitions_RepsIn_Preceded(unsigned int level, Timestamp a, PartitionId &next_from, Sink &result)
+{
+    TimestampArrayIterator iter, iterBegin, iterEnd;
+    RelationIdIterator iterI;
+    tuple<Timestamp, RelationIdIterator, TimestampArrayIterator, PartitionId> qdummy;
+    vector<tuple<Timestamp, RelationIdIterator, TimestampArrayIterator, PartitionId> >::iterator iterIO, iterIOBegin, iterIOEnd;
+    size_t cnt = this->pRepsIn_ioffsets[level].size();
+    PartitionId from = next_from;
+
+
+    if (this->getBoundsE_RepsIn(level, a, next_from, iterEnd, iterI))
+    {
+        iterBegin = this->pRepsInTimestamp[level].begin();
+        reportIds(this->kernel, iterI, iterI+(iterEnd-iterBegin), result);
     }
 }
 
 
-inline void HINT_M_ALL::scanPartitions_RepsIn_Preceded(unsigned int level, Timestamp a, PartitionId &next_from, size_t &result)
+// Report the ids in [iterIStart, iterIEnd) of ids, the array of a partition
+// class at the given level, all of which qualify; an AggregateSink or an
+// XorSink is served by the prefix aggregates of the array, if built, i.e.,
+// with two lookups instead of a pass over the ids.
+template <class Sink>
+inline void HINT_M_ALL::reportRange(PrefixAggregates *, unsigned int, RelationId &, RelationIdIterator iterIStart, RelationIdIterator iterIEnd, Sink &result)
+{
+    reportIds(this->kernel, iterIStart, iterIEnd, result);
+}
+
+
+inline void HINT_M_ALL::reportRange(PrefixAggregates *aggregates, unsigned int level, RelationId &ids, RelationIdIterator iterIStart, RelationIdIterator iterIEnd, AggregateSink &result)
+{
+    if (aggregates != NULL)
+        aggregates[level].report(iterIStart-ids.begin(), iterIEnd-ids.begin(), result);
+    else
+        reportIds(this->kernel, iterIStart, iterIEnd, result);
+}
+
+
+inline void HINT_M_ALL::reportRange(PrefixAggregates *aggregates, unsigned int level, RelationId &ids, RelationIdIterator iterIStart, RelationIdIterator iterIEnd, XorSink &result)
+{
+    if (aggregates != NULL)
+        aggregates[level].report(iterIStart-ids.begin(), iterIEnd-ids.begin(), result);
+    else
+        reportIds(this->kernel, iterIStart, iterIEnd, result);
+}
+
+
+// Same as above, but the ids are only collected to be scanned later, see
+// HierarchicalIndex::scanRanges().
+template <class Sink>
+inline void HINT_M_ALL::collectRange(PrefixAggregates *, unsigned int, RelationId &, RelationIdIterator iterIStart, RelationIdIterator iterIEnd, vector<IdRange> &ranges, Sink &)
+{
+    ranges.emplace_back(iterIStart, iterIEnd);
+}
+
+
+inline void HINT_M_ALL::collectRange(PrefixAggregates *aggregates, unsigned int level, RelationId &ids, RelationIdIterator iterIStart, RelationIdIterator iterIEnd, vector<IdRange> &ranges, AggregateSink &result)
 {
-    vector<Timestamp>::iterator iter, iterBegin, iterEnd;
-    RelationIdIterator iterI;
-    tuple<Timestamp, RelationIdIterator, vector<Timestamp>::iterator, PartitionId> qdummy;
-    vector<tuple<Timestamp, RelationIdIterator, vector<Timestamp>::iterator, PartitionId> >::iterator iterIO, iterIOBegin, iterIOEnd;
-    size_t cnt = this->pRepsIn_ioffsets[level].size();
-    PartitionId from = next_from;
-
+    if (aggregates != NULL)
+        aggregates[level].report(iterIStart-ids.begin(), iterIEnd-ids.begin(), result);
+    else
+        ranges.emplace_back(iterIStart, iterIEnd);
+}
 
-    if (this->getBoundsE_RepsIn(level, a, next_from, iterEnd, iterI))
-    {
-        iterBegin = this->pRepsInTimestamp[level].begin();
-        for (iter = iterBegin; iter != iterEnd; iter++)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
 
-            iterI++;
-        }
-    }
+inline void HINT_M_ALL::collectRange(PrefixAggregates *aggregates, unsigned int level, RelationId &ids, RelationIdIterator iterIStart, RelationIdIterator iterIEnd, vector<IdRange> &ranges, XorSink &result)
+{
+    if (aggregates != NULL)
+        aggregates[level].report(iterIStart-ids.begin(), iterIEnd-ids.begin(), result);
+    else
+        ranges.emplace_back(iterIStart, iterIEnd);
 }
 
 
-inline void HINT_M_ALL::scanFirstPartition_OrgsIn_gOverlaps(unsigned int level, Timestamp a, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanFirstPartition_OrgsIn_gOverlaps(unsigned int level, Timestamp a, PartitionId &next_from, Sink &result)
 {
     RelationIdIterator iterI, iterIStart, iterIEnd;
-    tuple<Timestamp, RelationIdIterator, vector<pair<Timestamp, Timestamp> >::iterator, PartitionId> qdummy;
+    tuple<Timestamp, RelationIdIterator, TimestampArrayIterator, PartitionId> qdummy;
 
 
     if (this->getBounds_OrgsIn(level, a, next_from, iterIStart, iterIEnd))
     {
-        for (iterI = iterIStart; iterI != iterIEnd; iterI++)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
-        }
+        this->reportRange(this->pOrgsInAggregates, level, this->pOrgsInIds[level], iterIStart, iterIEnd, result);
     }
 }
 
 
-inline void HINT_M_ALL::scanFirstPartition_OrgsIn_gOverlaps(unsigned int level, Timestamp a, Timestamp qstart, pair<Timestamp, Timestamp> qdummyE, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanFirstPartition_OrgsIn_gOverlaps(unsigned int level, Timestamp a, Timestamp qstart, pair<Timestamp, Timestamp> qdummyE, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
     if (this->getBounds_OrgsIn(level, a, next_from, iterBegin, iterEnd, iterI))
     {
-        vector<pair<Timestamp, Timestamp> >::iterator pivot = lower_bound(iterBegin, iterEnd, qdummyE);
-        for (iter = iterBegin; iter != pivot; iter++)
-        {
-            if (qstart <= iter->second)
-            {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
-            }
-            iterI++;
-        }
+        TimestampArrayIterator pivot = lower_bound(iterBegin, iterEnd, qdummyE.first);
+        auto pos = iterBegin-this->pOrgsInStarts[level].begin();
+        scanNotBefore(this->kernel, this->pOrgsInEnds[level].data()+pos, this->pOrgsInIds[level].data()+pos, pivot-iterBegin, qstart, result);
     }
 }
 
 
-inline void HINT_M_ALL::scanFirstPartition_OrgsIn_gOverlaps(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanFirstPartition_OrgsIn_gOverlaps(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
     if (this->getBounds_OrgsIn(level, a, next_from, iterBegin, iterEnd, iterI))
     {
-        for (iter = iterBegin; iter != iterEnd; iter++)
-        {
-            if (qstart <= iter->second)
-            {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
-            }
-            iterI++;
-        }
+        auto pos = iterBegin-this->pOrgsInStarts[level].begin();
+        scanNotBefore(this->kernel, this->pOrgsInEnds[level].data()+pos, this->pOrgsInIds[level].data()+pos, iterEnd-iterBegin, qstart, result);
     }
 }
 
 
-inline void HINT_M_ALL::scanFirstPartition_OrgsAft_gOverlaps(unsigned int level, Timestamp a, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanFirstPartition_OrgsAft_gOverlaps(unsigned int level, Timestamp a, PartitionId &next_from, Sink &result)
 {
     RelationIdIterator iterI, iterIStart, iterIEnd;
-    tuple<Timestamp, RelationIdIterator, vector<Timestamp>::iterator, PartitionId> qdummy;
+    tuple<Timestamp, RelationIdIterator, TimestampArrayIterator, PartitionId> qdummy;
 
 
     if (this->getBounds_OrgsAft(level, a, next_from, iterIStart, iterIEnd))
     {
-        for (iterI = iterIStart; iterI != iterIEnd; iterI++)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
-        }
+        this->reportRange(this->pOrgsAftAggregates, level, this->pOrgsAftIds[level], iterIStart, iterIEnd, result);
     }
 }
 
 
-inline void HINT_M_ALL::scanFirstPartition_RepsIn_gOverlaps(unsigned int level, Timestamp a, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanFirstPartition_RepsIn_gOverlaps(unsigned int level, Timestamp a, PartitionId &next_from, Sink &result)
 {
     RelationIdIterator iterI, iterIStart, iterIEnd;
-    tuple<Timestamp, RelationIdIterator, vector<Timestamp>::iterator, PartitionId> qdummy;
+    tuple<Timestamp, RelationIdIterator, TimestampArrayIterator, PartitionId> qdummy;
 
 
     if (this->getBounds_RepsIn(level, a, next_from, iterIStart, iterIEnd))
     {
-        for (iterI = iterIStart; iterI != iterIEnd; iterI++)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
-        }
+        this->reportRange(this->pRepsInAggregates, level, this->pRepsInIds[level], iterIStart, iterIEnd, result);
     }
 }
 
 
-inline void HINT_M_ALL::scanFirstPartition_RepsIn_gOverlaps(unsigned int level, Timestamp a, RecordEnd qdummyS, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanFirstPartition_RepsIn_gOverlaps(unsigned int level, Timestamp a, RecordEnd qdummyS, PartitionId &next_from, Sink &result)
 {
-    vector<Timestamp>::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
     if (this->getBounds_RepsIn(level, a, next_from, iterBegin, iterEnd, iterI))
     {
         iter = lower_bound(iterBegin, iterEnd, qdummyS.end);
-        iterI += iter-iterBegin;
-        while (iter != iterEnd)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
-
-            iter++;
-            iterI++;
-        }
+        this->reportRange(this->pRepsInAggregates, level, this->pRepsInIds[level], iterI+(iter-iterBegin), iterI+(iterEnd-iterBegin), result);
     }
 }
 
 
-inline void HINT_M_ALL::scanFirstPartition_RepsAft_gOverlaps(unsigned int level, Timestamp a, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanFirstPartition_RepsAft_gOverlaps(unsigned int level, Timestamp a, PartitionId &next_from, Sink &result)
 {
     RelationIdIterator iterI, iterIStart, iterIEnd;
 
 
     if (this->getBounds_RepsAft(level, a, next_from, iterIStart, iterIEnd))
     {
-        for (iterI = iterIStart; iterI != iterIEnd; iterI++)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
-        }
+        this->reportRange(this->pRepsAftAggregates, level, this->pRepsAft[level], iterIStart, iterIEnd, result);
     }
 }
 
 
-inline void HINT_M_ALL::scanLastPartition_OrgsIn_gOverlaps(unsigned int level, Timestamp b, pair<Timestamp, Timestamp> qdummyE, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanLastPartition_OrgsIn_gOverlaps(unsigned int level, Timestamp b, pair<Timestamp, Timestamp> qdummyE, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
     if (this->getBounds_OrgsIn(level, b, next_from, iterBegin, iterEnd, iterI))
     {
-        vector<pair<Timestamp, Timestamp> >::iterator pivot = lower_bound(iterBegin, iterEnd, qdummyE);
-        for (iter = iterBegin; iter != pivot; iter++)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= *iterI;
-#endif
-
-            iterI++;
-        }
+        TimestampArrayIterator pivot = lower_bound(iterBegin, iterEnd, qdummyE.first);
+        this->reportRange(this->pOrgsInAggregates, level, this->pOrgsInIds[level], iterI, iterI+(pivot-iterBegin), result);
     }
 }
 
 
-inline void HINT_M_ALL::scanLastPartition_OrgsAft_gOverlaps(unsigned int level, Timestamp b, RecordStart qdummySE, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanLastPartition_OrgsAft_gOverlaps(unsigned int level, Timestamp b, RecordStart qdummySE, PartitionId &next_from, Sink &result)
 {
-    vector<Timestamp>::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
     if (this->getBounds_OrgsAft(level, b, next_from, iterBegin, iterEnd, iterI))
     {
-        vector<Timestamp>::iterator pivot = lower_bound(iterBegin, iterEnd, qdummySE.start);
-        for (iter = iterBegin; iter != pivot; iter++)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= *iterI;
-#endif
-
-            iterI++;
-        }
+        TimestampArrayIterator pivot = lower_bound(iterBegin, iterEnd, qdummySE.start);
+        this->reportRange(this->pOrgsAftAggregates, level, this->pOrgsAftIds[level], iterI, iterI+(pivot-iterBegin), result);
     }
 }
 
 
-inline void HINT_M_ALL::scanPartitions_OrgsIn_gOverlaps(unsigned int level, Timestamp a, Timestamp b, PartitionId &next_from, PartitionId &next_to, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanPartitions_OrgsIn_gOverlaps(unsigned int level, Timestamp a, Timestamp b, PartitionId &next_from, PartitionId &next_to, Sink &result)
 {
     RelationIdIterator iterI, iterIStart, iterIEnd;
 
 
     if (this->getBounds_OrgsIn(level, a, b, next_from, next_to, iterIStart, iterIEnd))
     {
-        for (iterI = iterIStart; iterI != iterIEnd; iterI++)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
-        }
+        this->reportRange(this->pOrgsInAggregates, level, this->pOrgsInIds[level], iterIStart, iterIEnd, result);
     }
 }
 
 
-inline void HINT_M_ALL::scanPartitions_OrgsAft_gOverlaps(unsigned int level, Timestamp a, Timestamp b, PartitionId &next_from, PartitionId &next_to, size_t &result)
+template <class Sink>
+inline void HINT_M_ALL::scanPartitions_OrgsAft_gOverlaps(unsigned int level, Timestamp a, Timestamp b, PartitionId &next_from, PartitionId &next_to, Sink &result)
 {
     RelationIdIterator iterI, iterIStart, iterIEnd;
 
 
     if (this->getBounds_OrgsAft(level, a, b, next_from, next_to, iterIStart, iterIEnd))
     {
-        for (iterI = iterIStart; iterI != iterIEnd; iterI++)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
-        }
+        this->reportRange(this->pOrgsAftAggregates, level, this->pOrgsAftIds[level], iterIStart, iterIEnd, result);
     }
 }
 //
 //
 //
 //
-//inline void HINT_M_ALL::scanFirstPartition_OrgsIn_gContains(unsigned int level, Timestamp a, Timestamp qend, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, size_t &result)
+//template <class Sink>
+//inline void HINT_M_ALL::scanFirstPartition_OrgsIn_gContains(unsigned int level, Timestamp a, Timestamp qend, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, Sink &result)
 //{
-//    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+//    TimestampArrayIterator iter, iterBegin, iterEnd;
 //    RelationIdIterator iterI;
 //
 //
 //    if (this->getBounds_OrgsIn(level, a, next_from, iterBegin, iterEnd, iterI))
 //    {
-//        iter = lower_bound(iterBegin, iterEnd, qdummyS, CompareTimestampPairsByStart);
+//        iter = lower_bound(iterBegin, iterEnd, qdummyS.first);
 //        iterI += iter-iterBegin;
 //        while (iter != iterEnd)
 //        {
-//            if (qend >= iter->second)
+//            if (qend >= *iterE)
 //            {
-//#ifdef WORKLOAD_COUNT
-//                result++;
-//#else
-//                result ^= (*iterI);
-//#endif
+////                result.add(*iterI);
 //            }
 //            iter++;
 //            iterI++;
@@ -3269,23 +4160,20 @@ inline void HINT_M_ALL::scanPartitions_OrgsAft_gOverlaps(unsigned int level, Tim
 //}
 //
 //
-//inline void HINT_M_ALL::scanFirstPartition_OrgsIn_gContains(unsigned int level, Timestamp a, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, size_t &result)
+//template <class Sink>
+//inline void HINT_M_ALL::scanFirstPartition_OrgsIn_gContains(unsigned int level, Timestamp a, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, Sink &result)
 //{
-//    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+//    TimestampArrayIterator iter, iterBegin, iterEnd;
 //    RelationIdIterator iterI;
 //
 //
 //    if (this->getBounds_OrgsIn(level, a, next_from, iterBegin, iterEnd, iterI))
 //    {
-//        iter = lower_bound(iterBegin, iterEnd, qdummyS, CompareTimestampPairsByStart);
+//        iter = lower_bound(iterBegin, iterEnd, qdummyS.first);
 //        iterI += iter-iterBegin;
 //        while (iter != iterEnd)
 //        {
-//#ifdef WORKLOAD_COUNT
-//            result++;
-//#else
-//            result ^= (*iterI);
-//#endif
+////            result.add(*iterI);
 //
 //            iterI++;
 //            iter++;
@@ -3294,9 +4182,10 @@ inline void HINT_M_ALL::scanPartitions_OrgsAft_gOverlaps(unsigned int level, Tim
 //}
 //
 //
-//inline void HINT_M_ALL::scanFirstPartition_OrgsAft_gContains(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, boost::dynamic_bitset<> &vcand, size_t &result)
+//template <class Sink>
+//inline void HINT_M_ALL::scanFirstPartition_OrgsAft_gContains(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, CandidateSet &vcand, Sink &result)
 //{
-//    vector<Timestamp>::iterator iter, iterBegin, iterEnd;
+//    TimestampArrayIterator iter, iterBegin, iterEnd;
 //    RelationIdIterator iterI;
 //
 //
@@ -3306,16 +4195,12 @@ inline void HINT_M_ALL::scanPartitions_OrgsAft_gOverlaps(unsigned int level, Tim
 //        iterI += iter-iterBegin;
 //        while (iter != iterEnd)
 //        {
-//            if (vcand[(*iterI)] == 1)
+//            if (vcand.contains(*iterI))
 //            {
-//#ifdef WORKLOAD_COUNT
-//                result++;
-//#else
-//                result ^= (*iterI);
-//#endif
+////                result.add(*iterI);
 //            }
 //            else
-//                vcand[(*iterI)] = 1;
+//                vcand.insert(*iterI);
 //            iterI++;
 //            iter++;
 //        }
@@ -3323,9 +4208,10 @@ inline void HINT_M_ALL::scanPartitions_OrgsAft_gOverlaps(unsigned int level, Tim
 //}
 //
 //
-//inline void HINT_M_ALL::scanLastPartition_OrgsIn_gContains(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, size_t &result)
+//template <class Sink>
+//inline void HINT_M_ALL::scanLastPartition_OrgsIn_gContains(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, Sink &result)
 //{
-//    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+//    TimestampArrayIterator iter, iterBegin, iterEnd;
 //    RelationIdIterator iterI;
 //
 //
@@ -3333,13 +4219,9 @@ inline void HINT_M_ALL::scanPartitions_OrgsAft_gOverlaps(unsigned int level, Tim
 //    {
 //        for (iter = iterBegin; iter != iterEnd; iter++)
 //        {
-//            if (qend >= iter->second)
+//            if (qend >= *iterE)
 //            {
-//#ifdef WORKLOAD_COUNT
-//                result++;
-//#else
-//                result ^= (*iterI);
-//#endif
+////                result.add(*iterI);
 //            }
 //            iterI++;
 //        }
@@ -3347,27 +4229,24 @@ inline void HINT_M_ALL::scanPartitions_OrgsAft_gOverlaps(unsigned int level, Tim
 //}
 //
 //
-//inline void HINT_M_ALL::scanLastPartition_RepsIn_gContains(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, boost::dynamic_bitset<> &vcand, size_t &result)
+//template <class Sink>
+//inline void HINT_M_ALL::scanLastPartition_RepsIn_gContains(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, CandidateSet &vcand, Sink &result)
 //{
-//    vector<Timestamp>::iterator iter, iterBegin, iterEnd;
+//    TimestampArrayIterator iter, iterBegin, iterEnd;
 //    RelationIdIterator iterI;
 //
 //
 //    if (this->getBounds_RepsIn(level, b, next_from, iterBegin, iterEnd, iterI))
 //    {
-//        vector<Timestamp>::iterator pivot = upper_bound(iterBegin, iterEnd, qend);
+//        TimestampArrayIterator pivot = upper_bound(iterBegin, iterEnd, qend);
 //        for (iter = iterBegin; iter != pivot; iter++)
 //        {
-//            if (vcand[(*iterI)] == 1)
+//            if (vcand.contains(*iterI))
 //            {
-//#ifdef WORKLOAD_COUNT
-//                result++;
-//#else
-//                result ^= (*iterI);
-//#endif
+////                result.add(*iterI);
 //            }
 //            else
-//                vcand[(*iterI)] = 1;
+//                vcand.insert(*iterI);
 //            iterI++;
 //        }
 //    }
@@ -3376,28 +4255,25 @@ inline void HINT_M_ALL::scanPartitions_OrgsAft_gOverlaps(unsigned int level, Tim
 //
 //
 //
-//inline void HINT_M_ALL::scanFirstPartition_OrgsIn_gContained(unsigned int level, Timestamp a, Timestamp qend, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, size_t &result)
+//template <class Sink>
+//inline void HINT_M_ALL::scanFirstPartition_OrgsIn_gContained(unsigned int level, Timestamp a, Timestamp qend, pair<Timestamp, Timestamp> qdummyS, PartitionId &next_from, Sink &result)
 //{
-//    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+//    TimestampArrayIterator iter, iterBegin, iterEnd;
 //    RelationIdIterator iterI;
 //
 //
 //    if (this->getBounds_OrgsIn(level, a, next_from, iterBegin, iterEnd, iterI))
 //    {
-//        vector<pair<Timestamp, Timestamp> >::iterator pivot = upper_bound(iterBegin, iterEnd, qdummyS);
-////        vector<pair<Timestamp, Timestamp> >::iterator pivot = lower_bound(iterBegin, iterEnd, qdummyS);
+//        TimestampArrayIterator pivot = upper_bound(iterBegin, iterEnd, qdummyS);
+////        TimestampArrayIterator pivot = lower_bound(iterBegin, iterEnd, qdummyS.first);
 //        for (iter = iterBegin; iter != pivot; iter++)
 //        {
-////            if (iter->first > qdummyS.first)
+////            if (*iter > qdummyS.first)
 ////                break;
 //
-//            if (qend <= iter->second)
+//            if (qend <= *iterE)
 //            {
-//#ifdef WORKLOAD_COUNT
-//                result++;
-//#else
-//                result ^= (*iterI);
-//#endif
+////                result.add(*iterI);
 //            }
 //            iterI++;
 //        }
@@ -3405,22 +4281,19 @@ inline void HINT_M_ALL::scanPartitions_OrgsAft_gOverlaps(unsigned int level, Tim
 //}
 //
 //
-//inline void HINT_M_ALL::scanFirstPartition_OrgsAft_gContained(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, size_t &result)
+//template <class Sink>
+//inline void HINT_M_ALL::scanFirstPartition_OrgsAft_gContained(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, Sink &result)
 //{
-//    vector<Timestamp>::iterator iter, iterBegin, iterEnd;
+//    TimestampArrayIterator iter, iterBegin, iterEnd;
 //    RelationIdIterator iterI;
 //
 //
 //    if (this->getBounds_OrgsAft(level, a, next_from, iterBegin, iterEnd, iterI))
 //    {
-//        vector<Timestamp>::iterator pivot = upper_bound(iterBegin, iterEnd, qstart);
+//        TimestampArrayIterator pivot = upper_bound(iterBegin, iterEnd, qstart);
 //        for (iter = iterBegin; iter != pivot; iter++)
 //        {
-//#ifdef WORKLOAD_COUNT
-//            result++;
-//#else
-//            result ^= (*iterI);
-//#endif
+////            result.add(*iterI);
 //
 //            iterI++;
 //        }
@@ -3428,27 +4301,24 @@ inline void HINT_M_ALL::scanPartitions_OrgsAft_gOverlaps(unsigned int level, Tim
 //}
 //
 //
-//inline void HINT_M_ALL::scanFirstPartition_OrgsAft_gContained(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, boost::dynamic_bitset<> &vcand, size_t &result)
+//template <class Sink>
+//inline void HINT_M_ALL::scanFirstPartition_OrgsAft_gContained(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, CandidateSet &vcand, Sink &result)
 //{
-//    vector<Timestamp>::iterator iter, iterBegin, iterEnd;
+//    TimestampArrayIterator iter, iterBegin, iterEnd;
 //    RelationIdIterator iterI;
 //
 //
 //    if (this->getBounds_OrgsAft(level, a, next_from, iterBegin, iterEnd, iterI))
 //    {
-//        vector<Timestamp>::iterator pivot = upper_bound(iterBegin, iterEnd, qstart);
+//        TimestampArrayIterator pivot = upper_bound(iterBegin, iterEnd, qstart);
 //        for (iter = iterBegin; iter != pivot; iter++)
 //        {
-//            if (vcand[(*iterI)] == 1)
+//            if (vcand.contains(*iterI))
 //            {
-//#ifdef WORKLOAD_COUNT
-//                result++;
-//#else
-//                result ^= (*iterI);
-//#endif
+////                result.add(*iterI);
 //            }
 //            else
-//                vcand[(*iterI)] = 1;
+//                vcand.insert(*iterI);
 //            iterI++;
 //        }
 //    }
@@ -3456,9 +4326,10 @@ inline void HINT_M_ALL::scanPartitions_OrgsAft_gOverlaps(unsigned int level, Tim
 //
 //
 
-//inline void HINT_M_ALL::scanLastPartition_RepsIn_gContained(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, boost::dynamic_bitset<> &vcand, size_t &result)
+//template <class Sink>
+//inline void HINT_M_ALL::scanLastPartition_RepsIn_gContained(unsigned int level, Timestamp b, Timestamp qend, PartitionId &next_from, CandidateSet &vcand, Sink &result)
 //{
-//    vector<Timestamp>::iterator iter, iterBegin, iterEnd;
+//    TimestampArrayIterator iter, iterBegin, iterEnd;
 //    RelationIdIterator iterI;
 //
 //    if (this->getBounds_RepsIn(level, b, next_from, iterBegin, iterEnd, iterI))
@@ -3467,16 +4338,12 @@ inline void HINT_M_ALL::scanPartitions_OrgsAft_gOverlaps(unsigned int level, Tim
 //        iterI += iter-iterBegin;
 //        while (iter != iterEnd)
 //        {
-//            if (vcand[(*iterI)] == 1)
+//            if (vcand.contains(*iterI))
 //            {
-//#ifdef WORKLOAD_COUNT
-//                result++;
-//#else
-//                result ^= (*iterI);
-//#endif
+////                result.add(*iterI);
 //            }
 //            else
-//                vcand[(*iterI)] = 1;
+//                vcand.insert(*iterI);
 //            iter++;
 //            iterI++;
 //        }
@@ -3487,10 +4354,10 @@ inline void HINT_M_ALL::scanPartitions_OrgsAft_gOverlaps(unsigned int level, Tim
 
 
 // Basic predicates of Allen's algebra
-size_t HINT_M_ALL::executeBottomUp_Equals(RangeQuery Q)
+template <class Sink>
+void HINT_M_ALL::executeBottomUp_Equals(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
     Timestamp a = Q.start >> (this->maxBits-this->numBits); // prefix
     Timestamp b = Q.end >> (this->maxBits-this->numBits); // prefix
@@ -3499,11 +4366,22 @@ size_t HINT_M_ALL::executeBottomUp_Equals(RangeQuery Q)
     bool foundzero = false;
     bool firstfound = false, lastfound = false;
     PartitionId next_fromOinA = -1, next_fromOaftA = -1, next_fromRinB = -1;
-    boost::dynamic_bitset<> vcand(this->numIndexedRecords);
+    CandidateSet &vcand = QueryContext::local().vcand;
     Timestamp a_partition = -1, b_partition = -1;
     short int level = 0, a_level = -1, b_level = -1;
 
 
+    // Records erased since the last purge, see HierarchicalIndex::erase()
+    if (this->skipErased(result, [&](auto &filtered) {this->executeBottomUp_Equals(Q, filtered);}))
+        return;
+
+    // Records inserted since the last merge, see HierarchicalIndex::insert()
+    this->delta.execute_Equals(this->kernel, Q, result);
+
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_Equals(this->kernel, Q, result);
+
+    vcand.reset();
     while (level < this->height && a <= b)
     {
         if (a%2)
@@ -3566,16 +4444,23 @@ size_t HINT_M_ALL::executeBottomUp_Equals(RangeQuery Q)
     {
         this->scanLastPartition_RepsIn_Equals(b_level, b_partition, Q.end, next_fromRinB, vcand, result);
     }
+}
 
 
-    return result;
+size_t HINT_M_ALL::executeBottomUp_Equals(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_Equals(Q, result);
+    
+    return result.get();
 }
 
 
-size_t HINT_M_ALL::executeBottomUp_Starts(RangeQuery Q)
+template <class Sink>
+void HINT_M_ALL::executeBottomUp_Starts(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd, iterE;
     RelationIdIterator iterI;
     Timestamp a = Q.start >> (this->maxBits-this->numBits); // prefix
     Timestamp b = Q.end >> (this->maxBits-this->numBits); // prefix
@@ -3583,9 +4468,20 @@ size_t HINT_M_ALL::executeBottomUp_Starts(RangeQuery Q)
     bool foundone = false;
 //    bool foundoneB = false;
     PartitionId next_fromOinA = -1, next_fromOaftA = -1, next_fromRinB = -1, next_fromRaftB = -1;
-    boost::dynamic_bitset<> vcand(this->numIndexedRecords);
+    CandidateSet &vcand = QueryContext::local().vcand;
+
+
+    // Records erased since the last purge, see HierarchicalIndex::erase()
+    if (this->skipErased(result, [&](auto &filtered) {this->executeBottomUp_Starts(Q, filtered);}))
+        return;
+
+    // Records inserted since the last merge, see HierarchicalIndex::insert()
+    this->delta.execute_Starts(this->kernel, Q, result);
 
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_Starts(this->kernel, Q, result);
 
+    vcand.reset();
     for (auto l = 0; l < this->numBits; l++)
     {
 //        if (foundoneA && foundoneB)
@@ -3618,34 +4514,39 @@ size_t HINT_M_ALL::executeBottomUp_Starts(RangeQuery Q)
     {
         // Comparisons needed
         iterI = this->pOrgsInIds[this->numBits].begin();
-        iterBegin = this->pOrgsInTimestamps[this->numBits].begin();
-        iterEnd = this->pOrgsInTimestamps[this->numBits].end();
-        iter = lower_bound(iterBegin, iterEnd, qdummyS, CompareTimestampPairsByStart);
+        iterBegin = this->pOrgsInStarts[this->numBits].begin();
+        iterEnd = this->pOrgsInStarts[this->numBits].end();
+        iter = lower_bound(iterBegin, iterEnd, qdummyS.first);
         iterI += iter-iterBegin;
-        while ((iter != iterEnd) && (Q.start == iter->first))
+        iterE = this->pOrgsInEnds[this->numBits].begin()+(iter-this->pOrgsInStarts[this->numBits].begin());
+        while ((iter != iterEnd) && (Q.start == *iter))
         {
-            if (Q.end < iter->second)
+            if (Q.end < *iterE)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iter++;
             iterI++;
+            iterE++;
         }
     }
+}
 
 
-    return result;
+size_t HINT_M_ALL::executeBottomUp_Starts(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_Starts(Q, result);
+    
+    return result.get();
 }
 
 
-size_t HINT_M_ALL::executeBottomUp_Started(RangeQuery Q)
+template <class Sink>
+void HINT_M_ALL::executeBottomUp_Started(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd, iterE;
     RelationIdIterator iterI;
     Timestamp a = Q.start >> (this->maxBits-this->numBits); // prefix
     Timestamp b = Q.end >> (this->maxBits-this->numBits); // prefix
@@ -3653,9 +4554,20 @@ size_t HINT_M_ALL::executeBottomUp_Started(RangeQuery Q)
     bool foundzero = false;
     bool foundone = false;
     PartitionId next_fromOinA = -1, next_fromOaftA = -1, next_fromRinB = -1, next_fromRinAB = -1, next_toRinAB = -1;
-    boost::dynamic_bitset<> vcand(this->numIndexedRecords);
+    CandidateSet &vcand = QueryContext::local().vcand;
+
+
+    // Records erased since the last purge, see HierarchicalIndex::erase()
+    if (this->skipErased(result, [&](auto &filtered) {this->executeBottomUp_Started(Q, filtered);}))
+        return;
 
+    // Records inserted since the last merge, see HierarchicalIndex::insert()
+    this->delta.execute_Started(this->kernel, Q, result);
 
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_Started(this->kernel, Q, result);
+
+    vcand.reset();
     for (auto l = 0; l < this->numBits; l++)
     {
 //        if (foundone && foundzero)
@@ -3692,34 +4604,39 @@ size_t HINT_M_ALL::executeBottomUp_Started(RangeQuery Q)
     {
         // Comparisons needed
         iterI = this->pOrgsInIds[this->numBits].begin();
-        iterBegin = this->pOrgsInTimestamps[this->numBits].begin();
-        iterEnd = this->pOrgsInTimestamps[this->numBits].end();
-        iter = lower_bound(iterBegin, iterEnd, qdummyS, CompareTimestampPairsByStart);
+        iterBegin = this->pOrgsInStarts[this->numBits].begin();
+        iterEnd = this->pOrgsInStarts[this->numBits].end();
+        iter = lower_bound(iterBegin, iterEnd, qdummyS.first);
         iterI += iter-iterBegin;
-        while ((iter != iterEnd) && (Q.start == iter->first))
+        iterE = this->pOrgsInEnds[this->numBits].begin()+(iter-this->pOrgsInStarts[this->numBits].begin());
+        while ((iter != iterEnd) && (Q.start == *iter))
         {
-            if (Q.end > iter->second)
+            if (Q.end > *iterE)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iter++;
             iterI++;
+            iterE++;
         }
     }
+}
 
 
-    return result;
+size_t HINT_M_ALL::executeBottomUp_Started(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_Started(Q, result);
+    
+    return result.get();
 }
 
 
-size_t HINT_M_ALL::executeBottomUp_Finishes(RangeQuery Q)
+template <class Sink>
+void HINT_M_ALL::executeBottomUp_Finishes(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd, iterE;
     RelationIdIterator iterI;
     Timestamp a = Q.start >> (this->maxBits-this->numBits); // prefix
     Timestamp b = Q.end >> (this->maxBits-this->numBits); // prefix
@@ -3727,9 +4644,20 @@ size_t HINT_M_ALL::executeBottomUp_Finishes(RangeQuery Q)
     bool foundzero = false;
     bool foundone = false;
     PartitionId next_fromOaftA = -1, next_fromOinB = -1, next_fromRinB = -1, next_fromRaftA = -1;
-    boost::dynamic_bitset<> vcand(this->numIndexedRecords);
+    CandidateSet &vcand = QueryContext::local().vcand;
+
 
+    // Records erased since the last purge, see HierarchicalIndex::erase()
+    if (this->skipErased(result, [&](auto &filtered) {this->executeBottomUp_Finishes(Q, filtered);}))
+        return;
 
+    // Records inserted since the last merge, see HierarchicalIndex::insert()
+    this->delta.execute_Finishes(this->kernel, Q, result);
+
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_Finishes(this->kernel, Q, result);
+
+    vcand.reset();
     for (auto l = 0; l < this->numBits; l++)
     {
 //        if (foundone && foundzero)
@@ -3768,32 +4696,37 @@ size_t HINT_M_ALL::executeBottomUp_Finishes(RangeQuery Q)
     {
         // Comparisons needed
         iterI = this->pOrgsInIds[this->numBits].begin();
-        iterBegin = this->pOrgsInTimestamps[this->numBits].begin();
-        iterEnd = this->pOrgsInTimestamps[this->numBits].end();
-        vector<pair<Timestamp, Timestamp> >::iterator pivot = lower_bound(iterBegin, iterEnd, qdummyS, CompareTimestampPairsByStart);
+        iterBegin = this->pOrgsInStarts[this->numBits].begin();
+        iterEnd = this->pOrgsInStarts[this->numBits].end();
+        TimestampArrayIterator pivot = lower_bound(iterBegin, iterEnd, qdummyS.first);
+        iterE = this->pOrgsInEnds[this->numBits].begin()+(iterBegin-this->pOrgsInStarts[this->numBits].begin());
         for (iter = iterBegin; iter != pivot; iter++)
         {
-            if (Q.end == iter->second)
+            if (Q.end == *iterE)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= *iterI;
-#endif
+                result.add(*iterI);
             }
             iterI++;
+            iterE++;
         }
     }
+}
 
 
-    return result;
+size_t HINT_M_ALL::executeBottomUp_Finishes(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_Finishes(Q, result);
+    
+    return result.get();
 }
 
 
-size_t HINT_M_ALL::executeBottomUp_Finished(RangeQuery Q)
+template <class Sink>
+void HINT_M_ALL::executeBottomUp_Finished(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd, iterE;
     RelationIdIterator iterI;
     Timestamp a = Q.start >> (this->maxBits-this->numBits); // prefix
     Timestamp b = Q.end >> (this->maxBits-this->numBits); // prefix
@@ -3801,9 +4734,20 @@ size_t HINT_M_ALL::executeBottomUp_Finished(RangeQuery Q)
     bool foundzero = false;
     bool foundone = false;
     PartitionId next_fromOaftA = -1, next_fromOinB = -1, next_fromRinB = -1, next_fromOaftAB = -1, next_toOaftAB = -1;
-    boost::dynamic_bitset<> vcand(this->numIndexedRecords);
+    CandidateSet &vcand = QueryContext::local().vcand;
 
 
+    // Records erased since the last purge, see HierarchicalIndex::erase()
+    if (this->skipErased(result, [&](auto &filtered) {this->executeBottomUp_Finished(Q, filtered);}))
+        return;
+
+    // Records inserted since the last merge, see HierarchicalIndex::insert()
+    this->delta.execute_Finished(this->kernel, Q, result);
+
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_Finished(this->kernel, Q, result);
+
+    vcand.reset();
     for (auto l = 0; l < this->numBits; l++)
     {
 //        if (foundone && foundzero)
@@ -3840,34 +4784,39 @@ size_t HINT_M_ALL::executeBottomUp_Finished(RangeQuery Q)
     if (!foundzero)
     {
         // Comparisons needed
-        iterBegin = this->pOrgsInTimestamps[this->numBits].begin();
-        iterEnd = this->pOrgsInTimestamps[this->numBits].end();
-        iter = lower_bound(iterBegin, iterEnd, qdummyS, CompareTimestampPairsByStart);
+        iterBegin = this->pOrgsInStarts[this->numBits].begin();
+        iterEnd = this->pOrgsInStarts[this->numBits].end();
+        iter = lower_bound(iterBegin, iterEnd, qdummyS.first);
         iterI = this->pOrgsInIds[this->numBits].begin() + (iter-iterBegin);
+        iterE = this->pOrgsInEnds[this->numBits].begin()+(iter-this->pOrgsInStarts[this->numBits].begin());
         while (iter != iterEnd)
         {
-            if (Q.end == iter->second)
+            if (Q.end == *iterE)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= *iterI;
-#endif
+                result.add(*iterI);
             }
             iter++;
             iterI++;
+            iterE++;
         }
     }
+}
 
 
-    return result;
+size_t HINT_M_ALL::executeBottomUp_Finished(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_Finished(Q, result);
+    
+    return result.get();
 }
 
 
-size_t HINT_M_ALL::executeBottomUp_Meets(RangeQuery Q)
+template <class Sink>
+void HINT_M_ALL::executeBottomUp_Meets(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
     Timestamp b = Q.end >> (this->maxBits-this->numBits); // prefix
     pair<Timestamp, Timestamp> qdummyE(Q.end, Q.end);
@@ -3876,6 +4825,16 @@ size_t HINT_M_ALL::executeBottomUp_Meets(RangeQuery Q)
     PartitionId next_fromOinB = -1, next_fromOaftB = -1;
 
 
+    // Records erased since the last purge, see HierarchicalIndex::erase()
+    if (this->skipErased(result, [&](auto &filtered) {this->executeBottomUp_Meets(Q, filtered);}))
+        return;
+
+    // Records inserted since the last merge, see HierarchicalIndex::insert()
+    this->delta.execute_Meets(this->kernel, Q, result);
+
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_Meets(this->kernel, Q, result);
+
     for (auto l = 0; l < this->numBits; l++)
     {
 //        if (foundone && foundzero)
@@ -3899,32 +4858,35 @@ size_t HINT_M_ALL::executeBottomUp_Meets(RangeQuery Q)
     {
         // Comparisons needed
         iterI = this->pOrgsInIds[this->numBits].begin();
-        iterBegin = this->pOrgsInTimestamps[this->numBits].begin();
-        iterEnd = this->pOrgsInTimestamps[this->numBits].end();
-        iter = lower_bound(iterBegin, iterEnd, qdummyE, CompareTimestampPairsByStart);
+        iterBegin = this->pOrgsInStarts[this->numBits].begin();
+        iterEnd = this->pOrgsInStarts[this->numBits].end();
+        iter = lower_bound(iterBegin, iterEnd, qdummyE.first);
         iterI += iter-iterBegin;
-        while ((iter != iterEnd) && (Q.end == iter->first))
+        while ((iter != iterEnd) && (Q.end == *iter))
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
+            result.add(*iterI);
 
             iter++;
             iterI++;
         }
     }
+}
 
 
-    return result;
+size_t HINT_M_ALL::executeBottomUp_Meets(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_Meets(Q, result);
+    
+    return result.get();
 }
 
 
-size_t HINT_M_ALL::executeBottomUp_Met(RangeQuery Q)
+template <class Sink>
+void HINT_M_ALL::executeBottomUp_Met(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd, iterE;
     RelationIdIterator iterI;
     Timestamp a = Q.start >> (this->maxBits-this->numBits); // prefix
     pair<Timestamp, Timestamp> qdummyE(Q.start, Q.start);
@@ -3933,6 +4895,16 @@ size_t HINT_M_ALL::executeBottomUp_Met(RangeQuery Q)
     PartitionId next_fromOinA = -1, next_fromRinA = -1;
 
 
+    // Records erased since the last purge, see HierarchicalIndex::erase()
+    if (this->skipErased(result, [&](auto &filtered) {this->executeBottomUp_Met(Q, filtered);}))
+        return;
+
+    // Records inserted since the last merge, see HierarchicalIndex::insert()
+    this->delta.execute_Met(this->kernel, Q, result);
+
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_Met(this->kernel, Q, result);
+
     for (auto l = 0; l < this->numBits; l++)
     {
 //        if (foundone && foundzero)
@@ -3955,32 +4927,37 @@ size_t HINT_M_ALL::executeBottomUp_Met(RangeQuery Q)
     if (!foundzero)
     {
         // Comparisons needed
-        iterBegin = this->pOrgsInTimestamps[this->numBits].begin();
-        iterEnd = this->pOrgsInTimestamps[this->numBits].end();
+        iterBegin = this->pOrgsInStarts[this->numBits].begin();
+        iterEnd = this->pOrgsInStarts[this->numBits].end();
         iterI = this->pOrgsInIds[this->numBits].begin();
+        iterE = this->pOrgsInEnds[this->numBits].begin()+(iterBegin-this->pOrgsInStarts[this->numBits].begin());
         for (iter = iterBegin; iter != iterEnd; iter++)
         {
-            if (Q.start == iter->second)
+            if (Q.start == *iterE)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iterI++;
+            iterE++;
         }
     }
+}
 
 
-    return result;
+size_t HINT_M_ALL::executeBottomUp_Met(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_Met(Q, result);
+    
+    return result.get();
 }
 
 
-size_t HINT_M_ALL::executeBottomUp_Overlaps(RangeQuery Q)
+template <class Sink>
+void HINT_M_ALL::executeBottomUp_Overlaps(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd, iterE;
     RelationIdIterator iterI, iterIStart, iterIEnd;
     Timestamp a = Q.start >> (this->maxBits-this->numBits); // prefix
     Timestamp b = Q.end   >> (this->maxBits-this->numBits); // prefix
@@ -3989,15 +4966,26 @@ size_t HINT_M_ALL::executeBottomUp_Overlaps(RangeQuery Q)
     bool foundzero = false;
     bool foundone = false;
     PartitionId next_fromOinA = -1, next_fromOaftA = -1, next_fromOaftAB = -1, next_toOaftAB = -1, next_fromOinB = -1, next_fromOaftB = -1, next_fromRinB = -1, next_fromRaftB = -1;
-    boost::dynamic_bitset<> vcand(this->numIndexedRecords);
+    CandidateSet &vcand = QueryContext::local().vcand;
+
 
+    // Records erased since the last purge, see HierarchicalIndex::erase()
+    if (this->skipErased(result, [&](auto &filtered) {this->executeBottomUp_Overlaps(Q, filtered);}))
+        return;
 
+    // Records inserted since the last merge, see HierarchicalIndex::insert()
+    this->delta.execute_Overlaps(this->kernel, Q, result);
+
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_Overlaps(this->kernel, Q, result);
+
+    vcand.reset();
     for (auto l = 0; l < this->numBits; l++)
     {
         if (foundone && foundzero)
         {
             if (a == b)
-                return result;
+                return;
 
             this->scanPartitions_OrgsAft_Finished(l, a+1, b-1, next_fromOaftAB, next_toOaftAB, vcand, result);
 
@@ -4050,47 +5038,45 @@ size_t HINT_M_ALL::executeBottomUp_Overlaps(RangeQuery Q)
         // All contents are guaranteed to be results
         iterIStart = this->pOrgsInIds[this->numBits].begin();
         iterIEnd = this->pOrgsInIds[this->numBits].end();
-        for (iterI = iterIStart; iterI != iterIEnd; iterI++)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
-        }
+        reportIds(this->kernel, iterIStart, iterIEnd, result);
     }
     else
     {
         // Comparisons needed
         iterI = this->pOrgsInIds[this->numBits].begin();
-        iterBegin = this->pOrgsInTimestamps[this->numBits].begin();
-        iterEnd = this->pOrgsInTimestamps[this->numBits].end();
-        iter = lower_bound(iterBegin, iterEnd, qdummyS, CompareTimestampPairsByStart);
+        iterBegin = this->pOrgsInStarts[this->numBits].begin();
+        iterEnd = this->pOrgsInStarts[this->numBits].end();
+        iter = lower_bound(iterBegin, iterEnd, qdummyS.first);
         iterI += iter-iterBegin;
-        while ((iter != iterEnd) && (Q.end > iter->first))
+        iterE = this->pOrgsInEnds[this->numBits].begin()+(iter-this->pOrgsInStarts[this->numBits].begin());
+        while ((iter != iterEnd) && (Q.end > *iter))
         {
-            if (Q.end < iter->second)
+            if (Q.end < *iterE)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iter++;
             iterI++;
+            iterE++;
         }
     }
+}
 
 
-    return result;
+size_t HINT_M_ALL::executeBottomUp_Overlaps(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_Overlaps(Q, result);
+    
+    return result.get();
 }
 
 
-size_t HINT_M_ALL::executeBottomUp_Overlapped(RangeQuery Q)
+template <class Sink>
+void HINT_M_ALL::executeBottomUp_Overlapped(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd, iterE;
     RelationIdIterator iterI, iterIStart, iterIEnd;
     Timestamp a = Q.start >> (this->maxBits-this->numBits); // prefix
     Timestamp b = Q.end   >> (this->maxBits-this->numBits); // prefix
@@ -4098,15 +5084,26 @@ size_t HINT_M_ALL::executeBottomUp_Overlapped(RangeQuery Q)
     bool foundzero = false;
     bool foundone = false;
     PartitionId next_fromOinA = -1, next_fromOaftA = -1, next_fromRinA = -1, next_fromRaftA = -1, next_fromOinB = -1, next_fromRinB = -1, next_fromOinAB = -1, next_toOinAB = -1, next_fromRinAB = -1, next_toRinAB = -1, next_fromR = -1, next_fromO = -1, next_toO = -1;
-    boost::dynamic_bitset<> vcand(this->numIndexedRecords);
+    CandidateSet &vcand = QueryContext::local().vcand;
+
 
+    // Records erased since the last purge, see HierarchicalIndex::erase()
+    if (this->skipErased(result, [&](auto &filtered) {this->executeBottomUp_Overlapped(Q, filtered);}))
+        return;
 
+    // Records inserted since the last merge, see HierarchicalIndex::insert()
+    this->delta.execute_Overlapped(this->kernel, Q, result);
+
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_Overlapped(this->kernel, Q, result);
+
+    vcand.reset();
     for (auto l = 0; l < this->numBits; l++)
     {
         if (foundone && foundzero)
         {
             if (a == b)
-                return result;
+                return;
 
             this->scanFirstPartition_OrgsIn_Overlapped(l, a, Q.start, next_fromOinA, result);
             this->scanFirstPartition_RepsIn_Overlapped(l, a, Q.start, next_fromRinA, result);
@@ -4159,45 +5156,43 @@ size_t HINT_M_ALL::executeBottomUp_Overlapped(RangeQuery Q)
         // All contents are guaranteed to be results
         iterIStart = this->pOrgsInIds[this->numBits].begin();
         iterIEnd = this->pOrgsInIds[this->numBits].end();
-        for (iterI = iterIStart; iterI != iterIEnd; iterI++)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
-        }
+        reportIds(this->kernel, iterIStart, iterIEnd, result);
     }
     else
     {
         // Comparisons needed
         iterI = this->pOrgsInIds[this->numBits].begin();
-        iterBegin = this->pOrgsInTimestamps[this->numBits].begin();
-        iterEnd = this->pOrgsInTimestamps[this->numBits].end();
-        vector<pair<Timestamp, Timestamp> >::iterator pivot = lower_bound(iterBegin, iterEnd, qdummyS, CompareTimestampPairsByStart);
+        iterBegin = this->pOrgsInStarts[this->numBits].begin();
+        iterEnd = this->pOrgsInStarts[this->numBits].end();
+        TimestampArrayIterator pivot = lower_bound(iterBegin, iterEnd, qdummyS.first);
+        iterE = this->pOrgsInEnds[this->numBits].begin()+(iterBegin-this->pOrgsInStarts[this->numBits].begin());
         for (iter = iterBegin; iter != pivot; iter++)
         {
-            if ((Q.start < iter->second) && (Q.end > iter->second))
+            if ((Q.start < *iterE) && (Q.end > *iterE))
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iterI++;
+            iterE++;
         }
     }
+}
 
 
-    return result;
+size_t HINT_M_ALL::executeBottomUp_Overlapped(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_Overlapped(Q, result);
+    
+    return result.get();
 }
 
 
-size_t HINT_M_ALL::executeBottomUp_Contains(RangeQuery Q)
+template <class Sink>
+void HINT_M_ALL::executeBottomUp_Contains(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd, iterE;
     RelationIdIterator iterI;
     Timestamp a = Q.start >> (this->maxBits-this->numBits); // prefix
     Timestamp b = Q.end >> (this->maxBits-this->numBits); // prefix
@@ -4205,9 +5200,20 @@ size_t HINT_M_ALL::executeBottomUp_Contains(RangeQuery Q)
     bool foundzero = false;
     bool foundone = false;
     PartitionId next_fromOinA = -1, next_fromOaftA = -1, next_fromOinB = -1, next_fromOinAB = -1, next_toOinAB = -1, next_fromOaftAB = -1, next_toOaftAB = -1, next_fromRinB = -1, next_fromRinAB = -1, next_toRinAB = -1;
-    boost::dynamic_bitset<> vcand(this->numIndexedRecords);
+    CandidateSet &vcand = QueryContext::local().vcand;
+
 
+    // Records erased since the last purge, see HierarchicalIndex::erase()
+    if (this->skipErased(result, [&](auto &filtered) {this->executeBottomUp_Contains(Q, filtered);}))
+        return;
 
+    // Records inserted since the last merge, see HierarchicalIndex::insert()
+    this->delta.execute_Contains(this->kernel, Q, result);
+
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_Contains(this->kernel, Q, result);
+
+    vcand.reset();
     for (auto l = 0; l < this->numBits; l++)
     {
         if (foundone && foundzero)
@@ -4225,7 +5231,7 @@ size_t HINT_M_ALL::executeBottomUp_Contains(RangeQuery Q)
             {
                 this->scanFirstPartition_OrgsIn_Contains(l, a, Q.end, qdummyS, next_fromOinA, result);
                 // TODO ?
-//                return result;
+//                return;
             }
             else
             {
@@ -4260,43 +5266,59 @@ size_t HINT_M_ALL::executeBottomUp_Contains(RangeQuery Q)
     if (!(foundone && foundzero))
     {
         iterI = this->pOrgsInIds[this->numBits].begin();
-        iterBegin = this->pOrgsInTimestamps[this->numBits].begin();
-        iterEnd = this->pOrgsInTimestamps[this->numBits].end();
-        iter = lower_bound(iterBegin, iterEnd, qdummyS, CompareTimestampPairsByStart);
+        iterBegin = this->pOrgsInStarts[this->numBits].begin();
+        iterEnd = this->pOrgsInStarts[this->numBits].end();
+        iter = lower_bound(iterBegin, iterEnd, qdummyS.first);
         iterI += iter-iterBegin;
+        iterE = this->pOrgsInEnds[this->numBits].begin()+(iter-this->pOrgsInStarts[this->numBits].begin());
         while (iter != iterEnd)
         {
-            if (Q.end > iter->second)
+            if (Q.end > *iterE)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iter++;
             iterI++;
+            iterE++;
         }
     }
+}
 
 
-    return result;
+size_t HINT_M_ALL::executeBottomUp_Contains(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_Contains(Q, result);
+    
+    return result.get();
 }
 
 
-size_t HINT_M_ALL::executeBottomUp_Contained(RangeQuery Q)
+template <class Sink>
+void HINT_M_ALL::executeBottomUp_Contained(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd, iterE;
     RelationIdIterator iterI;
     Timestamp a = Q.start >> (this->maxBits-this->numBits); // prefix
     Timestamp b = Q.end >> (this->maxBits-this->numBits); // prefix
     pair<Timestamp, Timestamp> qdummyS(Q.start, Q.start);
     RecordEnd qdummyE(Q.end+1, Q.end+1);
     PartitionId next_fromOinA = -1, next_fromOaftA = -1, next_fromOinB = -1, next_fromRinA = -1, next_fromRinB = -1, next_fromRaftA = -1, next_fromRaftB = -1;
-    boost::dynamic_bitset<> vcand(this->numIndexedRecords);
+    CandidateSet &vcand = QueryContext::local().vcand;
 
 
+    // Records erased since the last purge, see HierarchicalIndex::erase()
+    if (this->skipErased(result, [&](auto &filtered) {this->executeBottomUp_Contained(Q, filtered);}))
+        return;
+
+    // Records inserted since the last merge, see HierarchicalIndex::insert()
+    this->delta.execute_Contained(this->kernel, Q, result);
+
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_Contained(this->kernel, Q, result);
+
+    vcand.reset();
     for (auto l = 0; l < this->numBits; l++)
     {
         if (a == b)
@@ -4305,7 +5327,7 @@ size_t HINT_M_ALL::executeBottomUp_Contained(RangeQuery Q)
             this->scanFirstPartition_OrgsAft_Contained(l, a, Q.start, next_fromOaftA, result);
             this->scanFirstPartition_RepsIn_gOverlaps(l, a, qdummyE, next_fromRinA, result);    // Re-using function from overlaps
             this->scanFirstPartition_RepsAft_gOverlaps(l, a, next_fromRaftA, result);           // Re-using function from gOverlaps
-//            return result;    // TODO?
+//            return;    // TODO?
         }
         else
         {
@@ -4327,30 +5349,35 @@ size_t HINT_M_ALL::executeBottomUp_Contained(RangeQuery Q)
 
     // Handle root.
     iterI = this->pOrgsInIds[this->numBits].begin();
-    iterBegin = this->pOrgsInTimestamps[this->numBits].begin();
-    vector<pair< Timestamp, Timestamp> >::iterator pivot = lower_bound(iterBegin, this->pOrgsInTimestamps[this->numBits].end(), qdummyS, CompareTimestampPairsByStart);
+    iterBegin = this->pOrgsInStarts[this->numBits].begin();
+    TimestampArrayIterator pivot = lower_bound(iterBegin, this->pOrgsInStarts[this->numBits].end(), qdummyS.first);
+    iterE = this->pOrgsInEnds[this->numBits].begin()+(iterBegin-this->pOrgsInStarts[this->numBits].begin());
     for (iter = iterBegin; iter != pivot; iter++)
     {
-        if (Q.end < iter->second)
+        if (Q.end < *iterE)
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
+            result.add(*iterI);
         }
         iterI++;
+        iterE++;
     }
+}
 
 
-    return result;
+size_t HINT_M_ALL::executeBottomUp_Contained(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_Contained(Q, result);
+    
+    return result.get();
 }
 
 
-size_t HINT_M_ALL::executeBottomUp_Precedes(RangeQuery Q)
+template <class Sink>
+void HINT_M_ALL::executeBottomUp_Precedes(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI, iterIStart, iterIEnd;
     Timestamp b = Q.end >> (this->maxBits-this->numBits); // prefix
     pair<Timestamp, Timestamp> qdummyE(Q.end+1, Q.end+1);
@@ -4359,6 +5386,16 @@ size_t HINT_M_ALL::executeBottomUp_Precedes(RangeQuery Q)
     PartitionId next_fromOinB = -1, next_fromOaftB = -1, next_fromOinAB = -1, next_fromOaftAB = -1;
 
 
+    // Records erased since the last purge, see HierarchicalIndex::erase()
+    if (this->skipErased(result, [&](auto &filtered) {this->executeBottomUp_Precedes(Q, filtered);}))
+        return;
+
+    // Records inserted since the last merge, see HierarchicalIndex::insert()
+    this->delta.execute_Precedes(this->kernel, Q, result);
+
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_Precedes(this->kernel, Q, result);
+
     for (auto l = 0; l < this->numBits; l++)
     {
 //        if (!(foundone && foundzero))
@@ -4387,17 +5424,13 @@ size_t HINT_M_ALL::executeBottomUp_Precedes(RangeQuery Q)
     {
         // Comparisons needed
         iterI = this->pOrgsInIds[this->numBits].begin();
-        iterBegin = this->pOrgsInTimestamps[this->numBits].begin();
-        iterEnd = this->pOrgsInTimestamps[this->numBits].end();
-        iter = lower_bound(iterBegin, iterEnd, qdummyE, CompareTimestampPairsByStart);
+        iterBegin = this->pOrgsInStarts[this->numBits].begin();
+        iterEnd = this->pOrgsInStarts[this->numBits].end();
+        iter = lower_bound(iterBegin, iterEnd, qdummyE.first);
         iterI += iter-iterBegin;
         while (iter != iterEnd)
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
+            result.add(*iterI);
 
             iter++;
             iterI++;
@@ -4407,25 +5440,25 @@ size_t HINT_M_ALL::executeBottomUp_Precedes(RangeQuery Q)
     {
         iterIStart = this->pOrgsInIds[this->numBits].begin();
         iterIEnd = this->pOrgsInIds[this->numBits].end();
-        for (iterI = iterIStart; iterI != iterIEnd; iterI++)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
-        }
+        reportIds(this->kernel, iterIStart, iterIEnd, result);
     }
+}
 
 
-    return result;
+size_t HINT_M_ALL::executeBottomUp_Precedes(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_Precedes(Q, result);
+    
+    return result.get();
 }
 
 
-size_t HINT_M_ALL::executeBottomUp_Preceded(RangeQuery Q)
+template <class Sink>
+void HINT_M_ALL::executeBottomUp_Preceded(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd, iterE;
     RelationIdIterator iterI, iterIStart, iterIEnd;
     Timestamp a = Q.start >> (this->maxBits-this->numBits); // prefix
     pair<Timestamp, Timestamp> qdummyS(Q.start, Q.start);
@@ -4434,6 +5467,16 @@ size_t HINT_M_ALL::executeBottomUp_Preceded(RangeQuery Q)
     PartitionId next_fromOinA = -1, next_fromRinA = -1, next_fromOinAB = -1, next_fromRinAB = -1;
 
 
+    // Records erased since the last purge, see HierarchicalIndex::erase()
+    if (this->skipErased(result, [&](auto &filtered) {this->executeBottomUp_Preceded(Q, filtered);}))
+        return;
+
+    // Records inserted since the last merge, see HierarchicalIndex::insert()
+    this->delta.execute_Preceded(this->kernel, Q, result);
+
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_Preceded(this->kernel, Q, result);
+
     for (auto l = 0; l < this->numBits; l++)
     {
 //        if (!(foundone && foundzero))
@@ -4465,45 +5508,43 @@ size_t HINT_M_ALL::executeBottomUp_Preceded(RangeQuery Q)
     {
         // Comparisons needed
         iterI = this->pOrgsInIds[this->numBits].begin();
-        iterBegin = this->pOrgsInTimestamps[this->numBits].begin();
-        iterEnd = this->pOrgsInTimestamps[this->numBits].end();
+        iterBegin = this->pOrgsInStarts[this->numBits].begin();
+        iterEnd = this->pOrgsInStarts[this->numBits].end();
+        iterE = this->pOrgsInEnds[this->numBits].begin()+(iterBegin-this->pOrgsInStarts[this->numBits].begin());
         for (iter = iterBegin; iter != iterEnd; iter++)
         {
-            if (Q.start > iter->second)
+            if (Q.start > *iterE)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iterI++;
+            iterE++;
         }
     }
     else
     {
         iterIStart = this->pOrgsInIds[this->numBits].begin();
         iterIEnd = this->pOrgsInIds[this->numBits].end();
-        for (iterI = iterIStart; iterI != iterIEnd; iterI++)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
-        }
+        reportIds(this->kernel, iterIStart, iterIEnd, result);
     }
+}
 
 
-    return result;
+size_t HINT_M_ALL::executeBottomUp_Preceded(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_Preceded(Q, result);
+    
+    return result.get();
 }
 
 
 // Generalized predicates, ACM SIGMOD'22 gOverlaps
-size_t HINT_M_ALL::executeBottomUp_gOverlaps(StabbingQuery Q)
+template <class Sink>
+void HINT_M_ALL::executeBottomUp_gOverlaps(StabbingQuery Q, Sink &result)
 {
-    size_t result = 0;
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI, iterIStart, iterIEnd;
     Timestamp a = Q.point >> (this->maxBits-this->numBits); // prefix
     RecordStart qdummySE(0, Q.point+1);
@@ -4514,6 +5555,16 @@ size_t HINT_M_ALL::executeBottomUp_gOverlaps(StabbingQuery Q)
     PartitionId next_fromOinA = -1, next_fromOaftA = -1, next_fromRinA = -1, next_fromRaftA = -1, next_fromOinB = -1, next_fromOaftB = -1, next_fromOinAB = -1, next_toOinAB = -1, next_fromOaftAB = -1, next_toOaftAB = -1, next_fromR = -1, next_fromO = -1, next_toO = -1;
 
 
+    // Records erased since the last purge, see HierarchicalIndex::erase()
+    if (this->skipErased(result, [&](auto &filtered) {this->executeBottomUp_gOverlaps(Q, filtered);}))
+        return;
+
+    // Records inserted since the last merge, see HierarchicalIndex::insert()
+    this->delta.execute_gOverlaps(this->kernel, Q, result);
+
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_gOverlaps(this->kernel, Q, result);
+
     for (auto l = 0; l < this->numBits; l++)
     {
         if (foundone && foundzero)
@@ -4553,42 +5604,32 @@ size_t HINT_M_ALL::executeBottomUp_gOverlaps(StabbingQuery Q)
         // All contents are guaranteed to be results
         iterIStart = this->pOrgsInIds[this->numBits].begin();
         iterIEnd = this->pOrgsInIds[this->numBits].end();
-        for (iterI = iterIStart; iterI != iterIEnd; iterI++)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
-        }
+        this->reportRange(this->pOrgsInAggregates, this->numBits, this->pOrgsInIds[this->numBits], iterIStart, iterIEnd, result);
     }
     else
     {
         // Comparisons needed
-        iterBegin = this->pOrgsInTimestamps[this->numBits].begin();
-        iterEnd = lower_bound(iterBegin, this->pOrgsInTimestamps[this->numBits].end(), qdummyE, CompareTimestampPairsByStart);
-        for (iter = iterBegin; iter != iterEnd; iter++)
-        {
-            if (Q.point <= iter->second)
-            {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= this->pOrgsInIds[this->numBits][iter-iterBegin];
-#endif
-            }
-        }
+        iterBegin = this->pOrgsInStarts[this->numBits].begin();
+        iterEnd = lower_bound(iterBegin, this->pOrgsInStarts[this->numBits].end(), qdummyE.first);
+        scanNotBefore(this->kernel, this->pOrgsInEnds[this->numBits].data(), this->pOrgsInIds[this->numBits].data(), iterEnd-iterBegin, Q.point, result);
     }
+}
 
 
-    return result;
+size_t HINT_M_ALL::executeBottomUp_gOverlaps(StabbingQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_gOverlaps(Q, result);
+    
+    return result.get();
 }
 
 
-size_t HINT_M_ALL::executeBottomUp_gOverlaps(RangeQuery Q)
+template <class Sink>
+inline void HINT_M_ALL::executeBottomUp_gOverlaps(RangeQuery Q, gOverlapsSweep *sweep, Sink &result)
 {
-    size_t result = 0;
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampArrayIterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI, iterIStart, iterIEnd;
     Timestamp a = Q.start >> (this->maxBits-this->numBits); // prefix
     Timestamp b = Q.end   >> (this->maxBits-this->numBits); // prefix
@@ -4597,9 +5638,44 @@ size_t HINT_M_ALL::executeBottomUp_gOverlaps(RangeQuery Q)
     pair<Timestamp, Timestamp> qdummyE(Q.end+1, Q.end+1);
     bool foundzero = false;
     bool foundone = false;
+    vector<IdRange> &ranges = QueryContext::local().ranges;
     PartitionId next_fromOinA = -1, next_fromOaftA = -1, next_fromRinA = -1, next_fromRaftA = -1, next_fromOinB = -1, next_fromOaftB = -1, next_fromOinAB = -1, next_toOinAB = -1, next_fromOaftAB = -1, next_toOaftAB = -1, next_fromR = -1, next_fromO = -1, next_toO = -1;
 
 
+    // Records erased since the last purge, see HierarchicalIndex::erase()
+    if (this->skipErased(result, [&](auto &filtered) {this->executeBottomUp_gOverlaps(Q, sweep, filtered);}))
+        return;
+
+    // Records inserted since the last merge, see HierarchicalIndex::insert()
+    this->delta.execute_gOverlaps(this->kernel, Q, result);
+
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_gOverlaps(this->kernel, Q, result);
+
+    // Within a batch, start the bottom level from where the previous query
+    // left the offsets instead of binary searching them
+    if (sweep != NULL)
+    {
+        next_fromOinA  = sweep->OinA.from(this->pOrgsIn_ioffsets[0], a);
+        next_fromOaftA = sweep->OaftA.from(this->pOrgsAft_ioffsets[0], a);
+        next_fromRinA  = sweep->RinA.from(this->pRepsIn_ioffsets[0], a);
+        next_fromRaftA = sweep->RaftA.from(this->pRepsAft_ioffsets[0], a);
+        if (a < b)
+        {
+            next_fromOinAB  = sweep->OinAB.from(this->pOrgsIn_ioffsets[0], a+1);
+            next_toOinAB    = sweep->toOinAB.to(this->pOrgsIn_ioffsets[0], b-1);
+            next_fromOaftAB = sweep->OaftAB.from(this->pOrgsAft_ioffsets[0], a+1);
+            next_toOaftAB   = sweep->toOaftAB.to(this->pOrgsAft_ioffsets[0], b-1);
+            next_fromOinB   = sweep->OinB.from(this->pOrgsIn_ioffsets[0], b);
+            next_fromOaftB  = sweep->OaftB.from(this->pOrgsAft_ioffsets[0], b);
+        }
+    }
+
+
+    // The originals in partitions fully covered by the query qualify without
+    // comparisons; collect their ids ranges and scan them at the end, in
+    // parallel if they are many
+    ranges.clear();
     for (auto l = 0; l < this->numBits; l++)
     {
         if (foundone && foundzero)
@@ -4611,8 +5687,10 @@ size_t HINT_M_ALL::executeBottomUp_gOverlaps(RangeQuery Q)
             this->scanFirstPartition_RepsIn_gOverlaps(l, a, next_fromRinA, result);
             this->scanFirstPartition_RepsAft_gOverlaps(l, a, next_fromRaftA, result);
 
-            this->scanPartitions_OrgsIn_gOverlaps(l, a, b, next_fromOinAB, next_toOinAB, result);
-            this->scanPartitions_OrgsAft_gOverlaps(l, a, b, next_fromOaftAB, next_toOaftAB, result);
+            if (this->getBounds_OrgsIn(l, a, b, next_fromOinAB, next_toOinAB, iterIStart, iterIEnd))
+                this->collectRange(this->pOrgsInAggregates, l, this->pOrgsInIds[l], iterIStart, iterIEnd, ranges, result);
+            if (this->getBounds_OrgsAft(l, a, b, next_fromOaftAB, next_toOaftAB, iterIStart, iterIEnd))
+                this->collectRange(this->pOrgsAftAggregates, l, this->pOrgsAftIds[l], iterIStart, iterIEnd, ranges, result);
         }
         else
         {
@@ -4639,8 +5717,10 @@ size_t HINT_M_ALL::executeBottomUp_gOverlaps(RangeQuery Q)
             if (a < b)
             {
                 // Handle the rest before the partition that contains b: consider only originals, no comparisons needed
-                this->scanPartitions_OrgsIn_gOverlaps(l, a+1, b-1, next_fromOinAB, next_toOinAB, result);
-                this->scanPartitions_OrgsAft_gOverlaps(l, a+1, b-1, next_fromOaftAB, next_toOaftAB, result);
+                if (this->getBounds_OrgsIn(l, a+1, b-1, next_fromOinAB, next_toOinAB, iterIStart, iterIEnd))
+                    this->collectRange(this->pOrgsInAggregates, l, this->pOrgsInIds[l], iterIStart, iterIEnd, ranges, result);
+                if (this->getBounds_OrgsAft(l, a+1, b-1, next_fromOaftAB, next_toOaftAB, iterIStart, iterIEnd))
+                    this->collectRange(this->pOrgsAftAggregates, l, this->pOrgsAftIds[l], iterIStart, iterIEnd, ranges, result);
 
                 // Handle the partition that contains b: consider only originals, comparisons needed
                 this->scanLastPartition_OrgsIn_gOverlaps(l, b, qdummyE, next_fromOinB, result);
@@ -4660,37 +5740,82 @@ size_t HINT_M_ALL::executeBottomUp_gOverlaps(RangeQuery Q)
     if (foundone && foundzero)
     {
         // All contents are guaranteed to be results
-        iterIStart = this->pOrgsInIds[this->numBits].begin();
-        iterIEnd = this->pOrgsInIds[this->numBits].end();
-        for (iterI = iterIStart; iterI != iterIEnd; iterI++)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
-        }
+        this->collectRange(this->pOrgsInAggregates, this->numBits, this->pOrgsInIds[this->numBits], this->pOrgsInIds[this->numBits].begin(), this->pOrgsInIds[this->numBits].end(), ranges, result);
     }
     else
     {
         // Comparisons needed
-        iterI = this->pOrgsInIds[this->numBits].begin();
-        iterBegin = this->pOrgsInTimestamps[this->numBits].begin();
-        iterEnd = lower_bound(iterBegin, this->pOrgsInTimestamps[this->numBits].end(), qdummyE, CompareTimestampPairsByStart);
-        for (iter = iterBegin; iter != iterEnd; iter++)
-        {
-            if (Q.start <= iter->second)
-            {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
-            }
-            iterI++;
-        }
+        iterBegin = this->pOrgsInStarts[this->numBits].begin();
+        iterEnd = lower_bound(iterBegin, this->pOrgsInStarts[this->numBits].end(), qdummyE.first);
+        scanNotBefore(this->kernel, this->pOrgsInEnds[this->numBits].data(), this->pOrgsInIds[this->numBits].data(), iterEnd-iterBegin, Q.start, result);
     }
 
+    this->scanRanges(ranges, result);
+}
+
+
+template <class Sink>
+void HINT_M_ALL::executeBottomUp_gOverlaps(RangeQuery Q, Sink &result)
+{
+    this->executeBottomUp_gOverlaps(Q, NULL, result);
+}
+
+
+size_t HINT_M_ALL::executeBottomUp_gOverlaps(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_gOverlaps(Q, result);
+    
+    return result.get();
+}
+
+
+// Querying a batch; the queries are evaluated in the order of their start,
+// sharing the cursors over the bottom-level offsets, see gOverlapsSweep.
+template <class Sink>
+void HINT_M_ALL::executeBottomUp_gOverlaps(const vector<RangeQuery> &queries, vector<Sink> &results)
+{
+    vector<size_t> order;
+    gOverlapsSweep sweep;
+    
+    
+    this->getBatchOrder(queries, order);
+    for (auto i : order)
+        this->executeBottomUp_gOverlaps(queries[i], &sweep, results[i]);
+}
+
 
-    return result;
+void HINT_M_ALL::executeBottomUp_gOverlaps(const vector<RangeQuery> &queries, vector<size_t> &results)
+{
+    vector<WorkloadSink> sinks(queries.size());
+    
+    
+    this->executeBottomUp_gOverlaps(queries, sinks);
+    results.resize(queries.size());
+    for (auto i = 0; i < queries.size(); i++)
+        results[i] = sinks[i].get();
 }
+
+
+
+// Explicit instantiations for every result sink
+#define INSTANTIATE_HINT_M_ALL(Sink) \
+    template void HINT_M_ALL::executeBottomUp_Equals(RangeQuery, Sink&); \
+    template void HINT_M_ALL::executeBottomUp_Starts(RangeQuery, Sink&); \
+    template void HINT_M_ALL::executeBottomUp_Started(RangeQuery, Sink&); \
+    template void HINT_M_ALL::executeBottomUp_Finishes(RangeQuery, Sink&); \
+    template void HINT_M_ALL::executeBottomUp_Finished(RangeQuery, Sink&); \
+    template void HINT_M_ALL::executeBottomUp_Meets(RangeQuery, Sink&); \
+    template void HINT_M_ALL::executeBottomUp_Met(RangeQuery, Sink&); \
+    template void HINT_M_ALL::executeBottomUp_Overlaps(RangeQuery, Sink&); \
+    template void HINT_M_ALL::executeBottomUp_Overlapped(RangeQuery, Sink&); \
+    template void HINT_M_ALL::executeBottomUp_Contains(RangeQuery, Sink&); \
+    template void HINT_M_ALL::executeBottomUp_Contained(RangeQuery, Sink&); \
+    template void HINT_M_ALL::executeBottomUp_Precedes(RangeQuery, Sink&); \
+    template void HINT_M_ALL::executeBottomUp_Preceded(RangeQuery, Sink&); \
+    template void HINT_M_ALL::executeBottomUp_gOverlaps(StabbingQuery, Sink&); \
+    template void HINT_M_ALL::executeBottomUp_gOverlaps(RangeQuery, Sink&); \
+    template void HINT_M_ALL::executeBottomUp_gOverlaps(const vector<RangeQuery>&, vector<Sink>&);
+
+FOR_EACH_SINK(INSTANTIATE_HINT_M_ALL)
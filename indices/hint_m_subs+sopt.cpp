@@ -325,9 +325,9 @@ HINT_M_SubsSopt::~HINT_M_SubsSopt()
 
 
 // Generalized predicates, ACM SIGMOD'22 gOverlaps
-size_t HINT_M_SubsSopt::executeBottomUp_gOverlaps(RangeQuery Q)
+template <class Sink>
+void HINT_M_SubsSopt::executeBottomUp_gOverlaps(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
     RelationIterator iter, iterBegin, iterEnd;
     RelationStartIterator iterS, iterSBegin, iterSEnd;
     RelationEndIterator iterE, iterEBegin, iterEEnd;
@@ -339,6 +339,7 @@ size_t HINT_M_SubsSopt::executeBottomUp_gOverlaps(RangeQuery Q)
     RecordEnd qdummyS(0, Q.start);
     bool foundzero = false;
     bool foundone = false;
+    const Timestamp tmin = numeric_limits<Timestamp>::min(), tmax = numeric_limits<Timestamp>::max();
     
     
     for (auto l = 0; l < this->numBits; l++)
@@ -353,21 +354,13 @@ size_t HINT_M_SubsSopt::executeBottomUp_gOverlaps(RangeQuery Q)
             iterEEnd = this->pRepsIn[l][a].end();
             for (iterE = iterEBegin; iterE != iterEEnd; iterE++)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= iterE->id;
-#endif
+                result.add(iterE->id);
             }
             iterIBegin =this->pRepsAft[l][a].begin();
             iterIEnd = this->pRepsAft[l][a].end();
             for (iterI = iterIBegin; iterI != iterIEnd; iterI++)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             
             // Handle rest: consider only originals
@@ -377,21 +370,13 @@ size_t HINT_M_SubsSopt::executeBottomUp_gOverlaps(RangeQuery Q)
                 iterEnd = this->pOrgsIn[l][j].end();
                 for (iter = iterBegin; iter != iterEnd; iter++)
                 {
-#ifdef WORKLOAD_COUNT
-                    result++;
-#else
-                    result ^= iter->id;
-#endif
+                    result.add(iter->id);
                 }
                 iterSBegin = this->pOrgsAft[l][j].begin();
                 iterSEnd = this->pOrgsAft[l][j].end();
                 for (iterS = iterSBegin; iterS != iterSEnd; iterS++)
                 {
-#ifdef WORKLOAD_COUNT
-                    result++;
-#else
-                    result ^= iterS->id;
-#endif
+                    result.add(iterS->id);
                 }
             }
         }
@@ -405,86 +390,22 @@ size_t HINT_M_SubsSopt::executeBottomUp_gOverlaps(RangeQuery Q)
                 // Special case when query overlaps only one partition, Lemma 3
                 if (!foundzero && !foundone)
                 {
-                    iterBegin = this->pOrgsIn[l][a].begin();
-                    iterEnd = this->pOrgsIn[l][a].end();
-                    for (iter = iterBegin; iter != iterEnd; iter++)
-                    {
-                        if ((iter->start <= Q.end) && (Q.start <= iter->end))
-                        {
-#ifdef WORKLOAD_COUNT
-                            result++;
-#else
-                            result ^= iter->id;
-#endif
-                        }
-                    }
-                    iterSBegin = this->pOrgsAft[l][a].begin();
-                    iterSEnd = this->pOrgsAft[l][a].end();
-                    for (iterS = iterSBegin; iterS != iterSEnd; iterS++)
-                    {
-                        if (iterS->start <= Q.end)
-                        {
-#ifdef WORKLOAD_COUNT
-                            result++;
-#else
-                            result ^= iterS->id;
-#endif
-                        }
-                    }
+                    scanRecords(this->kernel, this->pOrgsIn[l][a], tmin, Q.end, Q.start, tmax, result);
+                    scanEntries(this->kernel, this->pOrgsAft[l][a], tmin, Q.end, result);
                 }
                 else if (foundzero)
                 {
-                    iterBegin = this->pOrgsIn[l][a].begin();
-                    iterEnd = this->pOrgsIn[l][a].end();
-                    for (iter = iterBegin; iter != iterEnd; iter++)
-                    {
-                        if (iter->start <= Q.end)
-                        {
-#ifdef WORKLOAD_COUNT
-                            result++;
-#else
-                            result ^= iter->id;
-#endif
-                        }
-                    }
-                    iterSBegin = this->pOrgsAft[l][a].begin();
-                    iterSEnd = this->pOrgsAft[l][a].end();
-                    for (iterS = iterSBegin; iterS != iterSEnd; iterS++)
-                    {
-                        if (iterS->start <= Q.end)
-                        {
-#ifdef WORKLOAD_COUNT
-                            result++;
-#else
-                            result ^= iterS->id;
-#endif
-                        }
-                    }
+                    scanRecords(this->kernel, this->pOrgsIn[l][a], tmin, Q.end, tmin, tmax, result);
+                    scanEntries(this->kernel, this->pOrgsAft[l][a], tmin, Q.end, result);
                 }
                 else if (foundone)
                 {
-                    iterBegin = this->pOrgsIn[l][a].begin();
-                    iterEnd = this->pOrgsIn[l][a].end();
-                    for (iter = iterBegin; iter != iterEnd; iter++)
-                    {
-                        if (Q.start <= iter->end)
-                        {
-#ifdef WORKLOAD_COUNT
-                            result++;
-#else
-                            result ^= iter->id;
-#endif
-                        }
-                    }
+                    scanRecords(this->kernel, this->pOrgsIn[l][a], tmin, tmax, Q.start, tmax, result);
                     iterSBegin = this->pOrgsAft[l][a].begin();
                     iterSEnd = this->pOrgsAft[l][a].end();
                     for (iterS = iterSBegin; iterS != iterSEnd; iterS++)
                     {
-#ifdef WORKLOAD_COUNT
-                        result++;
-#else
-                        result ^= iterS->id;
-#endif
+                        result.add(iterS->id);
                     }
                 }
             }
@@ -493,19 +414,7 @@ size_t HINT_M_SubsSopt::executeBottomUp_gOverlaps(RangeQuery Q)
                 // Lemma 1
                 if (!foundzero)
                 {
-                    iterBegin = this->pOrgsIn[l][a].begin();
-                    iterEnd = this->pOrgsIn[l][a].end();
-                    for (iter = iterBegin; iter != iterEnd; iter++)
-                    {
-                        if (Q.start <= iter->end)
-                        {
-#ifdef WORKLOAD_COUNT
-                            result++;
-#else
-                            result ^= iter->id;
-#endif
-                        }
-                    }
+                    scanRecords(this->kernel, this->pOrgsIn[l][a], tmin, tmax, Q.start, tmax, result);
                 }
                 else
                 {
@@ -513,41 +422,21 @@ size_t HINT_M_SubsSopt::executeBottomUp_gOverlaps(RangeQuery Q)
                     iterEnd = this->pOrgsIn[l][a].end();
                     for (iter = iterBegin; iter != iterEnd; iter++)
                     {
-#ifdef WORKLOAD_COUNT
-                        result++;
-#else
-                        result ^= iter->id;
-#endif
+                        result.add(iter->id);
                     }
                 }
                 iterSBegin = this->pOrgsAft[l][a].begin();
                 iterSEnd = this->pOrgsAft[l][a].end();
                 for (iterS = iterSBegin; iterS != iterSEnd; iterS++)
                 {
-#ifdef WORKLOAD_COUNT
-                    result++;
-#else
-                    result ^= iterS->id;
-#endif
+                    result.add(iterS->id);
                 }
             }
             
             // Lemma 1, 3
             if (!foundzero)
             {
-                iterEBegin = this->pRepsIn[l][a].begin();
-                iterEEnd = this->pRepsIn[l][a].end();
-                for (iterE = iterEBegin; iterE != iterEEnd; iterE++)
-                {
-                    if (Q.start <= iterE->end)
-                    {
-#ifdef WORKLOAD_COUNT
-                        result++;
-#else
-                        result ^= iterE->id;
-#endif
-                    }
-                }
+                scanEntries(this->kernel, this->pRepsIn[l][a], Q.start, tmax, result);
             }
             else
             {
@@ -555,22 +444,14 @@ size_t HINT_M_SubsSopt::executeBottomUp_gOverlaps(RangeQuery Q)
                 iterEEnd = this->pRepsIn[l][a].end();
                 for (iterE = iterEBegin; iterE != iterEEnd; iterE++)
                 {
-#ifdef WORKLOAD_COUNT
-                    result++;
-#else
-                    result ^= iterE->id;
-#endif
+                    result.add(iterE->id);
                 }
             }
             iterIBegin = this->pRepsAft[l][a].begin();
             iterIEnd = this->pRepsAft[l][a].end();
             for (iterI = iterIBegin; iterI != iterIEnd; iterI++)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             
             if (a < b)
@@ -584,51 +465,19 @@ size_t HINT_M_SubsSopt::executeBottomUp_gOverlaps(RangeQuery Q)
                         iterEnd = this->pOrgsIn[l][j].end();
                         for (iter = iterBegin; iter != iterEnd; iter++)
                         {
-#ifdef WORKLOAD_COUNT
-                            result++;
-#else
-                            result ^= iter->id;
-#endif
+                            result.add(iter->id);
                         }
                         iterSBegin = this->pOrgsAft[l][j].begin();
                         iterSEnd = this->pOrgsAft[l][j].end();
                         for (iterS = iterSBegin; iterS != iterSEnd; iterS++)
                         {
-#ifdef WORKLOAD_COUNT
-                            result++;
-#else
-                            result ^= iterS->id;
-#endif
+                            result.add(iterS->id);
                         }
                     }
                     
                     // Handle the partition that contains b: consider only originals, comparisons needed
-                    iterBegin = this->pOrgsIn[l][b].begin();
-                    iterEnd = this->pOrgsIn[l][b].end();
-                    for (iter = iterBegin; iter != iterEnd; iter++)
-                    {
-                        if (iter->start <= Q.end)
-                        {
-#ifdef WORKLOAD_COUNT
-                            result++;
-#else
-                            result ^= iter->id;
-#endif
-                        }
-                    }
-                    iterSBegin = this->pOrgsAft[l][b].begin();
-                    iterSEnd = this->pOrgsAft[l][b].end();
-                    for (iterS = iterSBegin; iterS != iterSEnd; iterS++)
-                    {
-                        if (iterS->start <= Q.end)
-                        {
-#ifdef WORKLOAD_COUNT
-                            result++;
-#else
-                            result ^= iterS->id;
-#endif
-                        }
-                    }
+                    scanRecords(this->kernel, this->pOrgsIn[l][b], tmin, Q.end, tmin, tmax, result);
+                    scanEntries(this->kernel, this->pOrgsAft[l][b], tmin, Q.end, result);
                 }
                 else
                 {
@@ -638,21 +487,13 @@ size_t HINT_M_SubsSopt::executeBottomUp_gOverlaps(RangeQuery Q)
                         iterEnd = this->pOrgsIn[l][j].end();
                         for (iter = iterBegin; iter != iterEnd; iter++)
                         {
-#ifdef WORKLOAD_COUNT
-                            result++;
-#else
-                            result ^= iter->id;
-#endif
+                            result.add(iter->id);
                         }
                         iterSBegin = this->pOrgsAft[l][j].begin();
                         iterSEnd = this->pOrgsAft[l][j].end();
                         for (iterS = iterSBegin; iterS != iterSEnd; iterS++)
                         {
-#ifdef WORKLOAD_COUNT
-                            result++;
-#else
-                            result ^= iterS->id;
-#endif
+                            result.add(iterS->id);
                         }
                     }
                 }
@@ -675,31 +516,31 @@ size_t HINT_M_SubsSopt::executeBottomUp_gOverlaps(RangeQuery Q)
         iterEnd = this->pOrgsIn[this->numBits][0].end();
         for (iter = iterBegin; iter != iterEnd; iter++)
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= iter->id;
-#endif
+            result.add(iter->id);
         }
     }
     else
     {
         // Comparisons needed
-        iterBegin = this->pOrgsIn[this->numBits][0].begin();
-        iterEnd = this->pOrgsIn[this->numBits][0].end();
-        for (iter = iterBegin; iter != iterEnd; iter++)
-        {
-            if ((iter->start <= Q.end) && (Q.start <= iter->end))
-            {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= iter->id;
-#endif
-            }
-        }
+        scanRecords(this->kernel, this->pOrgsIn[this->numBits][0], tmin, Q.end, Q.start, tmax, result);
     }
     
+}
+
+
+size_t HINT_M_SubsSopt::executeBottomUp_gOverlaps(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_gOverlaps(Q, result);
     
-    return result;
+    return result.get();
 }
+
+
+
+// Explicit instantiations for every result sink
+#define INSTANTIATE_HINT_M_SUBSSOPT(Sink) \
+    template void HINT_M_SubsSopt::executeBottomUp_gOverlaps(RangeQuery, Sink&);
+
+FOR_EACH_SINK(INSTANTIATE_HINT_M_SUBSSOPT)
@@ -524,49 +524,25 @@ HINT_M_SubsSort_CM::~HINT_M_SubsSort_CM()
 
 
 // Querying
-inline void HINT_M_SubsSort_CM::scanPartition_CheckBothTimestamps_gOverlaps(unsigned int level, Timestamp t, RelationId **ids, vector<pair<Timestamp, Timestamp>> **timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), RangeQuery &q, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_CM::scanPartition_CheckBothTimestamps_gOverlaps(unsigned int level, Timestamp t, RelationId **ids, vector<pair<Timestamp, Timestamp>> **timestamps, bool (*)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), RangeQuery &q, Sink &result)
 {
-    auto iterI = ids[level][t].begin();
     auto iterBegin = timestamps[level][t].begin();
     auto iterEnd = lower_bound(iterBegin, timestamps[level][t].end(), pair<Timestamp, Timestamp>(q.end+1, q.end+1));
     
-    for (auto iter = iterBegin; iter != iterEnd; iter++)
-    {
-        if (q.start <= iter->second)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
-        }
-        iterI++;
-    }
+    scanPairs(this->kernel, timestamps[level][t].data(), ids[level][t].data(), iterEnd-iterBegin, numeric_limits<Timestamp>::min(), numeric_limits<Timestamp>::max(), q.start, numeric_limits<Timestamp>::max(), result);
 }
 
 
-inline void HINT_M_SubsSort_CM::scanPartition_CheckEnd_gOverlaps(unsigned int level, Timestamp t, RelationId **ids, vector<pair<Timestamp, Timestamp>> **timestamps, RangeQuery &q, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_CM::scanPartition_CheckEnd_gOverlaps(unsigned int level, Timestamp t, RelationId **ids, vector<pair<Timestamp, Timestamp>> **timestamps, RangeQuery &q, Sink &result)
 {
-    auto iterI = ids[level][t].begin();
-    auto iterBegin = timestamps[level][t].begin();
-    auto iterEnd = timestamps[level][t].end();
-
-    for (auto iter = iterBegin; iter != iterEnd; iter++)
-    {
-        if (q.start <= iter->second)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
-        }
-        iterI++;
-    }
+    scanPairs(this->kernel, timestamps[level][t].data(), ids[level][t].data(), timestamps[level][t].size(), numeric_limits<Timestamp>::min(), numeric_limits<Timestamp>::max(), q.start, numeric_limits<Timestamp>::max(), result);
 }
 
 
-inline void HINT_M_SubsSort_CM::scanPartition_CheckEnd_gOverlaps(unsigned int level, Timestamp t, RelationId **ids, vector<pair<Timestamp, Timestamp>> **timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), RangeQuery &q, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_CM::scanPartition_CheckEnd_gOverlaps(unsigned int level, Timestamp t, RelationId **ids, vector<pair<Timestamp, Timestamp>> **timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), RangeQuery &q, Sink &result)
 {
     auto iterI = ids[level][t].begin();
     auto iterBegin = timestamps[level][t].begin();
@@ -576,11 +552,7 @@ inline void HINT_M_SubsSort_CM::scanPartition_CheckEnd_gOverlaps(unsigned int le
     iterI += iter-iterBegin;
     while (iter != iterEnd)
     {
-#ifdef WORKLOAD_COUNT
-        result++;
-#else
-        result ^= (*iterI);
-#endif
+        result.add(*iterI);
 
         iter++;
         iterI++;
@@ -588,7 +560,8 @@ inline void HINT_M_SubsSort_CM::scanPartition_CheckEnd_gOverlaps(unsigned int le
 }
 
 
-inline void HINT_M_SubsSort_CM::scanPartition_CheckStart_gOverlaps(unsigned int level, Timestamp t, RelationId **ids, vector<pair<Timestamp, Timestamp>> **timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), RangeQuery &q, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_CM::scanPartition_CheckStart_gOverlaps(unsigned int level, Timestamp t, RelationId **ids, vector<pair<Timestamp, Timestamp>> **timestamps, bool (*)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), RangeQuery &q, Sink &result)
 {
     auto iterI = ids[level][t].begin();
     auto iterBegin = timestamps[level][t].begin();
@@ -596,34 +569,28 @@ inline void HINT_M_SubsSort_CM::scanPartition_CheckStart_gOverlaps(unsigned int
 
     for (auto iter = iterBegin; iter != iterEnd; iter++)
     {
-#ifdef WORKLOAD_COUNT
-        result++;
-#else
-        result ^= (*iterI);
-#endif
+        result.add(*iterI);
 
         iterI++;
     }
 }
 
 
-inline void HINT_M_SubsSort_CM::scanPartition_NoChecks_gOverlaps(unsigned int level, Timestamp t, RelationId **ids, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_CM::scanPartition_NoChecks_gOverlaps(unsigned int level, Timestamp t, RelationId **ids, Sink &result)
 {
     auto iterIBegin = ids[level][t].begin();
     auto iterIEnd = ids[level][t].end();
 
     for (auto iterI = iterIBegin; iterI != iterIEnd; iterI++)
     {
-#ifdef WORKLOAD_COUNT
-        result++;
-#else
-        result ^= (*iterI);
-#endif
+        result.add(*iterI);
     }
 }
 
 
-inline void HINT_M_SubsSort_CM::scanPartitions_NoChecks_gOverlaps(unsigned int level, Timestamp ts, Timestamp te, RelationId **ids, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_CM::scanPartitions_NoChecks_gOverlaps(unsigned int level, Timestamp ts, Timestamp te, RelationId **ids, Sink &result)
 {
     for (auto j = ts; j <= te; j++)
     {
@@ -631,23 +598,20 @@ inline void HINT_M_SubsSort_CM::scanPartitions_NoChecks_gOverlaps(unsigned int l
         auto iterIEnd = ids[level][j].end();
         for (auto iterI = iterIBegin; iterI != iterIEnd; iterI++)
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
+            result.add(*iterI);
         }
     }
 }
 
 
-size_t HINT_M_SubsSort_CM::executeBottomUp_gOverlaps(RangeQuery q)
+template <class Sink>
+void HINT_M_SubsSort_CM::executeBottomUp_gOverlaps(RangeQuery q, Sink &result)
 {
-    size_t result = 0;
     Timestamp a = q.start >> (this->maxBits-this->numBits); // prefix
     Timestamp b = q.end   >> (this->maxBits-this->numBits); // prefix
     bool foundzero = false;
     bool foundone = false;
+    const Timestamp tmin = numeric_limits<Timestamp>::min(), tmax = numeric_limits<Timestamp>::max();
     
     
     for (auto l = 0; l < this->numBits; l++)
@@ -715,33 +679,33 @@ size_t HINT_M_SubsSort_CM::executeBottomUp_gOverlaps(RangeQuery q)
         auto iterIEnd = this->pOrgsInIds[this->numBits][0].end();
         for (auto iterI = iterIBegin; iterI != iterIEnd; iterI++)
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
+            result.add(*iterI);
         }
     }
     else
     {
         // Comparisons needed
-        auto iterI = this->pOrgsInIds[this->numBits][0].begin();
         auto iterBegin = this->pOrgsInTimestamps[this->numBits][0].begin();
         auto iterEnd = lower_bound(iterBegin, this->pOrgsInTimestamps[this->numBits][0].end(), make_pair<Timestamp, Timestamp>(q.end+1, q.end+1), CompareTimestampPairsByStart);
-        for (auto iter = iterBegin; iter != iterEnd; iter++)
-        {
-            if ((iter->first <= q.end) && (q.start <= iter->second))
-            {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
-            }
-            iterI++;
-        }
+        scanPairs(this->kernel, this->pOrgsInTimestamps[this->numBits][0].data(), this->pOrgsInIds[this->numBits][0].data(), iterEnd-iterBegin, tmin, q.end, q.start, tmax, result);
     }
     
+}
+
+
+size_t HINT_M_SubsSort_CM::executeBottomUp_gOverlaps(RangeQuery q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_gOverlaps(q, result);
     
-    return result;
+    return result.get();
 }
+
+
+
+// Explicit instantiations for every result sink
+#define INSTANTIATE_HINT_M_SUBSSORT_CM(Sink) \
+    template void HINT_M_SubsSort_CM::executeBottomUp_gOverlaps(RangeQuery, Sink&);
+
+FOR_EACH_SINK(INSTANTIATE_HINT_M_SUBSSORT_CM)
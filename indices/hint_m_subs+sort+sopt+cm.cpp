@@ -367,9 +367,9 @@ HINT_M_SubsSortSopt_CM::~HINT_M_SubsSortSopt_CM()
 
 
 // Generalized predicates, ACM SIGMOD'22 gOverlaps
-size_t HINT_M_SubsSortSopt_CM::executeBottomUp_gOverlaps(RangeQuery Q)
+template <class Sink>
+void HINT_M_SubsSortSopt_CM::executeBottomUp_gOverlaps(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
     vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
     vector<Timestamp>::iterator iterS, iterSBegin, iterSEnd;
     vector<Timestamp>::iterator iterE, iterEBegin, iterEEnd;
@@ -381,6 +381,7 @@ size_t HINT_M_SubsSortSopt_CM::executeBottomUp_gOverlaps(RangeQuery Q)
     Timestamp qdummyS = Q.start;
     bool foundzero = false;
     bool foundone = false;
+    const Timestamp tmin = numeric_limits<Timestamp>::min(), tmax = numeric_limits<Timestamp>::max();
     
     
     for (auto l = 0; l < this->numBits; l++)
@@ -395,21 +396,13 @@ size_t HINT_M_SubsSortSopt_CM::executeBottomUp_gOverlaps(RangeQuery Q)
             iterIEnd = this->pRepsInIds[l][a].end();
             for (iterI = iterIBegin; iterI != iterIEnd; iterI++)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iterIBegin =this->pRepsAft[l][a].begin();
             iterIEnd = this->pRepsAft[l][a].end();
             for (iterI = iterIBegin; iterI != iterIEnd; iterI++)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             
             // Handle rest: consider only originals
@@ -419,21 +412,13 @@ size_t HINT_M_SubsSortSopt_CM::executeBottomUp_gOverlaps(RangeQuery Q)
                 iterIEnd = this->pOrgsInIds[l][j].end();
                 for (iterI = iterIBegin; iterI != iterIEnd; iterI++)
                 {
-#ifdef WORKLOAD_COUNT
-                    result++;
-#else
-                    result ^= (*iterI);
-#endif
+                    result.add(*iterI);
                 }
                 iterIBegin = this->pOrgsAftIds[l][j].begin();
                 iterIEnd = this->pOrgsAftIds[l][j].end();
                 for (iterI = iterIBegin; iterI != iterIEnd; iterI++)
                 {
-#ifdef WORKLOAD_COUNT
-                    result++;
-#else
-                    result ^= (*iterI);
-#endif
+                    result.add(*iterI);
                 }
             }
         }
@@ -447,53 +432,23 @@ size_t HINT_M_SubsSortSopt_CM::executeBottomUp_gOverlaps(RangeQuery Q)
                 // Special case when query overlaps only one partition, Lemma 3
                 iterBegin = this->pOrgsInTimestamps[l][a].begin();
                 iterEnd = lower_bound(iterBegin, this->pOrgsInTimestamps[l][a].end(), qdummyE, CompareTimestampPairsByStart);
-                for (iter = iterBegin; iter != iterEnd; iter++)
-                {
-                    if (Q.start <= iter->second)
-                    {
-#ifdef WORKLOAD_COUNT
-                        result++;
-#else
-                        result ^= this->pOrgsInIds[l][a][iter-iterBegin];
-#endif
-                    }
-                }
+                scanPairs(this->kernel, this->pOrgsInTimestamps[l][a].data(), this->pOrgsInIds[l][a].data(), iterEnd-iterBegin, tmin, tmax, Q.start, tmax, result);
                 iterSBegin = this->pOrgsAftTimestamp[l][a].begin();
                 iterSEnd = lower_bound(iterSBegin, this->pOrgsAftTimestamp[l][a].end(), qdummySE);
                 for (iterS = iterSBegin; iterS != iterSEnd; iterS++)
                 {
-#ifdef WORKLOAD_COUNT
-                    result++;
-#else
-                    result ^= this->pOrgsAftIds[l][a][iterS-iterSBegin];
-#endif
+                    result.add(this->pOrgsAftIds[l][a][iterS-iterSBegin]);
                 }
             }
             else
             {
                 // Lemma 1
-                iterBegin = this->pOrgsInTimestamps[l][a].begin();
-                iterEnd = this->pOrgsInTimestamps[l][a].end();
-                for (iter = iterBegin; iter != iterEnd; iter++)
-                {
-                    if (Q.start <= iter->second)
-                    {
-#ifdef WORKLOAD_COUNT
-                        result++;
-#else
-                        result ^= this->pOrgsInIds[l][a][iter-iterBegin];
-#endif
-                    }
-                }
+                scanPairs(this->kernel, this->pOrgsInTimestamps[l][a].data(), this->pOrgsInIds[l][a].data(), this->pOrgsInTimestamps[l][a].size(), tmin, tmax, Q.start, tmax, result);
                 iterSBegin = this->pOrgsAftTimestamp[l][a].begin();
                 iterSEnd = this->pOrgsAftTimestamp[l][a].end();
                 for (vector<Timestamp>::iterator iter = iterSBegin; iter != iterSEnd; iter++)
                 {
-#ifdef WORKLOAD_COUNT
-                    result++;
-#else
-                    result ^= this->pOrgsAftIds[l][a][iter-iterSBegin];
-#endif
+                    result.add(this->pOrgsAftIds[l][a][iter-iterSBegin]);
                 }
             }
             
@@ -503,21 +458,13 @@ size_t HINT_M_SubsSortSopt_CM::executeBottomUp_gOverlaps(RangeQuery Q)
             vector<Timestamp>::iterator pivot = lower_bound(iterEBegin, iterEEnd, qdummyS);
             for (iterE = pivot; iterE != iterEEnd; iterE++)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= this->pRepsInIds[l][a][iterE-iterEBegin];
-#endif
+                result.add(this->pRepsInIds[l][a][iterE-iterEBegin]);
             }
             iterIBegin = this->pRepsAft[l][a].begin();
             iterIEnd = this->pRepsAft[l][a].end();
             for (iterI = iterIBegin; iterI != iterIEnd; iterI++)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             
             if (a < b)
@@ -529,21 +476,13 @@ size_t HINT_M_SubsSortSopt_CM::executeBottomUp_gOverlaps(RangeQuery Q)
                     iterIEnd = this->pOrgsInIds[l][j].end();
                     for (iterI = iterIBegin; iterI != iterIEnd; iterI++)
                     {
-#ifdef WORKLOAD_COUNT
-                        result++;
-#else
-                        result ^= (*iterI);
-#endif
+                        result.add(*iterI);
                     }
                     iterIBegin = this->pOrgsAftIds[l][j].begin();
                     iterIEnd = this->pOrgsAftIds[l][j].end();
                     for (iterI = iterIBegin; iterI != iterIEnd; iterI++)
                     {
-#ifdef WORKLOAD_COUNT
-                        result++;
-#else
-                        result ^= (*iterI);
-#endif
+                        result.add(*iterI);
                     }
                 }
                 
@@ -552,21 +491,13 @@ size_t HINT_M_SubsSortSopt_CM::executeBottomUp_gOverlaps(RangeQuery Q)
                 iterEnd = lower_bound(iterBegin, this->pOrgsInTimestamps[l][b].end(), qdummyE, CompareTimestampPairsByStart);
                 for (iter = iterBegin; iter != iterEnd; iter++)
                 {
-#ifdef WORKLOAD_COUNT
-                    result++;
-#else
-                    result ^= this->pOrgsInIds[l][b][iter-iterBegin];
-#endif
+                    result.add(this->pOrgsInIds[l][b][iter-iterBegin]);
                 }
                 iterSBegin = this->pOrgsAftTimestamp[l][b].begin();
                 iterSEnd = lower_bound(iterSBegin, this->pOrgsAftTimestamp[l][b].end(), qdummySE);
                 for (iterS = iterSBegin; iterS != iterSEnd; iterS++)
                 {
-#ifdef WORKLOAD_COUNT
-                    result++;
-#else
-                    result ^= this->pOrgsAftIds[l][b][iterS-iterSBegin];
-#endif
+                    result.add(this->pOrgsAftIds[l][b][iterS-iterSBegin]);
                 }
             }
             
@@ -587,11 +518,7 @@ size_t HINT_M_SubsSortSopt_CM::executeBottomUp_gOverlaps(RangeQuery Q)
         iterIEnd = this->pOrgsInIds[this->numBits][0].end();
         for (iterI = iterIBegin; iterI != iterIEnd; iterI++)
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
+            result.add(*iterI);
         }
     }
     else
@@ -599,19 +526,25 @@ size_t HINT_M_SubsSortSopt_CM::executeBottomUp_gOverlaps(RangeQuery Q)
         // Comparisons needed
         iterBegin = this->pOrgsInTimestamps[this->numBits][0].begin();
         iterEnd = lower_bound(iterBegin, this->pOrgsInTimestamps[this->numBits][0].end(), qdummyE, CompareTimestampPairsByStart);
-        for (iter = iterBegin; iter != iterEnd; iter++)
-        {
-            if (Q.start <= iter->second)
-            {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= this->pOrgsInIds[this->numBits][0][iter-iterBegin];
-#endif
-            }
-        }
+        scanPairs(this->kernel, this->pOrgsInTimestamps[this->numBits][0].data(), this->pOrgsInIds[this->numBits][0].data(), iterEnd-iterBegin, tmin, tmax, Q.start, tmax, result);
     }
     
+}
+
+
+size_t HINT_M_SubsSortSopt_CM::executeBottomUp_gOverlaps(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_gOverlaps(Q, result);
     
-    return result;
+    return result.get();
 }
+
+
+
+// Explicit instantiations for every result sink
+#define INSTANTIATE_HINT_M_SUBSSORTSOPT_CM(Sink) \
+    template void HINT_M_SubsSortSopt_CM::executeBottomUp_gOverlaps(RangeQuery, Sink&);
+
+FOR_EACH_SINK(INSTANTIATE_HINT_M_SUBSSORTSOPT_CM)
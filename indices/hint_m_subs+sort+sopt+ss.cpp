@@ -279,7 +279,7 @@ HINT_M_SubsSortSopt_SS::HINT_M_SubsSortSopt_SS(const Relation &R, const unsigned
                 {
                     iterSEOStart = this->pOrgsIn_ioffsets[l+1].begin();
                     iterSEOEnd = this->pOrgsIn_ioffsets[l+1].end();
-                    iterSEO = lower_bound(iterSEOStart, iterSEOEnd, dummySE);
+                    iterSEO = iterSEOStart+this->pOrgsIn_ioffsets[l+1].rank(dummySE.tstamp);
                     tmp = (iterSEO != iterSEOEnd)? (iterSEO-iterSEOStart): -1;
                 }
                 this->pOrgsIn_ioffsets[l].push_back(OffsetEntry_SS<Relation>(pId, this->pOrgsIn[l].begin()+sumOin, tmp));
@@ -295,7 +295,7 @@ HINT_M_SubsSortSopt_SS::HINT_M_SubsSortSopt_SS(const Relation &R, const unsigned
                 {
                     iterSOStart = this->pOrgsAft_ioffsets[l+1].begin();
                     iterSOEnd = this->pOrgsAft_ioffsets[l+1].end();
-                    iterSO = lower_bound(iterSOStart, iterSOEnd, dummyS);//, CompareStartOffesetsByTimestamp);
+                    iterSO = iterSOStart+this->pOrgsAft_ioffsets[l+1].rank(dummyS.tstamp);
                     tmp = (iterSO != iterSOEnd)? (iterSO-iterSOStart): -1;
                 }
                 this->pOrgsAft_ioffsets[l].push_back(OffsetEntry_SS<RelationStart>(pId, this->pOrgsAft[l].begin()+sumOaft, tmp));
@@ -311,7 +311,7 @@ HINT_M_SubsSortSopt_SS::HINT_M_SubsSortSopt_SS(const Relation &R, const unsigned
                 {
                     iterEOStart = this->pRepsIn_ioffsets[l+1].begin();
                     iterEOEnd = this->pRepsIn_ioffsets[l+1].end();
-                    iterEO = lower_bound(iterEOStart, iterEOEnd, dummyE);//, CompareEndOffesetsByTimestamp);
+                    iterEO = iterEOStart+this->pRepsIn_ioffsets[l+1].rank(dummyE.tstamp);
                     tmp = (iterEO != iterEOEnd)? (iterEO-iterEOStart): -1;
                 }
                 this->pRepsIn_ioffsets[l].push_back(OffsetEntry_SS<RelationEnd>(pId, this->pRepsIn[l].begin()+sumRin, tmp));
@@ -327,7 +327,7 @@ HINT_M_SubsSortSopt_SS::HINT_M_SubsSortSopt_SS(const Relation &R, const unsigned
                 {
                     iterIOStart = this->pRepsAft_ioffsets[l+1].begin();
                     iterIOEnd = this->pRepsAft_ioffsets[l+1].end();
-                    iterIO = lower_bound(iterIOStart, iterIOEnd, dummyI);//, CompareIdOffesetsByTimestamp);
+                    iterIO = iterIOStart+this->pRepsAft_ioffsets[l+1].rank(dummyI.tstamp);
                     tmp = (iterIO != iterIOEnd)? (iterIO-iterIOStart): -1;
                 }
                 this->pRepsAft_ioffsets[l].push_back(OffsetEntry_SS<RelationId>(pId, this->pRepsAft[l].begin()+sumRaft, tmp));
@@ -350,6 +350,11 @@ HINT_M_SubsSortSopt_SS::HINT_M_SubsSortSopt_SS(const Relation &R, const unsigned
         this->pOrgsAft_offsets[l][cnt] = sumOaft;
         this->pRepsIn_offsets[l][cnt]  = sumRin;
         this->pRepsAft_offsets[l][cnt] = sumRaft;
+        
+        this->pOrgsIn_ioffsets[l].buildDirectory(cnt);
+        this->pOrgsAft_ioffsets[l].buildDirectory(cnt);
+        this->pRepsIn_ioffsets[l].buildDirectory(cnt);
+        this->pRepsAft_ioffsets[l].buildDirectory(cnt);
     }
 
 
@@ -367,16 +372,18 @@ HINT_M_SubsSortSopt_SS::HINT_M_SubsSortSopt_SS(const Relation &R, const unsigned
     free(this->pRepsAft_sizes);
 
 
-    // Step 4: sort partition contents.
+    // Step 4: sort partition contents; large partitions are radix sorted on
+    // the bits of their timestamps below those of the partition, see
+    // containers/radixsort.h.
     for (auto l = 0; l < this->height; l++)
     {
         auto cnt = (int)(pow(2, this->numBits-l));
-        for (auto pId = 0; pId < cnt; pId++)
-        {
-            sort(this->pOrgsIn[l].begin()+this->pOrgsIn_offsets[l][pId], this->pOrgsIn[l].begin()+this->pOrgsIn_offsets[l][pId+1]);
-            sort(this->pOrgsAft[l].begin()+this->pOrgsAft_offsets[l][pId], this->pOrgsAft[l].begin()+this->pOrgsAft_offsets[l][pId+1]);
-            sort(this->pRepsIn[l].begin()+this->pRepsIn_offsets[l][pId], this->pRepsIn[l].begin()+this->pRepsIn_offsets[l][pId+1]);
-        }
+        unsigned int bits = this->maxBits-this->numBits+l;
+        uint64_t mask = (((uint64_t)1) << bits)-1;
+        
+        sortPartitions(this->pOrgsIn[l].data(), this->pOrgsIn_offsets[l], 0, cnt, 2*bits, [&](const Record &r) {return (((r.start & mask) << bits) | (r.end & mask));});
+        sortPartitions(this->pOrgsAft[l].data(), this->pOrgsAft_offsets[l], 0, cnt, bits, [&](const RecordStart &r) {return (r.start & mask);});
+        sortPartitions(this->pRepsIn[l].data(), this->pRepsIn_offsets[l], 0, cnt, bits, [&](const RecordEnd &r) {return (r.end & mask);});
     }
 
 
@@ -440,12 +447,12 @@ inline bool HINT_M_SubsSortSopt_SS::getBounds_OrgsIn(unsigned int level, Timesta
     if (cnt > 0)
     {
         // Do binary search or follow vertical pointers.
-        if ((from == -1) || (from > cnt))
+        if ((from == -1) || (from >= cnt))
         {
             qdummy.tstamp = t;
             iterIOStart = this->pOrgsIn_ioffsets[level].begin();
             iterIOEnd = this->pOrgsIn_ioffsets[level].end();
-            iterIO = lower_bound(iterIOStart, iterIOEnd, qdummy);
+            iterIO = iterIOStart+this->pOrgsIn_ioffsets[level].rank(qdummy.tstamp);
             if ((iterIO != iterIOEnd) && (iterIO->tstamp == t))
             {
                 iterBegin = iterIO->iter;
@@ -461,14 +468,14 @@ inline bool HINT_M_SubsSortSopt_SS::getBounds_OrgsIn(unsigned int level, Timesta
             Timestamp tmp = (this->pOrgsIn_ioffsets[level][from]).tstamp;
             if (tmp < t)
             {
-                while (((this->pOrgsIn_ioffsets[level][from]).tstamp < t) && (from < cnt))
+                while ((from < cnt) && ((this->pOrgsIn_ioffsets[level][from]).tstamp < t))
                     from++;
             }
             else if (tmp > t)
             {
-                while (((this->pOrgsIn_ioffsets[level][from]).tstamp > t) && (from > -1))
+                while ((from > -1) && ((this->pOrgsIn_ioffsets[level][from]).tstamp > t))
                     from--;
-                if (((this->pOrgsIn_ioffsets[level][from]).tstamp != t) || (from == -1))
+                if ((from == -1) || ((this->pOrgsIn_ioffsets[level][from]).tstamp != t))
                     from++;
             }
 
@@ -512,12 +519,12 @@ inline bool HINT_M_SubsSortSopt_SS::getBounds_OrgsIn(unsigned int level, Timesta
         to = next_to;
 
         // Do binary search or follow vertical pointers.
-        if ((from == -1) || (to == -1))
+        if ((from == -1) || (from >= cnt) || (to == -1))
         {
             qdummyA.tstamp = a;
             iterIOStart = this->pOrgsIn_ioffsets[level].begin();
             iterIOEnd = this->pOrgsIn_ioffsets[level].end();
-            iterIO = lower_bound(iterIOStart, iterIOEnd, qdummyA);
+            iterIO = iterIOStart+this->pOrgsIn_ioffsets[level].rank(qdummyA.tstamp);
             if ((iterIO != iterIOEnd) && (iterIO->tstamp <= b))
             {
                 next_from = iterIO->pid;
@@ -525,7 +532,7 @@ inline bool HINT_M_SubsSortSopt_SS::getBounds_OrgsIn(unsigned int level, Timesta
                 qdummyB.tstamp = b;
                 iterBegin = iterIO->iter;
 
-                iterIO2 = upper_bound(iterIO, iterIOEnd, qdummyB);
+                iterIO2 = iterIOStart+this->pOrgsIn_ioffsets[level].rank(qdummyB.tstamp+1);
 //                iterIO2 = iterIO;
 //                while ((iterIO2 != iterIOEnd) && (get<0>(*iterIO2) <= b))
 //                    iterIO2++;
@@ -551,27 +558,27 @@ inline bool HINT_M_SubsSortSopt_SS::getBounds_OrgsIn(unsigned int level, Timesta
             Timestamp tmp = (this->pOrgsIn_ioffsets[level][from]).tstamp;
             if (tmp < a)
             {
-                while (((this->pOrgsIn_ioffsets[level][from]).tstamp < a) && (from < cnt))
+                while ((from < cnt) && ((this->pOrgsIn_ioffsets[level][from]).tstamp < a))
                     from++;
             }
             else if (tmp > a)
             {
-                while (((this->pOrgsIn_ioffsets[level][from]).tstamp > a) && (from > -1))
+                while ((from > -1) && ((this->pOrgsIn_ioffsets[level][from]).tstamp > a))
                     from--;
-                if (((this->pOrgsIn_ioffsets[level][from]).tstamp != a) || (from == -1))
+                if ((from == -1) || ((this->pOrgsIn_ioffsets[level][from]).tstamp != a))
                     from++;
             }
 
             tmp = (this->pOrgsIn_ioffsets[level][to]).tstamp;
             if (tmp > b)
             {
-                while (((this->pOrgsIn_ioffsets[level][to]).tstamp > b) && (to > -1))
+                while ((to > -1) && ((this->pOrgsIn_ioffsets[level][to]).tstamp > b))
                     to--;
                 to++;
             }
             else if (tmp == b)
             {
-                while (((this->pOrgsIn_ioffsets[level][to]).tstamp <= b) && (to < cnt))
+                while ((to < cnt) && ((this->pOrgsIn_ioffsets[level][to]).tstamp <= b))
                     to++;
             }
 
@@ -614,12 +621,12 @@ inline bool HINT_M_SubsSortSopt_SS::getBounds_OrgsAft(unsigned int level, Timest
     if (cnt > 0)
     {
         // Do binary search or follow vertical pointers.
-        if ((from == -1) || (from > cnt))
+        if ((from == -1) || (from >= cnt))
         {
             qdummy.tstamp = t;
             iterIOStart = this->pOrgsAft_ioffsets[level].begin();
             iterIOEnd = this->pOrgsAft_ioffsets[level].end();
-            iterIO = lower_bound(iterIOStart, iterIOEnd, qdummy);//, CompareStartOffesetsByTimestamp);
+            iterIO = iterIOStart+this->pOrgsAft_ioffsets[level].rank(qdummy.tstamp);
             if ((iterIO != iterIOEnd) && (iterIO->tstamp == t))
             {
                 iterBegin = iterIO->iter;
@@ -635,14 +642,14 @@ inline bool HINT_M_SubsSortSopt_SS::getBounds_OrgsAft(unsigned int level, Timest
             Timestamp tmp = (this->pOrgsAft_ioffsets[level][from]).tstamp;
             if (tmp < t)
             {
-                while (((this->pOrgsAft_ioffsets[level][from]).tstamp < t) && (from < cnt))
+                while ((from < cnt) && ((this->pOrgsAft_ioffsets[level][from]).tstamp < t))
                     from++;
             }
             else if (tmp > t)
             {
-                while (((this->pOrgsAft_ioffsets[level][from]).tstamp > t) && (from > -1))
+                while ((from > -1) && ((this->pOrgsAft_ioffsets[level][from]).tstamp > t))
                     from--;
-                if (((this->pOrgsAft_ioffsets[level][from]).tstamp != t) || (from == -1))
+                if ((from == -1) || ((this->pOrgsAft_ioffsets[level][from]).tstamp != t))
                     from++;
             }
 
@@ -683,12 +690,12 @@ inline bool HINT_M_SubsSortSopt_SS::getBounds_OrgsAft(unsigned int level, Timest
     if (cnt > 0)
     {
         // Do binary search or follow vertical pointers.
-        if ((from == -1) || (to == -1))
+        if ((from == -1) || (from >= cnt) || (to == -1))
         {
             qdummyA.tstamp = a;
             iterIOStart = this->pOrgsAft_ioffsets[level].begin();
             iterIOEnd = this->pOrgsAft_ioffsets[level].end();
-            iterIO = lower_bound(iterIOStart, iterIOEnd, qdummyA);//, CompareStartOffesetsByTimestamp);
+            iterIO = iterIOStart+this->pOrgsAft_ioffsets[level].rank(qdummyA.tstamp);
             if ((iterIO != iterIOEnd) && (iterIO->tstamp <= b))
             {
                 next_from = iterIO->pid;
@@ -696,7 +703,7 @@ inline bool HINT_M_SubsSortSopt_SS::getBounds_OrgsAft(unsigned int level, Timest
                 qdummyB.tstamp = b;
                 iterBegin = iterIO->iter;
 
-                iterIO2 = upper_bound(iterIO, iterIOEnd, qdummyB);//, CompareStartOffesetsByTimestamp);
+                iterIO2 = iterIOStart+this->pOrgsAft_ioffsets[level].rank(qdummyB.tstamp+1);
 //                iterIO2 = iterIO;
 //                while ((iterIO2 != iterIOEnd) && (get<0>(*iterIO2) <= b))
 //                    iterIO2++;
@@ -722,27 +729,27 @@ inline bool HINT_M_SubsSortSopt_SS::getBounds_OrgsAft(unsigned int level, Timest
             Timestamp tmp = (this->pOrgsAft_ioffsets[level][from]).tstamp;
             if (tmp < a)
             {
-                while (((this->pOrgsAft_ioffsets[level][from]).tstamp < a) && (from < cnt))
+                while ((from < cnt) && ((this->pOrgsAft_ioffsets[level][from]).tstamp < a))
                     from++;
             }
             else if (tmp > a)
             {
-                while (((this->pOrgsAft_ioffsets[level][from]).tstamp > a) && (from > -1))
+                while ((from > -1) && ((this->pOrgsAft_ioffsets[level][from]).tstamp > a))
                     from--;
-                if (((this->pOrgsAft_ioffsets[level][from]).tstamp != a) || (from == -1))
+                if ((from == -1) || ((this->pOrgsAft_ioffsets[level][from]).tstamp != a))
                     from++;
             }
 
             tmp = (this->pOrgsAft_ioffsets[level][to]).tstamp;
             if (tmp > b)
             {
-                while (((this->pOrgsAft_ioffsets[level][to]).tstamp > b) && (to > -1))
+                while ((to > -1) && ((this->pOrgsAft_ioffsets[level][to]).tstamp > b))
                     to--;
                 to++;
             }
             else if (tmp == b)
             {
-                while (((this->pOrgsAft_ioffsets[level][to]).tstamp <= b) && (to < cnt))
+                while ((to < cnt) && ((this->pOrgsAft_ioffsets[level][to]).tstamp <= b))
                     to++;
             }
 
@@ -785,12 +792,12 @@ inline bool HINT_M_SubsSortSopt_SS::getBounds_RepsIn(unsigned int level, Timesta
     if (cnt > 0)
     {
         // Do binary search or follow vertical pointers.
-        if ((from == -1) || (from > cnt))
+        if ((from == -1) || (from >= cnt))
         {
             qdummy.tstamp = t;
             iterIOStart = this->pRepsIn_ioffsets[level].begin();
             iterIOEnd = this->pRepsIn_ioffsets[level].end();
-            iterIO = lower_bound(iterIOStart, iterIOEnd, qdummy);//, CompareEndOffesetsByTimestamp);
+            iterIO = iterIOStart+this->pRepsIn_ioffsets[level].rank(qdummy.tstamp);
             if ((iterIO != iterIOEnd) && (iterIO->tstamp == t))
             {
                 iterBegin = iterIO->iter;
@@ -806,14 +813,14 @@ inline bool HINT_M_SubsSortSopt_SS::getBounds_RepsIn(unsigned int level, Timesta
             Timestamp tmp = (this->pRepsIn_ioffsets[level][from]).tstamp;
             if (tmp < t)
             {
-                while (((this->pRepsIn_ioffsets[level][from]).tstamp < t) && (from < cnt))
+                while ((from < cnt) && ((this->pRepsIn_ioffsets[level][from]).tstamp < t))
                     from++;
             }
             else if (tmp > t)
             {
-                while (((this->pRepsIn_ioffsets[level][from]).tstamp > t) && (from > -1))
+                while ((from > -1) && ((this->pRepsIn_ioffsets[level][from]).tstamp > t))
                     from--;
-                if (((this->pRepsIn_ioffsets[level][from]).tstamp != t) || (from == -1))
+                if ((from == -1) || ((this->pRepsIn_ioffsets[level][from]).tstamp != t))
                     from++;
             }
 
@@ -855,12 +862,12 @@ inline bool HINT_M_SubsSortSopt_SS::getBounds_RepsAft(unsigned int level, Timest
     if (cnt > 0)
     {
         // Do binary search or follow vertical pointers.
-        if ((from == -1) || (from > cnt))
+        if ((from == -1) || (from >= cnt))
         {
             qdummy.tstamp = t;
             iterIOStart = this->pRepsAft_ioffsets[level].begin();
             iterIOEnd = this->pRepsAft_ioffsets[level].end();
-            iterIO = lower_bound(iterIOStart, iterIOEnd, qdummy);//, CompareIdOffesetsByTimestamp);
+            iterIO = iterIOStart+this->pRepsAft_ioffsets[level].rank(qdummy.tstamp);
             if ((iterIO != iterIOEnd) && (iterIO->tstamp == t))
             {
                 iterBegin = iterIO->iter;
@@ -876,14 +883,14 @@ inline bool HINT_M_SubsSortSopt_SS::getBounds_RepsAft(unsigned int level, Timest
             Timestamp tmp = (this->pRepsAft_ioffsets[level][from]).tstamp;
             if (tmp < t)
             {
-                while (((this->pRepsAft_ioffsets[level][from]).tstamp < t) && (from < cnt))
+                while ((from < cnt) && ((this->pRepsAft_ioffsets[level][from]).tstamp < t))
                     from++;
             }
             else if (tmp > t)
             {
-                while (((this->pRepsAft_ioffsets[level][from]).tstamp > t) && (from > -1))
+                while ((from > -1) && ((this->pRepsAft_ioffsets[level][from]).tstamp > t))
                     from--;
-                if (((this->pRepsAft_ioffsets[level][from]).tstamp != t) || (from == -1))
+                if ((from == -1) || ((this->pRepsAft_ioffsets[level][from]).tstamp != t))
                     from++;
             }
 
@@ -914,7 +921,8 @@ inline bool HINT_M_SubsSortSopt_SS::getBounds_RepsAft(unsigned int level, Timest
 
 
 // Auxiliary functions to scan a partition.
-inline void HINT_M_SubsSortSopt_SS::scanFirstPartition_OrgsIn_gOverlaps(unsigned int level, Timestamp a, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSortSopt_SS::scanFirstPartition_OrgsIn_gOverlaps(unsigned int level, Timestamp a, PartitionId &next_from, Sink &result)
 {
     RelationIterator iter, iterBegin, iterEnd;
 
@@ -923,62 +931,43 @@ inline void HINT_M_SubsSortSopt_SS::scanFirstPartition_OrgsIn_gOverlaps(unsigned
     {
         for (iter = iterBegin; iter != iterEnd; iter++)
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= iter->id;
-#endif
+            result.add(iter->id);
         }
     }
 }
 
 
-inline void HINT_M_SubsSortSopt_SS::scanFirstPartition_OrgsIn_gOverlaps(unsigned int level, Timestamp a, Timestamp qstart, Record qdummyE, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSortSopt_SS::scanFirstPartition_OrgsIn_gOverlaps(unsigned int level, Timestamp a, Timestamp qstart, Record qdummyE, PartitionId &next_from, Sink &result)
 {
-    RelationIterator iter, iterBegin, iterEnd;
+    RelationIterator iterBegin, iterEnd;
+    const Timestamp tmin = numeric_limits<Timestamp>::min(), tmax = numeric_limits<Timestamp>::max();
 
 
     if (this->getBounds_OrgsIn(level, a, next_from, iterBegin, iterEnd))
     {
         RelationIterator pivot = lower_bound(iterBegin, iterEnd, qdummyE);
-        for (iter = iterBegin; iter != pivot; iter++)
-        {
-            if (qstart <= iter->end)
-            {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= iter->id;
-#endif
-            }
-        }
+        scanRecords(this->kernel, &(*iterBegin), pivot-iterBegin, tmin, tmax, qstart, tmax, result);
     }
 }
 
 
-inline void HINT_M_SubsSortSopt_SS::scanFirstPartition_OrgsIn_gOverlaps(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSortSopt_SS::scanFirstPartition_OrgsIn_gOverlaps(unsigned int level, Timestamp a, Timestamp qstart, PartitionId &next_from, Sink &result)
 {
-    RelationIterator iter, iterBegin, iterEnd;
+    RelationIterator iterBegin, iterEnd;
+    const Timestamp tmin = numeric_limits<Timestamp>::min(), tmax = numeric_limits<Timestamp>::max();
 
     
     if (this->getBounds_OrgsIn(level, a, next_from, iterBegin, iterEnd))
     {
-        for (iter = iterBegin; iter != iterEnd; iter++)
-        {
-            if (qstart <= iter->end)
-            {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= iter->id;
-#endif
-            }
-        }
+        scanRecords(this->kernel, &(*iterBegin), iterEnd-iterBegin, tmin, tmax, qstart, tmax, result);
     }
 }
 
 
-inline void HINT_M_SubsSortSopt_SS::scanFirstPartition_OrgsAft_gOverlaps(unsigned int level, Timestamp a, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSortSopt_SS::scanFirstPartition_OrgsAft_gOverlaps(unsigned int level, Timestamp a, PartitionId &next_from, Sink &result)
 {
     RelationStartIterator iter, iterBegin, iterEnd;
 
@@ -987,17 +976,14 @@ inline void HINT_M_SubsSortSopt_SS::scanFirstPartition_OrgsAft_gOverlaps(unsigne
     {
         for (iter = iterBegin; iter != iterEnd; iter++)
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= iter->id;
-#endif
+            result.add(iter->id);
         }
     }
 }
 
 
-inline void HINT_M_SubsSortSopt_SS::scanFirstPartition_RepsIn_gOverlaps(unsigned int level, Timestamp a, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSortSopt_SS::scanFirstPartition_RepsIn_gOverlaps(unsigned int level, Timestamp a, PartitionId &next_from, Sink &result)
 {
     RelationEndIterator iter, iterBegin, iterEnd;
 
@@ -1006,17 +992,14 @@ inline void HINT_M_SubsSortSopt_SS::scanFirstPartition_RepsIn_gOverlaps(unsigned
     {
         for (iter = iterBegin; iter != iterEnd; iter++)
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= iter->id;
-#endif
+            result.add(iter->id);
         }
     }
 }
 
 
-inline void HINT_M_SubsSortSopt_SS::scanFirstPartition_RepsIn_gOverlaps(unsigned int level, Timestamp a, RecordEnd qdummyS, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSortSopt_SS::scanFirstPartition_RepsIn_gOverlaps(unsigned int level, Timestamp a, RecordEnd qdummyS, PartitionId &next_from, Sink &result)
 {
     RelationEndIterator iter, iterBegin, iterEnd;
 
@@ -1026,17 +1009,14 @@ inline void HINT_M_SubsSortSopt_SS::scanFirstPartition_RepsIn_gOverlaps(unsigned
         RelationEndIterator pivot = lower_bound(iterBegin, iterEnd, qdummyS);
         for (iter = pivot; iter != iterEnd; iter++)
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= iter->id;
-#endif
+            result.add(iter->id);
         }
     }
 }
 
 
-inline void HINT_M_SubsSortSopt_SS::scanFirstPartition_RepsAft_gOverlaps(unsigned int level, Timestamp a, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSortSopt_SS::scanFirstPartition_RepsAft_gOverlaps(unsigned int level, Timestamp a, PartitionId &next_from, Sink &result)
 {
     RelationIdIterator iter, iterBegin, iterEnd;
 
@@ -1045,17 +1025,14 @@ inline void HINT_M_SubsSortSopt_SS::scanFirstPartition_RepsAft_gOverlaps(unsigne
     {
         for (iter = iterBegin; iter != iterEnd; iter++)
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iter);
-#endif
+            result.add(*iter);
         }
     }
 }
 
 
-inline void HINT_M_SubsSortSopt_SS::scanLastPartition_OrgsIn_gOverlaps(unsigned int level, Timestamp b, Record qdummyE, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSortSopt_SS::scanLastPartition_OrgsIn_gOverlaps(unsigned int level, Timestamp b, Record qdummyE, PartitionId &next_from, Sink &result)
 {
     RelationIterator iter, iterBegin, iterEnd;
 
@@ -1065,17 +1042,14 @@ inline void HINT_M_SubsSortSopt_SS::scanLastPartition_OrgsIn_gOverlaps(unsigned
         RelationIterator pivot = lower_bound(iterBegin, iterEnd, qdummyE);
         for (iter = iterBegin; iter != pivot; iter++)
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= iter->id;
-#endif
+            result.add(iter->id);
         }
     }
 }
 
 
-inline void HINT_M_SubsSortSopt_SS::scanLastPartition_OrgsAft_gOverlaps(unsigned int level, Timestamp b, RecordStart qdummySE, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSortSopt_SS::scanLastPartition_OrgsAft_gOverlaps(unsigned int level, Timestamp b, RecordStart qdummySE, PartitionId &next_from, Sink &result)
 {
     RelationStartIterator iter, iterBegin, iterEnd;
 
@@ -1085,17 +1059,14 @@ inline void HINT_M_SubsSortSopt_SS::scanLastPartition_OrgsAft_gOverlaps(unsigned
         RelationStartIterator pivot = lower_bound(iterBegin, iterEnd, qdummySE);
         for (iter = iterBegin; iter != pivot; iter++)
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= iter->id;
-#endif
+            result.add(iter->id);
         }
     }
 }
 
 
-inline void HINT_M_SubsSortSopt_SS::scanPartitions_OrgsIn_gOverlaps(unsigned int level, Timestamp a, Timestamp b, PartitionId &next_from, PartitionId &next_to, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSortSopt_SS::scanPartitions_OrgsIn_gOverlaps(unsigned int level, Timestamp a, Timestamp b, PartitionId &next_from, PartitionId &next_to, Sink &result)
 {
     RelationIterator iter, iterBegin, iterEnd;
 
@@ -1104,17 +1075,14 @@ inline void HINT_M_SubsSortSopt_SS::scanPartitions_OrgsIn_gOverlaps(unsigned int
     {
         for (iter = iterBegin; iter != iterEnd; iter++)
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= iter->id;
-#endif
+            result.add(iter->id);
         }
     }
 }
 
 
-inline void HINT_M_SubsSortSopt_SS::scanPartitions_OrgsAft_gOverlaps(unsigned int level, Timestamp a, Timestamp b, PartitionId &next_from, PartitionId &next_to, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSortSopt_SS::scanPartitions_OrgsAft_gOverlaps(unsigned int level, Timestamp a, Timestamp b, PartitionId &next_from, PartitionId &next_to, Sink &result)
 {
     RelationStartIterator iter, iterBegin, iterEnd;
 
@@ -1123,20 +1091,16 @@ inline void HINT_M_SubsSortSopt_SS::scanPartitions_OrgsAft_gOverlaps(unsigned in
     {
         for (iter = iterBegin; iter != iterEnd; iter++)
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= iter->id;
-#endif
+            result.add(iter->id);
         }
     }
 }
 
 
 // Generalized predicates, ACM SIGMOD'22 gOverlaps
-size_t HINT_M_SubsSortSopt_SS::executeBottomUp_gOverlaps(RangeQuery Q)
+template <class Sink>
+void HINT_M_SubsSortSopt_SS::executeBottomUp_gOverlaps(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
     Relation::iterator iterBegin;
     RelationIterator iter, iterEnd;
     Timestamp a = Q.start >> (this->maxBits-this->numBits); // prefix
@@ -1146,6 +1110,7 @@ size_t HINT_M_SubsSortSopt_SS::executeBottomUp_gOverlaps(RangeQuery Q)
     RecordEnd qdummyS(0, Q.start);
     bool foundzero = false;
     bool foundone = false;
+    const Timestamp tmin = numeric_limits<Timestamp>::min(), tmax = numeric_limits<Timestamp>::max();
     PartitionId next_fromOinA = -1, next_fromOaftA = -1, next_fromRinA = -1, next_fromRaftA = -1, next_fromOinB = -1, next_fromOaftB = -1, next_fromOinAB = -1, next_toOinAB = -1, next_fromOaftAB = -1, next_toOaftAB = -1;
 
 
@@ -1213,11 +1178,7 @@ size_t HINT_M_SubsSortSopt_SS::executeBottomUp_gOverlaps(RangeQuery Q)
         iterEnd = this->pOrgsIn[this->numBits].end();
         for (iter = iterBegin; iter != iterEnd; iter++)
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= iter->id;
-#endif
+            result.add(iter->id);
         }
     }
     else
@@ -1225,19 +1186,24 @@ size_t HINT_M_SubsSortSopt_SS::executeBottomUp_gOverlaps(RangeQuery Q)
         // Comparisons needed
         iterBegin = this->pOrgsIn[this->numBits].begin();
         iterEnd = lower_bound(iterBegin, this->pOrgsIn[this->numBits].end(), qdummyE);
-        for (iter = iterBegin; iter != iterEnd; iter++)
-        {
-            if (Q.start <= iter->end)
-            {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= iter->id;
-#endif
-            }
-        }
+        scanRecords(this->kernel, this->pOrgsIn[this->numBits].data(), iterEnd-iterBegin, tmin, tmax, Q.start, tmax, result);
     }
+}
 
 
-    return result;
+size_t HINT_M_SubsSortSopt_SS::executeBottomUp_gOverlaps(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_gOverlaps(Q, result);
+    
+    return result.get();
 }
+
+
+
+// Explicit instantiations for every result sink
+#define INSTANTIATE_HINT_M_SUBSSORTSOPT_SS(Sink) \
+    template void HINT_M_SubsSortSopt_SS::executeBottomUp_gOverlaps(RangeQuery, Sink&);
+
+FOR_EACH_SINK(INSTANTIATE_HINT_M_SUBSSORTSOPT_SS)
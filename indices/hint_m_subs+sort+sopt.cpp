@@ -338,9 +338,9 @@ HINT_M_SubsSortSopt::~HINT_M_SubsSortSopt()
 
 
 // Generalized predicates, ACM SIGMOD'22 gOverlaps
-size_t HINT_M_SubsSortSopt::executeBottomUp_gOverlaps(RangeQuery Q)
+template <class Sink>
+void HINT_M_SubsSortSopt::executeBottomUp_gOverlaps(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
     Relation::iterator iterBegin;
     RelationIterator iter, iterEnd;
     RelationStart::iterator iterS, iterSBegin, iterSEnd;
@@ -353,6 +353,7 @@ size_t HINT_M_SubsSortSopt::executeBottomUp_gOverlaps(RangeQuery Q)
     RecordEnd qdummyS(0, Q.start);
     bool foundzero = false;
     bool foundone = false;
+    const Timestamp tmin = numeric_limits<Timestamp>::min(), tmax = numeric_limits<Timestamp>::max();
     
     
     for (auto l = 0; l < this->numBits; l++)
@@ -367,21 +368,13 @@ size_t HINT_M_SubsSortSopt::executeBottomUp_gOverlaps(RangeQuery Q)
             iterEEnd = this->pRepsIn[l][a].end();
             for (iterE = iterEBegin; iterE != iterEEnd; iterE++)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= iterE->id;
-#endif
+                result.add(iterE->id);
             }
             iterIBegin =this->pRepsAft[l][a].begin();
             iterIEnd = this->pRepsAft[l][a].end();
             for (iterI = iterIBegin; iterI != iterIEnd; iterI++)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             
             // Handle rest: consider only originals
@@ -391,21 +384,13 @@ size_t HINT_M_SubsSortSopt::executeBottomUp_gOverlaps(RangeQuery Q)
                 iterEnd = this->pOrgsIn[l][j].end();
                 for (iter = iterBegin; iter != iterEnd; iter++)
                 {
-#ifdef WORKLOAD_COUNT
-                    result++;
-#else
-                    result ^= iter->id;
-#endif
+                    result.add(iter->id);
                 }
                 iterSBegin = this->pOrgsAft[l][j].begin();
                 iterSEnd = this->pOrgsAft[l][j].end();
                 for (iterS = iterSBegin; iterS != iterSEnd; iterS++)
                 {
-#ifdef WORKLOAD_COUNT
-                    result++;
-#else
-                    result ^= iterS->id;
-#endif
+                    result.add(iterS->id);
                 }
             }
         }
@@ -419,53 +404,23 @@ size_t HINT_M_SubsSortSopt::executeBottomUp_gOverlaps(RangeQuery Q)
                 // Special case when query overlaps only one partition, Lemma 3
                 iterBegin = this->pOrgsIn[l][a].begin();
                 iterEnd = lower_bound(iterBegin, this->pOrgsIn[l][a].end(), qdummyE);
-                for (iter = iterBegin; iter != iterEnd; iter++)
-                {
-                    if (Q.start <= iter->end)
-                    {
-#ifdef WORKLOAD_COUNT
-                        result++;
-#else
-                        result ^= iter->id;
-#endif
-                    }
-                }
+                scanRecords(this->kernel, this->pOrgsIn[l][a].data(), iterEnd-iterBegin, tmin, tmax, Q.start, tmax, result);
                 iterSBegin = this->pOrgsAft[l][a].begin();
                 iterSEnd = lower_bound(iterSBegin, this->pOrgsAft[l][a].end(), qdummySE);
                 for (iterS = iterSBegin; iterS != iterSEnd; iterS++)
                 {
-#ifdef WORKLOAD_COUNT
-                    result++;
-#else
-                    result ^= iterS->id;
-#endif
+                    result.add(iterS->id);
                 }
             }
             else
             {
                 // Lemma 1
-                iterBegin = this->pOrgsIn[l][a].begin();
-                iterEnd = this->pOrgsIn[l][a].end();
-                for (iter = iterBegin; iter != iterEnd; iter++)
-                {
-                    if (Q.start <= iter->end)
-                    {
-#ifdef WORKLOAD_COUNT
-                        result++;
-#else
-                        result ^= iter->id;
-#endif
-                    }
-                }
+                scanRecords(this->kernel, this->pOrgsIn[l][a], tmin, tmax, Q.start, tmax, result);
                 iterSBegin = this->pOrgsAft[l][a].begin();
                 iterSEnd = this->pOrgsAft[l][a].end();
                 for (iterS = iterSBegin; iterS != iterSEnd; iterS++)
                 {
-#ifdef WORKLOAD_COUNT
-                    result++;
-#else
-                    result ^= iterS->id;
-#endif
+                    result.add(iterS->id);
                 }
             }
             
@@ -474,21 +429,13 @@ size_t HINT_M_SubsSortSopt::executeBottomUp_gOverlaps(RangeQuery Q)
             iterEBegin = lower_bound(this->pRepsIn[l][a].begin(), iterEEnd, qdummyS);
             for (iterE = iterEBegin; iterE != iterEEnd; iterE++)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= iterE->id;
-#endif
+                result.add(iterE->id);
             }
             iterIBegin = this->pRepsAft[l][a].begin();
             iterIEnd = this->pRepsAft[l][a].end();
             for (iterI = iterIBegin; iterI != iterIEnd; iterI++)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             
             if (a < b)
@@ -500,21 +447,13 @@ size_t HINT_M_SubsSortSopt::executeBottomUp_gOverlaps(RangeQuery Q)
                     iterEnd = this->pOrgsIn[l][j].end();
                     for (iter = iterBegin; iter != iterEnd; iter++)
                     {
-#ifdef WORKLOAD_COUNT
-                        result++;
-#else
-                        result ^= iter->id;
-#endif
+                        result.add(iter->id);
                     }
                     iterSBegin = this->pOrgsAft[l][j].begin();
                     iterSEnd = this->pOrgsAft[l][j].end();
                     for (iterS = iterSBegin; iterS != iterSEnd; iterS++)
                     {
-#ifdef WORKLOAD_COUNT
-                        result++;
-#else
-                        result ^= iterS->id;
-#endif
+                        result.add(iterS->id);
                     }
                 }
                 
@@ -523,21 +462,13 @@ size_t HINT_M_SubsSortSopt::executeBottomUp_gOverlaps(RangeQuery Q)
                 iterEnd = lower_bound(iterBegin, this->pOrgsIn[l][b].end(), qdummyE);
                 for (iter = iterBegin; iter != iterEnd; iter++)
                 {
-#ifdef WORKLOAD_COUNT
-                    result++;
-#else
-                    result ^= iter->id;
-#endif
+                    result.add(iter->id);
                 }
                 iterSBegin = this->pOrgsAft[l][b].begin();
                 iterSEnd = lower_bound(iterSBegin, this->pOrgsAft[l][b].end(), qdummySE);
                 for (iterS = iterSBegin; iterS != iterSEnd; iterS++)
                 {
-#ifdef WORKLOAD_COUNT
-                    result++;
-#else
-                    result ^= iterS->id;
-#endif
+                    result.add(iterS->id);
                 }
             }
             
@@ -558,11 +489,7 @@ size_t HINT_M_SubsSortSopt::executeBottomUp_gOverlaps(RangeQuery Q)
         iterEnd = this->pOrgsIn[this->numBits][0].end();
         for (iter = iterBegin; iter != iterEnd; iter++)
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= iter->id;
-#endif
+            result.add(iter->id);
         }
     }
     else
@@ -570,19 +497,25 @@ size_t HINT_M_SubsSortSopt::executeBottomUp_gOverlaps(RangeQuery Q)
         // Comparisons needed
         iterBegin = this->pOrgsIn[this->numBits][0].begin();
         iterEnd = lower_bound(iterBegin, this->pOrgsIn[this->numBits][0].end(), qdummyE);
-        for (iter = iterBegin; iter != iterEnd; iter++)
-        {
-            if (Q.start <= iter->end)
-            {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= iter->id;
-#endif
-            }
-        }
+        scanRecords(this->kernel, this->pOrgsIn[this->numBits][0].data(), iterEnd-iterBegin, tmin, tmax, Q.start, tmax, result);
     }
     
+}
+
+
+size_t HINT_M_SubsSortSopt::executeBottomUp_gOverlaps(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_gOverlaps(Q, result);
     
-    return result;
+    return result.get();
 }
+
+
+
+// Explicit instantiations for every result sink
+#define INSTANTIATE_HINT_M_SUBSSORTSOPT(Sink) \
+    template void HINT_M_SubsSortSopt::executeBottomUp_gOverlaps(RangeQuery, Sink&);
+
+FOR_EACH_SINK(INSTANTIATE_HINT_M_SUBSSORTSOPT)
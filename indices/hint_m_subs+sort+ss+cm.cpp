@@ -172,11 +172,6 @@ inline void HINT_M_SubsSort_SS_CM::updatePartitions(const Record &r)
 
 HINT_M_SubsSort_SS_CM::HINT_M_SubsSort_SS_CM(const Relation &R, const unsigned int numBits, const unsigned int maxBits)  : HierarchicalIndex(R, numBits, maxBits)
 {
-    OffsetEntry_SS_CM dummySE;
-    Offsets_SS_CM_Iterator iterSEO, iterSEOBegin, iterSEOEnd;
-    PartitionId tmp = -1;
-    
-    
     // Step 1: one pass to count the contents inside each partition.
     this->pOrgsIn_sizes  = (RecordId **)malloc(this->height*sizeof(RecordId *));
     this->pOrgsAft_sizes = (RecordId **)malloc(this->height*sizeof(RecordId *));
@@ -268,16 +263,20 @@ HINT_M_SubsSort_SS_CM::HINT_M_SubsSort_SS_CM(const Relation &R, const unsigned i
         this->pRepsAft_offsets[l][cnt] = sumRaft;
     }
     
+    // Large partitions are radix sorted, see containers/radixsort.h; the
+    // starts of the originals and the ends of the In records are in the
+    // partition, so only their bits below those of the partition are used,
+    // while the ends of the Aft records are used whole.
     for (auto l = 0; l < this->height; l++)
     {
         auto cnt = (int)(pow(2, this->numBits-l));
-        for (auto pId = 0; pId < cnt; pId++)
-        {
-            sort(this->pOrgsInTmp[l].begin()+this->pOrgsIn_offsets[l][pId], this->pOrgsInTmp[l].begin()+this->pOrgsIn_offsets[l][pId+1]);
-            sort(this->pOrgsAftTmp[l].begin()+this->pOrgsAft_offsets[l][pId], this->pOrgsAftTmp[l].begin()+this->pOrgsAft_offsets[l][pId+1]);
-            sort(this->pRepsInTmp[l].begin()+this->pRepsIn_offsets[l][pId], this->pRepsInTmp[l].begin()+this->pRepsIn_offsets[l][pId+1], CompareByEnd);
-            sort(this->pRepsAftTmp[l].begin()+this->pRepsAft_offsets[l][pId], this->pRepsAftTmp[l].begin()+this->pRepsAft_offsets[l][pId+1], CompareByEnd);
-        }
+        unsigned int bits = this->maxBits-this->numBits+l;
+        uint64_t mask = (((uint64_t)1) << bits)-1;
+        
+        sortPartitions(this->pOrgsInTmp[l].data(), this->pOrgsIn_offsets[l], 0, cnt, 2*bits, [&](const Record &r) {return (((r.start & mask) << bits) | (r.end & mask));});
+        sortPartitions(this->pOrgsAftTmp[l].data(), this->pOrgsAft_offsets[l], 0, cnt, bits+32, [&](const Record &r) {return (((r.start & mask) << 32) | (uint32_t)r.end);});
+        sortPartitions(this->pRepsInTmp[l].data(), this->pRepsIn_offsets[l], 0, cnt, bits, [&](const Record &r) {return (r.end & mask);}, CompareByEnd);
+        sortPartitions(this->pRepsAftTmp[l].data(), this->pRepsAft_offsets[l], 0, cnt, 32, [&](const Record &r) {return (uint32_t)r.end;}, CompareByEnd);
     }
     
     
@@ -286,10 +285,10 @@ HINT_M_SubsSort_SS_CM::HINT_M_SubsSort_SS_CM(const Relation &R, const unsigned i
     this->pOrgsAftIds = new RelationId[this->height];
     this->pRepsInIds  = new RelationId[this->height];
     this->pRepsAftIds = new RelationId[this->height];
-    this->pOrgsInTimestamps  = new vector<pair<Timestamp, Timestamp> >[this->height];
-    this->pOrgsAftTimestamps = new vector<pair<Timestamp, Timestamp> >[this->height];
-    this->pRepsInTimestamps  = new vector<pair<Timestamp, Timestamp> >[this->height];
-    this->pRepsAftTimestamps = new vector<pair<Timestamp, Timestamp> >[this->height];
+    this->pOrgsInTimestamps  = new TimestampPairs[this->height];
+    this->pOrgsAftTimestamps = new TimestampPairs[this->height];
+    this->pRepsInTimestamps  = new TimestampPairs[this->height];
+    this->pRepsAftTimestamps = new TimestampPairs[this->height];
     for (auto l = 0; l < this->height; l++)
     {
         auto cnt = pOrgsInTmp[l].size();
@@ -299,8 +298,7 @@ HINT_M_SubsSort_SS_CM::HINT_M_SubsSort_SS_CM(const Relation &R, const unsigned i
         for (auto j = 0; j < cnt; j++)
         {
             this->pOrgsInIds[l][j] = this->pOrgsInTmp[l][j].id;
-            this->pOrgsInTimestamps[l][j].first = this->pOrgsInTmp[l][j].start;
-            this->pOrgsInTimestamps[l][j].second = this->pOrgsInTmp[l][j].end;
+            this->pOrgsInTimestamps[l].set(j, this->pOrgsInTmp[l][j].start, this->pOrgsInTmp[l][j].end);
         }
         
         cnt = pOrgsAftTmp[l].size();
@@ -309,8 +307,7 @@ HINT_M_SubsSort_SS_CM::HINT_M_SubsSort_SS_CM(const Relation &R, const unsigned i
         for (auto j = 0; j < cnt; j++)
         {
             this->pOrgsAftIds[l][j] = this->pOrgsAftTmp[l][j].id;
-            this->pOrgsAftTimestamps[l][j].first = this->pOrgsAftTmp[l][j].start;
-            this->pOrgsAftTimestamps[l][j].second = this->pOrgsAftTmp[l][j].end;
+            this->pOrgsAftTimestamps[l].set(j, this->pOrgsAftTmp[l][j].start, this->pOrgsAftTmp[l][j].end);
         }
         
         cnt = pRepsInTmp[l].size();
@@ -319,8 +316,7 @@ HINT_M_SubsSort_SS_CM::HINT_M_SubsSort_SS_CM(const Relation &R, const unsigned i
         for (auto j = 0; j < cnt; j++)
         {
             this->pRepsInIds[l][j] = this->pRepsInTmp[l][j].id;
-            this->pRepsInTimestamps[l][j].first = this->pRepsInTmp[l][j].start;
-            this->pRepsInTimestamps[l][j].second = this->pRepsInTmp[l][j].end;
+            this->pRepsInTimestamps[l].set(j, this->pRepsInTmp[l][j].start, this->pRepsInTmp[l][j].end);
         }
 
         cnt = pRepsAftTmp[l].size();
@@ -329,8 +325,7 @@ HINT_M_SubsSort_SS_CM::HINT_M_SubsSort_SS_CM(const Relation &R, const unsigned i
         for (auto j = 0; j < cnt; j++)
         {
             this->pRepsAftIds[l][j] = this->pRepsAftTmp[l][j].id;
-            this->pRepsAftTimestamps[l][j].first = this->pRepsAftTmp[l][j].start;
-            this->pRepsAftTimestamps[l][j].second = this->pRepsAftTmp[l][j].end;
+            this->pRepsAftTimestamps[l].set(j, this->pRepsAftTmp[l][j].start, this->pRepsAftTmp[l][j].end);
         }
     }
     
@@ -355,6 +350,34 @@ HINT_M_SubsSort_SS_CM::HINT_M_SubsSort_SS_CM(const Relation &R, const unsigned i
     
 
     // Step 4: create offset pointers
+    this->buildOffsets();
+    
+    
+    // Free auxliary memory
+    for (auto l = 0; l < this->height; l++)
+    {
+        free(this->pOrgsIn_sizes[l]);
+        free(this->pOrgsAft_sizes[l]);
+        free(this->pRepsIn_sizes[l]);
+        free(this->pRepsAft_sizes[l]);
+    }
+    free(this->pOrgsIn_sizes);
+    free(this->pOrgsAft_sizes);
+    free(this->pRepsIn_sizes);
+    free(this->pRepsAft_sizes);
+}
+
+
+// Creates the offsets of every level from the sizes of all its partitions,
+// pOrgsIn_sizes etc.; the levels are built top-down, as the vertical
+// pointers of a level point in the level above.
+void HINT_M_SubsSort_SS_CM::buildOffsets()
+{
+    OffsetEntry_SS_CM dummySE;
+    Offsets_SS_CM_Iterator iterSEO, iterSEOBegin, iterSEOEnd;
+    PartitionId tmp = -1;
+    
+    
     this->pOrgsIn_ioffsets  = new Offsets_SS_CM[this->height];
     this->pOrgsAft_ioffsets = new Offsets_SS_CM[this->height];
     this->pRepsIn_ioffsets  = new Offsets_SS_CM[this->height];
@@ -364,6 +387,11 @@ HINT_M_SubsSort_SS_CM::HINT_M_SubsSort_SS_CM(const Relation &R, const unsigned i
         auto cnt = (int)(pow(2, this->numBits-l));
         size_t sumOin = 0, sumOaft = 0, sumRin = 0, sumRaft = 0;
         
+        this->pOrgsIn_ioffsets[l].setBase(this->pOrgsInIds[l].begin(), this->pOrgsInTimestamps[l].begin());
+        this->pOrgsAft_ioffsets[l].setBase(this->pOrgsAftIds[l].begin(), this->pOrgsAftTimestamps[l].begin());
+        this->pRepsIn_ioffsets[l].setBase(this->pRepsInIds[l].begin(), this->pRepsInTimestamps[l].begin());
+        this->pRepsAft_ioffsets[l].setBase(this->pRepsAftIds[l].begin(), this->pRepsAftTimestamps[l].begin());
+        
         for (auto pId = 0; pId < cnt; pId++)
         {
             bool isEmpty = true;
@@ -436,9 +464,358 @@ HINT_M_SubsSort_SS_CM::HINT_M_SubsSort_SS_CM(const Relation &R, const unsigned i
             if (isEmpty)
                 this->numEmptyPartitions++;
         }
+        
+        this->pOrgsIn_ioffsets[l].buildDirectory(cnt);
+        this->pOrgsAft_ioffsets[l].buildDirectory(cnt);
+        this->pRepsIn_ioffsets[l].buildDirectory(cnt);
+        this->pRepsAft_ioffsets[l].buildDirectory(cnt);
+    }
+}
+
+
+// Builds the search tree on the offsets of every level and partition
+// class, used instead of the binary searches over the offsets.
+void HINT_M_SubsSort_SS_CM::buildSearchLayout()
+{
+    for (auto l = 0; l < this->height; l++)
+    {
+        this->pOrgsIn_ioffsets[l].buildSearchTree();
+        this->pOrgsAft_ioffsets[l].buildSearchTree();
+        this->pRepsIn_ioffsets[l].buildSearchTree();
+        this->pRepsAft_ioffsets[l].buildSearchTree();
+    }
+}
+
+
+// Merges the delta buffer in the partitions. The new records are placed in
+// partitions and sorted as in the construction, and then every level and
+// partition class is rewritten once, merging every old partition with its
+// new records. Hence, a merge costs about as much as copying the index,
+// amortized over the capacity of the buffer.
+void HINT_M_SubsSort_SS_CM::mergeDelta()
+{
+    const Relation &D = this->delta.records;
+    bool hasSearchLayout = false;
+    
+    
+    // Step 1: one pass to count the new contents of each partition.
+    this->pOrgsIn_sizes  = (RecordId **)malloc(this->height*sizeof(RecordId *));
+    this->pOrgsAft_sizes = (RecordId **)malloc(this->height*sizeof(RecordId *));
+    this->pRepsIn_sizes  = (size_t **)malloc(this->height*sizeof(size_t *));
+    this->pRepsAft_sizes = (size_t **)malloc(this->height*sizeof(size_t *));
+    this->pOrgsIn_offsets  = (RecordId **)malloc(this->height*sizeof(RecordId *));
+    this->pOrgsAft_offsets = (RecordId **)malloc(this->height*sizeof(RecordId *));
+    this->pRepsIn_offsets  = (size_t **)malloc(this->height*sizeof(size_t *));
+    this->pRepsAft_offsets = (size_t **)malloc(this->height*sizeof(size_t *));
+    for (auto l = 0; l < this->height; l++)
+    {
+        auto cnt = (int)(pow(2, this->numBits-l));
+        
+        this->pOrgsIn_sizes[l]  = (RecordId *)calloc(cnt, sizeof(RecordId));
+        this->pOrgsAft_sizes[l] = (RecordId *)calloc(cnt, sizeof(RecordId));
+        this->pRepsIn_sizes[l]  = (size_t *)calloc(cnt, sizeof(size_t));
+        this->pRepsAft_sizes[l] = (size_t *)calloc(cnt, sizeof(size_t));
+        this->pOrgsIn_offsets[l]  = (RecordId *)calloc(cnt+1, sizeof(RecordId));
+        this->pOrgsAft_offsets[l] = (RecordId *)calloc(cnt+1, sizeof(RecordId));
+        this->pRepsIn_offsets[l]  = (size_t *)calloc(cnt+1, sizeof(size_t));
+        this->pRepsAft_offsets[l] = (size_t *)calloc(cnt+1, sizeof(size_t));
+    }
+    for (const Record &r : D)
+        this->updateCounters(r);
+    
+    
+    // Step 2: fill and sort the partitions of the new records.
+    auto setOffsets = [&](auto offsets, auto sizes, PartitionId cnt)
+    {
+        size_t sum = 0;
+        
+        for (auto pId = 0; pId < cnt; pId++)
+        {
+            offsets[pId] = sum;
+            sum += sizes[pId];
+        }
+        offsets[cnt] = sum;
+    };
+    this->pOrgsInTmp  = new Relation[this->height];
+    this->pOrgsAftTmp = new Relation[this->height];
+    this->pRepsInTmp  = new Relation[this->height];
+    this->pRepsAftTmp = new Relation[this->height];
+    for (auto l = 0; l < this->height; l++)
+    {
+        auto cnt = (int)(pow(2, this->numBits-l));
+        
+        setOffsets(this->pOrgsIn_offsets[l], this->pOrgsIn_sizes[l], cnt);
+        setOffsets(this->pOrgsAft_offsets[l], this->pOrgsAft_sizes[l], cnt);
+        setOffsets(this->pRepsIn_offsets[l], this->pRepsIn_sizes[l], cnt);
+        setOffsets(this->pRepsAft_offsets[l], this->pRepsAft_sizes[l], cnt);
+        this->pOrgsInTmp[l].resize(this->pOrgsIn_offsets[l][cnt]);
+        this->pOrgsAftTmp[l].resize(this->pOrgsAft_offsets[l][cnt]);
+        this->pRepsInTmp[l].resize(this->pRepsIn_offsets[l][cnt]);
+        this->pRepsAftTmp[l].resize(this->pRepsAft_offsets[l][cnt]);
+    }
+    for (const Record &r : D)
+        this->updatePartitions(r);
+    for (auto l = 0; l < this->height; l++)
+    {
+        auto cnt = (int)(pow(2, this->numBits-l));
+        
+        setOffsets(this->pOrgsIn_offsets[l], this->pOrgsIn_sizes[l], cnt);
+        setOffsets(this->pOrgsAft_offsets[l], this->pOrgsAft_sizes[l], cnt);
+        setOffsets(this->pRepsIn_offsets[l], this->pRepsIn_sizes[l], cnt);
+        setOffsets(this->pRepsAft_offsets[l], this->pRepsAft_sizes[l], cnt);
+        for (auto pId = 0; pId < cnt; pId++)
+        {
+            sort(this->pOrgsInTmp[l].begin()+this->pOrgsIn_offsets[l][pId], this->pOrgsInTmp[l].begin()+this->pOrgsIn_offsets[l][pId+1]);
+            sort(this->pOrgsAftTmp[l].begin()+this->pOrgsAft_offsets[l][pId], this->pOrgsAftTmp[l].begin()+this->pOrgsAft_offsets[l][pId+1]);
+            sort(this->pRepsInTmp[l].begin()+this->pRepsIn_offsets[l][pId], this->pRepsInTmp[l].begin()+this->pRepsIn_offsets[l][pId+1], CompareByEnd);
+            sort(this->pRepsAftTmp[l].begin()+this->pRepsAft_offsets[l][pId], this->pRepsAftTmp[l].begin()+this->pRepsAft_offsets[l][pId+1], CompareByEnd);
+        }
+    }
+    
+    
+    // Step 3: merge every old partition with its new records; the sizes
+    // become those of the merged partitions.
+    auto mergePartitions = [&](RelationId &ids, TimestampPairs &timestamps, const Offsets_SS_CM &ioffsets, const Relation &tmp, auto offsets, auto sizes, PartitionId cnt, bool (*compare)(const Record&, const Record&))
+    {
+        vector<size_t> old(cnt+1);
+        RelationId mIds;
+        TimestampPairs mTimestamps;
+        size_t i = 0, k = 0;
+        
+        mIds.resize(ids.size()+tmp.size());
+        mTimestamps.resize(ids.size()+tmp.size());
+        ioffsets.getPartitionOffsets(cnt, ids.size(), old.data());
+        for (auto pId = 0; pId < cnt; pId++)
+        {
+            size_t j = offsets[pId];
+            
+            while ((i < old[pId+1]) || (j < offsets[pId+1]))
+            {
+                if ((j == offsets[pId+1]) || ((i < old[pId+1]) && (!compare(tmp[j], Record(ids[i], timestamps[i].first, timestamps[i].second)))))
+                {
+                    mIds[k] = ids[i];
+                    mTimestamps.set(k++, timestamps[i++]);
+                }
+                else
+                {
+                    mIds[k] = tmp[j].id;
+                    mTimestamps.set(k++, tmp[j].start, tmp[j].end);
+                    j++;
+                }
+            }
+            sizes[pId] += old[pId+1]-old[pId];
+        }
+        ids.swap(mIds);
+        timestamps.swap(mTimestamps);
+    };
+    for (auto l = 0; l < this->height; l++)
+    {
+        auto cnt = (int)(pow(2, this->numBits-l));
+        
+        hasSearchLayout |= (this->pOrgsIn_ioffsets[l].getSearchTreeSize()+this->pOrgsAft_ioffsets[l].getSearchTreeSize()+this->pRepsIn_ioffsets[l].getSearchTreeSize()+this->pRepsAft_ioffsets[l].getSearchTreeSize() > 0);
+        mergePartitions(this->pOrgsInIds[l], this->pOrgsInTimestamps[l], this->pOrgsIn_ioffsets[l], this->pOrgsInTmp[l], this->pOrgsIn_offsets[l], this->pOrgsIn_sizes[l], cnt, [](const Record &lhs, const Record &rhs) {return (lhs < rhs);});
+        mergePartitions(this->pOrgsAftIds[l], this->pOrgsAftTimestamps[l], this->pOrgsAft_ioffsets[l], this->pOrgsAftTmp[l], this->pOrgsAft_offsets[l], this->pOrgsAft_sizes[l], cnt, [](const Record &lhs, const Record &rhs) {return (lhs < rhs);});
+        mergePartitions(this->pRepsInIds[l], this->pRepsInTimestamps[l], this->pRepsIn_ioffsets[l], this->pRepsInTmp[l], this->pRepsIn_offsets[l], this->pRepsIn_sizes[l], cnt, CompareByEnd);
+        mergePartitions(this->pRepsAftIds[l], this->pRepsAftTimestamps[l], this->pRepsAft_ioffsets[l], this->pRepsAftTmp[l], this->pRepsAft_offsets[l], this->pRepsAft_sizes[l], cnt, CompareByEnd);
+    }
+    
+    
+    // Step 4: rebuild the offsets, as the arrays have moved
+    delete[] this->pOrgsIn_ioffsets;
+    delete[] this->pOrgsAft_ioffsets;
+    delete[] this->pRepsIn_ioffsets;
+    delete[] this->pRepsAft_ioffsets;
+    this->numEmptyPartitions = 0;
+    this->buildOffsets();
+    if (hasSearchLayout)
+        this->buildSearchLayout();
+    
+    
+    // Free auxliary memory
+    for (auto l = 0; l < this->height; l++)
+    {
+        free(this->pOrgsIn_sizes[l]);
+        free(this->pOrgsAft_sizes[l]);
+        free(this->pRepsIn_sizes[l]);
+        free(this->pRepsAft_sizes[l]);
+        free(this->pOrgsIn_offsets[l]);
+        free(this->pOrgsAft_offsets[l]);
+        free(this->pRepsIn_offsets[l]);
+        free(this->pRepsAft_offsets[l]);
+    }
+    free(this->pOrgsIn_sizes);
+    free(this->pOrgsAft_sizes);
+    free(this->pRepsIn_sizes);
+    free(this->pRepsAft_sizes);
+    free(this->pOrgsIn_offsets);
+    free(this->pOrgsAft_offsets);
+    free(this->pRepsIn_offsets);
+    free(this->pRepsAft_offsets);
+    
+    delete[] this->pOrgsInTmp;
+    delete[] this->pOrgsAftTmp;
+    delete[] this->pRepsInTmp;
+    delete[] this->pRepsAftTmp;
+}
+
+// Positions of the copies of record r in the arrays of the index, placed as
+// in updatePartitions(); only the partitions of r are scanned, and false is
+// returned if a copy is missing, i.e., r is not indexed.
+bool HINT_M_SubsSort_SS_CM::locate(const Record &r, vector<const RecordId*> &slots)
+{
+    int level = 0;
+    Timestamp a = r.start >> (this->maxBits-this->numBits);
+    Timestamp b = r.end   >> (this->maxBits-this->numBits);
+    Timestamp prevb;
+    int firstfound = 0, lastfound = 0;
+    bool found = true;
+    auto find = [&](const Offsets_SS_CM &ioffsets, const RelationId &ids, const PartitionId pId)
+    {
+        size_t first, last;
+        
+        if (!ioffsets.getPartition(pId, ids.size(), first, last))
+            return false;
+        
+        auto iter = std::find(ids.begin()+first, ids.begin()+last, r.id);
+        
+        if (iter == ids.begin()+last)
+            return false;
+        slots.push_back(&(*iter));
+        
+        return true;
+    };
+    
+
+    while (level < this->height && a <= b && found)
+    {
+        if (a%2)
+        { //last bit of a is 1
+            if (firstfound)
+            {
+                if ((a == b) && (!lastfound))
+                {
+                    found = find(this->pRepsIn_ioffsets[level], this->pRepsInIds[level], a);
+                    lastfound = 1;
+                }
+                else
+                {
+                    found = find(this->pRepsAft_ioffsets[level], this->pRepsAftIds[level], a);
+                }
+            }
+            else
+            {
+                if ((a == b) && (!lastfound))
+                {
+                    found = find(this->pOrgsIn_ioffsets[level], this->pOrgsInIds[level], a);
+                }
+                else
+                {
+                    found = find(this->pOrgsAft_ioffsets[level], this->pOrgsAftIds[level], a);
+                }
+                firstfound = 1;
+            }
+            a++;
+        }
+        if ((!(b%2)) && (found))
+        { //last bit of b is 0
+            prevb = b;
+            b--;
+            if ((!firstfound) && b < a)
+            {
+                if (!lastfound)
+                {
+                    found = find(this->pOrgsIn_ioffsets[level], this->pOrgsInIds[level], prevb);
+                }
+                else
+                {
+                    found = find(this->pOrgsAft_ioffsets[level], this->pOrgsAftIds[level], prevb);
+                }
+            }
+            else
+            {
+                if (!lastfound)
+                {
+                    found = find(this->pRepsIn_ioffsets[level], this->pRepsInIds[level], prevb);
+                    lastfound = 1;
+                }
+                else
+                {
+                    found = find(this->pRepsAft_ioffsets[level], this->pRepsAftIds[level], prevb);
+                }
+            }
+        }
+        a >>= 1; // a = a div 2
+        b >>= 1; // b = b div 2
+        level++;
+    }
+    
+    return found;
+}
+
+
+// Drops the erased records from the partitions. Every level and partition
+// class is compacted once, front to back, and the offsets are rebuilt from
+// the new sizes of the partitions, as after a merge.
+void HINT_M_SubsSort_SS_CM::purgeTombstones()
+{
+    bool hasSearchLayout = false;
+    
+    
+    // Step 1: compact the arrays and count the new contents of each partition.
+    auto compact = [&](RelationId &ids, TimestampPairs &timestamps, const Offsets_SS_CM &ioffsets, auto sizes, PartitionId cnt)
+    {
+        vector<size_t> old(cnt+1);
+        size_t k = 0;
+        
+        ioffsets.getPartitionOffsets(cnt, ids.size(), old.data());
+        for (auto pId = 0; pId < cnt; pId++)
+        {
+            size_t first = k;
+            
+            for (auto i = old[pId]; i < old[pId+1]; i++)
+            {
+                if (!this->tombstones.isErased(ids[i]))
+                {
+                    ids[k] = ids[i];
+                    timestamps.set(k++, timestamps[i]);
+                }
+            }
+            sizes[pId] = k-first;
+        }
+        ids.resize(k);
+        timestamps.resize(k);
+    };
+    this->pOrgsIn_sizes  = (RecordId **)malloc(this->height*sizeof(RecordId *));
+    this->pOrgsAft_sizes = (RecordId **)malloc(this->height*sizeof(RecordId *));
+    this->pRepsIn_sizes  = (size_t **)malloc(this->height*sizeof(size_t *));
+    this->pRepsAft_sizes = (size_t **)malloc(this->height*sizeof(size_t *));
+    for (auto l = 0; l < this->height; l++)
+    {
+        auto cnt = (int)(pow(2, this->numBits-l));
+        
+        this->pOrgsIn_sizes[l]  = (RecordId *)calloc(cnt, sizeof(RecordId));
+        this->pOrgsAft_sizes[l] = (RecordId *)calloc(cnt, sizeof(RecordId));
+        this->pRepsIn_sizes[l]  = (size_t *)calloc(cnt, sizeof(size_t));
+        this->pRepsAft_sizes[l] = (size_t *)calloc(cnt, sizeof(size_t));
+        hasSearchLayout |= (this->pOrgsIn_ioffsets[l].getSearchTreeSize()+this->pOrgsAft_ioffsets[l].getSearchTreeSize()+this->pRepsIn_ioffsets[l].getSearchTreeSize()+this->pRepsAft_ioffsets[l].getSearchTreeSize() > 0);
+        compact(this->pOrgsInIds[l], this->pOrgsInTimestamps[l], this->pOrgsIn_ioffsets[l], this->pOrgsIn_sizes[l], cnt);
+        compact(this->pOrgsAftIds[l], this->pOrgsAftTimestamps[l], this->pOrgsAft_ioffsets[l], this->pOrgsAft_sizes[l], cnt);
+        compact(this->pRepsInIds[l], this->pRepsInTimestamps[l], this->pRepsIn_ioffsets[l], this->pRepsIn_sizes[l], cnt);
+        compact(this->pRepsAftIds[l], this->pRepsAftTimestamps[l], this->pRepsAft_ioffsets[l], this->pRepsAft_sizes[l], cnt);
     }
     
     
+    // Step 2: rebuild the offsets, as the arrays have moved
+    delete[] this->pOrgsIn_ioffsets;
+    delete[] this->pOrgsAft_ioffsets;
+    delete[] this->pRepsIn_ioffsets;
+    delete[] this->pRepsAft_ioffsets;
+    this->numEmptyPartitions = 0;
+    this->buildOffsets();
+    if (hasSearchLayout)
+        this->buildSearchLayout();
+    
+    
     // Free auxliary memory
     for (auto l = 0; l < this->height; l++)
     {
@@ -467,6 +844,7 @@ void HINT_M_SubsSort_SS_CM::getStats()
         this->numOriginalsAft += this->pOrgsAftIds[l].size();
         this->numReplicasIn   += this->pRepsInIds[l].size();
         this->numReplicasAft  += this->pRepsAftIds[l].size();
+        this->sizeSearchLayout += this->pOrgsIn_ioffsets[l].getSearchTreeSize()+this->pOrgsAft_ioffsets[l].getSearchTreeSize()+this->pRepsIn_ioffsets[l].getSearchTreeSize()+this->pRepsAft_ioffsets[l].getSearchTreeSize();
     }
     
     this->avgPartitionSize = (float)(this->numIndexedRecords+this->numReplicasIn+this->numReplicasAft)/(this->numPartitions-numEmptyPartitions);
@@ -492,7 +870,7 @@ HINT_M_SubsSort_SS_CM::~HINT_M_SubsSort_SS_CM()
 
 
 // Auxiliary functions to determine exactly how to scan a partition.
-inline bool HINT_M_SubsSort_SS_CM::getBounds(unsigned int level, Timestamp t, PartitionId &next_from, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, vector<pair<Timestamp, Timestamp> >::iterator &iterBegin, vector<pair<Timestamp, Timestamp> >::iterator &iterEnd, RelationIdIterator &iterI)
+inline bool HINT_M_SubsSort_SS_CM::getBounds(unsigned int level, Timestamp t, PartitionId &next_from, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, TimestampPairs::iterator &iterBegin, TimestampPairs::iterator &iterEnd, RelationIdIterator &iterI)
 {
     OffsetEntry_SS_CM qdummy;
     Offsets_SS_CM_Iterator iterIO, iterIOBegin, iterIOEnd;
@@ -502,7 +880,7 @@ inline bool HINT_M_SubsSort_SS_CM::getBounds(unsigned int level, Timestamp t, Pa
     if (cnt > 0)
     {
         // Do binary search or follow vertical pointers.
-        if ((from == -1) || (from > cnt))
+        if ((from == -1) || (from >= cnt))
         {
             qdummy.tstamp = t;
             iterIOBegin = ioffsets[level].begin();
@@ -527,14 +905,14 @@ inline bool HINT_M_SubsSort_SS_CM::getBounds(unsigned int level, Timestamp t, Pa
             Timestamp tmp = (ioffsets[level][from]).tstamp;
             if (tmp < t)
             {
-                while (((ioffsets[level][from]).tstamp < t) && (from < cnt))
+                while ((from < cnt) && ((ioffsets[level][from]).tstamp < t))
                     from++;
             }
             else if (tmp > t)
             {
-                while (((ioffsets[level][from]).tstamp > t) && (from > -1))
+                while ((from > -1) && ((ioffsets[level][from]).tstamp > t))
                     from--;
-                if (((ioffsets[level][from]).tstamp != t) || (from == -1))
+                if ((from == -1) || ((ioffsets[level][from]).tstamp != t))
                     from++;
             }
 
@@ -575,7 +953,7 @@ inline bool HINT_M_SubsSort_SS_CM::getBounds(unsigned int level, Timestamp t, Pa
 
     if (cnt > 0)
     {
-        if ((from == -1) || (from > cnt))
+        if ((from == -1) || (from >= cnt))
         {
             qdummy.tstamp = t;
             iterIOBegin = ioffsets[level].begin();
@@ -598,14 +976,14 @@ inline bool HINT_M_SubsSort_SS_CM::getBounds(unsigned int level, Timestamp t, Pa
             Timestamp tmp = (ioffsets[level][from]).tstamp;
             if (tmp < t)
             {
-                while (((ioffsets[level][from]).tstamp < t) && (from < cnt))
+                while ((from < cnt) && ((ioffsets[level][from]).tstamp < t))
                     from++;
             }
             else if (tmp > t)
             {
-                while (((ioffsets[level][from]).tstamp > t) && (from > -1))
+                while ((from > -1) && ((ioffsets[level][from]).tstamp > t))
                     from--;
-                if (((ioffsets[level][from]).tstamp != t) || (from == -1))
+                if ((from == -1) || ((ioffsets[level][from]).tstamp != t))
                     from++;
             }
 
@@ -635,7 +1013,7 @@ inline bool HINT_M_SubsSort_SS_CM::getBounds(unsigned int level, Timestamp t, Pa
 }
 
 
-inline bool HINT_M_SubsSort_SS_CM::getBoundsS(unsigned int level, Timestamp t, PartitionId &next_from, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, RelationIdIterator &iterIBegin, RelationIdIterator &iterIEnd)
+inline bool HINT_M_SubsSort_SS_CM::getBoundsS(unsigned int level, Timestamp t, PartitionId &next_from, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, RelationIdIterator &iterIBegin, RelationIdIterator &iterIEnd)
 {
     OffsetEntry_SS_CM qdummy;
     Offsets_SS_CM_Iterator iterIO, iterIOBegin, iterIOEnd;
@@ -646,7 +1024,7 @@ inline bool HINT_M_SubsSort_SS_CM::getBoundsS(unsigned int level, Timestamp t, P
     if (cnt > 0)
     {
         // Do binary search or follow vertical pointers.
-        if ((from == -1) || (from > cnt))
+        if ((from == -1) || (from >= cnt))
         {
             qdummy.tstamp = t;
             iterIOBegin = ioffsets[level].begin();
@@ -673,14 +1051,14 @@ inline bool HINT_M_SubsSort_SS_CM::getBoundsS(unsigned int level, Timestamp t, P
             Timestamp tmp = (ioffsets[level][from]).tstamp;
             if (tmp < t)
             {
-                while (((ioffsets[level][from]).tstamp < t) && (from < cnt))
+                while ((from < cnt) && ((ioffsets[level][from]).tstamp < t))
                     from++;
             }
             else if (tmp > t)
             {
-                while (((ioffsets[level][from]).tstamp > t) && (from > -1))
+                while ((from > -1) && ((ioffsets[level][from]).tstamp > t))
                     from--;
-                if (((ioffsets[level][from]).tstamp != t) || (from == -1))
+                if ((from == -1) || ((ioffsets[level][from]).tstamp != t))
                     from++;
             }
 
@@ -713,7 +1091,7 @@ inline bool HINT_M_SubsSort_SS_CM::getBoundsS(unsigned int level, Timestamp t, P
     }
 }
 
-inline bool HINT_M_SubsSort_SS_CM::getBoundsE(unsigned int level, Timestamp t, PartitionId &next_from, Offsets_SS_CM *ioffsets, RelationId *ids, vector<pair<Timestamp, Timestamp> > *timestamps, RelationIdIterator &iterIBegin, RelationIdIterator &iterIEnd)
+inline bool HINT_M_SubsSort_SS_CM::getBoundsE(unsigned int level, Timestamp t, PartitionId &next_from, Offsets_SS_CM *ioffsets, RelationId *ids, TimestampPairs *timestamps, RelationIdIterator &iterIBegin, RelationIdIterator &iterIEnd)
 
 {
     OffsetEntry_SS_CM qdummy;
@@ -725,7 +1103,7 @@ inline bool HINT_M_SubsSort_SS_CM::getBoundsE(unsigned int level, Timestamp t, P
     if (cnt > 0)
     {
         // Do binary search or follow vertical pointers.
-        if ((from == -1) || (from > cnt))
+        if ((from == -1) || (from >= cnt))
         {
             qdummy.tstamp = t;
             iterIOBegin = ioffsets[level].begin();
@@ -752,15 +1130,15 @@ inline bool HINT_M_SubsSort_SS_CM::getBoundsE(unsigned int level, Timestamp t, P
             Timestamp tmp = (ioffsets[level][from]).tstamp;
             if (tmp < t)
             {
-                while (((ioffsets[level][from]).tstamp < t) && (from < cnt))
+                while ((from < cnt) && ((ioffsets[level][from]).tstamp < t))
                     from++;
                 from--;
             }
             else if (tmp >= t)
             {
-                while (((ioffsets[level][from]).tstamp >= t) && (from > -1))
+                while ((from > -1) && ((ioffsets[level][from]).tstamp >= t))
                     from--;
-//                if (((ioffsets[level][from]).tstamp != t) || (from == -1))
+//                if ((from == -1) || ((ioffsets[level][from]).tstamp != t))
 //                    from++;
             }
 
@@ -793,7 +1171,7 @@ inline bool HINT_M_SubsSort_SS_CM::getBoundsE(unsigned int level, Timestamp t, P
 }
 
 
-inline bool HINT_M_SubsSort_SS_CM::getBounds(unsigned int level, Timestamp ts, Timestamp te, PartitionId &next_from, PartitionId &next_to, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, vector<pair<Timestamp, Timestamp> >::iterator &iterBegin, vector<pair<Timestamp, Timestamp> >::iterator &iterEnd, RelationIdIterator &iterI)
+inline bool HINT_M_SubsSort_SS_CM::getBounds(unsigned int level, Timestamp ts, Timestamp te, PartitionId &next_from, PartitionId &next_to, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, TimestampPairs::iterator &iterBegin, TimestampPairs::iterator &iterEnd, RelationIdIterator &iterI)
 {
     OffsetEntry_SS_CM qdummyA, qdummyB;
     Offsets_SS_CM_Iterator iterIO, iterIO2, iterIOBegin, iterIOEnd;
@@ -804,7 +1182,7 @@ inline bool HINT_M_SubsSort_SS_CM::getBounds(unsigned int level, Timestamp ts, T
     if (cnt > 0)
     {
         // Do binary search or follow vertical pointers.
-        if ((from == -1) || (to == -1))
+        if ((from == -1) || (from >= cnt) || (to == -1))
         {
             qdummyA.tstamp = ts;
             iterIOBegin = ioffsets[level].begin();
@@ -844,28 +1222,28 @@ inline bool HINT_M_SubsSort_SS_CM::getBounds(unsigned int level, Timestamp ts, T
             Timestamp tmp = (ioffsets[level][from]).tstamp;
             if (tmp < ts)
             {
-                while (((ioffsets[level][from]).tstamp < ts) && (from < cnt))
+                while ((from < cnt) && ((ioffsets[level][from]).tstamp < ts))
                     from++;
             }
             else if (tmp > ts)
             {
-                while (((ioffsets[level][from]).tstamp > ts) && (from > -1))
+                while ((from > -1) && ((ioffsets[level][from]).tstamp > ts))
                     from--;
-                if (((ioffsets[level][from]).tstamp != ts) || (from == -1))
+                if ((from == -1) || ((ioffsets[level][from]).tstamp != ts))
                     from++;
             }
 
             tmp = (ioffsets[level][to]).tstamp;
             if (tmp > te)
             {
-                while (((ioffsets[level][to]).tstamp > te) && (to > -1))
+                while ((to > -1) && ((ioffsets[level][to]).tstamp > te))
                     to--;
                 to++;
             }
 //                else if (tmp <= te)
             else if (tmp == te)
             {
-                while (((ioffsets[level][to]).tstamp <= te) && (to < cnt))
+                while ((to < cnt) && ((ioffsets[level][to]).tstamp <= te))
                     to++;
             }
 
@@ -912,7 +1290,7 @@ inline bool HINT_M_SubsSort_SS_CM::getBounds(unsigned int level, Timestamp ts, T
         to = next_to;
 
         // Do binary search or follow vertical pointers.
-        if ((from == -1) || (to == -1))
+        if ((from == -1) || (from >= cnt) || (to == -1))
         {
             qdummyTS.tstamp = ts;
             iterIOBegin = ioffsets[level].begin();
@@ -951,28 +1329,28 @@ inline bool HINT_M_SubsSort_SS_CM::getBounds(unsigned int level, Timestamp ts, T
             Timestamp tmp = (ioffsets[level][from]).tstamp;
             if (tmp < ts)
             {
-                while (((ioffsets[level][from]).tstamp < ts) && (from < cnt))
+                while ((from < cnt) && ((ioffsets[level][from]).tstamp < ts))
                     from++;
             }
             else if (tmp > ts)
             {
-                while (((ioffsets[level][from]).tstamp > ts) && (from > -1))
+                while ((from > -1) && ((ioffsets[level][from]).tstamp > ts))
                     from--;
-                if (((ioffsets[level][from]).tstamp != ts) || (from == -1))
+                if ((from == -1) || ((ioffsets[level][from]).tstamp != ts))
                     from++;
             }
 
             tmp = (ioffsets[level][to]).tstamp;
             if (tmp > te)
             {
-                while (((ioffsets[level][to]).tstamp > te) && (to > -1))
+                while ((to > -1) && ((ioffsets[level][to]).tstamp > te))
                     to--;
                 to++;
             }
 //                else if (tmp <= b)
             else if (tmp == te)
             {
-                while (((ioffsets[level][to]).tstamp <= te) && (to < cnt))
+                while ((to < cnt) && ((ioffsets[level][to]).tstamp <= te))
                     to++;
             }
 
@@ -1004,9 +1382,10 @@ inline bool HINT_M_SubsSort_SS_CM::getBounds(unsigned int level, Timestamp ts, T
 }
 
 
-inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckBothTimestamps_Equals(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckBothTimestamps_Equals(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
@@ -1018,11 +1397,7 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckBothTimestamps_Equals(unsi
         {
             if (qend == iter->second)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iterI++;
             iter++;
@@ -1031,9 +1406,10 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckBothTimestamps_Equals(unsi
 }
 
 
-inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckBothTimestamps_Starts(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckBothTimestamps_Starts(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
@@ -1045,11 +1421,7 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckBothTimestamps_Starts(unsi
         {
             if (qend < iter->second)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iterI++;
             iter++;
@@ -1058,9 +1430,10 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckBothTimestamps_Starts(unsi
 }
 
 
-inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckStart_Starts(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckStart_Starts(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
@@ -1070,11 +1443,7 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckStart_Starts(unsigned int
         iterI += iter-iterBegin;
         while ((iter != iterEnd) && (qt == iter->first))
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
+            result.add(*iterI);
 
             iterI++;
             iter++;
@@ -1083,9 +1452,10 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckStart_Starts(unsigned int
 }
 
 
-inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckBothTimestamps_Started(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckBothTimestamps_Started(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
@@ -1097,11 +1467,7 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckBothTimestamps_Started(uns
         {
             if (qend > iter->second)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iterI++;
             iter++;
@@ -1110,24 +1476,21 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckBothTimestamps_Started(uns
 }
 
 
-inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckBothTimestamps_Finishes(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckBothTimestamps_Finishes(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
     if (this->getBounds(level, t, next_from, ioffsets, timestamps, iterBegin, iterEnd, iterI))
     {
-        vector<pair<Timestamp, Timestamp> >::iterator pivot = lower_bound(iterBegin, iterEnd, make_pair(qstart, qstart), compare);
+        TimestampPairs::iterator pivot = lower_bound(iterBegin, iterEnd, make_pair(qstart, qstart), compare);
         for (iter = iterBegin; iter != pivot; iter++)
         {
             if (qend == iter->second)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= *iterI;
-#endif
+                result.add(*iterI);
             }
             iterI++;
         }
@@ -1135,9 +1498,10 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckBothTimestamps_Finishes(un
 }
 
 
-inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckBothTimestamps2_Finishes(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckBothTimestamps2_Finishes(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
@@ -1149,11 +1513,7 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckBothTimestamps2_Finishes(u
         {
             if (qstart > iter->first)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iter++;
             iterI++;
@@ -1162,9 +1522,10 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckBothTimestamps2_Finishes(u
 }
 
 
-inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckEnd_Finishes(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckEnd_Finishes(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
@@ -1174,11 +1535,7 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckEnd_Finishes(unsigned int
         iterI += (iter-iterBegin);
         while ((iter != iterEnd) && (qt == iter->second))
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= *iterI;
-#endif
+            result.add(*iterI);
 
             iter++;
             iterI++;
@@ -1187,9 +1544,10 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckEnd_Finishes(unsigned int
 }
 
 
-inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckBothTimestamps_Finished(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckBothTimestamps_Finished(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
@@ -1201,11 +1559,7 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckBothTimestamps_Finished(un
         {
             if (qend == iter->second)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= *iterI;
-#endif
+                result.add(*iterI);
             }
             iter++;
             iterI++;
@@ -1214,9 +1568,10 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckBothTimestamps_Finished(un
 }
 
 
-inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckBothTimestamps2_Finished(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckBothTimestamps2_Finished(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
@@ -1228,11 +1583,7 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckBothTimestamps2_Finished(u
         {
             if (qstart < iter->first)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= *iterI;
-#endif
+                result.add(*iterI);
             }
             iter++;
             iterI++;
@@ -1241,9 +1592,10 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckBothTimestamps2_Finished(u
 }
 
 
-inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckEnd_Finished(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, Timestamp qt, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckEnd_Finished(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, Timestamp qt, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
@@ -1253,11 +1605,7 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckEnd_Finished(unsigned int
         {
             if (qt == iter->second)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iterI++;
         }
@@ -1265,9 +1613,10 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckEnd_Finished(unsigned int
 }
 
 
-inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckEnd_Met(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckEnd_Met(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
@@ -1277,11 +1626,7 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckEnd_Met(unsigned int level
         iterI += iter-iterBegin;
         while ((iter != iterEnd) && (qt == iter->second))
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= *iterI;
-#endif
+            result.add(*iterI);
 
             iterI++;
             iter++;
@@ -1290,9 +1635,10 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckEnd_Met(unsigned int level
 }
 
 
-inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckAllConditions_Overlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckAllConditions_Overlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
@@ -1304,11 +1650,7 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckAllConditions_Overlaps(uns
         {
             if (qend < iter->second)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iter++;
             iterI++;
@@ -1317,9 +1659,10 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckAllConditions_Overlaps(uns
 }
 
 
-inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckTwoConditions1_Overlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckTwoConditions1_Overlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
@@ -1329,11 +1672,7 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckTwoConditions1_Overlaps(un
         iterI += iter-iterBegin;
         while ((iter != iterEnd) && (qend > iter->first))
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
+            result.add(*iterI);
 
             iter++;
             iterI++;
@@ -1342,9 +1681,10 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckTwoConditions1_Overlaps(un
 }
 
 
-inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckTwoConditions2_Overlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckTwoConditions2_Overlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
@@ -1356,11 +1696,7 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckTwoConditions2_Overlaps(un
         {
             if (qend < iter->second)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iter++;
             iterI++;
@@ -1369,32 +1705,25 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckTwoConditions2_Overlaps(un
 }
 
 
-inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckOneCondition_Overlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckOneCondition_Overlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
     if (this->getBounds(level, t, next_from, ioffsets, timestamps, iterBegin, iterEnd, iterI))
     {
-        vector<pair< Timestamp, Timestamp> >::iterator pivot = lower_bound(iterBegin, iterEnd, make_pair(qt, qt), compare);
-        for (iter = iterBegin; iter != pivot; iter++)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
-
-            iterI++;
-        }
+        TimestampPairs::iterator pivot = lower_bound(iterBegin, iterEnd, make_pair(qt, qt), compare);
+        reportIds(this->kernel, iterI, iterI+(pivot-iterBegin), result);
     }
 }
 
 
-inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckOneCondition2_Overlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, Timestamp qt, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckOneCondition2_Overlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, Timestamp qt, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
@@ -1404,35 +1733,28 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckOneCondition2_Overlaps(uns
         {
             if (qt < iter->first)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iterI++;
         }
     }
 }
 
-inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckTwoConditions_Overlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckTwoConditions_Overlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
     if (this->getBounds(level, t, next_from, ioffsets, timestamps, iterBegin, iterEnd, iterI))
     {
-        vector<pair<Timestamp, Timestamp> >::iterator pivot = lower_bound(iterBegin, iterEnd, make_pair(qt, qt), compare);
+        TimestampPairs::iterator pivot = lower_bound(iterBegin, iterEnd, make_pair(qt, qt), compare);
         for (iter = iterBegin; iter != pivot; iter++)
         {
             if (qt < iter->second)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iterI++;
         }
@@ -1440,10 +1762,11 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckTwoConditions_Overlaps(uns
 }
 
 
-inline void HINT_M_SubsSort_SS_CM::scanPartitions_CheckOneCondition_Overlaps(unsigned int level, Timestamp ts, Timestamp te, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, Timestamp qt, PartitionId &next_from, PartitionId &next_to, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartitions_CheckOneCondition_Overlaps(unsigned int level, Timestamp ts, Timestamp te, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, Timestamp qt, PartitionId &next_from, PartitionId &next_to, Sink &result)
 {
     RelationIdIterator iterI, iterIBegin, iterIEnd;
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
 
 
     if (this->getBounds(level, ts, te, next_from, next_to, ioffsets, timestamps, iterBegin, iterEnd, iterI))
@@ -1451,11 +1774,7 @@ inline void HINT_M_SubsSort_SS_CM::scanPartitions_CheckOneCondition_Overlaps(uns
         {
             if (qt < iter->second)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iterI++;
         }
@@ -1463,9 +1782,10 @@ inline void HINT_M_SubsSort_SS_CM::scanPartitions_CheckOneCondition_Overlaps(uns
 }
 
 
-inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckTwoConditions3_Overlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckTwoConditions3_Overlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
@@ -1477,11 +1797,7 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckTwoConditions3_Overlaps(un
         {
             if (qstart < iter->first)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= *iterI;
-#endif
+                result.add(*iterI);
             }
             iterI++;
             iter++;
@@ -1490,24 +1806,21 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckTwoConditions3_Overlaps(un
 }
 
 
-inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckAllConditions_Overlapped(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckAllConditions_Overlapped(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
     if (this->getBounds(level, t, next_from, ioffsets, timestamps, iterBegin, iterEnd, iterI))
     {
-        vector<pair< Timestamp, Timestamp> >::iterator pivot = lower_bound(iterBegin, iterEnd, make_pair(qstart, qstart), compare);
+        TimestampPairs::iterator pivot = lower_bound(iterBegin, iterEnd, make_pair(qstart, qstart), compare);
         for (iter = iterBegin; iter != pivot; iter++)
         {
             if ((qstart < iter->second) && (qend > iter->second))
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iterI++;
         }
@@ -1515,9 +1828,10 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckAllConditions_Overlapped(u
 }
 
 
-inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckTwoConditions1_Overlapped(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckTwoConditions1_Overlapped(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
@@ -1527,11 +1841,7 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckTwoConditions1_Overlapped(
         iterI += iter-iterBegin;
         while ((iter != iterEnd) && (qend > iter->second))
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
+            result.add(*iterI);
 
             iter++;
             iterI++;
@@ -1540,24 +1850,21 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckTwoConditions1_Overlapped(
 }
 
 
-inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckTwoConditions2_Overlapped(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckTwoConditions2_Overlapped(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
     if (this->getBounds(level, t, next_from, ioffsets, timestamps, iterBegin, iterEnd, iterI))
     {
-        vector<pair< Timestamp, Timestamp> >::iterator pivot = lower_bound(iterBegin, iterEnd, make_pair(qt, qt), compare);
+        TimestampPairs::iterator pivot = lower_bound(iterBegin, iterEnd, make_pair(qt, qt), compare);
         for (iter = iterBegin; iter != pivot; iter++)
         {
             if (qt < iter->second)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iterI++;
         }
@@ -1565,24 +1872,21 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckTwoConditions2_Overlapped(
 }
 
 
-inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckTwoConditions3_Overlapped(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckTwoConditions3_Overlapped(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
     if (this->getBounds(level, t, next_from, ioffsets, timestamps, iterBegin, iterEnd, iterI))
     {
-        vector<pair< Timestamp, Timestamp> >::iterator pivot = lower_bound(iterBegin, iterEnd, make_pair(qend, qend), compare);
+        TimestampPairs::iterator pivot = lower_bound(iterBegin, iterEnd, make_pair(qend, qend), compare);
         for (iter = iterBegin; iter != pivot; iter++)
         {
             if (qstart > iter->first)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iterI++;
         }
@@ -1590,24 +1894,21 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckTwoConditions3_Overlapped(
 }
 
 
-inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckTwoConditions4_Overlapped(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckTwoConditions4_Overlapped(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
     if (this->getBounds(level, t, next_from, ioffsets, timestamps, iterBegin, iterEnd, iterI))
     {
-        vector<pair< Timestamp, Timestamp> >::iterator pivot = lower_bound(iterBegin, iterEnd, make_pair(qstart, qstart), compare);
+        TimestampPairs::iterator pivot = lower_bound(iterBegin, iterEnd, make_pair(qstart, qstart), compare);
         for (iter = iterBegin; iter != pivot; iter++)
         {
             if (qend > iter->second)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iterI++;
         }
@@ -1615,9 +1916,10 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckTwoConditions4_Overlapped(
 }
 
 
-inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckOneCondition_Overlapped(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, Timestamp qt, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckOneCondition_Overlapped(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, Timestamp qt, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
@@ -1627,11 +1929,7 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckOneCondition_Overlapped(un
         {
             if (qt < iter->second)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iterI++;
         }
@@ -1639,9 +1937,10 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckOneCondition_Overlapped(un
 }
 
 
-inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckOneCondition_Overlapped(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckOneCondition_Overlapped(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
@@ -1651,11 +1950,7 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckOneCondition_Overlapped(un
         iterI += iter-iterBegin;
         while (iter != iterEnd)
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
+            result.add(*iterI);
 
             iter++;
             iterI++;
@@ -1663,9 +1958,10 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckOneCondition_Overlapped(un
     }
 }
 
-inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckEnd_Overlapped(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, Timestamp qend, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckEnd_Overlapped(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, Timestamp qend, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
@@ -1675,11 +1971,7 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckEnd_Overlapped(unsigned in
         {
             if (qend > iter->second)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iterI++;
         }
@@ -1688,10 +1980,11 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckEnd_Overlapped(unsigned in
 
 
 
-inline void HINT_M_SubsSort_SS_CM::scanPartitions_CheckOneCondition_Overlapped(unsigned int level, Timestamp ts, Timestamp te, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, Timestamp qt, PartitionId &next_from, PartitionId &next_to, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartitions_CheckOneCondition_Overlapped(unsigned int level, Timestamp ts, Timestamp te, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, Timestamp qt, PartitionId &next_from, PartitionId &next_to, Sink &result)
 {
     RelationIdIterator iterI, iterIBegin, iterIEnd;
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
 
 
     if (this->getBounds(level, ts, te, next_from, next_to, ioffsets, timestamps, iterBegin, iterEnd, iterI))
@@ -1700,11 +1993,7 @@ inline void HINT_M_SubsSort_SS_CM::scanPartitions_CheckOneCondition_Overlapped(u
         {
             if (qt > iter->first)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iterI++;
         }
@@ -1715,9 +2004,10 @@ inline void HINT_M_SubsSort_SS_CM::scanPartitions_CheckOneCondition_Overlapped(u
 
 
 
-inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckBothTimestamps_Contains(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckBothTimestamps_Contains(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
@@ -1729,11 +2019,7 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckBothTimestamps_Contains(un
         {
             if (qend > iter->second)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iter++;
             iterI++;
@@ -1742,9 +2028,10 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckBothTimestamps_Contains(un
 }
 
 
-inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckStart_Contains(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckStart_Contains(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
@@ -1754,11 +2041,7 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckStart_Contains(unsigned in
         iterI += iter-iterBegin;
         while (iter != iterEnd)
         {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
 
             iter++;
             iterI++;
@@ -1768,10 +2051,11 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckStart_Contains(unsigned in
 
 
 
-inline void HINT_M_SubsSort_SS_CM::scanPartitions_CheckEnd_Contains(unsigned int level, Timestamp ts, Timestamp te, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, Timestamp qt, PartitionId &next_from, PartitionId &next_to, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartitions_CheckEnd_Contains(unsigned int level, Timestamp ts, Timestamp te, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, Timestamp qt, PartitionId &next_from, PartitionId &next_to, Sink &result)
 {
     RelationIdIterator iterI, iterIBegin, iterIEnd;
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
 
 
     if (this->getBounds(level, ts, te, next_from, next_to, ioffsets, timestamps, iterBegin, iterEnd, iterI))
@@ -1780,35 +2064,28 @@ inline void HINT_M_SubsSort_SS_CM::scanPartitions_CheckEnd_Contains(unsigned int
         {
             if (qt > iter->second)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iterI++;
         }
     }
 }
 
-inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckBothTimestamps_Contained(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckBothTimestamps_Contained(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
     if (this->getBounds(level, t, next_from, ioffsets, timestamps, iterBegin, iterEnd, iterI))
     {
-        vector<pair< Timestamp, Timestamp> >::iterator pivot = lower_bound(iterBegin, iterEnd, make_pair(qstart, qstart), compare);
+        TimestampPairs::iterator pivot = lower_bound(iterBegin, iterEnd, make_pair(qstart, qstart), compare);
         for (iter = iterBegin; iter != pivot; iter++)
         {
             if (qend < iter->second)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iterI++;
         }
@@ -1816,32 +2093,25 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckBothTimestamps_Contained(u
 }
 
 
-inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckStart_Contained(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckStart_Contained(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
     if (this->getBounds(level, t, next_from, ioffsets, timestamps, iterBegin, iterEnd, iterI))
     {
-        vector<pair<Timestamp, Timestamp> >::iterator pivot = lower_bound(iterBegin, iterEnd, make_pair(qt, qt), compare);
-        for (iter = iterBegin; iter != pivot; iter++)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
-
-            iterI++;
-        }
+        TimestampPairs::iterator pivot = lower_bound(iterBegin, iterEnd, make_pair(qt, qt), compare);
+        reportIds(this->kernel, iterI, iterI+(pivot-iterBegin), result);
     }
 }
 
 
-inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckEnd_Contained(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckEnd_Contained(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
@@ -1851,11 +2121,7 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckEnd_Contained(unsigned int
         iterI += iter-iterBegin;
         while (iter != iterEnd)
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= *iterI;
-#endif
+            result.add(*iterI);
 
             iterI++;
             iter++;
@@ -1864,9 +2130,10 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckEnd_Contained(unsigned int
 }
 
 
-inline void HINT_M_SubsSort_SS_CM::scanPartition_Precedes(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartition_Precedes(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
@@ -1876,11 +2143,7 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_Precedes(unsigned int level, Ti
         iterI += iter-iterBegin;
         while (iter != iterEnd)
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
+            result.add(*iterI);
 
             iterI++;
             iter++;
@@ -1889,28 +2152,23 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_Precedes(unsigned int level, Ti
 }
 
 
-inline void HINT_M_SubsSort_SS_CM::scanPartitions_Precedes(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartitions_Precedes(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, PartitionId &next_from, Sink &result)
 {
     RelationIdIterator iterI, iterIBegin, iterIEnd;
 
 
     if (this->getBoundsS(level, t, next_from, ioffsets, timestamps, iterIBegin, iterIEnd))
     {
-        for (iterI = iterIBegin; iterI != iterIEnd; iterI++)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= *iterI;
-#endif
-        }
+        reportIds(this->kernel, iterIBegin, iterIEnd, result);
     }
 }
 
 
-inline void HINT_M_SubsSort_SS_CM::scanPartition_Preceded(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, Timestamp qt, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartition_Preceded(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, Timestamp qt, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
@@ -1920,11 +2178,7 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_Preceded(unsigned int level, Ti
         {
             if (qt > iter->second)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iterI++;
         }
@@ -1932,100 +2186,69 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_Preceded(unsigned int level, Ti
 }
 
 
-inline void HINT_M_SubsSort_SS_CM::scanPartition_Preceded(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartition_Preceded(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
     if (this->getBounds(level, t, next_from, ioffsets, timestamps, iterBegin, iterEnd, iterI))
     {
-        vector<pair<Timestamp, Timestamp> >::iterator pivot = lower_bound(iterBegin, iterEnd, make_pair(qt, qt), compare);
-        for (iter = iterBegin; iter != pivot; iter++)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= *iterI;
-#endif
-
-            iterI++;
-        }
+        TimestampPairs::iterator pivot = lower_bound(iterBegin, iterEnd, make_pair(qt, qt), compare);
+        reportIds(this->kernel, iterI, iterI+(pivot-iterBegin), result);
     }
 }
 
 
-inline void HINT_M_SubsSort_SS_CM::scanPartitions_Preceded(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, RelationId *ids, vector<pair<Timestamp, Timestamp> > *timestamps, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartitions_Preceded(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, RelationId *ids, TimestampPairs *timestamps, PartitionId &next_from, Sink &result)
 {
     RelationIdIterator iterI, iterIBegin, iterIEnd;
 
 
     if (this->getBoundsE(level, t, next_from, ioffsets, ids, timestamps, iterIBegin, iterIEnd))
     {
-        for (iterI = iterIBegin; iterI != iterIEnd; iterI++)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
-        }
+        reportIds(this->kernel, iterIBegin, iterIEnd, result);
     }
 }
 
 
-inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckBothTimestamps_gOverlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckBothTimestamps_gOverlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, RelationId *ids, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qstart, Timestamp qend, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
     if (this->getBounds(level, t, next_from, ioffsets, timestamps, iterBegin, iterEnd, iterI))
     {
-        vector<pair<Timestamp, Timestamp> >::iterator pivot = lower_bound(iterBegin, iterEnd, make_pair(qend+1, qend+1), compare);
-        for (iter = iterBegin; iter != pivot; iter++)
-        {
-            if (qstart <= iter->second)
-            {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
-            }
-            iterI++;
-        }
+        TimestampPairs::iterator pivot = lower_bound(iterBegin, iterEnd, make_pair(qend+1, qend+1), compare);
+        auto pos = iterBegin-timestamps[level].begin();
+        scanNotBefore(this->kernel, timestamps[level].ends.data()+pos, ids[level].data()+pos, pivot-iterBegin, qstart, result);
     }
 }
 
 
-inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckEnd_gOverlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, Timestamp qt, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckEnd_gOverlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, RelationId *ids, Timestamp qt, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
     if (this->getBounds(level, t, next_from, ioffsets, timestamps, iterBegin, iterEnd, iterI))
     {
-        for (iter = iterBegin; iter != iterEnd; iter++)
-        {
-            if (qt <= iter->second)
-            {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
-            }
-            iterI++;
-        }
+        auto pos = iterBegin-timestamps[level].begin();
+        scanNotBefore(this->kernel, timestamps[level].ends.data()+pos, ids[level].data()+pos, iterEnd-iterBegin, qt, result);
     }
 }
 
 
-inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckEnd_gOverlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckEnd_gOverlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
@@ -2035,11 +2258,7 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckEnd_gOverlaps(unsigned int
         iterI += iter-iterBegin;
         while (iter != iterEnd)
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
+            result.add(*iterI);
 
             iter++;
             iterI++;
@@ -2048,50 +2267,37 @@ inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckEnd_gOverlaps(unsigned int
 }
 
 
-inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckStart_gOverlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartition_CheckStart_gOverlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, bool (*compare)(const pair<Timestamp, Timestamp>&, const pair<Timestamp, Timestamp>&), Timestamp qt, PartitionId &next_from, Sink &result)
 {
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
 
 
     if (this->getBounds(level, t, next_from, ioffsets, timestamps, iterBegin, iterEnd, iterI))
     {
-        vector<pair<Timestamp, Timestamp> >::iterator pivot = lower_bound(iterBegin, iterEnd, make_pair(qt+1, qt+1), compare);
-        for (iter = iterBegin; iter != pivot; iter++)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
-
-            iterI++;
-        }
+        TimestampPairs::iterator pivot = lower_bound(iterBegin, iterEnd, make_pair(qt+1, qt+1), compare);
+        reportIds(this->kernel, iterI, iterI+(pivot-iterBegin), result);
     }
 }
 
 
-inline bool getBounds(unsigned int level, Timestamp t, PartitionId &next_from, Offsets_SS_CM *ioffsets, vector<pair<Timestamp, Timestamp> > *timestamps, RelationIdIterator &iterIBegin, RelationIdIterator &iterIEnd);
-inline void HINT_M_SubsSort_SS_CM::scanPartition_NoChecks_gOverlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, RelationId *ids, PartitionId &next_from, size_t &result)
+inline bool getBounds(unsigned int level, Timestamp t, PartitionId &next_from, Offsets_SS_CM *ioffsets, TimestampPairs *timestamps, RelationIdIterator &iterIBegin, RelationIdIterator &iterIEnd);
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartition_NoChecks_gOverlaps(unsigned int level, Timestamp t, Offsets_SS_CM *ioffsets, RelationId *ids, PartitionId &next_from, Sink &result)
 {
     RelationIdIterator iterI, iterIBegin, iterIEnd;
 
 
     if (this->getBounds(level, t, next_from, ioffsets, ids, iterIBegin, iterIEnd))
     {
-        for (iterI = iterIBegin; iterI != iterIEnd; iterI++)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
-        }
+        reportIds(this->kernel, iterIBegin, iterIEnd, result);
     }
 }
 
 
-inline void HINT_M_SubsSort_SS_CM::scanPartitions_NoChecks_gOverlaps(unsigned int level, Timestamp ts, Timestamp te, Offsets_SS_CM *ioffsets, RelationId *ids, PartitionId &next_from, PartitionId &next_to, size_t &result)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::scanPartitions_NoChecks_gOverlaps(unsigned int level, Timestamp ts, Timestamp te, Offsets_SS_CM *ioffsets, RelationId *ids, PartitionId &next_from, PartitionId &next_to, Sink &result)
 {
     RelationIdIterator iterI, iterIBegin, iterIEnd;
     OffsetEntry_SS_CM qdummyTS, qdummyTE;
@@ -2099,23 +2305,16 @@ inline void HINT_M_SubsSort_SS_CM::scanPartitions_NoChecks_gOverlaps(unsigned in
 
     if (this->getBounds(level, ts, te, next_from, next_to, ioffsets, ids, iterIBegin, iterIEnd))
     {
-        for (iterI = iterIBegin; iterI != iterIEnd; iterI++)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
-        }
+        reportIds(this->kernel, iterIBegin, iterIEnd, result);
     }
 }
 
 
 // Basic predicates of Allen's algebra
-size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Equals(RangeQuery Q)
+template <class Sink>
+void HINT_M_SubsSort_SS_CM::executeBottomUp_Equals(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
     Timestamp a = Q.start >> (this->maxBits-this->numBits); // prefix
     Timestamp b = Q.end >> (this->maxBits-this->numBits); // prefix
@@ -2129,6 +2328,16 @@ size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Equals(RangeQuery Q)
     short int level = 0, a_level = -1, b_level = -1;
 
 
+    // Records erased since the last purge, see HierarchicalIndex::erase()
+    if (this->skipErased(result, [&](auto &filtered) {this->executeBottomUp_Equals(Q, filtered);}))
+        return;
+
+    // Records inserted since the last merge, see HierarchicalIndex::insert()
+    this->delta.execute_Equals(this->kernel, Q, result);
+
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_Equals(this->kernel, Q, result);
+
     while (level < this->height && a <= b)
     {
         if (a%2)
@@ -2189,7 +2398,7 @@ size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Equals(RangeQuery Q)
         this->scanPartition_CheckBothTimestamps_Equals(a_level, a_partition, this->pOrgsAft_ioffsets, this->pOrgsAftTimestamps, CompareTimestampPairsByStart, Q.start, Q.end, next_fromOaftA, result);
     }
 
-    return result;
+    return;
 //
 //    for (auto l = 0; l < this->numBits; l++)
 //    {
@@ -2229,16 +2438,23 @@ size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Equals(RangeQuery Q)
 //            iterI++;
 //        }
 //    }
+}
 
 
-    return result;
+size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Equals(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_Equals(Q, result);
+    
+    return result.get();
 }
 
 
-size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Starts(RangeQuery Q)
+template <class Sink>
+void HINT_M_SubsSort_SS_CM::executeBottomUp_Starts(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
     Timestamp a = Q.start >> (this->maxBits-this->numBits); // prefix
     Timestamp b = Q.end >> (this->maxBits-this->numBits); // prefix
@@ -2247,6 +2463,16 @@ size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Starts(RangeQuery Q)
     PartitionId next_fromOinA = -1, next_fromOaftA = -1;
 
 
+    // Records erased since the last purge, see HierarchicalIndex::erase()
+    if (this->skipErased(result, [&](auto &filtered) {this->executeBottomUp_Starts(Q, filtered);}))
+        return;
+
+    // Records inserted since the last merge, see HierarchicalIndex::insert()
+    this->delta.execute_Starts(this->kernel, Q, result);
+
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_Starts(this->kernel, Q, result);
+
     for (auto l = 0; l < this->numBits; l++)
     {
 //        if (foundone && foundzero)
@@ -2283,26 +2509,29 @@ size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Starts(RangeQuery Q)
         {
             if (Q.end < iter->second)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iter++;
             iterI++;
         }
     }
+}
 
 
-    return result;
+size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Starts(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_Starts(Q, result);
+    
+    return result.get();
 }
 
 
-size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Started(RangeQuery Q)
+template <class Sink>
+void HINT_M_SubsSort_SS_CM::executeBottomUp_Started(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
     Timestamp a = Q.start >> (this->maxBits-this->numBits); // prefix
     Timestamp b = Q.end >> (this->maxBits-this->numBits); // prefix
@@ -2311,6 +2540,16 @@ size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Started(RangeQuery Q)
     PartitionId next_fromOinA = -1, next_fromOaftA = -1;
 
 
+    // Records erased since the last purge, see HierarchicalIndex::erase()
+    if (this->skipErased(result, [&](auto &filtered) {this->executeBottomUp_Started(Q, filtered);}))
+        return;
+
+    // Records inserted since the last merge, see HierarchicalIndex::insert()
+    this->delta.execute_Started(this->kernel, Q, result);
+
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_Started(this->kernel, Q, result);
+
     for (auto l = 0; l < this->numBits; l++)
     {
 //        if (foundone && foundzero)
@@ -2347,26 +2586,29 @@ size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Started(RangeQuery Q)
         {
             if (Q.end > iter->second)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iter++;
             iterI++;
         }
     }
+}
 
 
-    return result;
+size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Started(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_Started(Q, result);
+    
+    return result.get();
 }
 
 
-size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Finishes(RangeQuery Q)
+template <class Sink>
+void HINT_M_SubsSort_SS_CM::executeBottomUp_Finishes(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
     Timestamp a = Q.start >> (this->maxBits-this->numBits); // prefix
     Timestamp b = Q.end >> (this->maxBits-this->numBits); // prefix
@@ -2375,6 +2617,16 @@ size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Finishes(RangeQuery Q)
     PartitionId next_fromOinB = -1, next_fromRinB = -1;
 
 
+    // Records erased since the last purge, see HierarchicalIndex::erase()
+    if (this->skipErased(result, [&](auto &filtered) {this->executeBottomUp_Finishes(Q, filtered);}))
+        return;
+
+    // Records inserted since the last merge, see HierarchicalIndex::insert()
+    this->delta.execute_Finishes(this->kernel, Q, result);
+
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_Finishes(this->kernel, Q, result);
+
     for (auto l = 0; l < this->numBits; l++)
     {
 //        if (foundone && foundzero)
@@ -2405,30 +2657,33 @@ size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Finishes(RangeQuery Q)
         iterI = this->pOrgsInIds[this->numBits].begin();
         iterBegin = this->pOrgsInTimestamps[this->numBits].begin();
         iterEnd = this->pOrgsInTimestamps[this->numBits].end();
-        vector<pair<Timestamp, Timestamp> >::iterator pivot = lower_bound(iterBegin, iterEnd, make_pair(Q.start, Q.start), CompareTimestampPairsByStart);
+        TimestampPairs::iterator pivot = lower_bound(iterBegin, iterEnd, make_pair(Q.start, Q.start), CompareTimestampPairsByStart);
         for (iter = iterBegin; iter != pivot; iter++)
         {
             if (Q.end == iter->second)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= *iterI;
-#endif
+                result.add(*iterI);
             }
             iterI++;
         }
     }
+}
 
 
-    return result;
+size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Finishes(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_Finishes(Q, result);
+    
+    return result.get();
 }
 
 
-size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Finished(RangeQuery Q)
+template <class Sink>
+void HINT_M_SubsSort_SS_CM::executeBottomUp_Finished(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
     Timestamp a = Q.start >> (this->maxBits-this->numBits); // prefix
     Timestamp b = Q.end >> (this->maxBits-this->numBits); // prefix
@@ -2437,6 +2692,16 @@ size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Finished(RangeQuery Q)
     PartitionId next_fromOinB = -1, next_fromRinB = -1;
 
 
+    // Records erased since the last purge, see HierarchicalIndex::erase()
+    if (this->skipErased(result, [&](auto &filtered) {this->executeBottomUp_Finished(Q, filtered);}))
+        return;
+
+    // Records inserted since the last merge, see HierarchicalIndex::insert()
+    this->delta.execute_Finished(this->kernel, Q, result);
+
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_Finished(this->kernel, Q, result);
+
     for (auto l = 0; l < this->numBits; l++)
     {
 //        if (foundone && foundzero)
@@ -2473,26 +2738,29 @@ size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Finished(RangeQuery Q)
         {
             if (Q.end == iter->second)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= *iterI;
-#endif
+                result.add(*iterI);
             }
             iter++;
             iterI++;
         }
     }
+}
 
 
-    return result;
+size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Finished(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_Finished(Q, result);
+    
+    return result.get();
 }
 
 
-size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Meets(RangeQuery Q)
+template <class Sink>
+void HINT_M_SubsSort_SS_CM::executeBottomUp_Meets(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
     Timestamp b = Q.end >> (this->maxBits-this->numBits); // prefix
     pair<Timestamp, Timestamp> qdummyE(Q.end, Q.end);
@@ -2501,6 +2769,16 @@ size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Meets(RangeQuery Q)
     PartitionId next_fromOinB = -1, next_fromOaftB = -1;
 
 
+    // Records erased since the last purge, see HierarchicalIndex::erase()
+    if (this->skipErased(result, [&](auto &filtered) {this->executeBottomUp_Meets(Q, filtered);}))
+        return;
+
+    // Records inserted since the last merge, see HierarchicalIndex::insert()
+    this->delta.execute_Meets(this->kernel, Q, result);
+
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_Meets(this->kernel, Q, result);
+
     for (auto l = 0; l < this->numBits; l++)
     {
 //        if (foundone && foundzero)
@@ -2530,26 +2808,29 @@ size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Meets(RangeQuery Q)
         iterI += iter-iterBegin;
         while ((iter != iterEnd) && (Q.end == iter->first))
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
+            result.add(*iterI);
 
             iter++;
             iterI++;
         }
     }
+}
 
 
-    return result;
+size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Meets(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_Meets(Q, result);
+    
+    return result.get();
 }
 
 
-size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Met(RangeQuery Q)
+template <class Sink>
+void HINT_M_SubsSort_SS_CM::executeBottomUp_Met(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
     Timestamp a = Q.start >> (this->maxBits-this->numBits); // prefix
     pair<Timestamp, Timestamp> qdummyE(Q.start, Q.start);
@@ -2558,6 +2839,16 @@ size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Met(RangeQuery Q)
     PartitionId next_fromOinA = -1, next_fromRinA = -1;
 
 
+    // Records erased since the last purge, see HierarchicalIndex::erase()
+    if (this->skipErased(result, [&](auto &filtered) {this->executeBottomUp_Met(Q, filtered);}))
+        return;
+
+    // Records inserted since the last merge, see HierarchicalIndex::insert()
+    this->delta.execute_Met(this->kernel, Q, result);
+
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_Met(this->kernel, Q, result);
+
     for (auto l = 0; l < this->numBits; l++)
     {
 //        if (foundone && foundzero)
@@ -2587,25 +2878,28 @@ size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Met(RangeQuery Q)
         {
             if (Q.start == iter->second)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iterI++;
         }
     }
+}
 
 
-    return result;
+size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Met(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_Met(Q, result);
+    
+    return result.get();
 }
 
 
-size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Overlaps(RangeQuery Q)
+template <class Sink>
+void HINT_M_SubsSort_SS_CM::executeBottomUp_Overlaps(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI, iterIBegin, iterIEnd;
     Timestamp a = Q.start >> (this->maxBits-this->numBits); // prefix
     Timestamp b = Q.end   >> (this->maxBits-this->numBits); // prefix
@@ -2614,12 +2908,22 @@ size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Overlaps(RangeQuery Q)
     PartitionId next_fromOinA = -1, next_fromOaftA = -1, next_fromRinA = -1, next_fromRaftA = -1, next_fromOinB = -1, next_fromOaftB = -1, next_fromOinAB = -1, next_toOinAB = -1, next_fromOaftAB = -1, next_toOaftAB = -1, next_fromR = -1, next_fromO = -1, next_toO = -1, next_fromRinB = -1, next_fromRaftB = -1;
 
 
+    // Records erased since the last purge, see HierarchicalIndex::erase()
+    if (this->skipErased(result, [&](auto &filtered) {this->executeBottomUp_Overlaps(Q, filtered);}))
+        return;
+
+    // Records inserted since the last merge, see HierarchicalIndex::insert()
+    this->delta.execute_Overlaps(this->kernel, Q, result);
+
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_Overlaps(this->kernel, Q, result);
+
     for (auto l = 0; l < this->numBits; l++)
     {
         if (foundone && foundzero)
         {
             if (a == b)
-                return result;
+                return;
 
             this->scanPartition_CheckOneCondition_Overlaps(l, b, this->pOrgsIn_ioffsets, this->pOrgsInTimestamps, CompareTimestampPairsByStart, Q.end, next_fromOinB, result);
             this->scanPartition_CheckOneCondition_Overlaps(l, b, this->pOrgsAft_ioffsets, this->pOrgsAftTimestamps, CompareTimestampPairsByStart, Q.end, next_fromOaftB, result);
@@ -2672,14 +2976,7 @@ size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Overlaps(RangeQuery Q)
         // All contents are guaranteed to be results
         iterIBegin = this->pOrgsInIds[this->numBits].begin();
         iterIEnd = this->pOrgsInIds[this->numBits].end();
-        for (iterI = iterIBegin; iterI != iterIEnd; iterI++)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
-        }
+        reportIds(this->kernel, iterIBegin, iterIEnd, result);
     }
     else
     {
@@ -2693,26 +2990,29 @@ size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Overlaps(RangeQuery Q)
         {
             if (Q.end < iter->second)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iter++;
             iterI++;
         }
     }
+}
 
 
-    return result;
+size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Overlaps(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_Overlaps(Q, result);
+    
+    return result.get();
 }
 
 
-size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Overlapped(RangeQuery Q)
+template <class Sink>
+void HINT_M_SubsSort_SS_CM::executeBottomUp_Overlapped(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI, iterIBegin, iterIEnd;
     Timestamp a = Q.start >> (this->maxBits-this->numBits); // prefix
     Timestamp b = Q.end   >> (this->maxBits-this->numBits); // prefix
@@ -2721,12 +3021,22 @@ size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Overlapped(RangeQuery Q)
     PartitionId next_fromOinA = -1, next_fromOaftA = -1, next_fromRinA = -1, next_fromRaftA = -1, next_fromOinB = -1, next_fromRinB = -1, next_fromOinAB = -1, next_toOinAB = -1, next_fromRinAB = -1, next_toRinAB = -1, next_fromR = -1, next_fromO = -1, next_toO = -1;
 
 
+    // Records erased since the last purge, see HierarchicalIndex::erase()
+    if (this->skipErased(result, [&](auto &filtered) {this->executeBottomUp_Overlapped(Q, filtered);}))
+        return;
+
+    // Records inserted since the last merge, see HierarchicalIndex::insert()
+    this->delta.execute_Overlapped(this->kernel, Q, result);
+
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_Overlapped(this->kernel, Q, result);
+
     for (auto l = 0; l < this->numBits; l++)
     {
         if (foundone && foundzero)
         {
             if (a == b)
-                return result;
+                return;
 
             this->scanPartition_CheckOneCondition_Overlapped(l, a, this->pOrgsIn_ioffsets, this->pOrgsInTimestamps, Q.start, next_fromOinA, result);
             this->scanPartition_CheckOneCondition_Overlapped(l, a, this->pRepsIn_ioffsets, this->pRepsInTimestamps, CompareTimestampPairsByEnd, Q.start, next_fromRinA, result);
@@ -2789,14 +3099,7 @@ size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Overlapped(RangeQuery Q)
         // All contents are guaranteed to be results
         iterIBegin = this->pOrgsInIds[this->numBits].begin();
         iterIEnd = this->pOrgsInIds[this->numBits].end();
-        for (iterI = iterIBegin; iterI != iterIEnd; iterI++)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
-        }
+        reportIds(this->kernel, iterIBegin, iterIEnd, result);
     }
     else
     {
@@ -2804,30 +3107,33 @@ size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Overlapped(RangeQuery Q)
         iterI = this->pOrgsInIds[this->numBits].begin();
         iterBegin = this->pOrgsInTimestamps[this->numBits].begin();
         iterEnd = this->pOrgsInTimestamps[this->numBits].end();
-        vector<pair< Timestamp, Timestamp> >::iterator pivot = lower_bound(iterBegin, iterEnd, make_pair(Q.start, Q.start), CompareTimestampPairsByStart);
+        TimestampPairs::iterator pivot = lower_bound(iterBegin, iterEnd, make_pair(Q.start, Q.start), CompareTimestampPairsByStart);
         for (iter = iterBegin; iter != pivot; iter++)
         {
             if ((Q.start < iter->second) && (Q.end > iter->second))
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iterI++;
         }
     }
+}
 
 
-    return result;
+size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Overlapped(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_Overlapped(Q, result);
+    
+    return result.get();
 }
 
 
-size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Contains(RangeQuery Q)
+template <class Sink>
+void HINT_M_SubsSort_SS_CM::executeBottomUp_Contains(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
     Timestamp a = Q.start >> (this->maxBits-this->numBits); // prefix
     Timestamp b = Q.end >> (this->maxBits-this->numBits); // prefix
@@ -2836,6 +3142,16 @@ size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Contains(RangeQuery Q)
     PartitionId next_fromOinA = -1, next_fromOaftA = -1, next_fromOinB = -1, next_fromOinAB = -1, next_toOinAB = -1, next_fromOaftAB = -1, next_toOaftAB = -1;
 
 
+    // Records erased since the last purge, see HierarchicalIndex::erase()
+    if (this->skipErased(result, [&](auto &filtered) {this->executeBottomUp_Contains(Q, filtered);}))
+        return;
+
+    // Records inserted since the last merge, see HierarchicalIndex::insert()
+    this->delta.execute_Contains(this->kernel, Q, result);
+
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_Contains(this->kernel, Q, result);
+
     for (auto l = 0; l < this->numBits; l++)
     {
         if (foundone && foundzero)
@@ -2889,26 +3205,29 @@ size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Contains(RangeQuery Q)
         {
             if (Q.end > iter->second)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iter++;
             iterI++;
         }
     }
+}
 
 
-    return result;
+size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Contains(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_Contains(Q, result);
+    
+    return result.get();
 }
 
 
-size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Contained(RangeQuery Q)
+template <class Sink>
+void HINT_M_SubsSort_SS_CM::executeBottomUp_Contained(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI;
     Timestamp a = Q.start >> (this->maxBits-this->numBits); // prefix
     Timestamp b = Q.end >> (this->maxBits-this->numBits); // prefix
@@ -2917,6 +3236,16 @@ size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Contained(RangeQuery Q)
     PartitionId next_fromOinA = -1, next_fromOaftA = -1, next_fromRinA = -1, next_fromRaftA = -1;
 
 
+    // Records erased since the last purge, see HierarchicalIndex::erase()
+    if (this->skipErased(result, [&](auto &filtered) {this->executeBottomUp_Contained(Q, filtered);}))
+        return;
+
+    // Records inserted since the last merge, see HierarchicalIndex::insert()
+    this->delta.execute_Contained(this->kernel, Q, result);
+
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_Contained(this->kernel, Q, result);
+
     for (auto l = 0; l < this->numBits; l++)
     {
 //        if (foundone && foundzero)
@@ -2948,30 +3277,33 @@ size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Contained(RangeQuery Q)
         // Comparisons needed
     iterI = this->pOrgsInIds[this->numBits].begin();
     iterBegin = this->pOrgsInTimestamps[this->numBits].begin();
-    vector<pair< Timestamp, Timestamp> >::iterator pivot = lower_bound(iterBegin, this->pOrgsInTimestamps[this->numBits].end(), make_pair(Q.start, Q.start), CompareTimestampPairsByStart);
+    TimestampPairs::iterator pivot = lower_bound(iterBegin, this->pOrgsInTimestamps[this->numBits].end(), make_pair(Q.start, Q.start), CompareTimestampPairsByStart);
     for (iter = iterBegin; iter != pivot; iter++)
     {
         if (Q.end < iter->second)
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
+            result.add(*iterI);
         }
         iterI++;
     }
 //    }
+}
 
 
-    return result;
+size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Contained(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_Contained(Q, result);
+    
+    return result.get();
 }
 
 
-size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Precedes(RangeQuery Q)
+template <class Sink>
+void HINT_M_SubsSort_SS_CM::executeBottomUp_Precedes(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI, iterIBegin, iterIEnd;
     Timestamp b = Q.end >> (this->maxBits-this->numBits); // prefix
     bool foundzero = false;
@@ -2979,6 +3311,16 @@ size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Precedes(RangeQuery Q)
     PartitionId next_fromOinB = -1, next_fromOaftB = -1, next_fromOinAB = -1, next_fromOaftAB = -1;
 
 
+    // Records erased since the last purge, see HierarchicalIndex::erase()
+    if (this->skipErased(result, [&](auto &filtered) {this->executeBottomUp_Precedes(Q, filtered);}))
+        return;
+
+    // Records inserted since the last merge, see HierarchicalIndex::insert()
+    this->delta.execute_Precedes(this->kernel, Q, result);
+
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_Precedes(this->kernel, Q, result);
+
     for (auto l = 0; l < this->numBits; l++)
     {
 //        if (!(foundone && foundzero))
@@ -3014,11 +3356,7 @@ size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Precedes(RangeQuery Q)
         iterI += iter-iterBegin;
         while (iter != iterEnd)
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
+            result.add(*iterI);
 
             iter++;
             iterI++;
@@ -3028,25 +3366,25 @@ size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Precedes(RangeQuery Q)
     {
         iterIBegin = this->pOrgsInIds[this->numBits].begin();
         iterIEnd = this->pOrgsInIds[this->numBits].end();
-        for (iterI = iterIBegin; iterI != iterIEnd; iterI++)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
-        }
+        reportIds(this->kernel, iterIBegin, iterIEnd, result);
     }
+}
 
 
-    return result;
+size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Precedes(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_Precedes(Q, result);
+    
+    return result.get();
 }
 
 
-size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Preceded(RangeQuery Q)
+template <class Sink>
+void HINT_M_SubsSort_SS_CM::executeBottomUp_Preceded(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI, iterIBegin, iterIEnd;
     Timestamp a = Q.start >> (this->maxBits-this->numBits); // prefix
     bool foundzero = false;
@@ -3054,6 +3392,16 @@ size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Preceded(RangeQuery Q)
     PartitionId next_fromOinA = -1, next_fromRinA = -1, next_fromOinAB = -1, next_fromRinAB = -1;
 
 
+    // Records erased since the last purge, see HierarchicalIndex::erase()
+    if (this->skipErased(result, [&](auto &filtered) {this->executeBottomUp_Preceded(Q, filtered);}))
+        return;
+
+    // Records inserted since the last merge, see HierarchicalIndex::insert()
+    this->delta.execute_Preceded(this->kernel, Q, result);
+
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_Preceded(this->kernel, Q, result);
+
     for (auto l = 0; l < this->numBits; l++)
     {
 //        if (!(foundone && foundzero))
@@ -3092,11 +3440,7 @@ size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Preceded(RangeQuery Q)
         {
             if (Q.start > iter->second)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
+                result.add(*iterI);
             }
             iterI++;
         }
@@ -3105,26 +3449,26 @@ size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Preceded(RangeQuery Q)
     {
         iterIBegin = this->pOrgsInIds[this->numBits].begin();
         iterIEnd = this->pOrgsInIds[this->numBits].end();
-        for (iterI = iterIBegin; iterI != iterIEnd; iterI++)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
-        }
+        reportIds(this->kernel, iterIBegin, iterIEnd, result);
     }
+}
 
 
-    return result;
+size_t HINT_M_SubsSort_SS_CM::executeBottomUp_Preceded(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_Preceded(Q, result);
+    
+    return result.get();
 }
 
 
 // Generalized predicates, ACM SIGMOD'22 gOverlaps
-size_t HINT_M_SubsSort_SS_CM::executeBottomUp_gOverlaps(RangeQuery Q)
+template <class Sink>
+inline void HINT_M_SubsSort_SS_CM::executeBottomUp_gOverlaps(RangeQuery Q, gOverlapsSweep *sweep, Sink &result)
 {
-    size_t result = 0;
-    vector<pair<Timestamp, Timestamp> >::iterator iter, iterBegin, iterEnd;
+    TimestampPairs::iterator iter, iterBegin, iterEnd;
     RelationIdIterator iterI, iterIBegin, iterIEnd;
     Timestamp a = Q.start >> (this->maxBits-this->numBits); // prefix
     Timestamp b = Q.end   >> (this->maxBits-this->numBits); // prefix
@@ -3133,6 +3477,36 @@ size_t HINT_M_SubsSort_SS_CM::executeBottomUp_gOverlaps(RangeQuery Q)
     PartitionId next_fromOinA = -1, next_fromOaftA = -1, next_fromRinA = -1, next_fromRaftA = -1, next_fromOinB = -1, next_fromOaftB = -1, next_fromOinAB = -1, next_toOinAB = -1, next_fromOaftAB = -1, next_toOaftAB = -1, next_fromR = -1, next_fromO = -1, next_toO = -1;
 
 
+    // Records erased since the last purge, see HierarchicalIndex::erase()
+    if (this->skipErased(result, [&](auto &filtered) {this->executeBottomUp_gOverlaps(Q, sweep, filtered);}))
+        return;
+
+    // Records inserted since the last merge, see HierarchicalIndex::insert()
+    this->delta.execute_gOverlaps(this->kernel, Q, result);
+
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_gOverlaps(this->kernel, Q, result);
+
+    // Within a batch, start the bottom level from where the previous query
+    // left the offsets instead of binary searching them
+    if (sweep != NULL)
+    {
+        next_fromOinA  = sweep->OinA.from(this->pOrgsIn_ioffsets[0], a);
+        next_fromOaftA = sweep->OaftA.from(this->pOrgsAft_ioffsets[0], a);
+        next_fromRinA  = sweep->RinA.from(this->pRepsIn_ioffsets[0], a);
+        next_fromRaftA = sweep->RaftA.from(this->pRepsAft_ioffsets[0], a);
+        if (a < b)
+        {
+            next_fromOinAB  = sweep->OinAB.from(this->pOrgsIn_ioffsets[0], a+1);
+            next_toOinAB    = sweep->toOinAB.to(this->pOrgsIn_ioffsets[0], b-1);
+            next_fromOaftAB = sweep->OaftAB.from(this->pOrgsAft_ioffsets[0], a+1);
+            next_toOaftAB   = sweep->toOaftAB.to(this->pOrgsAft_ioffsets[0], b-1);
+            next_fromOinB   = sweep->OinB.from(this->pOrgsIn_ioffsets[0], b);
+            next_fromOaftB  = sweep->OaftB.from(this->pOrgsAft_ioffsets[0], b);
+        }
+    }
+
+
     for (auto l = 0; l < this->numBits; l++)
     {
         if (foundone && foundzero)
@@ -3155,13 +3529,13 @@ size_t HINT_M_SubsSort_SS_CM::executeBottomUp_gOverlaps(RangeQuery Q)
             if (a == b)
             {
                 // Special case when query overlaps only one partition, Lemma 3
-                this->scanPartition_CheckBothTimestamps_gOverlaps(l, a, this->pOrgsIn_ioffsets, this->pOrgsInTimestamps, CompareTimestampPairsByStart, Q.start, Q.end, next_fromOinA, result);
+                this->scanPartition_CheckBothTimestamps_gOverlaps(l, a, this->pOrgsIn_ioffsets, this->pOrgsInTimestamps, this->pOrgsInIds, CompareTimestampPairsByStart, Q.start, Q.end, next_fromOinA, result);
                 this->scanPartition_CheckStart_gOverlaps(l, a, this->pOrgsAft_ioffsets, this->pOrgsAftTimestamps, CompareTimestampPairsByStart, Q.end, next_fromOaftA, result);
             }
             else
             {
                 // Lemma 1
-                this->scanPartition_CheckEnd_gOverlaps(l, a, this->pOrgsIn_ioffsets, this->pOrgsInTimestamps, Q.start, next_fromOinA, result);
+                this->scanPartition_CheckEnd_gOverlaps(l, a, this->pOrgsIn_ioffsets, this->pOrgsInTimestamps, this->pOrgsInIds, Q.start, next_fromOinA, result);
                 this->scanPartition_NoChecks_gOverlaps(l, a, this->pOrgsAft_ioffsets, this->pOrgsAftIds, next_fromOaftA, result);
             }
 
@@ -3195,35 +3569,79 @@ size_t HINT_M_SubsSort_SS_CM::executeBottomUp_gOverlaps(RangeQuery Q)
         // All contents are guaranteed to be results
         iterIBegin = this->pOrgsInIds[this->numBits].begin();
         iterIEnd = this->pOrgsInIds[this->numBits].end();
-        for (iterI = iterIBegin; iterI != iterIEnd; iterI++)
-        {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= (*iterI);
-#endif
-        }
+        reportIds(this->kernel, iterIBegin, iterIEnd, result);
     }
     else
     {
         // Comparisons needed
-        iterI = this->pOrgsInIds[this->numBits].begin();
         iterBegin = this->pOrgsInTimestamps[this->numBits].begin();
         iterEnd = lower_bound(iterBegin, this->pOrgsInTimestamps[this->numBits].end(), make_pair<Timestamp, Timestamp>(Q.end+1, Q.end+1), CompareTimestampPairsByStart);
-        for (iter = iterBegin; iter != iterEnd; iter++)
-        {
-            if (Q.start <= iter->second)
-            {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= (*iterI);
-#endif
-            }
-            iterI++;
-        }
+        scanNotBefore(this->kernel, this->pOrgsInTimestamps[this->numBits].ends.data(), this->pOrgsInIds[this->numBits].data(), iterEnd-iterBegin, Q.start, result);
     }
+}
+
+
+template <class Sink>
+void HINT_M_SubsSort_SS_CM::executeBottomUp_gOverlaps(RangeQuery Q, Sink &result)
+{
+    this->executeBottomUp_gOverlaps(Q, NULL, result);
+}
+
+
+size_t HINT_M_SubsSort_SS_CM::executeBottomUp_gOverlaps(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_gOverlaps(Q, result);
+    
+    return result.get();
+}
 
 
-    return result;
+// Querying a batch; the queries are evaluated in the order of their start,
+// sharing the cursors over the bottom-level offsets, see gOverlapsSweep.
+template <class Sink>
+void HINT_M_SubsSort_SS_CM::executeBottomUp_gOverlaps(const vector<RangeQuery> &queries, vector<Sink> &results)
+{
+    vector<size_t> order;
+    gOverlapsSweep sweep;
+    
+    
+    this->getBatchOrder(queries, order);
+    for (auto i : order)
+        this->executeBottomUp_gOverlaps(queries[i], &sweep, results[i]);
 }
+
+
+void HINT_M_SubsSort_SS_CM::executeBottomUp_gOverlaps(const vector<RangeQuery> &queries, vector<size_t> &results)
+{
+    vector<WorkloadSink> sinks(queries.size());
+    
+    
+    this->executeBottomUp_gOverlaps(queries, sinks);
+    results.resize(queries.size());
+    for (auto i = 0; i < queries.size(); i++)
+        results[i] = sinks[i].get();
+}
+
+
+
+// Explicit instantiations for every result sink
+#define INSTANTIATE_HINT_M_SUBSSORT_SS_CM(Sink) \
+    template void HINT_M_SubsSort_SS_CM::executeBottomUp_Equals(RangeQuery, Sink&); \
+    template void HINT_M_SubsSort_SS_CM::executeBottomUp_Starts(RangeQuery, Sink&); \
+    template void HINT_M_SubsSort_SS_CM::executeBottomUp_Started(RangeQuery, Sink&); \
+    template void HINT_M_SubsSort_SS_CM::executeBottomUp_Finishes(RangeQuery, Sink&); \
+    template void HINT_M_SubsSort_SS_CM::executeBottomUp_Finished(RangeQuery, Sink&); \
+    template void HINT_M_SubsSort_SS_CM::executeBottomUp_Meets(RangeQuery, Sink&); \
+    template void HINT_M_SubsSort_SS_CM::executeBottomUp_Met(RangeQuery, Sink&); \
+    template void HINT_M_SubsSort_SS_CM::executeBottomUp_Overlaps(RangeQuery, Sink&); \
+    template void HINT_M_SubsSort_SS_CM::executeBottomUp_Overlapped(RangeQuery, Sink&); \
+    template void HINT_M_SubsSort_SS_CM::executeBottomUp_Contains(RangeQuery, Sink&); \
+    template void HINT_M_SubsSort_SS_CM::executeBottomUp_Contained(RangeQuery, Sink&); \
+    template void HINT_M_SubsSort_SS_CM::executeBottomUp_Precedes(RangeQuery, Sink&); \
+    template void HINT_M_SubsSort_SS_CM::executeBottomUp_Preceded(RangeQuery, Sink&); \
+    template void HINT_M_SubsSort_SS_CM::executeBottomUp_gOverlaps(RangeQuery, Sink&); \
+    template void HINT_M_SubsSort_SS_CM::executeBottomUp_gOverlaps(const vector<RangeQuery>&, vector<Sink>&);
+
+FOR_EACH_SINK(INSTANTIATE_HINT_M_SUBSSORT_SS_CM)
@@ -311,9 +311,9 @@ void HINT_M_SubsSort::getStats()
 
 
 // Generalized predicates, ACM SIGMOD'22 gOverlaps
-size_t HINT_M_SubsSort::executeBottomUp_gOverlaps(RangeQuery Q)
+template <class Sink>
+void HINT_M_SubsSort::executeBottomUp_gOverlaps(RangeQuery Q, Sink &result)
 {
-    size_t result = 0;
     Relation::iterator iterBegin;
     RelationIterator iter, iterEnd;
     Timestamp a = Q.start >> (this->maxBits-this->numBits); // prefix
@@ -322,6 +322,7 @@ size_t HINT_M_SubsSort::executeBottomUp_gOverlaps(RangeQuery Q)
     Record qdummyS(0, Q.start, Q.start);
     bool foundzero = false;
     bool foundone = false;
+    const Timestamp tmin = numeric_limits<Timestamp>::min(), tmax = numeric_limits<Timestamp>::max();
     
     
     for (auto l = 0; l < this->numBits; l++)
@@ -336,21 +337,13 @@ size_t HINT_M_SubsSort::executeBottomUp_gOverlaps(RangeQuery Q)
             iterEnd = this->pRepsIn[l][a].end();
             for (iter = iterBegin; iter != iterEnd; iter++)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= iter->id;
-#endif
+                result.add(iter->id);
             }
             iterBegin =this->pRepsAft[l][a].begin();
             iterEnd = this->pRepsAft[l][a].end();
             for (iter = iterBegin; iter != iterEnd; iter++)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= iter->id;
-#endif
+                result.add(iter->id);
             }
             
             // Handle rest: consider only originals
@@ -360,21 +353,13 @@ size_t HINT_M_SubsSort::executeBottomUp_gOverlaps(RangeQuery Q)
                 iterEnd = this->pOrgsIn[l][j].end();
                 for (iter = iterBegin; iter != iterEnd; iter++)
                 {
-#ifdef WORKLOAD_COUNT
-                    result++;
-#else
-                    result ^= iter->id;
-#endif
+                    result.add(iter->id);
                 }
                 iterBegin = this->pOrgsAft[l][j].begin();
                 iterEnd = this->pOrgsAft[l][j].end();
                 for (iter = iterBegin; iter != iterEnd; iter++)
                 {
-#ifdef WORKLOAD_COUNT
-                    result++;
-#else
-                    result ^= iter->id;
-#endif
+                    result.add(iter->id);
                 }
             }
         }
@@ -390,26 +375,12 @@ size_t HINT_M_SubsSort::executeBottomUp_gOverlaps(RangeQuery Q)
                 {
                     iterBegin = this->pOrgsIn[l][a].begin();
                     iterEnd = lower_bound(iterBegin, this->pOrgsIn[l][a].end(), qdummyE);
-                    for (iter = iterBegin; iter != iterEnd; iter++)
-                    {
-                        if (Q.start <= iter->end)
-                        {
-#ifdef WORKLOAD_COUNT
-                            result++;
-#else
-                            result ^= iter->id;
-#endif
-                        }
-                    }
+                    scanRecords(this->kernel, this->pOrgsIn[l][a].data(), iterEnd-iterBegin, tmin, tmax, Q.start, tmax, result);
                     iterBegin = this->pOrgsAft[l][a].begin();
                     iterEnd = lower_bound(iterBegin, this->pOrgsAft[l][a].end(), qdummyE);
                     for (iter = iterBegin; iter != iterEnd; iter++)
                     {
-#ifdef WORKLOAD_COUNT
-                        result++;
-#else
-                        result ^= iter->id;
-#endif
+                        result.add(iter->id);
                     }
                 }
                 else if (foundzero)
@@ -418,47 +389,23 @@ size_t HINT_M_SubsSort::executeBottomUp_gOverlaps(RangeQuery Q)
                     iterEnd = lower_bound(iterBegin, this->pOrgsIn[l][a].end(), qdummyE);
                     for (iter = iterBegin; iter != iterEnd; iter++)
                     {
-#ifdef WORKLOAD_COUNT
-                        result++;
-#else
-                        result ^= iter->id;
-#endif
+                        result.add(iter->id);
                     }
                     iterBegin = this->pOrgsAft[l][a].begin();
                     iterEnd = lower_bound(iterBegin, this->pOrgsAft[l][a].end(), qdummyE);
                     for (iter = iterBegin; iter != iterEnd; iter++)
                     {
-#ifdef WORKLOAD_COUNT
-                        result++;
-#else
-                        result ^= iter->id;
-#endif
+                        result.add(iter->id);
                     }
                 }
                 else if (foundone)
                 {
-                    iterBegin = this->pOrgsIn[l][a].begin();
-                    iterEnd = this->pOrgsIn[l][a].end();
-                    for (iter = iterBegin; iter != iterEnd; iter++)
-                    {
-                        if (Q.start <= iter->end)
-                        {
-#ifdef WORKLOAD_COUNT
-                            result++;
-#else
-                            result ^= iter->id;
-#endif
-                        }
-                    }
+                    scanRecords(this->kernel, this->pOrgsIn[l][a], tmin, tmax, Q.start, tmax, result);
                     iterBegin = this->pOrgsAft[l][a].begin();
                     iterEnd = this->pOrgsAft[l][a].end();
                     for (iter = iterBegin; iter != iterEnd; iter++)
                     {
-#ifdef WORKLOAD_COUNT
-                        result++;
-#else
-                        result ^= iter->id;
-#endif
+                        result.add(iter->id);
                     }
                 }
             }
@@ -467,19 +414,7 @@ size_t HINT_M_SubsSort::executeBottomUp_gOverlaps(RangeQuery Q)
                 // Lemma 1
                 if (!foundzero)
                 {
-                    iterBegin = this->pOrgsIn[l][a].begin();
-                    iterEnd = this->pOrgsIn[l][a].end();
-                    for (iter = iterBegin; iter != iterEnd; iter++)
-                    {
-                        if (Q.start <= iter->end)
-                        {
-#ifdef WORKLOAD_COUNT
-                            result++;
-#else
-                            result ^= iter->id;
-#endif
-                        }
-                    }
+                    scanRecords(this->kernel, this->pOrgsIn[l][a], tmin, tmax, Q.start, tmax, result);
                 }
                 else
                 {
@@ -487,22 +422,14 @@ size_t HINT_M_SubsSort::executeBottomUp_gOverlaps(RangeQuery Q)
                     iterEnd = this->pOrgsIn[l][a].end();
                     for (iter = iterBegin; iter != iterEnd; iter++)
                     {
-#ifdef WORKLOAD_COUNT
-                        result++;
-#else
-                        result ^= iter->id;
-#endif
+                        result.add(iter->id);
                     }
                 }
                 iterBegin = this->pOrgsAft[l][a].begin();
                 iterEnd = this->pOrgsAft[l][a].end();
                 for (iter = iterBegin; iter != iterEnd; iter++)
                 {
-#ifdef WORKLOAD_COUNT
-                    result++;
-#else
-                    result ^= iter->id;
-#endif
+                    result.add(iter->id);
                 }
             }
             
@@ -513,11 +440,7 @@ size_t HINT_M_SubsSort::executeBottomUp_gOverlaps(RangeQuery Q)
                 iterBegin = lower_bound(this->pRepsIn[l][a].begin(), this->pRepsIn[l][a].end(), qdummyS, CompareRecordsByEnd);
                 for (iter = iterBegin; iter != iterEnd; iter++)
                 {
-#ifdef WORKLOAD_COUNT
-                    result++;
-#else
-                    result ^= iter->id;
-#endif
+                    result.add(iter->id);
                 }
             }
             else
@@ -526,22 +449,14 @@ size_t HINT_M_SubsSort::executeBottomUp_gOverlaps(RangeQuery Q)
                 iterEnd = this->pRepsIn[l][a].end();
                 for (iter = iterBegin; iter != iterEnd; iter++)
                 {
-#ifdef WORKLOAD_COUNT
-                    result++;
-#else
-                    result ^= iter->id;
-#endif
+                    result.add(iter->id);
                 }
             }
             iterBegin = this->pRepsAft[l][a].begin();
             iterEnd = this->pRepsAft[l][a].end();
             for (iter = iterBegin; iter != iterEnd; iter++)
             {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= iter->id;
-#endif
+                result.add(iter->id);
             }
             
             if (a < b)
@@ -555,21 +470,13 @@ size_t HINT_M_SubsSort::executeBottomUp_gOverlaps(RangeQuery Q)
                         iterEnd = this->pOrgsIn[l][j].end();
                         for (iter = iterBegin; iter != iterEnd; iter++)
                         {
-#ifdef WORKLOAD_COUNT
-                            result++;
-#else
-                            result ^= iter->id;
-#endif
+                            result.add(iter->id);
                         }
                         iterBegin = this->pOrgsAft[l][j].begin();
                         iterEnd = this->pOrgsAft[l][j].end();
                         for (iter = iterBegin; iter != iterEnd; iter++)
                         {
-#ifdef WORKLOAD_COUNT
-                            result++;
-#else
-                            result ^= iter->id;
-#endif
+                            result.add(iter->id);
                         }
                     }
                     
@@ -578,21 +485,13 @@ size_t HINT_M_SubsSort::executeBottomUp_gOverlaps(RangeQuery Q)
                     iterEnd = lower_bound(iterBegin, this->pOrgsIn[l][b].end(), qdummyE);
                     for (iter = iterBegin; iter != iterEnd; iter++)
                     {
-#ifdef WORKLOAD_COUNT
-                        result++;
-#else
-                        result ^= iter->id;
-#endif
+                        result.add(iter->id);
                     }
                     iterBegin = this->pOrgsAft[l][b].begin();
                     iterEnd = lower_bound(iterBegin, this->pOrgsAft[l][b].end(), qdummyE);
                     for (iter = iterBegin; iter != iterEnd; iter++)
                     {
-#ifdef WORKLOAD_COUNT
-                        result++;
-#else
-                        result ^= iter->id;
-#endif
+                        result.add(iter->id);
                     }
                 }
                 else
@@ -603,21 +502,13 @@ size_t HINT_M_SubsSort::executeBottomUp_gOverlaps(RangeQuery Q)
                         iterEnd = this->pOrgsIn[l][j].end();
                         for (iter = iterBegin; iter != iterEnd; iter++)
                         {
-#ifdef WORKLOAD_COUNT
-                            result++;
-#else
-                            result ^= iter->id;
-#endif
+                            result.add(iter->id);
                         }
                         iterBegin = this->pOrgsAft[l][j].begin();
                         iterEnd = this->pOrgsAft[l][j].end();
                         for (iter = iterBegin; iter != iterEnd; iter++)
                         {
-#ifdef WORKLOAD_COUNT
-                            result++;
-#else
-                            result ^= iter->id;
-#endif
+                            result.add(iter->id);
                         }
                     }
                 }
@@ -640,11 +531,7 @@ size_t HINT_M_SubsSort::executeBottomUp_gOverlaps(RangeQuery Q)
         iterEnd = this->pOrgsIn[this->numBits][0].end();
         for (iter = iterBegin; iter != iterEnd; iter++)
         {
-#ifdef WORKLOAD_COUNT
-            result++;
-#else
-            result ^= iter->id;
-#endif
+            result.add(iter->id);
         }
     }
     else
@@ -652,19 +539,25 @@ size_t HINT_M_SubsSort::executeBottomUp_gOverlaps(RangeQuery Q)
         // Comparisons needed
         iterBegin = this->pOrgsIn[this->numBits][0].begin();
         iterEnd = lower_bound(iterBegin, this->pOrgsIn[this->numBits][0].end(), qdummyE);
-        for (iter = iterBegin; iter != iterEnd; iter++)
-        {
-            if (Q.start <= iter->end)
-            {
-#ifdef WORKLOAD_COUNT
-                result++;
-#else
-                result ^= iter->id;
-#endif
-            }
-        }
+        scanRecords(this->kernel, this->pOrgsIn[this->numBits][0].data(), iterEnd-iterBegin, tmin, tmax, Q.start, tmax, result);
     }
     
+}
+
+
+size_t HINT_M_SubsSort::executeBottomUp_gOverlaps(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_gOverlaps(Q, result);
     
-    return result;
+    return result.get();
 }
+
+
+
+// Explicit instantiations for every result sink
+#define INSTANTIATE_HINT_M_SUBSSORT(Sink) \
+    template void HINT_M_SubsSort::executeBottomUp_gOverlaps(RangeQuery, Sink&);
+
+FOR_EACH_SINK(INSTANTIATE_HINT_M_SUBSSORT)
@@ -0,0 +1,616 @@
+/******************************************************************************
+ * Project:  hint
+ * Purpose:  Indexing interval data
+ * Author:   Panagiotis Bouros, pbour@github.io
+ * Author:   George Christodoulou
+ ******************************************************************************
+ * Copyright (c) 2020 - 2024
+ *
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************/
+
+
+#include "segmentedhint.h"
+
+
+
+Segment::Segment(const Relation &R, const unsigned int numBits, const unsigned int maxBits, const unsigned int tier, const unsigned int numThreads)
+{
+    this->idx  = new HINT_M_ALL(R, numBits, maxBits, numThreads);
+    this->tier = tier;
+    
+    // Immutable from now on, so the statistics are gathered once
+    this->idx->getStats();
+}
+
+
+Segment::~Segment()
+{
+    delete this->idx;
+}
+
+
+
+SegmentedHINT::SegmentedHINT(const Relation &R, const unsigned int numBits, const unsigned int maxBits, const unsigned int fanout, const unsigned int numThreads) : HierarchicalIndex(R, numBits, maxBits), segments(new SegmentList())
+{
+    this->fanout         = max(fanout, (unsigned int)2);
+    this->numThreads     = numThreads;
+    this->stop           = false;
+    this->busy           = false;
+    this->numCompactions = 0;
+    
+    // The initial data form a single segment, using all the bits; the open
+    // intervals stay with SegmentedHINT, so the segment gets a copy without
+    // them
+    if (!R.empty())
+    {
+        Relation R0;
+        
+        R0.assign(R.begin(), R.end());
+        this->publish(SegmentList(), make_shared<const Segment>(R0, this->numBits, this->maxBits, this->getTier(R.size()), numThreads));
+    }
+    
+    this->compactor = thread(&SegmentedHINT::compact, this);
+}
+
+
+// Tier of a segment with numRecords records: 0 up to the capacity of the
+// delta buffer, then one more for every fanout times as many records
+unsigned int SegmentedHINT::getTier(const size_t numRecords) const
+{
+    unsigned int tier = 0;
+    
+    for (size_t c = this->delta.capacity; numRecords > c; c *= this->fanout)
+        tier++;
+    
+    return tier;
+}
+
+
+// Number of bits of a segment with numRecords records; a small segment uses
+// fewer, as most of its partitions would be empty otherwise
+unsigned int SegmentedHINT::getSegmentBits(const size_t numRecords) const
+{
+    return max(min(this->numBits, (unsigned int)ceil(log2(max(numRecords, (size_t)2)))), (unsigned int)1);
+}
+
+
+// The oldest fanout segments of the lowest tier holding as many, if any
+bool SegmentedHINT::getCompaction(const SegmentList &list, SegmentList &victims) const
+{
+    map<unsigned int, SegmentList> tiers;
+    
+    for (const shared_ptr<const Segment> &segment : list)
+    {
+        SegmentList &tier = tiers[segment->tier];
+        
+        tier.push_back(segment);
+        if (tier.size() == this->fanout)
+        {
+            victims = tier;
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+
+// Replaces the victims by segment in a new list of segments, with the lock
+// held; the queries evaluated meanwhile keep using the old list, which is
+// freed once they are done.
+void SegmentedHINT::publish(const SegmentList &victims, const shared_ptr<const Segment> &segment)
+{
+    SegmentList *list = new SegmentList();
+    
+    for (const shared_ptr<const Segment> &s : *this->segments.get())
+    {
+        if (find(victims.begin(), victims.end(), s) == victims.end())
+            list->push_back(s);
+    }
+    list->push_back(segment);
+    
+    this->segments.publish(list);
+}
+
+
+// Background thread merging the segments; a merged segment is built with the
+// lock released, so that sealing the buffer is never blocked on it.
+void SegmentedHINT::compact()
+{
+    unique_lock<mutex> guard(this->lock);
+    SegmentList victims;
+    
+    while (true)
+    {
+        this->busy = false;
+        this->cvIdle.notify_all();
+        this->cvWork.wait(guard, [&] { return (this->stop || this->getCompaction(*this->segments.get(), victims)); });
+        if (this->stop)
+            return;
+        this->busy = true;
+        guard.unlock();
+        
+        Relation R;
+        size_t n = 0;
+        
+        for (const shared_ptr<const Segment> &s : victims)
+            n += s->idx->getNumIndexedRecords();
+        R.reserve(n);
+        for (const shared_ptr<const Segment> &s : victims)
+            s->idx->getRecords(R);
+        shared_ptr<const Segment> segment = make_shared<const Segment>(R, this->getSegmentBits(n), this->maxBits, this->getTier(n), this->numThreads);
+        
+        guard.lock();
+        this->publish(victims, segment);
+        this->numCompactions++;
+        victims.clear();
+    }
+}
+
+
+// Seals the delta buffer into a new segment of tier 0.
+void SegmentedHINT::mergeDelta()
+{
+    size_t n = this->delta.size();
+    shared_ptr<const Segment> segment = make_shared<const Segment>(this->delta.records, this->getSegmentBits(n), this->maxBits, 0, this->numThreads);
+    {
+        lock_guard<mutex> guard(this->lock);
+        
+        this->publish(SegmentList(), segment);
+    }
+    this->cvWork.notify_one();
+}
+
+
+// Seals the delta buffer and waits until no tier is due for a compaction.
+void SegmentedHINT::sync()
+{
+    SegmentList victims;
+    
+    
+    this->merge();
+    
+    unique_lock<mutex> guard(this->lock);
+    this->cvIdle.wait(guard, [&] { return ((!this->busy) && (!this->getCompaction(*this->segments.get(), victims))); });
+}
+
+
+size_t SegmentedHINT::getNumSegments() const
+{
+    return this->segments.acquire()->size();
+}
+
+
+void SegmentedHINT::getStats()
+{
+    IndexHandle<const SegmentList>::Reader list = this->segments.acquire();
+    
+    
+    for (const shared_ptr<const Segment> &segment : *list)
+    {
+        const HINT_M_ALL *idx = segment->idx;
+        
+        this->numPartitions      += idx->numPartitions;
+        this->numEmptyPartitions += idx->numEmptyPartitions;
+        this->numOriginalsIn     += idx->numOriginalsIn;
+        this->numOriginalsAft    += idx->numOriginalsAft;
+        this->numReplicasIn      += idx->numReplicasIn;
+        this->numReplicasAft     += idx->numReplicasAft;
+    }
+    
+    this->avgPartitionSize = (float)(this->numIndexedRecords+this->numReplicasIn+this->numReplicasAft)/(this->numPartitions-this->numEmptyPartitions);
+}
+
+
+SegmentedHINT::~SegmentedHINT()
+{
+    {
+        lock_guard<mutex> guard(this->lock);
+        
+        this->stop = true;
+    }
+    this->cvWork.notify_all();
+    this->compactor.join();
+}
+
+
+
+// Querying
+// Evaluates query on every segment, see the querying methods of HINT_M_ALL;
+// the list is taken once, so a compaction completing meanwhile is not seen.
+template <class Query>
+inline void SegmentedHINT::fanOut(const Query &query)
+{
+    IndexHandle<const SegmentList>::Reader list = this->segments.acquire();
+    
+    for (const shared_ptr<const Segment> &segment : *list)
+        query(*segment->idx);
+}
+
+
+// Basic predicates of Allen's algebra
+template <class Sink>
+void SegmentedHINT::executeBottomUp_Equals(RangeQuery Q, Sink &result)
+{
+    this->fanOut([&](HINT_M_ALL &idx) {idx.executeBottomUp_Equals(Q, result);});
+    
+    // Records inserted since the last seal, see HierarchicalIndex::insert()
+    this->delta.execute_Equals(this->kernel, Q, result);
+    
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_Equals(this->kernel, Q, result);
+}
+
+
+size_t SegmentedHINT::executeBottomUp_Equals(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_Equals(Q, result);
+    
+    return result.get();
+}
+
+
+template <class Sink>
+void SegmentedHINT::executeBottomUp_Starts(RangeQuery Q, Sink &result)
+{
+    this->fanOut([&](HINT_M_ALL &idx) {idx.executeBottomUp_Starts(Q, result);});
+    
+    // Records inserted since the last seal, see HierarchicalIndex::insert()
+    this->delta.execute_Starts(this->kernel, Q, result);
+    
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_Starts(this->kernel, Q, result);
+}
+
+
+size_t SegmentedHINT::executeBottomUp_Starts(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_Starts(Q, result);
+    
+    return result.get();
+}
+
+
+template <class Sink>
+void SegmentedHINT::executeBottomUp_Started(RangeQuery Q, Sink &result)
+{
+    this->fanOut([&](HINT_M_ALL &idx) {idx.executeBottomUp_Started(Q, result);});
+    
+    // Records inserted since the last seal, see HierarchicalIndex::insert()
+    this->delta.execute_Started(this->kernel, Q, result);
+    
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_Started(this->kernel, Q, result);
+}
+
+
+size_t SegmentedHINT::executeBottomUp_Started(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_Started(Q, result);
+    
+    return result.get();
+}
+
+
+template <class Sink>
+void SegmentedHINT::executeBottomUp_Finishes(RangeQuery Q, Sink &result)
+{
+    this->fanOut([&](HINT_M_ALL &idx) {idx.executeBottomUp_Finishes(Q, result);});
+    
+    // Records inserted since the last seal, see HierarchicalIndex::insert()
+    this->delta.execute_Finishes(this->kernel, Q, result);
+    
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_Finishes(this->kernel, Q, result);
+}
+
+
+size_t SegmentedHINT::executeBottomUp_Finishes(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_Finishes(Q, result);
+    
+    return result.get();
+}
+
+
+template <class Sink>
+void SegmentedHINT::executeBottomUp_Finished(RangeQuery Q, Sink &result)
+{
+    this->fanOut([&](HINT_M_ALL &idx) {idx.executeBottomUp_Finished(Q, result);});
+    
+    // Records inserted since the last seal, see HierarchicalIndex::insert()
+    this->delta.execute_Finished(this->kernel, Q, result);
+    
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_Finished(this->kernel, Q, result);
+}
+
+
+size_t SegmentedHINT::executeBottomUp_Finished(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_Finished(Q, result);
+    
+    return result.get();
+}
+
+
+template <class Sink>
+void SegmentedHINT::executeBottomUp_Meets(RangeQuery Q, Sink &result)
+{
+    this->fanOut([&](HINT_M_ALL &idx) {idx.executeBottomUp_Meets(Q, result);});
+    
+    // Records inserted since the last seal, see HierarchicalIndex::insert()
+    this->delta.execute_Meets(this->kernel, Q, result);
+    
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_Meets(this->kernel, Q, result);
+}
+
+
+size_t SegmentedHINT::executeBottomUp_Meets(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_Meets(Q, result);
+    
+    return result.get();
+}
+
+
+template <class Sink>
+void SegmentedHINT::executeBottomUp_Met(RangeQuery Q, Sink &result)
+{
+    this->fanOut([&](HINT_M_ALL &idx) {idx.executeBottomUp_Met(Q, result);});
+    
+    // Records inserted since the last seal, see HierarchicalIndex::insert()
+    this->delta.execute_Met(this->kernel, Q, result);
+    
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_Met(this->kernel, Q, result);
+}
+
+
+size_t SegmentedHINT::executeBottomUp_Met(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_Met(Q, result);
+    
+    return result.get();
+}
+
+
+template <class Sink>
+void SegmentedHINT::executeBottomUp_Overlaps(RangeQuery Q, Sink &result)
+{
+    this->fanOut([&](HINT_M_ALL &idx) {idx.executeBottomUp_Overlaps(Q, result);});
+    
+    // Records inserted since the last seal, see HierarchicalIndex::insert()
+    this->delta.execute_Overlaps(this->kernel, Q, result);
+    
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_Overlaps(this->kernel, Q, result);
+}
+
+
+size_t SegmentedHINT::executeBottomUp_Overlaps(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_Overlaps(Q, result);
+    
+    return result.get();
+}
+
+
+template <class Sink>
+void SegmentedHINT::executeBottomUp_Overlapped(RangeQuery Q, Sink &result)
+{
+    this->fanOut([&](HINT_M_ALL &idx) {idx.executeBottomUp_Overlapped(Q, result);});
+    
+    // Records inserted since the last seal, see HierarchicalIndex::insert()
+    this->delta.execute_Overlapped(this->kernel, Q, result);
+    
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_Overlapped(this->kernel, Q, result);
+}
+
+
+size_t SegmentedHINT::executeBottomUp_Overlapped(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_Overlapped(Q, result);
+    
+    return result.get();
+}
+
+
+template <class Sink>
+void SegmentedHINT::executeBottomUp_Contains(RangeQuery Q, Sink &result)
+{
+    this->fanOut([&](HINT_M_ALL &idx) {idx.executeBottomUp_Contains(Q, result);});
+    
+    // Records inserted since the last seal, see HierarchicalIndex::insert()
+    this->delta.execute_Contains(this->kernel, Q, result);
+    
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_Contains(this->kernel, Q, result);
+}
+
+
+size_t SegmentedHINT::executeBottomUp_Contains(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_Contains(Q, result);
+    
+    return result.get();
+}
+
+
+template <class Sink>
+void SegmentedHINT::executeBottomUp_Contained(RangeQuery Q, Sink &result)
+{
+    this->fanOut([&](HINT_M_ALL &idx) {idx.executeBottomUp_Contained(Q, result);});
+    
+    // Records inserted since the last seal, see HierarchicalIndex::insert()
+    this->delta.execute_Contained(this->kernel, Q, result);
+    
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_Contained(this->kernel, Q, result);
+}
+
+
+size_t SegmentedHINT::executeBottomUp_Contained(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_Contained(Q, result);
+    
+    return result.get();
+}
+
+
+template <class Sink>
+void SegmentedHINT::executeBottomUp_Precedes(RangeQuery Q, Sink &result)
+{
+    this->fanOut([&](HINT_M_ALL &idx) {idx.executeBottomUp_Precedes(Q, result);});
+    
+    // Records inserted since the last seal, see HierarchicalIndex::insert()
+    this->delta.execute_Precedes(this->kernel, Q, result);
+    
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_Precedes(this->kernel, Q, result);
+}
+
+
+size_t SegmentedHINT::executeBottomUp_Precedes(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_Precedes(Q, result);
+    
+    return result.get();
+}
+
+
+template <class Sink>
+void SegmentedHINT::executeBottomUp_Preceded(RangeQuery Q, Sink &result)
+{
+    this->fanOut([&](HINT_M_ALL &idx) {idx.executeBottomUp_Preceded(Q, result);});
+    
+    // Records inserted since the last seal, see HierarchicalIndex::insert()
+    this->delta.execute_Preceded(this->kernel, Q, result);
+    
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_Preceded(this->kernel, Q, result);
+}
+
+
+size_t SegmentedHINT::executeBottomUp_Preceded(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_Preceded(Q, result);
+    
+    return result.get();
+}
+
+
+
+// Generalized predicates, ACM SIGMOD'22 gOverlaps
+template <class Sink>
+void SegmentedHINT::executeBottomUp_gOverlaps(StabbingQuery Q, Sink &result)
+{
+    this->fanOut([&](HINT_M_ALL &idx) {idx.executeBottomUp_gOverlaps(Q, result);});
+    
+    // Records inserted since the last seal, see HierarchicalIndex::insert()
+    this->delta.execute_gOverlaps(this->kernel, Q, result);
+    
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_gOverlaps(this->kernel, Q, result);
+}
+
+
+size_t SegmentedHINT::executeBottomUp_gOverlaps(StabbingQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_gOverlaps(Q, result);
+    
+    return result.get();
+}
+
+
+template <class Sink>
+void SegmentedHINT::executeBottomUp_gOverlaps(RangeQuery Q, Sink &result)
+{
+    this->fanOut([&](HINT_M_ALL &idx) {idx.executeBottomUp_gOverlaps(Q, result);});
+    
+    // Records inserted since the last seal, see HierarchicalIndex::insert()
+    this->delta.execute_gOverlaps(this->kernel, Q, result);
+    
+    // Open intervals, see OpenIntervals
+    this->openRecords.execute_gOverlaps(this->kernel, Q, result);
+}
+
+
+size_t SegmentedHINT::executeBottomUp_gOverlaps(RangeQuery Q)
+{
+    WorkloadSink result;
+    
+    this->executeBottomUp_gOverlaps(Q, result);
+    
+    return result.get();
+}
+
+
+
+#define INSTANTIATE_SEGMENTED_HINT(Sink) \
+    template void SegmentedHINT::executeBottomUp_Equals(RangeQuery, Sink&); \
+    template void SegmentedHINT::executeBottomUp_Starts(RangeQuery, Sink&); \
+    template void SegmentedHINT::executeBottomUp_Started(RangeQuery, Sink&); \
+    template void SegmentedHINT::executeBottomUp_Finishes(RangeQuery, Sink&); \
+    template void SegmentedHINT::executeBottomUp_Finished(RangeQuery, Sink&); \
+    template void SegmentedHINT::executeBottomUp_Meets(RangeQuery, Sink&); \
+    template void SegmentedHINT::executeBottomUp_Met(RangeQuery, Sink&); \
+    template void SegmentedHINT::executeBottomUp_Overlaps(RangeQuery, Sink&); \
+    template void SegmentedHINT::executeBottomUp_Overlapped(RangeQuery, Sink&); \
+    template void SegmentedHINT::executeBottomUp_Contains(RangeQuery, Sink&); \
+    template void SegmentedHINT::executeBottomUp_Contained(RangeQuery, Sink&); \
+    template void SegmentedHINT::executeBottomUp_Precedes(RangeQuery, Sink&); \
+    template void SegmentedHINT::executeBottomUp_Preceded(RangeQuery, Sink&); \
+    template void SegmentedHINT::executeBottomUp_gOverlaps(StabbingQuery, Sink&); \
+    template void SegmentedHINT::executeBottomUp_gOverlaps(RangeQuery, Sink&);
+
+FOR_EACH_SINK(INSTANTIATE_SEGMENTED_HINT)
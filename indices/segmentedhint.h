@@ -0,0 +1,156 @@
+/******************************************************************************
+ * Project:  hint
+ * Purpose:  Indexing interval data
+ * Author:   Panagiotis Bouros, pbour@github.io
+ * Author:   George Christodoulou
+ ******************************************************************************
+ * Copyright (c) 2020 - 2024
+ *
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************/
+
+
+#ifndef _SEGMENTEDHINT_H_
+#define _SEGMENTEDHINT_H_
+
+#include "../def_global.h"
+#include "../containers/relation.h"
+#include "../indices/hint_m.h"
+#include "../containers/indexhandle.h"
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <map>
+
+#define SEGMENTED_HINT_FANOUT 4 // Default number of segments of a tier merged into one segment
+
+
+
+// Immutable segment of SegmentedHINT: HINT^m with all optimizations over a
+// batch of records; the records are taken back from the index to merge the
+// segment with others, see HINT_M_ALL::getRecords().
+class Segment
+{
+public:
+    HINT_M_ALL *idx;
+    unsigned int tier;
+    
+    Segment(const Relation &R, const unsigned int numBits, const unsigned int maxBits, const unsigned int tier, const unsigned int numThreads);
+    ~Segment();
+};
+
+typedef vector<shared_ptr<const Segment> > SegmentList;
+
+
+
+// LSM-style index for high ingest rates. Insertions go to the delta buffer
+// (see HierarchicalIndex::insert()), which when full is sealed into a new
+// segment; the segments are immutable, so a query takes the current list of
+// segments and evaluates on each one, and on the buffer, without any lock,
+// reporting to the same sink. A background thread merges the segments in
+// size tiers: a sealed buffer is in tier 0, and whenever a tier holds fanout
+// segments they are rebuilt as one segment of the next tier, which replaces
+// them in a new list; the old segments are freed once the queries in flight
+// are done with them, see IndexHandle. Hence, an insertion costs an insertion in the buffer plus the
+// build of a small segment, amortized over the capacity of the buffer, while
+// a query evaluates on O(fanout*log(n/capacity)) segments.
+//
+// Insertions and queries are issued by one thread, as for the rest of the
+// indices supporting updates; only the compactions run in the background.
+// Deletions are not supported.
+class SegmentedHINT : public HierarchicalIndex
+{
+private:
+    IndexHandle<const SegmentList> segments;    // Read without locking, see IndexHandle
+    unsigned int fanout;
+    unsigned int numThreads;    // Building every segment, see HINT_M_ALL
+    
+    // Compaction, see compact(); the lock serializes the updates of the
+    // list of segments
+    thread compactor;
+    mutex lock;
+    condition_variable cvWork, cvIdle;
+    bool stop, busy;
+    
+    unsigned int getTier(const size_t numRecords) const;
+    unsigned int getSegmentBits(const size_t numRecords) const;
+    bool getCompaction(const SegmentList &list, SegmentList &victims) const;
+    void publish(const SegmentList &victims, const shared_ptr<const Segment> &segment);
+    void compact();
+    
+    // Updating
+    bool supportsUpdates() const {return true;};
+    void mergeDelta();
+    
+    // Querying
+    template <class Query> inline void fanOut(const Query &query);
+    
+public:
+    // Statistics
+    atomic<size_t> numCompactions;
+    
+    // Construction
+    SegmentedHINT(const Relation &R, const unsigned int numBits, const unsigned int maxBits, const unsigned int fanout, const unsigned int numThreads);
+    void getStats();
+    size_t getNumSegments() const;
+    void sync();
+    ~SegmentedHINT();
+    
+    // Querying
+    // Basic predicates of Allen's algebra
+    size_t executeBottomUp_Equals(RangeQuery Q);
+    size_t executeBottomUp_Starts(RangeQuery Q);
+    size_t executeBottomUp_Started(RangeQuery Q);
+    size_t executeBottomUp_Finishes(RangeQuery Q);
+    size_t executeBottomUp_Finished(RangeQuery Q);
+    size_t executeBottomUp_Meets(RangeQuery Q);
+    size_t executeBottomUp_Met(RangeQuery Q);
+    size_t executeBottomUp_Overlaps(RangeQuery Q);
+    size_t executeBottomUp_Overlapped(RangeQuery Q);
+    size_t executeBottomUp_Contains(RangeQuery Q);
+    size_t executeBottomUp_Contained(RangeQuery Q);
+    size_t executeBottomUp_Precedes(RangeQuery Q);
+    size_t executeBottomUp_Preceded(RangeQuery Q);
+    
+    // Generalized predicates, ACM SIGMOD'22 gOverlaps
+    size_t executeBottomUp_gOverlaps(StabbingQuery Q);
+    size_t executeBottomUp_gOverlaps(RangeQuery Q);
+    
+    // Querying with an explicit result sink, see containers/sinks.h
+    template <class Sink> void executeBottomUp_Equals(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_Starts(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_Started(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_Finishes(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_Finished(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_Meets(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_Met(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_Overlaps(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_Overlapped(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_Contains(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_Contained(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_Precedes(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_Preceded(RangeQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_gOverlaps(StabbingQuery Q, Sink &result);
+    template <class Sink> void executeBottomUp_gOverlaps(RangeQuery Q, Sink &result);
+};
+#endif // _SEGMENTEDHINT_H_
@@ -0,0 +1,146 @@
+/******************************************************************************
+ * Project:  hint
+ * Purpose:  Indexing interval data
+ * Author:   Panagiotis Bouros, pbour@github.io
+ * Author:   George Christodoulou
+ ******************************************************************************
+ * Copyright (c) 2020 - 2024
+ *
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************/
+
+
+#include "getopt.h"
+#include "def_global.h"
+#include "./containers/relation.h"
+
+
+
+void usage()
+{
+    cerr << endl;
+    cerr << "PROJECT" << endl;
+    cerr << "       HINT: A Hierarchical Index for Intervals in Main Memory" << endl << endl;
+    cerr << "USAGE" << endl;
+    cerr << "       ./convert.exec [OPTION]... [DATA] [OUTPUT]" << endl << endl;
+    cerr << "DESCRIPTION" << endl;
+    cerr << "       Converts a data file to the binary format, which all query executables detect and load" << endl;
+    cerr << "       by mapping the file instead of parsing it; a binary data file is converted back to text." << endl << endl;
+    cerr << "       -?" << endl;
+    cerr << "              display this help message and exit" << endl << endl;
+    cerr << "EXAMPLES" << endl;
+    cerr << "       ./convert.exec samples/AARHUS-BOOKS_2013.dat samples/AARHUS-BOOKS_2013.bin" << endl << endl;
+}
+
+
+int main(int argc, char **argv)
+{
+    Timer tim;
+    Relation R;
+    double totalLoadTime = 0, totalSaveTime = 0;
+    char c;
+    bool toText;
+
+
+    // Parse command line input
+    while ((c = getopt(argc, argv, "?h")) != -1)
+    {
+        switch (c)
+        {
+            case '?':
+            case 'h':
+                usage();
+                return 0;
+
+            default:
+                cerr << endl << "Error - unknown option '" << c << "'" << endl << endl;
+                usage();
+                return 1;
+        }
+    }
+
+
+    // Sanity check
+    if (argc-optind != 2)
+    {
+        usage();
+        return 1;
+    }
+
+
+    // Load data, in either format
+    tim.start();
+    R.load(argv[optind]);
+    totalLoadTime = tim.stop();
+
+    // Convert
+    ifstream inp(argv[optind]);
+    char magic[sizeof(RelationFileHeader::magic)];
+    toText = ((inp.read(magic, sizeof(magic))) && (isRelationFileMagic(magic)));
+    inp.close();
+
+    tim.start();
+    if (toText)
+    {
+        ofstream out(argv[optind+1]);
+        if (!out)
+        {
+            cerr << endl << "Error - cannot create data file \"" << argv[optind+1] << "\"" << endl << endl;
+            return 1;
+        }
+        // In id order, with the open intervals back in place
+        vector<Record> records(R.size()+R.openRecords.size());
+        for (const Record &r : R)
+            records[r.id] = r;
+        for (const RecordStart &r : R.openRecords)
+            records[r.id] = Record(r.id, r.start, OPEN_END);
+        for (const Record &r : records)
+        {
+            if (r.end == OPEN_END)
+                out << r.start << " now\n";
+            else
+                out << r.start << " " << r.end << "\n";
+        }
+    }
+    else
+        R.save(argv[optind+1]);
+    totalSaveTime = tim.stop();
+
+
+    // Report
+    cout << endl;
+    cout << "Conversion" << endl;
+    cout << "==========" << endl;
+    cout << "Input" << endl;
+    cout << "  Num of intervals          : " << R.size() << endl;
+    if (!R.openRecords.empty())
+        cout << "  Num of open intervals     : " << R.openRecords.size() << endl;
+    cout << "  Domain size               : " << (R.gend-R.gstart) << endl;
+    cout << "  Avg interval extent [%]   : "; printf("%f\n", R.avgRecordExtent*100/(R.gend-R.gstart));
+    cout << endl;
+    cout << "Output" << endl;
+    cout << "  Format                    : " << ((toText)? "text": "binary") << endl;
+    printf( "  Loading time [secs]       : %f\n", totalLoadTime);
+    printf( "  Writing time [secs]       : %f\n\n", totalSaveTime);
+
+
+    return 0;
+}
@@ -66,6 +66,7 @@ int main(int argc, char **argv)
     size_t totalResult = 0, queryresult = 0, numQueries = 0;
     double totalIndexTime = 0, totalQueryTime = 0, querytime = 0, avgQueryTime = 0;
     Timestamp qstart, qend;
+    vector<RangeQuery> queries;
     RunSettings settings;
     char c;
     double vmDQ = 0, rssDQ = 0, vmI = 0, rssI = 0;
@@ -135,14 +136,14 @@ int main(int argc, char **argv)
     
     // Load data and queries
     R.load(settings.dataFile);
-    settings.maxBits = int(log2(R.gend-R.gstart)+1);
-    
-    ifstream fQ(settings.queryFile);
-    if (!fQ)
+    if (!R.openRecords.empty())
     {
-        cerr << endl << "Error - cannot open query file \"" << settings.queryFile << "\"" << endl << endl;
+        cerr << endl << "Error - open intervals are supported only by HINT^m with \"subs+sort+ss+cm\" and \"all\" optimizations" << endl << endl;
         return 1;
     }
+    settings.maxBits = int(log2(R.gend-R.gstart)+1);
+    
+    loadQueries(settings.queryFile, queries);
     process_mem_usage(vmDQ, rssDQ);
 
     
@@ -168,8 +169,10 @@ int main(int argc, char **argv)
     size_t sumQ = 0;
     if (settings.verbose)
         cout << "Query\tPredicate\tMethod\tBits\tOptimizations\tResult\tTime" << endl;
-    while (fQ >> qstart >> qend)
+    for (const RangeQuery &q : queries)
     {
+        qstart = q.start;
+        qend   = q.end;
         sumQ += qend-qstart;
         numQueries++;
         
@@ -271,7 +274,6 @@ int main(int argc, char **argv)
         totalResult += queryresult;
         avgQueryTime += sumT/settings.numRuns;
     }
-    fQ.close();
     
     
     // Report
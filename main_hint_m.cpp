@@ -31,6 +31,13 @@
 #include "def_global.h"
 #include "./containers/relation.h"
 #include "./indices/hint_m.h"
+#include "./indices/segmentedhint.h"
+#include "./containers/indexhandle.h"
+#include <thread>
+#include <atomic>
+
+// Number of queries grabbed at a time by a worker thread
+#define QUERY_CHUNK_SIZE 16
 
 
 
@@ -55,33 +62,279 @@ void usage()
     cerr << "       -t" << endl;
     cerr << "              evaluate query traversing the hierarchy in a top-down fashion, currently supported only by base HINT^m; by default the bottom-up strategy is used" << endl;
     cerr << "       -r runs" << endl;
-    cerr << "              set the number of runs per query; by default 1" << endl << endl;
+    cerr << "              set the number of runs per query; by default 1" << endl;
+    cerr << "       -j threads" << endl;
+    cerr << "              evaluate the queries using the given number of threads; by default 1, i.e., queries are evaluated one by one" << endl;
+    cerr << "       -c threads" << endl;
+    cerr << "              build the index using the given number of threads; the index is the same as the one built by a single thread; currently supported only by \"all\" optimizations; by default 1" << endl;
+    cerr << "       -R" << endl;
+    cerr << "              rebuild the index in a background thread once a quarter of the queries is evaluated with -j, and publish it to the query threads without stopping them; the latencies of the queries before, during and after the rebuild are reported; currently supported only by \"all\" optimizations" << endl;
+    cerr << "       -a" << endl;
+    cerr << "              also build the prefix aggregates (XOR of ids, sum of durations) of the partitions, which serve the partitions fully covered by a query in O(1) for the default XOR workload and for aggregate queries (see -A); currently supported only by \"all\" optimizations" << endl;
+    cerr << "       -A" << endl;
+    cerr << "              evaluate aggregate queries, i.e., report the number of the results of every query, the XOR of their ids and the sum of their durations; currently supported only by \"all\" optimizations" << endl;
+    cerr << "       -e" << endl;
+    cerr << "              search the partition offsets of every level with more than 256 of them in a static B+-tree (16 keys per node), which replaces their default rank directory; currently supported only by \"subs+sort+ss+cm\" and \"all\" optimizations" << endl;
+    cerr << "       -p threads" << endl;
+    cerr << "              evaluate every single query expected to report many results using the given number of threads; currently supported only for GOVERLAPS with \"all\" optimizations; by default 1" << endl;
+    cerr << "       -s selectivity" << endl;
+    cerr << "              set the fraction of the data, estimated from the partition offsets, above which a query is evaluated in parallel (see -p); by default 0.01" << endl;
+    cerr << "       -B" << endl;
+    cerr << "              evaluate all queries as one batch, sorted by start; supported only for GOVERLAPS with the bottom-up strategy, shares the offset lookups among the queries for \"subs+sort+ss+cm\" and \"all\" optimizations" << endl;
+    cerr << "       -S file" << endl;
+    cerr << "              save the index to the given file after building it; currently supported only by \"all\" optimizations" << endl;
+    cerr << "       -I file" << endl;
+    cerr << "              open the index saved to the given file with -S instead of building it; the number of bits is taken from the file; currently supported only by \"all\" optimizations" << endl;
+    cerr << "       -u fraction" << endl;
+    cerr << "              build the index on the data except for the given fraction at its end, which is inserted while the queries are evaluated, evenly spread before them; currently supported only by \"subs+sort+ss+cm\" and \"all\" optimizations; by default 0, i.e., no insertions" << endl;
+    cerr << "       -U capacity" << endl;
+    cerr << "              set the number of insertions kept in the delta buffer of the index before they are merged in its partitions (see -u); by default " << DELTA_BUFFER_CAPACITY << endl;
+    cerr << "       -d fraction" << endl;
+    cerr << "              erase the given fraction of the data the index is built on, evenly chosen, while the queries are evaluated, evenly spread before them; currently supported only by \"subs+sort+ss+cm\" and \"all\" optimizations; by default 0, i.e., no deletions" << endl;
+    cerr << "       -P ratio" << endl;
+    cerr << "              set the fraction of the indexed records that may be erased before they are purged from the partitions of the index (see -d); by default " << TOMBSTONES_PURGE_RATIO << endl;
+    cerr << "       -G fanout" << endl;
+    cerr << "              build a segmented index, i.e., immutable \"all\" indices over batches of the data, which are merged by a background thread whenever a tier holds fanout of them, e.g., " << SEGMENTED_HINT_FANOUT << "; the delta buffer is sealed into a new segment when full (see -u and -U); currently supported only by \"all\" optimizations" << endl << endl;
     cerr << "EXAMPLES" << endl;
     cerr << "       ./query_hint_m.exec -b 10 -q gOVERLAPS -r 10 samples/AARHUS-BOOKS_2013.dat samples/AARHUS-BOOKS_2013_20k.qry" << endl;
     cerr << "       ./query_hint_m.exec -b 10 -o subs+sort -q gOVERLAPS -v samples/AARHUS-BOOKS_2013.dat samples/AARHUS-BOOKS_2013_20k.qry" << endl;
     cerr << "       ./query_hint_m.exec -b 10 -o subs+sort+ss+cm -q gOVERLAPS -v samples/AARHUS-BOOKS_2013.dat samples/AARHUS-BOOKS_2013_20k.qry" << endl;
-    cerr << "       ./query_hint_m.exec -b 10 -o all -q gOVERLAPS -v samples/AARHUS-BOOKS_2013.dat samples/AARHUS-BOOKS_2013_20k.qry" << endl << endl;
+    cerr << "       ./query_hint_m.exec -b 10 -o all -q gOVERLAPS -v samples/AARHUS-BOOKS_2013.dat samples/AARHUS-BOOKS_2013_20k.qry" << endl;
+    cerr << "       ./query_hint_m.exec -b 10 -o all -q gOVERLAPS -j 8 samples/AARHUS-BOOKS_2013.dat samples/AARHUS-BOOKS_2013_20k.qry" << endl;
+    cerr << "       ./query_hint_m.exec -b 10 -o all -q gOVERLAPS -j 8 -R -r 10 samples/AARHUS-BOOKS_2013.dat samples/AARHUS-BOOKS_2013_20k.qry" << endl;
+    cerr << "       ./query_hint_m.exec -b 10 -o all -q gOVERLAPS -p 4 -s 0.05 samples/AARHUS-BOOKS_2013.dat samples/AARHUS-BOOKS_2013_20k.qry" << endl;
+    cerr << "       ./query_hint_m.exec -b 10 -o all -q gOVERLAPS -a -A samples/AARHUS-BOOKS_2013.dat samples/AARHUS-BOOKS_2013_20k.qry" << endl;
+    cerr << "       ./query_hint_m.exec -b 10 -o all -q gOVERLAPS -B samples/AARHUS-BOOKS_2013.dat samples/AARHUS-BOOKS_2013_20k.qry" << endl;
+    cerr << "       ./query_hint_m.exec -b 10 -o all -q gOVERLAPS -S books.idx samples/AARHUS-BOOKS_2013.dat samples/AARHUS-BOOKS_2013_20k.qry" << endl;
+    cerr << "       ./query_hint_m.exec -o all -q gOVERLAPS -I books.idx samples/AARHUS-BOOKS_2013.dat samples/AARHUS-BOOKS_2013_20k.qry" << endl;
+    cerr << "       ./query_hint_m.exec -b 10 -o all -q gOVERLAPS -u 0.1 -U 8192 samples/AARHUS-BOOKS_2013.dat samples/AARHUS-BOOKS_2013_20k.qry" << endl;
+    cerr << "       ./query_hint_m.exec -b 10 -o all -q gOVERLAPS -d 0.1 -P 0.02 samples/AARHUS-BOOKS_2013.dat samples/AARHUS-BOOKS_2013_20k.qry" << endl;
+    cerr << "       ./query_hint_m.exec -b 10 -o all -q gOVERLAPS -u 0.5 -G 4 samples/AARHUS-BOOKS_2013.dat samples/AARHUS-BOOKS_2013_20k.qry" << endl << endl;
+}
+
+
+// Evaluates query Q on index idxR, according to the predicate type.
+inline size_t executeQuery(HierarchicalIndex *idxR, const RunSettings &settings, RangeQuery Q)
+{
+    switch (settings.typePredicate)
+    {
+        case PREDICATE_EQUALS:
+            return idxR->executeBottomUp_Equals(Q);
+
+        case PREDICATE_STARTS:
+            return idxR->executeBottomUp_Starts(Q);
+
+        case PREDICATE_STARTED:
+            return idxR->executeBottomUp_Started(Q);
+
+        case PREDICATE_FINISHES:
+            return idxR->executeBottomUp_Finishes(Q);
+
+        case PREDICATE_FINISHED:
+            return idxR->executeBottomUp_Finished(Q);
+
+        case PREDICATE_MEETS:
+            return idxR->executeBottomUp_Meets(Q);
+
+        case PREDICATE_MET:
+            return idxR->executeBottomUp_Met(Q);
+
+        case PREDICATE_OVERLAPS:
+            return idxR->executeBottomUp_Overlaps(Q);
+
+        case PREDICATE_OVERLAPPED:
+            return idxR->executeBottomUp_Overlapped(Q);
+
+        case PREDICATE_CONTAINS:
+            return idxR->executeBottomUp_Contains(Q);
+
+        case PREDICATE_CONTAINED:
+            return idxR->executeBottomUp_Contained(Q);
+
+        case PREDICATE_PRECEDES:
+            return idxR->executeBottomUp_Precedes(Q);
+
+        case PREDICATE_PRECEDED:
+            return idxR->executeBottomUp_Preceded(Q);
+
+        case PREDICATE_GOVERLAPS:
+            if (settings.topDown)
+                return idxR->executeTopDown_gOverlaps(Q);
+            else
+                return idxR->executeBottomUp_gOverlaps(Q);
+    }
+
+    return 0;
+}
+
+
+// Evaluates query Q on index idxR as an aggregate query, see -A.
+inline void executeAggregateQuery(HINT_M_ALL *idxR, const RunSettings &settings, RangeQuery Q, AggregateSink &result)
+{
+    switch (settings.typePredicate)
+    {
+        case PREDICATE_EQUALS:
+            idxR->executeBottomUp_Equals(Q, result);
+            break;
+
+        case PREDICATE_STARTS:
+            idxR->executeBottomUp_Starts(Q, result);
+            break;
+
+        case PREDICATE_STARTED:
+            idxR->executeBottomUp_Started(Q, result);
+            break;
+
+        case PREDICATE_FINISHES:
+            idxR->executeBottomUp_Finishes(Q, result);
+            break;
+
+        case PREDICATE_FINISHED:
+            idxR->executeBottomUp_Finished(Q, result);
+            break;
+
+        case PREDICATE_MEETS:
+            idxR->executeBottomUp_Meets(Q, result);
+            break;
+
+        case PREDICATE_MET:
+            idxR->executeBottomUp_Met(Q, result);
+            break;
+
+        case PREDICATE_OVERLAPS:
+            idxR->executeBottomUp_Overlaps(Q, result);
+            break;
+
+        case PREDICATE_OVERLAPPED:
+            idxR->executeBottomUp_Overlapped(Q, result);
+            break;
+
+        case PREDICATE_CONTAINS:
+            idxR->executeBottomUp_Contains(Q, result);
+            break;
+
+        case PREDICATE_CONTAINED:
+            idxR->executeBottomUp_Contained(Q, result);
+            break;
+
+        case PREDICATE_PRECEDES:
+            idxR->executeBottomUp_Precedes(Q, result);
+            break;
+
+        case PREDICATE_PRECEDED:
+            idxR->executeBottomUp_Preceded(Q, result);
+            break;
+
+        case PREDICATE_GOVERLAPS:
+            idxR->executeBottomUp_gOverlaps(Q, result);
+            break;
+    }
+}
+
+
+// Statistics of a worker thread in the multi-threaded mode
+struct WorkerStats
+{
+    size_t numQueries;
+    size_t totalResult;
+    double busyTime;
+};
+
+
+// Worker thread; repeatedly grabs the next chunk of QUERY_CHUNK_SIZE queries
+// until all of them are evaluated. Every query is evaluated on the index
+// currently published through the handle, see -R; its start is recorded
+// relative to epoch.
+void runQueries(const IndexHandle<HierarchicalIndex> &handle, const RunSettings &settings, const vector<RangeQuery> &queries, atomic<size_t> &nextQuery, vector<size_t> &queryresults, vector<double> &querytimes, const Timer &epoch, vector<double> &querystarts, WorkerStats &stats)
+{
+    Timer tim, clock = epoch;
+    size_t numQueries = queries.size();
+    size_t queryresult = 0;
+
+
+    stats.numQueries  = 0;
+    stats.totalResult = 0;
+    stats.busyTime    = 0;
+    while (true)
+    {
+        size_t from = nextQuery.fetch_add(QUERY_CHUNK_SIZE);
+        if (from >= numQueries)
+            break;
+
+        size_t to = min(from+QUERY_CHUNK_SIZE, numQueries);
+        for (auto i = from; i < to; i++)
+        {
+            double sumT = 0;
+            
+            querystarts[i] = clock.stop();
+            IndexHandle<HierarchicalIndex>::Reader idxR = handle.acquire();
+            for (auto r = 0; r < settings.numRuns; r++)
+            {
+                tim.start();
+                queryresult = executeQuery(idxR.get(), settings, queries[i]);
+                sumT += tim.stop();
+            }
+            queryresults[i] = queryresult;
+            querytimes[i]   = sumT/settings.numRuns;
+
+            stats.numQueries++;
+            stats.totalResult += queryresult;
+            stats.busyTime    += sumT;
+        }
+    }
+}
+
+
+// Reports the latencies of the queries started in [from, to), see -R.
+void reportPeriod(const char *label, const vector<double> &querystarts, const vector<double> &querytimes, const double from, const double to)
+{
+    vector<double> times;
+    double sumT = 0;
+    
+    
+    for (auto i = 0; i < querystarts.size(); i++)
+    {
+        if ((querystarts[i] >= from) && (querystarts[i] < to))
+        {
+            times.push_back(querytimes[i]);
+            sumT += querytimes[i];
+        }
+    }
+    if (times.empty())
+    {
+        printf( "  %-26s: 0 queries\n", label);
+        return;
+    }
+    
+    sort(times.begin(), times.end());
+    printf( "  %-26s: %zu queries, avg %f secs, p99 %f secs, max %f secs\n", label, times.size(), sumT/times.size(), times[min(times.size()-1, (size_t)(times.size()*0.99))], times.back());
 }
 
 
 int main(int argc, char **argv)
 {
     Timer tim;
-    Relation R;
+    Relation R, R0;
     HierarchicalIndex *idxR;
-    size_t totalResult = 0, queryresult = 0, numQueries = 0;
-    double totalIndexTime = 0, totalQueryTime = 0, querytime = 0, avgQueryTime = 0;
+    IndexHandle<HierarchicalIndex> *handle = NULL;
+    size_t totalResult = 0, queryresult = 0, queryxor = 0, querydurations = 0, totalXorIds = 0, totalSumDurations = 0, numQueries = 0, numInitial = 0, numInserted = 0, numToErase = 0, numErased = 0;
+    double totalIndexTime = 0, totalSaveTime = 0, totalQueryTime = 0, querytime = 0, avgQueryTime = 0, totalInsertTime = 0, totalEraseTime = 0;
     Timestamp qstart, qend;
     RunSettings settings;
     char c;
-    double vmDQ = 0, rssDQ = 0, vmI = 0, rssI = 0;
+    double vmDQ = 0, rssDQ = 0, vmI = 0, rssI = 0, peakI = 0;
     string strQuery = "", strPredicate = "", strOptimizations = "";
+    vector<RangeQuery> queries;
+    vector<size_t> queryresults;
+    vector<double> querytimes, querystarts;
+    vector<WorkerStats> workerStats;
+    double rebuildStart = 0, rebuildTime = 0, swapTime = 0, retireTime = 0;
 
     
     // Parse command line input
     settings.init();
     settings.method = "hint_m";
-    while ((c = getopt(argc, argv, "?hvq:m:to:r:")) != -1)
+    while ((c = getopt(argc, argv, "?hvq:m:to:r:j:c:p:s:aAeBS:I:u:U:d:P:G:R")) != -1)
     {
         switch (c)
         {
@@ -114,6 +367,72 @@ int main(int argc, char **argv)
                 settings.numRuns = atoi(optarg);
                 break;
                 
+            case 'j':
+                settings.numThreads = atoi(optarg);
+                break;
+                
+            case 'c':
+                settings.numBuildThreads = atoi(optarg);
+                break;
+                
+            case 'a':
+                settings.buildAggregates = true;
+                break;
+                
+            case 'A':
+                settings.aggregateQueries = true;
+                break;
+                
+            case 'e':
+                settings.buildSearchLayout = true;
+                break;
+                
+            case 'p':
+                settings.numQueryThreads = atoi(optarg);
+                break;
+                
+            case 's':
+                settings.parallelSelectivity = atof(optarg);
+                break;
+                
+            case 'B':
+                settings.batch = true;
+                break;
+                
+            case 'S':
+                settings.indexFile = optarg;
+                settings.openIndex = false;
+                break;
+                
+            case 'I':
+                settings.indexFile = optarg;
+                settings.openIndex = true;
+                break;
+                
+            case 'u':
+                settings.updateFraction = atof(optarg);
+                break;
+                
+            case 'U':
+                settings.deltaCapacity = atoi(optarg);
+                break;
+                
+            case 'd':
+                settings.deleteFraction = atof(optarg);
+                break;
+                
+            case 'P':
+                settings.purgeRatio = atof(optarg);
+                break;
+                
+            case 'G':
+                settings.segmentFanout = atoi(optarg);
+                break;
+                
+            case 'R':
+                settings.rebuild = true;
+                break;
+                
             default:
                 cerr << endl << "Error - unknown option '" << c << "'" << endl << endl;
                 usage();
@@ -143,25 +462,169 @@ int main(int argc, char **argv)
         usage();
         return 1;
     }
+    if ((settings.numThreads > 1) && (settings.numQueryThreads > 1))
+    {
+        cerr << endl << "Error - options -j and -p cannot be combined" << endl << endl;
+        usage();
+        return 1;
+    }
+    if ((settings.batch) && ((settings.numThreads > 1) || (settings.numQueryThreads > 1)))
+    {
+        cerr << endl << "Error - option -B cannot be combined with -j or -p" << endl << endl;
+        usage();
+        return 1;
+    }
+    if ((settings.batch) && ((settings.typePredicate != PREDICATE_GOVERLAPS) || (settings.topDown)))
+    {
+        cerr << endl << "Error - option -B is supported only for GOVERLAPS with the bottom-up strategy" << endl << endl;
+        usage();
+        return 1;
+    }
+    if ((settings.numQueryThreads > 1) && ((settings.typePredicate != PREDICATE_GOVERLAPS) || (settings.typeOptimizations != HINT_M_OPTIMIZATIONS_ALL)))
+    {
+        cerr << endl << "Error - option -p is supported only for GOVERLAPS with \"all\" optimizations" << endl << endl;
+        usage();
+        return 1;
+    }
+    if ((settings.buildSearchLayout) && (settings.typeOptimizations != HINT_M_OPTIMIZATIONS_SUBS_SORT_SS_CM) && (settings.typeOptimizations != HINT_M_OPTIMIZATIONS_ALL))
+    {
+        cerr << endl << "Error - option -e is supported only by \"subs+sort+ss+cm\" and \"all\" optimizations" << endl << endl;
+        usage();
+        return 1;
+    }
+    if ((settings.buildAggregates) && (settings.typeOptimizations != HINT_M_OPTIMIZATIONS_ALL))
+    {
+        cerr << endl << "Error - option -a is supported only by \"all\" optimizations" << endl << endl;
+        usage();
+        return 1;
+    }
+    if ((settings.aggregateQueries) && (settings.typeOptimizations != HINT_M_OPTIMIZATIONS_ALL))
+    {
+        cerr << endl << "Error - option -A is supported only by \"all\" optimizations" << endl << endl;
+        usage();
+        return 1;
+    }
+    if ((settings.aggregateQueries) && ((settings.numThreads > 1) || (settings.batch) || (settings.topDown) || (settings.segmentFanout > 0)))
+    {
+        cerr << endl << "Error - option -A cannot be combined with -j, -B, -t or -G" << endl << endl;
+        usage();
+        return 1;
+    }
+    if (settings.numBuildThreads < 1)
+    {
+        cerr << endl << "Error - the number of threads for -c must be positive" << endl << endl;
+        usage();
+        return 1;
+    }
+    if ((settings.numBuildThreads > 1) && ((settings.typeOptimizations != HINT_M_OPTIMIZATIONS_ALL) || (settings.openIndex)))
+    {
+        cerr << endl << "Error - option -c is supported only when building an index with \"all\" optimizations" << endl << endl;
+        usage();
+        return 1;
+    }
+    if ((settings.indexFile != NULL) && (settings.typeOptimizations != HINT_M_OPTIMIZATIONS_ALL))
+    {
+        cerr << endl << "Error - options -S and -I are supported only by \"all\" optimizations" << endl << endl;
+        usage();
+        return 1;
+    }
+    if ((settings.updateFraction < 0) || (settings.updateFraction >= 1))
+    {
+        cerr << endl << "Error - the fraction of the data for -u must be in [0, 1)" << endl << endl;
+        usage();
+        return 1;
+    }
+    if ((settings.updateFraction > 0) && (settings.typeOptimizations != HINT_M_OPTIMIZATIONS_SUBS_SORT_SS_CM) && (settings.typeOptimizations != HINT_M_OPTIMIZATIONS_ALL))
+    {
+        cerr << endl << "Error - option -u is supported only by \"subs+sort+ss+cm\" and \"all\" optimizations" << endl << endl;
+        usage();
+        return 1;
+    }
+    if ((settings.updateFraction > 0) && ((settings.numThreads > 1) || (settings.batch) || (settings.topDown) || (settings.buildAggregates) || (settings.indexFile != NULL)))
+    {
+        cerr << endl << "Error - option -u cannot be combined with -j, -B, -t, -a, -S or -I" << endl << endl;
+        usage();
+        return 1;
+    }
+    if ((settings.deleteFraction < 0) || (settings.deleteFraction >= 1))
+    {
+        cerr << endl << "Error - the fraction of the data for -d must be in [0, 1)" << endl << endl;
+        usage();
+        return 1;
+    }
+    if ((settings.deleteFraction > 0) && (settings.typeOptimizations != HINT_M_OPTIMIZATIONS_SUBS_SORT_SS_CM) && (settings.typeOptimizations != HINT_M_OPTIMIZATIONS_ALL))
+    {
+        cerr << endl << "Error - option -d is supported only by \"subs+sort+ss+cm\" and \"all\" optimizations" << endl << endl;
+        usage();
+        return 1;
+    }
+    if ((settings.deleteFraction > 0) && ((settings.numThreads > 1) || (settings.batch) || (settings.topDown) || (settings.buildAggregates) || (settings.indexFile != NULL)))
+    {
+        cerr << endl << "Error - option -d cannot be combined with -j, -B, -t, -a, -S or -I" << endl << endl;
+        usage();
+        return 1;
+    }
+    if ((settings.segmentFanout > 0) && (settings.typeOptimizations != HINT_M_OPTIMIZATIONS_ALL))
+    {
+        cerr << endl << "Error - option -G is supported only by \"all\" optimizations" << endl << endl;
+        usage();
+        return 1;
+    }
+    if ((settings.segmentFanout > 0) && ((settings.numThreads > 1) || (settings.numQueryThreads > 1) || (settings.batch) || (settings.topDown) || (settings.buildAggregates) || (settings.buildSearchLayout) || (settings.indexFile != NULL) || (settings.deleteFraction > 0)))
+    {
+        cerr << endl << "Error - option -G cannot be combined with -j, -p, -B, -t, -a, -e, -S, -I or -d" << endl << endl;
+        usage();
+        return 1;
+    }
+    if ((settings.rebuild) && ((settings.numThreads < 2) || (settings.typeOptimizations != HINT_M_OPTIMIZATIONS_ALL) || (settings.indexFile != NULL)))
+    {
+        cerr << endl << "Error - option -R requires -j with at least 2 threads and \"all\" optimizations, and cannot be combined with -S or -I" << endl << endl;
+        usage();
+        return 1;
+    }
     settings.dataFile = argv[optind];
     settings.queryFile = argv[optind+1];
     
     
     // Load data and queries
     R.load(settings.dataFile);
+    if ((!R.openRecords.empty()) && (settings.typeOptimizations != HINT_M_OPTIMIZATIONS_SUBS_SORT_SS_CM) && (settings.typeOptimizations != HINT_M_OPTIMIZATIONS_ALL))
+    {
+        cerr << endl << "Error - open intervals are supported only by \"subs+sort+ss+cm\" and \"all\" optimizations" << endl << endl;
+        return 1;
+    }
+    if ((!R.openRecords.empty()) && (settings.indexFile != NULL))
+    {
+        cerr << endl << "Error - open intervals cannot be combined with -S or -I" << endl << endl;
+        return 1;
+    }
+    if ((!R.openRecords.empty()) && (settings.aggregateQueries))
+    {
+        cerr << endl << "Error - open intervals cannot be combined with -A" << endl << endl;
+        return 1;
+    }
     settings.maxBits = int(log2(R.gend-R.gstart)+1);
     
-    ifstream fQ(settings.queryFile);
-    if (!fQ)
+    loadQueries(settings.queryFile, queries);
+    
+    // With -u, the index is built on the data except for its last part,
+    // which is inserted while the queries are evaluated
+    numInitial = R.size()-(size_t)(R.size()*settings.updateFraction);
+    if (numInitial < R.size())
     {
-        cerr << endl << "Error - cannot open query file \"" << settings.queryFile << "\"" << endl << endl;
-        return 1;
+        R0.assign(R.begin(), R.begin()+numInitial);
+        R0.openRecords = R.openRecords;
     }
+    
+    // With -d, part of the data the index is built on is erased while the
+    // queries are evaluated
+    numToErase = (size_t)(numInitial*settings.deleteFraction);
     process_mem_usage(vmDQ, rssDQ);
+    reset_peak_mem_usage();
 
     
     // Build index
-    if (settings.numBits == 0)
+    if ((settings.numBits == 0) && (!settings.openIndex))
         settings.numBits = determineOptimalNumBitsForHINT_M(R, 0.1);    // Use 0.1% of the domain as the query extent
 
     switch (settings.typeOptimizations)
@@ -218,137 +681,201 @@ int main(int argc, char **argv)
         // HINT^m with subs+sort and cash misses optimizations activated, from VLDB Journal
         case HINT_M_OPTIMIZATIONS_SUBS_SORT_SS_CM:
             tim.start();
-            idxR = new HINT_M_SubsSort_SS_CM(R, settings.numBits, settings.maxBits);
+            idxR = new HINT_M_SubsSort_SS_CM(((numInitial < R.size())? R0: R), settings.numBits, settings.maxBits);
             totalIndexTime = tim.stop();
             break;
 
         // HINT^m with all optimizations activated, from ACM SIGMOD'22
         case HINT_M_OPTIMIZATIONS_ALL:
             tim.start();
-            idxR = new HINT_M_ALL(R, settings.numBits, settings.maxBits);
+            if (settings.segmentFanout > 0)
+                idxR = new SegmentedHINT(((numInitial < R.size())? R0: R), settings.numBits, settings.maxBits, settings.segmentFanout, settings.numBuildThreads);
+            else if (settings.openIndex)
+                idxR = new HINT_M_ALL(settings.indexFile);
+            else
+                idxR = new HINT_M_ALL(((numInitial < R.size())? R0: R), settings.numBits, settings.maxBits, settings.numBuildThreads);
+            if (settings.buildAggregates)
+                idxR->buildAggregates(R);
             totalIndexTime = tim.stop();
+            
+            if (settings.openIndex)
+            {
+                if (idxR->getNumIndexedRecords() != R.size())
+                {
+                    cerr << endl << "Error - index file \"" << settings.indexFile << "\" was not built on data file \"" << settings.dataFile << "\"" << endl << endl;
+                    return 1;
+                }
+                settings.numBits = idxR->getNumBits();
+            }
+            else if (settings.indexFile != NULL)
+            {
+                tim.start();
+                ((HINT_M_ALL*)idxR)->save(settings.indexFile);
+                totalSaveTime = tim.stop();
+            }
             break;
     }
+    if (settings.buildSearchLayout)
+    {
+        tim.start();
+        idxR->buildSearchLayout();
+        totalIndexTime += tim.stop();
+    }
     process_mem_usage(vmI, rssI);
+    peakI = peak_mem_usage();
+    if (settings.numQueryThreads > 1)
+        idxR->setQueryParallelism(settings.numQueryThreads, settings.parallelSelectivity);
+    if (settings.deltaCapacity > 0)
+        idxR->setDeltaCapacity(settings.deltaCapacity);
+    if (settings.purgeRatio >= 0)
+        idxR->setPurgeRatio(settings.purgeRatio);
 
     
     // Execute queries
     size_t sumQ = 0;
     if (settings.verbose)
         cout << "Query\tPredicate\tMethod\tBits\tStrategy\tOptimizations\tResult\tTime" << endl;
-    while (fQ >> qstart >> qend)
+    if (settings.batch)
     {
-        sumQ += qend-qstart;
-        numQueries++;
-        
-        double sumT = 0;
+        // Evaluate the whole query file in one call
+        for (const RangeQuery &q : queries)
+            sumQ += q.end-q.start;
+        numQueries = queries.size();
+
         for (auto r = 0; r < settings.numRuns; r++)
         {
-            switch (settings.typePredicate)
-            {
-                case PREDICATE_EQUALS:
-                    tim.start();
-                    queryresult = idxR->executeBottomUp_Equals(RangeQuery(numQueries, qstart, qend));
-                    querytime = tim.stop();
-                    break;
-
-                case PREDICATE_STARTS:
-                    tim.start();
-                    queryresult = idxR->executeBottomUp_Starts(RangeQuery(numQueries, qstart, qend));
-                    querytime = tim.stop();
-                    break;
-
-                case PREDICATE_STARTED:
-                    tim.start();
-                    queryresult = idxR->executeBottomUp_Started(RangeQuery(numQueries, qstart, qend));
-                    querytime = tim.stop();
-                    break;
-
-                case PREDICATE_FINISHES:
-                    tim.start();
-                    queryresult = idxR->executeBottomUp_Finishes(RangeQuery(numQueries, qstart, qend));
-                    querytime = tim.stop();
-                    break;
-
-                case PREDICATE_FINISHED:
-                    tim.start();
-                    queryresult = idxR->executeBottomUp_Finished(RangeQuery(numQueries, qstart, qend));
-                    querytime = tim.stop();
-                    break;
-
-                case PREDICATE_MEETS:
-                    tim.start();
-                    queryresult = idxR->executeBottomUp_Meets(RangeQuery(numQueries, qstart, qend));
-                    querytime = tim.stop();
-                    break;
-
-                case PREDICATE_MET:
-                    tim.start();
-                    queryresult = idxR->executeBottomUp_Met(RangeQuery(numQueries, qstart, qend));
-                    querytime = tim.stop();
-                    break;
-
-                case PREDICATE_OVERLAPS:
-                    tim.start();
-                    queryresult = idxR->executeBottomUp_Overlaps(RangeQuery(numQueries, qstart, qend));
-                    querytime = tim.stop();
-                    break;
+            tim.start();
+            idxR->executeBottomUp_gOverlaps(queries, queryresults);
+            totalQueryTime += tim.stop();
+        }
+        avgQueryTime = totalQueryTime/settings.numRuns;
 
-                case PREDICATE_OVERLAPPED:
-                    tim.start();
-                    queryresult = idxR->executeBottomUp_Overlapped(RangeQuery(numQueries, qstart, qend));
-                    querytime = tim.stop();
-                    break;
+        for (auto i = 0; i < numQueries; i++)
+        {
+            totalResult += queryresults[i];
+            if (settings.verbose)
+                cout << "[" << queries[i].start << "," << queries[i].end << "]\t" << strPredicate << "\t" << settings.method << "\t" << settings.numBits << "\t" << "bottom-up (batch)" << "\t" << strOptimizations << "\t" << queryresults[i] << "\t" << avgQueryTime/numQueries << endl;
+        }
+    }
+    else if (settings.numThreads > 1)
+    {
+        // Share the index among the workers
+        for (const RangeQuery &q : queries)
+            sumQ += q.end-q.start;
+        numQueries = queries.size();
+        queryresults.resize(numQueries);
+        querytimes.resize(numQueries);
+        querystarts.resize(numQueries);
+        workerStats.resize(settings.numThreads);
+        handle = new IndexHandle<HierarchicalIndex>(idxR);
+
+        atomic<size_t> nextQuery(0);
+        vector<thread> workers;
+        thread rebuilder;
+        tim.start();
+        for (auto t = 0; t < settings.numThreads; t++)
+            workers.emplace_back(runQueries, cref(*handle), cref(settings), cref(queries), ref(nextQuery), ref(queryresults), ref(querytimes), cref(tim), ref(querystarts), ref(workerStats[t]));
+        
+        // With -R, rebuild the index on the same data while the workers go on
+        // with the queries, and swap it in
+        if (settings.rebuild)
+        {
+            rebuilder = thread([&, tim] () mutable
+            {
+                while (nextQuery < numQueries/4)
+                    this_thread::sleep_for(chrono::milliseconds(1));
+                
+                rebuildStart = tim.stop();
+                HierarchicalIndex *idx = new HINT_M_ALL(R, settings.numBits, settings.maxBits, settings.numBuildThreads);
+                if (settings.buildAggregates)
+                    idx->buildAggregates(R);
+                if (settings.buildSearchLayout)
+                    idx->buildSearchLayout();
+                swapTime = tim.stop();
+                rebuildTime = swapTime-rebuildStart;
+                
+                handle->publish(idx);
+                retireTime = tim.stop()-swapTime;
+            });
+        }
+        for (auto &w : workers)
+            w.join();
+        totalQueryTime = tim.stop();
+        if (settings.rebuild)
+            rebuilder.join();
+        idxR = handle->get();
+
+        for (auto i = 0; i < numQueries; i++)
+        {
+            totalResult += queryresults[i];
+            avgQueryTime += querytimes[i];
+            if (settings.verbose)
+                cout << "[" << queries[i].start << "," << queries[i].end << "]\t" << strPredicate << "\t" << settings.method << "\t" << settings.numBits << "\t" << ((settings.topDown)? "top-down": "bottop-up") << "\t" << strOptimizations << "\t" << queryresults[i] << "\t" << querytimes[i] << endl;
+        }
+    }
+    else
+    {
+        for (const RangeQuery &q : queries)
+        {
+            qstart = q.start;
+            qend   = q.end;
+            sumQ += qend-qstart;
+            numQueries++;
 
-                case PREDICATE_CONTAINS:
-                    tim.start();
-                    queryresult = idxR->executeBottomUp_Contains(RangeQuery(numQueries, qstart, qend));
-                    querytime = tim.stop();
-                    break;
+            // Insert the data due before this query
+            if (numInitial < R.size())
+            {
+                size_t numDue = (R.size()-numInitial)*numQueries/queries.size();
+                
+                tim.start();
+                for (; numInserted < numDue; numInserted++)
+                    idxR->insert(R[numInitial+numInserted]);
+                totalInsertTime += tim.stop();
+            }
+            
+            // Erase the data due before this query
+            if (numToErase > 0)
+            {
+                size_t numDue = numToErase*numQueries/queries.size();
+                
+                tim.start();
+                for (; numErased < numDue; numErased++)
+                    idxR->erase(R[numErased*numInitial/numToErase]);
+                totalEraseTime += tim.stop();
+            }
 
-                case PREDICATE_CONTAINED:
+            double sumT = 0;
+            for (auto r = 0; r < settings.numRuns; r++)
+            {
+                if (settings.aggregateQueries)
+                {
+                    AggregateSink aggregate(R);
+                    
                     tim.start();
-                    queryresult = idxR->executeBottomUp_Contained(RangeQuery(numQueries, qstart, qend));
+                    executeAggregateQuery((HINT_M_ALL*)idxR, settings, RangeQuery(numQueries, qstart, qend), aggregate);
                     querytime = tim.stop();
-                    break;
-
-                case PREDICATE_PRECEDES:
+                    queryresult    = aggregate.get();
+                    queryxor       = aggregate.xorIds;
+                    querydurations = aggregate.sumDurations;
+                }
+                else
+                {
                     tim.start();
-                    queryresult = idxR->executeBottomUp_Precedes(RangeQuery(numQueries, qstart, qend));
+                    queryresult = executeQuery(idxR, settings, RangeQuery(numQueries, qstart, qend));
                     querytime = tim.stop();
-                    break;
+                }
+                sumT += querytime;
+                totalQueryTime += querytime;
 
-                case PREDICATE_PRECEDED:
-                    tim.start();
-                    queryresult = idxR->executeBottomUp_Preceded(RangeQuery(numQueries, qstart, qend));
-                    querytime = tim.stop();
-                    break;
-
-                case PREDICATE_GOVERLAPS:
-                    if (settings.topDown)
-                    {
-                        tim.start();
-                        queryresult = idxR->executeTopDown_gOverlaps(RangeQuery(numQueries, qstart, qend));
-                        querytime = tim.stop();
-                    }
-                    else
-                    {
-                        tim.start();
-                        queryresult = idxR->executeBottomUp_gOverlaps(RangeQuery(numQueries, qstart, qend));
-                        querytime = tim.stop();
-                    }
-                    break;
+                if (settings.verbose)
+                    cout << "[" << qstart << "," << qend << "]\t" << strPredicate << "\t" << settings.method << "\t" << settings.numBits << "\t" << ((settings.topDown)? "top-down": "bottop-up") << "\t" << strOptimizations << "\t" << queryresult << "\t" << querytime << endl;
             }
-            sumT += querytime;
-            totalQueryTime += querytime;
-            
-            if (settings.verbose)
-                cout << "[" << qstart << "," << qend << "]\t" << strPredicate << "\t" << settings.method << "\t" << settings.numBits << "\t" << ((settings.topDown)? "top-down": "bottop-up") << "\t" << strOptimizations << "\t" << queryresult << "\t" << querytime << endl;
+            totalResult += queryresult;
+            totalXorIds += queryxor;
+            totalSumDurations += querydurations;
+            avgQueryTime += sumT/settings.numRuns;
         }
-        totalResult += queryresult;
-        avgQueryTime += sumT/settings.numRuns;
     }
-    fQ.close();
     
     
     // Report
@@ -358,6 +885,8 @@ int main(int argc, char **argv)
     cout << "======" << endl;
     cout << "Input" << endl;
     cout << "  Num of intervals          : " << R.size() << endl;
+    if (!R.openRecords.empty())
+        cout << "  Num of open intervals     : " << R.openRecords.size() << endl;
     cout << "  Domain size               : " << (R.gend-R.gstart) << endl;
     cout << "  Avg interval extent [%]   : "; printf("%f\n", R.avgRecordExtent*100/(R.gend-R.gstart));
     cout << endl;
@@ -381,26 +910,107 @@ int main(int argc, char **argv)
     printf( "  Avg partition size        : %f\n", idxR->avgPartitionSize);
     printf( "  Read VM [Bytes]           : %ld\n", (size_t)(vmI-vmDQ)*1024);
     printf( "  Read RSS [Bytes]          : %ld\n", (size_t)(rssI-rssDQ)*1024);
+    printf( "  Peak build RSS [Bytes]    : %ld\n", (size_t)(peakI-rssDQ)*1024);
+    if (settings.buildAggregates)
+        printf( "  Prefix aggregates [Bytes] : %zu\n", idxR->sizeAggregates);
+    if (settings.buildSearchLayout)
+        printf( "  Search layout [Bytes]     : %zu\n", idxR->sizeSearchLayout);
+    if (settings.indexFile != NULL)
+        cout << "  Index file                : " << settings.indexFile << ((settings.openIndex)? " (opened)": " (saved)") << endl;
+    if (settings.numBuildThreads > 1)
+        cout << "  Num of build threads      : " << settings.numBuildThreads << endl;
     printf( "  Indexing time [secs]      : %f\n", totalIndexTime);
+    if ((settings.indexFile != NULL) && (!settings.openIndex))
+        printf( "  Saving time [secs]        : %f\n", totalSaveTime);
     cout << endl;
     cout << "Queries" << endl;
     cout << "  Predicate type            : " << strPredicate << endl;
-    cout << "  Strategy                  : " << ((settings.topDown) ? "top-down": "bottom-up") << endl;
+    cout << "  Scan kernels              : " << getScanKernelName(getScanKernel()) << endl;
+    cout << "  Strategy                  : " << ((settings.topDown) ? "top-down": ((settings.batch) ? "bottom-up (batch)": "bottom-up")) << endl;
     cout << "  Num of runs per query     : " << settings.numRuns << endl;
     cout << "  Num of queries            : " << numQueries << endl;
     cout << "  Avg query extent [%]      : "; printf("%f\n", (((float)sumQ/numQueries)*100)/(R.gend-R.gstart));
-    cout << "  Total result [";
+    if (settings.aggregateQueries)
+    {
+        cout << "  Total result [COUNT]      : " << totalResult << endl;
+        cout << "  Total result [XOR]        : " << totalXorIds << endl;
+        cout << "  Total result [DURATIONS]  : " << totalSumDurations << endl;
+    }
+    else
+    {
+        cout << "  Total result [";
 #ifdef WORKLOAD_COUNT
-    cout << "COUNT]      : ";
+        cout << "COUNT]      : ";
 #else
-    cout << "XOR]        : ";
+        cout << "XOR]        : ";
 #endif
-    cout << totalResult << endl;
+        cout << totalResult << endl;
+    }
     printf( "  Total querying time [secs]: %f\n", totalQueryTime/settings.numRuns);
     printf( "  Avg querying time [secs]  : %f\n\n", avgQueryTime/numQueries);
     printf( "  Throughput [queries/sec]  : %f\n\n", numQueries/(totalQueryTime/settings.numRuns));
+    if (settings.numThreads > 1)
+    {
+        cout << "Threads" << endl;
+        cout << "  Num of threads            : " << settings.numThreads << endl;
+        for (auto t = 0; t < settings.numThreads; t++)
+        {
+            printf( "  Thread %-3d                : %zu queries, result %zu, busy %f secs, %f queries/sec\n", t, workerStats[t].numQueries, workerStats[t].totalResult, workerStats[t].busyTime/settings.numRuns, (workerStats[t].busyTime > 0)? workerStats[t].numQueries/(workerStats[t].busyTime/settings.numRuns): 0);
+        }
+        cout << endl;
+    }
+    if (settings.rebuild)
+    {
+        cout << "Rebuild" << endl;
+        printf( "  Started at [secs]         : %f\n", rebuildStart);
+        printf( "  Rebuild time [secs]       : %f\n", rebuildTime);
+        printf( "  Published at [secs]       : %f\n", swapTime);
+        printf( "  Retire time [secs]        : %f\n", retireTime);
+        cout << "  Num of swaps              : " << handle->numSwaps << endl;
+        reportPeriod("Before rebuild", querystarts, querytimes, 0, rebuildStart);
+        reportPeriod("During rebuild", querystarts, querytimes, rebuildStart, swapTime);
+        reportPeriod("After swap", querystarts, querytimes, swapTime, numeric_limits<double>::max());
+        cout << endl;
+    }
+    if (numInitial < R.size())
+    {
+        cout << "Updates" << endl;
+        cout << "  Num of initial intervals  : " << numInitial << endl;
+        cout << "  Num of insertions         : " << numInserted << endl;
+        cout << "  Delta buffer capacity     : " << ((settings.deltaCapacity > 0)? settings.deltaCapacity: DELTA_BUFFER_CAPACITY) << endl;
+        cout << "  Num of merges             : " << idxR->numMerges << endl;
+        cout << "  Num of unmerged insertions: " << idxR->getDeltaSize() << endl;
+        printf( "  Total insert time [secs]  : %f\n", totalInsertTime);
+        printf( "  Ingest rate [records/sec] : %f\n\n", numInserted/totalInsertTime);
+    }
+    if (numToErase > 0)
+    {
+        cout << "Deletions" << endl;
+        cout << "  Num of deletions          : " << numErased << endl;
+        printf( "  Purge ratio               : %f\n", (settings.purgeRatio >= 0)? settings.purgeRatio: TOMBSTONES_PURGE_RATIO);
+        cout << "  Num of purges             : " << idxR->numPurges << endl;
+        cout << "  Num of unpurged deletions : " << idxR->getNumErased() << endl;
+        printf( "  Total delete time [secs]  : %f\n", totalEraseTime);
+        printf( "  Delete rate [records/sec] : %f\n\n", numErased/totalEraseTime);
+    }
+    if (settings.segmentFanout > 0)
+    {
+        cout << "Segments" << endl;
+        cout << "  Fanout                    : " << settings.segmentFanout << endl;
+        cout << "  Num of segments           : " << ((SegmentedHINT*)idxR)->getNumSegments() << endl;
+        cout << "  Num of compactions        : " << ((SegmentedHINT*)idxR)->numCompactions << endl << endl;
+    }
+    if (settings.numQueryThreads > 1)
+    {
+        cout << "Intra-query parallelism" << endl;
+        cout << "  Num of threads per query  : " << settings.numQueryThreads << endl;
+        printf( "  Selectivity threshold     : %f\n\n", settings.parallelSelectivity);
+    }
 
-    delete idxR;
+    if (handle != NULL)
+        delete handle;
+    else
+        delete idxR;
     
     
     return 0;
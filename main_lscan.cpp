@@ -30,6 +30,7 @@
 #include "getopt.h"
 #include "def_global.h"
 #include "./containers/relation.h"
+#include "./containers/kernels.h"
 
 
 
@@ -62,6 +63,7 @@ int main(int argc, char **argv)
     size_t totalResult = 0, queryresult = 0, numQueries = 0;
     double totalSortingTime = 0, totalQueryTime = 0, querytime = 0, avgQueryTime = 0;
     Timestamp qstart, qend;
+    vector<RangeQuery> queries;
     RunSettings settings;
     char c;
     double vmDQ = 0, rssDQ = 0, vmI = 0, rssI = 0;
@@ -122,12 +124,7 @@ int main(int argc, char **argv)
     // Load data and queries
     R.load(settings.dataFile);
     
-    ifstream fQ(settings.queryFile);
-    if (!fQ)
-    {
-        cerr << endl << "Error - cannot open query file \"" << settings.queryFile << "\"" << endl << endl;
-        return 1;
-    }
+    loadQueries(settings.queryFile, queries);
     process_mem_usage(vmDQ, rssDQ);
 
     
@@ -135,8 +132,10 @@ int main(int argc, char **argv)
     size_t sumQ = 0;
     if (settings.verbose)
         cout << "Query\tType\tPredicate\tMethod\tResult\tTime" << endl;
-    while (fQ >> qstart >> qend)
+    for (const RangeQuery &q : queries)
     {
+        qstart = q.start;
+        qend   = q.end;
         sumQ += qend-qstart;
         numQueries++;
         
@@ -238,7 +237,6 @@ int main(int argc, char **argv)
         totalResult += queryresult;
         avgQueryTime += sumT/settings.numRuns;
     }
-    fQ.close();
     
     
     // Report
@@ -247,6 +245,8 @@ int main(int argc, char **argv)
     cout << "===========" << endl;
     cout << "Input" << endl;
     cout << "  Num of intervals          : " << R.size() << endl;
+    if (!R.openRecords.empty())
+        cout << "  Num of open intervals     : " << R.openRecords.size() << endl;
     cout << "  Domain size               : " << (R.gend-R.gstart) << endl;
     cout << "  Avg interval extent [%]   : "; printf("%f\n", R.avgRecordExtent*100/(R.gend-R.gstart));
     cout << endl;
@@ -256,6 +256,7 @@ int main(int argc, char **argv)
     cout << endl;
     cout << "Queries" << endl;
     cout << "  Predicate type            : " << strPredicate << endl;
+    cout << "  Scan kernels              : " << getScanKernelName(getScanKernel()) << endl;
     cout << "  Num of runs per query     : " << settings.numRuns << endl;
     cout << "  Num of queries            : " << numQueries << endl;
     cout << "  Avg query extent [%]      : "; printf("%f\n", (((float)sumQ/numQueries)*100)/(R.gend-R.gstart));
@@ -29,6 +29,7 @@
 
 #include "def_global.h"
 #include "containers/relation.h"
+#include "containers/textparser.h"
 
 
 
@@ -202,6 +203,34 @@ void process_mem_usage(double& vm_usage, double& resident_set)
 }
 
 
+// Resets the peak resident set size of the process to its current one
+void reset_peak_mem_usage()
+{
+    std::ofstream ofs("/proc/self/clear_refs", std::ios_base::out);
+    ofs << "5";
+}
+
+
+// Returns the peak resident set size of the process in KB
+double peak_mem_usage()
+{
+    std::string key;
+    std::ifstream ifs("/proc/self/status", std::ios_base::in);
+    while (ifs >> key)
+    {
+        if (key == "VmHWM:")
+        {
+            double peak;
+            ifs >> peak;
+            return peak;
+        }
+        ifs.ignore(numeric_limits<streamsize>::max(), '\n');
+    }
+    
+    return 0.0;
+}
+
+
 #define C_cmp(n,m,b)    (b*n)/pow(2,m)
 #define C_acc(n,q,m,b)    b*(q - (2*n)/pow(2,m))
 unsigned int determineOptimalNumBitsForHINT_M(const Relation &R, const float qe_precentage)
@@ -239,3 +268,17 @@ unsigned int determineOptimalNumBitsForHINT_M(const Relation &R, const float qe_
 
     return m;
 }
+
+
+// Loads the queries of a text query file, with ids 1, 2, ..., see textparser.h
+void loadQueries(const char *filename, vector<RangeQuery> &queries)
+{
+    IntervalFileStats stats;
+    
+    parseIntervalFile(filename, "query", 1, queries, stats);
+    if (stats.numOpen > 0)
+    {
+        cerr << endl << "Error - query file \"" << filename << "\" contains open intervals" << endl << endl;
+        exit(1);
+    }
+}